@@ -25,7 +25,7 @@ Vendor: TaoBao
 Prefix:%{_prefix}
 Source:%{NAME}-%{VERSION}.tar.gz
 BuildRoot: %(pwd)/%{name}-root
-Requires: lzo >= 2.06 snappy >= 1.0.2 libaio >= 0.3 openssl >= 0.9.8 perl-DBI
+Requires: lzo >= 2.06 snappy >= 1.0.2 lz4 >= 1.7 libzstd >= 1.3 libaio >= 0.3 openssl >= 0.9.8 perl-DBI
 
 %package -n oceanbase-utils
 summary: OceanBase utility programs
@@ -89,6 +89,11 @@ rm -rf $RPM_BUILD_ROOT
 %{_prefix}/bin/lsyncserver
 %{_prefix}/bin/dumpsst
 %{_prefix}/bin/log_reader
+%{_prefix}/lib/liblz4_1.0.a
+%{_prefix}/lib/liblz4_1.0.la
+%{_prefix}/lib/liblz4_1.0.so
+%{_prefix}/lib/liblz4_1.0.so.0
+%{_prefix}/lib/liblz4_1.0.so.0.0.0
 %{_prefix}/lib/liblzo_1.0.a
 %{_prefix}/lib/liblzo_1.0.la
 %{_prefix}/lib/liblzo_1.0.so
@@ -109,6 +114,11 @@ rm -rf $RPM_BUILD_ROOT
 %{_prefix}/lib/libsnappy_1.0.so
 %{_prefix}/lib/libsnappy_1.0.so.0
 %{_prefix}/lib/libsnappy_1.0.so.0.0.0
+%{_prefix}/lib/libzstd_1.0.a
+%{_prefix}/lib/libzstd_1.0.la
+%{_prefix}/lib/libzstd_1.0.so
+%{_prefix}/lib/libzstd_1.0.so.0
+%{_prefix}/lib/libzstd_1.0.so.0.0.0
 %{_prefix}/bin/oceanbase.pl
 %config %{_prefix}/etc/oceanbase.conf.template
 %{_prefix}/tests/
@@ -72,6 +72,32 @@ namespace oceanbase
       return reader;
     }
 
+    ObSSTableReader *ObBlockCacheLoader::get_sstable_reader(const uint64_t sstable_id,
+                                                            ObTablet*& tablet)
+    {
+      int status              = OB_SUCCESS;
+      ObSSTableReader* reader = NULL;
+      ObSSTableId sst_id(sstable_id);
+
+      tablet = NULL;
+      status = tablet_image_->acquire_tablet(sst_id, tablet_version_, tablet);
+      if (OB_SUCCESS == status && NULL != tablet)
+      {
+        status = tablet->find_sstable(sst_id, reader);
+        if (OB_SUCCESS != status)
+        {
+          reader = NULL;
+        }
+      }
+      else
+      {
+        TBSYS_LOG(DEBUG, "sstable isn't in tablet image, sstable_id=%lu, version=%ld",
+                  sstable_id, tablet_version_);
+      }
+
+      return reader;
+    }
+
     int ObBlockCacheLoader::load_block_into_cache(ObBlockIndexCache& index_cache, 
                                                   ObBlockCache& block_cache,
                                                   const uint64_t table_id,
@@ -146,5 +172,90 @@ namespace oceanbase
 
       return ret;
     }
+
+    int ObBlockCacheLoader::load_blocks_into_cache(ObBlockIndexCache& index_cache, 
+                                                   ObBlockCache& block_cache,
+                                                   const ObDataIndexKey* block_keys,
+                                                   const int64_t block_count,
+                                                   int64_t& loaded_size)
+    {
+      int ret                       = OB_SUCCESS;
+      int32_t block_size            = 0;
+      uint64_t table_id             = OB_INVALID_ID;
+      ObSSTableReader* reader       = NULL;
+      ObTablet* tablet              = NULL;
+      const ObSSTableSchema* schema = NULL;
+      const ObSSTableSchemaColumnDef* column_def = NULL;
+      ObBlockIndexPositionInfo info;
+      ObRowkey end_key;
+      ObBufferHandle handler;
+
+      loaded_size = 0;
+      if (NULL == tablet_image_ || NULL == block_keys || block_count <= 0)
+      {
+        TBSYS_LOG(WARN, "invalid param, tablet_image_=%p, block_keys=%p, block_count=%ld",
+                  tablet_image_, block_keys, block_count);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (NULL == (reader = get_sstable_reader(block_keys[0].sstable_id, tablet)))
+      {
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else if (NULL == (schema = reader->get_schema())
+               || NULL == (column_def = schema->get_column_def(0)))
+      {
+        TBSYS_LOG(WARN, "sstable has no schema, sstable_id=%lu", block_keys[0].sstable_id);
+        ret = OB_ERROR;
+      }
+      else
+      {
+        const ObSSTableTrailer& trailer = reader->get_trailer();
+        table_id = column_def->table_id_;
+        memset(&info, 0, sizeof(info));
+        info.sstable_file_id_ = reader->get_sstable_id().sstable_file_id_;
+        info.offset_ = trailer.get_block_index_record_offset();
+        info.size_   = trailer.get_block_index_record_size();
+
+        //load block index into cache
+        ret = index_cache.get_end_key(info, table_id, end_key);
+        if (OB_SUCCESS != ret)
+        {
+          TBSYS_LOG(WARN, "failed to load block index, sstable_id=%lu, table_id=%lu, ret=%d",
+                    info.sstable_file_id_, table_id, ret);
+        }
+      }
+
+      //load blocks into cache, ignore the failure of single block
+      for (int64_t i = 0; OB_SUCCESS == ret && i < block_count; ++i)
+      {
+        if (block_keys[i].sstable_id != info.sstable_file_id_)
+        {
+          TBSYS_LOG(WARN, "block isn't in the same sstable, sstable_id=%lu, expected=%lu",
+                    block_keys[i].sstable_id, info.sstable_file_id_);
+        }
+        else
+        {
+          block_size = block_cache.get_block(block_keys[i].sstable_id, block_keys[i].offset, 
+                                             block_keys[i].size, handler, table_id);
+          if (block_size != block_keys[i].size)
+          {
+            TBSYS_LOG(DEBUG, "get block return unexpected block size, expected block "
+                             "size=%ld, get block size=%d", 
+                      block_keys[i].size, block_size);
+          }
+          else
+          {
+            loaded_size += block_size;
+          }
+        }
+      }
+
+      if (NULL != tablet && OB_SUCCESS != tablet_image_->release_tablet(tablet))
+      {
+        TBSYS_LOG(WARN, "failed to release tablet, tablet=%p", tablet);
+      }
+
+      return ret;
+    }
   } // end namespace chunkserver
 } // end namespace oceanbase
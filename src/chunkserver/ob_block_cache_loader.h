@@ -65,6 +65,30 @@ namespace oceanbase
                                 const common::ObRowkey& rowkey,
                                 sstable::ObSSTableReader* sstable_reader = NULL);
 
+      /**
+       * load blocks of one sstable into cache by block position, 
+       * the block index of the sstable is loaded into index cache 
+       * too. it's used to warm up cache with the blocks recorded in 
+       * cache snapshot. 
+       *  
+       * @param index_cache block index cache which stores block index 
+       *                    data
+       * @param block_cache block cache which stores block data 
+       * @param block_keys positions of blocks to load, all the blocks 
+       *                   must belong to the same sstable
+       * @param block_count count of blocks to load 
+       * @param loaded_size [out] total size of blocks loaded 
+       * 
+       * @return int if success,return OB_SUCCESS, if the sstable 
+       *         isn't in tablet image, return OB_ENTRY_NOT_EXIST,
+       *         else return OB_ERROR
+       */
+      int load_blocks_into_cache(sstable::ObBlockIndexCache& index_cache, 
+                                 sstable::ObBlockCache& block_cache,
+                                 const sstable::ObDataIndexKey* block_keys,
+                                 const int64_t block_count,
+                                 int64_t& loaded_size);
+
       /**
        * set tablet image for this block cache reader, the tablet 
        * image is used to find the sstable reader by key.
@@ -140,6 +164,18 @@ namespace oceanbase
                                                    const common::ObRowkey& rowkey,
                                                    ObTablet*& tablet);
 
+      /**
+       * get sstable reader by sstable id
+       *  
+       * @param sstable_id sstable id to search 
+       * @param tablet tablet which the reader belongs to 
+       * 
+       * @return ObSSTableReader* return the sstable reader, if fail, 
+       *         return NULL.
+       */
+      sstable::ObSSTableReader* get_sstable_reader(const uint64_t sstable_id, 
+                                                   ObTablet*& tablet);
+
     private:
       DISALLOW_COPY_AND_ASSIGN(ObBlockCacheLoader);
 
@@ -0,0 +1,493 @@
+/**
+ * (C) 2010-2012 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * ob_cache_snapshot.cpp for persist hot block positions and warm
+ * up block cache after chunkserver restart.
+ *
+ */
+#include <algorithm>
+#include "common/ob_crc64.h"
+#include "common/ob_record_header.h"
+#include "common/file_utils.h"
+#include "common/file_directory_utils.h"
+#include "sstable/ob_disk_path.h"
+#include "ob_tablet_manager.h"
+#include "ob_cache_snapshot.h"
+
+namespace oceanbase
+{
+  namespace chunkserver
+  {
+    using namespace tbsys;
+    using namespace oceanbase::common;
+    using namespace oceanbase::sstable;
+
+    static const char* CACHE_SNAPSHOT_FILE_NAME = "cache_snapshot";
+
+    struct HotterEntryCompare
+    {
+      bool operator()(const ObCacheSnapshot::Entry& lhs, const ObCacheSnapshot::Entry& rhs) const
+      {
+        return lhs.access_time_ > rhs.access_time_;
+      }
+    };
+
+    struct EntryPositionCompare
+    {
+      bool operator()(const ObCacheSnapshot::Entry& lhs, const ObCacheSnapshot::Entry& rhs) const
+      {
+        return (lhs.key_.sstable_id < rhs.key_.sstable_id
+                || (lhs.key_.sstable_id == rhs.key_.sstable_id
+                    && lhs.key_.offset < rhs.key_.offset));
+      }
+    };
+
+    ObCacheSnapshot::ObCacheSnapshot()
+    : inited_(false),
+      is_warming_up_(false),
+      snapshot_interval_(0),
+      warmup_bandwidth_(0),
+      tablet_manager_(NULL)
+    {
+    }
+
+    ObCacheSnapshot::~ObCacheSnapshot()
+    {
+      destroy();
+    }
+
+    int ObCacheSnapshot::init(ObTabletManager* manager, const int64_t snapshot_interval,
+                              const int64_t warmup_bandwidth)
+    {
+      int ret = OB_SUCCESS;
+
+      if (NULL == manager || snapshot_interval < 0 || warmup_bandwidth < 0)
+      {
+        TBSYS_LOG(WARN, "invalid param, manager=%p, snapshot_interval=%ld, warmup_bandwidth=%ld",
+                  manager, snapshot_interval, warmup_bandwidth);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (!inited_)
+      {
+        tablet_manager_ = manager;
+        snapshot_interval_ = snapshot_interval;
+        warmup_bandwidth_ = warmup_bandwidth;
+        cache_loader_.set_tablet_image(&manager->get_serving_tablet_image());
+        setThreadCount(1);
+        start();
+        inited_ = true;
+      }
+
+      return ret;
+    }
+
+    void ObCacheSnapshot::destroy()
+    {
+      if (inited_)
+      {
+        inited_ = false;
+        //stop the thread
+        stop();
+        //signal
+        cond_.lock();
+        cond_.broadcast();
+        cond_.unlock();
+        //join
+        wait();
+      }
+    }
+
+    void ObCacheSnapshot::run(CThread* thread, void* arg)
+    {
+      UNUSED(thread);
+      UNUSED(arg);
+
+      TBSYS_LOG(INFO, "cache snapshot thread start run, snapshot_interval=%ld, "
+                      "warmup_bandwidth=%ld",
+                snapshot_interval_, warmup_bandwidth_);
+      if (warmup_bandwidth_ > 0)
+      {
+        warm_up();
+      }
+
+      while (!_stop)
+      {
+        cond_.lock();
+        if (!_stop)
+        {
+          if (snapshot_interval_ > 0)
+          {
+            cond_.wait(static_cast<int>(snapshot_interval_ / 1000));
+          }
+          else
+          {
+            cond_.wait();
+          }
+        }
+        cond_.unlock();
+
+        if (!_stop && snapshot_interval_ > 0)
+        {
+          dump();
+        }
+      }
+    }
+
+    int ObCacheSnapshot::get_snapshot_path(char* path, const int64_t path_len) const
+    {
+      int ret = OB_SUCCESS;
+      int32_t disk_num = 0;
+      char dir[OB_MAX_FILE_NAME_LENGTH];
+      const int32_t* disk_no_array =
+        tablet_manager_->get_disk_manager().get_disk_no_array(disk_num);
+
+      if (NULL == disk_no_array || disk_num <= 0)
+      {
+        TBSYS_LOG(WARN, "no disk to store cache snapshot, disk_num=%d", disk_num);
+        ret = OB_ERROR;
+      }
+      else if (OB_SUCCESS != (ret = get_sstable_directory(disk_no_array[0], dir, sizeof(dir))))
+      {
+        TBSYS_LOG(WARN, "get sstable directory error, disk_no=%d, ret=%d",
+                  disk_no_array[0], ret);
+      }
+      else
+      {
+        int bufsiz = snprintf(path, path_len, "%s/%s", dir, CACHE_SNAPSHOT_FILE_NAME);
+        if (bufsiz + 1 > path_len)
+        {
+          TBSYS_LOG(WARN, "get_snapshot_path, path_len=%ld <= bufsiz=%d", path_len, bufsiz);
+          ret = OB_SIZE_OVERFLOW;
+        }
+      }
+
+      return ret;
+    }
+
+    int64_t ObCacheSnapshot::collect_entries(ObBlockCache& block_cache, Entry* entries)
+    {
+      int64_t entry_num = 0;
+      ObDataIndexKey data_index;
+      ObBufferHandle handle;
+
+      Entry entry;
+
+      // traverse the whole cache and keep the hottest entries in a heap
+      // whose top is the coldest one, so a big cache isn't cut off in
+      // iteration order
+      while (!_stop && OB_SUCCESS == block_cache.get_next_block(data_index, handle))
+      {
+        entry.key_ = data_index;
+        entry.access_time_ = block_cache.get_iter_access_time(handle);
+        if (entry_num < MAX_SNAPSHOT_ENTRY_NUM)
+        {
+          entries[entry_num++] = entry;
+          std::push_heap(entries, entries + entry_num, HotterEntryCompare());
+        }
+        else if (entry.access_time_ > entries[0].access_time_)
+        {
+          std::pop_heap(entries, entries + entry_num, HotterEntryCompare());
+          entries[entry_num - 1] = entry;
+          std::push_heap(entries, entries + entry_num, HotterEntryCompare());
+        }
+      }
+
+      return entry_num;
+    }
+
+    int ObCacheSnapshot::write_snapshot(const char* path, const Entry* entries,
+                                        const int64_t entry_num)
+    {
+      int ret = OB_SUCCESS;
+      int64_t pos = 0;
+      int64_t data_len = entry_num * static_cast<int64_t>(sizeof(Entry));
+      char tmp_path[OB_MAX_FILE_NAME_LENGTH];
+      char header_buf[OB_RECORD_HEADER_LENGTH];
+      ObRecordHeader record_header;
+      FileUtils file;
+
+      record_header.set_magic_num(CACHE_SNAPSHOT_MAGIC);
+      record_header.header_length_ = OB_RECORD_HEADER_LENGTH;
+      record_header.version_ = 0;
+      record_header.reserved_ = 0;
+      record_header.data_length_ = static_cast<int32_t>(data_len);
+      record_header.data_zlength_ = record_header.data_length_;
+      record_header.data_checksum_ = ob_crc64(entries, data_len);
+      record_header.set_header_checksum();
+
+      if (OB_SUCCESS != (ret = record_header.serialize(header_buf, sizeof(header_buf), pos)))
+      {
+        TBSYS_LOG(WARN, "serialize record header error, ret=%d", ret);
+      }
+      else if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) + 1
+               > static_cast<int64_t>(sizeof(tmp_path)))
+      {
+        TBSYS_LOG(WARN, "cache snapshot path is too long, path=%s", path);
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else if (file.open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644) < 0)
+      {
+        TBSYS_LOG(WARN, "open %s for write error, %s", tmp_path, strerror(errno));
+        ret = OB_IO_ERROR;
+      }
+      else
+      {
+        if (pos != file.write(header_buf, pos)
+            || data_len != file.write(reinterpret_cast<const char*>(entries), data_len, true))
+        {
+          TBSYS_LOG(WARN, "write cache snapshot %s error, %s", tmp_path, strerror(errno));
+          ret = OB_IO_ERROR;
+        }
+        file.close();
+
+        if (OB_SUCCESS == ret && !FileDirectoryUtils::rename(tmp_path, path))
+        {
+          TBSYS_LOG(WARN, "rename %s to %s error", tmp_path, path);
+          ret = OB_IO_ERROR;
+        }
+      }
+
+      return ret;
+    }
+
+    int ObCacheSnapshot::dump()
+    {
+      int ret = OB_SUCCESS;
+      int64_t entry_num = 0;
+      int64_t start_time = tbsys::CTimeUtil::getTime();
+      Entry* entries = NULL;
+      char path[OB_MAX_FILE_NAME_LENGTH];
+
+      if (NULL == tablet_manager_)
+      {
+        ret = OB_NOT_INIT;
+      }
+      else if (is_warming_up_)
+      {
+        // the cache is being filled by snapshot, keep the old one
+      }
+      else if (OB_SUCCESS != (ret = get_snapshot_path(path, sizeof(path))))
+      {
+        TBSYS_LOG(WARN, "get cache snapshot path error, ret=%d", ret);
+      }
+      else if (NULL == (entries = reinterpret_cast<Entry*>(
+              ob_malloc(MAX_SNAPSHOT_ENTRY_NUM * sizeof(Entry), ObModIds::OB_CS_COMMON))))
+      {
+        TBSYS_LOG(WARN, "allocate memory for cache snapshot error, entry_num=%ld",
+                  MAX_SNAPSHOT_ENTRY_NUM);
+        ret = OB_ALLOCATE_MEMORY_FAILED;
+      }
+      else
+      {
+        entry_num = collect_entries(tablet_manager_->get_serving_block_cache(), entries);
+        if (entry_num > 0)
+        {
+          std::sort_heap(entries, entries + entry_num, HotterEntryCompare());
+          ret = write_snapshot(path, entries, entry_num);
+        }
+        TBSYS_LOG(INFO, "dump cache snapshot %s, entry_num=%ld, ret=%d, cost=%ld",
+                  path, entry_num, ret, tbsys::CTimeUtil::getTime() - start_time);
+      }
+
+      if (NULL != entries)
+      {
+        ob_free(entries);
+      }
+
+      return ret;
+    }
+
+    int ObCacheSnapshot::read_snapshot(const char* path, char*& buf, Entry*& entries,
+                                       int64_t& entry_num)
+    {
+      int ret = OB_SUCCESS;
+      int64_t file_size = FileDirectoryUtils::get_size(path);
+      const char* payload_ptr = NULL;
+      int64_t payload_size = 0;
+      ObRecordHeader record_header;
+      FileUtils file;
+
+      buf = NULL;
+      entries = NULL;
+      entry_num = 0;
+      if (file_size <= OB_RECORD_HEADER_LENGTH)
+      {
+        TBSYS_LOG(WARN, "invalid cache snapshot %s, file_size=%ld", path, file_size);
+        ret = OB_ERROR;
+      }
+      else if (NULL == (buf = reinterpret_cast<char*>(
+              ob_malloc(file_size, ObModIds::OB_CS_COMMON))))
+      {
+        TBSYS_LOG(WARN, "allocate memory for cache snapshot error, file_size=%ld", file_size);
+        ret = OB_ALLOCATE_MEMORY_FAILED;
+      }
+      else if (file.open(path, O_RDONLY) < 0)
+      {
+        TBSYS_LOG(WARN, "open %s for read error, %s", path, strerror(errno));
+        ret = OB_IO_ERROR;
+      }
+      else
+      {
+        if (file_size != file.read(buf, file_size))
+        {
+          TBSYS_LOG(WARN, "read cache snapshot %s error, %s", path, strerror(errno));
+          ret = OB_IO_ERROR;
+        }
+        file.close();
+
+        if (OB_SUCCESS == ret
+            && OB_SUCCESS != (ret = ObRecordHeader::check_record(buf, file_size,
+                CACHE_SNAPSHOT_MAGIC, record_header, payload_ptr, payload_size)))
+        {
+          TBSYS_LOG(WARN, "check cache snapshot %s error, ret=%d", path, ret);
+        }
+        else if (OB_SUCCESS == ret)
+        {
+          entries = reinterpret_cast<Entry*>(const_cast<char*>(payload_ptr));
+          entry_num = payload_size / static_cast<int64_t>(sizeof(Entry));
+        }
+      }
+
+      if (OB_SUCCESS != ret && NULL != buf)
+      {
+        ob_free(buf);
+        buf = NULL;
+      }
+
+      return ret;
+    }
+
+    int ObCacheSnapshot::load_batch(Entry* entries, const int64_t entry_num,
+                                    int64_t& loaded_size)
+    {
+      int ret = OB_SUCCESS;
+      int err = OB_SUCCESS;
+      int64_t start = 0;
+      int64_t sstable_loaded_size = 0;
+      ObDataIndexKey keys[WARMUP_BATCH_SIZE];
+      ObMultiVersionTabletImage& tablet_image = tablet_manager_->get_serving_tablet_image();
+
+      loaded_size = 0;
+      if (NULL == entries || entry_num <= 0 || entry_num > WARMUP_BATCH_SIZE)
+      {
+        TBSYS_LOG(WARN, "invalid param, entries=%p, entry_num=%ld", entries, entry_num);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (ret = cache_loader_.set_tablet_version(
+              tablet_image.get_serving_version())))
+      {
+        TBSYS_LOG(WARN, "set tablet version error, ret=%d", ret);
+      }
+      else
+      {
+        // read blocks of one sstable in offset order
+        std::sort(entries, entries + entry_num, EntryPositionCompare());
+        for (int64_t i = 0; i < entry_num; ++i)
+        {
+          keys[i] = entries[i].key_;
+        }
+
+        for (int64_t i = 1; i <= entry_num && !_stop; ++i)
+        {
+          if (i == entry_num || keys[i].sstable_id != keys[start].sstable_id)
+          {
+            err = cache_loader_.load_blocks_into_cache(
+                tablet_manager_->get_serving_block_index_cache(),
+                tablet_manager_->get_serving_block_cache(),
+                keys + start, i - start, sstable_loaded_size);
+            if (OB_SUCCESS == err)
+            {
+              loaded_size += sstable_loaded_size;
+            }
+            else if (OB_ENTRY_NOT_EXIST != err)
+            {
+              // sstable which isn't in tablet image is just skipped
+              TBSYS_LOG(WARN, "load blocks of sstable into cache error, sstable_id=%lu, "
+                              "block_count=%ld, err=%d",
+                        keys[start].sstable_id, i - start, err);
+            }
+            start = i;
+          }
+        }
+      }
+
+      return ret;
+    }
+
+    void ObCacheSnapshot::throttle(const int64_t start_time, const int64_t loaded_size)
+    {
+      int64_t expect_time = loaded_size * 1000000 / warmup_bandwidth_;
+      int64_t elapsed_time = tbsys::CTimeUtil::getTime() - start_time;
+
+      if (expect_time - elapsed_time >= 1000)
+      {
+        cond_.lock();
+        if (!_stop)
+        {
+          cond_.wait(static_cast<int>((expect_time - elapsed_time) / 1000));
+        }
+        cond_.unlock();
+      }
+    }
+
+    int ObCacheSnapshot::warm_up()
+    {
+      int ret = OB_SUCCESS;
+      int64_t entry_num = 0;
+      int64_t batch_num = 0;
+      int64_t batch_loaded_size = 0;
+      int64_t loaded_size = 0;
+      int64_t start_time = tbsys::CTimeUtil::getTime();
+      char* buf = NULL;
+      Entry* entries = NULL;
+      char path[OB_MAX_FILE_NAME_LENGTH];
+
+      is_warming_up_ = true;
+      if (NULL == tablet_manager_ || warmup_bandwidth_ <= 0)
+      {
+        ret = OB_NOT_INIT;
+      }
+      else if (OB_SUCCESS != (ret = get_snapshot_path(path, sizeof(path))))
+      {
+        TBSYS_LOG(WARN, "get cache snapshot path error, ret=%d", ret);
+      }
+      else if (!FileDirectoryUtils::exists(path))
+      {
+        TBSYS_LOG(INFO, "cache snapshot %s doesn't exist, skip warm up", path);
+      }
+      else if (OB_SUCCESS != (ret = read_snapshot(path, buf, entries, entry_num)))
+      {
+        TBSYS_LOG(WARN, "read cache snapshot %s error, ret=%d", path, ret);
+      }
+      else
+      {
+        TBSYS_LOG(INFO, "start warm up cache by snapshot %s, entry_num=%ld", path, entry_num);
+        // entries are sorted by hotness, load the hottest first
+        for (int64_t i = 0; i < entry_num && !_stop; i += batch_num)
+        {
+          batch_num = std::min(WARMUP_BATCH_SIZE, entry_num - i);
+          if (OB_SUCCESS != (ret = load_batch(entries + i, batch_num, batch_loaded_size)))
+          {
+            break;
+          }
+          loaded_size += batch_loaded_size;
+          throttle(start_time, loaded_size);
+        }
+        TBSYS_LOG(INFO, "finish warm up cache, entry_num=%ld, loaded_size=%ld, ret=%d, cost=%ld",
+                  entry_num, loaded_size, ret, tbsys::CTimeUtil::getTime() - start_time);
+      }
+
+      if (NULL != buf)
+      {
+        ob_free(buf);
+      }
+      is_warming_up_ = false;
+
+      return ret;
+    }
+  } /* chunkserver */
+} /* oceanbase */
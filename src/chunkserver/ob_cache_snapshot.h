@@ -0,0 +1,113 @@
+/**
+ * (C) 2010-2012 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * ob_cache_snapshot.h for persist hot block positions and warm
+ * up block cache after chunkserver restart.
+ *
+ */
+#ifndef OCEANBASE_CHUNKSERVER_OB_CACHE_SNAPSHOT_H_
+#define OCEANBASE_CHUNKSERVER_OB_CACHE_SNAPSHOT_H_
+
+#include <tbsys.h>
+#include "sstable/ob_blockcache.h"
+#include "ob_block_cache_loader.h"
+
+namespace oceanbase
+{
+  namespace chunkserver
+  {
+    class ObTabletManager;
+
+    /**
+     * cache snapshot thread.
+     *
+     * every snapshot interval, traverse the serving block cache,
+     * sort the block positions (sstable id, offset, size) by the
+     * last access time of the memblock which the block belongs to,
+     * and write the hottest ones into the snapshot file in the
+     * sstable directory of the first disk.
+     *
+     * when the thread starts after tablets loaded, read the
+     * snapshot file and load the blocks and their block indexes
+     * into serving cache through ObBlockCacheLoader, hottest
+     * first, the read bandwidth is limited by warmup_bandwidth.
+     * blocks whose sstable isn't in the tablet image any more are
+     * skipped.
+     */
+    class ObCacheSnapshot : public tbsys::CDefaultRunnable
+    {
+      public:
+        static const int16_t CACHE_SNAPSHOT_MAGIC = static_cast<int16_t>(0xCA5E);
+        static const int64_t MAX_SNAPSHOT_ENTRY_NUM = 512 * 1024;
+        static const int64_t WARMUP_BATCH_SIZE = 128;
+
+        struct Entry
+        {
+          sstable::ObDataIndexKey key_;
+          int64_t access_time_;
+        };
+
+      public:
+        ObCacheSnapshot();
+        ~ObCacheSnapshot();
+
+        /**
+         * start snapshot thread
+         *
+         * @param manager tablet manager
+         * @param snapshot_interval interval to dump snapshot, 0 means
+         *                          don't dump
+         * @param warmup_bandwidth read bytes per second when warm up
+         *                         cache, 0 means don't warm up
+         */
+        int init(ObTabletManager* manager, const int64_t snapshot_interval,
+                 const int64_t warmup_bandwidth);
+        void destroy();
+
+        void run(tbsys::CThread* thread, void* arg);
+
+        /**
+         * dump the hottest blocks of serving block cache into snapshot
+         * file, it replaces the old snapshot file.
+         */
+        int dump();
+
+        /**
+         * load blocks in snapshot file into serving cache
+         */
+        int warm_up();
+
+        inline bool is_warming_up() const
+        {
+          return is_warming_up_;
+        }
+
+      private:
+        int get_snapshot_path(char* path, const int64_t path_len) const;
+        // collect at most MAX_SNAPSHOT_ENTRY_NUM hottest entries as a heap
+        int64_t collect_entries(sstable::ObBlockCache& block_cache, Entry* entries);
+        int write_snapshot(const char* path, const Entry* entries, const int64_t entry_num);
+        int read_snapshot(const char* path, char*& buf, Entry*& entries,
+                          int64_t& entry_num);
+        int load_batch(Entry* entries, const int64_t entry_num, int64_t& loaded_size);
+        void throttle(const int64_t start_time, const int64_t loaded_size);
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObCacheSnapshot);
+
+        bool inited_;
+        volatile bool is_warming_up_;
+        int64_t snapshot_interval_;
+        int64_t warmup_bandwidth_;
+        ObTabletManager* tablet_manager_;
+        ObBlockCacheLoader cache_loader_;
+        tbsys::CThreadCond cond_;
+    };
+  } /* chunkserver */
+} /* oceanbase */
+
+#endif // OCEANBASE_CHUNKSERVER_OB_CACHE_SNAPSHOT_H_
@@ -47,7 +47,8 @@ namespace oceanbase
                                    round_start_(true),round_end_(true), pending_in_upgrade_(false),
                                    merge_load_high_(0),request_count_high_(0), merge_adjust_ratio_(0),
                                    merge_load_adjust_(0), merge_pause_row_count_(0), merge_pause_sleep_time_(0),
-                                   merge_highload_sleep_time_(0), tablet_manager_(NULL)
+                                   merge_highload_sleep_time_(0), min_merge_thread_num_(0),
+                                   merge_adaptive_schedule_(false), tablet_manager_(NULL)
     {
       //memset(reinterpret_cast<void *>(&pending_merge_),0,sizeof(pending_merge_));
       for(uint32_t i=0; i < sizeof(pending_merge_) / sizeof(pending_merge_[0]); ++i)
@@ -67,6 +68,12 @@ namespace oceanbase
       merge_pause_row_count_ = chunk_server.get_config().merge_pause_row_count;
       merge_pause_sleep_time_ = chunk_server.get_config().merge_pause_sleep_time;
       merge_highload_sleep_time_ = chunk_server.get_config().merge_highload_sleep_time;
+      merge_adaptive_schedule_ = chunk_server.get_config().merge_adaptive_schedule;
+      merge_scheduler_.set_param(chunk_server.get_config().merge_adjust_interval,
+          chunk_server.get_config().merge_read_latency_high,
+          chunk_server.get_config().merge_disk_util_high,
+          chunk_server.get_config().merge_disk_util_low,
+          chunk_server.get_config().merge_thread_per_disk);
     }
 
     int ObChunkMerge::create_merge_threads(const int64_t max_merge_thread)
@@ -121,6 +128,10 @@ namespace oceanbase
         int64_t max_merge_thread = chunk_server.get_config().max_merge_thread_num;
         if (max_merge_thread <= 0 || max_merge_thread > MAX_MERGE_THREAD)
           max_merge_thread = MAX_MERGE_THREAD;
+        // sub ranges of all merging tablets share these threads
+        int64_t sub_merge_thread = chunk_server.get_config().merge_sub_range_thread_num;
+        if (sub_merge_thread > ObTabletMergerV2::MAX_SUB_MERGE_NUM)
+          sub_merge_thread = ObTabletMergerV2::MAX_SUB_MERGE_NUM;
 
         set_config_param();
         if (OB_SUCCESS != (ret = create_merge_threads(max_merge_thread)))
@@ -131,6 +142,12 @@ namespace oceanbase
         {
           TBSYS_LOG(ERROR, "create_all_tablet_mergers error, ret=%d", ret);
         }
+        else if (sub_merge_thread > 1
+            && OB_SUCCESS != sub_merge_pool_.init(sub_merge_thread))
+        {
+          // big tablets are merged in one thread as before
+          TBSYS_LOG(WARN, "start sub merge pool error, sub_merge_thread=%ld", sub_merge_thread);
+        }
       }
       else
       {
@@ -160,6 +177,7 @@ namespace oceanbase
         usleep(50);
 
         wait();
+        sub_merge_pool_.destroy();
         pthread_cond_destroy(&cond_);
         pthread_mutex_destroy(&mutex_);
         destroy_all_tablets_mergers();
@@ -447,6 +465,10 @@ namespace oceanbase
 
             volatile uint32_t *ref = &pending_merge_[ tablet->get_disk_no() ];
             int err = OB_SUCCESS;
+            if (merge_adaptive_schedule_)
+            {
+              merge_per_disk = merge_scheduler_.get_disk_merge_limit(tablet->get_disk_no());
+            }
             if (*ref < merge_per_disk)
             {
               atomic_inc(ref);
@@ -598,6 +620,12 @@ namespace oceanbase
       {
         TBSYS_LOG(INFO, "new merge process, version=%ld, frozen_timestamp_=%ld",
             frozen_version, frozen_timestamp_);
+        if (merge_adaptive_schedule_ && OB_SUCCESS != merge_scheduler_.init(
+              tablet_manager_->get_disk_manager(), THE_CHUNK_SERVER.get_config().datadir,
+              min_merge_thread_num_, thread_num_))
+        {
+          TBSYS_LOG(WARN, "init merge scheduler failed, merge threads will not be adjusted.");
+        }
       }
 
       return ret;
@@ -811,6 +839,10 @@ namespace oceanbase
 
 
       pthread_mutex_lock(&mutex_);
+      if (merge_adaptive_schedule_)
+      {
+        merge_scheduler_.adjust();
+      }
       if (active_thread_num_ <= min_merge_thread_num_)
       {
         TBSYS_LOG(INFO, "current active thread :%ld < min merge thread: %ld, continue run.",
@@ -825,7 +857,29 @@ namespace oceanbase
         int64_t sleep_thread = thread_num_ - active_thread_num_;
         int64_t remain_load = merge_load_high_ - static_cast<int64_t>(loadavg[0]) - 1; //loadavg[0] double to int
         int64_t remain_tablet = tablets_num_ - tablets_have_got_;
-        if ((loadavg[0] < merge_load_adjust_) &&
+        if (merge_adaptive_schedule_)
+        {
+          // thread number is decided by read latency and disk utilization
+          int64_t target_thread = merge_scheduler_.get_target_thread_num();
+          if (active_thread_num_ > target_thread && active_thread_num_ > min_merge_thread_num_)
+          {
+            TBSYS_LOG(INFO, "active merge thread:%ld > target:%ld, go to sleep",
+                active_thread_num_, target_thread);
+            ret = false;
+          }
+          else if ((remain_tablet > active_thread_num_) && (sleep_thread > 0)
+              && (target_thread > active_thread_num_))
+          {
+            int64_t wake_thread = target_thread - active_thread_num_;
+            wake_thread = sleep_thread > wake_thread ? wake_thread : sleep_thread;
+            TBSYS_LOG(INFO, "wake up %ld thread(s), target merge thread:%ld", wake_thread, target_thread);
+            while (wake_thread-- > 0)
+            {
+              pthread_cond_signal(&cond_);
+            }
+          }
+        }
+        else if ((loadavg[0] < merge_load_adjust_) &&
             (remain_tablet > active_thread_num_) &&
             (sleep_thread > 0) && (remain_load > 0) )
         {
@@ -22,6 +22,8 @@
 #include "common/ob_schema.h"
 #include "common/ob_vector.h"
 #include "common/thread_buffer.h"
+#include "ob_merge_scheduler.h"
+#include "ob_sub_merge_pool.h"
 
 
 namespace oceanbase
@@ -137,6 +139,9 @@ namespace oceanbase
         int64_t merge_pause_sleep_time_;
         int64_t merge_highload_sleep_time_;
         int64_t min_merge_thread_num_;
+        bool merge_adaptive_schedule_;
+        ObMergeScheduler merge_scheduler_;
+        ObSubMergePool sub_merge_pool_;
 
         common::ObSchemaManagerV2 last_schema_;
         common::ObSchemaManagerV2 current_schema_;
@@ -73,6 +73,8 @@ namespace oceanbase
         DEF_CAP(merge_mem_limit, "64MB", "memory usage to merge for each thread");
         DEF_INT(merge_thread_per_disk, "2", "[1,]", "merge thread per disk, increase the number will reduce daily merge time but increase response time");
         DEF_INT(max_merge_thread_num, "10", "[1,32]", "max merge thread number");
+        DEF_INT(merge_sub_range_thread_num, "1", "[1,16]", "number of threads shared by all merge threads to merge sub ranges of big tablets concurrently, a big tablet is split into this number of sub ranges by sstable block endkeys, 1 means disable, take effect after restart");
+        DEF_CAP(min_sub_range_merge_tablet_size, "1GB", "only tablets not smaller than this size are merged by sub ranges");
         DEF_INT(merge_threshold_load_high, "16", "[1,]", "suspend some merge threads if system load beyond this value");
         DEF_INT(merge_threshold_request_high, "3000", "[1,]", "suspend some merge threads if get/scan number beyond this value");
         DEF_TIME(merge_delay_interval, "600s", "(0,]", "sleep time before start merge");
@@ -84,6 +86,11 @@ namespace oceanbase
         DEF_TIME(merge_pause_sleep_time, "0", "sleep time for each merge check");
         DEF_TIME(merge_highload_sleep_time, "2s", "sleep time if system load beyond \\'merge_threashold_load_high\\' in merge check");
         DEF_INT(merge_adjust_ratio, "80", "when the load is greater than this ratio of merge_load_high, slow down daily merge");
+        DEF_BOOL(merge_adaptive_schedule, "False", "adjust merge thread number and merges per disk by read latency and disk utilization");
+        DEF_TIME(merge_adjust_interval, "1s", "(0,]", "interval to sample read latency and disk utilization for merge schedule");
+        DEF_TIME(merge_read_latency_high, "10ms", "(0,]", "reduce merge threads if average get/scan latency beyond this value");
+        DEF_INT(merge_disk_util_high, "80", "[1,100]", "reduce merges on a disk if its utilization percent beyond this value");
+        DEF_INT(merge_disk_util_low, "50", "[0,100]", "add merges on a disk if its utilization percent below this value");
         DEF_INT(max_version_gap, "3", "[1,]", "use to judge if the seving version is too old, maybe need not to merge");
         DEF_TIME(min_merge_interval, "10s", "minimal merge interval between tow merges");
         DEF_TIME(min_drop_cache_wait_time, "300s", "waiting time before drop previous version cache after merge done");
@@ -92,6 +99,7 @@ namespace oceanbase
         DEF_BOOL(each_tablet_sync_meta, "True", "sync tablet image to index file after merge each tablet");
         DEF_INT(over_size_percent_to_split, "50", "[0,]", "over size percent to split sstable");
         DEF_INT(merge_write_sstable_version, "2", "[1,]", "sstable version, 2 means old sstable format, 3 means new compact sstable");
+        DEF_BOOL(merge_block_encoding, "False", "prefix compress rowkeys and encode columns of DENSE_DENSE compact sstable blocks in merge, only used if the block gets smaller");
 
         DEF_CAP(merge_mem_size, "8MB", "memory for each sub merge round, finish that round if cell array oversize");
         DEF_CAP(max_merge_mem_size, "16MB", "clear memory over this size after each sub merge");
@@ -112,6 +120,14 @@ namespace oceanbase
         DEF_CAP(sstable_row_cache_size, "2GB", "[0,]", "sstable row cache size");
         DEF_INT(file_info_cache_num, "4096", "(0,]", "file info cache number");
         DEF_INT(join_batch_count, "3000", "(0,]", "join row count per round");
+        DEF_BOOL(block_cache_scan_resistant, "False", "use 2Q replace policy in block cache, blocks read by scan and merge are washed out first");
+        DEF_INT(block_cache_probation_percent, "25", "[1,90]", "percent of block cache for blocks read by scan and merge when block_cache_scan_resistant");
+        DEF_BOOL(use_disk_io_engine, "False", "read sstable blocks by per disk async io queues");
+        DEF_INT(disk_io_queue_depth, "32", "[1,128]", "max inflight io number of each disk when use_disk_io_engine");
+        DEF_TIME(cache_snapshot_interval, "0", "[0,]", "interval to persist positions of hot blocks in block cache, 0 means disable");
+        DEF_CAP(cache_warmup_bandwidth, "0", "[0,]", "read bandwidth to warm up block cache by cache snapshot after restart, 0 means disable");
+        DEF_CAP(fused_row_cache_size, "0", "[0,]", "cache size of rows fused with ups data for weak consistency get, 0 means disable");
+        DEF_TIME(fused_row_cache_sync_interval, "100ms", "(0,]", "interval to fetch modified rows from ups to validate fused row cache, cached rows may be stale for this long");
     };
   }
 }
@@ -55,7 +55,7 @@ namespace oceanbase
       service_started_(false), in_register_process_(false),
       service_expired_time_(0),
       migrate_task_count_(0), lease_checker_(this), merge_task_(this),
-      fetch_ups_task_(this)
+      fetch_ups_task_(this), fused_row_cache_sync_task_(this)
 
     {
     }
@@ -189,6 +189,13 @@ namespace oceanbase
           chunk_server_->get_config().fetch_ups_interval, false);
       }
 
+      if (OB_SUCCESS == rc
+          && chunk_server_->get_tablet_manager().get_fused_row_cache().is_inited())
+      {
+        rc = timer_.schedule(fused_row_cache_sync_task_,
+          chunk_server_->get_config().fused_row_cache_sync_interval, false);
+      }
+
       if (OB_SUCCESS == rc)
       {
         rc = timer_.schedule(time_update_duty_, TimeUpdateDuty::SCHEDULE_PERIOD, true);
@@ -225,6 +232,15 @@ namespace oceanbase
             TBSYS_LOG(ERROR, "start bypass sstable loader threads failed, ret=%d", rc);
           }
         }
+
+        if (OB_SUCCESS == rc && (chunk_server_->get_config().cache_snapshot_interval > 0
+              || chunk_server_->get_config().cache_warmup_bandwidth > 0))
+        {
+          if (OB_SUCCESS != (rc = tablet_manager.start_cache_snapshot_thread()))
+          {
+            TBSYS_LOG(ERROR, "start cache snapshot thread failed, ret=%d", rc);
+          }
+        }
       }
 
       return rc;
@@ -3797,6 +3813,14 @@ namespace oceanbase
         OB_STAT_SET(CHUNKSERVER, INDEX_MU_BLOCK_CACHE, manager.get_serving_block_cache().size());
         OB_STAT_SET(CHUNKSERVER, INDEX_MU_BI_CACHE_UNSERVING, manager.get_unserving_block_index_cache().get_cache_mem_size());
         OB_STAT_SET(CHUNKSERVER, INDEX_MU_BLOCK_CACHE_UNSERVING, manager.get_unserving_block_cache().size());
+        OB_STAT_SET(CHUNKSERVER, INDEX_BLOCK_CACHE_PROBATION_SIZE,
+                    manager.get_serving_block_cache().get_kv_cache().get_probation_size());
+        OB_STAT_SET(CHUNKSERVER, INDEX_BLOCK_CACHE_PROBATION_HIT,
+                    manager.get_serving_block_cache().get_kv_cache().get_probation_hit_cnt());
+        OB_STAT_SET(CHUNKSERVER, INDEX_BLOCK_CACHE_PROTECTED_HIT,
+                    manager.get_serving_block_cache().get_kv_cache().get_protected_hit_cnt());
+        OB_STAT_SET(CHUNKSERVER, INDEX_BLOCK_CACHE_PROMOTE_COUNT,
+                    manager.get_serving_block_cache().get_kv_cache().get_promote_cnt());
         if (manager.get_join_cache().is_inited())
         {
           OB_STAT_SET(CHUNKSERVER, INDEX_MU_JOIN_CACHE, manager.get_join_cache().get_cache_mem_size());
@@ -3873,6 +3897,39 @@ namespace oceanbase
         service_->chunk_server_->get_config().fetch_ups_interval, false);
     }
 
+    int ObChunkService::sync_fused_row_cache()
+    {
+      int err = OB_SUCCESS;
+      ObServer update_server;
+
+      if (NULL == chunk_server_->get_rpc_proxy())
+      {
+        TBSYS_LOG(ERROR, "rpc_proxy_ is NULL");
+        err = OB_NOT_INIT;
+      }
+      else if (OB_SUCCESS != (err = chunk_server_->get_rpc_proxy()->get_update_server(
+              false, update_server)))
+      {
+        TBSYS_LOG(WARN, "get master update server failed:ret[%d]", err);
+      }
+      else
+      {
+        // keep the poll short, a stale cache stops serving by itself.
+        err = chunk_server_->get_tablet_manager().get_fused_row_cache().sync(
+            chunk_server_->get_rpc_stub(), update_server,
+            chunk_server_->get_config().fused_row_cache_sync_interval);
+      }
+
+      return err;
+    }
+
+    void ObChunkService::FusedRowCacheSyncTask::runTimerTask()
+    {
+      service_->sync_fused_row_cache();
+      service_->timer_.schedule(*this,
+        service_->chunk_server_->get_config().fused_row_cache_sync_interval, false);
+    }
+
 
   } // end namespace chunkserver
 } // end namespace oceanbase
@@ -342,6 +342,16 @@ namespace oceanbase
             ObChunkService* service_;
         };
 
+        class FusedRowCacheSyncTask : public common::ObTimerTask
+        {
+          public:
+            FusedRowCacheSyncTask (ObChunkService* service) : service_(service) {}
+          public:
+            virtual void runTimerTask();
+          private:
+            ObChunkService* service_;
+        };
+
       private:
         int check_compress_lib(const char* compress_name_buf);
         int load_tablets();
@@ -356,6 +366,7 @@ namespace oceanbase
         int get_query_service(ObQueryService *&service);
         int reset_internal_status(bool release_table = true);
         int fetch_update_server_list();
+        int sync_fused_row_cache();
       private:
         DISALLOW_COPY_AND_ASSIGN(ObChunkService);
         ObChunkServer* chunk_server_;
@@ -371,6 +382,7 @@ namespace oceanbase
         StatUpdater  stat_updater_;
         MergeTask    merge_task_;
         FetchUpsTask fetch_ups_task_;
+        FusedRowCacheSyncTask fused_row_cache_sync_task_;
         ObMergerSchemaTask fetch_schema_task_;
         common::TimeUpdateDuty time_update_duty_;
         common::MsList ms_list_task_;
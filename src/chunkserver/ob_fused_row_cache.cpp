@@ -0,0 +1,274 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_fused_row_cache.cpp for cache of rows fused with the
+ * incremental data of updateserver.
+ *
+ */
+#include <string.h>
+#include <tblog.h>
+#include "common/utility.h"
+#include "common/ob_general_rpc_stub.h"
+#include "ob_fused_row_cache.h"
+
+namespace oceanbase
+{
+  namespace chunkserver
+  {
+    using namespace oceanbase::common;
+
+    ObFusedRowCache::ObFusedRowCache()
+      : inited_(false), sync_interval_(0), generation_(1), ups_epoch_(0),
+        commited_trans_id_(0), last_sync_time_(0)
+    {
+      memset((void*)slot_trans_ids_, 0, sizeof(slot_trans_ids_));
+    }
+
+    ObFusedRowCache::~ObFusedRowCache()
+    {
+    }
+
+    int ObFusedRowCache::init(const int64_t max_mem_size, const int64_t sync_interval)
+    {
+      int ret = OB_SUCCESS;
+
+      if (inited_)
+      {
+        //do nothing
+      }
+      else if (max_mem_size <= 0 || sync_interval <= 0)
+      {
+        TBSYS_LOG(WARN, "invalid param, max_mem_size=%ld, sync_interval=%ld",
+                  max_mem_size, sync_interval);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != kv_cache_.init(max_mem_size))
+      {
+        TBSYS_LOG(WARN, "init kv cache fail");
+        ret = OB_ERROR;
+      }
+      else
+      {
+        sync_interval_ = sync_interval;
+        inited_ = true;
+        TBSYS_LOG(INFO, "init fused row cache succ, cache_mem_size=%ld, sync_interval=%ld",
+                  max_mem_size, sync_interval);
+      }
+
+      return ret;
+    }
+
+    int ObFusedRowCache::destroy()
+    {
+      inited_ = false;
+      return kv_cache_.destroy();
+    }
+
+    bool ObFusedRowCache::get_snapshot(Snapshot& snapshot) const
+    {
+      bool ret = false;
+      if (inited_)
+      {
+        snapshot.generation_ = generation_;
+        snapshot.trans_id_ = commited_trans_id_;
+        ret = (0 < snapshot.trans_id_
+               && tbsys::CTimeUtil::getTime() - last_sync_time_
+               < sync_interval_ * MAX_SYNC_DELAY_TIMES);
+      }
+      return ret;
+    }
+
+    bool ObFusedRowCache::is_valid(const ObFusedRowCacheKey& key,
+                                   const ObFusedRowCacheValue& value,
+                                   const Snapshot& snapshot) const
+    {
+      return (value.generation_ == snapshot.generation_
+              && snapshot.generation_ == generation_
+              && value.trans_id_ >= slot_trans_ids_[get_row_modify_slot(key.table_id_, key.row_key_)]);
+    }
+
+    int ObFusedRowCache::get_row(const ObFusedRowCacheKey& key, const Snapshot& snapshot,
+                                 ObRow& row, ObRowStore& row_store)
+    {
+      int ret = OB_SUCCESS;
+      int64_t pos = 0;
+      ObObj cell;
+      const ObRowStore::StoredRow* stored_row = NULL;
+      ObFusedRowCacheValue row_val;
+      Handle handle;
+
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (NULL == key.row_key_.get_obj_ptr() || key.row_key_.get_obj_cnt() <= 0)
+      {
+        TBSYS_LOG(WARN, "invalid fused row cache key, =%s", to_cstring(key.row_key_));
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS == (ret = kv_cache_.get(key, row_val, handle)))
+      {
+        if (!is_valid(key, row_val, snapshot))
+        {
+          ret = OB_ENTRY_NOT_EXIST;
+        }
+        for (int64_t i = 0; OB_SUCCESS == ret && i < row.get_column_num(); ++i)
+        {
+          if (OB_SUCCESS != (ret = cell.deserialize(row_val.buf_, row_val.size_, pos)))
+          {
+            TBSYS_LOG(WARN, "deserialize cached cell fail, ret=%d, column_idx=%ld", ret, i);
+          }
+          else if (OB_SUCCESS != (ret = row.raw_set_cell(i, cell)))
+          {
+            TBSYS_LOG(WARN, "set cell fail, ret=%d, column_idx=%ld", ret, i);
+          }
+        }
+        if (OB_SUCCESS == ret && pos != row_val.size_)
+        {
+          TBSYS_LOG(WARN, "cached row size mismatch, size=%ld, pos=%ld", row_val.size_, pos);
+          ret = OB_ERROR;
+        }
+        // the cells point to cache memory, copy them before revert
+        if (OB_SUCCESS == ret
+            && OB_SUCCESS != (ret = row_store.add_row(row, stored_row)))
+        {
+          TBSYS_LOG(WARN, "add cached row to row store fail, ret=%d", ret);
+        }
+        kv_cache_.revert(handle);
+      }
+
+      return ret;
+    }
+
+    int ObFusedRowCache::put_row(const ObFusedRowCacheKey& key, const Snapshot& snapshot,
+                                 const ObRow& row)
+    {
+      int ret = OB_SUCCESS;
+      const ObObj* cell = NULL;
+      uint64_t table_id = OB_INVALID_ID;
+      uint64_t column_id = OB_INVALID_ID;
+      ObFusedRowCacheValue row_val;
+
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (NULL == key.row_key_.get_obj_ptr() || key.row_key_.get_obj_cnt() <= 0)
+      {
+        TBSYS_LOG(WARN, "invalid fused row cache key, =%s", to_cstring(key.row_key_));
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        for (int64_t i = 0; OB_SUCCESS == ret && i < row.get_column_num(); ++i)
+        {
+          if (OB_SUCCESS == (ret = row.raw_get_cell(i, cell, table_id, column_id)))
+          {
+            row_val.size_ += cell->get_serialize_size();
+          }
+        }
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        row_val.row_ = &row;
+        row_val.generation_ = snapshot.generation_;
+        row_val.trans_id_ = snapshot.trans_id_;
+
+        /**
+         * overwrite the stale row of the same key, the row may be put
+         * by another get concurrently, so ignore the return value.
+         */
+        kv_cache_.put(key, row_val, true);
+      }
+
+      return ret;
+    }
+
+    int ObFusedRowCache::sync(const ObGeneralRpcStub& rpc_stub,
+                              const ObServer& update_server, const int64_t timeout)
+    {
+      int ret = OB_SUCCESS;
+
+      if (!inited_)
+      {
+        ret = OB_NOT_INIT;
+      }
+      else if (OB_SUCCESS != (ret = rpc_stub.fetch_row_modify_slots(timeout, update_server,
+              commited_trans_id_, modify_slots_)))
+      {
+        TBSYS_LOG(WARN, "fetch row modify slots from ups=%s fail, last_trans_id=%ld, ret=%d",
+                  to_cstring(update_server), commited_trans_id_, ret);
+      }
+      else
+      {
+        ret = apply_modify_slots(modify_slots_);
+      }
+
+      return ret;
+    }
+
+    int ObFusedRowCache::apply_modify_slots(const ObRowModifySlots& slots)
+    {
+      int ret = OB_SUCCESS;
+      const ObRowModifySlot* slot = NULL;
+      bool epoch_changed = (slots.get_ups_epoch() != ups_epoch_);
+
+      if (epoch_changed || slots.is_overflow())
+      {
+        // rows cached can't be checked any more, drop all of them
+        TBSYS_LOG(INFO, "invalidate fused row cache, ups_epoch=%ld, new_ups_epoch=%ld, "
+                  "is_overflow=%d, generation=%ld",
+                  ups_epoch_, slots.get_ups_epoch(), slots.is_overflow(), generation_);
+        __sync_add_and_fetch(&generation_, 1);
+        ups_epoch_ = slots.get_ups_epoch();
+      }
+      else
+      {
+        for (int64_t i = 0; i < slots.get_slot_count(); ++i)
+        {
+          slot = &slots.get_slot(i);
+          if (slot_trans_ids_[slot->slot_] < slot->trans_id_)
+          {
+            slot_trans_ids_[slot->slot_] = slot->trans_id_;
+          }
+        }
+      }
+
+      // slots must be visible before the rows read after the new
+      // commited trans id are put.
+      __sync_synchronize();
+      if (epoch_changed || commited_trans_id_ < slots.get_commited_trans_id())
+      {
+        commited_trans_id_ = slots.get_commited_trans_id();
+      }
+      last_sync_time_ = tbsys::CTimeUtil::getTime();
+
+      return ret;
+    }
+
+    uint64_t ObFusedRowCache::get_column_signature(const ObRowDesc& row_desc)
+    {
+      uint32_t hash_val = 0;
+      uint64_t table_id = OB_INVALID_ID;
+      uint64_t column_id = OB_INVALID_ID;
+      for (int64_t i = 0; i < row_desc.get_column_num(); ++i)
+      {
+        if (OB_SUCCESS == row_desc.get_tid_cid(i, table_id, column_id))
+        {
+          hash_val = murmurhash2(&table_id, sizeof(table_id), hash_val);
+          hash_val = murmurhash2(&column_id, sizeof(column_id), hash_val);
+        }
+      }
+      return (static_cast<uint64_t>(row_desc.get_column_num()) << 32) | hash_val;
+    }
+  } //end namespace chunkserver
+} //end namespace oceanbase
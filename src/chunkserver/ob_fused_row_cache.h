@@ -0,0 +1,320 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_fused_row_cache.h for cache of rows fused with the
+ * incremental data of updateserver.
+ *
+ */
+#ifndef OCEANBASE_CHUNKSERVER_OB_FUSED_ROW_CACHE_H_
+#define OCEANBASE_CHUNKSERVER_OB_FUSED_ROW_CACHE_H_
+
+#include "common/ob_define.h"
+#include "common/ob_rowkey.h"
+#include "common/ob_row.h"
+#include "common/ob_row_desc.h"
+#include "common/ob_row_store.h"
+#include "common/ob_row_modify_slots.h"
+#include "common/ob_kv_storecache.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    class ObServer;
+    class ObGeneralRpcStub;
+  }
+
+  namespace chunkserver
+  {
+    struct ObFusedRowCacheValue
+    {
+      const common::ObRow* row_;
+      int64_t generation_;
+      int64_t trans_id_;
+      int64_t size_;
+      char* buf_;
+
+      ObFusedRowCacheValue()
+        : row_(NULL), generation_(0), trans_id_(0), size_(0), buf_(NULL)
+      {
+      }
+    };
+
+    struct ObFusedRowCacheKey
+    {
+      uint64_t table_id_;
+      int64_t data_version_;
+      // hash of the columns in the row, rows of different projections
+      // are cached separately.
+      uint64_t column_signature_;
+      int32_t row_key_size_;
+      common::ObRowkey row_key_;
+
+      ObFusedRowCacheKey()
+      {
+        table_id_ = common::OB_INVALID_ID;
+        data_version_ = 0;
+        column_signature_ = 0;
+        row_key_size_ = 0;
+        row_key_.assign(NULL, 0);
+      }
+
+      ObFusedRowCacheKey(const uint64_t table_id_in, const int64_t data_version_in,
+                         const uint64_t column_signature_in, const common::ObRowkey& row_key_in)
+      {
+        table_id_ = table_id_in;
+        data_version_ = data_version_in;
+        column_signature_ = column_signature_in;
+        row_key_size_ = static_cast<int32_t>(row_key_in.get_deep_copy_size());
+        row_key_ = row_key_in;
+      }
+
+      int64_t hash() const
+      {
+        uint32_t hash_val = 0;
+        hash_val = common::murmurhash2(&table_id_, sizeof(table_id_), hash_val);
+        hash_val = common::murmurhash2(&data_version_, sizeof(data_version_), hash_val);
+        hash_val = common::murmurhash2(&column_signature_, sizeof(column_signature_), hash_val);
+        if (NULL != row_key_.get_obj_ptr() && 0 < row_key_.get_obj_cnt())
+        {
+          hash_val = row_key_.murmurhash2(hash_val);
+        }
+        return hash_val;
+      }
+
+      bool operator==(const ObFusedRowCacheKey& other) const
+      {
+        bool ret = ((table_id_ == other.table_id_)
+                    && (data_version_ == other.data_version_)
+                    && (column_signature_ == other.column_signature_)
+                    && (row_key_size_ == other.row_key_size_));
+        if (ret && row_key_size_ > 0)
+        {
+          ret = (row_key_ == other.row_key_);
+        }
+        return ret;
+      }
+    };
+  }
+
+  namespace common
+  {
+    namespace KVStoreCacheComponent
+    {
+      struct ObFusedRowCacheDeepCopyTag
+      {
+      };
+
+      struct ObFusedRowCacheKeyDeepCopyTag
+      {
+      };
+
+      template <>
+      struct traits<chunkserver::ObFusedRowCacheValue>
+      {
+        typedef ObFusedRowCacheDeepCopyTag Tag;
+      };
+
+      template<>
+      struct traits<chunkserver::ObFusedRowCacheKey>
+      {
+        typedef ObFusedRowCacheKeyDeepCopyTag Tag;
+      };
+
+      inline chunkserver::ObFusedRowCacheValue* do_copy(const chunkserver::ObFusedRowCacheValue& other,
+                                                        char* buffer, ObFusedRowCacheDeepCopyTag)
+      {
+        int64_t pos = 0;
+        const ObObj* cell = NULL;
+        uint64_t table_id = OB_INVALID_ID;
+        uint64_t column_id = OB_INVALID_ID;
+        chunkserver::ObFusedRowCacheValue* ret = (chunkserver::ObFusedRowCacheValue*)buffer;
+
+        if (NULL != ret && NULL != other.row_)
+        {
+          ret->row_ = NULL;
+          ret->generation_ = other.generation_;
+          ret->trans_id_ = other.trans_id_;
+          ret->size_ = other.size_;
+          ret->buf_ = buffer + sizeof(chunkserver::ObFusedRowCacheValue);
+          for (int64_t i = 0; NULL != ret && i < other.row_->get_column_num(); ++i)
+          {
+            if (OB_SUCCESS != other.row_->raw_get_cell(i, cell, table_id, column_id)
+                || OB_SUCCESS != cell->serialize(ret->buf_, ret->size_, pos))
+            {
+              ret = NULL;
+            }
+          }
+        }
+
+        return ret;
+      }
+
+      inline chunkserver::ObFusedRowCacheKey* do_copy(const chunkserver::ObFusedRowCacheKey& other,
+                                                      char* buffer, ObFusedRowCacheKeyDeepCopyTag)
+      {
+        chunkserver::ObFusedRowCacheKey* ret = (chunkserver::ObFusedRowCacheKey*)buffer;
+        if (NULL != ret)
+        {
+          ret->table_id_ = other.table_id_;
+          ret->data_version_ = other.data_version_;
+          ret->column_signature_ = other.column_signature_;
+          ret->row_key_.assign(NULL, 0);
+          ret->row_key_size_ = 0;
+          if (NULL != other.row_key_.get_obj_ptr() && 0 < other.row_key_.get_obj_cnt())
+          {
+            ObRawBufAllocatorWrapper temp_buf(buffer + sizeof(chunkserver::ObFusedRowCacheKey),
+                                              other.row_key_size_);
+            other.row_key_.deep_copy(ret->row_key_, temp_buf);
+            ret->row_key_size_ = other.row_key_size_;
+          }
+        }
+        return ret;
+      }
+
+      inline int32_t do_size(const chunkserver::ObFusedRowCacheValue& data,
+                             ObFusedRowCacheDeepCopyTag)
+      {
+        return static_cast<int32_t>((NULL != data.row_ ? (sizeof(chunkserver::ObFusedRowCacheValue)
+                                                          + data.size_) : 0));
+      }
+
+      inline int32_t do_size(const chunkserver::ObFusedRowCacheKey& key,
+                             ObFusedRowCacheKeyDeepCopyTag)
+      {
+        return static_cast<int32_t>(sizeof(chunkserver::ObFusedRowCacheKey) + key.row_key_size_);
+      }
+
+      inline void do_destroy(chunkserver::ObFusedRowCacheValue* data,
+                             ObFusedRowCacheDeepCopyTag)
+      {
+        UNUSED(data);
+      }
+
+      inline void do_destroy(chunkserver::ObFusedRowCacheKey*,
+                             ObFusedRowCacheKeyDeepCopyTag)
+      {
+      }
+    }
+  }
+
+  namespace chunkserver
+  {
+    /**
+     * cache of the rows already fused with updateserver incremental
+     * data, a hit saves the sstable read and the updateserver round
+     * trip of the row.
+     *
+     * updateserver hashes rows into row modify slots and remembers
+     * the trans id of the last mutation of each slot, the sync task
+     * polls the slots modified since the last poll every
+     * sync_interval and keeps a mirror of the slot trans ids here.
+     * a cached row was read from updateserver after the commited
+     * trans id of some poll, it's still valid if its slot isn't
+     * modified after that trans id.
+     *
+     * so a hit may miss the mutations commited in the last
+     * sync_interval, the cache only serves reads not requiring read
+     * consistency. if the poll fails for a while, the cache is not
+     * used at all. all cached rows are dropped (generation changed)
+     * when updateserver restarts, master switches or too many slots
+     * are modified between two polls.
+     */
+    class ObFusedRowCache
+    {
+      static const int64_t KVCACHE_ITEM_SIZE = 1024;         //1k
+      static const int64_t KVCACHE_BLOCK_SIZE = 1024 * 1024; //1M
+      // stop serving if not synced in MAX_SYNC_DELAY_TIMES intervals
+      static const int64_t MAX_SYNC_DELAY_TIMES = 3;
+
+    public:
+      typedef common::KeyValueCache<ObFusedRowCacheKey, ObFusedRowCacheValue,
+      KVCACHE_ITEM_SIZE, KVCACHE_BLOCK_SIZE> KVCache;
+      typedef common::CacheHandle Handle;
+
+      // state of the cache before reading updateserver
+      struct Snapshot
+      {
+        int64_t generation_;
+        int64_t trans_id_;
+      };
+
+    public:
+      ObFusedRowCache();
+      ~ObFusedRowCache();
+
+      int init(const int64_t max_mem_size, const int64_t sync_interval);
+      int destroy();
+
+      inline bool is_inited() const
+      {
+        return inited_;
+      }
+
+      inline int64_t get_sync_interval() const
+      {
+        return sync_interval_;
+      }
+
+      /**
+       * take the snapshot before reading updateserver, the rows read
+       * are put into cache with it.
+       *
+       * @return bool false if cache is out of sync, don't get or put
+       *         rows in this case.
+       */
+      bool get_snapshot(Snapshot& snapshot) const;
+
+      /**
+       * get one valid row from cache, the cells are deserialized into
+       * row whose row desc is set by caller, and then the row is
+       * copied into row_store.
+       *
+       * @return int OB_SUCCESS on hit, OB_ENTRY_NOT_EXIST if not
+       *         cached or stale.
+       */
+      int get_row(const ObFusedRowCacheKey& key, const Snapshot& snapshot,
+                  common::ObRow& row, common::ObRowStore& row_store);
+
+      // put one row read after snapshot into cache
+      int put_row(const ObFusedRowCacheKey& key, const Snapshot& snapshot,
+                  const common::ObRow& row);
+
+      /**
+       * fetch the modified slots from updateserver and apply them,
+       * called by the sync task only.
+       */
+      int sync(const common::ObGeneralRpcStub& rpc_stub,
+               const common::ObServer& update_server, const int64_t timeout);
+
+      int apply_modify_slots(const common::ObRowModifySlots& slots);
+
+      static uint64_t get_column_signature(const common::ObRowDesc& row_desc);
+
+    private:
+      bool is_valid(const ObFusedRowCacheKey& key, const ObFusedRowCacheValue& value,
+                    const Snapshot& snapshot) const;
+
+    private:
+      DISALLOW_COPY_AND_ASSIGN(ObFusedRowCache);
+
+      bool inited_;
+      int64_t sync_interval_;
+      volatile int64_t generation_;
+      volatile int64_t ups_epoch_;
+      volatile int64_t commited_trans_id_;
+      volatile int64_t last_sync_time_;
+      volatile int64_t slot_trans_ids_[common::ROW_MODIFY_SLOT_NUM];
+      common::ObRowModifySlots modify_slots_;
+      KVCache kv_cache_;
+    };
+  }
+}
+
+#endif //OCEANBASE_CHUNKSERVER_OB_FUSED_ROW_CACHE_H_
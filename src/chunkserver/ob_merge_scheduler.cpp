@@ -0,0 +1,313 @@
+/*
+ * (C) 2007-2010 TaoBao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * ob_merge_scheduler.cpp is for what ...
+ *
+ * Version: $id$
+ *
+ * Authors:
+ *   MaoQi maoqi@taobao.com
+ *
+ */
+
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include "tbsys.h"
+#include "common/ob_common_stat.h"
+#include "ob_disk_manager.h"
+#include "ob_merge_scheduler.h"
+
+namespace oceanbase
+{
+  namespace chunkserver
+  {
+    using namespace common;
+
+    static const char* PROC_DISKSTATS_FILE = "/proc/diskstats";
+
+    ObMergeScheduler::ObMergeScheduler()
+      : inited_(false), adjust_interval_(1000000), read_latency_high_(10000),
+      disk_util_high_(80), disk_util_low_(50), max_merge_per_disk_(2),
+      min_thread_num_(1), max_thread_num_(1), target_thread_num_(1),
+      last_adjust_time_(0), last_request_count_(0), last_request_time_(0), disk_num_(0)
+    {
+      memset(disk_no_, 0, sizeof(disk_no_));
+      memset(disk_dev_, 0, sizeof(disk_dev_));
+      memset(last_io_ticks_, 0, sizeof(last_io_ticks_));
+      memset(disk_util_, 0, sizeof(disk_util_));
+      for (int64_t i = 0; i < MAX_DISK_SLOT; ++i)
+      {
+        disk_merge_limit_[i] = max_merge_per_disk_;
+      }
+    }
+
+    int ObMergeScheduler::init(const ObDiskManager& disk_manager, const char* data_dir,
+        const int64_t min_thread_num, const int64_t max_thread_num)
+    {
+      int ret = OB_SUCCESS;
+      int32_t disk_num = 0;
+      const int32_t* disk_no_array = disk_manager.get_disk_no_array(disk_num);
+      char disk_dir[OB_MAX_FILE_NAME_LENGTH];
+      struct stat st;
+
+      if (NULL == data_dir || min_thread_num <= 0 || max_thread_num < min_thread_num)
+      {
+        TBSYS_LOG(WARN, "invalid param, data_dir=%p, min_thread_num=%ld, max_thread_num=%ld",
+            data_dir, min_thread_num, max_thread_num);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        disk_num_ = 0;
+        for (int32_t i = 0; i < disk_num && i < MAX_DISK_SLOT; ++i)
+        {
+          snprintf(disk_dir, sizeof(disk_dir), "%s%c%d", data_dir, '/', disk_no_array[i]);
+          if (0 != stat(disk_dir, &st))
+          {
+            TBSYS_LOG(WARN, "stat disk dir %s error:%s", disk_dir, strerror(errno));
+          }
+          else
+          {
+            add_disk(disk_no_array[i], st.st_dev);
+          }
+        }
+        reset(min_thread_num, max_thread_num);
+      }
+      return ret;
+    }
+
+    int ObMergeScheduler::add_disk(const int32_t disk_no, const dev_t dev)
+    {
+      int ret = OB_SUCCESS;
+      if (disk_num_ >= MAX_DISK_SLOT)
+      {
+        TBSYS_LOG(WARN, "too many disks, disk_num_=%d, disk_no=%d", disk_num_, disk_no);
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else
+      {
+        disk_no_[disk_num_] = disk_no;
+        disk_dev_[disk_num_] = dev;
+        last_io_ticks_[disk_num_] = -1;
+        disk_util_[disk_num_] = 0;
+        TBSYS_LOG(INFO, "merge scheduler watch disk %d, dev=%u:%u",
+            disk_no, major(dev), minor(dev));
+        ++disk_num_;
+      }
+      return ret;
+    }
+
+    void ObMergeScheduler::reset(const int64_t min_thread_num, const int64_t max_thread_num)
+    {
+      min_thread_num_ = min_thread_num;
+      max_thread_num_ = max_thread_num;
+      target_thread_num_ = max_thread_num;
+      for (int64_t i = 0; i < MAX_DISK_SLOT; ++i)
+      {
+        disk_merge_limit_[i] = max_merge_per_disk_;
+      }
+      last_adjust_time_ = 0;
+      inited_ = true;
+    }
+
+    void ObMergeScheduler::set_param(const int64_t adjust_interval, const int64_t read_latency_high,
+        const int64_t disk_util_high, const int64_t disk_util_low, const int64_t max_merge_per_disk)
+    {
+      adjust_interval_ = adjust_interval;
+      read_latency_high_ = read_latency_high;
+      disk_util_high_ = disk_util_high;
+      disk_util_low_ = disk_util_low;
+      if (max_merge_per_disk_ != max_merge_per_disk)
+      {
+        max_merge_per_disk_ = max_merge_per_disk;
+        for (int64_t i = 0; i < MAX_DISK_SLOT; ++i)
+        {
+          if (disk_merge_limit_[i] > max_merge_per_disk_)
+          {
+            disk_merge_limit_[i] = max_merge_per_disk_;
+          }
+        }
+      }
+    }
+
+    int64_t ObMergeScheduler::get_disk_merge_limit(const int32_t disk_no) const
+    {
+      int64_t limit = max_merge_per_disk_;
+      if (disk_no >= 0 && disk_no < MAX_DISK_SLOT)
+      {
+        limit = disk_merge_limit_[disk_no];
+      }
+      return limit;
+    }
+
+    int64_t ObMergeScheduler::sample_read_latency()
+    {
+      int64_t latency = -1;
+      int64_t request_count = 0;
+      int64_t request_time = 0;
+      ObStatManager* stat_mgr = ObStatSingleton::get_instance();
+
+      if (NULL != stat_mgr)
+      {
+        for (ObStatManager::const_iterator it = stat_mgr->begin(OB_STAT_CHUNKSERVER);
+            it != stat_mgr->end(OB_STAT_CHUNKSERVER); ++it)
+        {
+          request_count += it->get_value(INDEX_GET_COUNT) + it->get_value(INDEX_SCAN_COUNT);
+          request_time += it->get_value(INDEX_GET_TIME) + it->get_value(INDEX_SCAN_TIME);
+        }
+        if (request_count > last_request_count_ && request_time >= last_request_time_)
+        {
+          latency = (request_time - last_request_time_) / (request_count - last_request_count_);
+        }
+        last_request_count_ = request_count;
+        last_request_time_ = request_time;
+      }
+      return latency;
+    }
+
+    int ObMergeScheduler::read_io_ticks(int64_t* io_ticks) const
+    {
+      int ret = OB_SUCCESS;
+      FILE* fp = NULL;
+      char line[OB_MAX_FILE_NAME_LENGTH];
+      unsigned int dev_major = 0;
+      unsigned int dev_minor = 0;
+      unsigned long ticks = 0;
+
+      for (int32_t i = 0; i < disk_num_; ++i)
+      {
+        io_ticks[i] = -1;
+      }
+
+      if (NULL == (fp = fopen(PROC_DISKSTATS_FILE, "r")))
+      {
+        TBSYS_LOG(WARN, "open %s error:%s", PROC_DISKSTATS_FILE, strerror(errno));
+        ret = OB_IO_ERROR;
+      }
+      else
+      {
+        // major minor name rd_ios rd_merges rd_sectors rd_ticks
+        // wr_ios wr_merges wr_sectors wr_ticks in_flight io_ticks ...
+        while (NULL != fgets(line, sizeof(line), fp))
+        {
+          if (3 == sscanf(line, "%u %u %*s %*u %*u %*u %*u %*u %*u %*u %*u %*u %lu",
+                &dev_major, &dev_minor, &ticks))
+          {
+            for (int32_t i = 0; i < disk_num_; ++i)
+            {
+              if (major(disk_dev_[i]) == dev_major && minor(disk_dev_[i]) == dev_minor)
+              {
+                io_ticks[i] = static_cast<int64_t>(ticks);
+              }
+            }
+          }
+        }
+        fclose(fp);
+      }
+      return ret;
+    }
+
+    int ObMergeScheduler::sample_disk_util(const int64_t elapsed_time)
+    {
+      int ret = OB_SUCCESS;
+      int64_t io_ticks[MAX_DISK_SLOT];
+      int64_t elapsed_ms = elapsed_time / 1000;
+
+      if (OB_SUCCESS == (ret = read_io_ticks(io_ticks)))
+      {
+        for (int32_t i = 0; i < disk_num_; ++i)
+        {
+          // io_ticks is the milliseconds spent doing io
+          if (io_ticks[i] >= 0 && last_io_ticks_[i] >= 0
+              && io_ticks[i] >= last_io_ticks_[i] && elapsed_ms > 0)
+          {
+            disk_util_[i] = (io_ticks[i] - last_io_ticks_[i]) * 100 / elapsed_ms;
+          }
+          else
+          {
+            disk_util_[i] = 0;
+          }
+          last_io_ticks_[i] = io_ticks[i];
+        }
+      }
+      return ret;
+    }
+
+    void ObMergeScheduler::adjust()
+    {
+      int64_t now = tbsys::CTimeUtil::getTime();
+      int64_t elapsed_time = now - last_adjust_time_;
+      int64_t latency = 0;
+      int64_t max_util = 0;
+      int64_t old_target = target_thread_num_;
+      bool latency_high = false;
+      bool latency_low = false;
+
+      if (inited_ && elapsed_time >= adjust_interval_)
+      {
+        latency = sample_read_latency();
+        sample_disk_util(elapsed_time);
+        if (0 == last_adjust_time_)
+        {
+          // first sample is only the baseline
+          last_adjust_time_ = now;
+        }
+        else
+        {
+          last_adjust_time_ = now;
+          latency_high = latency > read_latency_high_;
+          latency_low = latency < read_latency_high_ / 2;
+
+          for (int32_t i = 0; i < disk_num_; ++i)
+          {
+            int32_t disk_no = disk_no_[i];
+            if (disk_util_[i] > max_util)
+            {
+              max_util = disk_util_[i];
+            }
+            if (disk_no < 0 || disk_no >= MAX_DISK_SLOT)
+            {
+              // not a valid slot
+            }
+            else if ((latency_high || disk_util_[i] > disk_util_high_)
+                && disk_merge_limit_[disk_no] > 1)
+            {
+              --disk_merge_limit_[disk_no];
+            }
+            else if (latency_low && disk_util_[i] < disk_util_low_
+                && disk_merge_limit_[disk_no] < max_merge_per_disk_)
+            {
+              ++disk_merge_limit_[disk_no];
+            }
+          }
+
+          if (latency_high || max_util > disk_util_high_)
+          {
+            target_thread_num_ = target_thread_num_ / 2;
+            if (target_thread_num_ < min_thread_num_)
+            {
+              target_thread_num_ = min_thread_num_;
+            }
+          }
+          else if (latency_low && max_util < disk_util_low_ && target_thread_num_ < max_thread_num_)
+          {
+            ++target_thread_num_;
+          }
+
+          if (old_target != target_thread_num_)
+          {
+            TBSYS_LOG(INFO, "adjust merge thread number from %ld to %ld, read_latency=%ld, "
+                "read_latency_high=%ld, max_disk_util=%ld, disk_util_high=%ld, disk_util_low=%ld",
+                old_target, target_thread_num_, latency, read_latency_high_,
+                max_util, disk_util_high_, disk_util_low_);
+          }
+        }
+      }
+    }
+  } /* chunkserver */
+} /* oceanbase */
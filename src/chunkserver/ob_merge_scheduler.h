@@ -0,0 +1,109 @@
+/*
+ * (C) 2007-2010 TaoBao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * ob_merge_scheduler.h is for what ...
+ *
+ * Version: $id$
+ *
+ * Authors:
+ *   MaoQi maoqi@taobao.com
+ *
+ */
+#ifndef OB_CHUNKSERVER_OB_MERGE_SCHEDULER_H_
+#define OB_CHUNKSERVER_OB_MERGE_SCHEDULER_H_
+#include <sys/types.h>
+#include "common/ob_define.h"
+
+namespace oceanbase
+{
+  namespace chunkserver
+  {
+    class ObDiskManager;
+
+    /**
+     * adjust daily merge concurrency by feedback of foreground
+     * read latency and disk utilization.
+     *
+     * every adjust interval, sample the average get/scan latency
+     * from chunkserver stat and the io busy time of each data disk
+     * from /proc/diskstats, then:
+     *  1. if read latency or utilization of any disk beyond the high
+     *     threshold, halve the merge thread number;
+     *  2. if read latency is low and all disks are not busy, add one
+     *     merge thread;
+     *  3. the merge limit of each disk is adjusted by its own
+     *     utilization, decrease one if busy and increase one if idle.
+     */
+    class ObMergeScheduler
+    {
+      public:
+        ObMergeScheduler();
+        virtual ~ObMergeScheduler() {}
+
+        /**
+         * find block devices of all data disks, reset merge thread
+         * number and merge limit of each disk to the max value,
+         * called when a new merge round start.
+         */
+        int init(const ObDiskManager& disk_manager, const char* data_dir,
+            const int64_t min_thread_num, const int64_t max_thread_num);
+        void set_param(const int64_t adjust_interval, const int64_t read_latency_high,
+            const int64_t disk_util_high, const int64_t disk_util_low,
+            const int64_t max_merge_per_disk);
+
+        /**
+         * sample and adjust if adjust interval passed since last adjust,
+         * caller must serialize the calls.
+         */
+        void adjust();
+
+        inline int64_t get_target_thread_num() const
+        {
+          return target_thread_num_;
+        }
+        int64_t get_disk_merge_limit(const int32_t disk_no) const;
+
+      protected:
+        // watch the block device of a data disk
+        int add_disk(const int32_t disk_no, const dev_t dev);
+        // reset merge thread number and merge limit of each disk to the max value
+        void reset(const int64_t min_thread_num, const int64_t max_thread_num);
+        // average us of each get/scan since last sample, -1 if no request
+        virtual int64_t sample_read_latency();
+        // utilization percent of each disk since last sample
+        virtual int sample_disk_util(const int64_t elapsed_time);
+
+      private:
+        int read_io_ticks(int64_t* io_ticks) const;
+
+      protected:
+        static const int64_t MAX_DISK_SLOT = common::OB_MAX_DISK_NUMBER + 1;
+
+        bool inited_;
+        int64_t adjust_interval_;
+        int64_t read_latency_high_;
+        int64_t disk_util_high_;
+        int64_t disk_util_low_;
+        int64_t max_merge_per_disk_;
+        int64_t min_thread_num_;
+        int64_t max_thread_num_;
+
+        volatile int64_t target_thread_num_;
+        int64_t last_adjust_time_;
+        int64_t last_request_count_;
+        int64_t last_request_time_;
+
+        int32_t disk_num_;
+        int32_t disk_no_[MAX_DISK_SLOT];
+        dev_t disk_dev_[MAX_DISK_SLOT];
+        int64_t last_io_ticks_[MAX_DISK_SLOT];
+        int64_t disk_util_[MAX_DISK_SLOT];
+        volatile int64_t disk_merge_limit_[MAX_DISK_SLOT]; // indexed by disk_no
+    };
+  } /* chunkserver */
+} /* oceanbase */
+#endif //OB_CHUNKSERVER_OB_MERGE_SCHEDULER_H_
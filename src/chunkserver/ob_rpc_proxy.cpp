@@ -1058,5 +1058,81 @@ namespace oceanbase
       return ups_scan_(sql_rpc_stub_, scan_param, scanner, common::MERGE_SERVER, timeout);
     }
 
+    // adapt ObSqlRpcStub::stream_scan to the scan interface used by ups_scan_,
+    // so stream scan shares the ups selection, retry and blacklist logic
+    class ObSqlStreamScanStub
+    {
+      public:
+        ObSqlStreamScanStub(const ObSqlRpcStub &rpc_stub, ObUpsScanSession &session)
+          : rpc_stub_(rpc_stub), session_(session)
+        {
+        }
+        int scan(const int64_t timeout, const ObServer & server,
+            const ObScanParam & scan_param, ObNewScanner & new_scanner) const
+        {
+          int ret = rpc_stub_.stream_scan(timeout, server, scan_param, new_scanner, session_.session_id_);
+          session_.server_ = server;
+          return ret;
+        }
+      private:
+        const ObSqlRpcStub &rpc_stub_;
+        ObUpsScanSession &session_;
+    };
+
+    int ObMergerRpcProxy::sql_ups_stream_scan(const common::ObScanParam & scan_param,
+                     common::ObNewScanner & scanner,
+                     common::ObUpsScanSession & session,
+                     const int64_t timeout /* = 0 */)
+    {
+      int ret = OB_SUCCESS;
+      session.reset();
+      if (NULL == sql_rpc_stub_)
+      {
+        ret = OB_INNER_STAT_ERROR;
+      }
+      else
+      {
+        ObSqlStreamScanStub stream_stub(*sql_rpc_stub_, session);
+        ret = ups_scan_(&stream_stub, scan_param, scanner, common::MERGE_SERVER, timeout);
+      }
+      if (OB_SUCCESS != ret)
+      {
+        session.reset();
+      }
+      return ret;
+    }
+
+    int ObMergerRpcProxy::sql_ups_stream_next(const common::ObUpsScanSession & session,
+                     common::ObNewScanner & scanner,
+                     const int64_t timeout /* = 0 */)
+    {
+      int ret = OB_SUCCESS;
+      if (!check_inner_stat() || NULL == sql_rpc_stub_)
+      {
+        TBSYS_LOG(ERROR, "%s", "check inner stat failed");
+        ret = OB_INNER_STAT_ERROR;
+      }
+      else if (!session.is_valid())
+      {
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        ret = sql_rpc_stub_->stream_next((timeout > 0) ? timeout : rpc_timeout_,
+            session.server_, session.session_id_, scanner);
+      }
+      return ret;
+    }
+
+    void ObMergerRpcProxy::sql_ups_stream_end(const common::ObUpsScanSession & session)
+    {
+      if (check_inner_stat()
+          && NULL != sql_rpc_stub_
+          && session.is_valid())
+      {
+        sql_rpc_stub_->stream_end(rpc_timeout_, session.server_, session.session_id_);
+      }
+    }
+
   } // end namespace chunkserver
 } // end namespace oceanbase
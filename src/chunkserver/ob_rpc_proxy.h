@@ -188,6 +188,23 @@ namespace oceanbase
                            common::ObNewScanner & scanner,
                            const int64_t time_out = 0);
 
+      // scan the first page from update server and keep the scan stream
+      // param  @scan_param scan param
+      //        @scanner return result
+      //        @session return the server and stream id for following pages
+      virtual int sql_ups_stream_scan(const common::ObScanParam & scan_param,
+                           common::ObNewScanner & scanner,
+                           common::ObUpsScanSession & session,
+                           const int64_t time_out = 0);
+
+      // read the next page of the scan stream
+      virtual int sql_ups_stream_next(const common::ObUpsScanSession & session,
+                           common::ObNewScanner & scanner,
+                           const int64_t time_out = 0);
+
+      // abandon the scan stream before it ends
+      virtual void sql_ups_stream_end(const common::ObUpsScanSession & session);
+
     private:
       // get data from update server
       // param  @get_param get param
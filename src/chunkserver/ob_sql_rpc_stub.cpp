@@ -51,3 +51,93 @@ int ObSqlRpcStub::scan(const int64_t timeout, const ObServer & server, const ObS
   return send_1_return_1(server, timeout, OB_NEW_SCAN_REQUEST, DEFAULT_VERSION, scan_param, new_scanner);
 }
 
+
+int ObSqlRpcStub::stream_scan(const int64_t timeout, const ObServer & server, const ObScanParam & scan_param,
+    ObNewScanner & new_scanner, int64_t & session_id) const
+{
+  ObDataBuffer data_buff;
+  int ret = get_rpc_buffer(data_buff);
+  session_id = 0;
+  if (OB_SUCCESS != ret)
+  {
+    TBSYS_LOG(WARN, "get rpc buffer failed:ret[%d]", ret);
+  }
+  else if (OB_SUCCESS != (ret = scan_param.serialize(data_buff.get_data(), data_buff.get_capacity(),
+          data_buff.get_position())))
+  {
+    TBSYS_LOG(WARN, "serialize scan param failed:ret[%d]", ret);
+  }
+  else if (OB_SUCCESS != (ret = rpc_frame_->send_request(server, OB_NEW_SCAN_REQUEST, OB_UPS_STREAM_SCAN_VERSION,
+          timeout, data_buff, data_buff, session_id)))
+  {
+    TBSYS_LOG(WARN, "send scan request failed, server=%s, ret=%d", to_cstring(server), ret);
+  }
+  else if (OB_SUCCESS != (ret = deserialize_scan_result_(data_buff, new_scanner)))
+  {
+    TBSYS_LOG(WARN, "scan failed, server=%s, ret=%d", to_cstring(server), ret);
+  }
+  if (OB_SUCCESS != ret)
+  {
+    session_id = 0;
+  }
+  return ret;
+}
+
+int ObSqlRpcStub::stream_next(const int64_t timeout, const ObServer & server, const int64_t session_id,
+    ObNewScanner & new_scanner) const
+{
+  ObDataBuffer data_buff;
+  int ret = get_rpc_buffer(data_buff);
+  if (OB_SUCCESS != ret)
+  {
+    TBSYS_LOG(WARN, "get rpc buffer failed:ret[%d]", ret);
+  }
+  else if (OB_SUCCESS != (ret = rpc_frame_->get_next(server, session_id, timeout, data_buff, data_buff)))
+  {
+    TBSYS_LOG(WARN, "get next failed, server=%s, session_id=%ld, ret=%d", to_cstring(server), session_id, ret);
+  }
+  else if (OB_SUCCESS != (ret = deserialize_scan_result_(data_buff, new_scanner)))
+  {
+    TBSYS_LOG(INFO, "scan next failed, server=%s, session_id=%ld, ret=%d", to_cstring(server), session_id, ret);
+  }
+  return ret;
+}
+
+int ObSqlRpcStub::stream_end(const int64_t timeout, const ObServer & server, const int64_t session_id) const
+{
+  ObDataBuffer data_buff;
+  int ret = get_rpc_buffer(data_buff);
+  if (OB_SUCCESS != ret)
+  {
+    TBSYS_LOG(WARN, "get rpc buffer failed:ret[%d]", ret);
+  }
+  else if (OB_SUCCESS != (ret = rpc_frame_->post_end_next(server, session_id, timeout, data_buff, NULL, NULL)))
+  {
+    TBSYS_LOG(WARN, "post end next failed, server=%s, session_id=%ld, ret=%d", to_cstring(server), session_id, ret);
+  }
+  return ret;
+}
+
+int ObSqlRpcStub::deserialize_scan_result_(const ObDataBuffer & data_buff, ObNewScanner & new_scanner) const
+{
+  int ret = OB_SUCCESS;
+  int64_t pos = 0;
+  ObResultCode result_code;
+  if (OB_SUCCESS != (ret = result_code.deserialize(data_buff.get_data(), data_buff.get_position(), pos)))
+  {
+    TBSYS_LOG(WARN, "deserialize result failed:pos[%ld], ret[%d]", pos, ret);
+  }
+  else if (OB_SUCCESS != (ret = result_code.result_code_))
+  {
+    TBSYS_LOG(DEBUG, "scan response error:ret[%d]", ret);
+  }
+  else
+  {
+    new_scanner.clear();
+    if (OB_SUCCESS != (ret = new_scanner.deserialize(data_buff.get_data(), data_buff.get_position(), pos)))
+    {
+      TBSYS_LOG(WARN, "deserialize scanner from buff failed:pos[%ld], ret[%d]", pos, ret);
+    }
+  }
+  return ret;
+}
@@ -34,7 +34,18 @@ namespace oceanbase
 
         int get(const int64_t timeout, const ObServer & server, const ObGetParam & get_param, ObNewScanner & new_scanner) const;
         int scan(const int64_t timeout, const ObServer & server, const ObScanParam & scan_param, ObNewScanner & new_scanner) const;
- 
+
+        // 以OB_UPS_STREAM_SCAN_VERSION扫描UPS, UPS保留了扫描流时session_id返回非0
+        int stream_scan(const int64_t timeout, const ObServer & server, const ObScanParam & scan_param,
+            ObNewScanner & new_scanner, int64_t & session_id) const;
+        // 读取扫描流的下一页
+        int stream_next(const int64_t timeout, const ObServer & server, const int64_t session_id,
+            ObNewScanner & new_scanner) const;
+        // 通知UPS关闭扫描流, 不等待应答
+        int stream_end(const int64_t timeout, const ObServer & server, const int64_t session_id) const;
+      private:
+        int deserialize_scan_result_(const ObDataBuffer & data_buff, ObNewScanner & new_scanner) const;
+
     };
   }
 }
@@ -0,0 +1,177 @@
+/*
+ * (C) 2007-2010 TaoBao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * ob_sub_merge_pool.cpp is for what ...
+ *
+ * Version: $id$
+ *
+ * Authors:
+ *   MaoQi maoqi@taobao.com
+ *
+ */
+#include "ob_sub_merge_pool.h"
+
+namespace oceanbase
+{
+  namespace chunkserver
+  {
+    using namespace common;
+
+    ObSubMergePool::ObSubMergePool()
+      : head_(NULL), tail_(NULL), thread_num_(0)
+    {
+      pthread_mutex_init(&mutex_, NULL);
+      pthread_cond_init(&task_cond_, NULL);
+      pthread_cond_init(&done_cond_, NULL);
+    }
+
+    ObSubMergePool::~ObSubMergePool()
+    {
+      destroy();
+      pthread_cond_destroy(&done_cond_);
+      pthread_cond_destroy(&task_cond_);
+      pthread_mutex_destroy(&mutex_);
+    }
+
+    int ObSubMergePool::init(const int64_t thread_num)
+    {
+      int ret = OB_SUCCESS;
+
+      if (thread_num_ > 0)
+      {
+        TBSYS_LOG(WARN, "sub merge pool has been started, thread_num_=%ld", thread_num_);
+        ret = OB_INIT_TWICE;
+      }
+      else if (thread_num <= 0)
+      {
+        TBSYS_LOG(WARN, "invalid argument, thread_num=%ld", thread_num);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        _stop = false;
+        setThreadCount(static_cast<int32_t>(thread_num));
+        thread_num_ = start();
+        if (thread_num_ <= 0)
+        {
+          TBSYS_LOG(ERROR, "cannot create sub merge thread, thread_num=%ld", thread_num);
+          thread_num_ = 0;
+          ret = OB_ERROR;
+        }
+        else
+        {
+          TBSYS_LOG(INFO, "start %ld sub merge threads, expected %ld", thread_num_, thread_num);
+        }
+      }
+
+      return ret;
+    }
+
+    void ObSubMergePool::destroy()
+    {
+      if (thread_num_ > 0)
+      {
+        // the queued tasks are still processed before the workers exit
+        pthread_mutex_lock(&mutex_);
+        stop();
+        pthread_cond_broadcast(&task_cond_);
+        pthread_mutex_unlock(&mutex_);
+        wait();
+        thread_num_ = 0;
+      }
+    }
+
+    int ObSubMergePool::process(Task** tasks, const int64_t count)
+    {
+      int ret = OB_SUCCESS;
+      int64_t pending = count;
+
+      if (NULL == tasks || count <= 0)
+      {
+        TBSYS_LOG(WARN, "invalid argument, tasks=%p, count=%ld", tasks, count);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (thread_num_ <= 0)
+      {
+        for (int64_t i = 0; i < count; ++i)
+        {
+          tasks[i]->ret_ = tasks[i]->process();
+        }
+      }
+      else
+      {
+        pthread_mutex_lock(&mutex_);
+        for (int64_t i = 0; i < count; ++i)
+        {
+          tasks[i]->ret_ = OB_SUCCESS;
+          tasks[i]->next_ = NULL;
+          tasks[i]->pending_ = &pending;
+          if (NULL == tail_)
+          {
+            head_ = tasks[i];
+          }
+          else
+          {
+            tail_->next_ = tasks[i];
+          }
+          tail_ = tasks[i];
+        }
+        pthread_cond_broadcast(&task_cond_);
+        while (pending > 0)
+        {
+          pthread_cond_wait(&done_cond_, &mutex_);
+        }
+        pthread_mutex_unlock(&mutex_);
+      }
+
+      for (int64_t i = 0; OB_SUCCESS == ret && i < count; ++i)
+      {
+        ret = tasks[i]->ret_;
+      }
+
+      return ret;
+    }
+
+    void ObSubMergePool::run(tbsys::CThread* thread, void* arg)
+    {
+      UNUSED(thread);
+      UNUSED(arg);
+      Task* task = NULL;
+
+      pthread_mutex_lock(&mutex_);
+      while (true)
+      {
+        if (NULL != head_)
+        {
+          task = head_;
+          head_ = task->next_;
+          if (NULL == head_)
+          {
+            tail_ = NULL;
+          }
+          pthread_mutex_unlock(&mutex_);
+          task->ret_ = task->process();
+          pthread_mutex_lock(&mutex_);
+          // the caller may return as soon as its last task is done
+          if (0 == --(*task->pending_))
+          {
+            pthread_cond_broadcast(&done_cond_);
+          }
+        }
+        else if (_stop)
+        {
+          break;
+        }
+        else
+        {
+          pthread_cond_wait(&task_cond_, &mutex_);
+        }
+      }
+      pthread_mutex_unlock(&mutex_);
+    }
+  } /* chunkserver */
+} /* oceanbase */
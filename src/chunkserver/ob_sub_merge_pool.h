@@ -0,0 +1,86 @@
+/*
+ * (C) 2007-2010 TaoBao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * ob_sub_merge_pool.h is for what ...
+ *
+ * Version: $id$
+ *
+ * Authors:
+ *   MaoQi maoqi@taobao.com
+ *
+ */
+#ifndef OB_CHUNKSERVER_OB_SUB_MERGE_POOL_H_
+#define OB_CHUNKSERVER_OB_SUB_MERGE_POOL_H_
+#include <pthread.h>
+#include <tbsys.h>
+#include "common/ob_define.h"
+
+namespace oceanbase
+{
+  namespace chunkserver
+  {
+    /**
+     * fixed number of worker threads shared by all merge threads to
+     * merge the sub ranges of big tablets, so the number of sub merge
+     * threads is bounded however many tablets are merged at the same
+     * time.
+     */
+    class ObSubMergePool : public tbsys::CDefaultRunnable
+    {
+      public:
+        class Task
+        {
+          public:
+            Task() : ret_(common::OB_SUCCESS), next_(NULL), pending_(NULL) {}
+            virtual ~Task() {}
+            virtual int process() = 0;
+            inline int get_ret() const
+            {
+              return ret_;
+            }
+          private:
+            friend class ObSubMergePool;
+            int ret_;
+            Task* next_;
+            int64_t* pending_;
+        };
+
+      public:
+        ObSubMergePool();
+        ~ObSubMergePool();
+
+        int init(const int64_t thread_num);
+        void destroy();
+
+        /**
+         * run %tasks in the worker threads and wait until all of them
+         * finish, the tasks are processed in the caller thread if the
+         * pool is not started.
+         * @return the first error of %tasks in array order
+         */
+        int process(Task** tasks, const int64_t count);
+
+        inline int64_t get_thread_num() const
+        {
+          return thread_num_;
+        }
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObSubMergePool);
+        virtual void run(tbsys::CThread* thread, void* arg);
+
+      private:
+        pthread_mutex_t mutex_;
+        pthread_cond_t task_cond_;
+        pthread_cond_t done_cond_;
+        Task* head_;
+        Task* tail_;
+        int64_t thread_num_;
+    };
+  } /* chunkserver */
+} /* oceanbase */
+#endif
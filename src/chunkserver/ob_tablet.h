@@ -161,6 +161,7 @@ namespace oceanbase
         inline void inc_merge_count() { ++merge_count_; }
         inline uint32_t inc_ref() { return common::atomic_inc(&ref_count_); }
         inline uint32_t dec_ref() { return common::atomic_dec(&ref_count_); }
+        inline uint32_t get_ref_count() const { return ref_count_; }
         inline int32_t get_compactsstable_num() {return compactsstable_num_;}
         int add_compactsstable(compactsstable::ObCompactSSTableMemNode* cache);
         compactsstable::ObCompactSSTableMemNode* get_compactsstable_list();
@@ -16,6 +16,7 @@
 
 #include "ob_tablet_image.h"
 #include <dirent.h>
+#include <algorithm>
 #include "common/ob_record_header.h"
 #include "common/file_directory_utils.h"
 #include "common/ob_file.h"
@@ -227,13 +228,17 @@ namespace oceanbase
     //----------------------------------------
     // class ObTabletImage
     //----------------------------------------
+    ObTabletImage::TabletIndex ObTabletImage::empty_tablet_index_ = {0, NULL};
+    ObEpochManager ObTabletImage::tablet_index_epoch_;
+
     ObTabletImage::ObTabletImage()
-      : tablet_list_(DEFAULT_TABLET_NUM), sstable_list_(DEFAULT_TABLET_NUM),
+      : tablet_list_(DEFAULT_TABLET_NUM), tablet_index_(&empty_tablet_index_),
+      tablet_index_stale_(false), sstable_list_(DEFAULT_TABLET_NUM),
       delete_table_tablet_list_(DEFAULT_TABLE_TABLET_NUM),
       report_tablet_list_(DEFAULT_TABLET_NUM),
       hash_map_inited_(false), data_version_(0),
       max_sstable_file_seq_(0),
-      ref_count_(0), cur_iter_idx_(INVALID_ITER_INDEX),
+      cur_iter_idx_(INVALID_ITER_INDEX),
       merged_tablet_count_(0),
       mod_(ObModIds::OB_CS_TABLET_IMAGE),
       allocator_(ModuleArena::DEFAULT_PAGE_SIZE, mod_),
@@ -251,10 +256,15 @@ namespace oceanbase
     int ObTabletImage::destroy()
     {
       int ret = OB_SUCCESS;
-      if (atomic_read((atomic_t*)&ref_count_) != 0)
+      int32_t ref_count = 0;
+      // no reader can find the tablets after this, swap waits for the
+      // lock free readers which may still see the old index.
+      swap_tablet_index(&empty_tablet_index_);
+      tablet_index_stale_ = false;
+      if ((ref_count = get_ref_count()) != 0)
       {
         TBSYS_LOG(ERROR, "ObTabletImage still been used ref=%d, "
-                         "cannot destory..", ref_count_);
+                         "cannot destory..", ref_count);
         /**
          * FIXME: sometime the ref count is not zero when doing destroy,
          * it's a bug, but we review the code again and again, we don't
@@ -298,7 +308,6 @@ namespace oceanbase
 
       data_version_ = 0;
       max_sstable_file_seq_ = 0;
-      ref_count_ = 0;
       cur_iter_idx_ = INVALID_ITER_INDEX;
       merged_tablet_count_ = 0;
 
@@ -415,7 +424,6 @@ namespace oceanbase
         {
           if (0 == table_id || (*it)->get_range().table_id_ == table_id)
           {
-            atomic_inc((atomic_t*) &ref_count_);
             (*it)->inc_ref();
             if (OB_SUCCESS != (ret = table_tablets.push_back(*it)))
             {
@@ -514,6 +522,8 @@ namespace oceanbase
         if (OB_SUCCESS == ret && end - start > 0)
         {
           ret = tablet_list_.remove(start, end);
+          // removed tablets must not be found once removed.
+          publish_tablet_index();
         }
       }
 
@@ -709,6 +719,72 @@ namespace oceanbase
     }
 
     int ObTabletImage::add_tablet(ObTablet* tablet)
+    {
+      return insert_tablet(tablet);
+    }
+
+    void ObTabletImage::publish_tablet_index()
+    {
+      TabletIndex* index = &empty_tablet_index_;
+      int64_t count = tablet_list_.size();
+      char* ptr = NULL;
+
+      if (count > 0)
+      {
+        ptr = static_cast<char*>(ob_malloc(sizeof(TabletIndex) + count * sizeof(ObTablet*),
+              ObModIds::OB_CS_TABLET_IMAGE));
+        if (NULL == ptr)
+        {
+          // never keep the old index, it may refer to removed tablets,
+          // lookups use tablet_list_ until next publish.
+          TBSYS_LOG(ERROR, "failed to allocate tablet index, tablet count=%ld", count);
+        }
+        else
+        {
+          index = reinterpret_cast<TabletIndex*>(ptr);
+          index->count_ = count;
+          index->tablets_ = reinterpret_cast<ObTablet**>(ptr + sizeof(TabletIndex));
+          memcpy(index->tablets_, tablet_list_.begin(), count * sizeof(ObTablet*));
+        }
+      }
+
+      swap_tablet_index(index);
+      tablet_index_stale_ = (index == &empty_tablet_index_ && count > 0);
+    }
+
+    bool ObTabletImage::has_published_tablet() const
+    {
+      // caller is in tablet_index_epoch_.
+      return tablet_index_stale_ || tablet_index_->count_ > 0;
+    }
+
+    int32_t ObTabletImage::get_ref_count() const
+    {
+      int32_t ref_count = 0;
+      for (int32_t i = 0; i < tablet_list_.size(); ++i)
+      {
+        ref_count += tablet_list_.at(i)->get_ref_count();
+      }
+      return ref_count;
+    }
+
+    void ObTabletImage::swap_tablet_index(TabletIndex* index)
+    {
+      TabletIndex* old_index = NULL;
+
+      __sync_synchronize();
+      old_index = __sync_lock_test_and_set(&tablet_index_, index);
+      if (old_index != index)
+      {
+        tablet_index_epoch_.synchronize();
+        if (old_index != &empty_tablet_index_)
+        {
+          ob_free(old_index);
+        }
+      }
+    }
+
+    int ObTabletImage::insert_tablet(ObTablet* tablet)
     {
       int ret = OB_SUCCESS;
       int hash_ret = 0;
@@ -800,7 +876,7 @@ namespace oceanbase
       return ret;
     }
 
-    int ObTabletImage::find_tablet(const common::ObNewRange& range,
+    int ObTabletImage::find_tablet(const TabletIndex& index, const common::ObNewRange& range,
         const int32_t scan_direction, ObTablet* &tablet) const
     {
       int ret = OB_SUCCESS;
@@ -808,7 +884,7 @@ namespace oceanbase
       ObRowkey lookup_key = (ObMultiVersionTabletImage::SCAN_FORWARD == scan_direction)
         ? range.start_key_ : range.end_key_;
 
-      if (tablet_list_.size() <= 0)
+      if (index.count_ <= 0)
       {
         TBSYS_LOG(WARN, "chunkserver has no tablets, cannot find tablet.");
         ret = OB_CS_TABLET_NOT_EXIST;
@@ -818,7 +894,7 @@ namespace oceanbase
         TBSYS_LOG(WARN, "find invalid range:%s", to_cstring(range));
         ret = OB_INVALID_ARGUMENT;
       }
-      else if (OB_SUCCESS != (ret = find_tablet(range.table_id_,
+      else if (OB_SUCCESS != (ret = find_tablet(index, range.table_id_,
               lookup_key, range.get_rowkey_info(), range.border_flag_, scan_direction, tablet)))
       {
         TBSYS_LOG(WARN, "cannot find range :%s", to_cstring(range));
@@ -833,7 +909,7 @@ namespace oceanbase
       return ret;
     }
 
-    int ObTabletImage::find_tablet( const uint64_t table_id,
+    int ObTabletImage::find_tablet(const TabletIndex& index, const uint64_t table_id,
         const common::ObRowkey& key, const ObRowkeyInfo* ri,
         const ObBorderFlag& border_flag,
         const int32_t scan_direction, ObTablet* &tablet) const
@@ -841,7 +917,9 @@ namespace oceanbase
       int ret = OB_SUCCESS;
 
       tablet = NULL;
-      ObSortedVector<ObTablet*>::iterator it = tablet_list_.end();
+      ObTablet** begin = index.tablets_;
+      ObTablet** end = index.tablets_ + index.count_;
+      ObTablet** it = end;
 
       ObNewRange range;
       range.table_id_ = table_id;
@@ -849,8 +927,8 @@ namespace oceanbase
       range.end_key_ = key;
       range.set_rowkey_info(ri);
 
-      it = tablet_list_.lower_bound(range, compare_tablet_range);
-      if (it == tablet_list_.end())
+      it = std::lower_bound(begin, end, range, compare_tablet_range);
+      if (it == end)
       {
         //                       start_key
         //                        |--------------
@@ -863,7 +941,7 @@ namespace oceanbase
         if (ObMultiVersionTabletImage::SCAN_BACKWARD == scan_direction)
         {
           // check table id  in intersect range.
-          tablet = *tablet_list_.last();
+          tablet = *(end - 1);
         }
       }
       else if (NULL != *it)
@@ -874,10 +952,10 @@ namespace oceanbase
         //    ------------|
         // |--| |--| |---------| |---------|
         tablet = *it;
-        ObSortedVector<ObTablet*>::const_iterator next_it = ++it;
+        ObTablet** next_it = ++it;
         if (!check_border_inclusive(key, border_flag, scan_direction, *tablet))
         {
-          tablet =(next_it != tablet_list_.end()) ? (*next_it) : NULL;
+          tablet =(next_it != end) ? (*next_it) : NULL;
         }
       }
 
@@ -907,7 +985,6 @@ namespace oceanbase
       }
       else
       {
-        atomic_inc((atomic_t*) &ref_count_);
         tablet->inc_ref();
       }
 
@@ -1011,6 +1088,9 @@ namespace oceanbase
             }
           }
           disk_no = tablet->get_disk_no();
+          // caller releases and may destroy the tablet after this,
+          // lock free readers must not find it any more.
+          publish_tablet_index();
         }
         else
         {
@@ -1023,9 +1103,25 @@ namespace oceanbase
     }
 
     int ObTabletImage::acquire_tablet(const common::ObNewRange& range,
-        const int32_t scan_direction, ObTablet* &tablet) const
+        const int32_t scan_direction, ObTablet* &tablet, const bool use_tablet_list) const
     {
-      int ret =  find_tablet(range, scan_direction, tablet);
+      int ret = OB_SUCCESS;
+      // the tablet must be referenced before leave the epoch, after
+      // that it could be removed and destroyed.
+      ObEpochManager::Guard guard(tablet_index_epoch_);
+      if (use_tablet_list)
+      {
+        TabletIndex list_index = {tablet_list_.size(), tablet_list_.begin()};
+        ret = find_tablet(list_index, range, scan_direction, tablet);
+      }
+      else if (tablet_index_stale_)
+      {
+        ret = OB_EAGAIN;
+      }
+      else
+      {
+        ret = find_tablet(*tablet_index_, range, scan_direction, tablet);
+      }
 
       if (OB_SUCCESS != ret)
       {
@@ -1040,7 +1136,6 @@ namespace oceanbase
       }
       else
       {
-        atomic_inc((atomic_t*) &ref_count_);
         tablet->inc_ref();
       }
 
@@ -1056,14 +1151,13 @@ namespace oceanbase
         TBSYS_LOG(WARN, "invalid param, tablet=%p", tablet);
         ret = OB_INVALID_ARGUMENT;
       }
-      else if (ref_count_ <= 0)
+      else if (tablet->get_ref_count() <= 0)
       {
-        TBSYS_LOG(WARN, "invalid status, ref_count_=%d", ref_count_);
+        TBSYS_LOG(WARN, "invalid status, tablet ref_count_=%u", tablet->get_ref_count());
         ret = OB_ERROR;
       }
       else
       {
-        atomic_dec((atomic_t*) &ref_count_);
         if (0 == tablet->dec_ref() && tablet->is_removed() && NULL != is_remove_sstable)
         {
           *is_remove_sstable = true;
@@ -1296,11 +1390,13 @@ namespace oceanbase
             int64_t max_seq = tablet->get_max_sstable_file_seq();
             if (max_seq > max_sstable_file_seq_) max_sstable_file_seq_ = max_seq;
             tablet->set_disk_no(disk_no);
-            ret = add_tablet(tablet);
+            ret = insert_tablet(tablet);
           }
 
           if (OB_SUCCESS != ret) break;
         }
+        // publish once after all tablets of this disk loaded.
+        publish_tablet_index();
       }
 
       return ret;
@@ -1804,7 +1900,6 @@ namespace oceanbase
       {
         tablet = tablet_list_.at(cur_iter_idx_);
         atomic_inc((atomic_t*) &cur_iter_idx_);
-        atomic_inc((atomic_t*) &ref_count_);
         tablet->inc_ref();
       }
       return ret;
@@ -1829,7 +1924,7 @@ namespace oceanbase
     int ObTabletImage::dump(const bool dump_sstable) const
     {
       TBSYS_LOG(INFO, "ref_count_=%d, cur_iter_idx_=%d, memory usage=%ld",
-          ref_count_, cur_iter_idx_, allocator_.total());
+          get_ref_count(), cur_iter_idx_, allocator_.total());
 
       TBSYS_LOG(INFO, "----->begin dump tablets in image<--------");
       for (int32_t i = 0; i < tablet_list_.size(); ++i)
@@ -1967,57 +2062,85 @@ namespace oceanbase
       }
       else
       {
-        ret = OB_CS_TABLET_NOT_EXIST;
+        {
+          // no lock here, search the published tablet index. images are
+          // detached and waited out of the epoch before they're freed.
+          ObEpochManager::Guard guard(ObTabletImage::tablet_index_epoch_);
+          ret = search_tablet(range, scan_direction, from_index, version, false, tablet);
+        }
+        if (OB_EAGAIN == ret)
+        {
+          // some tablets added are not published yet, search tablet_list_
+          // under lock. never wait for the lock in the epoch, writers
+          // synchronize the epoch with the lock held.
+          tbsys::CRLockGuard guard(lock_);
+          ret = search_tablet(range, scan_direction, from_index, version, true, tablet);
+        }
+      }
 
-        tbsys::CRLockGuard guard(lock_);
+      return ret;
+    }
 
-        int64_t start_index =
-          (from_index == FROM_SERVICE_INDEX) ? service_index_ : newest_index_;
-        int64_t index = start_index;
-        int64_t serving_version = 0;
+    int ObMultiVersionTabletImage::search_tablet(
+        const common::ObNewRange &range,
+        const ScanDirection scan_direction,
+        const ScanPosition from_index,
+        const int64_t version,
+        const bool use_tablet_list,
+        ObTablet* &tablet) const
+    {
+      int ret = OB_CS_TABLET_NOT_EXIST;
+      // indexes may change without lock, read them once.
+      const int64_t service_index = service_index_;
+      const int64_t start_index =
+        (from_index == FROM_SERVICE_INDEX) ? service_index : newest_index_;
+      int64_t index = start_index;
+      int64_t serving_version = 0;
+      const ObTabletImage* image = NULL;
+
+      if (service_index >= 0 && service_index < MAX_RESERVE_VERSION_COUNT
+          && has_search_tablet(image_tracker_[service_index], use_tablet_list))
+      {
+        serving_version = image_tracker_[service_index]->data_version_;
+      }
 
-        if (service_index_ >= 0 && service_index_ < MAX_RESERVE_VERSION_COUNT
-            && has_tablet(service_index_))
+      do
+      {
+        if (index < 0 || index >= MAX_RESERVE_VERSION_COUNT)
         {
-          serving_version = image_tracker_[service_index_]->data_version_;
+          TBSYS_LOG(WARN, "image (index=%ld) not initialized, has no tablets", index);
+          break;
         }
-
-        do
+        image = image_tracker_[index];
+        // version == 0 search from serving tablet
+        if (version == 0 && has_search_tablet(image, use_tablet_list))
         {
-          if (index < 0 || index >= MAX_RESERVE_VERSION_COUNT)
+          ret = image->acquire_tablet(range, scan_direction, tablet, use_tablet_list);
+        }
+        // version != 0 search from newest tablet which has version less or equal than %version
+        if (version != 0 && has_search_tablet(image, use_tablet_list))
+        {
+          if (version >= serving_version && image->data_version_ <= version)
           {
-            TBSYS_LOG(WARN, "image (index=%ld) not initialized, has no tablets", index);
-            break;
+            // search from serving tablet
+            ret = image->acquire_tablet(range, scan_direction, tablet, use_tablet_list);
           }
-          // version == 0 search from serving tablet
-          if (version == 0 && has_tablet(index))
+          else if (version < serving_version && image->data_version_ == version)
           {
-            ret = image_tracker_[index]->acquire_tablet(range, scan_direction, tablet);
+            // search from oldest tablet
+            ret = image->acquire_tablet(range, scan_direction, tablet, use_tablet_list);
           }
-          // version != 0 search from newest tablet which has version less or equal than %version
-          if (version != 0 && has_tablet(index))
+          else
           {
-            if (version >= serving_version && image_tracker_[index]->data_version_ <= version)
-            {
-              // search from serving tablet
-              ret = image_tracker_[index]->acquire_tablet(range, scan_direction, tablet);
-            }
-            else if (version < serving_version && image_tracker_[index]->data_version_ == version)
-            {
-              // search from oldest tablet
-              ret = image_tracker_[index]->acquire_tablet(range, scan_direction, tablet);
-            }
-            else
-            {
-              // query tablet version not exist
-            }
+            // query tablet version not exist
           }
+        }
 
-          if (OB_SUCCESS == ret) break;
-          // if not found, search older version tablet until iterated every version of tablet.
-          if (--index < 0) index = MAX_RESERVE_VERSION_COUNT - 1;
-        } while (index != start_index);
-      }
+        // OB_EAGAIN: the index is stale, caller searches again with lock.
+        if (OB_SUCCESS == ret || OB_EAGAIN == ret) break;
+        // if not found, search older version tablet until iterated every version of tablet.
+        if (--index < 0) index = MAX_RESERVE_VERSION_COUNT - 1;
+      } while (index != start_index);
 
       return ret;
     }
@@ -2027,24 +2150,22 @@ namespace oceanbase
       int ret = OB_SUCCESS;
       bool is_remove_sstable = false;
 
+      // no lock here, the image can't be destroyed while it has
+      // tablets referenced.
+      if (NULL == tablet)
       {
-        tbsys::CRLockGuard guard(lock_);
-
-        if (NULL == tablet)
-        {
-          TBSYS_LOG(WARN, "release_tablet invalid argument tablet null");
-          ret = OB_INVALID_ARGUMENT;
-        }
-        else if (!has_match_version(tablet->get_data_version()))
-        {
-          TBSYS_LOG(WARN, "release_tablet version=%ld dont match",
-              tablet->get_data_version());
-          ret = OB_INVALID_ARGUMENT;
-        }
-        else
-        {
-          ret = get_image(tablet->get_data_version()).release_tablet(tablet, &is_remove_sstable);
-        }
+        TBSYS_LOG(WARN, "release_tablet invalid argument tablet null");
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (!has_match_version(tablet->get_data_version()))
+      {
+        TBSYS_LOG(WARN, "release_tablet version=%ld dont match",
+            tablet->get_data_version());
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        ret = get_image(tablet->get_data_version()).release_tablet(tablet, &is_remove_sstable);
       }
 
       if (OB_SUCCESS == ret && is_remove_sstable)
@@ -2408,6 +2529,14 @@ namespace oceanbase
         service_index_ = newest_index_;
       }
 
+      // all the tablets merged or added to the new version are in, so
+      // publish its index once here instead of on every add_tablet.
+      if (OB_SUCCESS == ret && NULL != image_tracker_[service_index_]
+          && image_tracker_[service_index_]->tablet_index_stale_)
+      {
+        image_tracker_[service_index_]->publish_tablet_index();
+      }
+
       return ret;
     }
 
@@ -2531,7 +2660,6 @@ namespace oceanbase
             {
               tablets[merge_count++] = *it;
               // add reference count
-              image_tracker_[index]->acquire();
               (*it)->inc_ref();
             }
           }
@@ -2671,11 +2799,19 @@ namespace oceanbase
       {
         if (NULL != image_tracker_[i])
         {
-          ret = image_tracker_[i]->destroy();
+          ObTabletImage* image = image_tracker_[i];
+          // detach first and wait for the lock free readers which may
+          // still see the image.
+          image_tracker_[i] = NULL;
+          ObTabletImage::tablet_index_epoch_.synchronize();
+          ret = image->destroy();
           if (OB_SUCCESS == ret)
           {
-            delete image_tracker_[i];
-            image_tracker_[i] = NULL;
+            delete image;
+          }
+          else
+          {
+            image_tracker_[i] = image;
           }
         }
       }
@@ -2985,7 +3121,7 @@ namespace oceanbase
           if ((*it)->is_merged() && !(*it)->is_removed())
           {
             ret = image_tracker_[newest_index_]->acquire_tablet(
-              (*it)->get_range(), SCAN_FORWARD, tablet);
+              (*it)->get_range(), SCAN_FORWARD, tablet, true);
             if (OB_SUCCESS == ret && NULL != tablet)
             {
               image_tracker_[newest_index_]->release_tablet(tablet);
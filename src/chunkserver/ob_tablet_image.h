@@ -23,6 +23,7 @@
 #include "common/ob_spin_rwlock.h"
 #include "common/ob_file.h"
 #include "common/ob_atomic.h"
+#include "common/ob_epoch_manager.h"
 #include "sstable/ob_disk_path.h"
 #include "sstable/ob_sstable_reader.h"
 #include "compactsstablev2/ob_compact_sstable_reader.h"
@@ -112,7 +113,14 @@ namespace oceanbase
         int destroy();
         int dump(const bool dump_sstable = false) const;
 
-        int acquire_tablet(const common::ObNewRange& range, const int32_t scan_direction, ObTablet* &tablet) const;
+        /**
+         * search the published tablet index without lock, returns
+         * OB_EAGAIN if it's stale. search tablet_list_ instead if
+         * %use_tablet_list, caller must hold the read lock of
+         * ObMultiVersionTabletImage then.
+         */
+        int acquire_tablet(const common::ObNewRange& range, const int32_t scan_direction,
+            ObTablet* &tablet, const bool use_tablet_list = false) const;
         int release_tablet(ObTablet* tablet, bool* is_remove_sstable = NULL) const;
         int acquire_tablet(const sstable::ObSSTableId& sstable_id, ObTablet* &tablet) const;
         int include_sstable(const sstable::ObSSTableId& sstable_id) const;
@@ -132,7 +140,8 @@ namespace oceanbase
         int get_next_tablet(ObTablet* &tablet);
         int end_scan_tablets();
 
-        inline int32_t get_ref_count() const { return atomic_read((atomic_t*)&ref_count_); }
+        // sum of tablet refs, for diagnostics only
+        int32_t get_ref_count() const;
         inline int64_t get_max_sstable_file_seq() const { return max_sstable_file_seq_; }
         inline int64_t get_data_version() const { return data_version_; }
         inline void set_data_version(int64_t version) { data_version_ = version; }
@@ -184,10 +193,32 @@ namespace oceanbase
             const char* buf, const int64_t data_len, int64_t& pos);
 
       private:
+        /**
+         * immutable sorted copy of tablet_list_ for lock free lookup.
+         * adding tablets only marks it stale, lookups fall back to
+         * tablet_list_ under the read lock until a new one is published
+         * after a batch of adds (image loaded or upgraded to service).
+         * removing tablets publishes at once, so a removed tablet can't
+         * be found after remove returns. the old one is freed after all
+         * readers which may see it leave tablet_index_epoch_, readers
+         * inc_ref() the tablet before leaving.
+         */
+        struct TabletIndex
+        {
+          int64_t count_;
+          ObTablet** tablets_;
+        };
+
         int find_tablet(const sstable::ObSSTableId& sstable_id, ObTablet* &tablet) const;
-        int find_tablet(const common::ObNewRange& range, const int32_t scan_direction, ObTablet* &tablet) const;
-        int find_tablet( const uint64_t table_id, const common::ObRowkey& key, const ObRowkeyInfo* ri, 
+        int find_tablet(const TabletIndex& index, const common::ObNewRange& range,
+            const int32_t scan_direction, ObTablet* &tablet) const;
+        int find_tablet(const TabletIndex& index, const uint64_t table_id,
+            const common::ObRowkey& key, const ObRowkeyInfo* ri,
             const ObBorderFlag& border_flag, const int32_t scan_direction, ObTablet* &tablet) const;
+        bool has_published_tablet() const;
+        int insert_tablet(ObTablet* tablet);
+        void publish_tablet_index();
+        void swap_tablet_index(TabletIndex* index);
 
         int acquire_tablets(const uint64_t table_id, common::ObVector<ObTablet*>& table_tablets);
         int release_tablets(const common::ObVector<ObTablet*>& table_tablets);
@@ -196,8 +227,6 @@ namespace oceanbase
         sstable::ObSSTableReader* alloc_sstable_object();
         compactsstablev2::ObCompactSSTableReader* alloc_compact_sstable_object();
         int reset();
-        inline int acquire() { return atomic_inc_return((atomic_t*) &ref_count_); }
-        inline int release() { return atomic_dec_return((atomic_t*) &ref_count_); }
 
       private:
         static const int64_t DEFAULT_TABLET_NUM = 128 * 1024L;
@@ -205,8 +234,13 @@ namespace oceanbase
         typedef common::hash::ObHashMap<sstable::ObSSTableId, ObTablet*, 
           common::hash::NoPthreadDefendMode> HashMap;
 
+        static TabletIndex empty_tablet_index_;
+        static common::ObEpochManager tablet_index_epoch_;
+
       private:
         common::ObSortedVector<ObTablet*> tablet_list_;
+        TabletIndex* volatile tablet_index_;
+        volatile bool tablet_index_stale_;
         common::ObVector<sstable::ObSSTableReader*> sstable_list_;
         common::ObVector<ObTablet*> delete_table_tablet_list_;
         common::ObVector<ObTablet*> report_tablet_list_;
@@ -216,7 +250,6 @@ namespace oceanbase
         // will be discard on next version.
         int64_t data_version_; 
         int64_t max_sstable_file_seq_;
-        volatile int32_t ref_count_;
         volatile int32_t cur_iter_idx_;
         volatile uint64_t merged_tablet_count_;
 
@@ -444,6 +477,9 @@ namespace oceanbase
         void get_image_stat(ObTabletImageStat& stat);
 
       private:
+        int search_tablet(const common::ObNewRange &range,
+            const ScanDirection scan_direction, const ScanPosition from_index,
+            const int64_t version, const bool use_tablet_list, ObTablet* &tablet) const;
         int64_t get_eldest_index() const;
         int alloc_tablet_image(const int64_t version);
         
@@ -465,6 +501,16 @@ namespace oceanbase
             && image_tracker_[index]->data_version_ > 0
             && image_tracker_[index]->tablet_list_.size() > 0;
         }
+        // has_tablet for search_tablet. without lock only the published
+        // index can be read, a stale image counts as having tablets so
+        // that the search falls back to lock.
+        static inline bool has_search_tablet(const ObTabletImage* image,
+            const bool use_tablet_list)
+        {
+          return NULL != image && image->data_version_ > 0
+            && (use_tablet_list ? image->tablet_list_.size() > 0
+                : image->has_published_tablet());
+        }
         inline bool has_version_tablet(const int64_t version) const
         {
           return has_tablet(version % MAX_RESERVE_VERSION_COUNT);
@@ -544,7 +590,6 @@ namespace oceanbase
             if (image_.has_report_tablet(cur_vi_))
             {
               tablet = image_.image_tracker_[cur_vi_]->report_tablet_list_.at(static_cast<int32_t>(cur_ti_));
-              image_.image_tracker_[cur_vi_]->acquire();
               tablet->inc_ref();
             }
             return tablet;
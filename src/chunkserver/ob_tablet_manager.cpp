@@ -190,6 +190,48 @@ namespace oceanbase
         }
       }
 
+      if (OB_SUCCESS == err && config_->fused_row_cache_size > 0)
+      {
+        if (OB_SUCCESS != (err = fused_row_cache_.init(config_->fused_row_cache_size,
+                                                       config_->fused_row_cache_sync_interval)))
+        {
+          TBSYS_LOG(ERROR, "init fused row cache failed, err=%d", err);
+        }
+      }
+
+      if (OB_SUCCESS == err && config_->use_disk_io_engine)
+      {
+        int32_t disk_num = 0;
+        const int32_t* disk_no_array = disk_manager_.get_disk_no_array(disk_num);
+        if (OB_SUCCESS != (err = io_engine_.init(disk_no_array, disk_num,
+                                                 config_->disk_io_queue_depth)))
+        {
+          TBSYS_LOG(ERROR, "init disk io engine failed, disk_num=%d, queue_depth=%ld, err=%d",
+                    disk_num, (int64_t)config_->disk_io_queue_depth, err);
+        }
+        else
+        {
+          get_serving_block_cache().set_io_engine(&io_engine_);
+          compact_block_cache_.set_io_engine(&io_engine_);
+        }
+      }
+
+      if (OB_SUCCESS == err && config_->block_cache_scan_resistant)
+      {
+        if (OB_SUCCESS != (err = get_serving_block_cache().get_kv_cache().set_replace_policy(
+                KVStoreCacheComponent::TWO_Q_POLICY, config_->block_cache_probation_percent)))
+        {
+          TBSYS_LOG(ERROR, "set block cache replace policy failed, probation_percent=%ld, err=%d",
+                    (int64_t)config_->block_cache_probation_percent, err);
+        }
+        else if (OB_SUCCESS != (err = compact_block_cache_.get_kv_cache().set_replace_policy(
+                KVStoreCacheComponent::TWO_Q_POLICY, config_->block_cache_probation_percent)))
+        {
+          TBSYS_LOG(ERROR, "set compact block cache replace policy failed, probation_percent=%ld, err=%d",
+                    (int64_t)config_->block_cache_probation_percent, err);
+        }
+      }
+
       return err;
     }
 
@@ -208,6 +250,22 @@ namespace oceanbase
       return bypass_sstable_loader_.init(this);
     }
 
+    int ObTabletManager::start_cache_snapshot_thread()
+    {
+      int ret = OB_SUCCESS;
+      if (NULL == config_)
+      {
+        TBSYS_LOG(WARN, "config is NULL, can't start cache snapshot thread");
+        ret = OB_NOT_INIT;
+      }
+      else
+      {
+        ret = cache_snapshot_.init(this, config_->cache_snapshot_interval,
+                                   config_->cache_warmup_bandwidth);
+      }
+      return ret;
+    }
+
     ObChunkMerge & ObTabletManager::get_chunk_merge()
     {
       return chunk_merge_;
@@ -223,6 +281,11 @@ namespace oceanbase
       return bypass_sstable_loader_;
     }
 
+    ObCacheSnapshot & ObTabletManager::get_cache_snapshot()
+    {
+      return cache_snapshot_;
+    }
+
     void ObTabletManager::destroy()
     {
       if ( is_init_ )
@@ -232,6 +295,9 @@ namespace oceanbase
         chunk_merge_.destroy();
         bypass_sstable_loader_.destroy();
         cache_thread_.destroy();
+        cache_snapshot_.destroy();
+        // wait for inflight reads before destroying caches they fill
+        io_engine_.destroy();
         fileinfo_cache_.destroy();
         for (uint64_t i = 0; i < TABLET_ARRAY_NUM; ++i)
         {
@@ -239,6 +305,7 @@ namespace oceanbase
           block_index_cache_[i].destroy();
         }
         join_cache_.destroy();
+        fused_row_cache_.destroy();
         if (NULL != sstable_row_cache_)
         {
           sstable_row_cache_->destroy();
@@ -1887,7 +1954,13 @@ namespace oceanbase
       {
         //initialize unserving block cache
         dst_block_cache.set_fileinfo_cache(fileinfo_cache_);
+        dst_block_cache.set_io_engine(io_engine_.is_inited() ? &io_engine_ : NULL);
         ret = dst_block_cache.init(block_cache_size);
+        if (OB_SUCCESS == ret && NULL != config_ && config_->block_cache_scan_resistant)
+        {
+          ret = dst_block_cache.get_kv_cache().set_replace_policy(
+            KVStoreCacheComponent::TWO_Q_POLICY, config_->block_cache_probation_percent);
+        }
       }
 
       if (OB_SUCCESS == ret)
@@ -19,6 +19,7 @@
 
 #include "common/thread_buffer.h"
 #include "common/ob_file_client.h"
+#include "common/ob_disk_io_engine.h"
 #include "sstable/ob_blockcache.h"
 #include "sstable/ob_block_index_cache.h"
 #include "sstable/ob_sstable_row_cache.h"
@@ -29,6 +30,7 @@
 #include "compactsstablev2/ob_sstable_block_index_cache.h"
 #include "sql/ob_sstable_scan.h"
 #include "ob_join_cache.h"
+#include "ob_fused_row_cache.h"
 #include "ob_fileinfo_cache.h"
 #include "ob_disk_manager.h"
 #include "ob_tablet_image.h"
@@ -39,6 +41,7 @@
 #include "ob_compactsstable_cache.h"
 #include "ob_multi_tablet_merger.h"
 #include "ob_bypass_sstable_loader.h"
+#include "ob_cache_snapshot.h"
 #include "ob_file_recycle.h"
 
 namespace oceanbase
@@ -80,6 +83,7 @@ namespace oceanbase
         int start_merge_thread();
         int start_cache_thread();
         int start_bypass_loader_thread();
+        int start_cache_snapshot_thread();
         int load_tablets(const int32_t* disk_no_array, const int32_t size);
         void destroy();
 
@@ -110,6 +114,7 @@ namespace oceanbase
         ObChunkMerge &get_chunk_merge() ;
         ObCompactSSTableMemThread& get_cache_thread();
         ObBypassSSTableLoader& get_bypass_sstable_loader();
+        ObCacheSnapshot& get_cache_snapshot();
 
         int report_tablets();
 
@@ -164,6 +169,7 @@ namespace oceanbase
 
         const ObMultiVersionTabletImage& get_serving_tablet_image() const;
         inline sstable::ObSSTableRowCache* get_row_cache() const { return sstable_row_cache_; }
+        inline ObFusedRowCache& get_fused_row_cache() { return fused_row_cache_; }
 
         /**
          * only after the new tablet image is loaded, and the tablet
@@ -262,8 +268,10 @@ namespace oceanbase
         compactsstablev2::ObSSTableBlockCache compact_block_cache_;
         ObJoinCache join_cache_; //used for join phase of daily merge
         sstable::ObSSTableRowCache* sstable_row_cache_;
+        ObFusedRowCache fused_row_cache_;
 
         ObDiskManager disk_manager_;
+        common::ObDiskIOEngine io_engine_;
         ObRegularRecycler regular_recycler_;
         ObScanRecycler scan_recycler_;
         ObMultiVersionTabletImage tablet_image_;
@@ -273,6 +281,7 @@ namespace oceanbase
         ObCompactSSTableMemThread cache_thread_;
         const ObChunkServerConfig* config_;
         ObBypassSSTableLoader bypass_sstable_loader_;
+        ObCacheSnapshot cache_snapshot_;
     };
 
     inline FileInfoCache&  ObTabletManager::get_fileinfo_cache()
@@ -18,6 +18,7 @@
 #include "ob_tablet_merger_v2.h"
 #include "common/ob_schema.h"
 #include "common/file_directory_utils.h"
+#include "compactsstablev2/ob_compact_sstable_reader.h"
 #include "compactsstablev2/ob_sstable_store_struct.h"
 #include "compactsstablev2/ob_sstable_schema.h"
 #include "sql/ob_sql_scan_param.h"
@@ -38,8 +39,23 @@ namespace oceanbase
      *-----------------------------------------------------------------------------*/
 
     ObTabletMergerV2::ObTabletMergerV2(ObChunkMerge& chunk_merge, ObTabletManager& manager) 
-      : ObTabletMerger(chunk_merge, manager)
-    {}
+      : ObTabletMerger(chunk_merge, manager), is_sub_merger_(false)
+    {
+      memset(sub_mergers_, 0, sizeof(sub_mergers_));
+    }
+
+    ObTabletMergerV2::~ObTabletMergerV2()
+    {
+      for (int64_t i = 0; i < MAX_SUB_MERGE_NUM; ++i)
+      {
+        if (NULL != sub_mergers_[i])
+        {
+          sub_mergers_[i]->~ObTabletMergerV2();
+          ob_free(sub_mergers_[i]);
+          sub_mergers_[i] = NULL;
+        }
+      }
+    }
 
     int ObTabletMergerV2::init()
     {
@@ -130,6 +146,7 @@ namespace oceanbase
 
 
 
+      writer_.set_block_encoding(THE_CHUNK_SERVER.get_config().merge_block_encoding);
       if (OB_SUCCESS != (ret = writer_.set_sstable_param(version_range, 
               store_type, table_count, sstable_block_size, compressor_string, 
               max_sstable_size, min_split_sstable_size)))
@@ -140,10 +157,10 @@ namespace oceanbase
             ret, frozen_version_, store_type, table_count, sstable_block_size,
             compressor_name, max_sstable_size, sstable_block_size);
       }
-      else if (OB_SUCCESS != (ret = writer_.set_table_info(tablet->get_range().table_id_, 
-              sstable_schema_, tablet->get_range())))
+      else if (OB_SUCCESS != (ret = writer_.set_table_info(merge_range_.table_id_, 
+              sstable_schema_, merge_range_)))
       {
-        TBSYS_LOG(WARN, "set_table_info error, ret=%d, range=%s", ret, to_cstring(tablet->get_range()));
+        TBSYS_LOG(WARN, "set_table_info error, ret=%d, range=%s", ret, to_cstring(merge_range_));
       }
       else
       {
@@ -168,17 +185,23 @@ namespace oceanbase
             "max_sstable_size=%ld, min_split_sstable_size=%ld, sstable_block_size=%ld",
             sstable_id, tablet->get_data_version(), frozen_version,
             tablet->get_row_count(), tablet->get_occupy_size(), 
-            compressor_name, path, to_cstring(tablet->get_range()), 
+            compressor_name, path, to_cstring(merge_range_), 
             max_sstable_size, min_split_sstable_size, sstable_block_size);
       }
 
       return ret;
     }
 
-    int ObTabletMergerV2::prepare_merge(ObTablet *tablet, int64_t frozen_version)
+    int ObTabletMergerV2::prepare_merge(ObTablet *tablet, int64_t frozen_version,
+        const ObNewRange* range)
     {
       int ret = OB_SUCCESS;
       ObTableSchema* table_schema = NULL;
+      if (NULL != tablet)
+      {
+        merge_range_ = (NULL == range) ? tablet->get_range() : *range;
+      }
+
       if (NULL == tablet || frozen_version <= 0)
       {
         TBSYS_LOG(ERROR,"merge : interal error, param invalid tablet[%p], frozen_version:[%ld]",
@@ -283,6 +306,8 @@ namespace oceanbase
       int ret = OB_SUCCESS;
       bool is_tablet_unchanged = false;
       bool is_sstable_split = false;
+      bool is_parallel = false;
+      int64_t sub_range_count = 0;
       bool need_filter = tablet_merge_filter_.need_filter();
       /**
        * there are 2 cases that we cann't do "unmerge_if_unchanged"
@@ -291,9 +316,10 @@ namespace oceanbase
        * 2. need expire some data in this tablet
        * 3. the table need join another tables (in v2, TabletScan op do this job)
        * 4. the sub range of this tablet is splited(in v2, Writer do this job)
+       * 5. merge only a sub range of the tablet in sub merger
        */
       bool unmerge_if_unchanged =
-        (THE_CHUNK_SERVER.get_config().unmerge_if_unchanged && (!need_filter) );
+        (THE_CHUNK_SERVER.get_config().unmerge_if_unchanged && (!need_filter) && (!is_sub_merger_));
 
       if (OB_SUCCESS != (ret = wait_aio_buffer()))
       {
@@ -311,13 +337,19 @@ namespace oceanbase
         TBSYS_LOG(INFO, "tablet %s has no incremental data, finish.", to_cstring(old_tablet_->get_range()));
         ret = finish_sstable(false, true);
       }
+      else if (!is_sub_merger_ && OB_SUCCESS == split_sub_ranges(sub_range_count)
+          && sub_range_count > 1)
+      {
+        // big tablet, merge sub ranges concurrently after close tablet_scan_
+        is_parallel = true;
+      }
       else if (OB_SUCCESS != (ret = create_new_sstable()))
       {
         TBSYS_LOG(ERROR,"create sstable failed.");
       }
 
       const ObRow *cur_row = NULL;
-      while (OB_SUCCESS == ret && !is_tablet_unchanged)
+      while (OB_SUCCESS == ret && !is_tablet_unchanged && !is_parallel)
       {
         if ( manager_.is_stoped() )
         {
@@ -373,6 +405,13 @@ namespace oceanbase
       }
       CLEAR_TRACE_LOG();
 
+      if (OB_SUCCESS == ret && is_parallel
+          && OB_SUCCESS != (ret = merge_sub_ranges(sub_range_count)))
+      {
+        TBSYS_LOG(WARN, "merge_sub_ranges error, ret=%d, tablet=%s, sub_range_count=%ld",
+            ret, to_cstring(merge_range_), sub_range_count);
+      }
+
       return ret;
     }
 
@@ -412,6 +451,237 @@ namespace oceanbase
       return ret;
     }
 
+    int ObTabletMergerV2::merge_sub_range(ObTablet *tablet, const int64_t frozen_version,
+        const ObNewRange& range)
+    {
+      int ret = OB_SUCCESS;
+
+      if (OB_SUCCESS != (ret = prepare_merge(tablet, frozen_version, &range)))
+      {
+        TBSYS_LOG(WARN, "prepare sub range merge failed, ret=%d, range=%s", ret, to_cstring(range));
+      }
+      else if (OB_SUCCESS != (ret = tablet_merge_filter_.init(chunk_merge_.current_schema_,
+                0, tablet, frozen_version, chunk_merge_.frozen_timestamp_)))
+      {
+        TBSYS_LOG(ERROR, "failed to initialize tablet merge filter, table=%ld",
+            tablet->get_range().table_id_);
+      }
+      else if (OB_SUCCESS != (ret = do_merge()))
+      {
+        TBSYS_LOG(WARN, "do_merge sub range error, ret=%d, range=%s", ret, to_cstring(range));
+      }
+
+      TBSYS_LOG(INFO, "finish merge sub range %s, ret=%d", to_cstring(range), ret);
+
+      return ret;
+    }
+
+    int ObTabletMergerV2::SubMergeTask::process()
+    {
+      return merger_->merge_sub_range(tablet_, frozen_version_, *range_);
+    }
+
+    int ObTabletMergerV2::split_sub_ranges(int64_t& sub_range_count)
+    {
+      int ret = OB_SUCCESS;
+      ObChunkServerConfig& config = THE_CHUNK_SERVER.get_config();
+      // one sub range for each thread of the sub merge pool
+      int64_t split_count = chunk_merge_.sub_merge_pool_.get_thread_num();
+      const ObNewRange& range = old_tablet_->get_range();
+      const compactsstablev2::ObCompactSSTableReader* reader = NULL;
+      const compactsstablev2::ObSSTableTableIndex* table_index = NULL;
+      compactsstablev2::ObBlockIndexPositionInfo info;
+      ObRowkey endkeys[MAX_SUB_MERGE_NUM];
+      int64_t endkey_count = 0;
+      sub_range_count = 0;
+
+      if (split_count > MAX_SUB_MERGE_NUM)
+      {
+        split_count = MAX_SUB_MERGE_NUM;
+      }
+
+      /**
+       * only the tablet with one compact sstable can be splited by
+       * block endkeys, other tablets are merged in one thread as
+       * before.
+       */
+      if (split_count <= 1
+          || old_tablet_->get_occupy_size() < config.min_sub_range_merge_tablet_size
+          || SSTableReader::COMPACT_SSTABLE_VERSION != old_tablet_->get_sstable_version()
+          || 1 != old_tablet_->get_sstable_reader_list().count())
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else if (NULL == (reader = dynamic_cast<const compactsstablev2::ObCompactSSTableReader*>(
+              old_tablet_->get_sstable_reader_list().at(0))))
+      {
+        TBSYS_LOG(WARN, "tablet sstable reader is not compact sstable reader, range=%s",
+            to_cstring(range));
+        ret = OB_NOT_SUPPORTED;
+      }
+      else if (NULL == (table_index = reader->get_table_index(range.table_id_)))
+      {
+        TBSYS_LOG(WARN, "table index is null, table_id=%lu", range.table_id_);
+        ret = OB_ERROR;
+      }
+      else
+      {
+        info.reset();
+        info.sstable_file_id_ = reader->get_sstable_id();
+        info.index_offset_ = table_index->block_index_offset_;
+        info.index_size_ = table_index->block_index_size_;
+        info.endkey_offset_ = table_index->block_endkey_offset_;
+        info.endkey_size_ = table_index->block_endkey_size_;
+        info.block_count_ = table_index->block_count_;
+        sub_range_allocator_.reuse();
+        if (OB_SUCCESS != (ret = manager_.get_compact_block_index_cache().get_split_endkeys(
+                info, range.table_id_, split_count, endkeys, endkey_count, sub_range_allocator_)))
+        {
+          TBSYS_LOG(WARN, "get_split_endkeys error, ret=%d, range=%s, split_count=%ld",
+              ret, to_cstring(range), split_count);
+        }
+      }
+
+      if (OB_SUCCESS == ret
+          && OB_SUCCESS == (ret = build_sub_ranges(range, endkeys, endkey_count,
+              sub_ranges_, MAX_SUB_MERGE_NUM, sub_range_count))
+          && sub_range_count > 0)
+      {
+        TBSYS_LOG(INFO, "split tablet %s into %ld sub ranges, occupy_size=%ld",
+            to_cstring(range), sub_range_count, old_tablet_->get_occupy_size());
+      }
+
+      return ret;
+    }
+
+    int ObTabletMergerV2::build_sub_ranges(const ObNewRange& range,
+        const ObRowkey* endkeys, const int64_t endkey_count,
+        ObNewRange* sub_ranges, const int64_t size, int64_t& sub_range_count)
+    {
+      int ret = OB_SUCCESS;
+      sub_range_count = 0;
+
+      if ((NULL == endkeys && endkey_count > 0) || NULL == sub_ranges || endkey_count >= size)
+      {
+        TBSYS_LOG(WARN, "invalid argument, endkeys=%p, endkey_count=%ld, sub_ranges=%p, size=%ld",
+            endkeys, endkey_count, sub_ranges, size);
+        ret = OB_INVALID_ARGUMENT;
+      }
+
+      for (int64_t i = 0; OB_SUCCESS == ret && i < endkey_count; ++i)
+      {
+        // endkeys must be inside the tablet range, and strictly increasing
+        if (range.start_key_.compare(endkeys[i]) >= 0
+            || range.end_key_.compare(endkeys[i]) <= 0
+            || (sub_range_count > 0 && sub_ranges[sub_range_count - 1].end_key_.compare(endkeys[i]) >= 0))
+        {
+          TBSYS_LOG(DEBUG, "skip block endkey %s, range=%s", to_cstring(endkeys[i]), to_cstring(range));
+        }
+        else
+        {
+          ObNewRange& sub_range = sub_ranges[sub_range_count];
+          sub_range = range;
+          if (sub_range_count > 0)
+          {
+            sub_range.start_key_ = sub_ranges[sub_range_count - 1].end_key_;
+            sub_range.border_flag_.unset_inclusive_start();
+            sub_range.border_flag_.unset_min_value();
+          }
+          sub_range.end_key_ = endkeys[i];
+          sub_range.border_flag_.set_inclusive_end();
+          sub_range.border_flag_.unset_max_value();
+          ++sub_range_count;
+        }
+      }
+
+      if (OB_SUCCESS == ret && sub_range_count > 0)
+      {
+        // the last sub range keeps the end of the tablet
+        ObNewRange& sub_range = sub_ranges[sub_range_count];
+        sub_range = range;
+        sub_range.start_key_ = sub_ranges[sub_range_count - 1].end_key_;
+        sub_range.border_flag_.unset_inclusive_start();
+        sub_range.border_flag_.unset_min_value();
+        ++sub_range_count;
+      }
+
+      return ret;
+    }
+
+    int ObTabletMergerV2::merge_sub_ranges(const int64_t sub_range_count)
+    {
+      int ret = OB_SUCCESS;
+      SubMergeTask tasks[MAX_SUB_MERGE_NUM];
+      ObSubMergePool::Task* task_list[MAX_SUB_MERGE_NUM];
+      int64_t processed_count = 0;
+      void* buf = NULL;
+
+      for (int64_t i = 0; OB_SUCCESS == ret && i < sub_range_count; ++i)
+      {
+        if (NULL == sub_mergers_[i])
+        {
+          if (NULL == (buf = ob_malloc(sizeof(ObTabletMergerV2), ObModIds::OB_CS_MERGER)))
+          {
+            TBSYS_LOG(ERROR, "cannot allocate memory for sub merger.");
+            ret = OB_ALLOCATE_MEMORY_FAILED;
+          }
+          else
+          {
+            sub_mergers_[i] = new (buf) ObTabletMergerV2(chunk_merge_, manager_);
+            sub_mergers_[i]->is_sub_merger_ = true;
+            if (OB_SUCCESS != (ret = sub_mergers_[i]->init()))
+            {
+              TBSYS_LOG(ERROR, "init sub merger error, ret=%d", ret);
+            }
+          }
+        }
+
+        if (OB_SUCCESS == ret)
+        {
+          tasks[i].merger_ = sub_mergers_[i];
+          tasks[i].tablet_ = old_tablet_;
+          tasks[i].frozen_version_ = frozen_version_;
+          tasks[i].range_ = &sub_ranges_[i];
+          task_list[i] = &tasks[i];
+        }
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        // wait until all sub ranges are merged, even if some of them failed
+        processed_count = sub_range_count;
+        if (OB_SUCCESS != (ret = chunk_merge_.sub_merge_pool_.process(task_list, sub_range_count)))
+        {
+          TBSYS_LOG(WARN, "merge sub ranges in sub merge pool error, ret=%d", ret);
+        }
+      }
+
+      // new tablets of sub ranges are in key order
+      for (int64_t i = 0; OB_SUCCESS == ret && i < processed_count; ++i)
+      {
+        ObVector<ObTablet*>& sub_tablets = sub_mergers_[i]->tablet_array_;
+        for (ObVector<ObTablet*>::iterator it = sub_tablets.begin();
+            OB_SUCCESS == ret && it != sub_tablets.end(); ++it)
+        {
+          if (OB_SUCCESS != (ret = tablet_array_.push_back(*it)))
+          {
+            TBSYS_LOG(WARN, "cannot push sub tablet=%p", *it);
+          }
+        }
+      }
+
+      if (OB_SUCCESS != ret)
+      {
+        tablet_array_.clear();
+        for (int64_t i = 0; i < processed_count; ++i)
+        {
+          sub_mergers_[i]->cleanup_uncomplete_sstable_files();
+        }
+      }
+
+      return ret;
+    }
+
     int ObTabletMergerV2::cleanup_uncomplete_sstable_files()
     {
       int64_t sstable_id = 0;
@@ -556,9 +826,9 @@ namespace oceanbase
       {
         TBSYS_LOG(ERROR, "set table id failed: [%d]",ret);
       }
-      else if (OB_SUCCESS != (ret = scan_param.set_range(old_tablet_->get_range())))
+      else if (OB_SUCCESS != (ret = scan_param.set_range(merge_range_)))
       {
-        TBSYS_LOG(ERROR, "set range failed:[%d] range:%s", ret, to_cstring(old_tablet_->get_range()));
+        TBSYS_LOG(ERROR, "set range failed:[%d] range:%s", ret, to_cstring(merge_range_));
       }
       else if (OB_SUCCESS != (ret = scan_param.set_project(project)))
       {
@@ -705,7 +975,7 @@ namespace oceanbase
     {
       int ret = OB_SUCCESS;
       ObTablet* new_tablet = NULL;
-      const ObNewRange *new_range = &old_tablet_->get_range();
+      const ObNewRange *new_range = &merge_range_;
 
       ObMultiVersionTabletImage& tablet_image = manager_.get_serving_tablet_image();
       if (!is_tablet_unchanged)
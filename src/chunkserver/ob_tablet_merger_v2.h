@@ -19,10 +19,13 @@
 #define OB_CHUNKSERVER_OB_TABLET_MERGER_V2_H_
 
 #include "common/ob_define.h"
+#include "common/ob_range2.h"
+#include "common/page_arena.h"
 #include "compactsstablev2/ob_compact_sstable_writer.h"
 #include "compactsstablev2/ob_sstable_schema.h"
 #include "ob_tablet_merger_v1.h"
 #include "ob_tablet_merge_filter.h"
+#include "ob_sub_merge_pool.h"
 #include "sql/ob_tablet_scan.h"
 
 namespace oceanbase
@@ -46,16 +49,48 @@ namespace oceanbase
     class ObTabletMergerV2 : public ObTabletMerger
     {
       public:
+        static const int64_t MAX_SUB_MERGE_NUM = 16;
+
         ObTabletMergerV2(ObChunkMerge& chunk_merge, ObTabletManager& manager);
-        ~ObTabletMergerV2() {}
+        ~ObTabletMergerV2();
 
         virtual int init();
         virtual int merge(ObTablet *tablet, int64_t frozen_version);
 
+        /**
+         * merge only part of %tablet, called by the parent merger in
+         * a sub merge thread, new tablets are kept in tablet_array_
+         * and the parent merger will update meta for all of them.
+         */
+        int merge_sub_range(ObTablet *tablet, const int64_t frozen_version,
+            const common::ObNewRange& range);
+
+        /**
+         * split %range at %endkeys into adjacent sub ranges, endkeys
+         * not strictly inside %range or not greater than the previous
+         * one are skipped. the first sub range keeps the start of
+         * %range and the last one keeps the end, each split endkey is
+         * inclusive end of its sub range.
+         * @param [out] sub_range_count 0 if no endkey is used
+         */
+        static int build_sub_ranges(const common::ObNewRange& range,
+            const common::ObRowkey* endkeys, const int64_t endkey_count,
+            common::ObNewRange* sub_ranges, const int64_t size, int64_t& sub_range_count);
+
       private:
         DISALLOW_COPY_AND_ASSIGN(ObTabletMergerV2);
 
-        int prepare_merge(ObTablet *tablet, int64_t frozen_version);
+        struct SubMergeTask : public ObSubMergePool::Task
+        {
+          virtual int process();
+          ObTabletMergerV2* merger_;
+          ObTablet* tablet_;
+          int64_t frozen_version_;
+          const common::ObNewRange* range_;
+        };
+
+        int prepare_merge(ObTablet *tablet, int64_t frozen_version,
+            const common::ObNewRange* range = NULL);
         int init_sstable_writer(const common::ObTableSchema & table_schema, 
             const ObTablet* tablet, const int64_t frozen_version);
         
@@ -77,6 +112,10 @@ namespace oceanbase
         int build_new_tablet(const bool is_tablet_unchanged, ObTablet* &tablet);
         int cleanup_uncomplete_sstable_files();
 
+        // split big tablet into sub ranges by block endkeys of its sstable
+        int split_sub_ranges(int64_t& sub_range_count);
+        int merge_sub_ranges(const int64_t sub_range_count);
+
       private:
         compactsstablev2::ObSSTableSchema sstable_schema_;
 
@@ -91,6 +130,13 @@ namespace oceanbase
         sql::ObSSTableScan op_sstable_scan_;
         sql::ObUpsScan op_ups_scan_;
         sql::ObUpsMultiGet op_ups_multi_get_;
+
+        // range of the merging tablet, or sub range for sub merger
+        common::ObNewRange merge_range_;
+        bool is_sub_merger_;
+        common::ObNewRange sub_ranges_[MAX_SUB_MERGE_NUM];
+        common::CharArena sub_range_allocator_;
+        ObTabletMergerV2* sub_mergers_[MAX_SUB_MERGE_NUM];
     };
   } /* chunkserver */
 } /* oceanbase */
@@ -0,0 +1,126 @@
+/**
+ * (C) 2010-2011 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License 
+ * version 2 as published by the Free Software Foundation. 
+ *
+ * lz4_compressor.cpp is for the lz4 compress library.
+ *
+ */
+
+#include <new>
+#include <limits.h>
+#include <lz4.h>
+#include "lz4_compressor.h"
+
+const char * LZ4Compressor::NAME = "lz4_1.0";
+
+int LZ4Compressor::compress(const char *src_buffer,
+                            const int64_t src_data_size,
+                            char *dst_buffer,
+                            const int64_t dst_buffer_size,
+                            int64_t &dst_data_size)
+{
+  int ret = COM_E_NOERROR;
+  int size = 0;
+
+  if (NULL == src_buffer
+      || 0 >= src_data_size
+      || NULL == dst_buffer
+      || 0 >= dst_buffer_size)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else if (src_data_size > LZ4_MAX_INPUT_SIZE)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else if ((src_data_size + get_max_overflow_size(src_data_size)) > dst_buffer_size)
+  {
+    ret = COM_E_OVERFLOW;
+  }
+  else if (0 >= (size = LZ4_compress_fast(src_buffer, dst_buffer,
+                                          static_cast<int>(src_data_size),
+                                          static_cast<int>(dst_buffer_size > INT_MAX ? INT_MAX : dst_buffer_size),
+                                          acceleration_)))
+  {
+    ret = COM_E_INTERNALERROR;
+  }
+  else
+  {
+    dst_data_size = size;
+  }
+  return ret;
+}
+
+int LZ4Compressor::decompress(const char *src_buffer,
+                              const int64_t src_data_size,
+                              char *dst_buffer,
+                              const int64_t dst_buffer_size,
+                              int64_t &dst_data_size)
+{
+  int ret = COM_E_NOERROR;
+  int size = 0;
+
+  if (NULL == src_buffer
+      || 0 >= src_data_size
+      || NULL == dst_buffer
+      || 0 >= dst_buffer_size
+      || src_data_size > INT_MAX)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else if (0 > (size = LZ4_decompress_safe(src_buffer, dst_buffer,
+                                           static_cast<int>(src_data_size),
+                                           static_cast<int>(dst_buffer_size > INT_MAX ? INT_MAX : dst_buffer_size))))
+  {
+    // lz4 doesn't tell corrupted input from small output buffer
+    ret = COM_E_DATAERROR;
+  }
+  else
+  {
+    dst_data_size = size;
+  }
+  return ret;
+}
+
+int LZ4Compressor::set_compress_level(const int64_t compress_level)
+{
+  int ret = COM_E_NOERROR;
+  if (0 >= compress_level || compress_level > INT_MAX)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else
+  {
+    acceleration_ = static_cast<int>(compress_level);
+  }
+  return ret;
+}
+
+const char * LZ4Compressor::get_compressor_name() const
+{
+  return NAME;
+}
+
+int64_t LZ4Compressor::get_max_overflow_size(const int64_t src_data_size) const
+{
+  // same as LZ4_COMPRESSBOUND
+  int64_t size = 16 + src_data_size/255;
+  return size;
+}
+
+ObCompressor *create()
+{
+  return (new(std::nothrow) LZ4Compressor());
+}
+
+void destroy(ObCompressor *lz4)
+{
+  if (NULL != lz4)
+  {
+    delete lz4;
+    lz4 = NULL;
+  }
+}
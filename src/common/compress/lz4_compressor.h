@@ -0,0 +1,48 @@
+/**
+ * (C) 2010-2011 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License 
+ * version 2 as published by the Free Software Foundation. 
+ *
+ * lz4_compressor.h is for the lz4 compress library, it's much
+ * faster than lzo and snappy when decompressing.
+ *
+ */
+#ifndef OCEANBASE_COMMON_COMPRESS_LZ4_COMPRESSOR_H_
+#define OCEANBASE_COMMON_COMPRESS_LZ4_COMPRESSOR_H_
+
+#include "ob_compressor.h"
+
+class LZ4Compressor : public ObCompressor
+{
+public:
+  const static char * NAME;
+  const static int64_t DEFAULT_ACCELERATION = 1;
+public:
+  LZ4Compressor() : acceleration_(DEFAULT_ACCELERATION)
+  {
+  };
+  int compress(const char *src_buffer,
+               const int64_t src_data_size,
+               char *dst_buffer,
+               const int64_t dst_buffer_size,
+               int64_t &dst_data_size);
+  int decompress(const char *src_buffer,
+                 const int64_t src_data_size,
+                 char *dst_buffer,
+                 const int64_t dst_buffer_size,
+                 int64_t &dst_data_size);
+  /*
+   * lz4没有压缩级别，这里设置的是加速因子，越大压缩越快，压缩率越低
+   */
+  int set_compress_level(const int64_t compress_level);
+  const char * get_compressor_name() const;
+  int64_t get_max_overflow_size(const int64_t src_data_size) const;
+private:
+  int acceleration_;
+};
+
+extern "C" ObCompressor *create();
+extern "C" void destroy(ObCompressor *lz4);
+#endif //OCEANBASE_COMMON_COMPRESS_LZ4_COMPRESSOR_H_ 
@@ -0,0 +1,341 @@
+/**
+ * (C) 2010-2011 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License 
+ * version 2 as published by the Free Software Foundation. 
+ *
+ * ob_adaptive_compressor.cpp is for the compressor choosing codec
+ * for each block by the compress ratio and decompress speed.
+ *
+ */
+#include <new>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "ob_adaptive_compressor.h"
+
+const char *ObAdaptiveCompressor::NAME = "adaptive_1.0";
+
+const char *ObAdaptiveCompressor::CODEC_LIB_NAMES[CODEC_COUNT] =
+{
+  NULL,
+  "lz4_1.0",
+  "zstd_1.0",
+};
+
+static int64_t get_time_ns_()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((int64_t)ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+ObAdaptiveCompressor::ObAdaptiveCompressor()
+  : max_size_slack_percent_(DEFAULT_MAX_SIZE_SLACK_PERCENT),
+    min_decompress_speed_(DEFAULT_MIN_DECOMPRESS_SPEED),
+    compress_count_(0), current_codec_(CODEC_NONE), sample_buffer_(NULL),
+    sample_decompress_buffer_(NULL), sample_buffer_size_(0)
+{
+  memset(codecs_, 0, sizeof(codecs_));
+  memset(block_counts_, 0, sizeof(block_counts_));
+  snprintf(name_, sizeof(name_), "%s", NAME);
+}
+
+ObAdaptiveCompressor::~ObAdaptiveCompressor()
+{
+  for (int64_t i = 0; i < CODEC_COUNT; ++i)
+  {
+    destroy_compressor(codecs_[i]);
+    codecs_[i] = NULL;
+  }
+  if (NULL != sample_buffer_)
+  {
+    delete[] sample_buffer_;
+    sample_buffer_ = NULL;
+  }
+  if (NULL != sample_decompress_buffer_)
+  {
+    delete[] sample_decompress_buffer_;
+    sample_decompress_buffer_ = NULL;
+  }
+}
+
+bool ObAdaptiveCompressor::is_adaptive(const char *compressor_lib_name)
+{
+  int64_t name_len = strlen(NAME);
+  return (NULL != compressor_lib_name
+          && 0 == strncmp(compressor_lib_name, NAME, name_len)
+          && ('\0' == compressor_lib_name[name_len] || ',' == compressor_lib_name[name_len]));
+}
+
+int ObAdaptiveCompressor::init(const char *compressor_lib_name)
+{
+  int ret = COM_E_NOERROR;
+  if (COM_E_NOERROR != (ret = parse_param_(compressor_lib_name)))
+  {
+    // invalid thresholds
+  }
+  else
+  {
+    for (int64_t i = CODEC_COUNT - 1; i > CODEC_NONE; --i)
+    {
+      if (NULL == codecs_[i] && NULL != (codecs_[i] = create_compressor(CODEC_LIB_NAMES[i])))
+      {
+        // before the first sample, prefer the fastest one
+        current_codec_ = i;
+      }
+    }
+    if (CODEC_NONE == current_codec_)
+    {
+      ret = COM_E_INTERNALERROR;
+    }
+  }
+  return ret;
+}
+
+int ObAdaptiveCompressor::parse_param_(const char *compressor_lib_name)
+{
+  int ret = COM_E_NOERROR;
+  int64_t name_len = strlen(NAME);
+  long slack_percent = 0;
+  long decompress_speed = 0;
+  int pos = 0;
+  if (!is_adaptive(compressor_lib_name)
+      || MAX_NAME_LENGTH <= static_cast<int64_t>(strlen(compressor_lib_name)))
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else if ('\0' == compressor_lib_name[name_len])
+  {
+    // default thresholds
+  }
+  else if (2 != sscanf(compressor_lib_name + name_len, ",%ld,%ld%n",
+                       &slack_percent, &decompress_speed, &pos)
+           || '\0' != compressor_lib_name[name_len + pos]
+           || 0 > slack_percent
+           || 0 > decompress_speed)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else
+  {
+    max_size_slack_percent_ = slack_percent;
+    min_decompress_speed_ = decompress_speed;
+  }
+  if (COM_E_NOERROR == ret)
+  {
+    // keep the thresholds in the name written into sstable trailer
+    snprintf(name_, sizeof(name_), "%s", compressor_lib_name);
+  }
+  return ret;
+}
+
+int ObAdaptiveCompressor::compress(const char *src_buffer,
+                                   const int64_t src_data_size,
+                                   char *dst_buffer,
+                                   const int64_t dst_buffer_size,
+                                   int64_t &dst_data_size)
+{
+  int ret = COM_E_NOERROR;
+
+  if (NULL == src_buffer
+      || 0 >= src_data_size
+      || NULL == dst_buffer
+      || 0 >= dst_buffer_size)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else if ((src_data_size + get_max_overflow_size(src_data_size)) > dst_buffer_size)
+  {
+    ret = COM_E_OVERFLOW;
+  }
+  else
+  {
+    if (0 == compress_count_ % SAMPLE_INTERVAL)
+    {
+      select_codec_(src_buffer, src_data_size);
+    }
+    ++compress_count_;
+    if (CODEC_NONE == current_codec_)
+    {
+      // equal size tells caller to use the original data
+      dst_data_size = src_data_size;
+    }
+    else if (COM_E_NOERROR == (ret = codecs_[current_codec_]->compress(
+            src_buffer, src_data_size, dst_buffer + 1, dst_buffer_size - 1, dst_data_size)))
+    {
+      dst_buffer[0] = static_cast<char>(current_codec_);
+      dst_data_size += 1;
+    }
+    if (COM_E_NOERROR == ret)
+    {
+      ++block_counts_[current_codec_];
+    }
+  }
+  return ret;
+}
+
+int ObAdaptiveCompressor::decompress(const char *src_buffer,
+                                     const int64_t src_data_size,
+                                     char *dst_buffer,
+                                     const int64_t dst_buffer_size,
+                                     int64_t &dst_data_size)
+{
+  int ret = COM_E_NOERROR;
+  int64_t codec = CODEC_NONE;
+
+  if (NULL == src_buffer
+      || 1 >= src_data_size
+      || NULL == dst_buffer
+      || 0 >= dst_buffer_size)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else if (CODEC_NONE >= (codec = static_cast<unsigned char>(src_buffer[0]))
+           || CODEC_COUNT <= codec)
+  {
+    ret = COM_E_DATAERROR;
+  }
+  else if (NULL == codecs_[codec])
+  {
+    // the block is written by a server with the codec library
+    ret = COM_E_NOIMPL;
+  }
+  else
+  {
+    ret = codecs_[codec]->decompress(src_buffer + 1, src_data_size - 1,
+                                     dst_buffer, dst_buffer_size, dst_data_size);
+  }
+  return ret;
+}
+
+void ObAdaptiveCompressor::select_codec_(const char *src_buffer, const int64_t src_data_size)
+{
+  int64_t sizes[CODEC_COUNT];
+  int64_t speeds[CODEC_COUNT];
+  int64_t min_size = src_data_size;
+  int64_t decompress_size = 0;
+  int64_t start_time = 0;
+  int64_t used_time = 0;
+  int64_t best_codec = -1;
+
+  if (COM_E_NOERROR == ensure_sample_buffer_(src_data_size))
+  {
+    sizes[CODEC_NONE] = src_data_size;
+    speeds[CODEC_NONE] = LONG_MAX;
+    for (int64_t i = CODEC_NONE + 1; i < CODEC_COUNT; ++i)
+    {
+      sizes[i] = -1;
+      speeds[i] = 0;
+      if (NULL != codecs_[i]
+          && COM_E_NOERROR == codecs_[i]->compress(src_buffer, src_data_size, sample_buffer_,
+                                                   sample_buffer_size_, sizes[i]))
+      {
+        start_time = get_time_ns_();
+        if (COM_E_NOERROR == codecs_[i]->decompress(sample_buffer_, sizes[i], sample_decompress_buffer_,
+                                                    src_data_size, decompress_size)
+            && decompress_size == src_data_size)
+        {
+          used_time = get_time_ns_() - start_time;
+          speeds[i] = src_data_size * 1000 / (used_time > 0 ? used_time : 1);
+          if (sizes[i] < min_size)
+          {
+            min_size = sizes[i];
+          }
+        }
+        else
+        {
+          sizes[i] = -1;
+        }
+      }
+    }
+
+    /*
+     * not compressing is always a candidate and never too slow, so
+     * a codec is chosen only if it saves enough space.
+     */
+    for (int64_t i = CODEC_NONE; i < CODEC_COUNT; ++i)
+    {
+      if (0 <= sizes[i]
+          && sizes[i] * 100 <= min_size * (100 + max_size_slack_percent_)
+          && speeds[i] >= min_decompress_speed_
+          && (0 > best_codec || speeds[i] > speeds[best_codec]))
+      {
+        best_codec = i;
+      }
+    }
+    current_codec_ = (0 > best_codec) ? static_cast<int64_t>(CODEC_NONE) : best_codec;
+  }
+}
+
+int ObAdaptiveCompressor::ensure_sample_buffer_(const int64_t src_data_size)
+{
+  int ret = COM_E_NOERROR;
+  int64_t buffer_size = src_data_size + get_max_overflow_size(src_data_size);
+  if (buffer_size > sample_buffer_size_)
+  {
+    if (NULL != sample_buffer_)
+    {
+      delete[] sample_buffer_;
+      sample_buffer_ = NULL;
+    }
+    if (NULL != sample_decompress_buffer_)
+    {
+      delete[] sample_decompress_buffer_;
+      sample_decompress_buffer_ = NULL;
+    }
+    sample_buffer_size_ = 0;
+    if (NULL == (sample_buffer_ = new(std::nothrow) char[buffer_size])
+        || NULL == (sample_decompress_buffer_ = new(std::nothrow) char[buffer_size]))
+    {
+      ret = COM_E_INTERNALERROR;
+    }
+    else
+    {
+      sample_buffer_size_ = buffer_size;
+    }
+  }
+  return ret;
+}
+
+int ObAdaptiveCompressor::set_compress_level(const int64_t compress_level)
+{
+  int ret = COM_E_NOIMPL;
+  if (NULL != codecs_[CODEC_ZSTD])
+  {
+    ret = codecs_[CODEC_ZSTD]->set_compress_level(compress_level);
+  }
+  return ret;
+}
+
+int ObAdaptiveCompressor::set_compress_dict(const char *dict, const int64_t dict_size)
+{
+  int ret = COM_E_NOIMPL;
+  if (NULL != codecs_[CODEC_ZSTD])
+  {
+    ret = codecs_[CODEC_ZSTD]->set_compress_dict(dict, dict_size);
+  }
+  return ret;
+}
+
+const char *ObAdaptiveCompressor::get_compressor_name() const
+{
+  return name_;
+}
+
+int64_t ObAdaptiveCompressor::get_max_overflow_size(const int64_t src_data_size) const
+{
+  int64_t max_size = 0;
+  int64_t size = 0;
+  for (int64_t i = CODEC_NONE + 1; i < CODEC_COUNT; ++i)
+  {
+    if (NULL != codecs_[i] && (size = codecs_[i]->get_max_overflow_size(src_data_size)) > max_size)
+    {
+      max_size = size;
+    }
+  }
+  // one byte for codec id
+  return max_size + 1;
+}
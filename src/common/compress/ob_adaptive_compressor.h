@@ -0,0 +1,110 @@
+/**
+ * (C) 2010-2011 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License 
+ * version 2 as published by the Free Software Foundation. 
+ *
+ * ob_adaptive_compressor.h is for the compressor choosing codec
+ * for each block by the compress ratio and decompress speed.
+ *
+ */
+#ifndef OCEANBASE_COMMON_COMPRESS_OB_ADAPTIVE_COMPRESSOR_H_
+#define OCEANBASE_COMMON_COMPRESS_OB_ADAPTIVE_COMPRESSOR_H_
+
+#include "ob_compressor.h"
+
+/*
+ * 自适应压缩，每个块单独选择压缩算法，压缩后数据的第一个字节记录算法编号，
+ * 解压缩时据此选择算法，所以表的压缩方法名写成adaptive_1.0即可，读写sstable
+ * 不需要其他改动。
+ *
+ * 每SAMPLE_INTERVAL个块取一个样本，用所有算法压缩并解压缩一遍，在压缩后大小
+ * 不超过最小值max_size_slack_percent的算法中选择解压最快的，之后的块都使用
+ * 该算法，直到下一个样本。不压缩也作为一个候选，它的解压速度最快，压缩率不
+ * 明显或者所有算法解压都低于min_decompress_speed时直接存原始数据。这样热数据
+ * 通常选lz4，重复多的冷数据选zstd。
+ *
+ * 两个门限可以跟在压缩方法名后面按表设置，格式为
+ * adaptive_1.0,<max_size_slack_percent>,<min_decompress_speed>，
+ * 比如冷数据表用adaptive_1.0,0,0只看压缩率；只写adaptive_1.0时用默认值。
+ * 门限只影响压缩，解压缩只看块里的算法编号。
+ *
+ * 压缩有状态，一个实例不能被多个线程同时用于压缩，解压缩没有限制。
+ */
+class ObAdaptiveCompressor : public ObCompressor
+{
+  public:
+    const static char *NAME;
+    enum CodecId
+    {
+      CODEC_NONE = 0,     // 不压缩，不会出现在压缩后的数据中
+      CODEC_LZ4 = 1,
+      CODEC_ZSTD = 2,
+      CODEC_COUNT,
+    };
+    const static int64_t SAMPLE_INTERVAL = 32;
+    const static int64_t DEFAULT_MAX_SIZE_SLACK_PERCENT = 10;
+    // 最低解压速度，单位字节每微秒，即MB/s
+    const static int64_t DEFAULT_MIN_DECOMPRESS_SPEED = 200;
+    const static int64_t MAX_NAME_LENGTH = 64;
+  public:
+    ObAdaptiveCompressor();
+    virtual ~ObAdaptiveCompressor();
+    /*
+     * 名字是adaptive_1.0或者后面带有门限参数时返回true
+     */
+    static bool is_adaptive(const char *compressor_lib_name);
+    /*
+     * 从名字中解析门限参数，加载lz4和zstd，至少一个加载成功才能使用
+     */
+    int init(const char *compressor_lib_name);
+    int compress(const char *src_buffer,
+                 const int64_t src_data_size,
+                 char *dst_buffer,
+                 const int64_t dst_buffer_size,
+                 int64_t &dst_data_size);
+    int decompress(const char *src_buffer,
+                   const int64_t src_data_size,
+                   char *dst_buffer,
+                   const int64_t dst_buffer_size,
+                   int64_t &dst_data_size);
+    /*
+     * 压缩级别和字典只作用于zstd
+     */
+    int set_compress_level(const int64_t compress_level);
+    int set_compress_dict(const char *dict, const int64_t dict_size);
+    const char *get_compressor_name() const;
+    int64_t get_max_overflow_size(const int64_t src_data_size) const;
+
+    int64_t get_block_count(const int64_t codec_id) const
+    {
+      return (0 <= codec_id && CODEC_COUNT > codec_id) ? block_counts_[codec_id] : 0;
+    };
+    int64_t get_max_size_slack_percent() const
+    {
+      return max_size_slack_percent_;
+    };
+    int64_t get_min_decompress_speed() const
+    {
+      return min_decompress_speed_;
+    };
+  private:
+    int parse_param_(const char *compressor_lib_name);
+    int ensure_sample_buffer_(const int64_t src_data_size);
+    void select_codec_(const char *src_buffer, const int64_t src_data_size);
+  private:
+    static const char *CODEC_LIB_NAMES[CODEC_COUNT];
+    ObCompressor *codecs_[CODEC_COUNT];
+    int64_t block_counts_[CODEC_COUNT];
+    int64_t max_size_slack_percent_;
+    int64_t min_decompress_speed_;
+    char name_[MAX_NAME_LENGTH];
+    int64_t compress_count_;
+    int64_t current_codec_;
+    char *sample_buffer_;
+    char *sample_decompress_buffer_;
+    int64_t sample_buffer_size_;
+};
+
+#endif // OCEANBASE_COMMON_COMPRESS_OB_ADAPTIVE_COMPRESSOR_H_
@@ -14,8 +14,11 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <dlfcn.h>
+#include <new>
 #include "ob_compressor.h"
+#include "ob_adaptive_compressor.h"
 
 #define LIB_FNAME_FORMAT_LENGTH 6 // lib.so
 #define MAX_LIB_FNAME_BUFFER_SIZE (MAX_LIB_NAME_LENGTH + LIB_FNAME_FORMAT_LENGTH + 1)
@@ -39,7 +42,19 @@ ObCompressor *create_compressor(const char *compressor_lib_name)
   ObCompressor *ret = NULL;
   void *sohandle = NULL;
   compressor_constructor_t compressor_constructor = NULL;
-  if (NULL != (sohandle = get_lib_handle_(compressor_lib_name)))
+  if (ObAdaptiveCompressor::is_adaptive(compressor_lib_name))
+  {
+    // built in, it loads the codec libraries itself
+    ObAdaptiveCompressor *adaptive = new(std::nothrow) ObAdaptiveCompressor();
+    if (NULL != adaptive && ObCompressor::COM_E_NOERROR != adaptive->init(compressor_lib_name))
+    {
+      fprintf(stderr, "create compressor %s error\n", compressor_lib_name);
+      delete adaptive;
+      adaptive = NULL;
+    }
+    ret = adaptive;
+  }
+  else if (NULL != (sohandle = get_lib_handle_(compressor_lib_name)))
   {
     if (NULL != (compressor_constructor = (compressor_constructor_t)dlsym(sohandle, "create")))
     {
@@ -74,6 +89,11 @@ void destroy_compressor(ObCompressor *compressor)
       }
       dlclose(sohandle);
     }
+    else
+    {
+      // built in compressor
+      delete compressor;
+    }
   }
 }
 
@@ -106,6 +106,20 @@ class ObCompressor
       return COM_E_NOIMPL;
     };
   
+    /*
+     * 设置压缩字典，压缩和解压缩必须使用相同的字典
+     * 不是所有算法都必须提供
+     *
+     * @param [in] dict 字典内容
+     * @param [in] dict_size 字典长度
+     */
+    virtual int set_compress_dict(const char *dict, const int64_t dict_size)
+    {
+      (void)(dict);
+      (void)(dict_size);
+      return COM_E_NOIMPL;
+    };
+
     /*
      * 根据传入的大小计算压缩后最大的可能的溢出大小
      * 不是所有算法都必须提供
@@ -0,0 +1,267 @@
+/**
+ * (C) 2010-2011 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License 
+ * version 2 as published by the Free Software Foundation. 
+ *
+ * zstd_compressor.cpp is for the zstd compress library.
+ *
+ */
+
+#include <new>
+#include <string.h>
+#include "zstd_compressor.h"
+
+const char * ZstdCompressor::NAME = "zstd_1.0";
+
+/*
+ * 压缩和解压缩上下文每个线程一个，同一个实例可以被多个线程同时使用，
+ * 线程退出前不释放
+ */
+static ZSTD_CCtx *get_cctx_()
+{
+  static __thread ZSTD_CCtx *cctx = NULL;
+  if (NULL == cctx)
+  {
+    cctx = ZSTD_createCCtx();
+  }
+  return cctx;
+}
+
+static ZSTD_DCtx *get_dctx_()
+{
+  static __thread ZSTD_DCtx *dctx = NULL;
+  if (NULL == dctx)
+  {
+    dctx = ZSTD_createDCtx();
+  }
+  return dctx;
+}
+
+ZstdCompressor::ZstdCompressor()
+  : level_(static_cast<int>(DEFAULT_COMPRESS_LEVEL)), dict_(NULL), dict_size_(0),
+    cdict_(NULL), ddict_(NULL)
+{
+}
+
+ZstdCompressor::~ZstdCompressor()
+{
+  free_dict_();
+}
+
+int ZstdCompressor::compress(const char *src_buffer,
+                             const int64_t src_data_size,
+                             char *dst_buffer,
+                             const int64_t dst_buffer_size,
+                             int64_t &dst_data_size)
+{
+  int ret = COM_E_NOERROR;
+  size_t size = 0;
+  ZSTD_CCtx *cctx = NULL;
+
+  if (NULL == src_buffer
+      || 0 >= src_data_size
+      || NULL == dst_buffer
+      || 0 >= dst_buffer_size)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else if ((src_data_size + get_max_overflow_size(src_data_size)) > dst_buffer_size)
+  {
+    ret = COM_E_OVERFLOW;
+  }
+  else if (NULL == (cctx = get_cctx_()))
+  {
+    ret = COM_E_INTERNALERROR;
+  }
+  else
+  {
+    if (NULL != cdict_)
+    {
+      size = ZSTD_compress_usingCDict(cctx, dst_buffer, static_cast<size_t>(dst_buffer_size),
+                                      src_buffer, static_cast<size_t>(src_data_size), cdict_);
+    }
+    else
+    {
+      size = ZSTD_compressCCtx(cctx, dst_buffer, static_cast<size_t>(dst_buffer_size),
+                               src_buffer, static_cast<size_t>(src_data_size), level_);
+    }
+    if (ZSTD_isError(size))
+    {
+      ret = COM_E_INTERNALERROR;
+    }
+    else
+    {
+      dst_data_size = static_cast<int64_t>(size);
+    }
+  }
+  return ret;
+}
+
+int ZstdCompressor::decompress(const char *src_buffer,
+                               const int64_t src_data_size,
+                               char *dst_buffer,
+                               const int64_t dst_buffer_size,
+                               int64_t &dst_data_size)
+{
+  int ret = COM_E_NOERROR;
+  unsigned long long content_size = 0;
+  size_t size = 0;
+  ZSTD_DCtx *dctx = NULL;
+
+  if (NULL == src_buffer
+      || 0 >= src_data_size
+      || NULL == dst_buffer
+      || 0 >= dst_buffer_size)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else if (ZSTD_CONTENTSIZE_ERROR == (content_size = ZSTD_getFrameContentSize(
+          src_buffer, static_cast<size_t>(src_data_size))))
+  {
+    ret = COM_E_DATAERROR;
+  }
+  else if (ZSTD_CONTENTSIZE_UNKNOWN != content_size
+           && content_size > static_cast<unsigned long long>(dst_buffer_size))
+  {
+    ret = COM_E_OVERFLOW;
+  }
+  else if (NULL == (dctx = get_dctx_()))
+  {
+    ret = COM_E_INTERNALERROR;
+  }
+  else
+  {
+    if (NULL != ddict_)
+    {
+      size = ZSTD_decompress_usingDDict(dctx, dst_buffer, static_cast<size_t>(dst_buffer_size),
+                                        src_buffer, static_cast<size_t>(src_data_size), ddict_);
+    }
+    else
+    {
+      size = ZSTD_decompressDCtx(dctx, dst_buffer, static_cast<size_t>(dst_buffer_size),
+                                 src_buffer, static_cast<size_t>(src_data_size));
+    }
+    if (ZSTD_isError(size))
+    {
+      ret = COM_E_DATAERROR;
+    }
+    else
+    {
+      dst_data_size = static_cast<int64_t>(size);
+    }
+  }
+  return ret;
+}
+
+int ZstdCompressor::set_compress_level(const int64_t compress_level)
+{
+  int ret = COM_E_NOERROR;
+  int old_level = level_;
+  if (0 >= compress_level || compress_level > ZSTD_maxCLevel())
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else
+  {
+    level_ = static_cast<int>(compress_level);
+    // the level of compress dict is fixed when it's created
+    if (NULL != dict_ && COM_E_NOERROR != (ret = create_cdict_()))
+    {
+      level_ = old_level;
+    }
+  }
+  return ret;
+}
+
+int ZstdCompressor::set_compress_dict(const char *dict, const int64_t dict_size)
+{
+  int ret = COM_E_NOERROR;
+  if (NULL == dict || 0 >= dict_size)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else
+  {
+    free_dict_();
+    if (NULL == (dict_ = new(std::nothrow) char[dict_size]))
+    {
+      ret = COM_E_INTERNALERROR;
+    }
+    else
+    {
+      memcpy(dict_, dict, dict_size);
+      dict_size_ = dict_size;
+      if (NULL == (ddict_ = ZSTD_createDDict(dict_, static_cast<size_t>(dict_size_))))
+      {
+        ret = COM_E_INTERNALERROR;
+      }
+      else
+      {
+        ret = create_cdict_();
+      }
+    }
+    if (COM_E_NOERROR != ret)
+    {
+      free_dict_();
+    }
+  }
+  return ret;
+}
+
+int ZstdCompressor::create_cdict_()
+{
+  int ret = COM_E_NOERROR;
+  ZSTD_CDict *cdict = NULL;
+  if (NULL == (cdict = ZSTD_createCDict(dict_, static_cast<size_t>(dict_size_), level_)))
+  {
+    ret = COM_E_INTERNALERROR;
+  }
+  else
+  {
+    ZSTD_freeCDict(cdict_);
+    cdict_ = cdict;
+  }
+  return ret;
+}
+
+void ZstdCompressor::free_dict_()
+{
+  ZSTD_freeCDict(cdict_);
+  cdict_ = NULL;
+  ZSTD_freeDDict(ddict_);
+  ddict_ = NULL;
+  if (NULL != dict_)
+  {
+    delete[] dict_;
+    dict_ = NULL;
+  }
+  dict_size_ = 0;
+}
+
+const char * ZstdCompressor::get_compressor_name() const
+{
+  return NAME;
+}
+
+int64_t ZstdCompressor::get_max_overflow_size(const int64_t src_data_size) const
+{
+  int64_t size = static_cast<int64_t>(ZSTD_compressBound(static_cast<size_t>(src_data_size)))
+    - src_data_size;
+  return size;
+}
+
+ObCompressor *create()
+{
+  return (new(std::nothrow) ZstdCompressor());
+}
+
+void destroy(ObCompressor *zstd)
+{
+  if (NULL != zstd)
+  {
+    delete zstd;
+    zstd = NULL;
+  }
+}
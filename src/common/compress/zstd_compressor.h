@@ -0,0 +1,57 @@
+/**
+ * (C) 2010-2011 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License 
+ * version 2 as published by the Free Software Foundation. 
+ *
+ * zstd_compressor.h is for the zstd compress library, it gets
+ * much better compress ratio than lzo and snappy, the compress
+ * level and dictionary are supported.
+ *
+ */
+#ifndef OCEANBASE_COMMON_COMPRESS_ZSTD_COMPRESSOR_H_
+#define OCEANBASE_COMMON_COMPRESS_ZSTD_COMPRESSOR_H_
+
+#include <zstd.h>
+#include "ob_compressor.h"
+
+class ZstdCompressor : public ObCompressor
+{
+public:
+  const static char * NAME;
+  const static int64_t DEFAULT_COMPRESS_LEVEL = 3;
+public:
+  ZstdCompressor();
+  virtual ~ZstdCompressor();
+  int compress(const char *src_buffer,
+               const int64_t src_data_size,
+               char *dst_buffer,
+               const int64_t dst_buffer_size,
+               int64_t &dst_data_size);
+  int decompress(const char *src_buffer,
+                 const int64_t src_data_size,
+                 char *dst_buffer,
+                 const int64_t dst_buffer_size,
+                 int64_t &dst_data_size);
+  int set_compress_level(const int64_t compress_level);
+  /*
+   * 字典需在压缩和解压缩之前设置，不能与压缩和解压缩并发调用
+   */
+  int set_compress_dict(const char *dict, const int64_t dict_size);
+  const char * get_compressor_name() const;
+  int64_t get_max_overflow_size(const int64_t src_data_size) const;
+private:
+  void free_dict_();
+  int create_cdict_();
+private:
+  int level_;
+  char *dict_;
+  int64_t dict_size_;
+  ZSTD_CDict *cdict_;
+  ZSTD_DDict *ddict_;
+};
+
+extern "C" ObCompressor *create();
+extern "C" void destroy(ObCompressor *zstd);
+#endif //OCEANBASE_COMMON_COMPRESS_ZSTD_COMPRESSOR_H_ 
@@ -71,6 +71,26 @@ const char *ObStatSingleton::ups_map[] = {
   "commit_log_id",
   "frozen_version",
 
+  "batch_trans_count",
+  "batch_flush_time",
+  "batch_wait_time",
+
+  "row_chain_len_1",
+  "row_chain_len_4",
+  "row_chain_len_16",
+  "row_chain_len_64",
+  "row_chain_len_inf",
+
+  "bloomfilter_check_count",
+  "bloomfilter_skip_count",
+
+  "scan_stream_open_count",
+  "scan_stream_next_count",
+  "scan_stream_prefetch_hit",
+  "dump_row_count",
+  "dump_bytes",
+  "dump_timeu",
+  "dump_throttle_timeu",
 };
 
 const char *ObStatSingleton::cs_map[] = {
@@ -90,6 +110,10 @@ const char *ObStatSingleton::cs_map[] = {
   "memory_used_sstable_row_cache",
   "memory_used_merge_buffer",
   "memory_used_merge_split_buffer",
+  "block_cache_probation_size",
+  "block_cache_probation_hit",
+  "block_cache_protected_hit",
+  "block_cache_promote_count",
   "request_count",
   "request_count_per_second",
   "queue_wait_time",
@@ -160,6 +184,10 @@ const char *ObStatSingleton::sql_map[] = {
   "sql_drop_table_count",
 
   "sql_ps_allocator_count",
+
+  "sql_plan_cache_hit_count",
+  "sql_plan_cache_miss_count",
+  "sql_plan_cache_evict_count",
 };
 
 const char *ObStatSingleton::common_map[] = {
@@ -82,6 +82,28 @@ namespace oceanbase
 
       UPS_STAT_FROZEN_VERSION,
 
+      UPS_STAT_BATCH_TRANS_COUNT,
+      UPS_STAT_BATCH_FLUSH_TIMEU,
+      UPS_STAT_BATCH_WAIT_TIMEU,
+
+      UPS_STAT_ROW_CHAIN_LEN_1,
+      UPS_STAT_ROW_CHAIN_LEN_4,
+      UPS_STAT_ROW_CHAIN_LEN_16,
+      UPS_STAT_ROW_CHAIN_LEN_64,
+      UPS_STAT_ROW_CHAIN_LEN_INF,
+
+      UPS_STAT_BF_CHECK_COUNT,
+      UPS_STAT_BF_SKIP_COUNT,
+
+      UPS_STAT_SCAN_STREAM_OPEN_COUNT,
+      UPS_STAT_SCAN_STREAM_NEXT_COUNT,
+      UPS_STAT_SCAN_STREAM_PREFETCH_HIT,
+
+      UPS_STAT_DUMP_ROW_COUNT,
+      UPS_STAT_DUMP_BYTES,
+      UPS_STAT_DUMP_TIMEU,
+      UPS_STAT_DUMP_THROTTLE_TIMEU,
+
       UPDATESERVER_STAT_MAX,
     };
     /* chunkserver */
@@ -106,6 +128,11 @@ namespace oceanbase
       INDEX_MU_MERGE_BUFFER,
       INDEX_MU_MERGE_SPLIT_BUFFER,
 
+      INDEX_BLOCK_CACHE_PROBATION_SIZE,
+      INDEX_BLOCK_CACHE_PROBATION_HIT,
+      INDEX_BLOCK_CACHE_PROTECTED_HIT,
+      INDEX_BLOCK_CACHE_PROMOTE_COUNT,
+
       INDEX_META_REQUEST_COUNT,
       INDEX_META_REQUEST_COUNT_PER_SECOND,
       INDEX_META_QUEUE_WAIT_TIME,
@@ -206,6 +233,10 @@ namespace oceanbase
 
       SQL_PS_ALLOCATOR_COUNT,
 
+      SQL_PLAN_CACHE_HIT_COUNT,
+      SQL_PLAN_CACHE_MISS_COUNT,
+      SQL_PLAN_CACHE_EVICT_COUNT,
+
       SQL_STAT_MAX,
     };
     /* obmysql */
@@ -397,6 +397,9 @@ namespace oceanbase
 
     const int64_t OB_UPS_START_MAJOR_VERSION = 2;
     const int64_t OB_UPS_START_MINOR_VERSION = 1;
+    // 以此版本号发送OB_NEW_SCAN_REQUEST时, UPS可以保留扫描迭代器,
+    // 后续数据通过OB_SESSION_NEXT_REQUEST续读, 不需要重新定位
+    const int32_t OB_UPS_STREAM_SCAN_VERSION = 2;
 
     const int64_t OB_NEWEST_DATA_VERSION = -2;
 
@@ -460,6 +463,8 @@ namespace oceanbase
     const char* const OB_PARAMETERS_SHOW_TABLE_NAME = "__parameters_show";
     // internal params
     const char* const OB_GROUP_AGG_PUSH_DOWN_PARAM = "ob_group_agg_push_down_param";
+    const char* const OB_HASH_GROUP_BY_PARAM = "ob_hash_group_by_param";
+    const char* const OB_ENABLE_PLAN_CACHE_PARAM = "ob_enable_plan_cache";
     // internal table id
     static const uint64_t OB_FIRST_META_VIRTUAL_TID = OB_INVALID_ID - 1; // not a real table
     static const uint64_t OB_NOT_EXIST_TABLE_TID = 0;
@@ -13,6 +13,7 @@
  */
 
 #include "ob_direct_log_reader.h"
+#include "ob_log_compressor.h"
 
 using namespace oceanbase::common;
 
@@ -87,6 +88,16 @@ int ObDirectLogReader::read_log(LogCommand &cmd, uint64_t &log_seq,
     log_data = log_buffer_.get_data() + log_buffer_.get_position();
     data_len = entry.get_log_data_len();
     log_buffer_.get_position() += data_len;
+    // 压缩的日志解压到线程局部缓冲区, 对调用者透明
+    const char* uncompressed_data = log_data;
+    if (OB_SUCCESS != (ret = uncompress_log_data(entry, uncompressed_data, data_len)))
+    {
+      TBSYS_LOG(ERROR, "uncompress_log_data(seq=%lu, cmd=%d)=>%d", entry.seq_, entry.cmd_, ret);
+    }
+    else
+    {
+      log_data = const_cast<char*>(uncompressed_data);
+    }
   }
 
   if (OB_SUCCESS == ret)
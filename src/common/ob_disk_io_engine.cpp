@@ -0,0 +1,503 @@
+////===================================================================
+ //
+ // ob_disk_io_engine.cpp / common / Oceanbase
+ //
+ // Copyright (C) 2010 Taobao.com, Inc.
+ //
+ // -------------------------------------------------------------------
+ //
+ // Description
+ //
+ //
+ // -------------------------------------------------------------------
+ //
+ // Change Log
+ //
+////====================================================================
+
+#include <new>
+#include "ob_malloc.h"
+#include "utility.h"
+#include "ob_disk_io_engine.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    void ObDiskIOEngine::SyncReadCallback::on_io_complete(const int err, const char *buf, const int64_t size)
+    {
+      if (OB_SUCCESS == err)
+      {
+        memcpy(buf_, buf, size);
+      }
+      cond_.lock();
+      err_ = err;
+      done_ = true;
+      cond_.signal();
+      cond_.unlock();
+    }
+
+    int ObDiskIOEngine::SyncReadCallback::wait()
+    {
+      cond_.lock();
+      while (!done_)
+      {
+        cond_.wait();
+      }
+      cond_.unlock();
+      return err_;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ObDiskIOEngine::ObDiskIOEngine() : inited_(false),
+                                       queue_depth_(DEFAULT_QUEUE_DEPTH)
+    {
+      memset(queues_, 0, sizeof(queues_));
+    }
+
+    ObDiskIOEngine::~ObDiskIOEngine()
+    {
+      destroy();
+    }
+
+    int ObDiskIOEngine::init(const int32_t *disk_no_array, const int32_t disk_num, const int64_t queue_depth)
+    {
+      int ret = OB_SUCCESS;
+      if (inited_)
+      {
+        TBSYS_LOG(WARN, "have already inited");
+        ret = OB_INIT_TWICE;
+      }
+      else if (NULL == disk_no_array
+              || 0 >= disk_num
+              || 0 >= queue_depth
+              || MAX_QUEUE_DEPTH < queue_depth)
+      {
+        TBSYS_LOG(WARN, "invalid param disk_no_array=%p disk_num=%d queue_depth=%ld",
+                  disk_no_array, disk_num, queue_depth);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        queue_depth_ = queue_depth;
+        for (int32_t i = 0; OB_SUCCESS == ret && i < disk_num; i++)
+        {
+          int32_t disk_no = disk_no_array[i];
+          DiskQueue *queue = NULL;
+          int tmp_ret = 0;
+          if (0 > disk_no
+              || MAX_DISK_NUM <= disk_no
+              || NULL != queues_[disk_no])
+          {
+            TBSYS_LOG(WARN, "invalid or duplicate disk_no=%d", disk_no);
+            ret = OB_INVALID_ARGUMENT;
+          }
+          else if (NULL == (queue = new(std::nothrow) DiskQueue()))
+          {
+            TBSYS_LOG(WARN, "new disk queue fail disk_no=%d", disk_no);
+            ret = OB_ALLOCATE_MEMORY_FAILED;
+          }
+          else
+          {
+            queue->host = this;
+            queue->disk_no = disk_no;
+            queue->stop = false;
+            queue->ctx = NULL;
+            queue->pending_num = 0;
+            for (int64_t j = 0; j < DISK_IO_PRIORITY_NUM; j++)
+            {
+              queue->head[j] = NULL;
+              queue->tail[j] = NULL;
+            }
+            queue->free_num = 0;
+            for (int64_t j = 0; j < queue_depth_; j++)
+            {
+              queue->free_ios[queue->free_num++] = &queue->ios[j];
+            }
+            queues_[disk_no] = queue;
+            if (0 != (tmp_ret = io_setup(static_cast<int>(queue_depth_), &queue->ctx)))
+            {
+              TBSYS_LOG(WARN, "io_setup fail disk_no=%d queue_depth=%ld ret=%d", disk_no, queue_depth_, tmp_ret);
+              queue->ctx = NULL;
+              ret = OB_ERROR;
+            }
+            else if (0 != (tmp_ret = pthread_create(&queue->thread, NULL, io_routine_, queue)))
+            {
+              TBSYS_LOG(WARN, "create io thread fail disk_no=%d ret=%d", disk_no, tmp_ret);
+              io_destroy(queue->ctx);
+              queue->ctx = NULL;
+              ret = OB_ERROR;
+            }
+            else
+            {
+              TBSYS_LOG(INFO, "disk io engine start disk_no=%d queue_depth=%ld", disk_no, queue_depth_);
+            }
+          }
+        }
+        inited_ = true;
+        if (OB_SUCCESS != ret)
+        {
+          destroy();
+        }
+      }
+      return ret;
+    }
+
+    void ObDiskIOEngine::destroy()
+    {
+      for (int64_t i = 0; i < MAX_DISK_NUM; i++)
+      {
+        DiskQueue *queue = queues_[i];
+        if (NULL != queue)
+        {
+          if (NULL != queue->ctx)
+          {
+            queue->cond.lock();
+            queue->stop = true;
+            queue->cond.signal();
+            queue->cond.unlock();
+            pthread_join(queue->thread, NULL);
+            io_destroy(queue->ctx);
+            queue->ctx = NULL;
+          }
+          cancel_requests_(*queue);
+          delete queue;
+          queues_[i] = NULL;
+        }
+      }
+      inited_ = false;
+    }
+
+    bool ObDiskIOEngine::has_disk(const int32_t disk_no) const
+    {
+      return (inited_
+              && 0 <= disk_no
+              && MAX_DISK_NUM > disk_no
+              && NULL != queues_[disk_no]);
+    }
+
+    int ObDiskIOEngine::submit(const int32_t disk_no, ObDiskIORequest &request)
+    {
+      int ret = OB_SUCCESS;
+      DiskQueue *queue = NULL;
+      if (!inited_)
+      {
+        ret = OB_NOT_INIT;
+      }
+      else if (!has_disk(disk_no))
+      {
+        TBSYS_LOG(WARN, "disk_no=%d not in disk io engine", disk_no);
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else if (0 > request.fd
+              || 0 > request.offset
+              || 0 >= request.size
+              || 0 > request.priority
+              || DISK_IO_PRIORITY_NUM <= request.priority
+              || NULL == request.callback)
+      {
+        TBSYS_LOG(WARN, "invalid request fd=%d offset=%ld size=%ld priority=%d callback=%p",
+                  request.fd, request.offset, request.size, request.priority, request.callback);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        queue = queues_[disk_no];
+        request.next = NULL;
+        queue->cond.lock();
+        if (queue->stop)
+        {
+          ret = OB_CANCELED;
+        }
+        else
+        {
+          if (NULL == queue->tail[request.priority])
+          {
+            queue->head[request.priority] = &request;
+          }
+          else
+          {
+            queue->tail[request.priority]->next = &request;
+          }
+          queue->tail[request.priority] = &request;
+          queue->pending_num++;
+          queue->cond.signal();
+        }
+        queue->cond.unlock();
+      }
+      return ret;
+    }
+
+    int ObDiskIOEngine::read(const int32_t disk_no, const int fd, const int64_t offset, const int64_t size,
+                            char *buf, const int priority)
+    {
+      int ret = OB_SUCCESS;
+      SyncReadCallback callback(buf);
+      ObDiskIORequest request;
+      request.fd = fd;
+      request.offset = offset;
+      request.size = size;
+      request.priority = priority;
+      request.callback = &callback;
+      if (NULL == buf)
+      {
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS == (ret = submit(disk_no, request)))
+      {
+        ret = callback.wait();
+      }
+      return ret;
+    }
+
+    void *ObDiskIOEngine::io_routine_(void *arg)
+    {
+      DiskQueue *queue = static_cast<DiskQueue*>(arg);
+      if (NULL != queue
+          && NULL != queue->host)
+      {
+        queue->host->run_queue_(*queue);
+      }
+      return NULL;
+    }
+
+    ObDiskIORequest *ObDiskIOEngine::pop_request_(DiskQueue &queue)
+    {
+      ObDiskIORequest *ret = NULL;
+      for (int64_t i = 0; NULL == ret && i < DISK_IO_PRIORITY_NUM; i++)
+      {
+        if (NULL != (ret = queue.head[i]))
+        {
+          queue.head[i] = ret->next;
+          if (NULL == queue.head[i])
+          {
+            queue.tail[i] = NULL;
+          }
+          ret->next = NULL;
+          queue.pending_num--;
+        }
+      }
+      return ret;
+    }
+
+    void ObDiskIOEngine::merge_requests_(DiskQueue &queue, InflightIO &io)
+    {
+      // 把同一文件上与当前io相邻或重叠的请求并进来, 不论优先级
+      int fd = io.reqs[0]->fd;
+      bool merged = true;
+      while (merged
+            && MAX_MERGE_REQUEST_NUM > io.req_num)
+      {
+        merged = false;
+        for (int64_t i = 0; !merged && i < DISK_IO_PRIORITY_NUM; i++)
+        {
+          ObDiskIORequest *prev = NULL;
+          ObDiskIORequest *cur = queue.head[i];
+          while (NULL != cur)
+          {
+            int64_t start = (cur->offset < io.offset) ? cur->offset : io.offset;
+            int64_t end = (cur->offset + cur->size > io.offset + io.size) ? cur->offset + cur->size : io.offset + io.size;
+            if (fd == cur->fd
+                && cur->offset <= io.offset + io.size
+                && cur->offset + cur->size >= io.offset
+                && MAX_MERGE_IO_SIZE >= end - start)
+            {
+              if (NULL == prev)
+              {
+                queue.head[i] = cur->next;
+              }
+              else
+              {
+                prev->next = cur->next;
+              }
+              if (queue.tail[i] == cur)
+              {
+                queue.tail[i] = prev;
+              }
+              cur->next = NULL;
+              queue.pending_num--;
+              io.reqs[io.req_num++] = cur;
+              io.offset = start;
+              io.size = end - start;
+              merged = true;
+              break;
+            }
+            prev = cur;
+            cur = cur->next;
+          }
+        }
+      }
+    }
+
+    int ObDiskIOEngine::prepare_io_(InflightIO &io)
+    {
+      int ret = OB_SUCCESS;
+      // 按IO_ALIGN_SIZE对齐, 这样打开时带O_DIRECT的文件也可以读
+      int64_t aligned_offset = io.offset & ~(IO_ALIGN_SIZE - 1);
+      int64_t aligned_size = upper_align(io.offset + io.size, IO_ALIGN_SIZE) - aligned_offset;
+      io.alloc_buf = NULL;
+      io.buf = NULL;
+      if (NULL == (io.alloc_buf = (char*)ob_malloc(aligned_size + IO_ALIGN_SIZE, ObModIds::OB_SSTABLE_AIO)))
+      {
+        TBSYS_LOG(WARN, "alloc io buffer fail size=%ld", aligned_size + IO_ALIGN_SIZE);
+        ret = OB_ALLOCATE_MEMORY_FAILED;
+      }
+      else
+      {
+        io.buf = (char*)upper_align((int64_t)io.alloc_buf, IO_ALIGN_SIZE);
+        io.offset = aligned_offset;
+        io.size = aligned_size;
+        io_prep_pread(&io.cb, io.reqs[0]->fd, io.buf, io.size, io.offset);
+        io.cb.data = &io;
+      }
+      return ret;
+    }
+
+    void ObDiskIOEngine::complete_io_(InflightIO &io, const int64_t res)
+    {
+      for (int64_t i = 0; i < io.req_num; i++)
+      {
+        ObDiskIORequest *req = io.reqs[i];
+        int err = OB_SUCCESS;
+        if (0 > res)
+        {
+          TBSYS_LOG(WARN, "aio read fail fd=%d offset=%ld size=%ld res=%ld",
+                    req->fd, io.offset, io.size, res);
+          err = OB_IO_ERROR;
+        }
+        else if (NULL == io.buf
+                || req->offset + req->size > io.offset + res)
+        {
+          TBSYS_LOG(WARN, "aio read not enough fd=%d offset=%ld size=%ld res=%ld req_offset=%ld req_size=%ld",
+                    req->fd, io.offset, io.size, res, req->offset, req->size);
+          err = OB_IO_ERROR;
+        }
+        // 回调之后request可能已经被释放
+        req->callback->on_io_complete(err, (OB_SUCCESS == err) ? io.buf + (req->offset - io.offset) : NULL, req->size);
+        io.reqs[i] = NULL;
+      }
+      io.req_num = 0;
+      if (NULL != io.alloc_buf)
+      {
+        ob_free(io.alloc_buf);
+        io.alloc_buf = NULL;
+        io.buf = NULL;
+      }
+    }
+
+    void ObDiskIOEngine::cancel_requests_(DiskQueue &queue)
+    {
+      ObDiskIORequest *req = NULL;
+      queue.cond.lock();
+      while (NULL != (req = pop_request_(queue)))
+      {
+        req->callback->on_io_complete(OB_CANCELED, NULL, req->size);
+      }
+      queue.cond.unlock();
+    }
+
+    void ObDiskIOEngine::run_queue_(DiskQueue &queue)
+    {
+      struct iocb *iocbs[MAX_QUEUE_DEPTH];
+      struct io_event events[MAX_QUEUE_DEPTH];
+      InflightIO *ios[MAX_QUEUE_DEPTH];
+      struct timespec timeout;
+      int64_t inflight_num = 0;
+      while (!queue.stop)
+      {
+        int64_t io_num = 0;
+        int64_t submit_num = 0;
+        queue.cond.lock();
+        while (!queue.stop
+              && 0 == queue.pending_num
+              && 0 == inflight_num)
+        {
+          queue.cond.wait(static_cast<int>(IO_WAIT_TIMEOUT_US / 1000));
+        }
+        while (0 < queue.pending_num
+              && 0 < queue.free_num)
+        {
+          InflightIO *io = queue.free_ios[--queue.free_num];
+          io->req_num = 0;
+          io->alloc_buf = NULL;
+          io->buf = NULL;
+          io->reqs[io->req_num++] = pop_request_(queue);
+          io->offset = io->reqs[0]->offset;
+          io->size = io->reqs[0]->size;
+          merge_requests_(queue, *io);
+          ios[io_num++] = io;
+        }
+        queue.cond.unlock();
+
+        for (int64_t i = 0; i < io_num; i++)
+        {
+          if (OB_SUCCESS != prepare_io_(*ios[i]))
+          {
+            complete_io_(*ios[i], -ENOMEM);
+            queue.cond.lock();
+            queue.free_ios[queue.free_num++] = ios[i];
+            queue.cond.unlock();
+          }
+          else
+          {
+            iocbs[submit_num] = &ios[i]->cb;
+            ios[submit_num++] = ios[i];
+          }
+        }
+
+        if (0 < submit_num)
+        {
+          int tmp_ret = io_submit(queue.ctx, submit_num, iocbs);
+          int64_t submitted = (0 > tmp_ret) ? 0 : tmp_ret;
+          if (submitted < submit_num)
+          {
+            TBSYS_LOG(WARN, "io_submit fail disk_no=%d submit_num=%ld ret=%d",
+                      queue.disk_no, submit_num, tmp_ret);
+          }
+          for (int64_t i = submitted; i < submit_num; i++)
+          {
+            complete_io_(*ios[i], (0 > tmp_ret) ? tmp_ret : -EAGAIN);
+            queue.cond.lock();
+            queue.free_ios[queue.free_num++] = ios[i];
+            queue.cond.unlock();
+          }
+          inflight_num += submitted;
+        }
+
+        if (0 < inflight_num)
+        {
+          timeout.tv_sec = IO_WAIT_TIMEOUT_US / 1000000;
+          timeout.tv_nsec = IO_WAIT_TIMEOUT_US % 1000000 * 1000;
+          int event_num = io_getevents(queue.ctx, 1, inflight_num, events, &timeout);
+          for (int i = 0; i < event_num; i++)
+          {
+            InflightIO *io = static_cast<InflightIO*>(events[i].data);
+            complete_io_(*io, static_cast<int64_t>(events[i].res));
+            queue.cond.lock();
+            queue.free_ios[queue.free_num++] = io;
+            queue.cond.unlock();
+          }
+          if (0 < event_num)
+          {
+            inflight_num -= event_num;
+          }
+        }
+      }
+      // 退出前等已经提交的io都完成
+      while (0 < inflight_num)
+      {
+        int event_num = io_getevents(queue.ctx, 1, inflight_num, events, NULL);
+        for (int i = 0; i < event_num; i++)
+        {
+          complete_io_(*static_cast<InflightIO*>(events[i].data), static_cast<int64_t>(events[i].res));
+        }
+        if (0 >= event_num)
+        {
+          break;
+        }
+        inflight_num -= event_num;
+      }
+    }
+  }
+}
@@ -0,0 +1,143 @@
+////===================================================================
+ //
+ // ob_disk_io_engine.h / common / Oceanbase
+ //
+ // Copyright (C) 2010 Taobao.com, Inc.
+ //
+ // -------------------------------------------------------------------
+ //
+ // Description
+ //
+ // 按磁盘划分的异步读引擎
+ // 每块盘一个libaio的io_context和一个提交线程, 读请求按优先级(get > scan > merge)
+ // 排队, 提交线程每次从高优先级队列取请求, 并把同一文件上相邻或重叠的请求合并成
+ // 一个io, 保持每块盘有queue_depth个io在飞, 完成后在提交线程里逐个回调
+ // 同步读也通过同一个队列, 这样多个线程的随机点读可以同时压到盘上, 不再是每个线程
+ // 一次阻塞的pread
+ //
+ // -------------------------------------------------------------------
+ //
+ // Change Log
+ //
+////====================================================================
+
+#ifndef  OCEANBASE_COMMON_DISK_IO_ENGINE_H_
+#define  OCEANBASE_COMMON_DISK_IO_ENGINE_H_
+#include <pthread.h>
+#include <libaio.h>
+#include "tbsys.h"
+#include "ob_define.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    enum ObDiskIOPriority
+    {
+      DISK_IO_PRIORITY_GET = 0,
+      DISK_IO_PRIORITY_SCAN = 1,
+      DISK_IO_PRIORITY_MERGE = 2,
+      DISK_IO_PRIORITY_NUM = 3,
+    };
+
+    class ObDiskIOCallback
+    {
+      public:
+        virtual ~ObDiskIOCallback() {};
+      public:
+        // 在io线程中调用, buf只在回调期间有效, 回调之后引擎不再访问对应的request
+        virtual void on_io_complete(const int err, const char *buf, const int64_t size) = 0;
+    };
+
+    struct ObDiskIORequest
+    {
+      ObDiskIORequest() : fd(-1), offset(0), size(0), priority(DISK_IO_PRIORITY_GET),
+                          callback(NULL), next(NULL)
+      {
+      };
+      int fd;
+      int64_t offset;
+      int64_t size;
+      int priority;
+      ObDiskIOCallback *callback;
+      ObDiskIORequest *next;
+    };
+
+    class ObDiskIOEngine
+    {
+      public:
+        static const int64_t MAX_DISK_NUM = OB_MAX_DISK_NUMBER + 1;
+        static const int64_t MAX_QUEUE_DEPTH = 128;
+        static const int64_t DEFAULT_QUEUE_DEPTH = 32;
+        static const int64_t MAX_MERGE_REQUEST_NUM = 16;
+        static const int64_t MAX_MERGE_IO_SIZE = 1024L * 1024L;
+        static const int64_t IO_ALIGN_SIZE = 4096;
+        static const int64_t IO_WAIT_TIMEOUT_US = 10000;
+      private:
+        struct InflightIO
+        {
+          struct iocb cb;
+          char *alloc_buf;
+          char *buf;
+          int64_t offset;
+          int64_t size;
+          int64_t req_num;
+          ObDiskIORequest *reqs[MAX_MERGE_REQUEST_NUM];
+        };
+        struct DiskQueue
+        {
+          ObDiskIOEngine *host;
+          int32_t disk_no;
+          volatile bool stop;
+          io_context_t ctx;
+          pthread_t thread;
+          tbsys::CThreadCond cond;
+          ObDiskIORequest *head[DISK_IO_PRIORITY_NUM];
+          ObDiskIORequest *tail[DISK_IO_PRIORITY_NUM];
+          int64_t pending_num;
+          int64_t free_num;
+          InflightIO *free_ios[MAX_QUEUE_DEPTH];
+          InflightIO ios[MAX_QUEUE_DEPTH];
+        };
+        class SyncReadCallback : public ObDiskIOCallback
+        {
+          public:
+            SyncReadCallback(char *buf) : buf_(buf), done_(false), err_(OB_SUCCESS) {};
+            virtual void on_io_complete(const int err, const char *buf, const int64_t size);
+            int wait();
+          private:
+            char *buf_;
+            bool done_;
+            int err_;
+            tbsys::CThreadCond cond_;
+        };
+      public:
+        ObDiskIOEngine();
+        ~ObDiskIOEngine();
+      public:
+        int init(const int32_t *disk_no_array, const int32_t disk_num, const int64_t queue_depth);
+        void destroy();
+        bool is_inited() const {return inited_;};
+        bool has_disk(const int32_t disk_no) const;
+        // 异步提交, 完成后在disk_no对应的io线程中回调, request在回调之前必须有效
+        int submit(const int32_t disk_no, ObDiskIORequest &request);
+        // 同步读, 数据拷贝到buf
+        int read(const int32_t disk_no, const int fd, const int64_t offset, const int64_t size,
+                char *buf, const int priority);
+      private:
+        static void *io_routine_(void *arg);
+        void run_queue_(DiskQueue &queue);
+        ObDiskIORequest *pop_request_(DiskQueue &queue);
+        void merge_requests_(DiskQueue &queue, InflightIO &io);
+        int prepare_io_(InflightIO &io);
+        void complete_io_(InflightIO &io, const int64_t res);
+        void cancel_requests_(DiskQueue &queue);
+      private:
+        bool inited_;
+        int64_t queue_depth_;
+        DiskQueue *queues_[MAX_DISK_NUM];
+    };
+  }
+}
+
+#endif //OCEANBASE_COMMON_DISK_IO_ENGINE_H_
@@ -0,0 +1,173 @@
+/**
+ * (C) 2010-2012 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_epoch_manager.cpp for epoch based reclamation of read mostly
+ * structures.
+ *
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "ob_epoch_manager.h"
+#include "tblog.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    // slot index is shared by all the managers, slots of exited threads
+    // are given to new threads so that only MAX_THREAD_NUM concurrently
+    // living threads fall into the overflow counter.
+    static volatile int64_t epoch_thread_seq = 0; // high water of used slots
+    static volatile int8_t epoch_slot_used[ObEpochManager::MAX_THREAD_NUM];
+    static pthread_key_t epoch_slot_key;
+    static pthread_once_t epoch_slot_key_once = PTHREAD_ONCE_INIT;
+    static int epoch_slot_key_err = 0;
+
+    static void free_epoch_slot(void* ptr)
+    {
+      // slot idx + 1 is stored to keep the value non NULL.
+      int64_t idx = reinterpret_cast<int64_t>(ptr) - 1;
+      if (idx >= 0 && idx < ObEpochManager::MAX_THREAD_NUM)
+      {
+        __sync_synchronize();
+        epoch_slot_used[idx] = 0;
+      }
+    }
+
+    static void create_epoch_slot_key()
+    {
+      if (0 != (epoch_slot_key_err = pthread_key_create(&epoch_slot_key, free_epoch_slot)))
+      {
+        TBSYS_LOG(ERROR, "pthread_key_create fail, err=%d", epoch_slot_key_err);
+      }
+    }
+
+    static int64_t alloc_epoch_slot()
+    {
+      int64_t idx = ObEpochManager::MAX_THREAD_NUM;
+      int64_t seq = 0;
+      pthread_once(&epoch_slot_key_once, create_epoch_slot_key);
+      if (0 == epoch_slot_key_err)
+      {
+        for (int64_t i = 0; i < ObEpochManager::MAX_THREAD_NUM; ++i)
+        {
+          if (0 == epoch_slot_used[i]
+              && __sync_bool_compare_and_swap(&epoch_slot_used[i], 0, 1))
+          {
+            idx = i;
+            break;
+          }
+        }
+      }
+      if (idx < ObEpochManager::MAX_THREAD_NUM)
+      {
+        while ((seq = epoch_thread_seq) <= idx
+            && !__sync_bool_compare_and_swap(&epoch_thread_seq, seq, idx + 1))
+        {
+          // retry
+        }
+        if (0 != pthread_setspecific(epoch_slot_key, reinterpret_cast<void*>(idx + 1)))
+        {
+          // never freed, the slot is lost but still valid.
+          TBSYS_LOG(WARN, "pthread_setspecific fail, epoch slot=%ld", idx);
+        }
+      }
+      return idx;
+    }
+
+    ObEpochManager::ObEpochManager()
+      : epoch_(1), overflow_ref_(0)
+    {
+      memset(slots_, 0, sizeof(slots_));
+    }
+
+    ObEpochManager::~ObEpochManager()
+    {
+    }
+
+    int64_t ObEpochManager::get_thread_idx()
+    {
+      static __thread int64_t thread_idx = -1;
+      if (0 > thread_idx)
+      {
+        thread_idx = alloc_epoch_slot();
+      }
+      return thread_idx;
+    }
+
+    void ObEpochManager::enter()
+    {
+      int64_t idx = get_thread_idx();
+      if (idx >= MAX_THREAD_NUM)
+      {
+        __sync_add_and_fetch(&overflow_ref_, 1);
+      }
+      else if (0 == slots_[idx].depth_++)
+      {
+        slots_[idx].epoch_ = epoch_;
+        // the slot must be visible before the reader loads the
+        // protected pointer.
+        __sync_synchronize();
+      }
+    }
+
+    void ObEpochManager::leave()
+    {
+      int64_t idx = get_thread_idx();
+      if (idx >= MAX_THREAD_NUM)
+      {
+        __sync_sub_and_fetch(&overflow_ref_, 1);
+      }
+      else if (0 == --slots_[idx].depth_)
+      {
+        __sync_synchronize();
+        slots_[idx].epoch_ = 0;
+      }
+    }
+
+    void ObEpochManager::synchronize()
+    {
+      int64_t thread_num = epoch_thread_seq;
+      int64_t epoch = 0;
+      int64_t slot_epoch = 0;
+      int64_t spin_count = 0;
+
+      __sync_synchronize();
+      epoch = __sync_add_and_fetch(&epoch_, 1);
+      if (thread_num > MAX_THREAD_NUM)
+      {
+        thread_num = MAX_THREAD_NUM;
+      }
+
+      for (int64_t i = 0; i < thread_num; ++i)
+      {
+        spin_count = 0;
+        while (0 != (slot_epoch = slots_[i].epoch_) && slot_epoch < epoch)
+        {
+          if (++spin_count < 1024)
+          {
+            PAUSE();
+          }
+          else
+          {
+            sched_yield();
+          }
+        }
+      }
+
+      // overflow readers can't be told apart, wait until all of them leave.
+      while (0 < overflow_ref_)
+      {
+        sched_yield();
+      }
+      __sync_synchronize();
+    }
+  } // end namespace common
+} // end namespace oceanbase
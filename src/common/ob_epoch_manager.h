@@ -0,0 +1,92 @@
+/**
+ * (C) 2010-2012 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_epoch_manager.h for epoch based reclamation of read mostly
+ * structures.
+ *
+ */
+#ifndef __OB_COMMON_OB_EPOCH_MANAGER_H__
+#define __OB_COMMON_OB_EPOCH_MANAGER_H__
+
+#include <stdint.h>
+#include "ob_define.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    /**
+     * readers wrap their access to a shared pointer with enter() and
+     * leave(), writers swap the pointer, call synchronize() and then
+     * free the old object. synchronize() returns after every reader
+     * that might have seen the old pointer has left.
+     *
+     * enter() only writes the calling thread's own cache line, so
+     * readers never contend with each other. each thread owns a slot
+     * for its life time and the slot is reused after the thread exits,
+     * threads beyond MAX_THREAD_NUM alive at the same time share one
+     * atomic counter.
+     */
+    class ObEpochManager
+    {
+      public:
+        static const int64_t MAX_THREAD_NUM = 1024;
+
+        class Guard
+        {
+          public:
+            explicit Guard(ObEpochManager& manager) : manager_(manager)
+            {
+              manager_.enter();
+            }
+            ~Guard()
+            {
+              manager_.leave();
+            }
+          private:
+            DISALLOW_COPY_AND_ASSIGN(Guard);
+            ObEpochManager& manager_;
+        };
+
+      public:
+        ObEpochManager();
+        ~ObEpochManager();
+
+        // nested enter is allowed in the same thread.
+        void enter();
+        void leave();
+
+        /**
+         * wait until all readers entered before this call leave,
+         * must not be called between enter() and leave().
+         */
+        void synchronize();
+
+        inline int64_t get_epoch() const { return epoch_; }
+
+        /// slot of the calling thread, MAX_THREAD_NUM if it shares the overflow counter
+        static int64_t get_thread_idx();
+
+      private:
+        struct Slot
+        {
+          volatile int64_t epoch_;
+          int64_t depth_;
+        } CACHE_ALIGNED;
+
+        DISALLOW_COPY_AND_ASSIGN(ObEpochManager);
+
+        volatile int64_t epoch_ CACHE_ALIGNED;
+        volatile int64_t overflow_ref_ CACHE_ALIGNED;
+        Slot slots_[MAX_THREAD_NUM];
+    };
+  } // end namespace common
+} // end namespace oceanbase
+
+#endif //__OB_COMMON_OB_EPOCH_MANAGER_H__
@@ -30,6 +30,7 @@
 #include "ob_strings.h"
 #include "ob_mutator.h"
 #include "ob_ups_info.h"
+#include "ob_row_modify_slots.h"
 #include "location/ob_tablet_location_list.h"
 #include "sql/ob_ups_result.h"
 #include "sql/ob_physical_plan.h"
@@ -110,6 +111,14 @@ namespace oceanbase
           DEFAULT_VERSION, frozen_version, frozen_time);
     }
 
+    int ObGeneralRpcStub::fetch_row_modify_slots(
+        const int64_t timeout, const ObServer & update_server,
+        const int64_t last_trans_id, ObRowModifySlots & slots) const
+    {
+      return send_1_return_1(update_server, timeout, OB_UPS_GET_ROW_MODIFY_SLOTS,
+          DEFAULT_VERSION, last_trans_id, slots);
+    }
+
     // fetch schema current version
     int ObGeneralRpcStub::fetch_schema_version(
         const int64_t timeout, const common::ObServer & root_server,
@@ -42,6 +42,7 @@ namespace oceanbase
     class ThreadSpecificBuffer;
     class TableSchema;
     class ObUpsList;
+    class ObRowModifySlots;
     class ObStrings;
     class ObTabletReportInfoList;
     class ObTabletLocation;
@@ -118,6 +119,13 @@ namespace oceanbase
         int fetch_frozen_time(const int64_t timeout, common::ObServer & update_server,
             const int64_t frozen_version, int64_t& frozen_time) const;
 
+        // fetch the row modify slots modified after last_trans_id
+        //        @update_server master update server
+        //        @last_trans_id commited trans id of last fetch
+        //        @slots modified slots and current commited trans id
+        int fetch_row_modify_slots(const int64_t timeout, const common::ObServer & update_server,
+            const int64_t last_trans_id, common::ObRowModifySlots & slots) const;
+
         // get tables schema info through root server rpc call
         // param  @timeout  action timeout
         //        @root_server root server addr
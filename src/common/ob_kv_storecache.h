@@ -21,6 +21,12 @@
  * 需要使用 KVStoreCacheComponent::MultiObjFreeList 作为内存分配器
  * 否则可以使用默认的 KVStoreCacheComponent::SingleObjFreeList 作为内存分配器
  *
+ * 淘汰策略可以通过set_replace_policy选择
+ * LRU_POLICY 按memblock最近访问时间淘汰
+ * TWO_Q_POLICY 带probation标记写入的对象(如scan和合并读入的block)单独存放在
+ * probation memblock中, 被非probation的访问命中后提升为protected, probation
+ * memblock超过总量的probation_percent时优先淘汰, 避免大scan冲掉点查的热数据
+ *
  * Authors:
  *   yubai <yubai.lk@taobao.com>
  *   huating <huating.zmq@taobao.com>
@@ -192,6 +198,14 @@ namespace oceanbase
 
       ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+      enum ReplacePolicy
+      {
+        LRU_POLICY = 0,
+        TWO_Q_POLICY = 1,
+      };
+
+      ////////////////////////////////////////////////////////////////////////////////////////////////////
+
       class StoreHandle
       {
         enum
@@ -977,26 +991,38 @@ namespace oceanbase
       static const int64_t MEM_BLOCK_SIZE = MemBlock::MEM_BLOCK_SIZE;
       static const int64_t MAX_WASH_OUT_SIZE = 10 * MEM_BLOCK_SIZE;
       static const int64_t MAX_MEMBLOCK_INFO_COUNT = 128 * 1024; //128K
+      static const int64_t DEFAULT_PROBATION_PERCENT = 25;
       typedef FreeList<MemBlock> MemBlockFreeList;
       struct MemBlockInfo
       {
         int64_t get_cnt;
         int64_t last_time;
         MemBlock * volatile mem_block;
+        volatile uint64_t probation;
       };
       class CmpFunc
       {
         public:
-          CmpFunc(MemBlockInfo *mb_infos) : mb_infos_(mb_infos)
+          CmpFunc(MemBlockInfo *mb_infos, const bool probation_first)
+            : mb_infos_(mb_infos), probation_first_(probation_first)
           {
           };
           bool operator() (int64_t a, int64_t b) const
           {
             bool bret = false;
-            if (0 <= a && 0 <= b
-                && 0 != mb_infos_[a].last_time
-                && (0 == mb_infos_[b].last_time
-                    || mb_infos_[a].last_time <= mb_infos_[b].last_time))
+            if (0 > a || 0 > b)
+            {
+              bret = false;
+            }
+            else if (probation_first_
+                    && mb_infos_[a].probation != mb_infos_[b].probation)
+            {
+              // probation memblock 先淘汰
+              bret = (0 != mb_infos_[a].probation);
+            }
+            else if (0 != mb_infos_[a].last_time
+                    && (0 == mb_infos_[b].last_time
+                        || mb_infos_[a].last_time <= mb_infos_[b].last_time))
             {
               bret = true;
             }
@@ -1004,12 +1030,16 @@ namespace oceanbase
           };
         private:
           MemBlockInfo *mb_infos_;
+          bool probation_first_;
       };
       public:
         KVStoreCache() : inited_(false), adapter_(NULL), free_list_(), avg_get_cnt_(0),
                          max_mb_num_(MAX_MEMBLOCK_INFO_COUNT),total_mb_num_(0), mb_infos_(NULL),
                          not_revert_cnt_(0), cache_miss_cnt_(0), cache_hit_cnt_(0),
-                         cur_memblock_(NULL)
+                         policy_(KVStoreCacheComponent::LRU_POLICY),
+                         probation_percent_(DEFAULT_PROBATION_PERCENT), probation_mb_num_(0),
+                         probation_hit_cnt_(0), protected_hit_cnt_(0), promote_cnt_(0),
+                         cur_memblock_(NULL), cur_probation_memblock_(NULL)
         {
         };
         ~KVStoreCache()
@@ -1119,6 +1149,12 @@ namespace oceanbase
               free_list_.free(cur_memblock_);
               cur_memblock_ = NULL;
             }
+            if (NULL != cur_probation_memblock_)
+            {
+              free_list_.free(cur_probation_memblock_);
+              cur_probation_memblock_ = NULL;
+            }
+            probation_mb_num_ = 0;
             inited_ = false;
             free_list_.clear();
             free_list_.set_max_alloc_size(INT64_MAX);
@@ -1148,11 +1184,17 @@ namespace oceanbase
                 }
               }
               memset(mb_infos_, 0, sizeof(MemBlockInfo) * total_mb_num_);
+              probation_mb_num_ = 0;
               if (NULL != cur_memblock_)
               {
                 free_list_.free(cur_memblock_);
                 cur_memblock_ = NULL;
               }
+              if (NULL != cur_probation_memblock_)
+              {
+                free_list_.free(cur_probation_memblock_);
+                cur_probation_memblock_ = NULL;
+              }
             }
           }
           return ret;
@@ -1161,14 +1203,38 @@ namespace oceanbase
         {
           adapter_ = adapter;
         };
+        int set_replace_policy(const KVStoreCacheComponent::ReplacePolicy policy,
+                               const int64_t probation_percent)
+        {
+          int ret = OB_SUCCESS;
+          if ((KVStoreCacheComponent::LRU_POLICY != policy
+                && KVStoreCacheComponent::TWO_Q_POLICY != policy)
+              || 0 >= probation_percent
+              || 100 <= probation_percent)
+          {
+            TBSYS_LOG(WARN, "invalid param policy=%d probation_percent=%ld", policy, probation_percent);
+            ret = OB_INVALID_ARGUMENT;
+          }
+          else
+          {
+            policy_ = policy;
+            probation_percent_ = probation_percent;
+          }
+          return ret;
+        };
       public:
+        /**
+         * probation为true表示对象来自scan或合并等一次性的读, 在TWO_Q_POLICY下
+         * 存放到probation memblock中
+         */
         int store(const Key &key, const Value &value, StoreHandle &handle,
-                  Key **ppkey = NULL, Value **ppvalue = NULL)
+                  Key **ppkey = NULL, Value **ppvalue = NULL, const bool probation = false)
         {
           int ret = OB_SUCCESS;
           MemBlock *memblock = NULL;
           int32_t seq_num = 0;
           int64_t align_kv_size = MemBlock::get_align_size(key, value);
+          const bool to_probation = (probation && KVStoreCacheComponent::TWO_Q_POLICY == policy_);
           if (!inited_)
           {
             ret = OB_NOT_INIT;
@@ -1178,7 +1244,7 @@ namespace oceanbase
           {
             ret = OB_INVALID_ARGUMENT;
           }
-          else if (NULL == (memblock = get_cur_memblock_(seq_num, align_kv_size)))
+          else if (NULL == (memblock = get_cur_memblock_(seq_num, align_kv_size, to_probation)))
           {
             ret = OB_BUF_NOT_ENOUGH;
           }
@@ -1218,14 +1284,14 @@ namespace oceanbase
                    * function get_cur_memblock_() can ensure big memblock is
                    * thread local.
                    */
-                  submit_memblock_(memblock);
+                  submit_memblock_(memblock, to_probation);
                 }
                 break;
               }
               else if (OB_BUF_NOT_ENOUGH == ret)
               {
-                submit_cur_memblock_(memblock);
-                if (NULL == (memblock = get_cur_memblock_(seq_num, align_kv_size)))
+                submit_cur_memblock_(memblock, to_probation);
+                if (NULL == (memblock = get_cur_memblock_(seq_num, align_kv_size, to_probation)))
                 {
                   break;
                 }
@@ -1308,6 +1374,18 @@ namespace oceanbase
                       tmp_mem_block = cur_memblock_;
                       TBSYS_LOG(DEBUG, "start scan cur_memblock");
                     }
+                    else if (handle.mb_infos_pos == total_mb_num_)
+                    {
+                      // cur_memblock_为空, 跳到cur_probation_memblock_
+                      handle.mb_infos_pos += 1;
+                      continue;
+                    }
+                    else if (handle.mb_infos_pos == total_mb_num_ + 1
+                            && NULL != cur_probation_memblock_)
+                    {
+                      tmp_mem_block = cur_probation_memblock_;
+                      TBSYS_LOG(DEBUG, "start scan cur_probation_memblock");
+                    }
                     else
                     {
                       ret = OB_ITER_END;
@@ -1370,7 +1448,22 @@ namespace oceanbase
           revert(handle);
           handle.mb_infos_pos = 0;
         };
-        int get(StoreHandle &handle, Key *&key, Value *&value)
+        /**
+         * get_next迭代到的kv所在memblock的最近访问时间, memblock内的kv共享
+         */
+        int64_t get_iter_access_time(const StoreHandle &handle) const
+        {
+          int64_t ret = 0;
+          if (StoreHandle::LOCKED == handle.stat && NULL != handle.mem_block)
+          {
+            ret = ((MemBlock*)handle.mem_block)->last_time();
+          }
+          return ret;
+        };
+        /**
+         * probation为true表示scan或合并的访问, 不会把probation memblock提升为protected
+         */
+        int get(StoreHandle &handle, Key *&key, Value *&value, const bool probation = false)
         {
           int ret = OB_SUCCESS;
           if (!inited_)
@@ -1392,7 +1485,7 @@ namespace oceanbase
             ret = ((MemBlock*)handle.mem_block)->get(handle.kv_pos, key, value);
             if (OB_SUCCESS == ret)
             {
-              update_mb_info_((MemBlock*)handle.mem_block);
+              update_mb_info_((MemBlock*)handle.mem_block, probation);
               handle.stat = StoreHandle::LOCKED;
               atomic_inc((uint64_t*)&not_revert_cnt_);
               atomic_inc((uint64_t*)&cache_hit_cnt_);
@@ -1447,6 +1540,22 @@ namespace oceanbase
         {
           return cache_hit_cnt_;
         };
+        int64_t get_probation_hit_cnt() const
+        {
+          return probation_hit_cnt_;
+        };
+        int64_t get_protected_hit_cnt() const
+        {
+          return protected_hit_cnt_;
+        };
+        int64_t get_promote_cnt() const
+        {
+          return promote_cnt_;
+        };
+        int64_t get_probation_size() const
+        {
+          return probation_mb_num_ * MemBlock::MEM_BLOCK_SIZE;
+        };
         int64_t size() const
         {
           return (free_list_.get_alloc_size());
@@ -1463,13 +1572,28 @@ namespace oceanbase
           }
           return bret;
         };
-        void update_mb_info_(MemBlock *memblock)
+        void update_mb_info_(MemBlock *memblock, const bool probation)
         {
           int64_t info_pos = memblock->get_info_pos();
           if (0 <= info_pos
               && total_mb_num_ > info_pos
               && memblock == mb_infos_[info_pos].mem_block)
           {
+            if (0 == mb_infos_[info_pos].probation)
+            {
+              atomic_inc((uint64_t*)&protected_hit_cnt_);
+            }
+            else
+            {
+              atomic_inc((uint64_t*)&probation_hit_cnt_);
+              // 被点查命中, 说明不是一次性的数据, 提升为protected
+              if (!probation
+                  && 1 == atomic_compare_exchange(&(mb_infos_[info_pos].probation), 0, 1))
+              {
+                atomic_dec((uint64_t*)&probation_mb_num_);
+                atomic_inc((uint64_t*)&promote_cnt_);
+              }
+            }
             // 有原子性问题 可能更新的访问计数已经不是这个memblock的了 这个误差可以接受
             atomic_inc((uint64_t*)&(mb_infos_[info_pos].get_cnt));
             if (mb_infos_[info_pos].get_cnt > avg_get_cnt_)
@@ -1480,6 +1604,14 @@ namespace oceanbase
           }
           else if (-1 == info_pos)
           {
+            if (memblock == cur_probation_memblock_)
+            {
+              atomic_inc((uint64_t*)&probation_hit_cnt_);
+            }
+            else
+            {
+              atomic_inc((uint64_t*)&protected_hit_cnt_);
+            }
             memblock->inc_get_cnt();
             memblock->set_last_time(tbsys::CTimeUtil::getTime());
           }
@@ -1501,7 +1633,9 @@ namespace oceanbase
           int64_t num = 0;
           const int64_t &max = heap[0];
           memset(heap, -1, sizeof(heap));
-          CmpFunc cmp_func(mb_infos_);
+          // probation memblock超过限额时优先淘汰, 否则和protected一起按访问时间淘汰
+          CmpFunc cmp_func(mb_infos_, KVStoreCacheComponent::TWO_Q_POLICY == policy_
+                                      && probation_mb_num_ * 100 > total_mb_num_ * probation_percent_);
           int64_t sort_timeu = tbsys::CTimeUtil::getTime();
           int64_t sum_get_cnt = 0;
           int64_t num_get_cnt = 0;
@@ -1544,6 +1678,10 @@ namespace oceanbase
             if (NULL != old
                 && old == (MemBlock*)atomic_compare_exchange((uint64_t*)&(mb_infos_[pos].mem_block), (uint64_t)NULL, (uint64_t)old))
             {
+              if (1 == atomic_compare_exchange(&(mb_infos_[pos].probation), 0, 1))
+              {
+                atomic_dec((uint64_t*)&probation_mb_num_);
+              }
               memblock_payload_size = old->get_payload_size();
               TBSYS_LOG_US(DEBUG, "try to free memblock=%p", old);
               if (deref_memblock_(old))
@@ -1562,9 +1700,10 @@ namespace oceanbase
           TBSYS_LOG_US(DEBUG, "sort_timeu=%ld free_timeu=%ld", sort_timeu, free_timeu);
           return wash_out_size;
         };
-        MemBlock *get_cur_memblock_(int32_t &seq_num, const int64_t align_kv_size)
+        MemBlock *get_cur_memblock_(int32_t &seq_num, const int64_t align_kv_size, const bool probation)
         {
           MemBlock *ret = NULL;
+          MemBlock * volatile &cur_memblock = probation ? cur_probation_memblock_ : cur_memblock_;
           if (align_kv_size > free_list_.get_max_alloc_size())
           {
             TBSYS_LOG_US(WARN, "cann't allocate memblock from free list, kv size is bigger "
@@ -1578,7 +1717,7 @@ namespace oceanbase
             {
               if (align_kv_size > MemBlock::MEM_BLOCK_SIZE
                   || (align_kv_size <= MemBlock::MEM_BLOCK_SIZE
-                      && (NULL == (ret = cur_memblock_) || !ret->check_and_inc_ref_cnt())))
+                      && (NULL == (ret = cur_memblock) || !ret->check_and_inc_ref_cnt())))
               {
                 MemBlock *new_memblock = free_list_.alloc(align_kv_size);
                 while (NULL == new_memblock)
@@ -1620,7 +1759,7 @@ namespace oceanbase
                 else
                 {
                   MemBlock *old_memblock = NULL;
-                  if (NULL == (old_memblock = (MemBlock*)atomic_compare_exchange((uint64_t*)&cur_memblock_, (uint64_t)new_memblock, (uint64_t)NULL)))
+                  if (NULL == (old_memblock = (MemBlock*)atomic_compare_exchange((uint64_t*)&cur_memblock, (uint64_t)new_memblock, (uint64_t)NULL)))
                   {
                     ret = new_memblock;
                     break;
@@ -1644,7 +1783,7 @@ namespace oceanbase
           }
           return ret;
         };
-        void submit_memblock_(MemBlock *submit_memblock)
+        void submit_memblock_(MemBlock *submit_memblock, const bool probation)
         {
           int64_t i = 0;
           for (; i < total_mb_num_; i++)
@@ -1659,6 +1798,11 @@ namespace oceanbase
             // 有原子性问题 可能更新的访问计数已经不是这个memblock的了 这个误差可以接受
             mb_infos_[i].get_cnt = submit_memblock->get_cnt();
             mb_infos_[i].last_time = tbsys::CTimeUtil::getTime();
+            if (probation
+                && 0 == atomic_compare_exchange(&(mb_infos_[i].probation), 1, 0))
+            {
+              atomic_inc((uint64_t*)&probation_mb_num_);
+            }
             submit_memblock->set_info_pos(i);
           }
           else
@@ -1669,11 +1813,12 @@ namespace oceanbase
             deref_memblock_(submit_memblock);
           }
         };
-        void submit_cur_memblock_(MemBlock *submit_memblock)
+        void submit_cur_memblock_(MemBlock *submit_memblock, const bool probation)
         {
-          if (submit_memblock == (MemBlock*)atomic_compare_exchange((uint64_t*)&cur_memblock_, (uint64_t)NULL, (uint64_t)submit_memblock))
+          MemBlock * volatile &cur_memblock = probation ? cur_probation_memblock_ : cur_memblock_;
+          if (submit_memblock == (MemBlock*)atomic_compare_exchange((uint64_t*)&cur_memblock, (uint64_t)NULL, (uint64_t)submit_memblock))
           {
-            submit_memblock_(submit_memblock);
+            submit_memblock_(submit_memblock, probation);
           }
         };
       private:
@@ -1691,7 +1836,15 @@ namespace oceanbase
         int64_t cache_miss_cnt_;
         int64_t cache_hit_cnt_;
 
+        KVStoreCacheComponent::ReplacePolicy policy_;
+        int64_t probation_percent_;
+        int64_t probation_mb_num_;
+        int64_t probation_hit_cnt_;
+        int64_t protected_hit_cnt_;
+        int64_t promote_cnt_;
+
         MemBlock * volatile cur_memblock_;
+        MemBlock * volatile cur_probation_memblock_;
     };
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1816,8 +1969,37 @@ namespace oceanbase
         {
           return store_.get_miss_cnt();
         };
+        int64_t get_probation_hit_cnt() const
+        {
+          return store_.get_probation_hit_cnt();
+        };
+        int64_t get_protected_hit_cnt() const
+        {
+          return store_.get_protected_hit_cnt();
+        };
+        int64_t get_promote_cnt() const
+        {
+          return store_.get_promote_cnt();
+        };
+        int64_t get_probation_size() const
+        {
+          return store_.get_probation_size();
+        };
+        /**
+         * select replace policy of the cache, with TWO_Q_POLICY, the
+         * key-values put with probation=true are stored in probation
+         * memblocks, which are washed out first if they exceed
+         * probation_percent of the cache, a probation memblock is
+         * promoted once it's hit by a get with probation=false.
+         */
+        int set_replace_policy(const KVStoreCacheComponent::ReplacePolicy policy,
+                               const int64_t probation_percent)
+        {
+          return store_.set_replace_policy(policy, probation_percent);
+        };
       private:
-        int internal_put(const Key &key, const Value &value, StoreHandle& store_handle, bool overwrite = true)
+        int internal_put(const Key &key, const Value &value, StoreHandle& store_handle,
+                         bool overwrite = true, const bool probation = false)
         {
           int ret = OB_SUCCESS;
           Key *pkey = NULL;
@@ -1829,7 +2011,7 @@ namespace oceanbase
           {
             ret = OB_ENTRY_EXIST;
           }
-          else if (OB_SUCCESS != (ret = store_.store(key, value, store_handle, &pkey))
+          else if (OB_SUCCESS != (ret = store_.store(key, value, store_handle, &pkey, NULL, probation))
                   || NULL == pkey)
           {
             TBSYS_LOG(WARN, "store key-value fail ret=%d", ret);
@@ -1886,12 +2068,12 @@ namespace oceanbase
          *
          * @return int
          */
-        int put(const Key &key, const Value &value, bool overwrite = true)
+        int put(const Key &key, const Value &value, bool overwrite = true, const bool probation = false)
         {
           int ret = OB_SUCCESS;
           StoreHandle store_handle;
 
-          ret = internal_put(key, value, store_handle, overwrite);
+          ret = internal_put(key, value, store_handle, overwrite, probation);
             if (OB_SUCCESS == ret)
             {
               store_.revert(store_handle);
@@ -1900,20 +2082,21 @@ namespace oceanbase
           return ret;
         };
         int put_and_fetch(const Key &key, const Value &input_value, Value &output_value,
-                          CacheHandle &handle, bool overwrite = true, bool only_cache = true)
+                          CacheHandle &handle, bool overwrite = true, bool only_cache = true,
+                          const bool probation = false)
         {
           int ret = OB_SUCCESS;
           StoreHandle store_handle;
 
-          ret = internal_put(key, input_value, store_handle, overwrite);
+          ret = internal_put(key, input_value, store_handle, overwrite, probation);
           if (OB_SUCCESS == ret)
           {
-            ret = get(key, output_value, handle, only_cache);
+            ret = get(key, output_value, handle, only_cache, true);
             store_.revert(store_handle);
           }
           else if (OB_ENTRY_EXIST == ret && !overwrite)
           {
-            ret = get(key, output_value, handle, only_cache);
+            ret = get(key, output_value, handle, only_cache, probation);
           }
           else
           {
@@ -1950,6 +2133,10 @@ namespace oceanbase
         {
           store_.reset_iter(handle.store_handle);
         };
+        int64_t get_iter_access_time(const CacheHandle &handle) const
+        {
+          return store_.get_iter_access_time(handle.store_handle);
+        };
         int get(const Key &key, Value &value, bool only_cache = true)
         {
           CacheHandle handle;
@@ -1963,7 +2150,8 @@ namespace oceanbase
 #ifdef __DEBUG_TEST__
         int get(const Key &key, Value &value, const Value &cv, CacheHandle &handle)
 #else
-        int get(const Key &key, Value &value, CacheHandle &handle, bool only_cache = true)
+        int get(const Key &key, Value &value, CacheHandle &handle, bool only_cache = true,
+                const bool probation = false)
 #endif
         {
           int ret = OB_SUCCESS;
@@ -1991,7 +2179,7 @@ namespace oceanbase
              */
             do
             {
-              if (OB_SUCCESS != (ret = store_.get(handle.store_handle, pkey, pvalue))
+              if (OB_SUCCESS != (ret = store_.get(handle.store_handle, pkey, pvalue, probation))
                   || NULL == pkey || NULL == pvalue)
               {
                 if (OB_SUCCESS == ret)
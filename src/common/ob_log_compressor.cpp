@@ -0,0 +1,183 @@
+/**
+ * (C) 2007-2010 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_log_compressor.cpp
+ *
+ */
+
+#include "ob_log_compressor.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    static const char *LOG_COMPRESSOR_LIB_NAMES[ObLogCompressor::MAX_TYPE] = {"none", "lzo_1.0", "snappy_1.0"};
+
+    ObLogCompressor &ObLogCompressor::get_instance()
+    {
+      static ObLogCompressor log_compressor;
+      return log_compressor;
+    }
+
+    int64_t ObLogCompressor::get_type(const char *lib_name)
+    {
+      int64_t type = -1;
+      if (NULL == lib_name || '\0' == lib_name[0])
+      {
+        type = NONE;
+      }
+      else
+      {
+        for (int64_t i = 0; i < MAX_TYPE; i++)
+        {
+          if (0 == strcmp(lib_name, LOG_COMPRESSOR_LIB_NAMES[i]))
+          {
+            type = i;
+            break;
+          }
+        }
+      }
+      return type;
+    }
+
+    const char *ObLogCompressor::get_lib_name(const int64_t type)
+    {
+      return (0 <= type && MAX_TYPE > type) ? LOG_COMPRESSOR_LIB_NAMES[type] : "unknown";
+    }
+
+    int64_t ObLogCompressor::get_max_compress_size(const int64_t data_len)
+    {
+      // snappy最多膨胀32 + len/6, lzo每1KB最多膨胀16字节
+      return data_len + data_len / 6 + 64;
+    }
+
+    ObLogCompressor::ObLogCompressor() : uncompress_buffer_(static_cast<int32_t>(OB_MAX_LOG_BUFFER_SIZE))
+    {
+      memset(compressors_, 0, sizeof(compressors_));
+    }
+
+    ObLogCompressor::~ObLogCompressor()
+    {
+    }
+
+    int ObLogCompressor::register_compressor(const int64_t type, ObCompressor *compressor)
+    {
+      int err = OB_SUCCESS;
+      if (NONE >= type || MAX_TYPE <= type || NULL == compressor)
+      {
+        err = OB_INVALID_ARGUMENT;
+        TBSYS_LOG(ERROR, "register_compressor(type=%ld, compressor=%p): invalid argument", type, compressor);
+      }
+      else if (NULL != compressors_[type])
+      {
+        err = OB_INIT_TWICE;
+        TBSYS_LOG(WARN, "log compressor[%s] already registered", get_lib_name(type));
+      }
+      else
+      {
+        compressors_[type] = compressor;
+        TBSYS_LOG(INFO, "register log compressor[%s]", get_lib_name(type));
+      }
+      return err;
+    }
+
+    bool ObLogCompressor::is_registered(const int64_t type) const
+    {
+      return NONE == type || (NONE < type && MAX_TYPE > type && NULL != compressors_[type]);
+    }
+
+    int ObLogCompressor::compress(const int64_t type, const char *data, const int64_t data_len,
+                                  char *buf, const int64_t buf_len, int64_t &compressed_len) const
+    {
+      int err = OB_SUCCESS;
+      int com_err = ObCompressor::COM_E_NOERROR;
+      if (NULL == data || 0 >= data_len || NULL == buf || get_max_compress_size(data_len) > buf_len)
+      {
+        err = OB_INVALID_ARGUMENT;
+      }
+      else if (NONE == type)
+      {
+        err = OB_NOT_SUPPORTED;
+      }
+      else if (!is_registered(type))
+      {
+        err = OB_ENTRY_NOT_EXIST;
+        TBSYS_LOG(ERROR, "log compressor[type=%ld] not registered", type);
+      }
+      else if (ObCompressor::COM_E_NOERROR != (com_err = compressors_[type]->compress(data, data_len, buf, buf_len, compressed_len)))
+      {
+        err = OB_ERROR;
+        TBSYS_LOG(WARN, "%s compress(data_len=%ld)=>%d", get_lib_name(type), data_len, com_err);
+      }
+      else if (compressed_len >= data_len)
+      {
+        err = OB_NOT_SUPPORTED;
+      }
+      return err;
+    }
+
+    int ObLogCompressor::uncompress(const int64_t type, const char *data, const int64_t data_len,
+                                    char *buf, const int64_t buf_len, const int64_t uncompressed_len) const
+    {
+      int err = OB_SUCCESS;
+      int com_err = ObCompressor::COM_E_NOERROR;
+      int64_t real_len = 0;
+      if (NULL == data || 0 >= data_len || NULL == buf || uncompressed_len > buf_len)
+      {
+        err = OB_INVALID_ARGUMENT;
+        TBSYS_LOG(ERROR, "uncompress(data=%p[%ld], buf=%p[%ld], uncompressed_len=%ld): invalid argument",
+                  data, data_len, buf, buf_len, uncompressed_len);
+      }
+      else if (NONE == type || !is_registered(type))
+      {
+        err = OB_NOT_SUPPORTED;
+        TBSYS_LOG(ERROR, "log compressor[type=%ld] not registered", type);
+      }
+      else if (ObCompressor::COM_E_NOERROR != (com_err = compressors_[type]->decompress(data, data_len, buf, buf_len, real_len)))
+      {
+        err = OB_ERR_UNEXPECTED;
+        TBSYS_LOG(ERROR, "%s decompress(data_len=%ld)=>%d", get_lib_name(type), data_len, com_err);
+      }
+      else if (real_len != uncompressed_len)
+      {
+        err = OB_ERR_UNEXPECTED;
+        TBSYS_LOG(ERROR, "uncompressed_len[%ld] != expected[%ld]", real_len, uncompressed_len);
+      }
+      return err;
+    }
+
+    int ObLogCompressor::uncompress_log(const ObLogEntry &entry, const char *&log_data, int64_t &data_len) const
+    {
+      int err = OB_SUCCESS;
+      ThreadSpecificBuffer::Buffer *buffer = NULL;
+      if (!entry.is_compressed())
+      {}
+      else if (NULL == (buffer = uncompress_buffer_.get_buffer()))
+      {
+        err = OB_ALLOCATE_MEMORY_FAILED;
+        TBSYS_LOG(ERROR, "get thread buffer fail");
+      }
+      else
+      {
+        buffer->reset();
+        if (OB_SUCCESS != (err = uncompress(entry.get_compress_type(), log_data, data_len,
+                                            buffer->current(), buffer->remain(), entry.get_uncompressed_data_len())))
+        {
+          TBSYS_LOG(ERROR, "uncompress log[seq=%lu, cmd=%d] fail, err=%d", entry.seq_, entry.cmd_, err);
+        }
+        else
+        {
+          log_data = buffer->current();
+          data_len = entry.get_uncompressed_data_len();
+        }
+      }
+      return err;
+    }
+  } // end namespace common
+} // end namespace oceanbase
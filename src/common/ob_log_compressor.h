@@ -0,0 +1,88 @@
+/**
+ * (C) 2007-2010 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_log_compressor.h
+ *
+ * commit log的压缩和解压
+ * 压缩库通过dlopen加载, common不直接依赖libcomp, 由写日志或回放日志的进程
+ * 在启动时调用register_compressor注册, 没有注册的压缩类型在解压时报错
+ *
+ */
+
+#ifndef __OB_COMMON_OB_LOG_COMPRESSOR_H__
+#define __OB_COMMON_OB_LOG_COMPRESSOR_H__
+
+#include "ob_define.h"
+#include "ob_log_entry.h"
+#include "thread_buffer.h"
+#include "compress/ob_compressor.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    class ObLogCompressor
+    {
+      public:
+        // 压缩类型会写入日志, 只能追加不能修改
+        enum
+        {
+          NONE = 0,
+          LZO = 1,
+          SNAPPY = 2,
+          MAX_TYPE = 3,
+        };
+      public:
+        static ObLogCompressor &get_instance();
+        // 根据压缩库名得到压缩类型, "none"或空串返回NONE, 不认识的名字返回-1
+        static int64_t get_type(const char *lib_name);
+        static const char *get_lib_name(const int64_t type);
+        // 压缩data_len字节的数据需要的最大缓冲区大小
+        static int64_t get_max_compress_size(const int64_t data_len);
+      public:
+        ObLogCompressor();
+        ~ObLogCompressor();
+      public:
+        int register_compressor(const int64_t type, ObCompressor *compressor);
+        bool is_registered(const int64_t type) const;
+        // 压缩后不小于原始长度时返回OB_NOT_SUPPORTED, 调用者应该写入原始数据
+        int compress(const int64_t type, const char *data, const int64_t data_len,
+                     char *buf, const int64_t buf_len, int64_t &compressed_len) const;
+        int uncompress(const int64_t type, const char *data, const int64_t data_len,
+                       char *buf, const int64_t buf_len, const int64_t uncompressed_len) const;
+        // 日志被压缩时解压到线程局部的缓冲区并替换log_data和data_len, 否则不做任何修改
+        // 返回的缓冲区在本线程下一次解压之前有效
+        int uncompress_log(const ObLogEntry &entry, const char *&log_data, int64_t &data_len) const;
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObLogCompressor);
+        ObCompressor *compressors_[MAX_TYPE];
+        ThreadSpecificBuffer uncompress_buffer_;
+    };
+
+    inline int uncompress_log_data(const ObLogEntry &entry, const char *&log_data, int64_t &data_len)
+    {
+      int err = OB_SUCCESS;
+      if (entry.is_compressed())
+      {
+        err = ObLogCompressor::get_instance().uncompress_log(entry, log_data, data_len);
+      }
+      return err;
+    }
+
+    // 取出buf中entry对应的日志内容, 压缩的日志会被解压
+    inline int get_log_data(const ObLogEntry &entry, const char *buf, const char *&log_data, int64_t &data_len)
+    {
+      log_data = buf;
+      data_len = entry.get_log_data_len();
+      return uncompress_log_data(entry, log_data, data_len);
+    }
+  } // end namespace common
+} // end namespace oceanbase
+
+#endif /* __OB_COMMON_OB_LOG_COMPRESSOR_H__ */
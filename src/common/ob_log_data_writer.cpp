@@ -382,6 +382,37 @@ namespace oceanbase
       return err;
     }
 
+    int remove_log_index(const char* fname)
+    {
+      int err = OB_SUCCESS;
+      char path[OB_MAX_FILE_NAME_LENGTH];
+      char tmp_path[OB_MAX_FILE_NAME_LENGTH];
+      int64_t len = 0;
+      if (NULL == fname)
+      {
+        err = OB_INVALID_ARGUMENT;
+      }
+      else if ((len = snprintf(path, sizeof(path), "%s.%s", fname, LOG_INDEX_EXTENSION)) < 0
+               || len >= (int64_t)sizeof(path)
+               || (len = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path)) < 0
+               || len >= (int64_t)sizeof(tmp_path))
+      {
+        err = OB_BUF_NOT_ENOUGH;
+        TBSYS_LOG(ERROR, "file name too long, fname=%s", fname);
+      }
+      else if (0 != unlink(path) && ENOENT != errno)
+      {
+        err = OB_IO_ERROR;
+        TBSYS_LOG(ERROR, "unlink(%s):%s", path, strerror(errno));
+      }
+      else if (0 != unlink(tmp_path) && ENOENT != errno)
+      {
+        err = OB_IO_ERROR;
+        TBSYS_LOG(ERROR, "unlink(%s):%s", tmp_path, strerror(errno));
+      }
+      return err;
+    }
+
     int ObLogDataWriter::prepare_fd(const int64_t file_id)
     {
       int err = OB_SUCCESS;
@@ -431,6 +462,11 @@ namespace oceanbase
       {
         TBSYS_LOG(INFO, "old %s exist, append clog to it", fname);
       }
+      // 同名的日志文件以前被删掉过, 它的索引已经过期了
+      else if (OB_SUCCESS != (err = remove_log_index(fname)))
+      {
+        TBSYS_LOG(ERROR, "remove_log_index(%s)=>%d", fname, err);
+      }
       else if ((NULL == select_pool_file(pool_file, sizeof(pool_file))
                 || (fd_ = reuse(pool_file, fname)) < 0)
                && (fd_ = open(fname, CREATE_FLAG, OPEN_MODE)) < 0)
@@ -470,6 +506,15 @@ namespace oceanbase
         err = OB_IO_ERROR;
         TBSYS_LOG(WARN, "rename(%s,%s):%s", pool_file, tmp_pool_file, strerror(errno));
       }
+      // 回收的日志文件换了file_id, 原来的索引不能再用
+      else if (OB_SUCCESS != (err = remove_log_index(pool_file)))
+      {
+        TBSYS_LOG(ERROR, "remove_log_index(%s)=>%d", pool_file, err);
+      }
+      else if (OB_SUCCESS != (err = remove_log_index(fname)))
+      {
+        TBSYS_LOG(ERROR, "remove_log_index(%s)=>%d", fname, err);
+      }
       else if ((fd = open(tmp_pool_file, OPEN_FLAG, OPEN_MODE)) < 0)
       {
         err = OB_IO_ERROR;
@@ -20,6 +20,11 @@ namespace oceanbase
 {
   namespace common
   {
+    // 已经写完的日志文件的索引文件是log_dir/file_id.index, 见updateserver::ObLogFileIndex
+    const char* const LOG_INDEX_EXTENSION = "index";
+    // 删除日志文件fname的索引文件和没写完的临时索引文件, 索引文件不存在不算错误
+    int remove_log_index(const char* fname);
+
     class MinAvailFileIdGetter
     {
       public:
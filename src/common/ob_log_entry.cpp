@@ -30,7 +30,7 @@ int ObLogEntry::fill_header(const char* log_data, const int64_t data_len)
     header_.set_magic_num(MAGIC_NUMER);
     header_.header_length_ = OB_RECORD_HEADER_LENGTH;
     header_.version_ = LOG_VERSION;
-    header_.reserved_ = 0;
+    // reserved_中保存压缩标志, 重新填充header(如修改日志号)时需要保留
     header_.data_length_ = static_cast<int32_t>(sizeof(uint64_t) + sizeof(LogCommand) + data_len);
     header_.data_zlength_ = header_.data_length_;
     if (NULL != log_data)
@@ -47,6 +47,22 @@ int ObLogEntry::fill_header(const char* log_data, const int64_t data_len)
   return ret;
 }
 
+int ObLogEntry::set_compressed(const int64_t compress_type, const int64_t uncompressed_data_len)
+{
+  int ret = OB_SUCCESS;
+  if (0 >= compress_type || 0xFFFFFFFFL < compress_type
+      || 0 >= uncompressed_data_len || 0xFFFFFFFFL < uncompressed_data_len)
+  {
+    ret = OB_INVALID_ARGUMENT;
+  }
+  else
+  {
+    header_.reserved_ = (compress_type << 32) | uncompressed_data_len;
+    header_.set_header_checksum();
+  }
+  return ret;
+}
+
 int64_t ObLogEntry::calc_data_checksum(const char* log_data, const int64_t data_len) const
 {
   uint64_t data_checksum = 0;
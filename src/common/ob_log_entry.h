@@ -74,6 +74,8 @@ namespace oceanbase
      *     ObRecordHeader + 日志序号 + LogCommand + 日志内容
      * ObLogEntry中保存ObRecordHeader, 日志序号, LogCommand 三部分
      * ObLogEntry中的data_checksum_项是对"日志序号", "LogCommand", "日志内容" 部分的校验
+     * 日志内容被压缩时, header_.reserved_的高32位为压缩类型, 低32位为压缩前的日志内容长度,
+     * data_length_和data_checksum_都按压缩后的内容计算, 因此按偏移切分和校验日志的逻辑不受影响
      */
     struct ObLogEntry
     {
@@ -131,6 +133,22 @@ namespace oceanbase
         return static_cast<int32_t>(header_.data_length_ - sizeof(uint64_t) - sizeof(LogCommand));
       }
 
+      /**
+       * 日志内容是否被压缩
+       */
+      bool is_compressed() const {return 0 != header_.reserved_;}
+
+      int64_t get_compress_type() const {return (header_.reserved_ >> 32) & 0xFFFFFFFFL;}
+
+      int64_t get_uncompressed_data_len() const {return header_.reserved_ & 0xFFFFFFFFL;}
+
+      /**
+       * 标记日志内容已被压缩, 需要在fill_header之后调用, 会重新计算header的校验和
+       * @param [in] compress_type 压缩类型
+       * @param [in] uncompressed_data_len 压缩前的日志内容长度
+       */
+      int set_compressed(const int64_t compress_type, const int64_t uncompressed_data_len);
+
       int check_header_integrity(const bool dump_content=true) const;
 
       /**
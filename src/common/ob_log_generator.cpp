@@ -54,7 +54,8 @@ namespace oceanbase
     } eof_flag_buf_constructor_;
 
     ObLogGenerator::ObLogGenerator(): is_frozen_(false), log_file_max_size_(1<<24), start_cursor_(), end_cursor_(),
-                                      log_buf_(NULL), log_buf_len_(0), pos_(0)
+                                      log_buf_(NULL), log_buf_len_(0), pos_(0), compress_type_(ObLogCompressor::NONE),
+                                      serialize_buf_(NULL), compress_buf_(NULL), compress_buf_len_(0)
     {
       memset(empty_log_, 0, sizeof(empty_log_));
     }
@@ -66,6 +67,41 @@ namespace oceanbase
         free(log_buf_);
         log_buf_ = NULL;
       }
+      if (NULL != serialize_buf_)
+      {
+        ob_free(serialize_buf_);
+        serialize_buf_ = NULL;
+      }
+      if (NULL != compress_buf_)
+      {
+        ob_free(compress_buf_);
+        compress_buf_ = NULL;
+      }
+    }
+
+    int ObLogGenerator::prepare_compress_buf()
+    {
+      int err = OB_SUCCESS;
+      int64_t compress_buf_len = ObLogCompressor::get_max_compress_size(log_buf_len_);
+      if (NULL != serialize_buf_ && NULL != compress_buf_)
+      {}
+      else if (NULL == serialize_buf_
+               && NULL == (serialize_buf_ = (char*)ob_malloc(log_buf_len_, ObModIds::OB_LOG_WRITER)))
+      {
+        err = OB_ALLOCATE_MEMORY_FAILED;
+        TBSYS_LOG(ERROR, "ob_malloc(%ld) for serialize_buf fail", log_buf_len_);
+      }
+      else if (NULL == compress_buf_
+               && NULL == (compress_buf_ = (char*)ob_malloc(compress_buf_len, ObModIds::OB_LOG_WRITER)))
+      {
+        err = OB_ALLOCATE_MEMORY_FAILED;
+        TBSYS_LOG(ERROR, "ob_malloc(%ld) for compress_buf fail", compress_buf_len);
+      }
+      else
+      {
+        compress_buf_len_ = compress_buf_len;
+      }
+      return err;
     }
 
     bool ObLogGenerator::is_inited() const
@@ -269,7 +305,8 @@ namespace oceanbase
     }
 
     static int generate_log(char* buf, const int64_t len, int64_t& pos, ObLogCursor& cursor, const LogCommand cmd,
-                 const char* log_data, const int64_t data_len)
+                 const char* log_data, const int64_t data_len,
+                 const int64_t compress_type = ObLogCompressor::NONE, const int64_t uncompressed_data_len = 0)
     {
       int err = OB_SUCCESS;
       ObLogEntry entry;
@@ -288,6 +325,11 @@ namespace oceanbase
       {
         TBSYS_LOG(ERROR, "cursor[%s].next_entry()=>%d", to_cstring(cursor), err);
       }
+      else if (ObLogCompressor::NONE != compress_type
+               && OB_SUCCESS != (err = entry.set_compressed(compress_type, uncompressed_data_len)))
+      {
+        TBSYS_LOG(ERROR, "entry.set_compressed(type=%ld, len=%ld)=>%d", compress_type, uncompressed_data_len, err);
+      }
       else if (OB_SUCCESS != (err = serialize_log_entry(buf, len, pos, entry, log_data, data_len)))
       {
         TBSYS_LOG(DEBUG, "serialize_log_entry(buf=%p, len=%ld, entry[id=%ld], data_len=%ld)=>%d",
@@ -301,7 +343,8 @@ namespace oceanbase
     }
 
     int ObLogGenerator:: do_write_log(const LogCommand cmd, const char* log_data, const int64_t data_len,
-                                      const int64_t reserved_len)
+                                      const int64_t reserved_len, const int64_t compress_type,
+                                      const int64_t uncompressed_data_len)
     {
       int err = OB_SUCCESS;
       if (OB_SUCCESS != (err = check_state()))
@@ -313,7 +356,8 @@ namespace oceanbase
         err = OB_INVALID_ARGUMENT;
       }
       else if (OB_SUCCESS != (err = generate_log(log_buf_, log_buf_len_ - reserved_len, pos_,
-                                                 end_cursor_, cmd, log_data, data_len))
+                                                 end_cursor_, cmd, log_data, data_len,
+                                                 compress_type, uncompressed_data_len))
                && OB_BUF_NOT_ENOUGH != err)
       {
         TBSYS_LOG(WARN, "generate_log(pos=%ld)=>%d", pos_, err);
@@ -434,6 +478,8 @@ namespace oceanbase
     int ObLogGenerator:: write_log(const LogCommand cmd, const char* log_data, const int64_t data_len)
     {
       int err = OB_SUCCESS;
+      int64_t compress_type = compress_type_;
+      int64_t compressed_len = 0;
       if (OB_SUCCESS != (err = check_state()))
       {
         TBSYS_LOG(ERROR, "check_state()=>%d", err);
@@ -447,10 +493,35 @@ namespace oceanbase
         err = OB_BUF_NOT_ENOUGH;
         TBSYS_LOG(WARN, "log_buf is frozen, end_cursor=%s", to_cstring(end_cursor_));
       }
-      else if (OB_SUCCESS != (err = do_write_log(cmd, log_data, data_len, LOG_BUF_RESERVED_SIZE))
+      else if (ObLogCompressor::NONE == compress_type
+               || MIN_COMPRESS_LOG_SIZE > data_len)
+      {
+        if (OB_SUCCESS != (err = do_write_log(cmd, log_data, data_len, LOG_BUF_RESERVED_SIZE))
+            && OB_BUF_NOT_ENOUGH != err)
+        {
+          TBSYS_LOG(WARN, "do_write_log(cmd=%d, pos=%ld, len=%ld)=>%d", cmd, pos_, data_len, err);
+        }
+      }
+      else if (OB_SUCCESS != (err = prepare_compress_buf()))
+      {
+        TBSYS_LOG(ERROR, "prepare_compress_buf()=>%d", err);
+      }
+      else if (OB_SUCCESS != (err = ObLogCompressor::get_instance().compress(compress_type, log_data, data_len,
+                                                                             compress_buf_, compress_buf_len_, compressed_len)))
+      {
+        // 压不小或者压缩失败时写入原始数据
+        if (OB_SUCCESS != (err = do_write_log(cmd, log_data, data_len, LOG_BUF_RESERVED_SIZE))
+            && OB_BUF_NOT_ENOUGH != err)
+        {
+          TBSYS_LOG(WARN, "do_write_log(cmd=%d, pos=%ld, len=%ld)=>%d", cmd, pos_, data_len, err);
+        }
+      }
+      else if (OB_SUCCESS != (err = do_write_log(cmd, compress_buf_, compressed_len, LOG_BUF_RESERVED_SIZE,
+                                                 compress_type, data_len))
                && OB_BUF_NOT_ENOUGH != err)
       {
-        TBSYS_LOG(WARN, "do_write_log(cmd=%d, pos=%ld, len=%ld)=>%d", cmd, pos_, data_len, err);
+        TBSYS_LOG(WARN, "do_write_log(cmd=%d, pos=%ld, len=%ld, compressed_len=%ld)=>%d",
+                  cmd, pos_, data_len, compressed_len, err);
       }
 
       return err;
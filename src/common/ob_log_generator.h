@@ -19,6 +19,7 @@
 
 #include "ob_log_entry.h"
 #include "ob_log_cursor.h"
+#include "ob_log_compressor.h"
 
 using namespace oceanbase::common;
 namespace oceanbase
@@ -31,6 +32,8 @@ namespace oceanbase
         static const int64_t LOG_FILE_ALIGN_SIZE = 1<<OB_DIRECT_IO_ALIGN_BITS;
         static const int64_t LOG_FILE_ALIGN_MASK = LOG_FILE_ALIGN_SIZE - 1;
         static const int64_t LOG_BUF_RESERVED_SIZE = 3 * LOG_FILE_ALIGN_SIZE; // nop + switch_log + eof
+        // 小于这个长度的日志压缩收益很小, 不压缩
+        static const int64_t MIN_COMPRESS_LOG_SIZE = 256;
       public:
         ObLogGenerator();
         ~ObLogGenerator();
@@ -44,6 +47,10 @@ namespace oceanbase
         int write_log(const LogCommand cmd, const char* log_data, const int64_t data_len);
         template<typename T>
         int write_log(const LogCommand cmd, T& data);
+        // 设置write_log写入的日志的压缩类型, 取值为ObLogCompressor::NONE/LZO/SNAPPY
+        // switch_log/nop/checkpoint等内部日志不压缩
+        void set_compress_type(const int64_t compress_type) {compress_type_ = compress_type;};
+        int64_t get_compress_type() const {return compress_type_;};
         int get_log(ObLogCursor& start_cursor, ObLogCursor& end_cursor, char*& buf, int64_t& len);
         int commit(const ObLogCursor& end_cursor);
         int switch_log(int64_t& new_file_id);
@@ -60,7 +67,9 @@ namespace oceanbase
         bool is_inited() const;
         int check_state() const;
         int do_write_log(const LogCommand cmd, const char* log_data, const int64_t data_len,
-                         const int64_t reserved_len);
+                         const int64_t reserved_len, const int64_t compress_type = ObLogCompressor::NONE,
+                         const int64_t uncompressed_data_len = 0);
+        int prepare_compress_buf();
         int check_log_file_size();
         int switch_log();
         int write_nop();
@@ -76,6 +85,11 @@ namespace oceanbase
         int64_t log_buf_len_;
         int64_t pos_;
         char empty_log_[LOG_FILE_ALIGN_SIZE * 2];
+        volatile int64_t compress_type_;
+        // 打开压缩后才分配, 只在写日志的线程中使用
+        char* serialize_buf_;
+        char* compress_buf_;
+        int64_t compress_buf_len_;
     };
 
     template<typename T>
@@ -129,15 +143,34 @@ namespace oceanbase
     int ObLogGenerator::write_log(const LogCommand cmd, T& data)
     {
       int err = OB_SUCCESS;
+      int64_t data_len = 0;
       if (OB_SUCCESS != (err = check_state()))
       {
         TBSYS_LOG(ERROR, "check_state()=>%d", err);
       }
-      else if (OB_SUCCESS != (err = generate_log(log_buf_, log_buf_len_ - LOG_BUF_RESERVED_SIZE, pos_,
-                                                 end_cursor_, cmd, data))
+      else if (ObLogCompressor::NONE == compress_type_)
+      {
+        if (OB_SUCCESS != (err = generate_log(log_buf_, log_buf_len_ - LOG_BUF_RESERVED_SIZE, pos_,
+                                              end_cursor_, cmd, data))
+            && OB_BUF_NOT_ENOUGH != err)
+        {
+          TBSYS_LOG(WARN, "generate_log(pos=%ld)=>%d", pos_, err);
+        }
+      }
+      // 压缩时先序列化到单独的缓冲区, 再按普通日志压缩写入
+      else if (OB_SUCCESS != (err = prepare_compress_buf()))
+      {
+        TBSYS_LOG(ERROR, "prepare_compress_buf()=>%d", err);
+      }
+      else if (OB_SUCCESS != (err = data.serialize(serialize_buf_, log_buf_len_ - LOG_BUF_RESERVED_SIZE, data_len)))
+      {
+        err = OB_LOG_TOO_LARGE;
+        TBSYS_LOG(WARN, "log too large(size=%ld, limit=%ld)", data.get_serialize_size(), log_buf_len_ - LOG_BUF_RESERVED_SIZE);
+      }
+      else if (OB_SUCCESS != (err = write_log(cmd, serialize_buf_, data_len))
                && OB_BUF_NOT_ENOUGH != err)
       {
-        TBSYS_LOG(WARN, "generate_log(pos=%ld)=>%d", pos_, err);
+        TBSYS_LOG(WARN, "write_log(pos=%ld, data_len=%ld)=>%d", pos_, data_len, err);
       }
       return err;
     }
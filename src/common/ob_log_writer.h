@@ -115,6 +115,8 @@ namespace oceanbase
 
         void set_disk_warn_threshold_us(const int64_t warn_us);
         void set_net_warn_threshold_us(const int64_t warn_us);
+        /// @brief 设置日志内容的压缩类型, 取值见ObLogCompressor
+        void set_log_compress_type(const int64_t compress_type) {log_generator_.set_compress_type(compress_type);}
       /// @brief Master切换日志文件
       /// 产生一条切换日志文件的commit log
       /// 同步到Slave机器并等待返回
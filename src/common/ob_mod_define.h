@@ -141,6 +141,10 @@ namespace oceanbase
         // updateserver modules
         OB_UPS_ENGINE,
         OB_UPS_MEMTABLE,
+        OB_UPS_MEMTABLE_STRING,
+        OB_UPS_MEMTABLE_NODE,
+        OB_UPS_MEMTABLE_TEVALUE,
+        OB_UPS_MEMTABLE_INDEX,
         OB_UPS_LOG,
         OB_UPS_SCHEMA,
         OB_UPS_RESOURCE_POOL_NODE,
@@ -154,6 +158,7 @@ namespace oceanbase
         OB_UPS_DATA_BLOCK,
         OB_UPS_SSTABLE_MGR,
         OB_UPS_COMMON,
+        OB_UPS_SCAN_STREAM,
 
         // chunkserver modules
         OB_CS_SSTABLE_READER,
@@ -211,6 +216,10 @@ namespace oceanbase
         OB_SQL_RESULT_SET_DYN,
         OB_SQL_SESSION_HASHMAP,
         OB_SQL_SESSION_SBLOCK,
+        OB_SQL_HASH_GROUPBY,
+        OB_SQL_HASH_JOIN,
+        OB_SQL_PLAN_CACHE,
+        OB_SQL_ROW_BATCH,
 
         OB_MOD_END
       };
@@ -293,6 +302,10 @@ namespace oceanbase
 
       ADD_MOD(OB_UPS_ENGINE);
       ADD_MOD(OB_UPS_MEMTABLE);
+      ADD_MOD(OB_UPS_MEMTABLE_STRING);
+      ADD_MOD(OB_UPS_MEMTABLE_NODE);
+      ADD_MOD(OB_UPS_MEMTABLE_TEVALUE);
+      ADD_MOD(OB_UPS_MEMTABLE_INDEX);
       ADD_MOD(OB_UPS_LOG);
       ADD_MOD(OB_UPS_SCHEMA);
       ADD_MOD(OB_UPS_RESOURCE_POOL_NODE);
@@ -306,6 +319,7 @@ namespace oceanbase
       ADD_MOD(OB_UPS_DATA_BLOCK);
       ADD_MOD(OB_UPS_SSTABLE_MGR);
       ADD_MOD(OB_UPS_COMMON);
+      ADD_MOD(OB_UPS_SCAN_STREAM);
 
       ADD_MOD(OB_CS_SSTABLE_READER);
       ADD_MOD(OB_CS_TABLET_IMAGE);
@@ -358,6 +372,10 @@ namespace oceanbase
       ADD_MOD(OB_SQL_RESULT_SET_DYN);
       ADD_MOD(OB_SQL_SESSION_HASHMAP);
       ADD_MOD(OB_SQL_SESSION_SBLOCK);
+      ADD_MOD(OB_SQL_HASH_GROUPBY);
+      ADD_MOD(OB_SQL_HASH_JOIN);
+      ADD_MOD(OB_SQL_PLAN_CACHE);
+      ADD_MOD(OB_SQL_ROW_BATCH);
 
       ADD_MOD(OB_MOD_END);
     }
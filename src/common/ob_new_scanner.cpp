@@ -756,6 +756,11 @@ int ObNewScanner::get_next_row(ObRow &row)
   return ret;
 }
 
+int ObNewScanner::get_next_compact_row(ObString &compact_row)
+{
+  return row_store_.get_next_compact_row(compact_row);
+}
+
 bool ObNewScanner::is_empty() const
 {
   return row_store_.is_empty();
@@ -59,6 +59,10 @@ namespace oceanbase
 
         int get_next_row(const ObRowkey *&rowkey, ObRow &row);
 
+        /// get the next row without converting it, see ObRowStore::get_next_compact_row()
+        /// @retval OB_ITER_END iterate end
+        int get_next_compact_row(ObString &compact_row);
+
         /* @brief set default row desc which will auto filt into row
          * when invoke get_next_row if row desc of the given parameter
          * row is NULL. */
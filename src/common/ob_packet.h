@@ -338,6 +338,8 @@ namespace oceanbase
       OB_UPS_SHOW_SESSIONS_RESPONSE = 1308,
       OB_UPS_KILL_SESSION = 1309,
       OB_UPS_KILL_SESSION_RESPONSE = 1310,
+      OB_UPS_GET_ROW_MODIFY_SLOTS = 1311,
+      OB_UPS_GET_ROW_MODIFY_SLOTS_RESPONSE = 1312,
 
       OB_GET_CLOG_STAT = 1340,
       OB_GET_CLOG_STAT_RESPONSE = 1341,
@@ -0,0 +1,151 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_row_modify_slots.cpp for the row modify slots which updateserver
+ * reports to chunkserver to validate cached fused rows.
+ *
+ */
+#include <tbsys.h>
+#include "serialization.h"
+#include "ob_row_modify_slots.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    ObRowModifySlots::ObRowModifySlots()
+    {
+      reset();
+    }
+
+    ObRowModifySlots::~ObRowModifySlots()
+    {
+    }
+
+    void ObRowModifySlots::reset()
+    {
+      ups_epoch_ = 0;
+      commited_trans_id_ = 0;
+      is_overflow_ = false;
+      slot_count_ = 0;
+    }
+
+    int ObRowModifySlots::add_slot(const int64_t slot, const int64_t trans_id)
+    {
+      int ret = OB_SUCCESS;
+      if (slot < 0 || slot >= ROW_MODIFY_SLOT_NUM)
+      {
+        TBSYS_LOG(WARN, "invalid row modify slot=%ld", slot);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (is_overflow_ || slot_count_ >= MAX_SLOT_COUNT)
+      {
+        set_overflow();
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else
+      {
+        slots_[slot_count_].slot_ = slot;
+        slots_[slot_count_].trans_id_ = trans_id;
+        ++slot_count_;
+      }
+      return ret;
+    }
+
+    DEFINE_SERIALIZE(ObRowModifySlots)
+    {
+      int ret = OB_SUCCESS;
+      if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos, ups_epoch_)))
+      {
+        TBSYS_LOG(WARN, "serialize ups_epoch fail, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos, commited_trans_id_)))
+      {
+        TBSYS_LOG(WARN, "serialize commited_trans_id fail, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::encode_bool(buf, buf_len, pos, is_overflow_)))
+      {
+        TBSYS_LOG(WARN, "serialize is_overflow fail, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos, slot_count_)))
+      {
+        TBSYS_LOG(WARN, "serialize slot_count fail, ret=%d", ret);
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < slot_count_; ++i)
+      {
+        if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos, slots_[i].slot_)))
+        {
+          TBSYS_LOG(WARN, "serialize slot fail, ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos, slots_[i].trans_id_)))
+        {
+          TBSYS_LOG(WARN, "serialize slot trans_id fail, ret=%d", ret);
+        }
+      }
+      return ret;
+    }
+
+    DEFINE_DESERIALIZE(ObRowModifySlots)
+    {
+      int ret = OB_SUCCESS;
+      if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &ups_epoch_)))
+      {
+        TBSYS_LOG(WARN, "deserialize ups_epoch fail, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &commited_trans_id_)))
+      {
+        TBSYS_LOG(WARN, "deserialize commited_trans_id fail, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::decode_bool(buf, data_len, pos, &is_overflow_)))
+      {
+        TBSYS_LOG(WARN, "deserialize is_overflow fail, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &slot_count_)))
+      {
+        TBSYS_LOG(WARN, "deserialize slot_count fail, ret=%d", ret);
+      }
+      else if (slot_count_ < 0 || slot_count_ > MAX_SLOT_COUNT)
+      {
+        TBSYS_LOG(WARN, "invalid slot_count=%ld", slot_count_);
+        ret = OB_DESERIALIZE_ERROR;
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < slot_count_; ++i)
+      {
+        if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &slots_[i].slot_)))
+        {
+          TBSYS_LOG(WARN, "deserialize slot fail, ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &slots_[i].trans_id_)))
+        {
+          TBSYS_LOG(WARN, "deserialize slot trans_id fail, ret=%d", ret);
+        }
+        else if (slots_[i].slot_ < 0 || slots_[i].slot_ >= ROW_MODIFY_SLOT_NUM)
+        {
+          TBSYS_LOG(WARN, "invalid row modify slot=%ld", slots_[i].slot_);
+          ret = OB_DESERIALIZE_ERROR;
+        }
+      }
+      return ret;
+    }
+
+    DEFINE_GET_SERIALIZE_SIZE(ObRowModifySlots)
+    {
+      int64_t size = serialization::encoded_length_vi64(ups_epoch_)
+        + serialization::encoded_length_vi64(commited_trans_id_)
+        + serialization::encoded_length_bool(is_overflow_)
+        + serialization::encoded_length_vi64(slot_count_);
+      for (int64_t i = 0; i < slot_count_; ++i)
+      {
+        size += serialization::encoded_length_vi64(slots_[i].slot_);
+        size += serialization::encoded_length_vi64(slots_[i].trans_id_);
+      }
+      return size;
+    }
+  } // end namespace common
+} // end namespace oceanbase
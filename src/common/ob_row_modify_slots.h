@@ -0,0 +1,127 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_row_modify_slots.h for the row modify slots which updateserver
+ * reports to chunkserver to validate cached fused rows.
+ *
+ */
+#ifndef OCEANBASE_COMMON_OB_ROW_MODIFY_SLOTS_H_
+#define OCEANBASE_COMMON_OB_ROW_MODIFY_SLOTS_H_
+
+#include "ob_define.h"
+#include "ob_rowkey.h"
+#include "murmur_hash.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    /**
+     * rows are hashed into ROW_MODIFY_SLOT_NUM slots by table id and
+     * rowkey, updateserver remembers the trans id of the last commited
+     * mutation of each slot. a row modified after trans id T must
+     * have its slot's trans id greater than T.
+     */
+    static const int64_t ROW_MODIFY_SLOT_NUM = 1 << 14;
+
+    inline int64_t get_row_modify_slot(const uint64_t table_id, const ObRowkey& rowkey)
+    {
+      uint32_t hash_val = murmurhash2(&table_id, static_cast<int32_t>(sizeof(table_id)), 0);
+      hash_val = rowkey.murmurhash2(hash_val);
+      return static_cast<int64_t>(hash_val & (ROW_MODIFY_SLOT_NUM - 1));
+    }
+
+    struct ObRowModifySlot
+    {
+      int64_t slot_;
+      int64_t trans_id_;
+    };
+
+    /**
+     * the slots modified after last_trans_id, which chunkserver sends
+     * in the request, plus the commited trans id of updateserver when
+     * the slots are collected. all mutations with trans id not greater
+     * than commited_trans_id have been recorded in the slots.
+     *
+     * if too many slots are modified, is_overflow is set and the slots
+     * are not returned, the receiver should treat all slots modified.
+     */
+    class ObRowModifySlots
+    {
+      public:
+        static const int64_t MAX_SLOT_COUNT = 4096;
+
+      public:
+        ObRowModifySlots();
+        ~ObRowModifySlots();
+
+        void reset();
+
+        /**
+         * @return OB_SIZE_OVERFLOW if MAX_SLOT_COUNT slots were added,
+         *         is_overflow is set in this case.
+         */
+        int add_slot(const int64_t slot, const int64_t trans_id);
+
+        inline int64_t get_slot_count() const
+        {
+          return slot_count_;
+        }
+
+        inline const ObRowModifySlot& get_slot(const int64_t index) const
+        {
+          return slots_[index];
+        }
+
+        inline void set_ups_epoch(const int64_t ups_epoch)
+        {
+          ups_epoch_ = ups_epoch;
+        }
+
+        inline int64_t get_ups_epoch() const
+        {
+          return ups_epoch_;
+        }
+
+        inline void set_commited_trans_id(const int64_t commited_trans_id)
+        {
+          commited_trans_id_ = commited_trans_id;
+        }
+
+        inline int64_t get_commited_trans_id() const
+        {
+          return commited_trans_id_;
+        }
+
+        inline void set_overflow()
+        {
+          is_overflow_ = true;
+          slot_count_ = 0;
+        }
+
+        inline bool is_overflow() const
+        {
+          return is_overflow_;
+        }
+
+        NEED_SERIALIZE_AND_DESERIALIZE;
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObRowModifySlots);
+
+        int64_t ups_epoch_;
+        int64_t commited_trans_id_;
+        bool is_overflow_;
+        int64_t slot_count_;
+        ObRowModifySlot slots_[MAX_SLOT_COUNT];
+    };
+  } // end namespace common
+} // end namespace oceanbase
+
+#endif //OCEANBASE_COMMON_OB_ROW_MODIFY_SLOTS_H_
@@ -478,7 +478,7 @@ int ObRowStore::get_next_row(ObRow &row, common::ObString *compact_row /* = NULL
   return get_next_row(NULL, NULL, row, compact_row);
 }
 
-int ObRowStore::get_next_row(ObRowkey *rowkey, ObObj *rowkey_obj, ObRow &row, common::ObString *compact_row)
+int ObRowStore::get_next_compact_row(common::ObString &compact_row)
 {
   int ret = OB_SUCCESS;
   const StoredRow *stored_row = NULL;
@@ -501,47 +501,55 @@ int ObRowStore::get_next_row(ObRowkey *rowkey, ObObj *rowkey_obj, ObRow &row, co
     cur_iter_pos_ += (get_reserved_cells_size(stored_row->reserved_cells_count_) + stored_row->compact_row_size_);
     //TBSYS_LOG(DEBUG, "stored_row->reserved_cells_count_=%d, stored_row->compact_row_size_=%d, sizeof(ObObj)=%lu, next_pos_=%ld",
     //stored_row->reserved_cells_count_, stored_row->compact_row_size_, sizeof(ObObj), cur_iter_pos_);
+    compact_row = stored_row->get_compact_row();
+  }
+  return ret;
+}
 
-    if (OB_SUCCESS == ret && NULL != stored_row)
+int ObRowStore::get_next_row(ObRowkey *rowkey, ObObj *rowkey_obj, ObRow &row, common::ObString *compact_row)
+{
+  int ret = OB_SUCCESS;
+  ObString cur_compact_row;
+
+  if (OB_SUCCESS == (ret = get_next_compact_row(cur_compact_row)))
+  {
+    ObUpsRow *ups_row = dynamic_cast<ObUpsRow*>(&row);
+    if (NULL != ups_row)
     {
-      ObUpsRow *ups_row = dynamic_cast<ObUpsRow*>(&row);
-      if (NULL != ups_row)
-      {
-        const ObRowDesc *row_desc = row.get_row_desc();
-        uint64_t table_id = OB_INVALID_ID;
-        uint64_t column_id = OB_INVALID_ID;
+      const ObRowDesc *row_desc = row.get_row_desc();
+      uint64_t table_id = OB_INVALID_ID;
+      uint64_t column_id = OB_INVALID_ID;
 
-        if(NULL == row_desc)
-        {
-          ret = OB_INVALID_ARGUMENT;
-          TBSYS_LOG(WARN, "row should set row desc first");
-        }
-        else if(OB_SUCCESS != (ret = row_desc->get_tid_cid(0, table_id, column_id)))
-        {
-          TBSYS_LOG(WARN, "get tid cid fail:ret[%d]", ret);
-        }
-        else if (OB_SUCCESS != (ret = ObUpsRowUtil::convert(table_id, stored_row->get_compact_row(), *ups_row, rowkey, rowkey_obj)))
-        {
-          TBSYS_LOG(WARN, "fail to convert compact row to ObUpsRow. ret=%d", ret);
-        }
+      if(NULL == row_desc)
+      {
+        ret = OB_INVALID_ARGUMENT;
+        TBSYS_LOG(WARN, "row should set row desc first");
       }
-      else
+      else if(OB_SUCCESS != (ret = row_desc->get_tid_cid(0, table_id, column_id)))
       {
-        if(OB_SUCCESS != (ret = ObRowUtil::convert(stored_row->get_compact_row(), row, rowkey, rowkey_obj)))
-        {
-          TBSYS_LOG(WARN, "fail to convert compact row to ObRow:ret[%d]", ret);
-        }
+        TBSYS_LOG(WARN, "get tid cid fail:ret[%d]", ret);
       }
-      if (OB_SUCCESS == ret && NULL != compact_row)
+      else if (OB_SUCCESS != (ret = ObUpsRowUtil::convert(table_id, cur_compact_row, *ups_row, rowkey, rowkey_obj)))
       {
-        *compact_row = stored_row->get_compact_row();
+        TBSYS_LOG(WARN, "fail to convert compact row to ObUpsRow. ret=%d", ret);
       }
     }
     else
     {
-      TBSYS_LOG(WARN, "fail to get next row. stored_row=%p, ret=%d", stored_row, ret);
+      if(OB_SUCCESS != (ret = ObRowUtil::convert(cur_compact_row, row, rowkey, rowkey_obj)))
+      {
+        TBSYS_LOG(WARN, "fail to convert compact row to ObRow:ret[%d]", ret);
+      }
+    }
+    if (OB_SUCCESS == ret && NULL != compact_row)
+    {
+      *compact_row = cur_compact_row;
     }
   }
+  else if (OB_ITER_END != ret)
+  {
+    TBSYS_LOG(WARN, "fail to get next row. ret=%d", ret);
+  }
 
   return ret;
 }
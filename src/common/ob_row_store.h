@@ -95,6 +95,8 @@ namespace oceanbase
         int get_next_row(const ObRowkey *&rowkey, ObRow &row, common::ObString *compact_row = NULL);
         int get_next_ups_row(ObUpsRow &row, common::ObString *compact_row = NULL);
         int get_next_ups_row(const ObRowkey *&rowkey, ObUpsRow &row, common::ObString *compact_row = NULL);
+        /// get the next row in compact format without converting it, the row is valid until the store is cleared
+        int get_next_compact_row(common::ObString &compact_row);
         void reset_iterator();
 
         int64_t to_string(char* buf, const int64_t buf_len) const;
@@ -127,16 +127,64 @@ namespace oceanbase
         T* tail_;
     };
 
+    // 按线程分散到不同cache line上累加, 读的时候求和; 适合写多读少的统计
+    class ObStripedCounter
+    {
+      public:
+        static const int64_t STRIPE_NUM = 64;
+        ObStripedCounter() { reset(); }
+        ~ObStripedCounter() {}
+      public:
+        void reset()
+        {
+          for (int64_t i = 0; i < STRIPE_NUM; i++)
+          {
+            stripes_[i].value_ = 0;
+          }
+        }
+        void add(const int64_t delta)
+        {
+          __sync_fetch_and_add(&stripes_[get_stripe_idx_()].value_, delta);
+        }
+        int64_t value() const
+        {
+          int64_t sum = 0;
+          for (int64_t i = 0; i < STRIPE_NUM; i++)
+          {
+            sum += stripes_[i].value_;
+          }
+          return sum;
+        }
+      private:
+        static int64_t get_stripe_idx_()
+        {
+          static volatile int64_t thread_seq = 0;
+          static __thread int64_t stripe_idx = -1;
+          if (0 > stripe_idx)
+          {
+            stripe_idx = __sync_fetch_and_add(&thread_seq, 1) % STRIPE_NUM;
+          }
+          return stripe_idx;
+        }
+      private:
+        struct Stripe
+        {
+          volatile int64_t value_;
+        } CACHE_ALIGNED;
+        Stripe stripes_[STRIPE_NUM];
+    };
+
     template<typename Allocator>
     class ObHandyAllocatorWrapper: public Allocator
     {
       public:
-        ObHandyAllocatorWrapper(): allocated_(0) {}
+        ObHandyAllocatorWrapper() {}
         ~ObHandyAllocatorWrapper() {}
       private:
-        volatile int64_t allocated_;
+        // 多个写线程同时分配时共享一个计数器会成为热点
+        ObStripedCounter allocated_;
       public:
-        int64_t get_alloc_size() const { return allocated_; }
+        int64_t get_alloc_size() const { return allocated_.value(); }
         void* alloc(const int64_t size)
         {
           int err = OB_SUCCESS;
@@ -147,7 +195,7 @@ namespace oceanbase
           }
           else
           {
-            __sync_fetch_and_add(&allocated_, size);
+            allocated_.add(size);
           }
           return p;
         }
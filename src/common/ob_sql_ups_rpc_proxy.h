@@ -26,6 +26,24 @@ namespace oceanbase
 {
   namespace common
   {
+    // UPS保留的流式扫描, session_id_为0表示没有可以续读的流
+    struct ObUpsScanSession
+    {
+      ObServer server_;
+      int64_t session_id_;
+
+      ObUpsScanSession() : server_(), session_id_(0) {}
+      void reset()
+      {
+        server_.reset();
+        session_id_ = 0;
+      }
+      bool is_valid() const
+      {
+        return 0 != session_id_;
+      }
+    };
+
     class ObSqlUpsRpcProxy
     {
       public:
@@ -33,6 +51,28 @@ namespace oceanbase
 
         virtual int sql_ups_get(const ObGetParam & get_param, ObNewScanner & new_scanner, const int64_t timeout) = 0;
         virtual int sql_ups_scan(const ObScanParam & scan_param, ObNewScanner & new_scanner, const int64_t timeout) = 0;
+
+        // 扫描第一页, UPS支持时在session中返回流式扫描的session id,
+        // 不支持流式扫描的实现退化为普通扫描
+        virtual int sql_ups_stream_scan(const ObScanParam & scan_param, ObNewScanner & new_scanner,
+            ObUpsScanSession & session, const int64_t timeout)
+        {
+          session.reset();
+          return sql_ups_scan(scan_param, new_scanner, timeout);
+        }
+        // 从流中读取下一页, 失败时调用者从last rowkey重新扫描
+        virtual int sql_ups_stream_next(const ObUpsScanSession & session, ObNewScanner & new_scanner, const int64_t timeout)
+        {
+          UNUSED(session);
+          UNUSED(new_scanner);
+          UNUSED(timeout);
+          return OB_NOT_SUPPORTED;
+        }
+        // 提前结束流, 释放UPS上的迭代器和session
+        virtual void sql_ups_stream_end(const ObUpsScanSession & session)
+        {
+          UNUSED(session);
+        }
     };
   }
 }
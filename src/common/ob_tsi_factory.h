@@ -105,6 +105,7 @@ namespace oceanbase
       TSI_UPS_MUTATOR_1,
       TSI_UPS_SCANNER_ARRAY_1,
       TSI_UPS_UPS_MUTATOR_1,
+      TSI_UPS_UPS_MUTATOR_2,
       TSI_UPS_TABLE_UTILS_SET_1,
       TSI_UPS_COLUMN_FILTER_1,
       TSI_UPS_COLUMN_MAP_1,
@@ -115,6 +116,7 @@ namespace oceanbase
       TSI_UPS_FIXED_SIZE_BUFFER_1,
       TSI_UPS_FIXED_SIZE_BUFFER_2,
       TSI_UPS_SQL_SCAN_PARAM_1,
+      TSI_UPS_ROW_MODIFY_SLOTS_1,
     };
 
     enum TSIMergeserverType
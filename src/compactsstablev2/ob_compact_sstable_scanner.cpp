@@ -939,8 +939,10 @@ namespace oceanbase
             bool need_looking_forward = false;
             ObSSTableBlockReader::BlockData block_data(internal_buf_, internal_buf_size_, block_data_ptr, block_data_size);
 
+            //encoded block only decodes the scanned columns
             ret = block_scanner_.set_scan_param(sstable_scan_param_->get_range(), sstable_scan_param_->is_reverse_scan(),
-                block_data, row_store_type, need_looking_forward);
+                block_data, row_store_type, need_looking_forward,
+                DENSE_DENSE_NORMAL_ROW_SCAN == scan_flag_ ? &scan_column_indexes_ : NULL);
             if (OB_SUCCESS == ret)
             {
               advance_to_next_block();
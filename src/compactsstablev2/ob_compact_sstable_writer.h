@@ -133,6 +133,16 @@ namespace oceanbase
           const int64_t def_sstable_size,
           const int64_t min_split_sstable_size = 0);
 
+      /**
+       * encode the DENSE_DENSE blocks(prefix compressed rowkeys and
+       * column encoding), the block is stored encoded only if it
+       * gets smaller
+       */
+      inline void set_block_encoding(const bool block_encoding)
+      {
+        block_.set_block_encoding(block_encoding);
+      }
+
       /**
        * set table info
        * --init the table
@@ -1986,7 +1986,7 @@ namespace oceanbase
       dataindex_key.offset_ = offset;
       dataindex_key.size_ = nbyte;
 
-      ret = block_cache_->get_kv_cache().put(dataindex_key, value, false);
+      ret = block_cache_->get_kv_cache().put(dataindex_key, value, false, true);
 
       return  ret;
     }
@@ -2113,7 +2113,7 @@ namespace oceanbase
             else
             {
               value.nbyte_ = dataindex_key.size_;
-              status = block_cache_->get_kv_cache().put(dataindex_key, value);
+              status = block_cache_->get_kv_cache().put(dataindex_key, value, true, true);
               if (OB_SUCCESS != status && OB_ENTRY_EXIST != status)
               {
                 TBSYS_LOG(WARN, "failed to copy block data to cache, status=%d", status);
@@ -77,6 +77,11 @@ namespace oceanbase
         block_builder_.set_row_store_type(row_store_type);
       }
 
+      inline void set_block_encoding(const bool block_encoding)
+      {
+        block_builder_.set_block_encoding(block_encoding);
+      }
+
       inline int32_t get_row_count()
       {
         return block_builder_.get_row_count();
@@ -301,6 +301,29 @@ namespace oceanbase
         size = row_length_;
       }
 
+      if (OB_SUCCESS == ret && block_encoding_ && DENSE_DENSE == row_store_type_)
+      {
+        char* encoded_buf = NULL;
+        int64_t encoded_size = 0;
+        int err = encoder_.encode(row_buf_,
+            reinterpret_cast<const ObSSTableBlockRowIndex*>(row_index_buf_),
+            block_header_.row_count_, encoded_buf, encoded_size);
+        if (OB_SUCCESS == err)
+        {
+          if (encoded_size < size)
+          {
+            buf = encoded_buf;
+            size = encoded_size;
+          }
+        }
+        else if (OB_NOT_SUPPORTED != err)
+        {
+          //keep the normal block
+          TBSYS_LOG(WARN, "encode block error:err=%d,row_count=%d",
+              err, block_header_.row_count_);
+        }
+      }
+
       return ret;
     }
 
@@ -8,6 +8,7 @@
 #include "common/ob_row.h"
 #include "common/ob_rowkey.h"
 #include "ob_sstable_store_struct.h"
+#include "ob_sstable_block_encoding.h"
 #include "common/ob_compact_store_type.h"
 
 class TestSSTableBlockBuilder_construction_Test;
@@ -47,7 +48,8 @@ namespace oceanbase
           row_buf_size_(0),
           row_index_buf_(NULL), 
           row_index_length_(0),
-          row_index_buf_size_(0)
+          row_index_buf_size_(0),
+          block_encoding_(false)
       {
         int ret = common::OB_SUCCESS;
         if (common::OB_SUCCESS != (ret = reset()))
@@ -136,6 +138,12 @@ namespace oceanbase
         row_store_type_ = row_store_type;
       }
 
+      //encode DENSE_DENSE block if the encoded block is smaller
+      inline void set_block_encoding(const bool block_encoding)
+      {
+        block_encoding_ = block_encoding;
+      }
+
     private:     
       ObSSTableBlockHeader block_header_;
       common::ObCompactStoreType row_store_type_;
@@ -147,6 +155,9 @@ namespace oceanbase
       char* row_index_buf_;
       int64_t row_index_length_;
       int64_t row_index_buf_size_;
+
+      bool block_encoding_;
+      ObSSTableBlockEncoder encoder_;
     };
   }//end namespace compactsstablev2
 }//end namespace oceanbase
@@ -1,4 +1,5 @@
 #include "common/ob_common_stat.h"
+#include "sstable/ob_disk_path.h"
 #include "ob_sstable_block_cache.h"
 
 using namespace oceanbase::common;
@@ -7,6 +8,54 @@ namespace oceanbase
 {
   namespace compactsstablev2
   {
+    class ObSSTableBlockPrefetchCallback : public ObDiskIOCallback
+    {
+    public:
+      ObSSTableBlockPrefetchCallback(ObSSTableBlockCache::KVCache& kv_cache,
+          IFileInfoMgr& fileinfo_cache, const IFileInfo* file_info,
+          const ObSSTableBlockCacheKey& key)
+        : kv_cache_(kv_cache),
+          fileinfo_cache_(fileinfo_cache),
+          file_info_(file_info),
+          key_(key)
+      {
+      }
+
+      virtual void on_io_complete(const int err, const char* buf, const int64_t size)
+      {
+        int status = err;
+        ObSSTableBlockCacheValue value;
+        if (OB_SUCCESS == status)
+        {
+          value.nbyte_ = size;
+          value.buffer_ = const_cast<char*>(buf);
+          status = ObRecordHeaderV2::check_record(value.buffer_,
+              value.nbyte_, OB_SSTABLE_BLOCK_DATA_MAGIC);
+        }
+        if (OB_SUCCESS == status)
+        {
+          status = kv_cache_.put(key_, value, false);
+        }
+        if (OB_SUCCESS != status && OB_ENTRY_EXIST != status)
+        {
+          TBSYS_LOG(WARN, "prefetch block error:sstable_id=%lu,offset=%ld,"
+              "size=%ld,status=%d", key_.sstable_id_, key_.offset_,
+              key_.size_, status);
+        }
+        fileinfo_cache_.revert_fileinfo(file_info_);
+        this->~ObSSTableBlockPrefetchCallback();
+        ob_free(this);
+      }
+
+      ObDiskIORequest request_;
+
+    private:
+      ObSSTableBlockCache::KVCache& kv_cache_;
+      IFileInfoMgr& fileinfo_cache_;
+      const IFileInfo* file_info_;
+      ObSSTableBlockCacheKey key_;
+    };
+
     int ObSSTableBlockCache::init(const int64_t cache_mem_size)
     {
       int ret = OB_SUCCESS;
@@ -110,7 +159,7 @@ namespace oceanbase
         data_index.size_ = nbyte;
 
         if (OB_SUCCESS == kv_cache_.get(data_index, value, 
-              buffer_handle.handle_, true))
+              buffer_handle.handle_, true, true))
         {
           buffer_handle.block_cache_ = this;
           buffer_handle.buffer_ = value.buffer_;
@@ -227,6 +276,95 @@ namespace oceanbase
       return ret;
     }
 
+    int ObSSTableBlockCache::prefetch_block(const uint64_t sstable_id,
+        const int64_t offset,
+        const int64_t nbyte,
+        const uint64_t table_id,
+        const int priority/*=DISK_IO_PRIORITY_GET*/)
+    {
+      int ret = OB_SUCCESS;
+      int32_t disk_no = static_cast<int32_t>(sstable_id & DISK_NO_MASK);
+      const IFileInfo* file_info = NULL;
+      void* cb_buf = NULL;
+      ObSSTableBlockPrefetchCallback* callback = NULL;
+      ObSSTableBlockCacheKey key;
+      ObSSTableBlockCacheValue value;
+
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (NULL == fileinfo_cache_)
+      {
+        TBSYS_LOG(WARN, "file info cache is null");
+        ret = OB_ERROR;
+      }
+      else if (OB_INVALID_ID == sstable_id || offset < 0 || nbyte <= 0
+          || OB_INVALID_ID == table_id || 0 == table_id)
+      {
+        TBSYS_LOG(WARN, "invalid param:sstable_id=%lu, "
+            "offset=%ld, nbyte=%ld, table_id=%lu",
+            sstable_id, offset, nbyte, table_id);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (NULL == io_engine_ || !io_engine_->has_disk(disk_no))
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else
+      {
+        key.sstable_id_ = sstable_id;
+        key.offset_ = offset;
+        key.size_ = nbyte;
+
+        if (OB_SUCCESS == kv_cache_.get(key, value, false))
+        {
+          //in cache
+        }
+        else if (NULL == (file_info = fileinfo_cache_->get_fileinfo(sstable_id)))
+        {
+          TBSYS_LOG(WARN, "get fileinfo error:sstable_id=%lu", sstable_id);
+          ret = OB_ERROR;
+        }
+        else if (NULL == (cb_buf = ob_malloc(sizeof(ObSSTableBlockPrefetchCallback),
+                ObModIds::OB_SSTABLE_AIO)))
+        {
+          TBSYS_LOG(WARN, "ob malloc error:size=%ld",
+              sizeof(ObSSTableBlockPrefetchCallback));
+          fileinfo_cache_->revert_fileinfo(file_info);
+          ret = OB_ALLOCATE_MEMORY_FAILED;
+        }
+        else
+        {
+          callback = new (cb_buf) ObSSTableBlockPrefetchCallback(kv_cache_,
+              *fileinfo_cache_, file_info, key);
+          callback->request_.fd = file_info->get_fd();
+          callback->request_.offset = offset;
+          callback->request_.size = nbyte;
+          callback->request_.priority = priority;
+          callback->request_.callback = callback;
+          if (OB_SUCCESS != (ret = io_engine_->submit(disk_no, callback->request_)))
+          {
+            TBSYS_LOG(WARN, "io engine submit error:ret=%d,sstable_id=%lu,"
+                "offset=%ld,nbyte=%ld", ret, sstable_id, offset, nbyte);
+            callback->~ObSSTableBlockPrefetchCallback();
+            ob_free(cb_buf);
+            fileinfo_cache_->revert_fileinfo(file_info);
+          }
+#ifndef _SSTABLE_NO_STAT_
+          else
+          {
+            OB_STAT_TABLE_INC(SSTABLE, table_id, INDEX_DISK_IO_NUM, 1);
+            OB_STAT_TABLE_INC(SSTABLE, table_id, INDEX_DISK_IO_BYTES, nbyte);
+          }
+#endif
+        }
+      }
+
+      return ret;
+    }
+
     int ObSSTableBlockCache::get_block_readahead(const uint64_t sstable_id,
         const uint64_t table_id,
         const ObBlockPositionInfos& block_infos,
@@ -259,7 +397,7 @@ namespace oceanbase
         key.size_ = current_block.size_;
 
         if (OB_SUCCESS == kv_cache_.get(key, output_value, 
-                buffer_handle.handle_, true))
+                buffer_handle.handle_, true, true))
         {
           buffer_handle.block_cache_ = this;
           buffer_handle.buffer_ = output_value.buffer_;
@@ -326,7 +464,8 @@ namespace oceanbase
           {
             readahead_offset = block_infos.position_info_[start_cursor].offset_;
             status = read_record(*fileinfo_cache_, sstable_id,
-                readahead_offset, readahead_size, record_buf);
+                readahead_offset, readahead_size, record_buf,
+                DISK_IO_PRIORITY_SCAN);
 #ifndef _SSTABLE_NO_STAT_
             OB_STAT_TABLE_INC(SSTABLE, table_id, INDEX_BLOCK_CACHE_MISS, 1);
             OB_STAT_TABLE_INC(SSTABLE, table_id, INDEX_DISK_IO_NUM, 1);
@@ -367,7 +506,7 @@ namespace oceanbase
               if (cursor == i)
               {
                 status = kv_cache_.put_and_fetch(key, input_value,
-                    output_value, buffer_handle.handle_, false, false);
+                    output_value, buffer_handle.handle_, false, false, true);
                 if (OB_SUCCESS == status)
                 {
                   buffer_handle.block_cache_ = this;
@@ -386,7 +525,7 @@ namespace oceanbase
               }
               else
               {
-                kv_cache_.put(key, input_value, false);
+                kv_cache_.put(key, input_value, false, true);
               }
               inner_offset += block_infos.position_info_[i].size_;
             }//end for
@@ -465,11 +604,14 @@ namespace oceanbase
         const uint64_t sstable_id,
         const int64_t offset,
         const int64_t size,
-        const char*& out_buffer)
+        const char*& out_buffer,
+        const int priority/*=DISK_IO_PRIORITY_GET*/)
     {
       int ret = OB_SUCCESS;
       ObFileBuffer* file_buf = GET_TSI_MULT(ObFileBuffer, 
           TSI_COMPACTSSTABLEV2_FILE_BUFFER_1);
+      int32_t disk_no = static_cast<int32_t>(sstable_id & DISK_NO_MASK);
+      const IFileInfo* file_info = NULL;
       out_buffer = NULL;
 
       if (NULL == file_buf)
@@ -477,6 +619,36 @@ namespace oceanbase
         TBSYS_LOG(WARN, "NULL==file_buf");
         ret = OB_ERROR;
       }
+      else if (NULL != io_engine_ && io_engine_->has_disk(disk_no))
+      {
+        if (NULL == (file_info = fileinfo_cache.get_fileinfo(sstable_id)))
+        {
+          TBSYS_LOG(WARN, "get fileinfo error:sstable_id=%lu", sstable_id);
+          ret = OB_ERROR;
+        }
+        else
+        {
+          if (OB_SUCCESS != (ret = file_buf->assign(size)))
+          {
+            TBSYS_LOG(WARN, "file buffer assign error:ret=%d,size=%ld",
+                ret, size);
+          }
+          else if (OB_SUCCESS != (ret = io_engine_->read(disk_no,
+                  file_info->get_fd(), offset, size,
+                  file_buf->get_buffer(), priority)))
+          {
+            TBSYS_LOG(WARN, "io engine read error:ret=%d,"
+                "sstable_id=%lu,offset=%ld,size=%ld",
+                ret, sstable_id, offset, size);
+          }
+          else
+          {
+            file_buf->set_base_pos(0);
+            out_buffer = file_buf->get_buffer();
+          }
+          fileinfo_cache.revert_fileinfo(file_info);
+        }
+      }
       else if (OB_SUCCESS != (ret = ObFileReader::read_record(fileinfo_cache, 
               sstable_id, offset, size, *file_buf)))
       {
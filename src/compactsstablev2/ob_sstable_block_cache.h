@@ -5,6 +5,7 @@
 #include "common/murmur_hash.h"
 #include "common/ob_kv_storecache.h"
 #include "common/ob_fileinfo_manager.h"
+#include "common/ob_disk_io_engine.h"
 #include "ob_sstable_aio_buffer_mgr.h"
 #include "common/ob_record_header_v2.h"
 #include "compactsstablev2/ob_sstable_block_index_mgr.h"
@@ -118,13 +119,15 @@ namespace oceanbase
     public:
       ObSSTableBlockCache()
         : inited_(false),
-          fileinfo_cache_(NULL)
+          fileinfo_cache_(NULL),
+          io_engine_(NULL)
       {
       }
 
       ObSSTableBlockCache(common::IFileInfoMgr& fileinfo_cache)
         : inited_(false),
-          fileinfo_cache_(&fileinfo_cache)
+          fileinfo_cache_(&fileinfo_cache),
+          io_engine_(NULL)
       {
       }
 
@@ -212,6 +215,17 @@ namespace oceanbase
           const uint64_t table_id,
           const bool check_crc = true);
 
+      /**
+       * submit an async read of the block to disk io engine if it
+       * isn't in cache, the block is put into cache when io complete
+       * @return OB_NOT_SUPPORTED if disk io engine isn't set
+       */
+      int prefetch_block(const uint64_t sstable_id,
+          const int64_t offset,
+          const int64_t nbyte,
+          const uint64_t table_id,
+          const int priority = common::DISK_IO_PRIORITY_GET);
+
       /**
        * if using the default constructor, must call this function to 
        * set the file info cache 
@@ -228,6 +242,14 @@ namespace oceanbase
         return *fileinfo_cache_;
       }
 
+      /**
+       * read missed blocks by disk io engine instead of pread
+       */
+      inline void set_io_engine(common::ObDiskIOEngine* io_engine)
+      {
+        io_engine_ = io_engine;
+      }
+
       inline KVCache& get_kv_cache()
       {
         return kv_cache_;
@@ -238,7 +260,8 @@ namespace oceanbase
           const uint64_t sstable_id,
           const int64_t offset,
           const int64_t size,
-          const char*& out_buffer);
+          const char*& out_buffer,
+          const int priority = common::DISK_IO_PRIORITY_GET);
 
       ObAIOBufferMgr* get_aio_buf_mgr(const uint64_t sstable_id,
           const uint64_t table_id,
@@ -247,6 +270,7 @@ namespace oceanbase
     private:
       bool inited_;
       common::IFileInfoMgr* fileinfo_cache_;
+      common::ObDiskIOEngine* io_engine_;
       KVCache kv_cache_;
     };
 
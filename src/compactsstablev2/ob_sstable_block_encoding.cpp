@@ -0,0 +1,981 @@
+#include "common/ob_compact_cell_iterator.h"
+#include "common/ob_compact_cell_writer.h"
+#include "ob_sstable_block_encoding.h"
+
+using namespace oceanbase::common;
+
+namespace oceanbase
+{
+  namespace compactsstablev2
+  {
+    static inline int64_t align8(const int64_t offset)
+    {
+      return (offset + 7) & ~7L;
+    }
+
+    int ObSSTableBlockEncoder::encode(const char* row_buf,
+        const ObSSTableBlockRowIndex* row_index,
+        const int64_t row_count, char*& buf, int64_t& size)
+    {
+      int ret = OB_SUCCESS;
+      ObSSTableBlockHeader block_header;
+      ObSSTableEncodedBlockHeader header;
+      ObSSTableEncodedColumnMeta* metas = NULL;
+      int64_t key_size = 0;
+      int64_t total_size = 0;
+      char* block = NULL;
+
+      if (NULL == row_buf || NULL == row_index || row_count <= 0)
+      {
+        TBSYS_LOG(WARN, "invalid argument:row_buf=%p,row_index=%p,"
+            "row_count=%ld", row_buf, row_index, row_count);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (ret = parse_rows(row_buf, row_index, row_count)))
+      {
+        if (OB_NOT_SUPPORTED != ret)
+        {
+          TBSYS_LOG(WARN, "parse rows error:ret=%d,row_count=%ld",
+              ret, row_count);
+        }
+      }
+      else if (max_rowkey_length_ > MAX_PREFIX_KEY_LENGTH)
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else if (OB_SUCCESS != (ret = metas_buf_.ensure_space(
+              column_count_ * sizeof(ObSSTableEncodedColumnMeta),
+              ObModIds::OB_SSTABLE_WRITER)))
+      {
+        TBSYS_LOG(WARN, "alloc column metas error:ret=%d,column_count_=%ld",
+            ret, column_count_);
+      }
+      else
+      {
+        //rowkeys
+        for (int64_t i = 0; i < row_count_; i ++)
+        {
+          int64_t shared = 0;
+          if (0 != i % RESTART_INTERVAL)
+          {
+            const CellRef& prev = rowkey(i - 1);
+            const CellRef& cur = rowkey(i);
+            while (shared < prev.length_ && shared < cur.length_
+                && row_buf_[prev.offset_ + shared] == row_buf_[cur.offset_ + shared])
+            {
+              shared ++;
+            }
+          }
+          key_size += 2 * sizeof(uint16_t) + rowkey(i).length_ - shared;
+        }
+
+        header.restart_interval_ = static_cast<int32_t>(RESTART_INTERVAL);
+        header.restart_count_ = static_cast<int32_t>(
+            (row_count_ + RESTART_INTERVAL - 1) / RESTART_INTERVAL);
+        header.restart_offset_ = static_cast<int32_t>(align8(
+              sizeof(ObSSTableBlockHeader) + sizeof(ObSSTableEncodedBlockHeader)
+              + key_size));
+        header.column_count_ = static_cast<int32_t>(column_count_);
+        header.column_meta_offset_ = static_cast<int32_t>(align8(
+              header.restart_offset_ + header.restart_count_ * sizeof(int32_t)));
+        header.max_rowkey_length_ = static_cast<int32_t>(max_rowkey_length_);
+        header.max_row_length_ = static_cast<int32_t>(max_row_length_);
+
+        //column metas
+        metas = reinterpret_cast<ObSSTableEncodedColumnMeta*>(
+            metas_buf_.get_buffer());
+        total_size = header.column_meta_offset_
+          + column_count_ * sizeof(ObSSTableEncodedColumnMeta);
+        for (int64_t i = 0; OB_SUCCESS == ret && i < column_count_; i ++)
+        {
+          total_size = align8(total_size);
+          if (OB_SUCCESS != (ret = choose_encoding(i, metas[i])))
+          {
+            TBSYS_LOG(WARN, "choose encoding error:ret=%d,column=%ld", ret, i);
+          }
+          else
+          {
+            metas[i].offset_ = static_cast<int32_t>(total_size);
+            total_size += metas[i].length_;
+          }
+        }
+
+        if (OB_SUCCESS != ret)
+        {
+          //do nothing
+        }
+        else if (total_size > INT32_MAX)
+        {
+          ret = OB_NOT_SUPPORTED;
+        }
+        else if (OB_SUCCESS != (ret = block_buf_.ensure_space(total_size,
+                ObModIds::OB_SSTABLE_WRITER)))
+        {
+          TBSYS_LOG(WARN, "alloc block buf error:ret=%d,total_size=%ld",
+              ret, total_size);
+        }
+        else
+        {
+          block = block_buf_.get_buffer();
+          memset(block, 0, total_size);
+
+          //block header, the row index of normal block is not needed
+          block_header.row_index_offset_ = static_cast<int32_t>(total_size);
+          block_header.row_count_ = static_cast<int32_t>(row_count_);
+          block_header.block_format_ = OB_SSTABLE_BLOCK_FORMAT_ENCODED;
+          memcpy(block, &block_header, sizeof(block_header));
+          memcpy(block + sizeof(block_header), &header, sizeof(header));
+
+          //rowkeys and restart points
+          int64_t pos = sizeof(block_header) + sizeof(header);
+          for (int64_t i = 0; i < row_count_; i ++)
+          {
+            const CellRef& cur = rowkey(i);
+            uint16_t shared = 0;
+            uint16_t unshared = 0;
+            if (0 == i % RESTART_INTERVAL)
+            {
+              int32_t restart = static_cast<int32_t>(pos);
+              memcpy(block + header.restart_offset_
+                  + (i / RESTART_INTERVAL) * sizeof(int32_t),
+                  &restart, sizeof(restart));
+            }
+            else
+            {
+              const CellRef& prev = rowkey(i - 1);
+              while (shared < prev.length_ && shared < cur.length_
+                  && row_buf_[prev.offset_ + shared] == row_buf_[cur.offset_ + shared])
+              {
+                shared ++;
+              }
+            }
+            unshared = static_cast<uint16_t>(cur.length_ - shared);
+            memcpy(block + pos, &shared, sizeof(shared));
+            memcpy(block + pos + sizeof(shared), &unshared, sizeof(unshared));
+            pos += 2 * sizeof(uint16_t);
+            memcpy(block + pos, row_buf_ + cur.offset_ + shared, unshared);
+            pos += unshared;
+          }
+
+          //column metas and datas
+          memcpy(block + header.column_meta_offset_, metas,
+              column_count_ * sizeof(ObSSTableEncodedColumnMeta));
+          for (int64_t i = 0; OB_SUCCESS == ret && i < column_count_; i ++)
+          {
+            if (OB_SUCCESS != (ret = write_column(i, metas[i],
+                    block + metas[i].offset_)))
+            {
+              TBSYS_LOG(WARN, "write column error:ret=%d,column=%ld,"
+                  "encoding=%d", ret, i, metas[i].encoding_);
+            }
+          }
+
+          if (OB_SUCCESS == ret)
+          {
+            buf = block;
+            size = total_size;
+          }
+        }
+      }
+
+      return ret;
+    }
+
+    int ObSSTableBlockEncoder::parse_rows(const char* row_buf,
+        const ObSSTableBlockRowIndex* row_index, const int64_t row_count)
+    {
+      int ret = OB_SUCCESS;
+      ObCompactCellIterator row;
+      const ObObj* obj = NULL;
+      bool is_row_finished = false;
+      int64_t cell_count = 0;
+
+      row_buf_ = row_buf;
+      row_count_ = row_count;
+      column_count_ = 0;
+      max_rowkey_length_ = 0;
+      max_row_length_ = 0;
+
+      //count the rowvalue columns with the first row
+      if (OB_SUCCESS != (ret = row.init(row_buf + row_index[0].row_offset_,
+              DENSE_DENSE)))
+      {
+        TBSYS_LOG(WARN, "row init error:ret=%d", ret);
+      }
+      while (OB_SUCCESS == ret && cell_count < 2)
+      {
+        if (OB_SUCCESS != (ret = row.next_cell()))
+        {
+          TBSYS_LOG(WARN, "row next cell error:ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = row.get_cell(obj, &is_row_finished)))
+        {
+          TBSYS_LOG(WARN, "row get cell error:ret=%d", ret);
+        }
+        else if (!is_row_finished)
+        {
+          //cells after the rowkey end flag are rowvalue columns
+          column_count_ += cell_count;
+        }
+        else
+        {
+          cell_count ++;
+          if (1 == cell_count && row.parsed_size()
+              >= row_index[1].row_offset_ - row_index[0].row_offset_)
+          {
+            //rowkey only row has no end flag of rowvalue, not worth encoding
+            ret = OB_NOT_SUPPORTED;
+          }
+        }
+      }
+
+      if (OB_SUCCESS != ret)
+      {
+        //do nothing
+      }
+      else if (0 == column_count_)
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else if (OB_SUCCESS != (ret = cells_buf_.ensure_space(
+              row_count_ * (column_count_ + 1) * sizeof(CellRef),
+              ObModIds::OB_SSTABLE_WRITER)))
+      {
+        TBSYS_LOG(WARN, "alloc cells buf error:ret=%d,row_count_=%ld,"
+            "column_count_=%ld", ret, row_count_, column_count_);
+      }
+      else if (OB_SUCCESS != (ret = stats_buf_.ensure_space(
+              column_count_ * sizeof(ColumnStat), ObModIds::OB_SSTABLE_WRITER)))
+      {
+        TBSYS_LOG(WARN, "alloc stats buf error:ret=%d,column_count_=%ld",
+            ret, column_count_);
+      }
+      else
+      {
+        cells_ = reinterpret_cast<CellRef*>(cells_buf_.get_buffer());
+        stats_ = reinterpret_cast<ColumnStat*>(stats_buf_.get_buffer());
+        for (int64_t i = 0; i < column_count_; i ++)
+        {
+          stats_[i].all_int_ = true;
+          stats_[i].min_int_ = INT64_MAX;
+          stats_[i].max_int_ = INT64_MIN;
+        }
+
+        for (int64_t i = 0; OB_SUCCESS == ret && i < row_count_; i ++)
+        {
+          ret = parse_row(i, row_buf, row_index[i].row_offset_,
+              row_index[i + 1].row_offset_ - row_index[i].row_offset_);
+        }
+      }
+
+      return ret;
+    }
+
+    int ObSSTableBlockEncoder::parse_row(const int64_t row, const char* row_buf,
+        const int64_t row_offset, const int64_t row_length)
+    {
+      int ret = OB_SUCCESS;
+      ObCompactCellIterator iter;
+      const ObObj* obj = NULL;
+      bool is_row_finished = false;
+      int64_t column = 0;
+      int64_t prev_size = 0;
+      int64_t value = 0;
+      CellRef* refs = cells_ + row * (column_count_ + 1);
+
+      if (OB_SUCCESS != (ret = iter.init(row_buf + row_offset, DENSE_DENSE)))
+      {
+        TBSYS_LOG(WARN, "row init error:ret=%d,row=%ld", ret, row);
+      }
+
+      //rowkey, with the end flag
+      while (OB_SUCCESS == ret && !is_row_finished)
+      {
+        if (OB_SUCCESS != (ret = iter.next_cell()))
+        {
+          TBSYS_LOG(WARN, "row next cell error:ret=%d,row=%ld", ret, row);
+        }
+        else if (OB_SUCCESS != (ret = iter.get_cell(obj, &is_row_finished)))
+        {
+          TBSYS_LOG(WARN, "row get cell error:ret=%d,row=%ld", ret, row);
+        }
+        else if (iter.parsed_size() >= row_length)
+        {
+          ret = OB_NOT_SUPPORTED;
+        }
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        prev_size = iter.parsed_size();
+        refs[0].offset_ = static_cast<int32_t>(row_offset);
+        refs[0].length_ = static_cast<int32_t>(prev_size);
+        if (prev_size > max_rowkey_length_)
+        {
+          max_rowkey_length_ = prev_size;
+        }
+        is_row_finished = false;
+      }
+
+      //rowvalue, the end flag is not stored
+      while (OB_SUCCESS == ret)
+      {
+        if (OB_SUCCESS != (ret = iter.next_cell()))
+        {
+          TBSYS_LOG(WARN, "row next cell error:ret=%d,row=%ld", ret, row);
+        }
+        else if (OB_SUCCESS != (ret = iter.get_cell(obj, &is_row_finished)))
+        {
+          TBSYS_LOG(WARN, "row get cell error:ret=%d,row=%ld", ret, row);
+        }
+        else if (is_row_finished)
+        {
+          break;
+        }
+        else if (column >= column_count_ || ObExtendType == obj->get_type()
+            || iter.parsed_size() >= row_length)
+        {
+          //the rows of the block must have the same columns
+          ret = OB_NOT_SUPPORTED;
+        }
+        else
+        {
+          refs[column + 1].offset_ = static_cast<int32_t>(row_offset + prev_size);
+          refs[column + 1].length_ = static_cast<int32_t>(iter.parsed_size() - prev_size);
+          prev_size = iter.parsed_size();
+          if (!stats_[column].all_int_)
+          {
+            //do nothing
+          }
+          else if (ObIntType != obj->get_type()
+              || OB_SUCCESS != obj->get_int(value))
+          {
+            stats_[column].all_int_ = false;
+          }
+          else
+          {
+            if (value < stats_[column].min_int_)
+            {
+              stats_[column].min_int_ = value;
+            }
+            if (value > stats_[column].max_int_)
+            {
+              stats_[column].max_int_ = value;
+            }
+          }
+          column ++;
+        }
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        if (column != column_count_ || iter.parsed_size() != row_length)
+        {
+          ret = OB_NOT_SUPPORTED;
+        }
+        else if (row_length > max_row_length_)
+        {
+          max_row_length_ = row_length;
+        }
+      }
+
+      return ret;
+    }
+
+    int ObSSTableBlockEncoder::choose_encoding(const int64_t column,
+        ObSSTableEncodedColumnMeta& meta)
+    {
+      int ret = OB_SUCCESS;
+      int64_t cells_size = 0;
+      int64_t run_count = 1;
+      int64_t run_cells_size = cell(0, column).length_;
+      int64_t dict_count = 0;
+      int64_t dict_size = 0;
+      int64_t length = 0;
+      CellRef values[MAX_DICT_VALUE_COUNT];
+
+      memset(&meta, 0, sizeof(meta));
+      for (int64_t i = 0; i < row_count_; i ++)
+      {
+        cells_size += cell(i, column).length_;
+        if (i > 0 && !cell_equal(cell(i, column), cell(i - 1, column)))
+        {
+          run_count ++;
+          run_cells_size += cell(i, column).length_;
+        }
+      }
+
+      //plain
+      meta.encoding_ = OB_COLUMN_ENCODING_PLAIN;
+      meta.param_ = 0;
+      length = (row_count_ + 1) * sizeof(int32_t) + cells_size;
+
+      //rle
+      int64_t rle_length = (2 * run_count + 1) * sizeof(int32_t) + run_cells_size;
+      if (rle_length < length)
+      {
+        meta.encoding_ = OB_COLUMN_ENCODING_RLE;
+        meta.param_ = static_cast<int32_t>(run_count);
+        length = rle_length;
+      }
+
+      //dict
+      if (OB_SUCCESS != (ret = codes_buf_.ensure_space(row_count_,
+              ObModIds::OB_SSTABLE_WRITER)))
+      {
+        TBSYS_LOG(WARN, "alloc codes buf error:ret=%d,row_count_=%ld",
+            ret, row_count_);
+      }
+      else if (0 < (dict_count = build_dict(column, values,
+              reinterpret_cast<uint8_t*>(codes_buf_.get_buffer()))))
+      {
+        for (int64_t i = 0; i < dict_count; i ++)
+        {
+          dict_size += values[i].length_;
+        }
+        int64_t dict_length = (dict_count + 1) * sizeof(int32_t) + dict_size
+          + row_count_ * sizeof(uint8_t);
+        if (dict_length < length)
+        {
+          meta.encoding_ = OB_COLUMN_ENCODING_DICT;
+          meta.param_ = static_cast<int32_t>(dict_count);
+          length = dict_length;
+        }
+      }
+
+      //int frame of reference
+      if (OB_SUCCESS == ret && stats_[column].all_int_)
+      {
+        int64_t bit_width = get_bit_width(static_cast<uint64_t>(
+              stats_[column].max_int_) - static_cast<uint64_t>(stats_[column].min_int_));
+        //the packed values are read by 8 bytes, so pad 8 bytes
+        int64_t for_length = sizeof(int64_t) + (row_count_ * bit_width + 7) / 8
+          + sizeof(int64_t);
+        if (bit_width <= MAX_INT_FOR_BIT_WIDTH && for_length < length)
+        {
+          meta.encoding_ = OB_COLUMN_ENCODING_INT_FOR;
+          meta.param_ = static_cast<int32_t>(bit_width);
+          length = for_length;
+        }
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        meta.length_ = static_cast<int32_t>(length);
+      }
+
+      return ret;
+    }
+
+    int ObSSTableBlockEncoder::write_column(const int64_t column,
+        const ObSSTableEncodedColumnMeta& meta, char* buf)
+    {
+      int ret = OB_SUCCESS;
+      int32_t offset = 0;
+
+      switch (meta.encoding_)
+      {
+        case OB_COLUMN_ENCODING_PLAIN:
+          {
+            char* cells = buf + (row_count_ + 1) * sizeof(int32_t);
+            for (int64_t i = 0; i < row_count_; i ++)
+            {
+              const CellRef& ref = cell(i, column);
+              memcpy(buf + i * sizeof(int32_t), &offset, sizeof(offset));
+              memcpy(cells + offset, row_buf_ + ref.offset_, ref.length_);
+              offset += ref.length_;
+            }
+            memcpy(buf + row_count_ * sizeof(int32_t), &offset, sizeof(offset));
+          }
+          break;
+        case OB_COLUMN_ENCODING_DICT:
+          {
+            CellRef values[MAX_DICT_VALUE_COUNT];
+            char* cells = buf + (meta.param_ + 1) * sizeof(int32_t);
+            uint8_t* codes = reinterpret_cast<uint8_t*>(codes_buf_.get_buffer());
+            if (meta.param_ != build_dict(column, values, codes))
+            {
+              TBSYS_LOG(WARN, "dict value count changed:param=%d", meta.param_);
+              ret = OB_ERROR;
+            }
+            else
+            {
+              for (int64_t i = 0; i < meta.param_; i ++)
+              {
+                memcpy(buf + i * sizeof(int32_t), &offset, sizeof(offset));
+                memcpy(cells + offset, row_buf_ + values[i].offset_, values[i].length_);
+                offset += values[i].length_;
+              }
+              memcpy(buf + meta.param_ * sizeof(int32_t), &offset, sizeof(offset));
+              memcpy(cells + offset, codes, row_count_);
+            }
+          }
+          break;
+        case OB_COLUMN_ENCODING_RLE:
+          {
+            char* offsets = buf + meta.param_ * sizeof(int32_t);
+            char* cells = offsets + (meta.param_ + 1) * sizeof(int32_t);
+            int64_t run = -1;
+            for (int64_t i = 0; i < row_count_; i ++)
+            {
+              const CellRef& ref = cell(i, column);
+              if (0 == i || !cell_equal(ref, cell(i - 1, column)))
+              {
+                run ++;
+                memcpy(offsets + run * sizeof(int32_t), &offset, sizeof(offset));
+                memcpy(cells + offset, row_buf_ + ref.offset_, ref.length_);
+                offset += ref.length_;
+              }
+              int32_t run_end = static_cast<int32_t>(i + 1);
+              memcpy(buf + run * sizeof(int32_t), &run_end, sizeof(run_end));
+            }
+            memcpy(offsets + meta.param_ * sizeof(int32_t), &offset, sizeof(offset));
+          }
+          break;
+        case OB_COLUMN_ENCODING_INT_FOR:
+          {
+            ObCompactCellIterator iter;
+            const ObObj* obj = NULL;
+            int64_t value = 0;
+            int64_t base = stats_[column].min_int_;
+            char* packed = buf + sizeof(int64_t);
+            memcpy(buf, &base, sizeof(base));
+            for (int64_t i = 0; OB_SUCCESS == ret && i < row_count_; i ++)
+            {
+              if (OB_SUCCESS != (ret = iter.init(row_buf_ + cell(i, column).offset_, DENSE)))
+              {
+                TBSYS_LOG(WARN, "cell init error:ret=%d", ret);
+              }
+              else if (OB_SUCCESS != (ret = iter.next_cell()))
+              {
+                TBSYS_LOG(WARN, "cell next cell error:ret=%d", ret);
+              }
+              else if (OB_SUCCESS != (ret = iter.get_cell(obj)))
+              {
+                TBSYS_LOG(WARN, "get cell error:ret=%d", ret);
+              }
+              else if (OB_SUCCESS != (ret = obj->get_int(value)))
+              {
+                TBSYS_LOG(WARN, "get int error:ret=%d,type=%d", ret, obj->get_type());
+              }
+              else if (meta.param_ > 0)
+              {
+                int64_t bit_pos = i * meta.param_;
+                uint64_t word = 0;
+                memcpy(&word, packed + bit_pos / 8, sizeof(word));
+                word |= (static_cast<uint64_t>(value) - static_cast<uint64_t>(base))
+                  << (bit_pos % 8);
+                memcpy(packed + bit_pos / 8, &word, sizeof(word));
+              }
+            }
+          }
+          break;
+        default:
+          TBSYS_LOG(WARN, "unknown encoding:encoding=%d", meta.encoding_);
+          ret = OB_ERROR;
+          break;
+      }
+
+      return ret;
+    }
+
+    int64_t ObSSTableBlockEncoder::build_dict(const int64_t column,
+        CellRef* values, uint8_t* codes) const
+    {
+      int64_t count = 0;
+      int64_t code = 0;
+
+      for (int64_t i = 0; count >= 0 && i < row_count_; i ++)
+      {
+        const CellRef& ref = cell(i, column);
+        if (count > 0 && cell_equal(ref, values[code]))
+        {
+          //same as the last row
+        }
+        else
+        {
+          for (code = 0; code < count && !cell_equal(ref, values[code]); code ++)
+          {
+          }
+          if (code < count)
+          {
+            //found
+          }
+          else if (count >= MAX_DICT_VALUE_COUNT)
+          {
+            count = -1;
+          }
+          else
+          {
+            values[count ++] = ref;
+          }
+        }
+        if (count > 0)
+        {
+          codes[i] = static_cast<uint8_t>(code);
+        }
+      }
+
+      return count;
+    }
+
+    int64_t ObSSTableBlockEncoder::get_bit_width(const uint64_t value)
+    {
+      return 0 == value ? 0 : 64 - __builtin_clzl(value);
+    }
+
+    int ObSSTableBlockDecoder::init(const char* block_buf, const int64_t block_size)
+    {
+      int ret = OB_SUCCESS;
+      ObSSTableBlockHeader block_header;
+      ObCompactCellWriter writer;
+      ObObj null_obj;
+
+      if (NULL == block_buf || block_size < static_cast<int64_t>(
+            sizeof(ObSSTableBlockHeader) + sizeof(ObSSTableEncodedBlockHeader)))
+      {
+        TBSYS_LOG(WARN, "invalid argument:block_buf=%p,block_size=%ld",
+            block_buf, block_size);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        memcpy(&block_header, block_buf, sizeof(block_header));
+        memcpy(&header_, block_buf + sizeof(block_header), sizeof(header_));
+        if (OB_SSTABLE_BLOCK_FORMAT_ENCODED != block_header.block_format_
+            || block_header.row_count_ <= 0
+            || header_.restart_interval_ <= 0
+            || header_.restart_count_ != (block_header.row_count_
+              + header_.restart_interval_ - 1) / header_.restart_interval_
+            || header_.column_count_ <= 0
+            || header_.restart_offset_ + header_.restart_count_
+            * static_cast<int64_t>(sizeof(int32_t)) > block_size
+            || header_.column_meta_offset_ + header_.column_count_
+            * static_cast<int64_t>(sizeof(ObSSTableEncodedColumnMeta)) > block_size)
+        {
+          TBSYS_LOG(WARN, "invalid encoded block:block_format=%d,row_count=%d,"
+              "restart_interval=%d,restart_count=%d,column_count=%d,"
+              "block_size=%ld", block_header.block_format_,
+              block_header.row_count_, header_.restart_interval_,
+              header_.restart_count_, header_.column_count_, block_size);
+          ret = OB_ERROR;
+        }
+        else if (OB_SUCCESS != (ret = rowkey_buf_.ensure_space(
+                header_.max_rowkey_length_, ObModIds::OB_SSTABLE_READER)))
+        {
+          TBSYS_LOG(WARN, "alloc rowkey buf error:ret=%d,max_rowkey_length=%d",
+              ret, header_.max_rowkey_length_);
+        }
+        else if (OB_SUCCESS != (ret = row_buf_.ensure_space(header_.max_row_length_
+                + header_.column_count_ * MAX_FLAG_LENGTH, ObModIds::OB_SSTABLE_READER)))
+        {
+          TBSYS_LOG(WARN, "alloc row buf error:ret=%d,max_row_length=%d",
+              ret, header_.max_row_length_);
+        }
+        else
+        {
+          block_buf_ = block_buf;
+          block_size_ = block_size;
+          row_count_ = block_header.row_count_;
+          restarts_ = block_buf + header_.restart_offset_;
+          metas_ = reinterpret_cast<const ObSSTableEncodedColumnMeta*>(
+              block_buf + header_.column_meta_offset_);
+          cached_row_ = -1;
+          cached_next_offset_ = 0;
+          cached_rowkey_length_ = 0;
+        }
+      }
+
+      //the compact cells of null and the end flag
+      if (OB_SUCCESS != ret)
+      {
+        //do nothing
+      }
+      else if (OB_SUCCESS != (ret = writer.init(null_cell_, MAX_FLAG_LENGTH, DENSE)))
+      {
+        TBSYS_LOG(WARN, "writer init error:ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = writer.append(null_obj)))
+      {
+        TBSYS_LOG(WARN, "append null cell error:ret=%d", ret);
+      }
+      else
+      {
+        null_cell_length_ = writer.size();
+        if (OB_SUCCESS != (ret = writer.init(end_row_, MAX_FLAG_LENGTH, DENSE)))
+        {
+          TBSYS_LOG(WARN, "writer init error:ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = writer.row_finish()))
+        {
+          TBSYS_LOG(WARN, "append end flag error:ret=%d", ret);
+        }
+        else
+        {
+          end_row_length_ = writer.size();
+        }
+      }
+
+      return ret;
+    }
+
+    int ObSSTableBlockDecoder::get_rowkey(const int64_t row,
+        const char*& buf, int64_t& length)
+    {
+      int ret = OB_SUCCESS;
+      int64_t cur = 0;
+      int64_t offset = 0;
+      uint16_t shared = 0;
+      uint16_t unshared = 0;
+      char* key_buf = rowkey_buf_.get_buffer();
+
+      if (NULL == block_buf_)
+      {
+        TBSYS_LOG(WARN, "decoder is not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (row < 0 || row >= row_count_)
+      {
+        TBSYS_LOG(WARN, "invalid argument:row=%ld,row_count_=%ld", row, row_count_);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (row == cached_row_)
+      {
+        //the cached rowkey
+      }
+      else
+      {
+        //continue from the cached rowkey in the same restart interval
+        if (cached_row_ >= 0 && row > cached_row_
+            && row / header_.restart_interval_ == cached_row_ / header_.restart_interval_)
+        {
+          cur = cached_row_ + 1;
+          offset = cached_next_offset_;
+        }
+        else
+        {
+          cur = row / header_.restart_interval_ * header_.restart_interval_;
+          offset = read_int32(restarts_
+              + (row / header_.restart_interval_) * sizeof(int32_t));
+          cached_rowkey_length_ = 0;
+        }
+
+        for (; OB_SUCCESS == ret && cur <= row; cur ++)
+        {
+          if (offset + static_cast<int64_t>(2 * sizeof(uint16_t)) > block_size_)
+          {
+            ret = OB_ERROR;
+          }
+          else
+          {
+            memcpy(&shared, block_buf_ + offset, sizeof(shared));
+            memcpy(&unshared, block_buf_ + offset + sizeof(shared), sizeof(unshared));
+            offset += 2 * sizeof(uint16_t);
+            if (shared > cached_rowkey_length_
+                || shared + unshared > header_.max_rowkey_length_
+                || offset + unshared > block_size_)
+            {
+              ret = OB_ERROR;
+            }
+            else
+            {
+              memcpy(key_buf + shared, block_buf_ + offset, unshared);
+              cached_rowkey_length_ = shared + unshared;
+              offset += unshared;
+            }
+          }
+        }
+
+        if (OB_SUCCESS == ret)
+        {
+          cached_row_ = row;
+          cached_next_offset_ = offset;
+        }
+        else
+        {
+          TBSYS_LOG(WARN, "invalid encoded rowkey:row=%ld,offset=%ld,"
+              "shared=%u,unshared=%u", row, offset, shared, unshared);
+          cached_row_ = -1;
+        }
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        buf = key_buf;
+        length = cached_rowkey_length_;
+      }
+
+      return ret;
+    }
+
+    int ObSSTableBlockDecoder::get_row(const int64_t row,
+        const bool* project_columns, const char*& buf, int64_t& length)
+    {
+      int ret = OB_SUCCESS;
+      const char* key = NULL;
+      int64_t key_length = 0;
+      int64_t cell_length = 0;
+      char* row_buf = row_buf_.get_buffer();
+      int64_t row_buf_size = row_buf_.get_buffer_size();
+      int64_t pos = 0;
+
+      if (OB_SUCCESS != (ret = get_rowkey(row, key, key_length)))
+      {
+        TBSYS_LOG(WARN, "get rowkey error:ret=%d,row=%ld", ret, row);
+      }
+      else
+      {
+        memcpy(row_buf, key, key_length);
+        pos = key_length;
+        for (int64_t i = 0; OB_SUCCESS == ret && i < header_.column_count_; i ++)
+        {
+          if (NULL == project_columns || project_columns[i])
+          {
+            if (OB_SUCCESS != (ret = get_cell(row, i, row_buf + pos,
+                    row_buf_size - pos, cell_length)))
+            {
+              TBSYS_LOG(WARN, "get cell error:ret=%d,row=%ld,column=%ld",
+                  ret, row, i);
+            }
+            else
+            {
+              pos += cell_length;
+            }
+          }
+          else if (row_buf_size - pos < null_cell_length_)
+          {
+            ret = OB_SIZE_OVERFLOW;
+          }
+          else
+          {
+            memcpy(row_buf + pos, null_cell_, null_cell_length_);
+            pos += null_cell_length_;
+          }
+        }
+
+        if (OB_SUCCESS != ret)
+        {
+          //do nothing
+        }
+        else if (row_buf_size - pos < end_row_length_)
+        {
+          ret = OB_SIZE_OVERFLOW;
+        }
+        else
+        {
+          memcpy(row_buf + pos, end_row_, end_row_length_);
+          pos += end_row_length_;
+          buf = row_buf;
+          length = pos;
+        }
+      }
+
+      return ret;
+    }
+
+    int ObSSTableBlockDecoder::get_cell(const int64_t row, const int64_t column,
+        char* buf, const int64_t buf_size, int64_t& length) const
+    {
+      int ret = OB_SUCCESS;
+      const ObSSTableEncodedColumnMeta& meta = metas_[column];
+      const char* data = block_buf_ + meta.offset_;
+      const char* src = NULL;
+      int64_t src_length = 0;
+
+      switch (meta.encoding_)
+      {
+        case OB_COLUMN_ENCODING_PLAIN:
+          {
+            int32_t start = read_int32(data + row * sizeof(int32_t));
+            src = data + (row_count_ + 1) * sizeof(int32_t) + start;
+            src_length = read_int32(data + (row + 1) * sizeof(int32_t)) - start;
+          }
+          break;
+        case OB_COLUMN_ENCODING_DICT:
+          {
+            const char* cells = data + (meta.param_ + 1) * sizeof(int32_t);
+            uint8_t code = static_cast<uint8_t>(
+                cells[read_int32(data + meta.param_ * sizeof(int32_t)) + row]);
+            int32_t start = read_int32(data + code * sizeof(int32_t));
+            src = cells + start;
+            src_length = read_int32(data + (code + 1) * sizeof(int32_t)) - start;
+          }
+          break;
+        case OB_COLUMN_ENCODING_RLE:
+          {
+            //the first run whose end is greater than row
+            int64_t low = 0;
+            int64_t high = meta.param_ - 1;
+            while (low < high)
+            {
+              int64_t mid = (low + high) / 2;
+              if (read_int32(data + mid * sizeof(int32_t)) > row)
+              {
+                high = mid;
+              }
+              else
+              {
+                low = mid + 1;
+              }
+            }
+            const char* offsets = data + meta.param_ * sizeof(int32_t);
+            int32_t start = read_int32(offsets + low * sizeof(int32_t));
+            src = offsets + (meta.param_ + 1) * sizeof(int32_t) + start;
+            src_length = read_int32(offsets + (low + 1) * sizeof(int32_t)) - start;
+          }
+          break;
+        case OB_COLUMN_ENCODING_INT_FOR:
+          {
+            int64_t base = 0;
+            uint64_t word = 0;
+            int64_t bit_pos = row * meta.param_;
+            ObCompactCellWriter writer;
+            ObObj obj;
+            memcpy(&base, data, sizeof(base));
+            if (meta.param_ > 0)
+            {
+              memcpy(&word, data + sizeof(int64_t) + bit_pos / 8, sizeof(word));
+              word = (word >> (bit_pos % 8)) & ((1UL << meta.param_) - 1);
+            }
+            obj.set_int(static_cast<int64_t>(static_cast<uint64_t>(base) + word));
+            if (OB_SUCCESS != (ret = writer.init(buf, buf_size, DENSE)))
+            {
+              TBSYS_LOG(WARN, "writer init error:ret=%d,buf_size=%ld", ret, buf_size);
+            }
+            else if (OB_SUCCESS != (ret = writer.append(obj)))
+            {
+              TBSYS_LOG(WARN, "append int cell error:ret=%d", ret);
+            }
+            else
+            {
+              length = writer.size();
+            }
+          }
+          break;
+        default:
+          TBSYS_LOG(WARN, "unknown encoding:encoding=%d,column=%ld",
+              meta.encoding_, column);
+          ret = OB_ERROR;
+          break;
+      }
+
+      if (OB_SUCCESS != ret || NULL == src)
+      {
+        //do nothing
+      }
+      else if (src_length < 0 || src_length > buf_size)
+      {
+        TBSYS_LOG(WARN, "invalid cell length:length=%ld,buf_size=%ld",
+            src_length, buf_size);
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else
+      {
+        memcpy(buf, src, src_length);
+        length = src_length;
+      }
+
+      return ret;
+    }
+  }//end namespace compactsstablev2
+}//end namespace oceanbase
@@ -0,0 +1,262 @@
+#ifndef OCEANBASE_COMPACTSSTABLEV2_OB_SSTABLE_BLOCK_ENCODING_H_
+#define OCEANBASE_COMPACTSSTABLEV2_OB_SSTABLE_BLOCK_ENCODING_H_
+
+#include "common/ob_define.h"
+#include "common/ob_malloc.h"
+#include "ob_sstable_store_struct.h"
+
+class TestSSTableBlockEncoding_choose_encoding_Test;
+
+namespace oceanbase
+{
+  namespace compactsstablev2
+  {
+    /**
+     * encoded block(DENSE_DENSE only):
+     * ObSSTableBlockHeader(block_format_=OB_SSTABLE_BLOCK_FORMAT_ENCODED)
+     * ObSSTableEncodedBlockHeader
+     * rowkeys: (uint16 shared, uint16 unshared, unshared bytes) per row,
+     *          the bytes are the compact cells of rowkey and the end flag,
+     *          shared is always 0 at a restart point
+     * restart points: int32 offset of every restart_interval_ rowkey
+     * column metas: ObSSTableEncodedColumnMeta per rowvalue column
+     * column datas: the compact cells of each column in rows, encoded
+     *
+     * all offsets are from the begin of the block
+     */
+    struct ObSSTableEncodedBlockHeader
+    {
+      int32_t restart_interval_;
+      int32_t restart_count_;
+      int32_t restart_offset_;
+      int32_t column_count_;          //rowvalue column count
+      int32_t column_meta_offset_;
+      int32_t max_rowkey_length_;
+      int32_t max_row_length_;
+      int32_t reserved32_;
+
+      ObSSTableEncodedBlockHeader()
+      {
+        memset(this, 0, sizeof(ObSSTableEncodedBlockHeader));
+      }
+    };
+
+    enum ObSSTableColumnEncoding
+    {
+      //int32 offsets[row_count + 1], cells
+      OB_COLUMN_ENCODING_PLAIN = 0,
+      //int32 offsets[value_count + 1], cells, uint8 codes[row_count]
+      OB_COLUMN_ENCODING_DICT = 1,
+      //int32 run_ends[run_count], int32 offsets[run_count + 1], cells
+      OB_COLUMN_ENCODING_RLE = 2,
+      //int64 base, bit packed (value - base), int cells only
+      OB_COLUMN_ENCODING_INT_FOR = 3,
+    };
+
+    struct ObSSTableEncodedColumnMeta
+    {
+      int16_t encoding_;
+      int16_t reserved16_;
+      int32_t param_;   //DICT:value count, RLE:run count, INT_FOR:bit width
+      int32_t offset_;
+      int32_t length_;
+    };
+
+    /**
+     * encode the rows of a DENSE_DENSE block built by
+     * ObSSTableBlockBuilder, rowkeys are prefix compressed and each
+     * column gets the smallest encoding of PLAIN/DICT/RLE/INT_FOR.
+     */
+    class ObSSTableBlockEncoder
+    {
+      friend class ::TestSSTableBlockEncoding_choose_encoding_Test;
+
+    public:
+      static const int64_t RESTART_INTERVAL = 16;
+      static const int64_t MAX_DICT_VALUE_COUNT = 256;
+      static const int64_t MAX_INT_FOR_BIT_WIDTH = 56;
+      static const int64_t MAX_PREFIX_KEY_LENGTH = UINT16_MAX;
+
+    public:
+      ObSSTableBlockEncoder()
+        : row_buf_(NULL), row_count_(0), column_count_(0),
+          max_rowkey_length_(0), max_row_length_(0), cells_(NULL),
+          stats_(NULL), cells_buf_(DEFAULT_BUF_SIZE),
+          stats_buf_(DEFAULT_BUF_SIZE), codes_buf_(DEFAULT_BUF_SIZE),
+          metas_buf_(DEFAULT_BUF_SIZE), block_buf_(DEFAULT_BUF_SIZE)
+      {
+      }
+
+      ~ObSSTableBlockEncoder()
+      {
+      }
+
+      /**
+       * encode block
+       * @param row_buf: rows of the block, begin with the block header
+       * @param row_index: row offsets, row_count + 1 items
+       * @param row_count: row count
+       * @param buf: encoded block, valid until next encode
+       * @param size: encoded block size
+       * @return OB_NOT_SUPPORTED if the rows can't be encoded
+       */
+      int encode(const char* row_buf, const ObSSTableBlockRowIndex* row_index,
+          const int64_t row_count, char*& buf, int64_t& size);
+
+    private:
+      static const int64_t DEFAULT_BUF_SIZE = 64 * 1024;
+
+      struct CellRef
+      {
+        int32_t offset_;
+        int32_t length_;
+      };
+
+      struct ColumnStat
+      {
+        bool all_int_;
+        int64_t min_int_;
+        int64_t max_int_;
+      };
+
+      int parse_rows(const char* row_buf, const ObSSTableBlockRowIndex* row_index,
+          const int64_t row_count);
+
+      int parse_row(const int64_t row, const char* row_buf, const int64_t row_offset,
+          const int64_t row_length);
+
+      int choose_encoding(const int64_t column, ObSSTableEncodedColumnMeta& meta);
+
+      int write_column(const int64_t column, const ObSSTableEncodedColumnMeta& meta,
+          char* buf);
+
+      inline const CellRef& rowkey(const int64_t row) const
+      {
+        return cells_[row * (column_count_ + 1)];
+      }
+
+      inline const CellRef& cell(const int64_t row, const int64_t column) const
+      {
+        return cells_[row * (column_count_ + 1) + 1 + column];
+      }
+
+      inline bool cell_equal(const CellRef& a, const CellRef& b) const
+      {
+        return a.length_ == b.length_
+          && 0 == memcmp(row_buf_ + a.offset_, row_buf_ + b.offset_, a.length_);
+      }
+
+      int64_t build_dict(const int64_t column, CellRef* values, uint8_t* codes) const;
+
+      static int64_t get_bit_width(const uint64_t value);
+
+    private:
+      const char* row_buf_;
+      int64_t row_count_;
+      int64_t column_count_;
+      int64_t max_rowkey_length_;
+      int64_t max_row_length_;
+      CellRef* cells_;    //rowkey + columns of each row
+      ColumnStat* stats_;
+      common::ObMemBuf cells_buf_;
+      common::ObMemBuf stats_buf_;
+      common::ObMemBuf codes_buf_;
+      common::ObMemBuf metas_buf_;
+      common::ObMemBuf block_buf_;
+    };
+
+    /**
+     * decode the rows of an encoded block, the row is rebuilt in
+     * compact format so it can be read by ObCompactCellIterator as
+     * the row of normal block.
+     * not thread safe, the returned rowkey and row are valid until
+     * next call.
+     */
+    class ObSSTableBlockDecoder
+    {
+    public:
+      ObSSTableBlockDecoder()
+        : block_buf_(NULL), block_size_(0), row_count_(0),
+          restarts_(NULL), metas_(NULL), cached_row_(-1),
+          cached_next_offset_(0), cached_rowkey_length_(0),
+          rowkey_buf_(DEFAULT_BUF_SIZE), row_buf_(DEFAULT_BUF_SIZE),
+          null_cell_length_(0), end_row_length_(0)
+      {
+      }
+
+      ~ObSSTableBlockDecoder()
+      {
+      }
+
+      int init(const char* block_buf, const int64_t block_size);
+
+      inline int64_t get_row_count() const
+      {
+        return row_count_;
+      }
+
+      inline int64_t get_restart_count() const
+      {
+        return header_.restart_count_;
+      }
+
+      inline int64_t get_restart_interval() const
+      {
+        return header_.restart_interval_;
+      }
+
+      inline int64_t get_column_count() const
+      {
+        return header_.column_count_;
+      }
+
+      /**
+       * get the compact cells of the rowkey, with the end flag
+       */
+      int get_rowkey(const int64_t row, const char*& buf, int64_t& length);
+
+      /**
+       * rebuild the row in compact format
+       * @param project_columns: columns need decoding, the others are
+       *        set to null. NULL for all columns.
+       */
+      int get_row(const int64_t row, const bool* project_columns,
+          const char*& buf, int64_t& length);
+
+    private:
+      static const int64_t DEFAULT_BUF_SIZE = 4 * 1024;
+      static const int64_t MAX_FLAG_LENGTH = 16;
+
+      int get_cell(const int64_t row, const int64_t column, char* buf,
+          const int64_t buf_size, int64_t& length) const;
+
+      inline int32_t read_int32(const char* ptr) const
+      {
+        int32_t value = 0;
+        memcpy(&value, ptr, sizeof(value));
+        return value;
+      }
+
+    private:
+      const char* block_buf_;
+      int64_t block_size_;
+      int64_t row_count_;
+      ObSSTableEncodedBlockHeader header_;
+      const char* restarts_;
+      const ObSSTableEncodedColumnMeta* metas_;
+
+      //the last decoded rowkey, for sequential access
+      int64_t cached_row_;
+      int64_t cached_next_offset_;
+      int64_t cached_rowkey_length_;
+      common::ObMemBuf rowkey_buf_;
+      common::ObMemBuf row_buf_;
+
+      char null_cell_[MAX_FLAG_LENGTH];
+      int64_t null_cell_length_;
+      char end_row_[MAX_FLAG_LENGTH];
+      int64_t end_row_length_;
+    };
+  }//end namespace compactsstablev2
+}//end namespace oceanbase
+#endif
@@ -179,6 +179,74 @@ namespace oceanbase
     }
 
 
+    int ObSSTableBlockIndexCache::get_split_endkeys(
+        const ObBlockIndexPositionInfo& block_index_info,
+        const uint64_t table_id, const int64_t split_count,
+        ObRowkey* endkeys, int64_t& endkey_count, CharArena& allocator)
+    {
+      int ret = OB_SUCCESS;
+      bool revert_handle = false;
+      ObSSTableBlockIndexMgr block_index;
+      Handle handle;
+      ObRowkey endkey;
+      int64_t block_count = 0;
+      int64_t block_idx = 0;
+      int64_t last_block_idx = -1;
+      endkey_count = 0;
+
+      if (OB_SUCCESS != (ret = check_param(block_index_info, table_id)))
+      {
+        TBSYS_LOG(ERROR, "check param error");
+      }
+      else if (NULL == endkeys || 1 >= split_count)
+      {
+        TBSYS_LOG(WARN, "invalid argument:endkeys=%p,split_count=%ld",
+            endkeys, split_count);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (ret = load_block_index(block_index_info,
+              block_index, table_id, handle)))
+      {
+        TBSYS_LOG(ERROR, "load block index error");
+      }
+      else
+      {
+        revert_handle = true;
+        block_count = block_index.get_block_count();
+        for (int64_t i = 1; i < split_count && OB_SUCCESS == ret; i ++)
+        {
+          block_idx = i * block_count / split_count - 1;
+          if (block_idx <= last_block_idx)
+          {
+            //not enough blocks, skip the duplicate split point
+          }
+          else if (OB_SUCCESS != (ret = block_index.get_block_endkey(
+                  block_idx, endkey)))
+          {
+            TBSYS_LOG(WARN, "get block endkey error:ret=%d,block_idx=%ld",
+                ret, block_idx);
+          }
+          else if (OB_SUCCESS != (ret = endkey.deep_copy(
+                  endkeys[endkey_count], allocator)))
+          {
+            TBSYS_LOG(WARN, "deep copy endkey error:ret=%d", ret);
+          }
+          else
+          {
+            last_block_idx = block_idx;
+            endkey_count ++;
+          }
+        }
+      }
+
+      if (revert_handle && OB_SUCCESS != kv_cache_.revert(handle))
+      {
+        TBSYS_LOG(WARN, "kv cache revert error");
+      }
+
+      return ret;
+    }
+
     int ObSSTableBlockIndexCache::read_index_record(IFileInfoMgr& fileinfo_cache, 
         const uint64_t sstable_id, const int64_t offset, 
         const int64_t size, const char*& out_buffer)
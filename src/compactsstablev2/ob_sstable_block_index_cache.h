@@ -6,6 +6,7 @@
 #include "common/ob_fileinfo_manager.h"
 #include "common/ob_range2.h"
 #include "common/ob_record_header_v2.h"
+#include "common/page_arena.h"
 #include "ob_sstable_block_index_mgr.h"
 
 class TestSSTableBlockIndexCache_construct_Test;
@@ -129,6 +130,17 @@ namespace oceanbase
           const uint64_t table_id, const int64_t cur_offset,
           const SearchMode search_mode, ObBlockPositionInfos& pos_info);
 
+      /**
+       * split the sstable into split_count parts with the same block
+       * count, return the endkeys of the last block of each part except
+       * the last one, maybe less than split_count - 1 endkeys if there
+       * is not enough blocks. the endkeys are deep copied into allocator
+       */
+      int get_split_endkeys(const ObBlockIndexPositionInfo& block_index_info,
+          const uint64_t table_id, const int64_t split_count,
+          common::ObRowkey* endkeys, int64_t& endkey_count,
+          common::CharArena& allocator);
+
     private:
       int read_index_record(common::IFileInfoMgr& fileinfo_cache, 
                       const uint64_t sstable_id, 
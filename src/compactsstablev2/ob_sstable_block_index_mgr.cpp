@@ -122,6 +122,30 @@ namespace oceanbase
       return ret;
     }
 
+    int ObSSTableBlockIndexMgr::get_block_endkey(const int64_t index,
+        common::ObRowkey& key) const
+    {
+      int ret = OB_SUCCESS;
+      Bound bound;
+
+      if (0 > index || block_count_ <= index)
+      {
+        TBSYS_LOG(WARN, "invalid block index:index=%ld,block_count_=%ld",
+            index, block_count_);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (ret = get_bound(bound)))
+      {
+        TBSYS_LOG(WARN, "get bound error:ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = get_row_key(*(bound.begin_ + index), key)))
+      {
+        TBSYS_LOG(WARN, "get row key error:ret=%d,index=%ld", ret, index);
+      }
+
+      return ret;
+    }
+
     int ObSSTableBlockIndexMgr::search_batch_blocks_by_offset(
         const int64_t offset, const SearchMode mode,
         ObBlockPositionInfos& pos_info) const
@@ -212,6 +212,10 @@ namespace oceanbase
       int search_batch_blocks_by_offset(const int64_t offset,
           const SearchMode mode, ObBlockPositionInfos& pos_info) const;
 
+      //get the endkey of the index-th block, the rowkey objs live in
+      //thread local arena, caller should deep copy it if needed
+      int get_block_endkey(const int64_t index, common::ObRowkey& key) const;
+
       ObSSTableBlockIndexMgr* copy(char* buffer) const;
 
       inline int64_t get_size() const
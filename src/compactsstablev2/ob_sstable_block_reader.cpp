@@ -7,7 +7,8 @@ namespace oceanbase
   namespace compactsstablev2
   {
     int ObSSTableBlockReader::init(const BlockData& data, 
-        const common::ObCompactStoreType& row_store_type)
+        const common::ObCompactStoreType& row_store_type,
+        const ObSSTableScanColumnIndexes* scan_columns)
     {
       int ret = OB_SUCCESS;
 
@@ -31,6 +32,27 @@ namespace oceanbase
 
         //block header
         memcpy(&block_header_, data.data_buf_, BLOCK_HEADER_SIZE);
+        is_encoded_ = (OB_SSTABLE_BLOCK_FORMAT_ENCODED == block_header_.block_format_);
+        if (!is_encoded_)
+        {
+          //do nothing
+        }
+        else if (DENSE_DENSE != row_store_type)
+        {
+          TBSYS_LOG(WARN, "encoded block must be DENSE_DENSE:row_store_type=%d",
+              row_store_type);
+          ret = OB_ERROR;
+        }
+        else if (OB_SUCCESS != (ret = decoder_.init(data.data_buf_,
+                data.data_buf_size_)))
+        {
+          TBSYS_LOG(WARN, "decoder init error:ret=%d,data_buf_size_=%ld",
+              ret, data.data_buf_size_);
+        }
+        else if (OB_SUCCESS != (ret = init_project_columns(scan_columns)))
+        {
+          TBSYS_LOG(WARN, "init project columns error:ret=%d", ret);
+        }
 
         //block data
         data_begin_ = data.data_buf_;
@@ -64,7 +86,19 @@ namespace oceanbase
           }
         }
 
-        if (NULL != internal_buf_ptr)
+        if (OB_SUCCESS == ret && NULL != internal_buf_ptr && is_encoded_)
+        {
+          //the rows are decoded by row number
+          iterator index_ptr = reinterpret_cast<iterator>(internal_buf_ptr);
+          index_begin_ = index_ptr;
+          index_end_ = index_begin_ + block_header_.row_count_;
+          for (int32_t i = 0; i < block_header_.row_count_; i ++)
+          {
+            index_ptr[i].offset_ = i;
+            index_ptr[i].size_ = 0;
+          }
+        }
+        else if (OB_SUCCESS == ret && NULL != internal_buf_ptr)
         {
           //row index
           char* row_index = const_cast<char*>(data_end_);
@@ -98,9 +132,27 @@ namespace oceanbase
         common::ObCompactCellIterator& row) const
     {
       int ret = OB_SUCCESS;
+      const char* row_buf = NULL;
+      int64_t row_size = 0;
 
-      const char* row_buf = find_row(index);
-      if (NULL == row_buf)
+      if (is_encoded_)
+      {
+        if (OB_SUCCESS != (ret = decoder_.get_row(index->offset_,
+                has_project_columns_ ? project_columns_ : NULL, row_buf, row_size)))
+        {
+          TBSYS_LOG(WARN, "decode row error:ret=%d,row=%d", ret, index->offset_);
+        }
+      }
+      else
+      {
+        row_buf = find_row(index);
+      }
+
+      if (OB_SUCCESS != ret)
+      {
+        //do nothing
+      }
+      else if (NULL == row_buf)
       {
         ret = OB_SEARCH_NOT_FOUND;
       }
@@ -118,8 +170,27 @@ namespace oceanbase
     {
       int ret = OB_SUCCESS;
       ObCompactCellIterator row;
+      const char* key_buf = NULL;
+      int64_t key_size = 0;
       
-      if (OB_SUCCESS != (ret = get_row(index, row)))
+      if (is_encoded_)
+      {
+        if (OB_SUCCESS != (ret = decoder_.get_rowkey(index->offset_,
+                key_buf, key_size)))
+        {
+          TBSYS_LOG(WARN, "decode rowkey error:ret=%d,row=%d",
+              ret, index->offset_);
+        }
+        else if (OB_SUCCESS != (ret = row.init(key_buf, row_store_type_)))
+        {
+          TBSYS_LOG(WARN, "row init error:ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = get_row_key(row, key)))
+        {
+          TBSYS_LOG(WARN, "ger row key error:ret=%d", ret); 
+        }
+      }
+      else if (OB_SUCCESS != (ret = get_row(index, row)))
       {
         TBSYS_LOG(WARN, "get row error:ret=%d,index.offset_=%d," \
             "index.size_=%d", ret, index->offset_, index->size_);
@@ -157,6 +228,20 @@ namespace oceanbase
         TBSYS_LOG(WARN, "get row key error:ret=%d,index.offset_=%d" \
             "index.size_=%d", ret, index->offset_, index->size_);
       }
+      else if (is_encoded_)
+      {
+        //the full row is cached, not the projected one
+        const char* row_buf = NULL;
+        if (OB_SUCCESS != (ret = decoder_.get_row(index->offset_, NULL,
+                row_buf, row_value.size_)))
+        {
+          TBSYS_LOG(WARN, "decode row error:ret=%d,row=%d", ret, index->offset_);
+        }
+        else
+        {
+          row_value.buf_ = const_cast<char*>(row_buf);
+        }
+      }
       else
       {
         row_value.buf_ = const_cast<char*>(data_begin_ + index->offset_);
@@ -219,5 +304,80 @@ namespace oceanbase
 
       return ret;
     }
+
+    ObSSTableBlockReader::const_iterator ObSSTableBlockReader::encoded_lower_bound(
+        const ObRowkey& key)
+    {
+      Compare less(*this);
+      int64_t interval = decoder_.get_restart_interval();
+      int64_t low = 0;
+      int64_t high = decoder_.get_restart_count();
+      int64_t mid = 0;
+      const_iterator iter = NULL;
+      const_iterator last = NULL;
+
+      //the first restart point not less than key
+      while (low < high)
+      {
+        mid = (low + high) / 2;
+        if (less(index_begin_[mid * interval], key))
+        {
+          low = mid + 1;
+        }
+        else
+        {
+          high = mid;
+        }
+      }
+
+      //the rowkeys after the previous restart point, decoded sequentially
+      if (0 == low)
+      {
+        iter = index_begin_;
+      }
+      else
+      {
+        iter = index_begin_ + (low - 1) * interval + 1;
+        last = index_begin_ + low * interval;
+        if (last > index_end_)
+        {
+          last = index_end_;
+        }
+        while (iter < last && less(*iter, key))
+        {
+          iter ++;
+        }
+      }
+
+      return iter;
+    }
+
+    int ObSSTableBlockReader::init_project_columns(
+        const ObSSTableScanColumnIndexes* scan_columns)
+    {
+      int ret = OB_SUCCESS;
+      ObSSTableScanColumnIndexes::Column column;
+
+      has_project_columns_ = (NULL != scan_columns);
+      if (has_project_columns_)
+      {
+        memset(project_columns_, 0, sizeof(project_columns_));
+        for (int64_t i = 0; OB_SUCCESS == ret
+            && i < scan_columns->get_column_count(); i ++)
+        {
+          if (OB_SUCCESS != (ret = scan_columns->get_column(i, column)))
+          {
+            TBSYS_LOG(WARN, "get scan column error:ret=%d,i=%ld", ret, i);
+          }
+          else if (ObSSTableScanColumnIndexes::Normal == column.type_
+              && column.index_ >= 0 && column.index_ < OB_MAX_COLUMN_NUMBER)
+          {
+            project_columns_[column.index_] = true;
+          }
+        }
+      }
+
+      return ret;
+    }
   }//end namespace compactsstablev2
 }//end namespace oceanbase
@@ -7,6 +7,8 @@
 #include "common/ob_tsi_factory.h"
 #include "sstable/ob_sstable_row_cache.h"
 #include "ob_sstable_store_struct.h"
+#include "ob_sstable_block_encoding.h"
+#include "ob_sstable_scan_column_indexes.h"
 
 namespace oceanbase
 {
@@ -113,7 +115,9 @@ namespace oceanbase
           data_end_(NULL),
           index_begin_(NULL),
           index_end_(NULL),
-          row_store_type_(common::INVALID_COMPACT_STORE_TYPE)
+          row_store_type_(common::INVALID_COMPACT_STORE_TYPE),
+          is_encoded_(false),
+          has_project_columns_(false)
       {
         memset(&block_header_, 0, sizeof(block_header_));
       }
@@ -134,12 +138,20 @@ namespace oceanbase
         data_begin_ = NULL;
         data_end_ = NULL;
         row_store_type_ = common::INVALID_COMPACT_STORE_TYPE;
+        is_encoded_ = false;
+        has_project_columns_ = false;
         memset(&block_header_, 0, sizeof(block_header_));
         return ret;
       }
 
+      /**
+       * @param scan_columns: columns to read, only used by encoded
+       *        block, the rowvalue columns not in it are read as null.
+       *        NULL for all columns.
+       */
       int init(const BlockData& data, 
-          const common::ObCompactStoreType& row_store_type);
+          const common::ObCompactStoreType& row_store_type,
+          const ObSSTableScanColumnIndexes* scan_columns = NULL);
       
       int get_row(const_iterator index, 
           common::ObCompactCellIterator& row) const;
@@ -149,7 +161,8 @@ namespace oceanbase
       inline ObSSTableBlockReader::const_iterator lower_bound(
           const common::ObRowkey& key)
       {
-        return std::lower_bound(index_begin_, index_end_, key, Compare(*this));
+        return is_encoded_ ? encoded_lower_bound(key)
+          : std::lower_bound(index_begin_, index_end_, key, Compare(*this));
       }
 
       inline const_iterator begin_index() const
@@ -174,6 +187,11 @@ namespace oceanbase
       int get_row_key(common::ObCompactCellIterator& row, 
           common::ObRowkey& key) const;
 
+      //binary search the restart points, then the rowkeys in interval
+      const_iterator encoded_lower_bound(const common::ObRowkey& key);
+
+      int init_project_columns(const ObSSTableScanColumnIndexes* scan_columns);
+
       inline const char* find_row(const_iterator index) const
       {
         return (data_begin_ + index->offset_);
@@ -187,6 +205,12 @@ namespace oceanbase
       const_iterator index_end_;
       common::ObCompactStoreType row_store_type_;
       mutable common::ObObj rowkey_buf_array_[common::OB_MAX_ROWKEY_COLUMN_NUMBER]; //用于rowkey比较的临时Obj数组
+
+      //encoded block, the offset_ of row index is the row number
+      bool is_encoded_;
+      mutable ObSSTableBlockDecoder decoder_;
+      bool has_project_columns_;
+      bool project_columns_[common::OB_MAX_COLUMN_NUMBER];
     };
   }//end namespace compactsstablev2
 }//end namesapce oceanbase
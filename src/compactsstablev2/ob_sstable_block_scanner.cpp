@@ -11,7 +11,8 @@ namespace oceanbase
         const bool is_reverse_scan,
         const ObSSTableBlockReader::BlockData& block_data,
         const ObCompactStoreType& row_store_type,
-        bool& need_looking_forward)
+        bool& need_looking_forward,
+        const ObSSTableScanColumnIndexes* scan_columns)
     {
       int ret = OB_SUCCESS;
       need_looking_forward = true;
@@ -35,7 +36,7 @@ namespace oceanbase
             ret, is_reverse_scan);
       }
       else if (OB_SUCCESS != (ret = block_reader_.init(
-              block_data, row_store_type)))
+              block_data, row_store_type, scan_columns)))
       {//init block reader
         TBSYS_LOG(WARN, "block reader init error:ret=%d,"
             "block_internal_buf_=%p,internal_buf_size=%ld,data_buf_=%p,"
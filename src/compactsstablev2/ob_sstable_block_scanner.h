@@ -31,7 +31,8 @@ namespace oceanbase
           const bool is_reverse_scan,
           const ObSSTableBlockReader::BlockData& block_data,
           const common::ObCompactStoreType& row_store_type,
-          bool& need_looking_forward);
+          bool& need_looking_forward,
+          const ObSSTableScanColumnIndexes* scan_columns = NULL);
 
       int get_next_row(common::ObCompactCellIterator*& row);
 
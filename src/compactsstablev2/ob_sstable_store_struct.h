@@ -152,11 +152,17 @@ namespace oceanbase
       }
     };
 
+    //block format
+    static const int16_t OB_SSTABLE_BLOCK_FORMAT_ROW = 0;
+    static const int16_t OB_SSTABLE_BLOCK_FORMAT_ENCODED = 1;
+
     struct ObSSTableBlockHeader
     {
       int32_t row_index_offset_;
       int32_t row_count_;
-      int64_t reserved64_;
+      int16_t block_format_;  //OB_SSTABLE_BLOCK_FORMAT_ROW/ENCODED
+      int16_t reserved16_;
+      int32_t reserved32_;
 
       ObSSTableBlockHeader()
       {
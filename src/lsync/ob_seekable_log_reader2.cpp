@@ -8,8 +8,6 @@ namespace oceanbase
   namespace updateserver
   {
     int get_log_file_offset_func(const char* log_dir, const int64_t file_id, const int64_t log_id, int64_t& offset);
-    int read_log_file_by_location(const char* log_dir, const int64_t file_id, const int64_t offset,
-                                  char* buf, const int64_t len, int64_t& read_count, const bool dio = true);
   };
 
   namespace lsync
@@ -30,7 +28,7 @@ namespace oceanbase
       {
         err = OB_INVALID_ARGUMENT;
       }
-      else if (OB_SUCCESS != (err = located_log_reader_.init(log_dir)))
+      else if (OB_SUCCESS != (err = located_log_reader_.init(log_dir, dio_)))
       {
         TBSYS_LOG(ERROR, "located_log_reader.init(log_dir=%s)=>%d", log_dir, err);
       }
@@ -284,9 +282,9 @@ namespace oceanbase
           err = OB_READ_NOTHING;
         }
       }
-      else if (OB_SUCCESS != (err = read_log_file_by_location(log_dir_, file_id, start_location.offset_, buf, len, read_count, dio_)))
+      else if (OB_SUCCESS != (err = located_log_reader_.read_file(file_id, start_location.offset_, buf, len, read_count)))
       {
-        TBSYS_LOG(ERROR, "read_log_file_by_location(log_dir=%s, file=%ld:+%ld, start_id=%ld, buf=%p[%ld])=>%d",
+        TBSYS_LOG(ERROR, "located_log_reader.read_file(log_dir=%s, file=%ld:+%ld, start_id=%ld, buf=%p[%ld])=>%d",
                   log_dir_, file_id, start_location.offset_, start_id, buf, len, err);
       }
       else if (OB_SUCCESS != (err = trim_log_buffer(file_id, start_location.offset_, OB_DIRECT_IO_ALIGN_BITS,
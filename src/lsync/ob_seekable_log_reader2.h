@@ -19,7 +19,7 @@
 
 #include "common/ob_define.h"
 #include "updateserver/ob_log_locator.h"
-#include "updateserver/ob_located_log_reader.h"
+#include "updateserver/ob_mmap_log_reader.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::updateserver;
@@ -53,7 +53,7 @@ namespace oceanbase
         int64_t lsync_retry_wait_time_us_;
         int64_t reserved_time_to_send_packet_;
         ObLogLocation start_location_;
-        ObLocatedLogReader located_log_reader_;
+        ObMmapLogReader located_log_reader_;
     };
 
   } // end namespace lsync
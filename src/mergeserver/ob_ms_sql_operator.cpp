@@ -170,3 +170,17 @@ int oceanbase::mergeserver::ObMsSqlOperator::get_next_row(oceanbase::common::ObR
   return err;
 }
 
+int oceanbase::mergeserver::ObMsSqlOperator::get_next_batch(oceanbase::sql::ObRowBatch &batch)
+{
+  int err = OB_SUCCESS;
+  if (NULL == scan_param_)
+  {
+    TBSYS_LOG(WARN,"please set request param first");
+    err = OB_INVALID_ARGUMENT;
+  }
+  else if (OB_SUCCESS != (err = sorted_operator_.get_next_batch(batch)) && OB_ITER_END != err)
+  {
+    TBSYS_LOG(WARN,"fail to get next batch from result [err:%d,status_:%d]", err, status_);
+  }
+  return err;
+}
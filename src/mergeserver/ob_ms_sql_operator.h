@@ -52,6 +52,7 @@ namespace oceanbase
       int64_t get_cur_sharding_result_idx() const;
       
       int get_next_row(common::ObRow &row);
+      int get_next_batch(sql::ObRowBatch &batch);
     private:
       enum
       {
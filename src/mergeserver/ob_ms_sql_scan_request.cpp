@@ -980,7 +980,7 @@ namespace oceanbase
       sharding_limit_count_ = 0;
     }
 
-    int ObMsSqlScanRequest::get_next_row(oceanbase::common::ObRow &row)
+    void ObMsSqlScanRequest::trigger_more_request_()
     {
       if (true == is_finish())
       {
@@ -1004,10 +1004,22 @@ namespace oceanbase
           }
         }
       }
+    }
+
+    int ObMsSqlScanRequest::get_next_row(oceanbase::common::ObRow &row)
+    {
+      trigger_more_request_();
       int ret = merger_operator_.get_next_row(row);
       return ret;
     }
 
+    int ObMsSqlScanRequest::get_next_batch(sql::ObRowBatch &batch)
+    {
+      trigger_more_request_();
+      int ret = merger_operator_.get_next_batch(batch);
+      return ret;
+    }
+
     /// namespace
   }
 }
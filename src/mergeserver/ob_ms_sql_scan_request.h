@@ -67,6 +67,8 @@ namespace oceanbase
       int retry(const int32_t sub_req_idx, ObMsSqlRpcEvent *rpc_event, int64_t timeout_us);
 
       int get_next_row(oceanbase::common::ObRow &row);
+      /// batch version of get_next_row(), the rows are valid until the next call
+      int get_next_batch(sql::ObRowBatch &batch);
 
       int64_t get_mem_size_used()const
       {
@@ -85,6 +87,7 @@ namespace oceanbase
       int send_rpc_event(ObMsSqlSubScanRequest * sub_req, const int64_t timeout_us, uint64_t * triggered_rpc_event_id = NULL);
 
       bool check_if_location_cache_valid_(const oceanbase::common::ObNewScanner & scanner, const oceanbase::sql::ObSqlScanParam & scan_param);
+      void trigger_more_request_();
 
     private:
       void end_sessions_();
@@ -14,6 +14,7 @@
 #include "ob_ms_sql_sorted_operator.h"
 #include <algorithm>
 #include "sql/ob_sql_scan_param.h"
+#include "sql/ob_row_batch.h"
 #include "common/ob_new_scanner.h"
 #include "common/ob_range2.h"
 using namespace oceanbase;
@@ -276,3 +277,48 @@ int oceanbase::mergeserver::ObMsSqlSortedOperator::get_next_row(oceanbase::commo
   }
   return err;
 }
+
+int oceanbase::mergeserver::ObMsSqlSortedOperator::get_next_batch(oceanbase::sql::ObRowBatch &batch)
+{
+  int err = OB_SUCCESS;
+  ObString compact_row;
+  int64_t row_count = 0;
+  while (OB_SUCCESS == err && !batch.is_full())
+  {
+    if (cur_sharding_result_idx_ >= seamless_result_count_)
+    {
+      err = OB_ITER_END;
+    }
+    else if (OB_SUCCESS == (err = sharding_result_arr_[cur_sharding_result_idx_].sharding_res_->get_next_compact_row(compact_row)))
+    {
+      if (OB_SUCCESS != (err = batch.add_compact_row(compact_row)))
+      {
+        TBSYS_LOG(WARN,"fail to add row to batch [idx:%ld,err:%d]", cur_sharding_result_idx_, err);
+      }
+      else
+      {
+        row_count ++;
+      }
+    }
+    else if (OB_ITER_END == err)
+    {
+      if (0 == row_count)
+      {
+        total_mem_size_used_ -= sharding_result_arr_[cur_sharding_result_idx_].sharding_res_->get_used_mem_size();
+        // rows of the batch do not point into it any more, release it
+        sharding_result_arr_[cur_sharding_result_idx_].sharding_res_->clear();
+        cur_sharding_result_idx_ ++;
+        err = OB_SUCCESS;
+      }
+    }
+    else
+    {
+      TBSYS_LOG(WARN,"fail to get next row from ObNewScanner [idx:%ld,err:%d]", cur_sharding_result_idx_, err);
+    }
+  }
+  if (OB_ITER_END == err && 0 < row_count)
+  {
+    err = OB_SUCCESS;
+  }
+  return err;
+}
@@ -22,6 +22,7 @@ namespace oceanbase
   namespace sql
   {
     class ObSqlScanParam;
+    class ObRowBatch;
   }
   namespace common
   {
@@ -52,6 +53,9 @@ namespace oceanbase
     public:
       // row interface
       int get_next_row(common::ObRow &row);
+      /// decode rows straight into the batch, all the rows added by one call come from
+      /// one sharding result, which is not released until the next call
+      int get_next_batch(sql::ObRowBatch &batch);
 
       void reset();
 
@@ -712,6 +712,20 @@ int ObBootstrap::init_all_sys_param()
         ObBoolType,
         "true",
         "");
+    INSERT_ALL_SYS_PARAM_ROW(
+        ret,
+        acc,
+        "ob_hash_group_by_param",
+        ObBoolType,
+        "false",
+        "");
+    INSERT_ALL_SYS_PARAM_ROW(
+        ret,
+        acc,
+        "ob_enable_plan_cache",
+        ObBoolType,
+        "true",
+        "");
     INSERT_ALL_SYS_PARAM_ROW(
         ret,
         acc,
@@ -138,3 +138,13 @@ int ObAddProject::get_next_row(const common::ObRow *&row)
   }
   return ret;
 }
+
+int ObAddProject::get_next_batch(ObRowBatch &batch)
+{
+  return ObPhyOperator::get_next_batch(batch);
+}
+
+bool ObAddProject::is_batch_native() const
+{
+  return false;
+}
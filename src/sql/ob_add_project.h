@@ -30,6 +30,9 @@ namespace oceanbase
 
         virtual int open();
         virtual int get_next_row(const common::ObRow *&row);
+        /// fill the batch by get_next_row() of this operator
+        virtual int get_next_batch(ObRowBatch &batch);
+        virtual bool is_batch_native() const;
       private:
         // types and constants
       private:
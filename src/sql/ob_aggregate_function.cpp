@@ -94,10 +94,14 @@ void ObAggregateFunction::destroy()
   destroy_dedup_sets();
 }
 
-int ObAggregateFunction::clone_expr_cell(const ObExprObj &cell, ObExprObj &cell_clone)
+int ObAggregateFunction::clone_expr_cell(const ObExprObj &cell, ObExprObj &cell_clone, ModuleArena *arena)
 {
   int ret = OB_SUCCESS;
-  if (ObVarcharType == cell.get_type())
+  if (NULL != arena)
+  {
+    ret = arena_clone_expr_cell(cell, cell_clone, *arena);
+  }
+  else if (ObVarcharType == cell.get_type())
   {
     ObString varchar;
     cell.get_varchar(varchar);
@@ -148,6 +152,51 @@ int ObAggregateFunction::clone_expr_cell(const ObExprObj &cell, ObExprObj &cell_
   return ret;
 }
 
+// the varchar buffer of cell_clone is reused if it is long enough,
+// so MAX()/MIN() of one group won't eat up the arena
+int ObAggregateFunction::arena_clone_expr_cell(const ObExprObj &cell, ObExprObj &cell_clone, ModuleArena &arena)
+{
+  int ret = OB_SUCCESS;
+  if (ObVarcharType == cell.get_type())
+  {
+    ObString varchar;
+    cell.get_varchar(varchar);
+    ObString varchar_clone;
+    char* buff = NULL;
+    if (ObVarcharType == cell_clone.get_type())
+    {
+      cell_clone.get_varchar(varchar_clone);
+    }
+    if (0 >= varchar.length())
+    {
+      varchar_clone.assign_ptr(NULL, 0);
+    }
+    else if (NULL != varchar_clone.ptr() && varchar_clone.length() >= varchar.length())
+    {
+      buff = varchar_clone.ptr();
+    }
+    else if (NULL == (buff = arena.alloc(varchar.length())))
+    {
+      TBSYS_LOG(ERROR, "no memory, length=%d", varchar.length());
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+    }
+    if (OB_SUCCESS == ret)
+    {
+      if (NULL != buff)
+      {
+        memcpy(buff, varchar.ptr(), varchar.length());
+        varchar_clone.assign_ptr(buff, varchar.length());
+      }
+      cell_clone.set_varchar(varchar_clone);
+    }
+  }
+  else
+  {
+    cell_clone = cell;
+  }
+  return ret;
+}
+
 int ObAggregateFunction::clone_cell(const ObObj &cell, ObObj &cell_clone)
 {
   int ret = OB_SUCCESS;
@@ -467,7 +516,8 @@ int ObAggregateFunction::process(const ObRow &input_row)
   return ret;
 }
 
-int ObAggregateFunction::init_aggr_cell(const ObItemType aggr_fun, const ObObj &oprand, ObExprObj &res1, ObExprObj &res2)
+int ObAggregateFunction::init_aggr_cell(const ObItemType aggr_fun, const ObObj &oprand, ObExprObj &res1, ObExprObj &res2,
+                                        ModuleArena *arena)
 {
   int ret = OB_SUCCESS;
   ObExprObj oprand_clone;
@@ -490,7 +540,7 @@ int ObAggregateFunction::init_aggr_cell(const ObItemType aggr_fun, const ObObj &
     case T_FUN_MIN:
     case T_FUN_SUM:
     case T_FUN_AVG:
-      ret = clone_expr_cell(oprand_clone, res1);
+      ret = clone_expr_cell(oprand_clone, res1, arena);
       if (!oprand.is_null())
       {
         res2.set_int(1);
@@ -504,7 +554,8 @@ int ObAggregateFunction::init_aggr_cell(const ObItemType aggr_fun, const ObObj &
   return ret;
 }
 
-int ObAggregateFunction::calc_aggr_cell(const ObItemType aggr_fun, const ObObj &oprand, ObExprObj &res1, ObExprObj &res2)
+int ObAggregateFunction::calc_aggr_cell(const ObItemType aggr_fun, const ObObj &oprand, ObExprObj &res1, ObExprObj &res2,
+                                        ModuleArena *arena)
 {
   int ret = OB_SUCCESS;
   if (!oprand.is_null())
@@ -531,7 +582,7 @@ int ObAggregateFunction::calc_aggr_cell(const ObItemType aggr_fun, const ObObj &
           res1.lt(oprand_clone, result);
           if (result.is_true())
           {
-            ret = clone_expr_cell(oprand_clone, res1);
+            ret = clone_expr_cell(oprand_clone, res1, arena);
           }
           else if (result.is_null())
           {
@@ -539,7 +590,7 @@ int ObAggregateFunction::calc_aggr_cell(const ObItemType aggr_fun, const ObObj &
             // @ref mysql_test/r/group_min_max.test
             if (res1.is_null() && !oprand_clone.is_null())
             {
-              ret = clone_expr_cell(oprand_clone, res1);
+              ret = clone_expr_cell(oprand_clone, res1, arena);
             }
           }
           break;
@@ -547,7 +598,7 @@ int ObAggregateFunction::calc_aggr_cell(const ObItemType aggr_fun, const ObObj &
           oprand_clone.lt(res1, result);
           if (result.is_true())
           {
-            ret = clone_expr_cell(oprand_clone, res1);
+            ret = clone_expr_cell(oprand_clone, res1, arena);
           }
           else if (result.is_null())
           {
@@ -555,7 +606,7 @@ int ObAggregateFunction::calc_aggr_cell(const ObItemType aggr_fun, const ObObj &
             // @ref mysql_test/r/group_min_max.test
             if (res1.is_null() && !oprand_clone.is_null())
             {
-              ret = clone_expr_cell(oprand_clone, res1);
+              ret = clone_expr_cell(oprand_clone, res1, arena);
             }
           }
           break;
@@ -564,7 +615,7 @@ int ObAggregateFunction::calc_aggr_cell(const ObItemType aggr_fun, const ObObj &
           if (res1.is_null())
           {
             // the first non-NULL cell
-            ret = clone_expr_cell(oprand_clone, res1);
+            ret = clone_expr_cell(oprand_clone, res1, arena);
           }
           else
           {
@@ -592,7 +643,6 @@ int ObAggregateFunction::get_result(const ObRow *&row)
   ObObj *res_cell = NULL;
   ObExprObj *aggr_cell = NULL;
   ObExprObj *aux_cell = NULL;
-  ObExprObj result;
   for (int64_t i = 0; OB_SUCCESS == ret && i < aggr_columns_->count(); ++i)
   {
     const ObSqlExpression &cexpr = aggr_columns_->at(static_cast<int32_t>(i));
@@ -614,44 +664,9 @@ int ObAggregateFunction::get_result(const ObRow *&row)
     {
       TBSYS_LOG(WARN, "failed to get cell, err=%d", ret);
     }
-    else
+    else if (OB_SUCCESS != (ret = calc_result_cell(aggr_fun, *aggr_cell, *aux_cell, *res_cell)))
     {
-      switch(aggr_fun)
-      {
-        case T_FUN_COUNT:
-          ret = aggr_cell->to(*res_cell);
-          break;
-        case T_FUN_MAX:
-        case T_FUN_MIN:
-        case T_FUN_SUM:
-          if (aux_cell->is_zero())
-          {
-            res_cell->set_null();
-          }
-          else
-          {
-            ret = aggr_cell->to(*res_cell);
-          }
-          break;
-        case T_FUN_AVG:
-          if (aux_cell->is_zero())
-          {
-            res_cell->set_null();
-          }
-          else
-          {
-            ret = aggr_cell->div(*aux_cell, result, did_int_div_as_double_);
-            if (OB_SUCCESS == ret)
-            {
-              ret = result.to(*res_cell);
-            }
-          }
-          break;
-        default:
-          ret = OB_ERR_UNEXPECTED;
-          TBSYS_LOG(ERROR, "unknown aggr function type, t=%d", aggr_fun);
-          break;
-      } // end switch
+      TBSYS_LOG(WARN, "failed to calc result cell, err=%d", ret);
     }
   } // end for
   if (OB_SUCCESS == ret)
@@ -661,6 +676,50 @@ int ObAggregateFunction::get_result(const ObRow *&row)
   return ret;
 }
 
+int ObAggregateFunction::calc_result_cell(const ObItemType aggr_fun, ObExprObj &aggr_cell,
+                                          ObExprObj &aux_cell, ObObj &res_cell)
+{
+  int ret = OB_SUCCESS;
+  ObExprObj result;
+  switch(aggr_fun)
+  {
+    case T_FUN_COUNT:
+      ret = aggr_cell.to(res_cell);
+      break;
+    case T_FUN_MAX:
+    case T_FUN_MIN:
+    case T_FUN_SUM:
+      if (aux_cell.is_zero())
+      {
+        res_cell.set_null();
+      }
+      else
+      {
+        ret = aggr_cell.to(res_cell);
+      }
+      break;
+    case T_FUN_AVG:
+      if (aux_cell.is_zero())
+      {
+        res_cell.set_null();
+      }
+      else
+      {
+        ret = aggr_cell.div(aux_cell, result, did_int_div_as_double_);
+        if (OB_SUCCESS == ret)
+        {
+          ret = result.to(res_cell);
+        }
+      }
+      break;
+    default:
+      ret = OB_ERR_UNEXPECTED;
+      TBSYS_LOG(ERROR, "unknown aggr function type, t=%d", aggr_fun);
+      break;
+  } // end switch
+  return ret;
+}
+
 int ObAggregateFunction::init_dedup_sets()
 {
   int ret = OB_SUCCESS;
@@ -766,3 +825,105 @@ int ObAggregateFunction::get_result_for_empty_set(const ObRow *&row)
   }
   return ret;
 }
+
+int ObAggregateFunction::init_state(const ObRow &row, ObExprObj *state, ModuleArena &arena)
+{
+  int ret = OB_SUCCESS;
+  OB_ASSERT(aggr_columns_);
+  ObItemType aggr_fun;
+  bool is_distinct = false;
+  const ObObj *input_cell = NULL;
+  for (int64_t i = 0; OB_SUCCESS == ret && i < aggr_columns_->count(); ++i)
+  {
+    ObSqlExpression &cexpr = aggr_columns_->at(static_cast<int32_t>(i));
+    if (OB_SUCCESS != (ret = cexpr.get_aggr_column(aggr_fun, is_distinct)))
+    {
+      TBSYS_LOG(WARN, "failed to get aggr column, err=%d", ret);
+    }
+    else if (is_distinct)
+    {
+      ret = OB_NOT_SUPPORTED;
+      TBSYS_LOG(WARN, "distinct aggr column is not supported by aggregate state, i=%ld", i);
+    }
+    else if (OB_SUCCESS != (ret = cexpr.calc(row, input_cell)))
+    {
+      TBSYS_LOG(WARN, "failed to calc cell, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = init_aggr_cell(aggr_fun, *input_cell, state[2*i], state[2*i+1], &arena)))
+    {
+      TBSYS_LOG(WARN, "failed to init cell, err=%d", ret);
+    }
+  } // end for
+  return ret;
+}
+
+int ObAggregateFunction::calc_state(const ObRow &row, ObExprObj *state, ModuleArena &arena)
+{
+  int ret = OB_SUCCESS;
+  OB_ASSERT(aggr_columns_);
+  ObItemType aggr_fun;
+  bool is_distinct = false;
+  const ObObj *input_cell = NULL;
+  for (int64_t i = 0; OB_SUCCESS == ret && i < aggr_columns_->count(); ++i)
+  {
+    ObSqlExpression &cexpr = aggr_columns_->at(static_cast<int32_t>(i));
+    if (OB_SUCCESS != (ret = cexpr.get_aggr_column(aggr_fun, is_distinct)))
+    {
+      TBSYS_LOG(WARN, "failed to get aggr column, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = cexpr.calc(row, input_cell)))
+    {
+      TBSYS_LOG(WARN, "failed to calc cell, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = calc_aggr_cell(aggr_fun, *input_cell, state[2*i], state[2*i+1], &arena)))
+    {
+      TBSYS_LOG(WARN, "failed to calculate aggr cell, err=%d", ret);
+    }
+  } // end for
+  return ret;
+}
+
+int ObAggregateFunction::get_state_result(const ObRow &group_row, ObExprObj *state, const ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  OB_ASSERT(aggr_columns_);
+  const ObObj *cell = NULL;
+  ObObj *res_cell = NULL;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  ObItemType aggr_fun;
+  bool is_distinct = false;
+  // the input columns are the prefix of the output row
+  for (int64_t i = 0; OB_SUCCESS == ret && i < group_row.get_column_num(); ++i)
+  {
+    if (OB_SUCCESS != (ret = group_row.raw_get_cell(i, cell, tid, cid)))
+    {
+      TBSYS_LOG(WARN, "failed to get cell, err=%d i=%ld", ret, i);
+    }
+    else if (OB_SUCCESS != (ret = curr_row_.raw_set_cell(i, *cell)))
+    {
+      TBSYS_LOG(WARN, "failed to set cell, err=%d i=%ld", ret, i);
+    }
+  } // end for
+  for (int64_t i = 0; OB_SUCCESS == ret && i < aggr_columns_->count(); ++i)
+  {
+    const ObSqlExpression &cexpr = aggr_columns_->at(static_cast<int32_t>(i));
+    if (OB_SUCCESS != (ret = cexpr.get_aggr_column(aggr_fun, is_distinct)))
+    {
+      TBSYS_LOG(WARN, "failed to get aggr column, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = curr_row_.get_cell(cexpr.get_table_id(), cexpr.get_column_id(), res_cell)))
+    {
+      TBSYS_LOG(WARN, "failed to get cell, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = calc_result_cell(aggr_fun, state[2*i], state[2*i+1], *res_cell)))
+    {
+      TBSYS_LOG(WARN, "failed to calc result cell, err=%d", ret);
+    }
+  } // end for
+  if (OB_SUCCESS == ret)
+  {
+    row = &curr_row_;
+  }
+  return ret;
+}
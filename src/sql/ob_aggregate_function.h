@@ -19,6 +19,7 @@
 #include "common/ob_array.h"
 #include "common/hash/ob_hashset.h"
 #include "common/ob_row_store.h"
+#include "common/page_arena.h"
 #include <stdint.h>
 namespace oceanbase
 {
@@ -47,6 +48,17 @@ namespace oceanbase
         int get_result_for_empty_set(const ObRow *&row);
 
         int64_t get_used_mem_size() const;
+
+        /// aggregate state kept by the caller, e.g. one state for each group of ObHashGroupBy.
+        /// the state is get_state_cells_count() cells, the aggregate cell and the qualified
+        /// count of every aggr column, varchar cells are cloned into the arena.
+        /// distinct aggr columns are not supported.
+        bool has_distinct() const;
+        int64_t get_state_cells_count() const;
+        int init_state(const ObRow &row, common::ObExprObj *state, common::ModuleArena &arena);
+        int calc_state(const ObRow &row, common::ObExprObj *state, common::ModuleArena &arena);
+        /// @param group_row the first input row of the group
+        int get_state_result(const ObRow &group_row, common::ObExprObj *state, const ObRow *&row);
       private:
         // types and constants
         typedef common::hash::ObHashSet<const common::ObObj*> DedupSet;
@@ -58,9 +70,16 @@ namespace oceanbase
         // function members
         int aggr_get_cell(const uint64_t table_id, const uint64_t column_id, common::ObExprObj *&cell);
         int aux_get_cell(const uint64_t table_id, const uint64_t column_id, common::ObExprObj *&cell);
-        int init_aggr_cell(const ObItemType aggr_fun, const ObObj &oprand, ObExprObj &res1, ObExprObj &res2);
-        int calc_aggr_cell(const ObItemType aggr_fun, const ObObj &oprand, ObExprObj &res1, ObExprObj &res2);
-        int clone_expr_cell(const common::ObExprObj &cell, common::ObExprObj &cell_clone);
+        int init_aggr_cell(const ObItemType aggr_fun, const ObObj &oprand, ObExprObj &res1, ObExprObj &res2,
+                           common::ModuleArena *arena = NULL);
+        int calc_aggr_cell(const ObItemType aggr_fun, const ObObj &oprand, ObExprObj &res1, ObExprObj &res2,
+                           common::ModuleArena *arena = NULL);
+        int calc_result_cell(const ObItemType aggr_fun, ObExprObj &aggr_cell, ObExprObj &aux_cell,
+                             common::ObObj &res_cell);
+        int clone_expr_cell(const common::ObExprObj &cell, common::ObExprObj &cell_clone,
+                            common::ModuleArena *arena = NULL);
+        int arena_clone_expr_cell(const common::ObExprObj &cell, common::ObExprObj &cell_clone,
+                                  common::ModuleArena &arena);
         int clone_cell(const common::ObObj &cell, common::ObObj &cell_clone);
         int init_dedup_sets();
         void destroy_dedup_sets();
@@ -103,6 +122,16 @@ namespace oceanbase
     {
       return row_store_.get_used_mem_size();
     }
+
+    inline bool ObAggregateFunction::has_distinct() const
+    {
+      return 0 < dedup_row_desc_.get_column_num();
+    }
+
+    inline int64_t ObAggregateFunction::get_state_cells_count() const
+    {
+      return NULL == aggr_columns_ ? 0 : 2 * aggr_columns_->count();
+    }
   } // end namespace sql
 } // end namespace oceanbase
 
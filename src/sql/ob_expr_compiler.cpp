@@ -0,0 +1,1076 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_expr_compiler.cpp
+ *
+ * Authors:
+ *   Zhifeng YANG <zhuweng.yzf@taobao.com>
+ *
+ */
+#include "ob_expr_compiler.h"
+#include "ob_postfix_expression.h"
+#include <new>
+#include <algorithm>
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+#define NEW_EXPR_NODE(arena, node, T, args...)                        \
+  do                                                                  \
+  {                                                                   \
+    void *buf = (arena).alloc_aligned(sizeof(T));                     \
+    node = (NULL == buf) ? NULL : new(buf) T(args);                   \
+  } while (0)
+
+namespace oceanbase
+{
+  namespace sql
+  {
+    class ObExprNode
+    {
+      public:
+        enum NodeType
+        {
+          COLUMN_REF = 0,
+          CONST,          // literal or folded value
+          PARAM,          // question mark or variable, the value may change
+          OPERATOR
+        };
+      public:
+        ObExprNode(const NodeType type, const bool can_fail)
+          :type_(type), can_fail_(can_fail)
+        {
+        }
+        virtual ~ObExprNode()
+        {
+        }
+        virtual int eval(const ObRow &row, ObPostExprExtraParams &params, ObExprObj &result) const = 0;
+        NodeType get_type() const
+        {
+          return type_;
+        }
+        /// the error of the node should not be skipped by the short circuit of AND and OR
+        bool can_fail() const
+        {
+          return can_fail_;
+        }
+      protected:
+        NodeType type_;
+        bool can_fail_;
+    };
+
+    namespace
+    {
+      const int64_t NODE_PAGE_SIZE = 2 * 1024;
+      const int32_t MAX_OPERAND_COUNT = 3;
+
+      // locate the cell by the index got from the last row desc, the
+      // index is checked against the tid and cid before used
+      class ObColumnLocator
+      {
+        public:
+          ObColumnLocator(const uint64_t tid, const uint64_t cid)
+            :tid_(tid), cid_(cid), row_desc_(NULL), idx_(OB_INVALID_INDEX)
+          {
+          }
+          inline int get_cell(const ObRow &row, const ObObj *&cell) const
+          {
+            int ret = OB_SUCCESS;
+            uint64_t tid = OB_INVALID_ID;
+            uint64_t cid = OB_INVALID_ID;
+            if (OB_LIKELY(NULL != row_desc_ && row.get_row_desc() == row_desc_
+                          && 0 <= idx_ && idx_ < row.get_column_num())
+                && OB_SUCCESS == row.raw_get_cell(idx_, cell, tid, cid)
+                && tid == tid_ && cid == cid_)
+            {
+              // hit
+            }
+            else if (OB_SUCCESS != (ret = row.get_cell(tid_, cid_, cell)))
+            {
+              TBSYS_LOG(WARN, "fail to get cell from row. err=%d tid=%lu cid=%lu", ret, tid_, cid_);
+            }
+            else
+            {
+              row_desc_ = row.get_row_desc();
+              idx_ = row_desc_->get_idx(tid_, cid_);
+            }
+            return ret;
+          }
+        private:
+          uint64_t tid_;
+          uint64_t cid_;
+          mutable const ObRowDesc *row_desc_;
+          mutable int64_t idx_;
+      };
+
+      class ObColumnRefNode: public ObExprNode
+      {
+        public:
+          ObColumnRefNode(const uint64_t tid, const uint64_t cid)
+            :ObExprNode(COLUMN_REF, false), column_(tid, cid)
+          {
+          }
+          virtual int eval(const ObRow &row, ObPostExprExtraParams &params, ObExprObj &result) const
+          {
+            int ret = OB_SUCCESS;
+            const ObObj *cell = NULL;
+            UNUSED(params);
+            if (OB_SUCCESS == (ret = column_.get_cell(row, cell)))
+            {
+              result.assign(*cell);
+            }
+            return ret;
+          }
+          const ObColumnLocator &get_column() const
+          {
+            return column_;
+          }
+        private:
+          ObColumnLocator column_;
+      };
+
+      class ObConstNode: public ObExprNode
+      {
+        public:
+          ObConstNode(const ObObj &obj, const ObExprObj &value)
+            :ObExprNode(CONST, false), obj_(obj), value_(value)
+          {
+          }
+          virtual int eval(const ObRow &row, ObPostExprExtraParams &params, ObExprObj &result) const
+          {
+            UNUSED(row);
+            UNUSED(params);
+            result = value_;
+            return OB_SUCCESS;
+          }
+          const ObObj *get_obj() const
+          {
+            return &obj_;
+          }
+        private:
+          ObObj obj_;
+          ObExprObj value_;
+      };
+
+      class ObParamNode: public ObExprNode
+      {
+        public:
+          explicit ObParamNode(const ObObj *param)
+            :ObExprNode(PARAM, false), param_(param)
+          {
+          }
+          virtual int eval(const ObRow &row, ObPostExprExtraParams &params, ObExprObj &result) const
+          {
+            UNUSED(row);
+            UNUSED(params);
+            result.assign(*param_);
+            return OB_SUCCESS;
+          }
+          const ObObj *get_obj() const
+          {
+            return param_;
+          }
+        private:
+          const ObObj *param_;
+      };
+
+      // the object of a const or param node, NULL for other nodes
+      inline const ObObj *get_value_obj(const ObExprNode *node)
+      {
+        const ObObj *obj = NULL;
+        if (ObExprNode::CONST == node->get_type())
+        {
+          obj = static_cast<const ObConstNode*>(node)->get_obj();
+        }
+        else if (ObExprNode::PARAM == node->get_type())
+        {
+          obj = static_cast<const ObParamNode*>(node)->get_obj();
+        }
+        return obj;
+      }
+
+      // compare operators, calc() is the same operation used by the interpreter
+      struct ObCmpLt
+      {
+        static bool test(const int64_t v1, const int64_t v2) {return v1 < v2;}
+        static bool test(const ObString &v1, const ObString &v2) {return v1.compare(v2) < 0;}
+        static int calc(const ObExprObj &v1, const ObExprObj &v2, ObExprObj &res) {return v1.lt(v2, res);}
+      };
+
+      struct ObCmpLe
+      {
+        static bool test(const int64_t v1, const int64_t v2) {return v1 <= v2;}
+        static bool test(const ObString &v1, const ObString &v2) {return v1.compare(v2) <= 0;}
+        static int calc(const ObExprObj &v1, const ObExprObj &v2, ObExprObj &res) {return v1.le(v2, res);}
+      };
+
+      struct ObCmpGt
+      {
+        static bool test(const int64_t v1, const int64_t v2) {return v1 > v2;}
+        static bool test(const ObString &v1, const ObString &v2) {return v1.compare(v2) > 0;}
+        static int calc(const ObExprObj &v1, const ObExprObj &v2, ObExprObj &res) {return v1.gt(v2, res);}
+      };
+
+      struct ObCmpGe
+      {
+        static bool test(const int64_t v1, const int64_t v2) {return v1 >= v2;}
+        static bool test(const ObString &v1, const ObString &v2) {return v1.compare(v2) >= 0;}
+        static int calc(const ObExprObj &v1, const ObExprObj &v2, ObExprObj &res) {return v1.ge(v2, res);}
+      };
+
+      struct ObCmpEq
+      {
+        static bool test(const int64_t v1, const int64_t v2) {return v1 == v2;}
+        static bool test(const ObString &v1, const ObString &v2)
+        {
+          return v1.length() == v2.length() && 0 == v1.compare(v2);
+        }
+        static int calc(const ObExprObj &v1, const ObExprObj &v2, ObExprObj &res) {return v1.eq(v2, res);}
+      };
+
+      struct ObCmpNe
+      {
+        static bool test(const int64_t v1, const int64_t v2) {return v1 != v2;}
+        static bool test(const ObString &v1, const ObString &v2)
+        {
+          return v1.length() != v2.length() || 0 != v1.compare(v2);
+        }
+        static int calc(const ObExprObj &v1, const ObExprObj &v2, ObExprObj &res) {return v1.ne(v2, res);}
+      };
+
+      // column OP const, the const may also be a param
+      template <class Op>
+      class ObColumnCmpConstNode: public ObExprNode
+      {
+        public:
+          ObColumnCmpConstNode(const ObColumnLocator &column, const ObObj *value)
+            :ObExprNode(OPERATOR, false), column_(column), value_(value)
+          {
+          }
+          virtual int eval(const ObRow &row, ObPostExprExtraParams &params, ObExprObj &result) const
+          {
+            int ret = OB_SUCCESS;
+            const ObObj *cell = NULL;
+            UNUSED(params);
+            if (OB_SUCCESS != (ret = column_.get_cell(row, cell)))
+            {
+            }
+            else if (ObIntType == cell->get_type() && ObIntType == value_->get_type())
+            {
+              int64_t v1 = 0;
+              int64_t v2 = 0;
+              cell->get_int(v1);
+              value_->get_int(v2);
+              result.set_bool(Op::test(v1, v2));
+            }
+            else if (ObVarcharType == cell->get_type() && ObVarcharType == value_->get_type())
+            {
+              ObString v1;
+              ObString v2;
+              cell->get_varchar(v1);
+              value_->get_varchar(v2);
+              result.set_bool(Op::test(v1, v2));
+            }
+            else
+            {
+              ObExprObj v1;
+              ObExprObj v2;
+              v1.assign(*cell);
+              v2.assign(*value_);
+              Op::calc(v1, v2, result);
+            }
+            return ret;
+          }
+        private:
+          ObColumnLocator column_;
+          const ObObj *value_;
+      };
+
+      template <class Op>
+      class ObCmpNode: public ObExprNode
+      {
+        public:
+          ObCmpNode(const ObExprNode *left, const ObExprNode *right)
+            :ObExprNode(OPERATOR, left->can_fail() || right->can_fail()), left_(left), right_(right)
+          {
+          }
+          virtual int eval(const ObRow &row, ObPostExprExtraParams &params, ObExprObj &result) const
+          {
+            int ret = OB_SUCCESS;
+            ObExprObj v1;
+            ObExprObj v2;
+            if (OB_SUCCESS != (ret = left_->eval(row, params, v1)))
+            {
+            }
+            else if (OB_SUCCESS != (ret = right_->eval(row, params, v2)))
+            {
+            }
+            else if (ObIntType == v1.get_type() && ObIntType == v2.get_type())
+            {
+              result.set_bool(Op::test(v1.get_int(), v2.get_int()));
+            }
+            else if (ObVarcharType == v1.get_type() && ObVarcharType == v2.get_type())
+            {
+              result.set_bool(Op::test(v1.get_varchar(), v2.get_varchar()));
+            }
+            else
+            {
+              Op::calc(v1, v2, result);
+            }
+            return ret;
+          }
+        private:
+          const ObExprNode *left_;
+          const ObExprNode *right_;
+      };
+
+      // column [NOT] BETWEEN const AND const
+      template <bool IS_NOT>
+      class ObColumnBtwConstNode: public ObExprNode
+      {
+        public:
+          ObColumnBtwConstNode(const ObColumnLocator &column, const ObObj *low, const ObObj *high)
+            :ObExprNode(OPERATOR, false), column_(column), low_(low), high_(high)
+          {
+          }
+          virtual int eval(const ObRow &row, ObPostExprExtraParams &params, ObExprObj &result) const
+          {
+            int ret = OB_SUCCESS;
+            const ObObj *cell = NULL;
+            UNUSED(params);
+            if (OB_SUCCESS != (ret = column_.get_cell(row, cell)))
+            {
+            }
+            else if (ObIntType == cell->get_type()
+                     && ObIntType == low_->get_type() && ObIntType == high_->get_type())
+            {
+              int64_t value = 0;
+              int64_t low = 0;
+              int64_t high = 0;
+              cell->get_int(value);
+              low_->get_int(low);
+              high_->get_int(high);
+              result.set_bool(IS_NOT ? (value < low || value > high) : (low <= value && value <= high));
+            }
+            else
+            {
+              ObExprObj value;
+              ObExprObj low;
+              ObExprObj high;
+              value.assign(*cell);
+              low.assign(*low_);
+              high.assign(*high_);
+              if (IS_NOT)
+              {
+                value.not_btw(low, high, result);
+              }
+              else
+              {
+                value.btw(low, high, result);
+              }
+            }
+            return ret;
+          }
+        private:
+          ObColumnLocator column_;
+          const ObObj *low_;
+          const ObObj *high_;
+      };
+
+      enum ObLikeKind
+      {
+        LIKE_EXACT = 0,         // 'abc'
+        LIKE_PREFIX,            // 'abc%'
+        LIKE_SUFFIX,            // '%abc'
+        LIKE_SUBSTR,            // '%abc%'
+        LIKE_ANY                // '%'
+      };
+
+      // only the patterns whose result of ObStringSearch::is_matched() is
+      // obvious are recognized, patterns with '_' or escapes are not
+      bool analyze_like_pattern(const ObString &pattern, ObLikeKind &kind, ObString &literal)
+      {
+        bool ret = true;
+        const char *ptr = pattern.ptr();
+        const int32_t len = pattern.length();
+        int32_t lead = 0;
+        int32_t trail = 0;
+        while (lead < len && '%' == ptr[lead])
+        {
+          ++lead;
+        }
+        while (trail < len - lead && '%' == ptr[len - trail - 1])
+        {
+          ++trail;
+        }
+        literal.assign_ptr(const_cast<char*>(ptr + lead), len - lead - trail);
+        for (int32_t i = 0; ret && i < literal.length(); ++i)
+        {
+          if ('%' == literal.ptr()[i] || '_' == literal.ptr()[i] || '\\' == literal.ptr()[i])
+          {
+            ret = false;
+          }
+        }
+        if (!ret)
+        {
+        }
+        else if (0 < len && lead == len)
+        {
+          kind = LIKE_ANY;
+        }
+        else if (0 == lead && 0 == trail)
+        {
+          kind = LIKE_EXACT;
+        }
+        else if (0 == lead)
+        {
+          kind = LIKE_PREFIX;
+        }
+        else if (0 == trail)
+        {
+          // the matcher treats '%%abc' differently, leave it alone
+          ret = (1 == lead);
+          kind = LIKE_SUFFIX;
+        }
+        else
+        {
+          kind = LIKE_SUBSTR;
+        }
+        return ret;
+      }
+
+      inline bool contains(const ObString &text, const ObString &literal)
+      {
+        bool found = false;
+        if (text.length() >= literal.length())
+        {
+          const char *pos = text.ptr();
+          const char *last = text.ptr() + (text.length() - literal.length());
+          while (!found && NULL != pos && pos <= last)
+          {
+            pos = static_cast<const char*>(memchr(pos, literal.ptr()[0], static_cast<size_t>(last - pos + 1)));
+            if (NULL == pos)
+            {
+            }
+            else if (0 == memcmp(pos + 1, literal.ptr() + 1, literal.length() - 1))
+            {
+              found = true;
+            }
+            else
+            {
+              ++pos;
+            }
+          }
+        }
+        return found;
+      }
+
+      // column [NOT] LIKE pattern, the pattern is analyzed when compiled
+      template <bool IS_NOT>
+      class ObColumnLikeConstNode: public ObExprNode
+      {
+        public:
+          ObColumnLikeConstNode(const ObColumnLocator &column, const ObObj *pattern,
+                                const ObLikeKind kind, const ObString &literal)
+            // like returns error for non-varchar values
+            :ObExprNode(OPERATOR, !IS_NOT), column_(column), pattern_(pattern),
+             kind_(kind), literal_(literal)
+          {
+          }
+          virtual int eval(const ObRow &row, ObPostExprExtraParams &params, ObExprObj &result) const
+          {
+            int ret = OB_SUCCESS;
+            const ObObj *cell = NULL;
+            UNUSED(params);
+            if (OB_SUCCESS != (ret = column_.get_cell(row, cell)))
+            {
+            }
+            else if (ObVarcharType == cell->get_type())
+            {
+              ObString text;
+              cell->get_varchar(text);
+              bool matched = match(text);
+              result.set_bool(IS_NOT ? !matched : matched);
+            }
+            else
+            {
+              ObExprObj value;
+              ObExprObj pattern;
+              value.assign(*cell);
+              pattern.assign(*pattern_);
+              if (IS_NOT)
+              {
+                value.not_like(pattern, result);
+              }
+              else if (OB_SUCCESS != (ret = value.like(pattern, result)))
+              {
+                TBSYS_LOG(WARN, "failed to calc like, err=%d type=%d", ret, cell->get_type());
+              }
+            }
+            return ret;
+          }
+        private:
+          inline bool match(const ObString &text) const
+          {
+            bool matched = false;
+            const int32_t len = literal_.length();
+            switch(kind_)
+            {
+              case LIKE_EXACT:
+                matched = (text.length() == len && (0 == len || 0 == memcmp(text.ptr(), literal_.ptr(), len)));
+                break;
+              case LIKE_PREFIX:
+                matched = (text.length() >= len && 0 == memcmp(text.ptr(), literal_.ptr(), len));
+                break;
+              case LIKE_SUFFIX:
+                matched = (text.length() >= len
+                           && 0 == memcmp(text.ptr() + (text.length() - len), literal_.ptr(), len));
+                break;
+              case LIKE_SUBSTR:
+                matched = contains(text, literal_);
+                break;
+              case LIKE_ANY:
+                matched = true;
+                break;
+              default:
+                break;
+            }
+            return matched;
+          }
+        private:
+          ObColumnLocator column_;
+          const ObObj *pattern_;
+          ObLikeKind kind_;
+          ObString literal_;
+      };
+
+      // FALSE AND x is FALSE whatever x is, the right side is skipped
+      // unless its error has to be reported
+      class ObAndNode: public ObExprNode
+      {
+        public:
+          ObAndNode(const ObExprNode *left, const ObExprNode *right)
+            :ObExprNode(OPERATOR, left->can_fail() || right->can_fail()), left_(left), right_(right)
+          {
+          }
+          virtual int eval(const ObRow &row, ObPostExprExtraParams &params, ObExprObj &result) const
+          {
+            int ret = OB_SUCCESS;
+            ObExprObj left;
+            ObExprObj right;
+            if (OB_SUCCESS != (ret = left_->eval(row, params, left)))
+            {
+            }
+            else if (left.is_false() && !right_->can_fail())
+            {
+              result.set_bool(false);
+            }
+            else if (OB_SUCCESS != (ret = right_->eval(row, params, right)))
+            {
+            }
+            else
+            {
+              left.land(right, result);
+            }
+            return ret;
+          }
+        private:
+          const ObExprNode *left_;
+          const ObExprNode *right_;
+      };
+
+      // TRUE OR x is TRUE whatever x is
+      class ObOrNode: public ObExprNode
+      {
+        public:
+          ObOrNode(const ObExprNode *left, const ObExprNode *right)
+            :ObExprNode(OPERATOR, left->can_fail() || right->can_fail()), left_(left), right_(right)
+          {
+          }
+          virtual int eval(const ObRow &row, ObPostExprExtraParams &params, ObExprObj &result) const
+          {
+            int ret = OB_SUCCESS;
+            ObExprObj left;
+            ObExprObj right;
+            if (OB_SUCCESS != (ret = left_->eval(row, params, left)))
+            {
+            }
+            else if (left.is_true() && !right_->can_fail())
+            {
+              result.set_bool(true);
+            }
+            else if (OB_SUCCESS != (ret = right_->eval(row, params, right)))
+            {
+            }
+            else
+            {
+              left.lor(right, result);
+            }
+            return ret;
+          }
+        private:
+          const ObExprNode *left_;
+          const ObExprNode *right_;
+      };
+
+      // other operators, evaluated by the function of the interpreter
+      class ObOperatorNode: public ObExprNode
+      {
+        public:
+          ObOperatorNode(const int64_t op, const op_call_func_t func,
+                         const int32_t operand_count, ObExprNode * const *operands)
+            :ObExprNode(OPERATOR, T_OP_LIKE == op), op_(op), func_(func), operand_count_(operand_count)
+          {
+            for (int32_t i = 0; i < operand_count_; ++i)
+            {
+              operands_[i] = operands[i];
+              can_fail_ = can_fail_ || operands[i]->can_fail();
+            }
+          }
+          virtual int eval(const ObRow &row, ObPostExprExtraParams &params, ObExprObj &result) const
+          {
+            int ret = OB_SUCCESS;
+            ObExprObj stack[MAX_OPERAND_COUNT];
+            int idx = 0;
+            for (int32_t i = 0; OB_SUCCESS == ret && i < operand_count_; ++i)
+            {
+              ret = operands_[i]->eval(row, params, stack[idx++]);
+            }
+            if (OB_SUCCESS == ret)
+            {
+              params.operand_count_ = operand_count_;
+              if (OB_SUCCESS != (ret = func_(stack, idx, result, params)))
+              {
+                TBSYS_LOG(WARN, "call calculation function error [op:%ld, err:%d]", op_, ret);
+              }
+            }
+            return ret;
+          }
+        private:
+          int64_t op_;
+          op_call_func_t func_;
+          int32_t operand_count_;
+          const ObExprNode *operands_[MAX_OPERAND_COUNT];
+      };
+
+      // operand count of the operators which can be compiled, -1 for others
+      int32_t get_operand_count(const int64_t op)
+      {
+        int32_t count = -1;
+        switch(op)
+        {
+          case T_OP_NEG:
+          case T_OP_POS:
+          case T_OP_NOT:
+            count = 1;
+            break;
+          case T_OP_ADD:
+          case T_OP_MINUS:
+          case T_OP_MUL:
+          case T_OP_DIV:
+          case T_OP_REM:
+          case T_OP_MOD:
+          case T_OP_EQ:
+          case T_OP_LE:
+          case T_OP_LT:
+          case T_OP_GE:
+          case T_OP_GT:
+          case T_OP_NE:
+          case T_OP_IS:
+          case T_OP_IS_NOT:
+          case T_OP_LIKE:
+          case T_OP_NOT_LIKE:
+          case T_OP_AND:
+          case T_OP_OR:
+          case T_OP_CNN:
+            count = 2;
+            break;
+          case T_OP_BTW:
+          case T_OP_NOT_BTW:
+            count = 3;
+            break;
+          default:
+            break;
+        }
+        return count;
+      }
+
+      // const OP column => column OP' const
+      int64_t swap_compare_op(const int64_t op)
+      {
+        int64_t ret = op;
+        switch(op)
+        {
+          case T_OP_LT:
+            ret = T_OP_GT;
+            break;
+          case T_OP_LE:
+            ret = T_OP_GE;
+            break;
+          case T_OP_GT:
+            ret = T_OP_LT;
+            break;
+          case T_OP_GE:
+            ret = T_OP_LE;
+            break;
+          default:
+            break;
+        }
+        return ret;
+      }
+
+      template <class Op>
+      int new_compare_node(ModuleArena &arena, const ObExprNode *left, const ObExprNode *right,
+                           ObExprNode *&node)
+      {
+        int ret = OB_SUCCESS;
+        const ObObj *value = get_value_obj(right);
+        if (ObExprNode::COLUMN_REF == left->get_type() && NULL != value)
+        {
+          const ObColumnLocator &column = static_cast<const ObColumnRefNode*>(left)->get_column();
+          NEW_EXPR_NODE(arena, node, ObColumnCmpConstNode<Op>, column, value);
+        }
+        else
+        {
+          NEW_EXPR_NODE(arena, node, ObCmpNode<Op>, left, right);
+        }
+        if (NULL == node)
+        {
+          ret = OB_ALLOCATE_MEMORY_FAILED;
+        }
+        return ret;
+      }
+
+      int new_compare_node(ModuleArena &arena, int64_t op, ObExprNode *left, ObExprNode *right,
+                           ObExprNode *&node)
+      {
+        int ret = OB_SUCCESS;
+        if (ObExprNode::COLUMN_REF == right->get_type() && NULL != get_value_obj(left))
+        {
+          std::swap(left, right);
+          op = swap_compare_op(op);
+        }
+        switch(op)
+        {
+          case T_OP_LT:
+            ret = new_compare_node<ObCmpLt>(arena, left, right, node);
+            break;
+          case T_OP_LE:
+            ret = new_compare_node<ObCmpLe>(arena, left, right, node);
+            break;
+          case T_OP_GT:
+            ret = new_compare_node<ObCmpGt>(arena, left, right, node);
+            break;
+          case T_OP_GE:
+            ret = new_compare_node<ObCmpGe>(arena, left, right, node);
+            break;
+          case T_OP_EQ:
+            ret = new_compare_node<ObCmpEq>(arena, left, right, node);
+            break;
+          case T_OP_NE:
+            ret = new_compare_node<ObCmpNe>(arena, left, right, node);
+            break;
+          default:
+            ret = OB_ERR_UNEXPECTED;
+            TBSYS_LOG(ERROR, "not a compare operator, op=%ld", op);
+            break;
+        }
+        return ret;
+      }
+
+      // create the specialized node if the operands fit, node is NULL otherwise
+      int new_special_node(ModuleArena &arena, const int64_t op, ObExprNode * const *operands,
+                           ObExprNode *&node)
+      {
+        int ret = OB_SUCCESS;
+        node = NULL;
+        switch(op)
+        {
+          case T_OP_LT:
+          case T_OP_LE:
+          case T_OP_GT:
+          case T_OP_GE:
+          case T_OP_EQ:
+          case T_OP_NE:
+            ret = new_compare_node(arena, op, operands[0], operands[1], node);
+            break;
+          case T_OP_BTW:
+          case T_OP_NOT_BTW:
+          {
+            const ObObj *low = get_value_obj(operands[1]);
+            const ObObj *high = get_value_obj(operands[2]);
+            if (ObExprNode::COLUMN_REF == operands[0]->get_type() && NULL != low && NULL != high)
+            {
+              const ObColumnLocator &column = static_cast<const ObColumnRefNode*>(operands[0])->get_column();
+              if (T_OP_BTW == op)
+              {
+                NEW_EXPR_NODE(arena, node, ObColumnBtwConstNode<false>, column, low, high);
+              }
+              else
+              {
+                NEW_EXPR_NODE(arena, node, ObColumnBtwConstNode<true>, column, low, high);
+              }
+              if (NULL == node)
+              {
+                ret = OB_ALLOCATE_MEMORY_FAILED;
+              }
+            }
+            break;
+          }
+          case T_OP_LIKE:
+          case T_OP_NOT_LIKE:
+          {
+            // the pattern of a param may change, only literals are analyzed
+            const ObObj *pattern = NULL;
+            ObString pattern_str;
+            ObString literal;
+            ObLikeKind kind = LIKE_EXACT;
+            if (ObExprNode::COLUMN_REF == operands[0]->get_type()
+                && ObExprNode::CONST == operands[1]->get_type()
+                && NULL != (pattern = get_value_obj(operands[1]))
+                && OB_SUCCESS == pattern->get_varchar(pattern_str)
+                && analyze_like_pattern(pattern_str, kind, literal))
+            {
+              const ObColumnLocator &column = static_cast<const ObColumnRefNode*>(operands[0])->get_column();
+              if (T_OP_LIKE == op)
+              {
+                NEW_EXPR_NODE(arena, node, ObColumnLikeConstNode<false>, column, pattern, kind, literal);
+              }
+              else
+              {
+                NEW_EXPR_NODE(arena, node, ObColumnLikeConstNode<true>, column, pattern, kind, literal);
+              }
+              if (NULL == node)
+              {
+                ret = OB_ALLOCATE_MEMORY_FAILED;
+              }
+            }
+            break;
+          }
+          case T_OP_AND:
+            NEW_EXPR_NODE(arena, node, ObAndNode, operands[0], operands[1]);
+            if (NULL == node)
+            {
+              ret = OB_ALLOCATE_MEMORY_FAILED;
+            }
+            break;
+          case T_OP_OR:
+            NEW_EXPR_NODE(arena, node, ObOrNode, operands[0], operands[1]);
+            if (NULL == node)
+            {
+              ret = OB_ALLOCATE_MEMORY_FAILED;
+            }
+            break;
+          default:
+            break;
+        }
+        return ret;
+      }
+    } // end anonymous namespace
+  } // end namespace sql
+} // end namespace oceanbase
+
+ObExprCompiler::ObExprCompiler()
+  :arena_(NODE_PAGE_SIZE, ModulePageAllocator(ObModIds::OB_SQL_EXPR)),
+   root_(NULL), state_(NOT_COMPILED)
+{
+}
+
+ObExprCompiler::~ObExprCompiler()
+{
+  reset();
+}
+
+void ObExprCompiler::reset()
+{
+  // nodes hold no resources, free the memory only
+  root_ = NULL;
+  state_ = NOT_COMPILED;
+  arena_.free();
+}
+
+int ObExprCompiler::compile(const ObPostfixExpression &expr, ObPostExprExtraParams &params)
+{
+  int ret = OB_SUCCESS;
+  const ObPostfixExpression::ExprArray &items = expr.expr_;
+  ObExprNode *stack[ObPostfixExpressionCalcStack::STACK_SIZE];
+  int32_t top = 0;
+  int64_t idx = 0;
+  int64_t type = 0;
+  bool is_end = false;
+  reset();
+  while (OB_SUCCESS == ret && !is_end)
+  {
+    ObExprNode *node = NULL;
+    if (idx >= items.count() || OB_SUCCESS != items[idx++].get_int(type))
+    {
+      // broken expression, let the interpreter report it
+      ret = OB_NOT_SUPPORTED;
+    }
+    else if (ObPostfixExpression::END == type)
+    {
+      is_end = true;
+      if (1 != top)
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+    }
+    else if (ObPostfixExpression::COLUMN_IDX == type)
+    {
+      int64_t tid = 0;
+      int64_t cid = 0;
+      if (idx + 2 > items.count()
+          || OB_SUCCESS != items[idx++].get_int(tid)
+          || OB_SUCCESS != items[idx++].get_int(cid))
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else
+      {
+        NEW_EXPR_NODE(arena_, node, ObColumnRefNode, static_cast<uint64_t>(tid), static_cast<uint64_t>(cid));
+      }
+    }
+    else if (ObPostfixExpression::CONST_OBJ == type)
+    {
+      if (idx >= items.count())
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else if (ObExtendType == items[idx].get_type())
+      {
+        int64_t obj_addr = 0;
+        items[idx++].get_ext(obj_addr);
+        NEW_EXPR_NODE(arena_, node, ObParamNode, reinterpret_cast<const ObObj*>(obj_addr));
+      }
+      else
+      {
+        ObExprObj value;
+        value.assign(items[idx]);
+        NEW_EXPR_NODE(arena_, node, ObConstNode, items[idx], value);
+        ++idx;
+      }
+    }
+    else if (ObPostfixExpression::OP == type)
+    {
+      int64_t op = 0;
+      int64_t operand_count = 0;
+      if (idx + 2 > items.count()
+          || OB_SUCCESS != items[idx++].get_int(op)
+          || OB_SUCCESS != items[idx++].get_int(operand_count))
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else if (0 > get_operand_count(op)
+               || operand_count != get_operand_count(op)
+               || top < operand_count)
+      {
+        // system functions, IN, CASE etc.
+        ret = OB_NOT_SUPPORTED;
+      }
+      else
+      {
+        top -= static_cast<int32_t>(operand_count);
+        ret = make_operator(op, static_cast<int32_t>(operand_count), stack + top, params, node);
+      }
+    }
+    else
+    {
+      ret = OB_NOT_SUPPORTED;
+    }
+
+    if (OB_SUCCESS != ret || is_end)
+    {
+    }
+    else if (NULL == node)
+    {
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+      TBSYS_LOG(WARN, "no memory for expression node");
+    }
+    else if (top >= ObPostfixExpressionCalcStack::STACK_SIZE)
+    {
+      ret = OB_NOT_SUPPORTED;
+    }
+    else
+    {
+      stack[top++] = node;
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    root_ = stack[0];
+    state_ = COMPILED;
+  }
+  else
+  {
+    reset();
+    state_ = NOT_COMPILABLE;
+    if (OB_NOT_SUPPORTED != ret)
+    {
+      TBSYS_LOG(WARN, "failed to compile expression, interpret it, err=%d", ret);
+    }
+  }
+  return ret;
+}
+
+int ObExprCompiler::make_operator(const int64_t op, const int32_t operand_count, ObExprNode **operands,
+                                  ObPostExprExtraParams &params, ObExprNode *&node)
+{
+  int ret = OB_SUCCESS;
+  bool all_const = true;
+  for (int32_t i = 0; i < operand_count; ++i)
+  {
+    if (ObExprNode::CONST != operands[i]->get_type())
+    {
+      all_const = false;
+      break;
+    }
+  }
+  if (OB_SUCCESS != (ret = new_special_node(arena_, op, operands, node)))
+  {
+    TBSYS_LOG(WARN, "failed to create expression node, err=%d op=%ld", ret, op);
+  }
+  else if (NULL == node)
+  {
+    NEW_EXPR_NODE(arena_, node, ObOperatorNode, op, ObPostfixExpression::call_func[op - T_MIN_OP - 1],
+                 operand_count, operands);
+  }
+  if (OB_SUCCESS == ret && NULL != node && all_const)
+  {
+    // the value of literals never changes, calc it once
+    ObRow row;
+    ObExprObj value;
+    ObObj obj;
+    ObExprNode *folded = NULL;
+    if (OB_SUCCESS != node->eval(row, params, value)
+        || OB_SUCCESS != value.to(obj))
+    {
+      // keep the node, the error is reported when calculated
+    }
+    else
+    {
+      NEW_EXPR_NODE(arena_, folded, ObConstNode, obj, value);
+      node = folded;
+    }
+  }
+  return ret;
+}
+
+int ObExprCompiler::calc(const ObRow &row, ObPostExprExtraParams &params, ObExprObj &result) const
+{
+  int ret = OB_SUCCESS;
+  if (OB_UNLIKELY(NULL == root_))
+  {
+    ret = OB_NOT_INIT;
+    TBSYS_LOG(ERROR, "expression not compiled");
+  }
+  else
+  {
+    ret = root_->eval(row, params, result);
+  }
+  return ret;
+}
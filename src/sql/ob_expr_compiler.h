@@ -0,0 +1,83 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_expr_compiler.h
+ *
+ * Authors:
+ *   Zhifeng YANG <zhuweng.yzf@taobao.com>
+ *
+ */
+#ifndef _OB_EXPR_COMPILER_H
+#define _OB_EXPR_COMPILER_H 1
+#include "common/ob_row.h"
+#include "common/ob_expr_obj.h"
+#include "common/page_arena.h"
+
+namespace oceanbase
+{
+  namespace sql
+  {
+    class ObPostfixExpression;
+    struct ObPostExprExtraParams;
+    class ObExprNode;
+
+    // compile a postfix expression into a tree of evaluators
+    //
+    // every operator becomes a node specialized for its operator and the
+    // shape of its operands, e.g. `column > const', `column BETWEEN const
+    // AND const' and `column LIKE const' with the pattern analyzed once.
+    // the types of the cells are only known when the rows come, so the
+    // specialized nodes take the int64 or varchar fast path when the types
+    // match and use the same ObExprObj operation as the interpreter
+    // otherwise. operators whose operands are all literals are folded.
+    // expressions with operators which are not supported, e.g. IN, CASE
+    // and system functions, are left to the interpreter.
+    class ObExprCompiler
+    {
+      public:
+        ObExprCompiler();
+        virtual ~ObExprCompiler();
+        /**
+         * compile the expression, call it only once after the expression is built
+         * @return OB_NOT_SUPPORTED if the expression should be interpreted
+         */
+        int compile(const ObPostfixExpression &expr, ObPostExprExtraParams &params);
+        /// drop the compiled expression, compile() can be called again
+        void reset();
+        bool is_compiled() const;
+        int calc(const common::ObRow &row, ObPostExprExtraParams &params, common::ObExprObj &result) const;
+      private:
+        // disallow copy
+        ObExprCompiler(const ObExprCompiler &other);
+        ObExprCompiler& operator=(const ObExprCompiler &other);
+
+        int make_operator(const int64_t op, const int32_t operand_count, ObExprNode **operands,
+                          ObPostExprExtraParams &params, ObExprNode *&node);
+      private:
+        enum State
+        {
+          NOT_COMPILED = 0,
+          COMPILED,
+          NOT_COMPILABLE
+        };
+      private:
+        // data members
+        common::ModuleArena arena_;
+        ObExprNode *root_;
+        State state_;
+    };
+
+    inline bool ObExprCompiler::is_compiled() const
+    {
+      return COMPILED == state_;
+    }
+  } // end namespace sql
+} // end namespace oceanbase
+
+#endif /* _OB_EXPR_COMPILER_H */
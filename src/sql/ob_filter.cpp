@@ -57,11 +57,22 @@ int ObFilter::add_filter(ObSqlExpression* expr)
 
 int ObFilter::open()
 {
-  return ObSingleChildPhyOperator::open();
+  int ret = OB_SUCCESS;
+  if (OB_SUCCESS != (ret = ObSingleChildPhyOperator::open()))
+  {
+    TBSYS_LOG(WARN, "failed to open child_op, err=%d", ret);
+  }
+  else if (child_op_->is_batch_native()
+           && OB_SUCCESS != (ret = batch_reader_.open(*this)))
+  {
+    TBSYS_LOG(WARN, "failed to open batch reader, err=%d", ret);
+  }
+  return ret;
 }
 
 int ObFilter::close()
 {
+  batch_reader_.close();
   return ObSingleChildPhyOperator::close();
 }
 
@@ -80,6 +91,27 @@ int ObFilter::get_row_desc(const common::ObRowDesc *&row_desc) const
   return ret;
 }
 
+int ObFilter::check_filters(const common::ObRow &row, bool &did_output)
+{
+  int ret = OB_SUCCESS;
+  const ObObj *result = NULL;
+  did_output = true;
+  dlist_for_each(ObSqlExpression, p, filters_)
+  {
+    if (OB_SUCCESS != (ret = p->calc(row, result)))
+    {
+      TBSYS_LOG(WARN, "failed to calc expression, err=%d", ret);
+      break;
+    }
+    else if (!result->is_true())
+    {
+      did_output = false;
+      break;
+    }
+  } // end for
+  return ret;
+}
+
 int ObFilter::get_next_row(const common::ObRow *&row)
 {
   int ret = OB_SUCCESS;
@@ -89,37 +121,78 @@ int ObFilter::get_next_row(const common::ObRow *&row)
     ret = OB_NOT_INIT;
     TBSYS_LOG(ERROR, "child_op_ is NULL");
   }
+  else if (batch_reader_.is_opened())
+  {
+    ret = batch_reader_.get_next_row(row);
+  }
   else
   {
-    const ObObj *result = NULL;
     bool did_output = true;
     while(OB_SUCCESS == ret
           && OB_SUCCESS == (ret = child_op_->get_next_row(input_row)))
     {
-      did_output = true;
-      dlist_for_each(ObSqlExpression, p, filters_)
+      if (OB_SUCCESS != (ret = check_filters(*input_row, did_output)))
+      {
+        break;
+      }
+      else if (did_output)
+      {
+        row = input_row;
+        break;
+      }
+    } // end while
+  }
+  return ret;
+}
+
+int ObFilter::get_next_batch(ObRowBatch &batch)
+{
+  int ret = OB_SUCCESS;
+  if (OB_UNLIKELY(NULL == child_op_))
+  {
+    ret = OB_NOT_INIT;
+    TBSYS_LOG(ERROR, "child_op_ is NULL");
+  }
+  else
+  {
+    bool did_output = true;
+    int64_t output_count = 0;
+    while (OB_SUCCESS == ret && 0 == output_count
+           && OB_SUCCESS == (ret = child_op_->get_next_batch(batch)))
+    {
+      int64_t *selection = batch.get_selection();
+      const int64_t input_count = batch.get_row_count();
+      for (int64_t i = 0; i < input_count; ++i)
       {
-        if (OB_SUCCESS != (ret = p->calc(*input_row, result)))
+        if (OB_SUCCESS != (ret = batch.get_row(i, input_row_)))
         {
-          TBSYS_LOG(WARN, "failed to calc expression, err=%d", ret);
+          TBSYS_LOG(WARN, "failed to get row from batch, err=%d", ret);
           break;
         }
-        else if (!result->is_true())
+        else if (OB_SUCCESS != (ret = check_filters(input_row_, did_output)))
         {
-          did_output = false;
           break;
         }
+        else if (did_output)
+        {
+          selection[output_count++] = selection[i];
+        }
       } // end for
-      if (did_output)
+      if (OB_SUCCESS == ret)
       {
-        row = input_row;
-        break;
+        batch.set_row_count(output_count);
       }
     } // end while
   }
   return ret;
 }
 
+bool ObFilter::is_batch_native() const
+{
+  // only worth reading by batches if the child produces batches itself
+  return NULL != child_op_ && child_op_->is_batch_native();
+}
+
 int64_t ObFilter::to_string(char* buf, const int64_t buf_len) const
 {
   int64_t pos = 0;
@@ -17,6 +17,7 @@
 #define _OB_FILTER_H 1
 #include "ob_single_child_phy_operator.h"
 #include "ob_sql_expression.h"
+#include "ob_row_batch.h"
 #include "common/dlist.h"
 
 namespace oceanbase
@@ -42,6 +43,9 @@ namespace oceanbase
         virtual int open();
         virtual int close();
         virtual int get_next_row(const common::ObRow *&row);
+        /// filter the rows of the child batch in place by the selection vector
+        virtual int get_next_batch(ObRowBatch &batch);
+        virtual bool is_batch_native() const;
         virtual int get_row_desc(const common::ObRowDesc *&row_desc) const;
         virtual int64_t to_string(char* buf, const int64_t buf_len) const;
         void assign(const ObFilter &other);
@@ -52,9 +56,12 @@ namespace oceanbase
         // disallow copy
         ObFilter(const ObFilter &other);
         ObFilter& operator=(const ObFilter &other);
+        int check_filters(const common::ObRow &row, bool &did_output);
       private:
         // data members
         common::DList filters_;
+        common::ObRow input_row_;
+        ObRowBatchReader batch_reader_; // used if the child is batch native
     };
   } // end namespace sql
 } // end namespace oceanbase
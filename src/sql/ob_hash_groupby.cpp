@@ -14,51 +14,699 @@
  *
  */
 #include "ob_hash_groupby.h"
+#include "common/utility.h"
+#include "common/ob_row_util.h"
+#include "ob_physical_plan.h"
+#include <sys/stat.h>
+#include <unistd.h>
 using namespace oceanbase::sql;
-/*
-int ObHashGroupBy::open()
+using namespace oceanbase::common;
+using namespace oceanbase::common::serialization;
+
+const char* const ObHashGroupBy::DEFAULT_RUN_FILE_PREFIX = "/tmp/ob_hash_groupby";
+
+ObHashGroupBy::ObHashGroupBy()
+  :group_store_(ObModIds::OB_SQL_HASH_GROUPBY),
+   arena_(ModuleArena::DEFAULT_PAGE_SIZE, ModulePageAllocator(ObModIds::OB_SQL_HASH_GROUPBY)),
+   buckets_(NULL), bucket_num_(0), group_idx_(0),
+   spill_level_(0), spill_file_count_(0)
+{
+  run_filename_buf_[0] = '\0';
+}
+
+ObHashGroupBy::~ObHashGroupBy()
 {
-  构造row_desc_;
-  // 从子运算符读取所有数据，插入桶中
-  child_op_->open();
-  const common::ObRow *row = NULL;
-  for(child_op_->get_next_row(row))
+  destroy_partitions();
+  if (NULL != buckets_)
   {
-    根据groupby列计算row归属的hash桶ID;
-    add_to_backet(backet_idx, row);
+    ob_free(buckets_, ObModIds::OB_SQL_HASH_GROUPBY);
+    buckets_ = NULL;
   }
-  child_op_->close();
-  for(每个桶)
+}
+
+void ObHashGroupBy::reset()
+{
+  ObGroupBy::reset();
+  aggr_func_.reset();
+  destroy_partitions();
+  reuse_groups();
+  group_column_idxs_.clear();
+  group_store_.clear();
+  run_filename_buf_[0] = '\0';
+  run_filename_.assign_ptr(NULL, 0);
+  spill_level_ = 0;
+  spill_file_count_ = 0;
+}
+
+int ObHashGroupBy::set_run_filename(const common::ObString &filename)
+{
+  int ret = OB_SUCCESS;
+  // leave room for the ".<seq>" suffix of every spill file
+  if (filename.length() >= OB_MAX_FILE_NAME_LENGTH - 32)
   {
-    根据groupby列排序这个桶的内容，如果必要使用外排。
+    TBSYS_LOG(ERROR, "filename is too long, filename=%.*s", filename.length(), filename.ptr());
+    ret = OB_BUF_NOT_ENOUGH;
   }
+  else
+  {
+    snprintf(run_filename_buf_, OB_MAX_FILE_NAME_LENGTH, "%.*s", filename.length(), filename.ptr());
+    run_filename_.assign_ptr(run_filename_buf_, filename.length());
+  }
+  return ret;
 }
 
-int ObHashGroupBy::add_to_backet(const int64_t backet_idx, const common::ObRow* row)
+int ObHashGroupBy::open()
 {
-  把row写入第backet_idx个桶中;  // 内存存储结构同ObSort，采用common::ObRow和ObCompactRow结合的方式
-  if (第backet_idx个桶大小超过backet_mem_size)
+  int ret = OB_SUCCESS;
+  const ObRowDesc *child_row_desc = NULL;
+  if (OB_SUCCESS != (ret = ObGroupBy::open()))
+  {
+    TBSYS_LOG(WARN, "failed to open child op, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = child_op_->get_row_desc(child_row_desc)))
+  {
+    TBSYS_LOG(WARN, "failed to get child row desc, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = aggr_func_.init(*child_row_desc, aggr_columns_)))
+  {
+    TBSYS_LOG(WARN, "failed to construct row desc, err=%d", ret);
+  }
+  else if (aggr_func_.has_distinct())
+  {
+    TBSYS_LOG(WARN, "distinct aggregate function is not supported by hash group by");
+    ret = OB_NOT_SUPPORTED;
+  }
+  else if (OB_SUCCESS != (ret = init_group_columns(*child_row_desc)))
   {
-    dump这个桶到磁盘;
+    TBSYS_LOG(WARN, "failed to init group columns, err=%d", ret);
   }
+  else if (OB_SUCCESS != (ret = init_buckets()))
+  {
+    TBSYS_LOG(WARN, "failed to init hash buckets, err=%d", ret);
+  }
+  else
+  {
+    input_row_.set_row_desc(*child_row_desc);
+    group_row_.set_row_desc(*child_row_desc);
+    if (0 >= run_filename_.length())
+    {
+      int len = snprintf(run_filename_buf_, OB_MAX_FILE_NAME_LENGTH, "%s.%d.%p",
+                         DEFAULT_RUN_FILE_PREFIX, getpid(), this);
+      run_filename_.assign_ptr(run_filename_buf_, len);
+    }
+    spill_level_ = 0;
+    if (OB_SUCCESS != (ret = aggregate_child()))
+    {
+      TBSYS_LOG(WARN, "failed to aggregate input rows, err=%d", ret);
+    }
+  }
+  return ret;
 }
 
 int ObHashGroupBy::close()
 {
-  释放内存等资源;
+  int ret = OB_SUCCESS;
+  destroy_partitions();
+  reuse_groups();
+  if (NULL != buckets_)
+  {
+    ob_free(buckets_, ObModIds::OB_SQL_HASH_GROUPBY);
+    buckets_ = NULL;
+    bucket_num_ = 0;
+  }
+  group_column_idxs_.clear();
+  group_store_.clear();
+  aggr_func_.destroy();
+  ret = ObGroupBy::close();
+  return ret;
+}
+
+int ObHashGroupBy::get_row_desc(const common::ObRowDesc *&row_desc) const
+{
+  const ObRowDesc &r = aggr_func_.get_row_desc();
+  int ret = OB_SUCCESS;
+  if (OB_UNLIKELY(0 >= r.get_column_num()))
+  {
+    TBSYS_LOG(ERROR, "not init");
+    ret = OB_NOT_INIT;
+  }
+  else
+  {
+    row_desc = &r;
+  }
+  return ret;
+}
+
+int ObHashGroupBy::init_group_columns(const ObRowDesc &row_desc)
+{
+  int ret = OB_SUCCESS;
+  int64_t idx = OB_INVALID_INDEX;
+  group_column_idxs_.clear();
+  group_store_.clear();
+  for (int64_t i = 0; OB_SUCCESS == ret && i < group_columns_.count(); ++i)
+  {
+    const ObGroupColumn &group_col = group_columns_.at(static_cast<int32_t>(i));
+    if (OB_INVALID_INDEX == (idx = row_desc.get_idx(group_col.table_id_, group_col.column_id_)))
+    {
+      TBSYS_LOG(WARN, "group column not in the input row, tid=%lu cid=%lu",
+                group_col.table_id_, group_col.column_id_);
+      ret = OB_ERR_UNEXPECTED;
+    }
+    else if (OB_SUCCESS != (ret = group_column_idxs_.push_back(idx)))
+    {
+      TBSYS_LOG(WARN, "failed to push back, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = group_store_.add_reserved_column(group_col.table_id_, group_col.column_id_)))
+    {
+      TBSYS_LOG(WARN, "failed to add reserved column, err=%d", ret);
+    }
+  } // end for
+  return ret;
+}
+
+int ObHashGroupBy::init_buckets()
+{
+  int ret = OB_SUCCESS;
+  if (NULL == buckets_)
+  {
+    if (NULL == (buckets_ = static_cast<Group**>(ob_malloc(INIT_BUCKET_NUM * sizeof(Group*),
+                                                            ObModIds::OB_SQL_HASH_GROUPBY))))
+    {
+      TBSYS_LOG(ERROR, "no memory");
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+    }
+    else
+    {
+      bucket_num_ = INIT_BUCKET_NUM;
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    memset(buckets_, 0, bucket_num_ * sizeof(Group*));
+  }
+  return ret;
+}
+
+int ObHashGroupBy::aggregate_child()
+{
+  int ret = OB_SUCCESS;
+  const ObRow *input_row = NULL;
+  while (OB_SUCCESS == (ret = child_op_->get_next_row(input_row)))
+  {
+    if (OB_SUCCESS != (ret = add_row(*input_row)))
+    {
+      TBSYS_LOG(WARN, "failed to add row, err=%d", ret);
+      break;
+    }
+  } // end while
+  if (OB_ITER_END == ret)
+  {
+    ret = finish_spill();
+  }
+  else
+  {
+    TBSYS_LOG(WARN, "failed to get next row, err=%d", ret);
+  }
+  return ret;
+}
+
+int ObHashGroupBy::aggregate_partition(SpillPartition &partition)
+{
+  int ret = OB_SUCCESS;
+  int64_t run_count = 0;
+  spill_level_ = partition.level_;
+  if (OB_SUCCESS != (ret = partition.run_file_->begin_read_bucket(SPILL_BUCKET_IDX, run_count)))
+  {
+    TBSYS_LOG(WARN, "failed to begin read spill file, err=%d file=%s", ret, partition.filename_);
+  }
+  else
+  {
+    while (OB_SUCCESS == (ret = partition.run_file_->get_next_row(0, input_row_)))
+    {
+      if (OB_SUCCESS != (ret = add_row(input_row_)))
+      {
+        TBSYS_LOG(WARN, "failed to add row, err=%d", ret);
+        break;
+      }
+    } // end while
+    if (OB_ITER_END == ret)
+    {
+      ret = OB_SUCCESS;
+    }
+    partition.run_file_->end_read_bucket();
+  }
+  TBSYS_LOG(INFO, "aggregate spill partition, level=%ld row_count=%ld group_count=%ld file=%s err=%d",
+            partition.level_, partition.row_count_, groups_.count(), partition.filename_, ret);
+  destroy_partition(partition);
+  if (OB_SUCCESS == ret)
+  {
+    ret = finish_spill();
+  }
+  return ret;
+}
+
+int ObHashGroupBy::add_row(const ObRow &row)
+{
+  int ret = OB_SUCCESS;
+  uint64_t hash = 0;
+  int64_t bucket_idx = 0;
+  if (OB_SUCCESS != (ret = calc_hash(row, 0, hash)))
+  {
+    TBSYS_LOG(WARN, "failed to calc hash, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = find_group(row, hash, bucket_idx)))
+  {
+    TBSYS_LOG(WARN, "failed to find group, err=%d", ret);
+  }
+  else if (NULL != buckets_[bucket_idx])
+  {
+    if (OB_SUCCESS != (ret = aggr_func_.calc_state(row, buckets_[bucket_idx]->state_, arena_)))
+    {
+      TBSYS_LOG(WARN, "failed to calc aggr state, err=%d", ret);
+    }
+  }
+  else if (need_spill())
+  {
+    if (OB_SUCCESS != (ret = spill_row(row)))
+    {
+      TBSYS_LOG(WARN, "failed to spill row, err=%d", ret);
+    }
+  }
+  else if (OB_SUCCESS != (ret = new_group(row, hash, bucket_idx)))
+  {
+    TBSYS_LOG(WARN, "failed to add new group, err=%d", ret);
+  }
+  return ret;
+}
+
+int ObHashGroupBy::calc_hash(const ObRow &row, const uint32_t seed, uint64_t &hash) const
+{
+  int ret = OB_SUCCESS;
+  const ObObj *cell = NULL;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  uint32_t hash_val = seed;
+  for (int64_t i = 0; OB_SUCCESS == ret && i < group_column_idxs_.count(); ++i)
+  {
+    if (OB_SUCCESS != (ret = row.raw_get_cell(group_column_idxs_.at(static_cast<int32_t>(i)), cell, tid, cid)))
+    {
+      TBSYS_LOG(WARN, "failed to get cell, err=%d", ret);
+    }
+    else
+    {
+      hash_val = cell->murmurhash2(hash_val);
+    }
+  } // end for
+  hash = hash_val;
+  return ret;
+}
+
+// linear probing, bucket_idx is the bucket of the group or the empty
+// bucket to insert the new group
+int ObHashGroupBy::find_group(const ObRow &row, const uint64_t hash, int64_t &bucket_idx) const
+{
+  int ret = OB_SUCCESS;
+  const ObObj *cell = NULL;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  const int64_t mask = bucket_num_ - 1;
+  bool found = false;
+  bucket_idx = static_cast<int64_t>(hash) & mask;
+  while (OB_SUCCESS == ret && !found && NULL != buckets_[bucket_idx])
+  {
+    const Group *group = buckets_[bucket_idx];
+    found = (hash == group->hash_);
+    for (int64_t i = 0; OB_SUCCESS == ret && found && i < group_column_idxs_.count(); ++i)
+    {
+      if (OB_SUCCESS != (ret = row.raw_get_cell(group_column_idxs_.at(static_cast<int32_t>(i)), cell, tid, cid)))
+      {
+        TBSYS_LOG(WARN, "failed to get cell, err=%d", ret);
+      }
+      else
+      {
+        found = (group->stored_row_->reserved_cells_[i] == *cell);
+      }
+    } // end for
+    if (!found)
+    {
+      bucket_idx = (bucket_idx + 1) & mask;
+    }
+  } // end while
+  return ret;
+}
+
+int ObHashGroupBy::new_group(const ObRow &row, const uint64_t hash, const int64_t bucket_idx)
+{
+  int ret = OB_SUCCESS;
+  Group *group = NULL;
+  const int64_t state_cells_count = aggr_func_.get_state_cells_count();
+  char *state_buf = NULL;
+  if (NULL == (group = reinterpret_cast<Group*>(arena_.alloc_aligned(sizeof(Group))))
+      || (0 < state_cells_count
+          && NULL == (state_buf = arena_.alloc_aligned(state_cells_count * sizeof(ObExprObj)))))
+  {
+    TBSYS_LOG(ERROR, "no memory");
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else if (OB_SUCCESS != (ret = group_store_.add_row(row, group->stored_row_)))
+  {
+    TBSYS_LOG(WARN, "failed to add row into store, err=%d", ret);
+  }
+  else
+  {
+    group->hash_ = hash;
+    group->state_ = reinterpret_cast<ObExprObj*>(state_buf);
+    for (int64_t i = 0; i < state_cells_count; ++i)
+    {
+      new(group->state_ + i) ObExprObj();
+    }
+    if (OB_SUCCESS != (ret = aggr_func_.init_state(row, group->state_, arena_)))
+    {
+      TBSYS_LOG(WARN, "failed to init aggr state, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = groups_.push_back(group)))
+    {
+      TBSYS_LOG(WARN, "failed to push back, err=%d", ret);
+    }
+    else
+    {
+      buckets_[bucket_idx] = group;
+      // keep the load factor under 0.5
+      if (groups_.count() * 2 > bucket_num_)
+      {
+        ret = expand_buckets();
+      }
+    }
+  }
+  return ret;
+}
+
+int ObHashGroupBy::expand_buckets()
+{
+  int ret = OB_SUCCESS;
+  const int64_t new_bucket_num = bucket_num_ * 2;
+  const int64_t mask = new_bucket_num - 1;
+  Group **new_buckets = NULL;
+  if (NULL == (new_buckets = static_cast<Group**>(ob_malloc(new_bucket_num * sizeof(Group*),
+                                                             ObModIds::OB_SQL_HASH_GROUPBY))))
+  {
+    TBSYS_LOG(ERROR, "no memory, bucket_num=%ld", new_bucket_num);
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else
+  {
+    memset(new_buckets, 0, new_bucket_num * sizeof(Group*));
+    for (int64_t i = 0; i < groups_.count(); ++i)
+    {
+      Group *group = groups_.at(static_cast<int32_t>(i));
+      int64_t bucket_idx = static_cast<int64_t>(group->hash_) & mask;
+      while (NULL != new_buckets[bucket_idx])
+      {
+        bucket_idx = (bucket_idx + 1) & mask;
+      }
+      new_buckets[bucket_idx] = group;
+    } // end for
+    ob_free(buckets_, ObModIds::OB_SQL_HASH_GROUPBY);
+    buckets_ = new_buckets;
+    bucket_num_ = new_bucket_num;
+  }
+  return ret;
+}
+
+// at least one group is kept in memory, so every pass makes progress
+bool ObHashGroupBy::need_spill() const
+{
+  const int64_t limit = 0 < mem_size_limit_ ? mem_size_limit_ : DEFAULT_MEM_SIZE_LIMIT;
+  return 0 < groups_.count() && get_used_mem_size() >= limit;
+}
+
+int64_t ObHashGroupBy::get_used_mem_size() const
+{
+  return group_store_.get_used_mem_size() + arena_.total()
+    + bucket_num_ * static_cast<int64_t>(sizeof(Group*))
+    + groups_.count() * static_cast<int64_t>(sizeof(Group*));
+}
+
+int ObHashGroupBy::spill_row(const ObRow &row)
+{
+  int ret = OB_SUCCESS;
+  uint64_t hash = 0;
+  if (MAX_SPILL_LEVEL <= spill_level_)
+  {
+    TBSYS_LOG(WARN, "hash group by has exceeded the mem limit, limit=%ld used=%ld level=%ld",
+              mem_size_limit_, get_used_mem_size(), spill_level_);
+    ret = OB_EXCEED_MEM_LIMIT;
+  }
+  // hash with another seed for every level, or all rows of this level
+  // would fall into the same partition again
+  else if (OB_SUCCESS != (ret = calc_hash(row, static_cast<uint32_t>(spill_level_ + 1), hash)))
+  {
+    TBSYS_LOG(WARN, "failed to calc hash, err=%d", ret);
+  }
+  else
+  {
+    SpillPartition &partition = spill_partitions_[hash % SPILL_PARTITION_NUM];
+    ObString compact_row;
+    if (NULL == partition.run_file_
+        && OB_SUCCESS != (ret = open_partition(partition)))
+    {
+      TBSYS_LOG(WARN, "failed to open spill partition, err=%d", ret);
+    }
+    else
+    {
+      compact_row.assign_buffer(spill_row_buf_.get_buffer(),
+                                static_cast<ObString::obstr_size_t>(spill_row_buf_.get_buffer_size()));
+      if (OB_SUCCESS != (ret = ObRowUtil::convert(row, compact_row)))
+      {
+        TBSYS_LOG(WARN, "failed to convert row, err=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = partition.run_file_->append_row(compact_row)))
+      {
+        TBSYS_LOG(WARN, "failed to append row, err=%d file=%s", ret, partition.filename_);
+      }
+      else
+      {
+        ++partition.row_count_;
+      }
+    }
+  }
+  return ret;
+}
+
+int ObHashGroupBy::open_partition(SpillPartition &partition)
+{
+  int ret = OB_SUCCESS;
+  ObString filename;
+  int len = snprintf(partition.filename_, OB_MAX_FILE_NAME_LENGTH, "%.*s.%ld",
+                     run_filename_.length(), run_filename_.ptr(), spill_file_count_++);
+  filename.assign_ptr(partition.filename_, len);
+  partition.level_ = spill_level_ + 1;
+  partition.row_count_ = 0;
+  if (OB_SUCCESS != (ret = spill_row_buf_.ensure_space(OB_MAX_ROW_LENGTH, ObModIds::OB_SQL_HASH_GROUPBY)))
+  {
+    TBSYS_LOG(WARN, "failed to alloc spill row buffer, err=%d", ret);
+  }
+  else if (NULL == (partition.run_file_ = OB_NEW(ObRunFile, ObModIds::OB_SQL_HASH_GROUPBY)))
+  {
+    TBSYS_LOG(ERROR, "no memory");
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else if (OB_SUCCESS != (ret = partition.run_file_->open(filename)))
+  {
+    TBSYS_LOG(WARN, "failed to open run file, err=%d file=%s", ret, partition.filename_);
+  }
+  else if (OB_SUCCESS != (ret = partition.run_file_->begin_append_run(SPILL_BUCKET_IDX)))
+  {
+    TBSYS_LOG(WARN, "failed to begin append run, err=%d file=%s", ret, partition.filename_);
+  }
+  else
+  {
+    TBSYS_LOG(INFO, "hash group by spill, level=%ld file=%s group_count=%ld used=%ld",
+              partition.level_, partition.filename_, groups_.count(), get_used_mem_size());
+  }
+  if (OB_SUCCESS != ret)
+  {
+    destroy_partition(partition);
+  }
+  return ret;
+}
+
+// all rows of the current input are aggregated or spilled,
+// seal the spill files and queue them
+int ObHashGroupBy::finish_spill()
+{
+  int ret = OB_SUCCESS;
+  for (int64_t i = 0; i < SPILL_PARTITION_NUM; ++i)
+  {
+    SpillPartition &partition = spill_partitions_[i];
+    if (NULL == partition.run_file_)
+    {
+      // nothing spilled
+    }
+    else if (OB_SUCCESS != ret)
+    {
+      destroy_partition(partition);
+    }
+    else if (OB_SUCCESS != (ret = partition.run_file_->end_append_run()))
+    {
+      TBSYS_LOG(WARN, "failed to end append run, err=%d file=%s", ret, partition.filename_);
+      destroy_partition(partition);
+    }
+    else if (OB_SUCCESS != (ret = pending_partitions_.push_back(partition)))
+    {
+      TBSYS_LOG(WARN, "failed to push back, err=%d", ret);
+      destroy_partition(partition);
+    }
+    else
+    {
+      // owned by pending_partitions_ now
+      partition.run_file_ = NULL;
+    }
+  } // end for
+  group_idx_ = 0;
+  return ret;
+}
+
+void ObHashGroupBy::destroy_partition(SpillPartition &partition)
+{
+  if (NULL != partition.run_file_)
+  {
+    partition.run_file_->close();
+    OB_DELETE(ObRunFile, ObModIds::OB_SQL_HASH_GROUPBY, partition.run_file_);
+    if (0 != unlink(partition.filename_))
+    {
+      TBSYS_LOG(WARN, "failed to remove spill file, file=%s err=%s", partition.filename_, strerror(errno));
+    }
+  }
+  partition.row_count_ = 0;
 }
 
-int ObHashGroupBy::get_next_row(const common::ObRow *&row)
+void ObHashGroupBy::destroy_partitions()
 {
-  for(当前桶curr_backet_idx_的具有相同groupby列的下k个行)
+  for (int64_t i = 0; i < SPILL_PARTITION_NUM; ++i)
+  {
+    destroy_partition(spill_partitions_[i]);
+  }
+  for (int64_t i = 0; i < pending_partitions_.count(); ++i)
   {
-    计算聚集列，修改curr_row_;
+    destroy_partition(pending_partitions_.at(static_cast<int32_t>(i)));
   }
-  if (当前桶处理完)
+  pending_partitions_.clear();
+}
+
+void ObHashGroupBy::reuse_groups()
+{
+  groups_.clear();
+  group_idx_ = 0;
+  if (NULL != buckets_)
   {
-    ++curr_backet_idx_;
+    memset(buckets_, 0, bucket_num_ * sizeof(Group*));
   }
-  row = &curr_row_;
+  group_store_.clear_rows();
+  arena_.free();
 }
 
-*/
+int ObHashGroupBy::get_next_row(const ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  if (OB_UNLIKELY(NULL != my_phy_plan_ && my_phy_plan_->is_timeout()))
+  {
+    TBSYS_LOG(WARN, "execution timeout, ts=%ld", my_phy_plan_->get_timeout_timestamp());
+    ret = OB_PROCESS_TIMEOUT;
+  }
+  while (OB_SUCCESS == ret && group_idx_ >= groups_.count())
+  {
+    SpillPartition partition;
+    if (0 >= pending_partitions_.count())
+    {
+      ret = OB_ITER_END;
+    }
+    else if (OB_SUCCESS != (ret = pending_partitions_.pop_back(partition)))
+    {
+      TBSYS_LOG(WARN, "failed to pop back, err=%d", ret);
+    }
+    else
+    {
+      reuse_groups();
+      if (OB_SUCCESS != (ret = aggregate_partition(partition)))
+      {
+        TBSYS_LOG(WARN, "failed to aggregate spill partition, err=%d", ret);
+      }
+    }
+  } // end while
+  if (OB_SUCCESS == ret)
+  {
+    Group *group = groups_.at(static_cast<int32_t>(group_idx_++));
+    if (OB_SUCCESS != (ret = ObRowUtil::convert(group->stored_row_->get_compact_row(), group_row_)))
+    {
+      TBSYS_LOG(WARN, "failed to convert compact row, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = aggr_func_.get_state_result(group_row_, group->state_, row)))
+    {
+      TBSYS_LOG(WARN, "failed to get aggr result, err=%d", ret);
+    }
+  }
+  return ret;
+}
+
+int64_t ObHashGroupBy::to_string(char* buf, const int64_t buf_len) const
+{
+  int64_t pos = 0;
+  databuff_printf(buf, buf_len, pos, "HashGroupBy(mem_size_limit=%ld)\n", mem_size_limit_);
+  pos += ObGroupBy::to_string(buf+pos, buf_len-pos);
+  return pos;
+}
+
+ObPhyOperatorType ObHashGroupBy::get_type() const
+{
+  return PHY_HASH_GROUP_BY;
+}
+
+void ObHashGroupBy::assign(const ObHashGroupBy& other)
+{
+  group_columns_ = other.group_columns_;
+  aggr_columns_ = other.aggr_columns_;
+  mem_size_limit_ = other.mem_size_limit_;
+  set_int_div_as_double(other.get_int_div_as_double());
+}
+
+DEFINE_SERIALIZE(ObHashGroupBy)
+{
+  int ret = OB_SUCCESS;
+  if ((ret = ObGroupBy::serialize(buf, buf_len, pos)) != OB_SUCCESS)
+  {
+    TBSYS_LOG(WARN, "fail to serialize ObGroupBy, ret= %d", ret);
+  }
+  else if ((ret = encode_bool(buf, buf_len, pos, get_int_div_as_double())))
+  {
+    TBSYS_LOG(WARN, "serialize get_int_div_as_double fail. ret=%d", ret);
+  }
+  return ret;
+}
+
+DEFINE_DESERIALIZE(ObHashGroupBy)
+{
+  int ret = OB_SUCCESS;
+  bool did_int_div_as_double = false;
+  if ((ret = ObGroupBy::deserialize(buf, data_len, pos)) != OB_SUCCESS)
+  {
+    TBSYS_LOG(WARN, "fail to deserialize ObGroupBy. ret=%d", ret);
+  }
+  else if ((ret = decode_bool(buf, data_len, pos, &did_int_div_as_double)) != OB_SUCCESS)
+  {
+    TBSYS_LOG(WARN, "fail to deserialize get_int_div_as_double. ret=%d", ret);
+  }
+  else
+  {
+    set_int_div_as_double(did_int_div_as_double);
+  }
+  return ret;
+}
+
+DEFINE_GET_SERIALIZE_SIZE(ObHashGroupBy)
+{
+  int64_t size = 0;
+  size += ObGroupBy::get_serialize_size();
+  size += encoded_length_bool(get_int_div_as_double());
+  return size;
+}
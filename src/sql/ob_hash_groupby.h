@@ -15,44 +15,125 @@
  */
 #ifndef _OB_HASH_GROUPBY_H
 #define _OB_HASH_GROUPBY_H 1
-
-#include "sql/ob_groupby.h"
-#include "ob_sql_expression.h"
-
+#include "ob_groupby.h"
+#include "ob_aggregate_function.h"
+#include "ob_run_file.h"
+#include "common/ob_row_store.h"
+#include "common/page_arena.h"
 namespace oceanbase
 {
   namespace sql
   {
+    // 输入数据不需要按照groupby列排序
+    //
+    // groups are kept in an open addressing hash table, the first input row
+    // of every group is stored in compact format and the aggregate state of
+    // the group lives in an arena. when the memory exceeds the limit, rows of
+    // new groups are spilled to SPILL_PARTITION_NUM run files by another hash
+    // of the group columns, and every partition is aggregated the same way
+    // after the groups in memory are output.
+    // the output is not ordered by the group columns.
     class ObHashGroupBy: public ObGroupBy
     {
       public:
         ObHashGroupBy();
         virtual ~ObHashGroupBy();
+        void reset();
+
+        virtual void set_int_div_as_double(bool did);
+        virtual bool get_int_div_as_double() const;
+        /// prefix of the spill files, DEFAULT_RUN_FILE_PREFIX if not set
+        int set_run_filename(const common::ObString &filename);
 
-        virtual int set_child(int32_t child_idx, ObPhyOperator &child_operator);
         virtual int open();
         virtual int close();
         virtual int get_next_row(const common::ObRow *&row);
+        virtual int get_row_desc(const common::ObRowDesc *&row_desc) const;
+        virtual int64_t to_string(char* buf, const int64_t buf_len) const;
+        virtual ObPhyOperatorType get_type() const;
+        void assign(const ObHashGroupBy &other);
 
-        virtual int add_group_column(const ObSqlExpression &expr);
-        virtual int add_agg_column(const ObSqlExpression &expr);
-
-        void set_backets_param(const int64_t backets_num, const int64_t backet_mem_size);
+        NEED_SERIALIZE_AND_DESERIALIZE;
+      private:
+        // types and constants
+        static const int64_t DEFAULT_MEM_SIZE_LIMIT = 256*1024*1024LL; // used if mem_size_limit_ is not set
+        static const int64_t INIT_BUCKET_NUM = 1024;
+        static const int64_t SPILL_PARTITION_NUM = 8;
+        static const int64_t MAX_SPILL_LEVEL = 8;
+        static const int64_t SPILL_BUCKET_IDX = 0;
+        static const char* const DEFAULT_RUN_FILE_PREFIX;
+        struct Group
+        {
+          uint64_t hash_;
+          const common::ObRowStore::StoredRow *stored_row_; // reserved cells are the group columns
+          common::ObExprObj *state_;
+        };
+        struct SpillPartition
+        {
+          ObRunFile *run_file_;
+          int64_t level_;
+          int64_t row_count_;
+          char filename_[common::OB_MAX_FILE_NAME_LENGTH];
+          SpillPartition()
+            :run_file_(NULL), level_(0), row_count_(0)
+          {
+            filename_[0] = '\0';
+          }
+        };
       private:
         // disallow copy
         ObHashGroupBy(const ObHashGroupBy &other);
         ObHashGroupBy& operator=(const ObHashGroupBy &other);
+        // function members
+        int init_group_columns(const common::ObRowDesc &row_desc);
+        int init_buckets();
+        int aggregate_child();
+        int aggregate_partition(SpillPartition &partition);
+        int add_row(const common::ObRow &row);
+        int calc_hash(const common::ObRow &row, const uint32_t seed, uint64_t &hash) const;
+        int find_group(const common::ObRow &row, const uint64_t hash, int64_t &bucket_idx) const;
+        int new_group(const common::ObRow &row, const uint64_t hash, const int64_t bucket_idx);
+        int expand_buckets();
+        bool need_spill() const;
+        int spill_row(const common::ObRow &row);
+        int open_partition(SpillPartition &partition);
+        int finish_spill();
+        void destroy_partition(SpillPartition &partition);
+        void destroy_partitions();
+        void reuse_groups();
+        int64_t get_used_mem_size() const;
       private:
         // data members
-        ObPhyOpearator *child_op_;
-        ObArray<columnExpr> group_columns_;
-        ObArray<columnExpr> other_columns_;
-        ObArray<columnExpr> agg_columns_;
-        common::ObRow curr_row_;
-        common::ObRowDesc row_desc_;
+        ObAggregateFunction aggr_func_;
+        common::ObArray<int64_t> group_column_idxs_;
+        common::ObRowStore group_store_;
+        common::ModuleArena arena_;
+        Group **buckets_;
+        int64_t bucket_num_;
+        common::ObArray<Group*> groups_;
+        int64_t group_idx_;
+        common::ObRow input_row_; // row read from the spill file
+        common::ObRow group_row_; // the first input row of the output group
+        // spill
+        char run_filename_buf_[common::OB_MAX_FILE_NAME_LENGTH];
+        common::ObString run_filename_;
+        int64_t spill_level_;     // level of the rows being aggregated, 0 for the child
+        int64_t spill_file_count_;
+        SpillPartition spill_partitions_[SPILL_PARTITION_NUM]; // partitions of the rows being aggregated
+        common::ObArray<SpillPartition> pending_partitions_;
+        common::ObMemBuf spill_row_buf_;
     };
+
+    inline void ObHashGroupBy::set_int_div_as_double(bool did)
+    {
+      aggr_func_.set_int_div_as_double(did);
+    }
+
+    inline bool ObHashGroupBy::get_int_div_as_double() const
+    {
+      return aggr_func_.get_int_div_as_double();
+    }
   } // end namespace sql
 } // end namespace oceanbase
 
 #endif /* _OB_HASH_GROUPBY_H */
-
@@ -0,0 +1,1304 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_hash_join.cpp
+ *
+ * Authors:
+ *   Zhifeng YANG <zhuweng.yzf@taobao.com>
+ *
+ */
+#include "ob_hash_join.h"
+#include "common/utility.h"
+#include "common/ob_row_util.h"
+#include "ob_physical_plan.h"
+#include <unistd.h>
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+const char* const ObHashJoin::DEFAULT_RUN_FILE_PREFIX = "/tmp/ob_hash_join";
+
+ObHashJoin::ObHashJoin()
+  :out_row_desc_(NULL),
+   bloom_filter_inited_(false),
+   level_(0),
+   state_(PROBE),
+   is_chunked_(false),
+   build_chunk_full_(false),
+   probe_row_idx_(-1),
+   probe_row_(NULL),
+   probe_hash_(0),
+   probe_part_idx_(0),
+   curr_entry_(-1),
+   probe_matched_(false),
+   output_part_idx_(0),
+   output_entry_idx_(0),
+   mem_size_limit_(0),
+   spill_file_count_(0)
+{
+  run_filename_buf_[0] = '\0';
+}
+
+ObHashJoin::~ObHashJoin()
+{
+  destroy_all_spill_files();
+  for (int64_t i = 0; i < PARTITION_NUM; ++i)
+  {
+    if (NULL != partitions_[i].buckets_)
+    {
+      ob_free(partitions_[i].buckets_, ObModIds::OB_SQL_HASH_JOIN);
+      partitions_[i].buckets_ = NULL;
+    }
+  }
+}
+
+int ObHashJoin::set_join_type(const ObJoin::JoinType join_type)
+{
+  int ret = OB_SUCCESS;
+  switch(join_type)
+  {
+    case INNER_JOIN:
+    case LEFT_OUTER_JOIN:
+    case RIGHT_OUTER_JOIN:
+    case FULL_OUTER_JOIN:
+    case LEFT_SEMI_JOIN:
+    case RIGHT_SEMI_JOIN:
+    case LEFT_ANTI_SEMI_JOIN:
+    case RIGHT_ANTI_SEMI_JOIN:
+      ObJoin::set_join_type(join_type);
+      break;
+    default:
+      ret = OB_ERR_UNEXPECTED;
+      break;
+  }
+  return ret;
+}
+
+void ObHashJoin::set_mem_size_limit(const int64_t limit)
+{
+  mem_size_limit_ = limit;
+}
+
+int ObHashJoin::set_run_filename(const common::ObString &filename)
+{
+  int ret = OB_SUCCESS;
+  // leave room for the ".<seq>" suffix of every spill file
+  if (filename.length() >= OB_MAX_FILE_NAME_LENGTH - 32)
+  {
+    TBSYS_LOG(ERROR, "filename is too long, filename=%.*s", filename.length(), filename.ptr());
+    ret = OB_BUF_NOT_ENOUGH;
+  }
+  else
+  {
+    snprintf(run_filename_buf_, OB_MAX_FILE_NAME_LENGTH, "%.*s", filename.length(), filename.ptr());
+    run_filename_.assign_ptr(run_filename_buf_, filename.length());
+  }
+  return ret;
+}
+
+int ObHashJoin::open()
+{
+  int ret = OB_SUCCESS;
+  const ObRowDesc *left_row_desc = NULL;
+  const ObRowDesc *right_row_desc = NULL;
+  if (equal_join_conds_.count() <= 0)
+  {
+    TBSYS_LOG(WARN, "hash join can not work without equijoin conditions");
+    ret = OB_NOT_SUPPORTED;
+  }
+  else if (OB_SUCCESS != (ret = ObJoin::open()))
+  {
+    TBSYS_LOG(WARN, "failed to open child ops, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = left_op_->get_row_desc(left_row_desc)))
+  {
+    TBSYS_LOG(WARN, "failed to get child row desc, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = right_op_->get_row_desc(right_row_desc)))
+  {
+    TBSYS_LOG(WARN, "failed to get child row desc, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = init_join_keys(*left_row_desc, *right_row_desc)))
+  {
+    TBSYS_LOG(WARN, "failed to init join keys, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = cons_row_desc(*left_row_desc, *right_row_desc)))
+  {
+    TBSYS_LOG(WARN, "failed to cons row desc, err=%d", ret);
+  }
+  else
+  {
+    switch(join_type_)
+    {
+      case LEFT_SEMI_JOIN:
+      case LEFT_ANTI_SEMI_JOIN:
+        out_row_desc_ = left_row_desc;
+        break;
+      case RIGHT_SEMI_JOIN:
+      case RIGHT_ANTI_SEMI_JOIN:
+        out_row_desc_ = right_row_desc;
+        break;
+      default:
+        out_row_desc_ = &row_desc_;
+        break;
+    }
+    curr_row_.set_row_desc(row_desc_);
+    build_row_.set_row_desc(*right_row_desc);
+    build_file_row_.set_row_desc(*right_row_desc);
+    probe_file_row_.set_row_desc(*left_row_desc);
+    if (0 >= run_filename_.length())
+    {
+      int len = snprintf(run_filename_buf_, OB_MAX_FILE_NAME_LENGTH, "%s.%d.%p",
+                         DEFAULT_RUN_FILE_PREFIX, getpid(), this);
+      run_filename_.assign_ptr(run_filename_buf_, len);
+    }
+    level_ = 0;
+    state_ = PROBE;
+    is_chunked_ = false;
+    build_chunk_full_ = false;
+    probe_row_idx_ = -1;
+    probe_matched_bits_.clear();
+    probe_row_ = NULL;
+    curr_entry_ = -1;
+    if (OB_SUCCESS != (ret = build()))
+    {
+      TBSYS_LOG(WARN, "failed to build hash table, err=%d", ret);
+    }
+  }
+  return ret;
+}
+
+int ObHashJoin::close()
+{
+  int ret = OB_SUCCESS;
+  destroy_all_spill_files();
+  for (int64_t i = 0; i < PARTITION_NUM; ++i)
+  {
+    Partition &part = partitions_[i];
+    part.entries_.clear();
+    part.store_.clear();
+    if (NULL != part.buckets_)
+    {
+      ob_free(part.buckets_, ObModIds::OB_SQL_HASH_JOIN);
+      part.buckets_ = NULL;
+      part.bucket_num_ = 0;
+    }
+  }
+  bloom_filter_.destroy();
+  bloom_filter_inited_ = false;
+  probe_matched_bits_.clear();
+  left_key_idxs_.clear();
+  right_key_idxs_.clear();
+  row_desc_.reset();
+  out_row_desc_ = NULL;
+  probe_row_ = NULL;
+  ret = ObJoin::close();
+  return ret;
+}
+
+int ObHashJoin::get_row_desc(const common::ObRowDesc *&row_desc) const
+{
+  int ret = OB_SUCCESS;
+  if (OB_UNLIKELY(NULL == out_row_desc_ || 0 >= out_row_desc_->get_column_num()))
+  {
+    TBSYS_LOG(ERROR, "not init");
+    ret = OB_NOT_INIT;
+  }
+  else
+  {
+    row_desc = out_row_desc_;
+  }
+  return ret;
+}
+
+int ObHashJoin::init_join_keys(const ObRowDesc &left_row_desc, const ObRowDesc &right_row_desc)
+{
+  int ret = OB_SUCCESS;
+  left_key_idxs_.clear();
+  right_key_idxs_.clear();
+  for (int64_t i = 0; i < PARTITION_NUM; ++i)
+  {
+    partitions_[i].store_.clear();
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < equal_join_conds_.count(); ++i)
+  {
+    const ObSqlExpression &expr = equal_join_conds_.at(i);
+    ExprItem::SqlCellInfo c1;
+    ExprItem::SqlCellInfo c2;
+    int64_t left_idx = OB_INVALID_INDEX;
+    int64_t right_idx = OB_INVALID_INDEX;
+    if (!expr.is_equijoin_cond(c1, c2))
+    {
+      TBSYS_LOG(ERROR, "invalid equijoin condition");
+      ret = OB_ERR_UNEXPECTED;
+      break;
+    }
+    // the columns of the condition may be in any order
+    if (OB_INVALID_INDEX == (left_idx = left_row_desc.get_idx(c1.tid, c1.cid)))
+    {
+      ExprItem::SqlCellInfo tmp = c1;
+      c1 = c2;
+      c2 = tmp;
+      left_idx = left_row_desc.get_idx(c1.tid, c1.cid);
+    }
+    right_idx = right_row_desc.get_idx(c2.tid, c2.cid);
+    if (OB_INVALID_INDEX == left_idx || OB_INVALID_INDEX == right_idx)
+    {
+      TBSYS_LOG(WARN, "equijoin columns not in the children, tid1=%lu cid1=%lu tid2=%lu cid2=%lu",
+                c1.tid, c1.cid, c2.tid, c2.cid);
+      ret = OB_ERR_UNEXPECTED;
+    }
+    else if (OB_SUCCESS != (ret = left_key_idxs_.push_back(left_idx))
+             || OB_SUCCESS != (ret = right_key_idxs_.push_back(right_idx)))
+    {
+      TBSYS_LOG(WARN, "failed to push back, err=%d", ret);
+    }
+    for (int64_t j = 0; OB_SUCCESS == ret && j < PARTITION_NUM; ++j)
+    {
+      if (OB_SUCCESS != (ret = partitions_[j].store_.add_reserved_column(c2.tid, c2.cid)))
+      {
+        TBSYS_LOG(WARN, "failed to add reserved column, err=%d", ret);
+      }
+    }
+  } // end for
+  return ret;
+}
+
+int ObHashJoin::cons_row_desc(const ObRowDesc &rd1, const ObRowDesc &rd2)
+{
+  int ret = OB_SUCCESS;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  row_desc_.reset();
+  for (int64_t i = 0; OB_SUCCESS == ret && i < rd1.get_column_num(); ++i)
+  {
+    if (OB_SUCCESS != (ret = rd1.get_tid_cid(i, tid, cid)))
+    {
+      TBSYS_LOG(ERROR, "unexpected branch");
+      ret = OB_ERR_UNEXPECTED;
+    }
+    else if (OB_SUCCESS != (ret = row_desc_.add_column_desc(tid, cid)))
+    {
+      TBSYS_LOG(WARN, "failed to add column desc, err=%d", ret);
+    }
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < rd2.get_column_num(); ++i)
+  {
+    if (OB_SUCCESS != (ret = rd2.get_tid_cid(i, tid, cid)))
+    {
+      TBSYS_LOG(ERROR, "unexpected branch");
+      ret = OB_ERR_UNEXPECTED;
+    }
+    else if (OB_SUCCESS != (ret = row_desc_.add_column_desc(tid, cid)))
+    {
+      TBSYS_LOG(WARN, "failed to add column desc, err=%d", ret);
+    }
+  }
+  return ret;
+}
+
+bool ObHashJoin::need_output_build_rows() const
+{
+  return RIGHT_OUTER_JOIN == join_type_ || FULL_OUTER_JOIN == join_type_
+    || RIGHT_SEMI_JOIN == join_type_ || RIGHT_ANTI_SEMI_JOIN == join_type_;
+}
+
+bool ObHashJoin::need_unmatched_probe_rows() const
+{
+  return LEFT_OUTER_JOIN == join_type_ || FULL_OUTER_JOIN == join_type_
+    || LEFT_ANTI_SEMI_JOIN == join_type_;
+}
+
+int ObHashJoin::get_next_build_row(const ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  if (0 == level_)
+  {
+    ret = right_op_->get_next_row(row);
+  }
+  else if (0 >= curr_spill_.build_row_count_)
+  {
+    // no run is written into an empty file
+    ret = OB_ITER_END;
+  }
+  else if (OB_SUCCESS == (ret = curr_spill_.build_file_->get_next_row(SPILL_BUCKET_IDX, build_file_row_)))
+  {
+    row = &build_file_row_;
+  }
+  return ret;
+}
+
+int ObHashJoin::get_next_probe_row(const ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  if (0 == level_)
+  {
+    ret = left_op_->get_next_row(row);
+  }
+  else if (0 >= curr_spill_.probe_row_count_)
+  {
+    ret = OB_ITER_END;
+  }
+  else if (OB_SUCCESS == (ret = curr_spill_.probe_file_->get_next_row(SPILL_BUCKET_IDX, probe_file_row_)))
+  {
+    row = &probe_file_row_;
+  }
+  return ret;
+}
+
+int ObHashJoin::build()
+{
+  int ret = OB_SUCCESS;
+  const ObRow *row = NULL;
+  build_chunk_full_ = false;
+  while (!build_chunk_full_ && OB_SUCCESS == (ret = get_next_build_row(row)))
+  {
+    if (OB_SUCCESS != (ret = add_build_row(*row)))
+    {
+      TBSYS_LOG(WARN, "failed to add build row, err=%d", ret);
+      break;
+    }
+  } // end while
+  if (OB_ITER_END == ret || (OB_SUCCESS == ret && build_chunk_full_))
+  {
+    ret = finish_build();
+  }
+  else
+  {
+    TBSYS_LOG(WARN, "failed to get next build row, err=%d", ret);
+  }
+  return ret;
+}
+
+int ObHashJoin::add_build_row(const ObRow &row)
+{
+  int ret = OB_SUCCESS;
+  uint64_t hash = 0;
+  bool has_null = false;
+  if (OB_SUCCESS != (ret = calc_hash(row, right_key_idxs_, hash, has_null)))
+  {
+    TBSYS_LOG(WARN, "failed to calc hash, err=%d", ret);
+  }
+  else
+  {
+    Partition &part = partitions_[get_partition_idx(hash)];
+    if (part.is_spilled() || !need_spill())
+    {
+    }
+    else if (MAX_SPILL_LEVEL <= level_)
+    {
+      // rows of the same join key can not be split by spilling anymore,
+      // this row closes the chunk and the rest are loaded by next_build_chunk()
+      if (!is_chunked_)
+      {
+        TBSYS_LOG(INFO, "join spilled partition chunk by chunk, limit=%ld used=%ld level=%ld",
+                  mem_size_limit_, get_used_mem_size(), level_);
+      }
+      is_chunked_ = true;
+      build_chunk_full_ = true;
+    }
+    else
+    {
+      // evict the biggest partition in memory
+      Partition *victim = &part;
+      for (int64_t i = 0; i < PARTITION_NUM; ++i)
+      {
+        if (!partitions_[i].is_spilled()
+            && partitions_[i].entries_.count() > victim->entries_.count())
+        {
+          victim = &partitions_[i];
+        }
+      }
+      if (OB_SUCCESS != (ret = spill_partition(*victim)))
+      {
+        TBSYS_LOG(WARN, "failed to spill partition, err=%d", ret);
+      }
+    }
+    if (OB_SUCCESS != ret)
+    {
+    }
+    else if (bloom_filter_inited_ && !has_null
+             && OB_SUCCESS != (ret = bloom_filter_.insert(hash)))
+    {
+      TBSYS_LOG(WARN, "failed to insert into bloom filter, err=%d", ret);
+    }
+    else if (part.is_spilled())
+    {
+      if (OB_SUCCESS != (ret = append_row(*part.spill_.build_file_, row)))
+      {
+        TBSYS_LOG(WARN, "failed to spill build row, err=%d", ret);
+      }
+      else
+      {
+        ++part.spill_.build_row_count_;
+      }
+    }
+    else
+    {
+      Entry entry;
+      entry.hash_ = hash;
+      entry.next_ = -1;
+      entry.null_key_ = has_null;
+      entry.matched_ = false;
+      if (OB_SUCCESS != (ret = part.store_.add_row(row, entry.stored_row_)))
+      {
+        TBSYS_LOG(WARN, "failed to add row into store, err=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = part.entries_.push_back(entry)))
+      {
+        TBSYS_LOG(WARN, "failed to push back, err=%d", ret);
+      }
+    }
+  }
+  return ret;
+}
+
+int ObHashJoin::finish_build()
+{
+  int ret = OB_SUCCESS;
+  for (int64_t i = 0; OB_SUCCESS == ret && i < PARTITION_NUM; ++i)
+  {
+    Partition &part = partitions_[i];
+    if (part.is_spilled())
+    {
+      if (OB_SUCCESS != (ret = part.spill_.build_file_->end_append_run()))
+      {
+        TBSYS_LOG(WARN, "failed to end append run, err=%d file=%s", ret, part.spill_.build_filename_);
+      }
+      else
+      {
+        TBSYS_LOG(INFO, "hash join partition spilled, level=%ld build_row_count=%ld file=%s",
+                  part.spill_.level_, part.spill_.build_row_count_, part.spill_.build_filename_);
+      }
+    }
+    else if (OB_SUCCESS != (ret = build_buckets(part)))
+    {
+      TBSYS_LOG(WARN, "failed to build hash buckets, err=%d", ret);
+    }
+  } // end for
+  return ret;
+}
+
+int ObHashJoin::build_buckets(Partition &part)
+{
+  int ret = OB_SUCCESS;
+  int64_t bucket_num = 16;
+  // keep the load factor under 0.5
+  while (bucket_num < part.entries_.count() * 2)
+  {
+    bucket_num *= 2;
+  }
+  if (bucket_num > part.bucket_num_)
+  {
+    if (NULL != part.buckets_)
+    {
+      ob_free(part.buckets_, ObModIds::OB_SQL_HASH_JOIN);
+      part.buckets_ = NULL;
+      part.bucket_num_ = 0;
+    }
+    if (NULL == (part.buckets_ = static_cast<int64_t*>(ob_malloc(bucket_num * sizeof(int64_t),
+                                                                  ObModIds::OB_SQL_HASH_JOIN))))
+    {
+      TBSYS_LOG(ERROR, "no memory, bucket_num=%ld", bucket_num);
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+    }
+    else
+    {
+      part.bucket_num_ = bucket_num;
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    const int64_t mask = part.bucket_num_ - 1;
+    for (int64_t i = 0; i < part.bucket_num_; ++i)
+    {
+      part.buckets_[i] = -1;
+    }
+    for (int64_t i = 0; i < part.entries_.count(); ++i)
+    {
+      Entry &entry = part.entries_.at(i);
+      // rows with null join keys match nothing
+      if (!entry.null_key_)
+      {
+        const int64_t bucket_idx = static_cast<int64_t>(entry.hash_) & mask;
+        entry.next_ = part.buckets_[bucket_idx];
+        part.buckets_[bucket_idx] = i;
+      }
+    }
+  }
+  return ret;
+}
+
+// the bloom filter is created when the first partition is spilled, assume
+// that the build rows are at most PARTITION_NUM times of the rows in memory
+int ObHashJoin::create_bloom_filter()
+{
+  int ret = OB_SUCCESS;
+  int64_t row_count = 0;
+  for (int64_t i = 0; i < PARTITION_NUM; ++i)
+  {
+    row_count += partitions_[i].entries_.count();
+  }
+  int64_t nbit = row_count * PARTITION_NUM * BLOOM_FILTER_BITS_PER_ROW;
+  if (nbit < MIN_BLOOM_FILTER_BITS)
+  {
+    nbit = MIN_BLOOM_FILTER_BITS;
+  }
+  else if (nbit > MAX_BLOOM_FILTER_BITS)
+  {
+    nbit = MAX_BLOOM_FILTER_BITS;
+  }
+  if (OB_SUCCESS != (ret = bloom_filter_.init(BLOOM_FILTER_HASH_NUM, nbit)))
+  {
+    TBSYS_LOG(WARN, "failed to init bloom filter, err=%d nbit=%ld", ret, nbit);
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < PARTITION_NUM; ++i)
+  {
+    const ObArray<Entry> &entries = partitions_[i].entries_;
+    for (int64_t j = 0; OB_SUCCESS == ret && j < entries.count(); ++j)
+    {
+      if (!entries.at(j).null_key_)
+      {
+        ret = bloom_filter_.insert(entries.at(j).hash_);
+      }
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    bloom_filter_inited_ = true;
+  }
+  return ret;
+}
+
+int ObHashJoin::calc_hash(const ObRow &row, const ObArray<int64_t> &key_idxs,
+                          uint64_t &hash, bool &has_null) const
+{
+  int ret = OB_SUCCESS;
+  const ObObj *cell = NULL;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  // use another seed for every level, or all rows of a spilled partition
+  // would fall into the same partition again
+  uint32_t hash_val = static_cast<uint32_t>(level_);
+  has_null = false;
+  for (int64_t i = 0; OB_SUCCESS == ret && i < key_idxs.count(); ++i)
+  {
+    if (OB_SUCCESS != (ret = row.raw_get_cell(key_idxs.at(i), cell, tid, cid)))
+    {
+      TBSYS_LOG(WARN, "failed to get cell, err=%d", ret);
+    }
+    else
+    {
+      has_null = has_null || cell->is_null();
+      hash_val = cell->murmurhash2(hash_val);
+    }
+  } // end for
+  hash = hash_val;
+  return ret;
+}
+
+int ObHashJoin::is_key_equal(const ObRow &probe_row, const Entry &entry, bool &equal) const
+{
+  int ret = OB_SUCCESS;
+  const ObObj *cell = NULL;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  equal = true;
+  for (int64_t i = 0; OB_SUCCESS == ret && equal && i < left_key_idxs_.count(); ++i)
+  {
+    if (OB_SUCCESS != (ret = probe_row.raw_get_cell(left_key_idxs_.at(i), cell, tid, cid)))
+    {
+      TBSYS_LOG(WARN, "failed to get cell, err=%d", ret);
+    }
+    else
+    {
+      equal = (entry.stored_row_->reserved_cells_[i] == *cell);
+    }
+  } // end for
+  return ret;
+}
+
+int64_t ObHashJoin::get_partition_idx(const uint64_t hash) const
+{
+  return static_cast<int64_t>(hash >> PARTITION_SHIFT) & (PARTITION_NUM - 1);
+}
+
+bool ObHashJoin::need_spill() const
+{
+  const int64_t limit = 0 < mem_size_limit_ ? mem_size_limit_ : DEFAULT_MEM_SIZE_LIMIT;
+  return get_used_mem_size() >= limit;
+}
+
+int64_t ObHashJoin::get_used_mem_size() const
+{
+  int64_t size = 0;
+  for (int64_t i = 0; i < PARTITION_NUM; ++i)
+  {
+    const Partition &part = partitions_[i];
+    size += part.store_.get_used_mem_size()
+      + part.entries_.count() * static_cast<int64_t>(sizeof(Entry))
+      + part.bucket_num_ * static_cast<int64_t>(sizeof(int64_t));
+  }
+  return size + bloom_filter_.get_nbit() / CHAR_BIT;
+}
+
+int ObHashJoin::spill_partition(Partition &part)
+{
+  int ret = OB_SUCCESS;
+  if (!bloom_filter_inited_ && OB_SUCCESS != (ret = create_bloom_filter()))
+  {
+    TBSYS_LOG(WARN, "failed to create bloom filter, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = open_spill_file(part.spill_.build_file_, part.spill_.build_filename_)))
+  {
+    TBSYS_LOG(WARN, "failed to open build spill file, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = open_spill_file(part.spill_.probe_file_, part.spill_.probe_filename_)))
+  {
+    TBSYS_LOG(WARN, "failed to open probe spill file, err=%d", ret);
+  }
+  else
+  {
+    part.spill_.level_ = level_ + 1;
+    part.spill_.build_row_count_ = 0;
+    part.spill_.probe_row_count_ = 0;
+    TBSYS_LOG(INFO, "spill hash join partition, level=%ld row_count=%ld used=%ld file=%s",
+              level_, part.entries_.count(), get_used_mem_size(), part.spill_.build_filename_);
+    // the stored rows are already in compact format
+    for (int64_t i = 0; OB_SUCCESS == ret && i < part.entries_.count(); ++i)
+    {
+      if (OB_SUCCESS != (ret = part.spill_.build_file_->append_row(
+                             part.entries_.at(i).stored_row_->get_compact_row())))
+      {
+        TBSYS_LOG(WARN, "failed to append row, err=%d file=%s", ret, part.spill_.build_filename_);
+      }
+      else
+      {
+        ++part.spill_.build_row_count_;
+      }
+    }
+    part.entries_.clear();
+    part.store_.clear_rows();
+  }
+  if (OB_SUCCESS != ret)
+  {
+    destroy_spill_files(part.spill_);
+  }
+  return ret;
+}
+
+int ObHashJoin::open_spill_file(ObRunFile *&run_file, char *filename)
+{
+  int ret = OB_SUCCESS;
+  ObString fname;
+  int len = snprintf(filename, OB_MAX_FILE_NAME_LENGTH, "%.*s.%ld",
+                     run_filename_.length(), run_filename_.ptr(), spill_file_count_++);
+  fname.assign_ptr(filename, len);
+  if (OB_SUCCESS != (ret = spill_row_buf_.ensure_space(OB_MAX_ROW_LENGTH, ObModIds::OB_SQL_HASH_JOIN)))
+  {
+    TBSYS_LOG(WARN, "failed to alloc spill row buffer, err=%d", ret);
+  }
+  else if (NULL == (run_file = OB_NEW(ObRunFile, ObModIds::OB_SQL_HASH_JOIN)))
+  {
+    TBSYS_LOG(ERROR, "no memory");
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else if (OB_SUCCESS != (ret = run_file->open(fname)))
+  {
+    TBSYS_LOG(WARN, "failed to open run file, err=%d file=%s", ret, filename);
+  }
+  else if (OB_SUCCESS != (ret = run_file->begin_append_run(SPILL_BUCKET_IDX)))
+  {
+    TBSYS_LOG(WARN, "failed to begin append run, err=%d file=%s", ret, filename);
+  }
+  return ret;
+}
+
+int ObHashJoin::append_row(ObRunFile &run_file, const ObRow &row)
+{
+  int ret = OB_SUCCESS;
+  ObString compact_row;
+  compact_row.assign_buffer(spill_row_buf_.get_buffer(),
+                            static_cast<ObString::obstr_size_t>(spill_row_buf_.get_buffer_size()));
+  if (OB_SUCCESS != (ret = ObRowUtil::convert(row, compact_row)))
+  {
+    TBSYS_LOG(WARN, "failed to convert row, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = run_file.append_row(compact_row)))
+  {
+    TBSYS_LOG(WARN, "failed to append row, err=%d", ret);
+  }
+  return ret;
+}
+
+int ObHashJoin::get_next_row(const ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  row = NULL;
+  if (OB_UNLIKELY(NULL != my_phy_plan_ && my_phy_plan_->is_timeout()))
+  {
+    TBSYS_LOG(WARN, "execution timeout, ts=%ld", my_phy_plan_->get_timeout_timestamp());
+    ret = OB_PROCESS_TIMEOUT;
+  }
+  while (OB_SUCCESS == ret && NULL == row)
+  {
+    switch(state_)
+    {
+      case PROBE:
+        if (OB_ITER_END == (ret = probe_get_next_row(row)))
+        {
+          if (OB_SUCCESS == (ret = finish_probe()))
+          {
+            state_ = need_output_build_rows() ? OUTPUT_BUILD : NEXT_PARTITION;
+            output_part_idx_ = 0;
+            output_entry_idx_ = 0;
+          }
+        }
+        break;
+      case OUTPUT_BUILD:
+        if (OB_ITER_END == (ret = output_build_get_next_row(row)))
+        {
+          state_ = NEXT_PARTITION;
+          ret = OB_SUCCESS;
+        }
+        break;
+      case NEXT_PARTITION:
+        if (OB_SUCCESS == (ret = next_partition()))
+        {
+          state_ = PROBE;
+        }
+        break;
+      default:
+        TBSYS_LOG(ERROR, "unexpected state=%d", state_);
+        ret = OB_ERR_UNEXPECTED;
+        break;
+    }
+  } // end while
+  if (OB_SUCCESS != ret && OB_ITER_END != ret)
+  {
+    TBSYS_LOG(WARN, "failed to get next row, err=%d", ret);
+  }
+  return ret;
+}
+
+int ObHashJoin::probe_get_next_row(const ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  const bool output_joined_row = (INNER_JOIN == join_type_ || LEFT_OUTER_JOIN == join_type_
+                                  || RIGHT_OUTER_JOIN == join_type_ || FULL_OUTER_JOIN == join_type_);
+  row = NULL;
+  while (OB_SUCCESS == ret && NULL == row)
+  {
+    if (NULL == probe_row_)
+    {
+      bool has_null = false;
+      if (OB_SUCCESS != (ret = get_next_probe_row(probe_row_)))
+      {
+        if (OB_ITER_END != ret)
+        {
+          TBSYS_LOG(WARN, "failed to get next probe row, err=%d", ret);
+        }
+        probe_row_ = NULL;
+      }
+      else if (OB_SUCCESS != (ret = calc_hash(*probe_row_, left_key_idxs_, probe_hash_, has_null)))
+      {
+        TBSYS_LOG(WARN, "failed to calc hash, err=%d", ret);
+      }
+      else
+      {
+        probe_part_idx_ = get_partition_idx(probe_hash_);
+        Partition &part = partitions_[probe_part_idx_];
+        ++probe_row_idx_;
+        probe_matched_ = is_chunked_ && is_probe_row_matched(probe_row_idx_);
+        curr_entry_ = -1;
+        if (has_null || (bloom_filter_inited_ && !bloom_filter_.contain(probe_hash_)))
+        {
+          // no build row matches
+        }
+        else if (probe_matched_ && (LEFT_SEMI_JOIN == join_type_ || LEFT_ANTI_SEMI_JOIN == join_type_))
+        {
+          // done by an earlier chunk
+        }
+        else if (part.is_spilled())
+        {
+          if (OB_SUCCESS != (ret = append_row(*part.spill_.probe_file_, *probe_row_)))
+          {
+            TBSYS_LOG(WARN, "failed to spill probe row, err=%d", ret);
+          }
+          else
+          {
+            ++part.spill_.probe_row_count_;
+            probe_row_ = NULL;
+          }
+        }
+        else if (0 < part.bucket_num_)
+        {
+          curr_entry_ = part.buckets_[static_cast<int64_t>(probe_hash_) & (part.bucket_num_ - 1)];
+        }
+      }
+    }
+    else
+    {
+      Partition &part = partitions_[probe_part_idx_];
+      while (OB_SUCCESS == ret && NULL == row && 0 <= curr_entry_)
+      {
+        Entry &entry = part.entries_.at(curr_entry_);
+        bool equal = false;
+        bool is_qualified = true;
+        curr_entry_ = entry.next_;
+        if (entry.hash_ != probe_hash_
+            || (entry.matched_ && (RIGHT_SEMI_JOIN == join_type_ || RIGHT_ANTI_SEMI_JOIN == join_type_)))
+        {
+          // skip
+        }
+        else if (OB_SUCCESS != (ret = is_key_equal(*probe_row_, entry, equal)))
+        {
+          TBSYS_LOG(WARN, "failed to compare join keys, err=%d", ret);
+        }
+        else if (!equal)
+        {
+          // hash collision
+        }
+        else if (!output_joined_row && 0 >= other_join_conds_.count())
+        {
+          // the joined row is not needed
+        }
+        else if (OB_SUCCESS != (ret = ObRowUtil::convert(entry.stored_row_->get_compact_row(), build_row_)))
+        {
+          TBSYS_LOG(WARN, "failed to convert compact row, err=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = join_rows(*probe_row_, build_row_)))
+        {
+          TBSYS_LOG(WARN, "failed to join rows, err=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = curr_row_is_qualified(is_qualified)))
+        {
+          TBSYS_LOG(WARN, "failed to test qualification, err=%d", ret);
+        }
+        if (OB_SUCCESS == ret && equal && is_qualified)
+        {
+          entry.matched_ = true;
+          probe_matched_ = true;
+          if (output_joined_row)
+          {
+            row = &curr_row_;
+          }
+          else if (LEFT_SEMI_JOIN == join_type_)
+          {
+            row = probe_row_;
+            curr_entry_ = -1;
+          }
+          else if (LEFT_ANTI_SEMI_JOIN == join_type_)
+          {
+            curr_entry_ = -1;
+          }
+        }
+      } // end while
+      if (OB_SUCCESS == ret && NULL == row && 0 > curr_entry_)
+      {
+        // all the build rows matching the probe row are done
+        if (probe_matched_)
+        {
+          if (is_chunked_ && OB_SUCCESS != (ret = set_probe_row_matched(probe_row_idx_)))
+          {
+            TBSYS_LOG(WARN, "failed to mark probe row, err=%d idx=%ld", ret, probe_row_idx_);
+          }
+        }
+        else if (is_chunked_ && build_chunk_full_)
+        {
+          // may be matched by the following chunks
+        }
+        else if (LEFT_OUTER_JOIN == join_type_ || FULL_OUTER_JOIN == join_type_)
+        {
+          if (OB_SUCCESS != (ret = left_join_rows(*probe_row_)))
+          {
+            TBSYS_LOG(WARN, "failed to join rows, err=%d", ret);
+          }
+          else
+          {
+            row = &curr_row_;
+          }
+        }
+        else if (LEFT_ANTI_SEMI_JOIN == join_type_)
+        {
+          row = probe_row_;
+        }
+        probe_row_ = NULL;
+      }
+    }
+  } // end while
+  return ret;
+}
+
+// all probe rows are joined or spilled, queue the spilled partitions
+int ObHashJoin::finish_probe()
+{
+  int ret = OB_SUCCESS;
+  for (int64_t i = 0; i < PARTITION_NUM; ++i)
+  {
+    SpillFiles &spill = partitions_[i].spill_;
+    if (NULL == spill.build_file_)
+    {
+      // in memory
+    }
+    else if (OB_SUCCESS != ret)
+    {
+      destroy_spill_files(spill);
+    }
+    else if ((0 >= spill.probe_row_count_ && !need_output_build_rows())
+             || (0 >= spill.build_row_count_ && !need_unmatched_probe_rows()))
+    {
+      // nothing to output
+      destroy_spill_files(spill);
+    }
+    else if (OB_SUCCESS != (ret = spill.probe_file_->end_append_run()))
+    {
+      TBSYS_LOG(WARN, "failed to end append run, err=%d file=%s", ret, spill.probe_filename_);
+      destroy_spill_files(spill);
+    }
+    else if (OB_SUCCESS != (ret = pending_spills_.push_back(spill)))
+    {
+      TBSYS_LOG(WARN, "failed to push back, err=%d", ret);
+      destroy_spill_files(spill);
+    }
+    else
+    {
+      // owned by pending_spills_ now
+      spill = SpillFiles();
+    }
+  } // end for
+  if (0 < level_)
+  {
+    if (0 < curr_spill_.probe_row_count_)
+    {
+      curr_spill_.probe_file_->end_read_bucket();
+    }
+    // the probe file is read again for the next chunk
+    if (!build_chunk_full_)
+    {
+      destroy_spill_files(curr_spill_);
+    }
+  }
+  return ret;
+}
+
+int ObHashJoin::output_build_get_next_row(const ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  row = NULL;
+  while (OB_SUCCESS == ret && NULL == row && output_part_idx_ < PARTITION_NUM)
+  {
+    const ObArray<Entry> &entries = partitions_[output_part_idx_].entries_;
+    if (output_entry_idx_ >= entries.count())
+    {
+      ++output_part_idx_;
+      output_entry_idx_ = 0;
+    }
+    else
+    {
+      const Entry &entry = entries.at(output_entry_idx_++);
+      if (entry.matched_ != (RIGHT_SEMI_JOIN == join_type_))
+      {
+        // skip
+      }
+      else if (OB_SUCCESS != (ret = ObRowUtil::convert(entry.stored_row_->get_compact_row(), build_row_)))
+      {
+        TBSYS_LOG(WARN, "failed to convert compact row, err=%d", ret);
+      }
+      else if (RIGHT_SEMI_JOIN == join_type_ || RIGHT_ANTI_SEMI_JOIN == join_type_)
+      {
+        row = &build_row_;
+      }
+      else if (OB_SUCCESS != (ret = right_join_rows(build_row_)))
+      {
+        TBSYS_LOG(WARN, "failed to join rows, err=%d", ret);
+      }
+      else
+      {
+        row = &curr_row_;
+      }
+    }
+  } // end while
+  if (OB_SUCCESS == ret && NULL == row)
+  {
+    ret = OB_ITER_END;
+  }
+  return ret;
+}
+
+int ObHashJoin::next_partition()
+{
+  int ret = OB_SUCCESS;
+  int64_t run_count = 0;
+  if (build_chunk_full_)
+  {
+    ret = next_build_chunk();
+  }
+  else if (0 >= pending_spills_.count())
+  {
+    ret = OB_ITER_END;
+  }
+  else if (OB_SUCCESS != (ret = pending_spills_.pop_back(curr_spill_)))
+  {
+    TBSYS_LOG(WARN, "failed to pop back, err=%d", ret);
+  }
+  else
+  {
+    level_ = curr_spill_.level_;
+    is_chunked_ = false;
+    probe_matched_bits_.clear();
+    if (0 < curr_spill_.build_row_count_
+        && OB_SUCCESS != (ret = curr_spill_.build_file_->begin_read_bucket(SPILL_BUCKET_IDX, run_count)))
+    {
+      TBSYS_LOG(WARN, "failed to begin read spill file, err=%d file=%s", ret, curr_spill_.build_filename_);
+    }
+    else
+    {
+      ret = next_build_chunk();
+    }
+    TBSYS_LOG(INFO, "join spilled partition, level=%ld build_row_count=%ld probe_row_count=%ld chunked=%c err=%d",
+              level_, curr_spill_.build_row_count_, curr_spill_.probe_row_count_, is_chunked_ ? 'Y' : 'N', ret);
+  }
+  return ret;
+}
+
+// load the next chunk of the build file and read the probe file from the start
+int ObHashJoin::next_build_chunk()
+{
+  int ret = OB_SUCCESS;
+  int64_t run_count = 0;
+  reuse_partitions();
+  probe_row_ = NULL;
+  probe_row_idx_ = -1;
+  curr_entry_ = -1;
+  if (OB_SUCCESS != (ret = build()))
+  {
+    TBSYS_LOG(WARN, "failed to build hash table, err=%d level=%ld", ret, level_);
+  }
+  else
+  {
+    if (0 < curr_spill_.build_row_count_ && !build_chunk_full_)
+    {
+      curr_spill_.build_file_->end_read_bucket();
+    }
+    if (0 < curr_spill_.probe_row_count_
+        && OB_SUCCESS != (ret = curr_spill_.probe_file_->begin_read_bucket(SPILL_BUCKET_IDX, run_count)))
+    {
+      TBSYS_LOG(WARN, "failed to begin read spill file, err=%d file=%s", ret, curr_spill_.probe_filename_);
+    }
+  }
+  return ret;
+}
+
+bool ObHashJoin::is_probe_row_matched(const int64_t idx) const
+{
+  return idx / 64 < probe_matched_bits_.count()
+    && 0 != (probe_matched_bits_.at(idx / 64) & (1UL << (idx % 64)));
+}
+
+int ObHashJoin::set_probe_row_matched(const int64_t idx)
+{
+  int ret = OB_SUCCESS;
+  while (OB_SUCCESS == ret && probe_matched_bits_.count() <= idx / 64)
+  {
+    ret = probe_matched_bits_.push_back(0);
+  }
+  if (OB_SUCCESS == ret)
+  {
+    probe_matched_bits_.at(idx / 64) |= (1UL << (idx % 64));
+  }
+  return ret;
+}
+
+int ObHashJoin::curr_row_is_qualified(bool &is_qualified)
+{
+  int ret = OB_SUCCESS;
+  is_qualified = true;
+  const ObObj *res = NULL;
+  for (int64_t i = 0; i < other_join_conds_.count(); ++i)
+  {
+    ObSqlExpression &expr = other_join_conds_.at(i);
+    if (OB_SUCCESS != (ret = expr.calc(curr_row_, res)))
+    {
+      TBSYS_LOG(WARN, "failed to calc expr, err=%d", ret);
+      break;
+    }
+    else if (!res->is_true())
+    {
+      is_qualified = false;
+      break;
+    }
+  }
+  return ret;
+}
+
+int ObHashJoin::join_rows(const ObRow& r1, const ObRow& r2)
+{
+  int ret = OB_SUCCESS;
+  const ObObj *cell = NULL;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  int64_t i = 0;
+  for (; i < r1.get_column_num(); ++i)
+  {
+    if (OB_SUCCESS != (ret = r1.raw_get_cell(i, cell, tid, cid)))
+    {
+      TBSYS_LOG(ERROR, "unexpected branch, err=%d", ret);
+      ret = OB_ERR_UNEXPECTED;
+      break;
+    }
+    else if (OB_SUCCESS != (ret = curr_row_.raw_set_cell(i, *cell)))
+    {
+      TBSYS_LOG(WARN, "failed to set cell, err=%d i=%ld", ret, i);
+      break;
+    }
+  } // end for
+  for (int64_t j = 0; OB_SUCCESS == ret && j < r2.get_column_num(); ++j)
+  {
+    if (OB_SUCCESS != (ret = r2.raw_get_cell(j, cell, tid, cid)))
+    {
+      TBSYS_LOG(ERROR, "unexpected branch, err=%d", ret);
+      ret = OB_ERR_UNEXPECTED;
+    }
+    else if (OB_SUCCESS != (ret = curr_row_.raw_set_cell(i+j, *cell)))
+    {
+      TBSYS_LOG(WARN, "failed to set cell, err=%d j=%ld", ret, j);
+    }
+  } // end for
+  return ret;
+}
+
+int ObHashJoin::left_join_rows(const ObRow& r1)
+{
+  int ret = OB_SUCCESS;
+  const ObObj *cell = NULL;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  int64_t i = 0;
+  for (; i < r1.get_column_num(); ++i)
+  {
+    if (OB_SUCCESS != (ret = r1.raw_get_cell(i, cell, tid, cid)))
+    {
+      TBSYS_LOG(ERROR, "unexpected branch, err=%d", ret);
+      ret = OB_ERR_UNEXPECTED;
+      break;
+    }
+    else if (OB_SUCCESS != (ret = curr_row_.raw_set_cell(i, *cell)))
+    {
+      TBSYS_LOG(WARN, "failed to set cell, err=%d i=%ld", ret, i);
+      break;
+    }
+  } // end for
+  int64_t right_row_column_num = row_desc_.get_column_num() - r1.get_column_num();
+  ObObj null_cell;
+  null_cell.set_null();
+  for (int64_t j = 0; OB_SUCCESS == ret && j < right_row_column_num; ++j)
+  {
+    if (OB_SUCCESS != (ret = curr_row_.raw_set_cell(i+j, null_cell)))
+    {
+      TBSYS_LOG(WARN, "failed to set cell, err=%d j=%ld", ret, j);
+    }
+  } // end for
+  return ret;
+}
+
+int ObHashJoin::right_join_rows(const ObRow& r2)
+{
+  int ret = OB_SUCCESS;
+  const ObObj *cell = NULL;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  int64_t left_row_column_num = row_desc_.get_column_num() - r2.get_column_num();
+  ObObj null_cell;
+  null_cell.set_null();
+  for (int64_t i = 0; i < left_row_column_num; ++i)
+  {
+    if (OB_SUCCESS != (ret = curr_row_.raw_set_cell(i, null_cell)))
+    {
+      TBSYS_LOG(WARN, "failed to set cell, err=%d i=%ld", ret, i);
+      break;
+    }
+  } // end for
+  for (int64_t j = 0; OB_SUCCESS == ret && j < r2.get_column_num(); ++j)
+  {
+    if (OB_SUCCESS != (ret = r2.raw_get_cell(j, cell, tid, cid)))
+    {
+      TBSYS_LOG(ERROR, "unexpected branch, err=%d", ret);
+      ret = OB_ERR_UNEXPECTED;
+    }
+    else if (OB_SUCCESS != (ret = curr_row_.raw_set_cell(left_row_column_num+j, *cell)))
+    {
+      TBSYS_LOG(WARN, "failed to set cell, err=%d j=%ld", ret, j);
+    }
+  } // end for
+  return ret;
+}
+
+void ObHashJoin::reuse_partitions()
+{
+  for (int64_t i = 0; i < PARTITION_NUM; ++i)
+  {
+    partitions_[i].entries_.clear();
+    partitions_[i].store_.clear_rows();
+  }
+  bloom_filter_.destroy();
+  bloom_filter_inited_ = false;
+}
+
+void ObHashJoin::destroy_spill_files(SpillFiles &spill)
+{
+  if (NULL != spill.build_file_)
+  {
+    spill.build_file_->close();
+    OB_DELETE(ObRunFile, ObModIds::OB_SQL_HASH_JOIN, spill.build_file_);
+    spill.build_file_ = NULL;
+    if (0 != unlink(spill.build_filename_))
+    {
+      TBSYS_LOG(WARN, "failed to remove spill file, file=%s err=%s", spill.build_filename_, strerror(errno));
+    }
+  }
+  if (NULL != spill.probe_file_)
+  {
+    spill.probe_file_->close();
+    OB_DELETE(ObRunFile, ObModIds::OB_SQL_HASH_JOIN, spill.probe_file_);
+    spill.probe_file_ = NULL;
+    if (0 != unlink(spill.probe_filename_))
+    {
+      TBSYS_LOG(WARN, "failed to remove spill file, file=%s err=%s", spill.probe_filename_, strerror(errno));
+    }
+  }
+  spill.build_row_count_ = 0;
+  spill.probe_row_count_ = 0;
+}
+
+void ObHashJoin::destroy_all_spill_files()
+{
+  for (int64_t i = 0; i < PARTITION_NUM; ++i)
+  {
+    destroy_spill_files(partitions_[i].spill_);
+  }
+  for (int64_t i = 0; i < pending_spills_.count(); ++i)
+  {
+    destroy_spill_files(pending_spills_.at(i));
+  }
+  pending_spills_.clear();
+  destroy_spill_files(curr_spill_);
+}
+
+int64_t ObHashJoin::to_string(char* buf, const int64_t buf_len) const
+{
+  int64_t pos = 0;
+  databuff_printf(buf, buf_len, pos, "HashJoin(mem_size_limit=%ld)\n", mem_size_limit_);
+  pos += ObJoin::to_string(buf+pos, buf_len-pos);
+  return pos;
+}
+
+ObPhyOperatorType ObHashJoin::get_type() const
+{
+  return PHY_HASH_JOIN;
+}
@@ -0,0 +1,210 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_hash_join.h
+ *
+ * Authors:
+ *   Zhifeng YANG <zhuweng.yzf@taobao.com>
+ *
+ */
+#ifndef _OB_HASH_JOIN_H
+#define _OB_HASH_JOIN_H 1
+
+#include "ob_join.h"
+#include "ob_run_file.h"
+#include "common/ob_row.h"
+#include "common/ob_array.h"
+#include "common/ob_row_store.h"
+#include "common/ob_bloomfilter.h"
+
+namespace oceanbase
+{
+  namespace sql
+  {
+    // 不要求两个输入在等值join列上有序
+    //
+    // right_child is the build side and left_child is the probe side. rows of
+    // the build side are hashed into PARTITION_NUM partitions, each has its
+    // own row store and chained hash table. when the memory exceeds the limit,
+    // the biggest partition is written to a run file together with the probe
+    // rows falling into it (hybrid hash join), and the spilled partitions are
+    // joined the same way after the partitions in memory. rows of the same
+    // join key can not be split by spilling, so a partition still too big at
+    // MAX_SPILL_LEVEL is joined chunk by chunk: as many build rows as fit are
+    // loaded and the whole probe file is read for every chunk (block nested
+    // loop). the probe rows matched by earlier chunks are kept in a bitmap.
+    // once a partition is spilled, a bloom filter of the build keys is built
+    // and the probe rows missing it are not probed or spilled at all.
+    // the output is not ordered, all join types are supported.
+    // the join keys are hashed and compared as ObObj without type promotion,
+    // so both sides of every equijoin condition must have the same type.
+    class ObHashJoin: public ObJoin
+    {
+      public:
+        ObHashJoin();
+        virtual ~ObHashJoin();
+        virtual int open();
+        virtual int close();
+        virtual int set_join_type(const ObJoin::JoinType join_type);
+        virtual int get_next_row(const common::ObRow *&row);
+        virtual int get_row_desc(const common::ObRowDesc *&row_desc) const;
+        virtual int64_t to_string(char* buf, const int64_t buf_len) const;
+        virtual ObPhyOperatorType get_type() const;
+        void set_mem_size_limit(const int64_t limit);
+        /// prefix of the spill files, DEFAULT_RUN_FILE_PREFIX if not set
+        int set_run_filename(const common::ObString &filename);
+      private:
+        // types and constants
+        static const int64_t DEFAULT_MEM_SIZE_LIMIT = 256*1024*1024LL; // used if mem_size_limit_ is not set
+        static const int64_t PARTITION_NUM = 8;
+        static const int64_t PARTITION_SHIFT = 29; // the high 3 bits of the 32 bits hash
+        static const int64_t MAX_SPILL_LEVEL = 8;
+        static const int64_t SPILL_BUCKET_IDX = 0;
+        static const int64_t BLOOM_FILTER_HASH_NUM = 4;
+        static const int64_t BLOOM_FILTER_BITS_PER_ROW = 8;
+        static const int64_t MIN_BLOOM_FILTER_BITS = 64*1024;
+        static const int64_t MAX_BLOOM_FILTER_BITS = 256*1024*1024LL;
+        static const char* const DEFAULT_RUN_FILE_PREFIX;
+        enum State
+        {
+          PROBE,
+          OUTPUT_BUILD,         // unmatched (or matched for right semi join) build rows
+          NEXT_PARTITION
+        };
+        struct Entry
+        {
+          uint64_t hash_;
+          const common::ObRowStore::StoredRow *stored_row_; // reserved cells are the join keys
+          int64_t next_;
+          bool null_key_;
+          bool matched_;
+        };
+        struct SpillFiles
+        {
+          ObRunFile *build_file_;
+          ObRunFile *probe_file_;
+          int64_t level_;
+          int64_t build_row_count_;
+          int64_t probe_row_count_;
+          char build_filename_[common::OB_MAX_FILE_NAME_LENGTH];
+          char probe_filename_[common::OB_MAX_FILE_NAME_LENGTH];
+          SpillFiles()
+            :build_file_(NULL), probe_file_(NULL), level_(0),
+             build_row_count_(0), probe_row_count_(0)
+          {
+            build_filename_[0] = '\0';
+            probe_filename_[0] = '\0';
+          }
+        };
+        struct Partition
+        {
+          common::ObRowStore store_;
+          common::ObArray<Entry> entries_;
+          int64_t *buckets_;
+          int64_t bucket_num_;
+          SpillFiles spill_;
+          Partition()
+            :store_(common::ObModIds::OB_SQL_HASH_JOIN), buckets_(NULL), bucket_num_(0)
+          {
+          }
+          bool is_spilled() const { return NULL != spill_.build_file_; }
+        };
+        struct BloomFilterHashFunc
+        {
+          int64_t operator() (const uint64_t &key, const int64_t hash) const
+          {
+            return common::murmurhash2(&key, static_cast<int32_t>(sizeof(key)), static_cast<uint32_t>(hash));
+          }
+        };
+        struct BloomFilterAllocator
+        {
+          void *alloc(const int32_t nbyte) { return common::ob_malloc(nbyte, common::ObModIds::OB_SQL_HASH_JOIN); }
+          void free(void *ptr) { common::ob_free(ptr, common::ObModIds::OB_SQL_HASH_JOIN); }
+        };
+        typedef common::ObBloomFilter<uint64_t, BloomFilterHashFunc, BloomFilterAllocator> BloomFilter;
+      private:
+        // disallow copy
+        ObHashJoin(const ObHashJoin &other);
+        ObHashJoin& operator=(const ObHashJoin &other);
+        // function members
+        int init_join_keys(const common::ObRowDesc &left_row_desc, const common::ObRowDesc &right_row_desc);
+        int cons_row_desc(const common::ObRowDesc &rd1, const common::ObRowDesc &rd2);
+        bool need_output_build_rows() const;
+        bool need_unmatched_probe_rows() const;
+        int get_next_build_row(const common::ObRow *&row);
+        int get_next_probe_row(const common::ObRow *&row);
+        int build();
+        int add_build_row(const common::ObRow &row);
+        int finish_build();
+        int build_buckets(Partition &part);
+        int create_bloom_filter();
+        int calc_hash(const common::ObRow &row, const common::ObArray<int64_t> &key_idxs,
+                      uint64_t &hash, bool &has_null) const;
+        int is_key_equal(const common::ObRow &probe_row, const Entry &entry, bool &equal) const;
+        int64_t get_partition_idx(const uint64_t hash) const;
+        bool need_spill() const;
+        int spill_partition(Partition &part);
+        int open_spill_file(ObRunFile *&run_file, char *filename);
+        int append_row(ObRunFile &run_file, const common::ObRow &row);
+        int probe_get_next_row(const common::ObRow *&row);
+        int finish_probe();
+        int next_build_chunk();
+        bool is_probe_row_matched(const int64_t idx) const;
+        int set_probe_row_matched(const int64_t idx);
+        int output_build_get_next_row(const common::ObRow *&row);
+        int next_partition();
+        int curr_row_is_qualified(bool &is_qualified);
+        int join_rows(const common::ObRow& r1, const common::ObRow& r2);
+        int left_join_rows(const common::ObRow& r1);
+        int right_join_rows(const common::ObRow& r2);
+        void reuse_partitions();
+        void destroy_spill_files(SpillFiles &spill);
+        void destroy_all_spill_files();
+        int64_t get_used_mem_size() const;
+      private:
+        // data members
+        common::ObArray<int64_t> left_key_idxs_;
+        common::ObArray<int64_t> right_key_idxs_;
+        common::ObRowDesc row_desc_;              // left columns + right columns
+        const common::ObRowDesc *out_row_desc_;
+        Partition partitions_[PARTITION_NUM];
+        BloomFilter bloom_filter_;
+        bool bloom_filter_inited_;
+        int64_t level_;                           // 0 for the children, n for the files spilled at level n-1
+        State state_;
+        SpillFiles curr_spill_;                   // files being joined, NULL files for the children
+        common::ObArray<SpillFiles> pending_spills_;
+        // block nested loop at MAX_SPILL_LEVEL
+        bool is_chunked_;                         // curr_spill_ is joined in more than one chunk
+        bool build_chunk_full_;                   // more build rows are left in the build file
+        int64_t probe_row_idx_;                   // index of probe_row_ in the probe file
+        common::ObArray<uint64_t> probe_matched_bits_;
+        // probe cursor
+        const common::ObRow *probe_row_;
+        uint64_t probe_hash_;
+        int64_t probe_part_idx_;
+        int64_t curr_entry_;
+        bool probe_matched_;
+        // output build rows cursor
+        int64_t output_part_idx_;
+        int64_t output_entry_idx_;
+        common::ObRow curr_row_;
+        common::ObRow build_row_;                 // the stored build row
+        common::ObRow build_file_row_;            // build row read from the spill file
+        common::ObRow probe_file_row_;            // probe row read from the spill file
+        int64_t mem_size_limit_;
+        char run_filename_buf_[common::OB_MAX_FILE_NAME_LENGTH];
+        common::ObString run_filename_;
+        int64_t spill_file_count_;
+        common::ObMemBuf spill_row_buf_;
+    };
+  } // end namespace sql
+} // end namespace oceanbase
+
+#endif /* _OB_HASH_JOIN_H */
@@ -121,6 +121,19 @@ int ObLimit::open()
   else
   {
     is_instantiated_ = true;
+    if (child_op_->is_batch_native())
+    {
+      // do not read much more rows than needed from the child
+      int64_t capacity = ObRowBatch::DEFAULT_BATCH_SIZE;
+      if (0 <= limit_ && offset_ + limit_ < capacity)
+      {
+        capacity = offset_ + limit_ > 0 ? offset_ + limit_ : 1;
+      }
+      if (OB_SUCCESS != (ret = batch_reader_.open(*this, capacity)))
+      {
+        TBSYS_LOG(WARN, "failed to open batch reader, err=%d", ret);
+      }
+    }
   }
   return ret;
 }
@@ -128,6 +141,7 @@ int ObLimit::open()
 int ObLimit::close()
 {
   is_instantiated_ = false;
+  batch_reader_.close();
   return ObSingleChildPhyOperator::close();
 }
 
@@ -155,6 +169,10 @@ int ObLimit::get_next_row(const common::ObRow *&row)
     ret = OB_NOT_INIT;
     TBSYS_LOG(ERROR, "child_op_ is NULL or invalid offset=%ld", offset_);
   }
+  else if (batch_reader_.is_opened())
+  {
+    ret = batch_reader_.get_next_row(row);
+  }
   else
   {
     while (input_count_ < offset_)
@@ -196,6 +214,66 @@ int ObLimit::get_next_row(const common::ObRow *&row)
   return ret;
 }
 
+int ObLimit::get_next_batch(ObRowBatch &batch)
+{
+  int ret = OB_SUCCESS;
+  int64_t output_count = 0;
+  if (OB_UNLIKELY(NULL == child_op_ || 0 > offset_))
+  {
+    ret = OB_NOT_INIT;
+    TBSYS_LOG(ERROR, "child_op_ is NULL or invalid offset=%ld", offset_);
+  }
+  else
+  {
+    while (OB_SUCCESS == ret && 0 == output_count)
+    {
+      if (0 <= limit_ && output_count_ >= limit_)
+      {
+        ret = OB_ITER_END;
+      }
+      else if (OB_SUCCESS != (ret = child_op_->get_next_batch(batch)))
+      {
+        if (OB_ITER_END != ret)
+        {
+          TBSYS_LOG(WARN, "child_op failed to get next batch, err=%d, limit_=%ld, offset_=%ld, input_count_=%ld, output_count=%ld",
+                    ret, limit_, offset_, input_count_, output_count_);
+        }
+      }
+      else
+      {
+        const int64_t row_count = batch.get_row_count();
+        int64_t skip_count = offset_ - input_count_;
+        if (skip_count > row_count)
+        {
+          skip_count = row_count;
+        }
+        input_count_ += skip_count;
+        output_count = row_count - skip_count;
+        if (0 <= limit_ && output_count > limit_ - output_count_)
+        {
+          output_count = limit_ - output_count_;
+        }
+        if (0 < output_count)
+        {
+          int64_t *selection = batch.get_selection();
+          if (0 < skip_count)
+          {
+            memmove(selection, selection + skip_count, output_count * sizeof(int64_t));
+          }
+          batch.set_row_count(output_count);
+          output_count_ += output_count;
+        }
+      }
+    } // end while
+  }
+  return ret;
+}
+
+bool ObLimit::is_batch_native() const
+{
+  return NULL != child_op_ && child_op_->is_batch_native();
+}
+
 int64_t ObLimit::to_string(char* buf, const int64_t buf_len) const
 {
   int64_t pos = 0;
@@ -17,6 +17,7 @@
 #define _OB_LIMIT_H 1
 #include "ob_single_child_phy_operator.h"
 #include "ob_sql_expression.h"
+#include "ob_row_batch.h"
 
 namespace oceanbase
 {
@@ -36,6 +37,9 @@ namespace oceanbase
         virtual int open();
         virtual int close();
         virtual int get_next_row(const common::ObRow *&row);
+        /// skip and truncate the child batch in place by the selection vector
+        virtual int get_next_batch(ObRowBatch &batch);
+        virtual bool is_batch_native() const;
         virtual int get_row_desc(const common::ObRowDesc *&row_desc) const;
         virtual int64_t to_string(char* buf, const int64_t buf_len) const;
         void assign(const ObLimit &other);
@@ -56,6 +60,7 @@ namespace oceanbase
         int64_t offset_;
         int64_t input_count_;
         int64_t output_count_;
+        ObRowBatchReader batch_reader_; // used if the child is batch native
     };
   } // end namespace sql
 } // end namespace oceanbase
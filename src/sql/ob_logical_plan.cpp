@@ -104,7 +104,7 @@ namespace oceanbase
       return expr;
     }
 
-    int ObLogicalPlan::fill_result_set(ObResultSet& result_set, ObSQLSessionInfo* session_info, common::StackAllocator &alloc)
+    int ObLogicalPlan::fill_result_set(ObResultSet& result_set, ObSQLSessionInfo* session_info, common::ObIAllocator &alloc)
     {
       int ret = OB_SUCCESS;
       result_set.set_affected_rows(0);
@@ -53,6 +53,11 @@ int ObMergeGroupBy::open()
   {
     TBSYS_LOG(WARN, "failed to construct row desc, err=%d", ret);
   }
+  else if (child_op_->is_batch_native()
+           && OB_SUCCESS != (ret = child_reader_.open(*child_op_)))
+  {
+    TBSYS_LOG(WARN, "failed to open child batch reader, err=%d", ret);
+  }
   return ret;
 }
 
@@ -60,6 +65,7 @@ int ObMergeGroupBy::close()
 {
   int ret = OB_SUCCESS;
   last_input_row_ = NULL;
+  child_reader_.close();
   aggr_func_.destroy();
   ret = ObGroupBy::close();
   return ret;
@@ -118,7 +124,7 @@ int ObMergeGroupBy::get_next_row(const ObRow *&row)
   if (NULL == last_input_row_)
   {
     // get the first input row of one group
-    if (OB_SUCCESS != (ret = child_op_->get_next_row(last_input_row_)))
+    if (OB_SUCCESS != (ret = get_next_input_row(last_input_row_)))
     {
       if (OB_ITER_END != ret)
       {
@@ -142,7 +148,7 @@ int ObMergeGroupBy::get_next_row(const ObRow *&row)
   {
     bool same_group = false;
     const ObRow *input_row = NULL;
-    while (OB_SUCCESS == (ret = child_op_->get_next_row(input_row)))
+    while (OB_SUCCESS == (ret = get_next_input_row(input_row)))
     {
       if (OB_SUCCESS != (ret = is_same_group(aggr_func_.get_curr_row(), *input_row, same_group)))
       {
@@ -17,6 +17,7 @@
 #define _OB_MERGE_GROUPBY_H 1
 #include "ob_groupby.h"
 #include "ob_aggregate_function.h"
+#include "ob_row_batch.h"
 namespace oceanbase
 {
   namespace sql
@@ -45,6 +46,7 @@ namespace oceanbase
         NEED_SERIALIZE_AND_DESERIALIZE;
       private:
         int is_same_group(const ObRow &row1, const ObRow &row2, bool &result);
+        int get_next_input_row(const ObRow *&row);
         // disallow copy
         ObMergeGroupBy(const ObMergeGroupBy &other);
         ObMergeGroupBy& operator=(const ObMergeGroupBy &other);
@@ -54,6 +56,7 @@ namespace oceanbase
         // data members
         ObAggregateFunction aggr_func_;
         const ObRow *last_input_row_;
+        ObRowBatchReader child_reader_; // used if the child is batch native
     };
 
     inline void ObMergeGroupBy::set_int_div_as_double(bool did)
@@ -66,6 +69,11 @@ namespace oceanbase
       return aggr_func_.get_result_for_empty_set(row);
     }
 
+    inline int ObMergeGroupBy::get_next_input_row(const ObRow *&row)
+    {
+      return child_reader_.is_opened() ? child_reader_.get_next_row(row) : child_op_->get_next_row(row);
+    }
+
     inline bool ObMergeGroupBy::get_int_div_as_double() const
     {
       return aggr_func_.get_int_div_as_double();
@@ -15,9 +15,52 @@
  */
 
 #include "ob_phy_operator.h"
+#include "ob_row_batch.h"
 
 using namespace oceanbase;
 using namespace sql;
+using namespace oceanbase::common;
+
+// row to batch adapter for the operators which only implement get_next_row()
+int ObPhyOperator::get_next_batch(ObRowBatch &batch)
+{
+  int ret = OB_SUCCESS;
+  const ObRow *row = NULL;
+  if (batch.is_end())
+  {
+    // do not call get_next_row() again after OB_ITER_END
+    ret = OB_ITER_END;
+  }
+  else
+  {
+    batch.reuse();
+    while (!batch.is_full())
+    {
+      if (OB_SUCCESS != (ret = get_next_row(row)))
+      {
+        if (OB_ITER_END == ret)
+        {
+          batch.set_end();
+          if (0 < batch.get_row_count())
+          {
+            ret = OB_SUCCESS;
+          }
+        }
+        else
+        {
+          TBSYS_LOG(WARN, "failed to get next row, err=%d", ret);
+        }
+        break;
+      }
+      else if (OB_SUCCESS != (ret = batch.add_row(*row)))
+      {
+        TBSYS_LOG(WARN, "failed to add row to batch, err=%d", ret);
+        break;
+      }
+    } // end while
+  }
+  return ret;
+}
 
 DEFINE_SERIALIZE(ObPhyOperator)
 {
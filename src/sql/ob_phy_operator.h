@@ -23,6 +23,7 @@ namespace oceanbase
   namespace sql
   {
     class ObPhysicalPlan;
+    class ObRowBatch;
     /// 物理运算符接口
     class ObPhyOperator
     {
@@ -67,6 +68,26 @@ namespace oceanbase
          */
         virtual int get_next_row(const common::ObRow *&row) = 0;
 
+        /**
+         * get the next batch of rows, batch-at-a-time version of get_next_row()
+         * the default implementation fills the batch by get_next_row(), the
+         * varchar cells are deep copied.
+         * @note the rows are valid until the next get_next_batch() or close()
+         * @pre call open() first, batch is inited by the row desc of this operator
+         * and reset() before the first call
+         * @param batch [in/out] rows in it are replaced, at least one row is selected if OB_SUCCESS is returned
+         *
+         * @return OB_SUCCESS或OB_ITER_END或错误码
+         */
+        virtual int get_next_batch(ObRowBatch &batch);
+
+        /// true if get_next_batch() does not go through get_next_row(), so the
+        /// parent operator should read rows from this operator by batches
+        virtual bool is_batch_native() const
+        {
+          return false;
+        }
+
         /**
          * get the row description
          * the row desc should have been valid after open() and before close()
@@ -30,6 +30,8 @@
 #include "ob_multiple_scan_merge.h"
 #include "ob_multiple_get_merge.h"
 #include "ob_empty_row_filter.h"
+#include "ob_hash_groupby.h"
+#include "ob_hash_join.h"
 #include "ob_phy_operator.h"
 
 using namespace oceanbase;
@@ -68,6 +70,8 @@ ObPhyOperator *ObPhyOperatorFactory::get_one(ObPhyOperatorType phy_operator_type
     CASE_CLAUSE(PHY_MULTIPLE_GET_MERGE, ObMultipleGetMerge);
     CASE_CLAUSE(PHY_EMPTY_ROW_FILTER, ObEmptyRowFilter);
     CASE_CLAUSE(PHY_EXPR_VALUES, ObExprValues);
+    CASE_CLAUSE(PHY_HASH_GROUP_BY, ObHashGroupBy);
+    CASE_CLAUSE(PHY_HASH_JOIN, ObHashJoin);
     default:
       break;
   }
@@ -44,6 +44,8 @@ namespace oceanbase
       PHY_EMPTY_ROW_FILTER,
       PHY_EXPR_VALUES,
       PHY_UPS_EXECUTOR,
+      PHY_HASH_GROUP_BY,
+      PHY_HASH_JOIN,
 
       PHY_END /* end of phy operator type */
     };
@@ -0,0 +1,474 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_plan_cache.cpp
+ *
+ * Authors:
+ *   Zhifeng YANG <zhuweng.yzf@taobao.com>
+ *
+ */
+#include "ob_plan_cache.h"
+#include "common/ob_malloc.h"
+#include "common/ob_mod_define.h"
+#include <ctype.h>
+using namespace oceanbase::common;
+using namespace oceanbase::sql;
+
+namespace
+{
+  enum ClauseKeyword
+  {
+    OTHER_WORD,
+    PARAM_CLAUSE,               // constants of the clause are parameterized
+    NON_PARAM_CLAUSE,
+  };
+
+  inline bool is_word_char(const char c)
+  {
+    return isalnum(static_cast<unsigned char>(c)) || '_' == c || '$' == c;
+  }
+
+  inline bool word_equal(const char *word, const int64_t len, const char *keyword)
+  {
+    return static_cast<int64_t>(strlen(keyword)) == len
+      && 0 == strncasecmp(word, keyword, len);
+  }
+
+  // VALUES and VALUE are also common column names, they begin a clause
+  // only right in an INSERT or REPLACE statement
+  ClauseKeyword get_clause_keyword(const char *word, const int64_t len, const bool values_allowed)
+  {
+    static const char* const PARAM_KEYWORDS[] = {"WHERE", "SET"};
+    static const char* const NON_PARAM_KEYWORDS[] = {"SELECT", "FROM", "JOIN", "ON", "GROUP",
+                                                     "HAVING", "ORDER", "LIMIT", "UNION",
+                                                     "INTERSECT", "EXCEPT"};
+    ClauseKeyword ret = OTHER_WORD;
+    if (values_allowed && (word_equal(word, len, "VALUES") || word_equal(word, len, "VALUE")))
+    {
+      ret = PARAM_CLAUSE;
+    }
+    for (int64_t i = 0; OTHER_WORD == ret && i < static_cast<int64_t>(ARRAYSIZEOF(PARAM_KEYWORDS)); ++i)
+    {
+      if (word_equal(word, len, PARAM_KEYWORDS[i]))
+      {
+        ret = PARAM_CLAUSE;
+      }
+    }
+    for (int64_t i = 0; OTHER_WORD == ret && i < static_cast<int64_t>(ARRAYSIZEOF(NON_PARAM_KEYWORDS)); ++i)
+    {
+      if (word_equal(word, len, NON_PARAM_KEYWORDS[i]))
+      {
+        ret = NON_PARAM_CLAUSE;
+      }
+    }
+    return ret;
+  }
+
+  bool is_cachable_stmt(const char *word, const int64_t len)
+  {
+    return word_equal(word, len, "SELECT")
+      || word_equal(word, len, "INSERT")
+      || word_equal(word, len, "REPLACE")
+      || word_equal(word, len, "UPDATE")
+      || word_equal(word, len, "DELETE");
+  }
+
+  // X'..', DATE '..', TIME '..' and TIMESTAMP '..' are not strings
+  bool is_typed_literal_prefix(const char *word, const int64_t len)
+  {
+    return NULL != word
+      && (word_equal(word, len, "X")
+          || word_equal(word, len, "DATE")
+          || word_equal(word, len, "TIME")
+          || word_equal(word, len, "TIMESTAMP"));
+  }
+}
+
+int ObSqlParameterizer::parameterize(const ObString &stmt, char *buf, const int64_t buf_len,
+                                     ObString &key, ObArray<ObObj> &params, bool &cachable)
+{
+  int ret = OB_SUCCESS;
+  const char *str = stmt.ptr();
+  const int64_t len = stmt.length();
+  int64_t pos = 0;
+  int64_t out = 0;
+  bool in_param_clause = false;
+  bool clause_stack[MAX_PAREN_DEPTH];
+  int64_t depth = 0;
+  bool first_word = true;
+  bool is_insert = false;       // INSERT or REPLACE without SELECT so far
+  const char *last_word = NULL; // the word just before the current token
+  int64_t last_word_len = 0;
+  cachable = true;
+  params.clear();
+  if (NULL == buf || buf_len < len)
+  {
+    TBSYS_LOG(WARN, "invalid argument, buf=%p buf_len=%ld stmt_len=%ld", buf, buf_len, len);
+    ret = OB_INVALID_ARGUMENT;
+  }
+  else if (NULL == str || 0 >= len || MAX_STMT_LENGTH < len)
+  {
+    cachable = false;
+  }
+  while (OB_SUCCESS == ret && cachable && pos < len)
+  {
+    const char c = str[pos];
+    int64_t end = pos + 1;      // end of the current token
+    bool is_param = false;
+    bool keep_last_word = false;
+    ObObj param;
+    if (isspace(static_cast<unsigned char>(c)))
+    {
+      keep_last_word = true;
+    }
+    else if ('-' == c && end < len && '-' == str[end])
+    {
+      // comment till the end of line
+      while (end < len && '\n' != str[end] && '\r' != str[end])
+      {
+        ++end;
+      }
+      keep_last_word = true;
+    }
+    else if ('/' == c && end < len && '*' == str[end])
+    {
+      // comment or hint
+      end += 1;
+      while (end + 1 < len && !('*' == str[end] && '/' == str[end + 1]))
+      {
+        ++end;
+      }
+      if (end + 1 >= len)
+      {
+        cachable = false;
+      }
+      else
+      {
+        end += 2;
+        keep_last_word = true;
+      }
+    }
+    else if ('"' == c || '`' == c)
+    {
+      // quoted identifier
+      while (end < len && c != str[end])
+      {
+        end += ('\\' == str[end]) ? 2 : 1;
+      }
+      if (end >= len)
+      {
+        cachable = false;
+      }
+      else
+      {
+        ++end;
+      }
+    }
+    else if ('\'' == c)
+    {
+      bool escaped = false;
+      while (end < len && cachable)
+      {
+        if ('\\' == str[end])
+        {
+          escaped = true;
+          end += 2;
+        }
+        else if ('\'' == str[end])
+        {
+          if (end + 1 < len && '\'' == str[end + 1])
+          {
+            escaped = true;
+            end += 2;
+          }
+          else
+          {
+            break;
+          }
+        }
+        else if ('\n' == str[end])
+        {
+          // let the parser report it
+          cachable = false;
+        }
+        else
+        {
+          ++end;
+        }
+      }
+      if (end >= len)
+      {
+        cachable = false;
+      }
+      else if (cachable)
+      {
+        ++end;                  // the closing quote
+        if (in_param_clause && !escaped && !is_typed_literal_prefix(last_word, last_word_len))
+        {
+          ObString value(static_cast<ObString::obstr_size_t>(end - pos - 2),
+                         static_cast<ObString::obstr_size_t>(end - pos - 2), str + pos + 1);
+          param.set_varchar(value);
+          is_param = true;
+        }
+      }
+    }
+    else if (isdigit(static_cast<unsigned char>(c))
+             || ('.' == c && end < len && isdigit(static_cast<unsigned char>(str[end]))))
+    {
+      while (end < len && isdigit(static_cast<unsigned char>(str[end])))
+      {
+        ++end;
+      }
+      if ('.' == c || (end < len && (is_word_char(str[end]) || '.' == str[end])))
+      {
+        // decimal, float or hex number, keep it
+        while (end < len && (is_word_char(str[end]) || '.' == str[end]
+                             || (('+' == str[end] || '-' == str[end])
+                                 && ('e' == str[end - 1] || 'E' == str[end - 1]))))
+        {
+          ++end;
+        }
+      }
+      else if (in_param_clause && end - pos <= 18)
+      {
+        int64_t value = 0;
+        for (int64_t i = pos; i < end; ++i)
+        {
+          value = value * 10 + (str[i] - '0');
+        }
+        param.set_int(value);
+        is_param = true;
+      }
+    }
+    else if (is_word_char(c))
+    {
+      while (end < len && is_word_char(str[end]))
+      {
+        ++end;
+      }
+      if (first_word)
+      {
+        cachable = is_cachable_stmt(str + pos, end - pos);
+        is_insert = word_equal(str + pos, end - pos, "INSERT")
+          || word_equal(str + pos, end - pos, "REPLACE");
+        first_word = false;
+      }
+      else if (word_equal(str + pos, end - pos, "SELECT"))
+      {
+        // INSERT ... SELECT
+        is_insert = false;
+      }
+      switch (get_clause_keyword(str + pos, end - pos, is_insert && 0 == depth))
+      {
+        case PARAM_CLAUSE:
+          in_param_clause = true;
+          break;
+        case NON_PARAM_CLAUSE:
+          in_param_clause = false;
+          break;
+        default:
+          break;
+      }
+      last_word = str + pos;
+      last_word_len = end - pos;
+      keep_last_word = true;
+    }
+    else if ('?' == c || '@' == c)
+    {
+      // prepared statement or variables
+      cachable = false;
+    }
+    else if ('(' == c)
+    {
+      if (MAX_PAREN_DEPTH <= depth)
+      {
+        cachable = false;
+      }
+      else
+      {
+        clause_stack[depth++] = in_param_clause;
+      }
+    }
+    else if (')' == c)
+    {
+      if (0 < depth)
+      {
+        in_param_clause = clause_stack[--depth];
+      }
+    }
+    if (first_word && !keep_last_word)
+    {
+      // the statement does not begin with a word
+      cachable = false;
+    }
+    if (!keep_last_word)
+    {
+      last_word = NULL;
+      last_word_len = 0;
+    }
+    if (!cachable)
+    {
+      // stop
+    }
+    else if (is_param)
+    {
+      if (MAX_PARAM_COUNT <= params.count())
+      {
+        cachable = false;
+      }
+      else if (OB_SUCCESS != (ret = params.push_back(param)))
+      {
+        TBSYS_LOG(WARN, "failed to push param, err=%d", ret);
+      }
+      else
+      {
+        buf[out++] = '?';
+      }
+    }
+    else
+    {
+      memcpy(buf + out, str + pos, end - pos);
+      out += end - pos;
+    }
+    pos = end;
+  }
+  if (OB_SUCCESS == ret && cachable)
+  {
+    if (first_word)
+    {
+      cachable = false;
+    }
+    else
+    {
+      key.assign_ptr(buf, static_cast<ObString::obstr_size_t>(out));
+    }
+  }
+  return ret;
+}
+
+ObPlanCache::ObPlanCache()
+{
+}
+
+ObPlanCache::~ObPlanCache()
+{
+  CachedPlan plan;
+  while (OB_SUCCESS == pop(plan))
+  {
+    // free all
+  }
+  if (map_.created())
+  {
+    map_.destroy();
+  }
+}
+
+int ObPlanCache::get(const ObString &stmt, CachedPlan &plan)
+{
+  int ret = OB_SUCCESS;
+  Node *node = NULL;
+  if (!map_.created()
+      || hash::HASH_EXIST != map_.get(stmt, node))
+  {
+    ret = OB_ENTRY_NOT_EXIST;
+  }
+  else
+  {
+    lru_list_.move_to_last(node);
+    plan = node->plan_;
+  }
+  return ret;
+}
+
+int ObPlanCache::put(const ObString &stmt, const CachedPlan &plan, CachedPlan &evicted)
+{
+  int ret = OB_SUCCESS;
+  Node *node = NULL;
+  char *ptr = NULL;
+  evicted = CachedPlan();
+  if (!map_.created()
+      && OB_SUCCESS != (ret = map_.create(MAX_CACHED_PLAN_COUNT * 2)))
+  {
+    TBSYS_LOG(WARN, "failed to create plan cache map, err=%d", ret);
+  }
+  else if (hash::HASH_EXIST == map_.get(stmt, node))
+  {
+    ret = OB_ENTRY_EXIST;
+  }
+  else if (MAX_CACHED_PLAN_COUNT <= size()
+           && OB_SUCCESS != (ret = pop(evicted)))
+  {
+    TBSYS_LOG(WARN, "failed to evict cached plan, err=%d", ret);
+  }
+  else if (NULL == (ptr = reinterpret_cast<char*>(ob_malloc(sizeof(Node) + stmt.length(),
+                                                            ObModIds::OB_SQL_PLAN_CACHE))))
+  {
+    TBSYS_LOG(WARN, "no memory");
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else
+  {
+    node = new(ptr) Node();
+    memcpy(ptr + sizeof(Node), stmt.ptr(), stmt.length());
+    node->stmt_.assign_ptr(ptr + sizeof(Node), stmt.length());
+    node->plan_ = plan;
+    if (hash::HASH_INSERT_SUCC != map_.set(node->stmt_, node))
+    {
+      TBSYS_LOG(WARN, "failed to insert into plan cache map");
+      ret = OB_ERROR;
+      free_node(node);
+    }
+    else
+    {
+      lru_list_.add_last(node);
+    }
+  }
+  return ret;
+}
+
+int ObPlanCache::remove(const ObString &stmt, CachedPlan &plan)
+{
+  int ret = OB_SUCCESS;
+  Node *node = NULL;
+  if (!map_.created()
+      || hash::HASH_EXIST != map_.erase(stmt, &node))
+  {
+    ret = OB_ENTRY_NOT_EXIST;
+  }
+  else
+  {
+    plan = node->plan_;
+    lru_list_.remove(node);
+    free_node(node);
+  }
+  return ret;
+}
+
+int ObPlanCache::pop(CachedPlan &plan)
+{
+  int ret = OB_SUCCESS;
+  Node *node = static_cast<Node*>(lru_list_.remove_first());
+  if (NULL == node)
+  {
+    ret = OB_ENTRY_NOT_EXIST;
+  }
+  else
+  {
+    map_.erase(node->stmt_);
+    plan = node->plan_;
+    free_node(node);
+  }
+  return ret;
+}
+
+void ObPlanCache::free_node(Node *node)
+{
+  node->~Node();
+  ob_free(node, ObModIds::OB_SQL_PLAN_CACHE);
+}
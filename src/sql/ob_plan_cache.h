@@ -0,0 +1,120 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_plan_cache.h
+ *
+ * Authors:
+ *   Zhifeng YANG <zhuweng.yzf@taobao.com>
+ *
+ */
+#ifndef _OB_PLAN_CACHE_H
+#define _OB_PLAN_CACHE_H 1
+
+#include "common/ob_define.h"
+#include "common/ob_string.h"
+#include "common/ob_object.h"
+#include "common/ob_array.h"
+#include "common/dlist.h"
+#include "common/hash/ob_hashmap.h"
+
+namespace oceanbase
+{
+  namespace sql
+  {
+    // turn the constants of a text statement into question marks, so that
+    // the statements differ only in constants share one prepared plan.
+    //
+    // only SELECT/INSERT/REPLACE/UPDATE/DELETE are parameterized, and only
+    // the constants in WHERE, VALUES and SET clauses (including the
+    // subqueries in them) are replaced, the constants in the select list,
+    // GROUP BY, ORDER BY, LIMIT etc. are kept because they change the
+    // result columns or the meaning of the plan. integers become ObIntType
+    // params, strings without escapes become ObVarcharType params which
+    // point to the original statement. decimals, binaries, dates and
+    // escaped strings are kept as they are.
+    class ObSqlParameterizer
+    {
+      public:
+        static const int64_t MAX_STMT_LENGTH = 8*1024;
+        static const int64_t MAX_PARAM_COUNT = 256;
+        static const int64_t MAX_PAREN_DEPTH = 32;
+        /**
+         * @param stmt [in] the original statement
+         * @param buf [in] buffer of the parameterized statement, at least stmt.length() bytes
+         * @param key [out] the parameterized statement in buf
+         * @param params [out] the replaced constants in order
+         * @param cachable [out] false if the statement can not be parameterized
+         *
+         * @return OB_SUCCESS or other error code
+         */
+        static int parameterize(const common::ObString &stmt, char *buf, const int64_t buf_len,
+                                common::ObString &key, common::ObArray<common::ObObj> &params,
+                                bool &cachable);
+      private:
+        ObSqlParameterizer();
+    };
+
+    // LRU map from parameterized statement to the id of its prepared plan
+    // stored in the session, the schema version and privilege version are
+    // kept to find the outdated plans. a plan of OB_INVALID_ID means the
+    // parameterized statement could not be prepared, and the original
+    // statement should be executed directly.
+    class ObPlanCache
+    {
+      public:
+        struct CachedPlan
+        {
+          uint64_t stmt_id_;
+          int64_t schema_version_;
+          int64_t priv_version_;
+          CachedPlan()
+            :stmt_id_(common::OB_INVALID_ID), schema_version_(0), priv_version_(0)
+          {
+          }
+        };
+        static const int64_t MAX_CACHED_PLAN_COUNT = 32;
+      public:
+        ObPlanCache();
+        virtual ~ObPlanCache();
+        /// @retval OB_ENTRY_NOT_EXIST not cached
+        int get(const common::ObString &stmt, CachedPlan &plan);
+        /// the least recently used plan is removed and returned by evicted
+        /// if the cache is full, evicted.stmt_id_ is OB_INVALID_ID otherwise
+        int put(const common::ObString &stmt, const CachedPlan &plan, CachedPlan &evicted);
+        /// @retval OB_ENTRY_NOT_EXIST not cached
+        int remove(const common::ObString &stmt, CachedPlan &plan);
+        /// remove the least recently used plan
+        /// @retval OB_ENTRY_NOT_EXIST the cache is empty
+        int pop(CachedPlan &plan);
+        int64_t size() const;
+      private:
+        struct Node: public common::DLink
+        {
+          common::ObString stmt_;
+          CachedPlan plan_;
+        };
+        typedef common::hash::ObHashMap<common::ObString, Node*, common::hash::NoPthreadDefendMode> NodeMap;
+      private:
+        // disallow copy
+        ObPlanCache(const ObPlanCache &other);
+        ObPlanCache& operator=(const ObPlanCache &other);
+        void free_node(Node *node);
+      private:
+        NodeMap map_;
+        common::DList lru_list_;    // the most recently used one is the last
+    };
+
+    inline int64_t ObPlanCache::size() const
+    {
+      return lru_list_.get_size();
+    }
+  } // end namespace sql
+} // end namespace oceanbase
+
+#endif /* _OB_PLAN_CACHE_H */
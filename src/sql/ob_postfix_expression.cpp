@@ -253,6 +253,7 @@ namespace oceanbase
       int ret = OB_SUCCESS;
       int i = 0;
       this->expr_.clear();
+      compiler_.reset();
       if (OB_SUCCESS != (ret = str_buf_.reset()))
       {
         TBSYS_LOG(WARN, "fail to reset string buffer");
@@ -282,6 +283,11 @@ namespace oceanbase
             }
           }
         }
+        // the nodes refer to the objects of the expression, compile our copy
+        if (OB_SUCCESS == ret && other.compiler_.is_compiled())
+        {
+          compile();
+        }
       }
       return *this;
     }
@@ -327,6 +333,7 @@ namespace oceanbase
     {
       int ret = OB_SUCCESS;
       ObObj obj2;
+      compiler_.reset();
       if (obj.get_type() == ObVarcharType)
       {
         if (OB_SUCCESS != (ret = str_buf_.write_obj(obj, &obj2)))
@@ -351,6 +358,7 @@ namespace oceanbase
       ObObj item_type;
       ObObj obj, obj2;
       ObSqlSysFunc sys_func;
+      compiler_.reset();
       switch(item.type_)
       {
         case T_STRING:
@@ -520,13 +528,40 @@ namespace oceanbase
       int ret = OB_SUCCESS;
       ObObj obj;
       obj.set_int(END);
+      compiler_.reset();
       if (OB_SUCCESS != (ret = expr_.push_back(obj)))
       {
         TBSYS_LOG(WARN, "failed to add END, err=%d", ret);
       }
+      else
+      {
+        compile();
+      }
       return ret;
     }
 
+    void ObPostfixExpression::compile()
+    {
+      int ret = OB_SUCCESS;
+      // the params are only used to fold the constants
+      ObPostExprExtraParams *extra_params = GET_TSI_MULT(ObPostExprExtraParams, TSI_SQL_EXPR_EXTRA_PARAMS_1);
+      compiler_.reset();
+      if (NULL == extra_params)
+      {
+        TBSYS_LOG(WARN, "no memory for postfix expression extra params, interpret the expression");
+      }
+      else
+      {
+        extra_params->did_int_div_as_double_ = did_int_div_as_double_;
+        extra_params->str_buf_ = &str_buf_;
+        if (OB_SUCCESS != (ret = compiler_.compile(*this, *extra_params)))
+        {
+          // not supported or failed, interpret the expression
+          TBSYS_LOG(DEBUG, "expression is not compiled, err=%d", ret);
+        }
+      }
+    }
+
     int ObPostfixExpression::merge_expr(const ObPostfixExpression &expr1, const ObPostfixExpression &expr2, const ExprItem &op)
     {
       int ret = OB_SUCCESS;
@@ -558,13 +593,7 @@ namespace oceanbase
     int ObPostfixExpression::calc(const common::ObRow &row, const ObObj *&composite_val)
     {
       int ret = OB_SUCCESS;
-      int64_t type = 0;
-      int64_t value = 0;
-      int64_t value2 = 0;
-      int64_t sys_func = 0;
-      int idx = 0;
       ObExprObj result;
-      int idx_i = 0;
       ObPostExprExtraParams *extra_params = GET_TSI_MULT(ObPostExprExtraParams, TSI_SQL_EXPR_EXTRA_PARAMS_1);
       // get the stack for calculation
       ObPostfixExpressionCalcStack *stack = GET_TSI_MULT(ObPostfixExpressionCalcStack, TSI_SQL_EXPR_STACK_1);
@@ -577,8 +606,39 @@ namespace oceanbase
       {
         stack_ = stack->stack_;
         extra_params->did_int_div_as_double_ = did_int_div_as_double_;
+        extra_params->str_buf_ = &str_buf_;
+        if (!compiler_.is_compiled())
+        {
+          ret = interpret(row, *extra_params, composite_val);
+        }
+        else if (OB_SUCCESS != (ret = compiler_.calc(row, *extra_params, result)))
+        {
+          TBSYS_LOG(WARN, "failed to calc compiled expression, err=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = result.to(result_)))
+        {
+          TBSYS_LOG(WARN, "failed to convert exprobj to obj, err=%d", ret);
+        }
+        else
+        {
+          composite_val = &result_;
+        }
       }
+      return ret;
+    }
 
+    int ObPostfixExpression::interpret(const common::ObRow &row, ObPostExprExtraParams &params,
+                                       const ObObj *&composite_val)
+    {
+      int ret = OB_SUCCESS;
+      int64_t type = 0;
+      int64_t value = 0;
+      int64_t value2 = 0;
+      int64_t sys_func = 0;
+      int idx = 0;
+      ObExprObj result;
+      int idx_i = 0;
+      ObPostExprExtraParams *extra_params = &params;
       while (OB_SUCCESS == ret)
       {
         // 获得数据类型:列id、数字、操作符、结束标记
@@ -1354,6 +1414,10 @@ namespace oceanbase
           }
         }
       }
+      if (OB_SUCCESS == ret)
+      {
+        compile();
+      }
       return ret;
     }
 
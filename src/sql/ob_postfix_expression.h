@@ -29,6 +29,7 @@
 #include "common/ob_row.h"
 #include "common/ob_expr_obj.h"
 #include "common/ob_se_array.h"
+#include "ob_expr_compiler.h"
 using namespace oceanbase::common;
 
 namespace oceanbase
@@ -298,6 +299,7 @@ namespace oceanbase
 
     class ObPostfixExpression
     {
+      friend class ObExprCompiler;
       public:
         ObPostfixExpression();
         ~ObPostfixExpression();
@@ -313,6 +315,8 @@ namespace oceanbase
 
         /* 将row中的值代入到expr计算结果 */
         int calc(const common::ObRow &row, const ObObj *&result);
+        /// the expression is compiled when it is finished, by add_expr_item_end(), deserialize() or assignment
+        bool is_compiled() const;
 
         /*
          * 判断表达式类型：是否是const, column_index, etc
@@ -356,6 +360,8 @@ namespace oceanbase
         };
       private:
         ObPostfixExpression(const ObPostfixExpression &other);
+        int interpret(const common::ObRow &row, ObPostExprExtraParams &params, const ObObj *&result);
+        void compile();
         static inline int nop_func(ObExprObj *stack_i, int &idx_i, ObExprObj &result, const ObPostExprExtraParams &params);
         static inline int reserved_func(const ObExprObj &obj1, const ObExprObj &obj2, ObExprObj &result);
         /* compare function list:
@@ -437,11 +443,25 @@ namespace oceanbase
         bool did_int_div_as_double_;
         ObObj result_;
         ObStringBuf str_buf_;
+        ObExprCompiler compiler_;
     }; // class ObPostfixExpression
 
     inline void ObPostfixExpression::set_int_div_as_double(bool did)
     {
-      did_int_div_as_double_ = did;
+      if (did != did_int_div_as_double_)
+      {
+        did_int_div_as_double_ = did;
+        // the folded constants may change
+        if (compiler_.is_compiled())
+        {
+          compile();
+        }
+      }
+    }
+
+    inline bool ObPostfixExpression::is_compiled() const
+    {
+      return compiler_.is_compiled();
     }
 
     inline bool ObPostfixExpression::is_empty() const
@@ -457,6 +477,7 @@ namespace oceanbase
     {
       str_buf_.reset();
       expr_.clear();
+      compiler_.reset();
     }
 
   } // namespace commom
@@ -21,7 +21,7 @@ using namespace oceanbase::common;
 
 ObProject::ObProject()
   :columns_(common::OB_MALLOC_BLOCK_SIZE, ModulePageAllocator(ObModIds::OB_SQL_ARRAY)),
-   rowkey_cell_count_(0)
+   rowkey_cell_count_(0), child_batch_pos_(0)
 {
 }
 
@@ -97,12 +97,21 @@ int ObProject::open()
   else
   {
     row_.set_row_desc(row_desc_);
+    child_batch_pos_ = 0;
+    if (child_op_->is_batch_native()
+        && OB_SUCCESS != (ret = batch_reader_.open(*this)))
+    {
+      TBSYS_LOG(WARN, "failed to open batch reader, err=%d", ret);
+    }
   }
   return ret;
 }
 
 int ObProject::close()
 {
+  batch_reader_.close();
+  child_batch_.destroy();
+  child_batch_pos_ = 0;
   row_desc_.reset();
   return ObSingleChildPhyOperator::close();
 }
@@ -131,6 +140,10 @@ int ObProject::get_next_row(const common::ObRow *&row)
     ret = OB_NOT_INIT;
     TBSYS_LOG(ERROR, "child_op_ is NULL");
   }
+  else if (batch_reader_.is_opened())
+  {
+    ret = batch_reader_.get_next_row(row);
+  }
   else if (OB_SUCCESS != (ret = child_op_->get_next_row(input_row)))
   {
     if (OB_ITER_END != ret)
@@ -165,6 +178,87 @@ int ObProject::get_next_row(const common::ObRow *&row)
   return ret;
 }
 
+int ObProject::get_next_batch(ObRowBatch &batch)
+{
+  int ret = OB_SUCCESS;
+  const ObRowDesc *child_row_desc = NULL;
+  if (NULL == child_op_)
+  {
+    ret = OB_NOT_INIT;
+    TBSYS_LOG(ERROR, "child_op_ is NULL");
+  }
+  else if (NULL == child_batch_.get_row_desc())
+  {
+    // the first call after open()
+    if (OB_SUCCESS != (ret = child_op_->get_row_desc(child_row_desc)))
+    {
+      TBSYS_LOG(WARN, "failed to get child row desc, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = child_batch_.init(*child_row_desc)))
+    {
+      TBSYS_LOG(WARN, "failed to init child batch, err=%d", ret);
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    const ObObj *result = NULL;
+    int64_t row_idx = 0;
+    batch.reuse();
+    while (OB_SUCCESS == ret && !batch.is_full())
+    {
+      if (child_batch_pos_ >= child_batch_.get_row_count())
+      {
+        if (0 < batch.get_row_count())
+        {
+          // return the rows at hand instead of waiting for the next child batch
+          break;
+        }
+        else if (OB_SUCCESS != (ret = child_op_->get_next_batch(child_batch_)))
+        {
+          if (OB_ITER_END != ret)
+          {
+            TBSYS_LOG(WARN, "failed to get next batch, err=%d", ret);
+          }
+          break;
+        }
+        else
+        {
+          child_batch_pos_ = 0;
+        }
+      }
+      if (OB_SUCCESS != (ret = child_batch_.get_row(child_batch_pos_++, input_row_)))
+      {
+        TBSYS_LOG(WARN, "failed to get row from child batch, err=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = batch.alloc_row(row_idx)))
+      {
+        TBSYS_LOG(WARN, "failed to alloc row, err=%d", ret);
+      }
+      else
+      {
+        for (int32_t i = 0; i < columns_.count(); ++i)
+        {
+          if (OB_SUCCESS != (ret = columns_.at(i).calc(input_row_, result)))
+          {
+            TBSYS_LOG(WARN, "failed to calculate, err=%d", ret);
+            break;
+          }
+          else
+          {
+            batch.set_cell(row_idx, i, *result);
+          }
+        } // end for
+      }
+    } // end while
+  }
+  return ret;
+}
+
+bool ObProject::is_batch_native() const
+{
+  return NULL != child_op_ && child_op_->is_batch_native();
+}
+
 int64_t ObProject::to_string(char* buf, const int64_t buf_len) const
 {
   int64_t pos = 0;
@@ -17,6 +17,7 @@
 #define _OB_PROJECT_H 1
 #include "ob_single_child_phy_operator.h"
 #include "ob_sql_expression.h"
+#include "ob_row_batch.h"
 #include "common/ob_array.h"
 
 namespace oceanbase
@@ -38,6 +39,9 @@ namespace oceanbase
         virtual int open();
         virtual int close();
         virtual int get_next_row(const common::ObRow *&row);
+        /// the output cells are shallow copies of the results of the expressions
+        virtual int get_next_batch(ObRowBatch &batch);
+        virtual bool is_batch_native() const;
         virtual int get_row_desc(const common::ObRowDesc *&row_desc) const;
         virtual int64_t to_string(char* buf, const int64_t buf_len) const;
         void assign(const ObProject &other);
@@ -56,6 +60,10 @@ namespace oceanbase
         common::ObRowDesc row_desc_;
         common::ObRow row_;
         int64_t rowkey_cell_count_;
+        ObRowBatch child_batch_;
+        int64_t child_batch_pos_;
+        common::ObRow input_row_;
+        ObRowBatchReader batch_reader_; // used if the child is batch native
     };
 
     inline int64_t ObProject::get_output_column_size() const
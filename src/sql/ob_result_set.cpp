@@ -112,7 +112,7 @@ void ObResultSet::set_statement_name(const common::ObString name)
   statement_name_ = name;
 }
 
-int ObResultSet::pre_assign_params_room(const int64_t& size, common::StackAllocator &alloc)
+int ObResultSet::pre_assign_params_room(const int64_t& size, common::ObIAllocator &alloc)
 {
   int ret = OB_SUCCESS;
   ObObj *place_holder = NULL;
@@ -0,0 +1,314 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_row_batch.cpp
+ *
+ * Authors:
+ *   Zhifeng YANG <zhuweng.yzf@taobao.com>
+ *
+ */
+#include "ob_row_batch.h"
+#include "common/ob_malloc.h"
+#include "common/ob_compact_cell_iterator.h"
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+ObRowBatch::ObRowBatch()
+  :row_desc_(NULL), column_num_(0), capacity_(0), row_count_(0), selected_count_(0),
+   buf_size_(0), buf_(NULL), cells_(NULL), selection_(NULL), is_end_(false),
+   arena_(ModuleArena::DEFAULT_PAGE_SIZE, ModulePageAllocator(ObModIds::OB_SQL_ROW_BATCH))
+{
+}
+
+ObRowBatch::~ObRowBatch()
+{
+  destroy();
+}
+
+int ObRowBatch::init(const ObRowDesc &row_desc, const int64_t capacity)
+{
+  int ret = OB_SUCCESS;
+  const int64_t column_num = row_desc.get_column_num();
+  const int64_t buf_size = capacity * static_cast<int64_t>(sizeof(int64_t))
+    + column_num * capacity * static_cast<int64_t>(sizeof(ObObj));
+  if (0 >= column_num || 0 >= capacity)
+  {
+    ret = OB_INVALID_ARGUMENT;
+    TBSYS_LOG(WARN, "invalid argument, column_num=%ld capacity=%ld", column_num, capacity);
+  }
+  else if (buf_size > buf_size_)
+  {
+    if (NULL != buf_)
+    {
+      ob_free(buf_, ObModIds::OB_SQL_ROW_BATCH);
+      buf_ = NULL;
+      buf_size_ = 0;
+    }
+    if (NULL == (buf_ = reinterpret_cast<char*>(ob_malloc(buf_size, ObModIds::OB_SQL_ROW_BATCH))))
+    {
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+      TBSYS_LOG(ERROR, "no memory, size=%ld", buf_size);
+    }
+    else
+    {
+      buf_size_ = buf_size;
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    row_desc_ = &row_desc;
+    column_num_ = column_num;
+    capacity_ = capacity;
+    selection_ = reinterpret_cast<int64_t*>(buf_);
+    cells_ = reinterpret_cast<ObObj*>(buf_ + capacity * sizeof(int64_t));
+    reset();
+  }
+  return ret;
+}
+
+void ObRowBatch::destroy()
+{
+  if (NULL != buf_)
+  {
+    ob_free(buf_, ObModIds::OB_SQL_ROW_BATCH);
+    buf_ = NULL;
+  }
+  arena_.free();
+  row_desc_ = NULL;
+  column_num_ = capacity_ = row_count_ = selected_count_ = buf_size_ = 0;
+  cells_ = NULL;
+  selection_ = NULL;
+  is_end_ = false;
+}
+
+void ObRowBatch::reset()
+{
+  reuse();
+  is_end_ = false;
+}
+
+void ObRowBatch::reuse()
+{
+  row_count_ = 0;
+  selected_count_ = 0;
+  arena_.reuse();
+}
+
+int ObRowBatch::alloc_row(int64_t &row_idx)
+{
+  int ret = OB_SUCCESS;
+  if (OB_UNLIKELY(NULL == buf_))
+  {
+    ret = OB_NOT_INIT;
+    TBSYS_LOG(ERROR, "row batch not init");
+  }
+  else if (OB_UNLIKELY(row_count_ >= capacity_))
+  {
+    ret = OB_SIZE_OVERFLOW;
+    TBSYS_LOG(WARN, "row batch is full, capacity=%ld", capacity_);
+  }
+  else
+  {
+    row_idx = row_count_++;
+    selection_[selected_count_++] = row_idx;
+  }
+  return ret;
+}
+
+int ObRowBatch::add_row(const ObRow &row)
+{
+  int ret = OB_SUCCESS;
+  int64_t row_idx = 0;
+  const ObObj *cell = NULL;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  if (OB_UNLIKELY(row.get_column_num() != column_num_))
+  {
+    ret = OB_ERR_UNEXPECTED;
+    TBSYS_LOG(WARN, "column num not match, row=%ld batch=%ld", row.get_column_num(), column_num_);
+  }
+  else if (OB_SUCCESS != (ret = alloc_row(row_idx)))
+  {
+    TBSYS_LOG(WARN, "failed to alloc row, err=%d", ret);
+  }
+  else
+  {
+    for (int64_t i = 0; i < column_num_; ++i)
+    {
+      if (OB_SUCCESS != (ret = row.raw_get_cell(i, cell, tid, cid)))
+      {
+        TBSYS_LOG(WARN, "failed to get cell, err=%d idx=%ld", ret, i);
+        break;
+      }
+      else if (OB_SUCCESS != (ret = ob_write_obj(arena_, *cell, cells_[i * capacity_ + row_idx])))
+      {
+        TBSYS_LOG(WARN, "failed to copy cell, err=%d", ret);
+        break;
+      }
+    }
+    if (OB_SUCCESS != ret)
+    {
+      --row_count_;
+      --selected_count_;
+    }
+  }
+  return ret;
+}
+
+int ObRowBatch::add_compact_row(const ObString &compact_row)
+{
+  int ret = OB_SUCCESS;
+  int64_t row_idx = 0;
+  int64_t cell_idx = 0;
+  uint64_t column_id = OB_INVALID_ID;
+  const ObObj *cell = NULL;
+  bool is_row_finished = false;
+  ObCompactCellIterator cell_reader;
+  if (OB_SUCCESS != (ret = cell_reader.init(compact_row, SPARSE)))
+  {
+    TBSYS_LOG(WARN, "failed to init cell reader, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = alloc_row(row_idx)))
+  {
+    TBSYS_LOG(WARN, "failed to alloc row, err=%d", ret);
+  }
+  else
+  {
+    while (OB_SUCCESS == (ret = cell_reader.next_cell()))
+    {
+      if (OB_SUCCESS != (ret = cell_reader.get_cell(column_id, cell, &is_row_finished)))
+      {
+        TBSYS_LOG(WARN, "failed to get cell, err=%d", ret);
+        break;
+      }
+      else if (is_row_finished)
+      {
+        break;
+      }
+      else if (OB_UNLIKELY(cell_idx >= column_num_))
+      {
+        ret = OB_SIZE_OVERFLOW;
+        TBSYS_LOG(WARN, "too many cells in compact row, column_num=%ld", column_num_);
+        break;
+      }
+      else
+      {
+        set_cell(row_idx, cell_idx++, *cell);
+      }
+    }
+    for (; OB_SUCCESS == ret && cell_idx < column_num_; ++cell_idx)
+    {
+      // the cells of the last row in this slot may be left over
+      cells_[cell_idx * capacity_ + row_idx].set_null();
+    }
+    if (OB_SUCCESS != ret)
+    {
+      --row_count_;
+      --selected_count_;
+    }
+  }
+  return ret;
+}
+
+int ObRowBatch::get_row(const int64_t idx, ObRow &row) const
+{
+  int ret = OB_SUCCESS;
+  if (OB_UNLIKELY(0 > idx || idx >= selected_count_))
+  {
+    ret = OB_INVALID_ARGUMENT;
+    TBSYS_LOG(WARN, "invalid row idx=%ld count=%ld", idx, selected_count_);
+  }
+  else
+  {
+    const ObObj *cell = cells_ + selection_[idx];
+    row.set_row_desc(*row_desc_);
+    for (int64_t i = 0; i < column_num_; ++i, cell += capacity_)
+    {
+      if (OB_SUCCESS != (ret = row.raw_set_cell(i, *cell)))
+      {
+        TBSYS_LOG(WARN, "failed to set cell, err=%d idx=%ld", ret, i);
+        break;
+      }
+    }
+  }
+  return ret;
+}
+
+ObRowBatchReader::ObRowBatchReader()
+  :op_(NULL), pos_(0)
+{
+}
+
+ObRowBatchReader::~ObRowBatchReader()
+{
+}
+
+int ObRowBatchReader::open(ObPhyOperator &op, const int64_t capacity)
+{
+  int ret = OB_SUCCESS;
+  const ObRowDesc *row_desc = NULL;
+  if (OB_SUCCESS != (ret = op.get_row_desc(row_desc)))
+  {
+    TBSYS_LOG(WARN, "failed to get row desc, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = batch_.init(*row_desc, capacity)))
+  {
+    TBSYS_LOG(WARN, "failed to init row batch, err=%d", ret);
+  }
+  else
+  {
+    op_ = &op;
+    pos_ = 0;
+  }
+  return ret;
+}
+
+void ObRowBatchReader::close()
+{
+  op_ = NULL;
+  pos_ = 0;
+  batch_.destroy();
+}
+
+int ObRowBatchReader::get_next_row(const ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  if (OB_UNLIKELY(NULL == op_))
+  {
+    ret = OB_NOT_INIT;
+    TBSYS_LOG(ERROR, "row batch reader not opened");
+  }
+  else if (pos_ >= batch_.get_row_count())
+  {
+    if (OB_SUCCESS != (ret = op_->get_next_batch(batch_)))
+    {
+      if (OB_ITER_END != ret)
+      {
+        TBSYS_LOG(WARN, "failed to get next batch, err=%d", ret);
+      }
+    }
+    else
+    {
+      pos_ = 0;
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    if (OB_SUCCESS != (ret = batch_.get_row(pos_, row_)))
+    {
+      TBSYS_LOG(WARN, "failed to get row from batch, err=%d", ret);
+    }
+    else
+    {
+      ++pos_;
+      row = &row_;
+    }
+  }
+  return ret;
+}
@@ -0,0 +1,181 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_row_batch.h
+ *
+ * Authors:
+ *   Zhifeng YANG <zhuweng.yzf@taobao.com>
+ *
+ */
+#ifndef _OB_ROW_BATCH_H
+#define _OB_ROW_BATCH_H 1
+#include "ob_phy_operator.h"
+#include "common/ob_row.h"
+#include "common/page_arena.h"
+
+namespace oceanbase
+{
+  namespace sql
+  {
+    // a batch of rows of the same row desc, used by ObPhyOperator::get_next_batch
+    //
+    // the cells are stored column by column, the cells of column i are
+    // cells_[i*capacity_, i*capacity_+row_count_). the selection vector
+    // holds the physical indexes of the rows which are still alive, so that
+    // filter and limit only need to update the selection instead of moving
+    // the cells. get_row_count() and get_row() work on the selected rows.
+    class ObRowBatch
+    {
+      public:
+        static const int64_t DEFAULT_BATCH_SIZE = 256;
+      public:
+        ObRowBatch();
+        virtual ~ObRowBatch();
+        /// the memory is allocated only if the old one is not big enough
+        int init(const common::ObRowDesc &row_desc, const int64_t capacity = DEFAULT_BATCH_SIZE);
+        void destroy();
+        /// remove all the rows and clear the end flag, call it before a new scan
+        void reset();
+        /// remove all the rows, the end flag is kept
+        void reuse();
+
+        /// append a row and select it, varchar cells are deep copied
+        int add_row(const common::ObRow &row);
+        /// append a row and select it, the cells should be set by set_cell()
+        int alloc_row(int64_t &row_idx);
+        /**
+         * decode a row of common::ObRowStore format into the column vectors and select it
+         * @note varchar cells point into compact_row, it should be valid until the batch is reused
+         */
+        int add_compact_row(const common::ObString &compact_row);
+        /// shallow copy the cell into the row of physical index row_idx
+        void set_cell(const int64_t row_idx, const int64_t col_idx, const common::ObObj &cell);
+        /**
+         * get the idx-th selected row
+         * @note the cells are shallow copied, row is valid until the batch is reused
+         */
+        int get_row(const int64_t idx, common::ObRow &row) const;
+
+        /// cell vector of the column, indexed by physical row index
+        const common::ObObj *get_column(const int64_t col_idx) const;
+        /// physical row indexes of the selected rows
+        int64_t *get_selection();
+        /// keep the first count selected rows, count should not be more than get_row_count()
+        void set_row_count(const int64_t count);
+        /// count of the selected rows
+        int64_t get_row_count() const;
+        int64_t get_capacity() const;
+        bool is_full() const;
+        const common::ObRowDesc *get_row_desc() const;
+
+        /// the producer has no more rows after this batch
+        bool is_end() const;
+        void set_end();
+      private:
+        // disallow copy
+        ObRowBatch(const ObRowBatch &other);
+        ObRowBatch& operator=(const ObRowBatch &other);
+      private:
+        // data members
+        const common::ObRowDesc *row_desc_;
+        int64_t column_num_;
+        int64_t capacity_;
+        int64_t row_count_;       // physical row count
+        int64_t selected_count_;
+        int64_t buf_size_;
+        char *buf_;
+        common::ObObj *cells_;
+        int64_t *selection_;
+        bool is_end_;
+        common::ModuleArena arena_; // varchars of add_row()
+    };
+
+    inline void ObRowBatch::set_cell(const int64_t row_idx, const int64_t col_idx, const common::ObObj &cell)
+    {
+      cells_[col_idx * capacity_ + row_idx] = cell;
+    }
+
+    inline const common::ObObj *ObRowBatch::get_column(const int64_t col_idx) const
+    {
+      return cells_ + col_idx * capacity_;
+    }
+
+    inline int64_t *ObRowBatch::get_selection()
+    {
+      return selection_;
+    }
+
+    inline void ObRowBatch::set_row_count(const int64_t count)
+    {
+      selected_count_ = count;
+    }
+
+    inline int64_t ObRowBatch::get_row_count() const
+    {
+      return selected_count_;
+    }
+
+    inline int64_t ObRowBatch::get_capacity() const
+    {
+      return capacity_;
+    }
+
+    inline bool ObRowBatch::is_full() const
+    {
+      return row_count_ >= capacity_;
+    }
+
+    inline const common::ObRowDesc *ObRowBatch::get_row_desc() const
+    {
+      return row_desc_;
+    }
+
+    inline bool ObRowBatch::is_end() const
+    {
+      return is_end_;
+    }
+
+    inline void ObRowBatch::set_end()
+    {
+      is_end_ = true;
+    }
+
+    // batch to row adapter, returns the selected rows of the batches got
+    // from the operator one by one
+    class ObRowBatchReader
+    {
+      public:
+        ObRowBatchReader();
+        virtual ~ObRowBatchReader();
+        /// @pre op has been opened
+        int open(ObPhyOperator &op, const int64_t capacity = ObRowBatch::DEFAULT_BATCH_SIZE);
+        void close();
+        bool is_opened() const;
+        /// @note the row is valid until the next call
+        int get_next_row(const common::ObRow *&row);
+      private:
+        // disallow copy
+        ObRowBatchReader(const ObRowBatchReader &other);
+        ObRowBatchReader& operator=(const ObRowBatchReader &other);
+      private:
+        // data members
+        ObPhyOperator *op_;
+        ObRowBatch batch_;
+        common::ObRow row_;
+        int64_t pos_;
+    };
+
+    inline bool ObRowBatchReader::is_opened() const
+    {
+      return NULL != op_;
+    }
+  } // end namespace sql
+} // end namespace oceanbase
+
+#endif /* _OB_ROW_BATCH_H */
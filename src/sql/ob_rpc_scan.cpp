@@ -22,6 +22,7 @@
 #include "mergeserver/ob_merge_server_main.h"
 #include "mergeserver/ob_ms_sql_get_request.h"
 #include "ob_sql_read_strategy.h"
+#include "ob_row_batch.h"
 #include "common/ob_profile_type.h"
 #include "common/ob_profile_log.h"
 using namespace oceanbase;
@@ -566,6 +567,68 @@ int ObRpcScan::get_next_compact_row(const common::ObRow *&row)
   return ret;
 }
 
+int ObRpcScan::get_next_batch(ObRowBatch &batch)
+{
+  int ret = OB_SUCCESS;
+  bool can_break = false;
+  int64_t remain_us = 0;
+  if (ObSqlReadStrategy::USE_SCAN != hint_.read_method_)
+  {
+    ret = ObPhyOperator::get_next_batch(batch);
+  }
+  else if (batch.is_end())
+  {
+    ret = OB_ITER_END;
+  }
+  else
+  {
+    batch.reuse();
+    do
+    {
+      if (OB_UNLIKELY(my_phy_plan_->is_timeout(&remain_us)))
+      {
+        can_break = true;
+        ret = OB_PROCESS_TIMEOUT;
+      }
+      else if (OB_LIKELY(OB_SUCCESS == (ret = sql_scan_request_.get_next_batch(batch))))
+      {
+        // got rows without block
+        can_break = true;
+      }
+      else if (OB_ITER_END == ret && sql_scan_request_.is_finish())
+      {
+        // finish all data
+        batch.set_end();
+        can_break = true;
+      }
+      else if (OB_ITER_END == ret)
+      {
+        // need to wait for incomming data
+        can_break = false;
+        timeout_us_ = std::min(timeout_us_, remain_us);
+        if( OB_SUCCESS != (ret = sql_scan_request_.wait_single_event(timeout_us_)))
+        {
+          if (timeout_us_ <= 0)
+          {
+            TBSYS_LOG(WARN, "wait timeout. timeout_us_=%ld", timeout_us_);
+          }
+          can_break = true;
+        }
+      }
+      else
+      {
+        TBSYS_LOG(WARN, "Unexprected error. ret=%d, cur_row_desc[%s], read_method_[%d]", ret, to_cstring(cur_row_desc_), hint_.read_method_);
+        can_break = true;
+      }
+    }while(false == can_break);
+  }
+  return ret;
+}
+
+bool ObRpcScan::is_batch_native() const
+{
+  return ObSqlReadStrategy::USE_SCAN == hint_.read_method_;
+}
 
 int ObRpcScan::add_output_column(const ObSqlExpression& expr)
 {
@@ -54,6 +54,9 @@ namespace oceanbase
         virtual int open();
         virtual int close();
         virtual int get_next_row(const common::ObRow *&row);
+        /// scan方式下直接把CS返回的行解码到batch的列里, get方式下逐行填充
+        virtual int get_next_batch(ObRowBatch &batch);
+        virtual bool is_batch_native() const;
         virtual int get_row_desc(const common::ObRowDesc *&row_desc) const;
         /**
          * 添加一个需输出的column
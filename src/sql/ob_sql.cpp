@@ -41,6 +41,8 @@
 #include "sql/ob_set_password_stmt.h"
 #include "sql/ob_rename_user_stmt.h"
 #include "sql/ob_show_stmt.h"
+#include "sql/ob_plan_cache.h"
+#include "common/ob_common_stat.h"
 using namespace oceanbase::common;
 using namespace oceanbase::sql;
 
@@ -99,6 +101,14 @@ int ObSql::direct_execute(const common::ObString &stmt, ObResultSet &result, ObS
       TBSYS_LOG(TRACE, "execute special sql statement success [%.*s]", stmt.length(), stmt.ptr());
     }
   }
+  else if (true == plan_cache_hook(stmt, result, context))
+  {
+    if (OB_UNLIKELY(TBSYS_LOGGER._level >= TBSYS_LOG_LEVEL_TRACE))
+    {
+      TBSYS_LOG(TRACE, "execute with cached plan, stmt_id=%lu [%.*s]",
+                result.get_statement_id(), stmt.length(), stmt.ptr());
+    }
+  }
   else
   {
     ResultPlan result_plan;
@@ -130,7 +140,13 @@ int ObSql::direct_execute(const common::ObString &stmt, ObResultSet &result, ObS
         ObBasicStmt::StmtType stmt_type = logic_plan->get_main_stmt()->get_stmt_type();
         result.set_stmt_type(stmt_type);
         result.set_inner_stmt_type(stmt_type);
-        if (OB_SUCCESS != (ret = logic_plan->fill_result_set(result, context.session_info_, context.session_info_->get_transformer_mem_pool())))
+        // the fields and params of a prepared statement live as long as its plan
+        ObIAllocator *allocator = &context.session_info_->get_transformer_mem_pool();
+        if (context.is_prepare_protocol_ && NULL != context.transformer_allocator_)
+        {
+          allocator = context.transformer_allocator_;
+        }
+        if (OB_SUCCESS != (ret = logic_plan->fill_result_set(result, context.session_info_, *allocator)))
         {
           TBSYS_LOG(WARN, "fill result set failed,ret=%d", ret);
         }
@@ -399,6 +415,153 @@ int ObSql::stmt_close(const uint64_t stmt_id, ObSqlContext &context)
   return ret;
 }
 
+bool ObSql::plan_cache_hook(const common::ObString &stmt, ObResultSet &result, ObSqlContext &context)
+{
+  bool hooked = false;
+  int ret = OB_SUCCESS;
+  ObSQLSessionInfo *session = context.session_info_;
+  char *buf = NULL;
+  bool cachable = false;
+  ObString key;
+  ObArray<ObObj> params;
+  ObArray<obmysql::EMySQLFieldType> params_type; // not bound
+  ObPlanCache::CachedPlan plan;
+  ObResultSet *stored_result = NULL;
+  // only the statements from the client are cached, the internal ones and
+  // the ones being prepared are executed directly
+  if (context.is_prepare_protocol_
+      || context.disable_privilege_check_
+      || NULL == session
+      || &result != session->get_current_result_set()
+      || NULL == context.schema_manager_
+      || NULL == context.pp_privilege_
+      || NULL == *context.pp_privilege_
+      || 0 >= stmt.length()
+      || ObSqlParameterizer::MAX_STMT_LENGTH < stmt.length()
+      || !session->is_plan_cache_enabled())
+  {
+    // execute directly
+  }
+  else if (NULL == (buf = reinterpret_cast<char*>(parse_malloc(static_cast<size_t>(stmt.length()), &session->get_parser_mem_pool()))))
+  {
+    TBSYS_LOG(WARN, "no memory");
+  }
+  else if (OB_SUCCESS != (ret = ObSqlParameterizer::parameterize(stmt, buf, stmt.length(), key, params, cachable))
+           || !cachable)
+  {
+    // execute directly
+  }
+  else
+  {
+    const int64_t schema_version = context.schema_manager_->get_version();
+    const int64_t priv_version = (*context.pp_privilege_)->get_version();
+    ret = session->get_plan_cache().get(key, plan);
+    if (OB_SUCCESS == ret
+        && (plan.schema_version_ != schema_version
+            || plan.priv_version_ != priv_version
+            || (OB_INVALID_ID != plan.stmt_id_ && NULL == session->get_plan(plan.stmt_id_))))
+    {
+      // outdated
+      session->remove_cached_plan(key);
+      ret = OB_ENTRY_NOT_EXIST;
+    }
+    if (OB_ENTRY_NOT_EXIST == ret)
+    {
+      OB_STAT_INC(SQL, SQL_PLAN_CACHE_MISS_COUNT);
+      plan.schema_version_ = schema_version;
+      plan.priv_version_ = priv_version;
+      if (OB_SUCCESS != prepare_cached_plan(key, context, plan.stmt_id_))
+      {
+        // remember it and execute the statement directly
+        plan.stmt_id_ = OB_INVALID_ID;
+      }
+      if (OB_SUCCESS != (ret = session->add_cached_plan(key, plan))
+          && OB_INVALID_ID != plan.stmt_id_)
+      {
+        session->remove_plan(plan.stmt_id_);
+      }
+    }
+    else if (OB_SUCCESS == ret && OB_INVALID_ID != plan.stmt_id_)
+    {
+      OB_STAT_INC(SQL, SQL_PLAN_CACHE_HIT_COUNT);
+    }
+    if (OB_SUCCESS != ret || OB_INVALID_ID == plan.stmt_id_)
+    {
+      // execute directly
+    }
+    else if (NULL == (stored_result = session->get_plan(plan.stmt_id_)))
+    {
+      TBSYS_LOG(WARN, "cached plan not found, stmt_id=%lu", plan.stmt_id_);
+    }
+    // set the constants of this statement
+    else if (OB_SUCCESS != (ret = stored_result->fill_params(params_type, params)))
+    {
+      TBSYS_LOG(WARN, "failed to fill params of the cached plan, err=%d stmt_id=%lu", ret, plan.stmt_id_);
+    }
+    else if (OB_SUCCESS != (ret = result.from_prepared(*stored_result)))
+    {
+      TBSYS_LOG(WARN, "failed to fill result set, err=%d", ret);
+    }
+    else
+    {
+      result.set_stmt_type(stored_result->get_stmt_type());
+      hooked = true;
+    }
+  }
+  return hooked;
+}
+
+int ObSql::prepare_cached_plan(const common::ObString &key, ObSqlContext &context, uint64_t &stmt_id)
+{
+  int ret = OB_SUCCESS;
+  ObSQLSessionInfo *session = context.session_info_;
+  ObResultSet *outer_result = session->get_current_result_set();
+  ObIAllocator *outer_allocator = context.transformer_allocator_;
+  ObArenaAllocator *allocator = NULL;
+  ObResultSet result;
+  stmt_id = OB_INVALID_ID;
+  if (NULL == (allocator = session->get_transformer_mem_pool_for_ps()))
+  {
+    TBSYS_LOG(WARN, "failed to get new allocator");
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else
+  {
+    // prepare it the same way as stmt_prepare(), the question marks are
+    // bound to the params of the result set being prepared
+    session->set_current_result_set(&result);
+    context.is_prepare_protocol_ = true;
+    context.transformer_allocator_ = allocator;
+    result.set_ps_transformer_allocator(allocator);
+    if (OB_SUCCESS != (ret = direct_execute(key, result, context)))
+    {
+      TBSYS_LOG(DEBUG, "failed to prepare parameterized stmt, err=%d stmt=%.*s",
+                ret, key.length(), key.ptr());
+    }
+    else if (OB_SUCCESS != (ret = session->store_plan(ObString(), result)))
+    {
+      TBSYS_LOG(WARN, "failed to store plan, err=%d", ret);
+    }
+    else
+    {
+      stmt_id = result.get_statement_id();
+    }
+    context.is_prepare_protocol_ = false;
+    context.transformer_allocator_ = outer_allocator;
+    session->set_current_result_set(outer_result);
+  }
+  if (OB_SUCCESS != ret)
+  {
+    // the original statement will be executed, drop the errors of the parameterized one
+    tbsys::WarningBuffer *warning_buffer = tbsys::get_tsi_warning_buffer();
+    if (NULL != warning_buffer)
+    {
+      warning_buffer->reset();
+    }
+  }
+  return ret;
+}
+
 bool ObSql::process_special_stmt_hook(const common::ObString &stmt, ObResultSet &result, ObSqlContext &context)
 {
   int ret = OB_SUCCESS;
@@ -91,6 +91,12 @@ namespace oceanbase
         //  true: hook success
         //  false: not hooked
         static bool process_special_stmt_hook(const common::ObString &stmt, ObResultSet &result, ObSqlContext &context);
+        // execute the text statement with the plan cached in the session
+        // @return
+        //  true: executed with the cached plan
+        //  false: not cachable or failed to use the cache, execute it directly
+        static bool plan_cache_hook(const common::ObString &stmt, ObResultSet &result, ObSqlContext &context);
+        static int prepare_cached_plan(const common::ObString &key, ObSqlContext &context, uint64_t &stmt_id);
         static int do_privilege_check(const common::ObString & username, const ObPrivilege **pp_privilege, ObLogicalPlan *plan);
         static bool no_enough_memory();
       private:
@@ -79,6 +79,7 @@ int ObSQLSessionInfo::init(common::DefaultBlockAllocator &block_allocator)
 
 void ObSQLSessionInfo::destroy()
 {
+  clear_plan_cache();
   IdPlanMap::iterator iter;
   for (iter = id_plan_map_.begin(); iter != id_plan_map_.end(); iter++)
   {
@@ -305,6 +306,11 @@ int ObSQLSessionInfo::update_system_variable(const ObString& var, const ObObj& v
     {
       TBSYS_LOG(ERROR, "Update system variable %.*s error", var.length(), var.ptr());
     }
+    else
+    {
+      // the cached plans may depend on the old value
+      clear_plan_cache();
+    }
   }
   return ret;
 }
@@ -431,6 +437,61 @@ bool ObSQLSessionInfo::is_create_sys_table_disabled() const
   return ret;
 }
 
+bool ObSQLSessionInfo::is_plan_cache_enabled() const
+{
+  bool ret = true;
+  ObObj val;
+  if (OB_SUCCESS != get_sys_variable_value(ObString::make_string(OB_ENABLE_PLAN_CACHE_PARAM), val)
+      || OB_SUCCESS != val.get_bool(ret))
+  {
+    ret = true;
+  }
+  return ret;
+}
+
+int ObSQLSessionInfo::add_cached_plan(const ObString& stmt, const ObPlanCache::CachedPlan& plan)
+{
+  int ret = OB_SUCCESS;
+  ObPlanCache::CachedPlan evicted;
+  if (OB_SUCCESS != (ret = plan_cache_.put(stmt, plan, evicted)))
+  {
+    TBSYS_LOG(WARN, "failed to add plan to cache, err=%d stmt_id=%lu", ret, plan.stmt_id_);
+  }
+  else if (OB_INVALID_ID != evicted.stmt_id_)
+  {
+    OB_STAT_INC(SQL, SQL_PLAN_CACHE_EVICT_COUNT);
+    if (OB_SUCCESS != remove_plan(evicted.stmt_id_))
+    {
+      TBSYS_LOG(WARN, "failed to remove evicted plan, stmt_id=%lu", evicted.stmt_id_);
+    }
+  }
+  return ret;
+}
+
+void ObSQLSessionInfo::remove_cached_plan(const ObString& stmt)
+{
+  ObPlanCache::CachedPlan plan;
+  if (OB_SUCCESS == plan_cache_.remove(stmt, plan)
+      && OB_INVALID_ID != plan.stmt_id_
+      && OB_SUCCESS != remove_plan(plan.stmt_id_))
+  {
+    TBSYS_LOG(WARN, "failed to remove cached plan, stmt_id=%lu", plan.stmt_id_);
+  }
+}
+
+void ObSQLSessionInfo::clear_plan_cache()
+{
+  ObPlanCache::CachedPlan plan;
+  while (OB_SUCCESS == plan_cache_.pop(plan))
+  {
+    if (OB_INVALID_ID != plan.stmt_id_
+        && OB_SUCCESS != remove_plan(plan.stmt_id_))
+    {
+      TBSYS_LOG(WARN, "failed to remove cached plan, stmt_id=%lu", plan.stmt_id_);
+    }
+  }
+}
+
 int ObSQLSessionInfo::set_username(const ObString & user_name)
 {
   int ret = OB_SUCCESS;
@@ -439,6 +500,11 @@ int ObSQLSessionInfo::set_username(const ObString & user_name)
   {
     TBSYS_LOG(WARN, "write username to string_buf_ failed,ret=%d", ret);
   }
+  else
+  {
+    // privileges of the cached plans were checked for the old user
+    clear_plan_cache();
+  }
   return ret;
 }
 
@@ -21,6 +21,7 @@
 #include "common/ob_atomic.h"
 #include "common/hash/ob_hashmap.h"
 #include "ob_result_set.h"
+#include "ob_plan_cache.h"
 #include "WarningBuffer.h"
 #include "common/ob_stack_allocator.h"
 #include "common/ob_range.h"
@@ -133,6 +134,13 @@ namespace oceanbase
         bool get_autocommit() const {return is_autocommit_;};
         // get system variable value
         bool is_create_sys_table_disabled() const;
+        bool is_plan_cache_enabled() const;
+        // plans of text statements are stored like prepared statements,
+        // the plan cache maps the parameterized statements to them
+        ObPlanCache& get_plan_cache(){return plan_cache_;}
+        int add_cached_plan(const common::ObString& stmt, const ObPlanCache::CachedPlan& plan);
+        void remove_cached_plan(const common::ObString& stmt);
+        void clear_plan_cache();
       private:
         static const int64_t MAX_STORED_PLANS_COUNT = 10240;
         static const int64_t MAX_CACHED_ARENA_COUNT = 2;
@@ -168,6 +176,7 @@ namespace oceanbase
         common::ObPool<common::ObWrapperAllocator> arena_pointers_;
         common::ObList<common::ObArenaAllocator *> free_arena_for_transformer_;
         common::ObPooledAllocator<ObResultSet, common::ObWrapperAllocator> result_set_pool_;
+        ObPlanCache plan_cache_;
     };
   }
 }
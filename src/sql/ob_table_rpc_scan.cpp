@@ -174,6 +174,26 @@ namespace oceanbase
       return ret;
     }
 
+    int ObTableRpcScan::get_next_batch(ObRowBatch &batch)
+    {
+      int ret = OB_SUCCESS;
+      if (OB_UNLIKELY(NULL == child_op_))
+      {
+        ret = OB_NOT_INIT;
+      }
+      else
+      {
+        ret = child_op_->get_next_batch(batch);
+      }
+      return ret;
+    }
+
+    bool ObTableRpcScan::is_batch_native() const
+    {
+      // rpc_scan_ is batch native for scan, the operators over it decide
+      return NULL != child_op_ && child_op_->is_batch_native();
+    }
+
     int ObTableRpcScan::get_row_desc(const common::ObRowDesc *&row_desc) const
     {
       int ret = OB_SUCCESS;
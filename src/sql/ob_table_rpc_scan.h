@@ -42,6 +42,8 @@ namespace oceanbase
         virtual int open();
         virtual int close();
         virtual int get_next_row(const common::ObRow *&row);
+        virtual int get_next_batch(ObRowBatch &batch);
+        virtual bool is_batch_native() const;
         virtual int get_row_desc(const common::ObRowDesc *&row_desc) const;
         virtual ObPhyOperatorType get_type() const;
 
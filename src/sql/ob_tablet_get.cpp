@@ -262,6 +262,25 @@ int ObTabletGet::need_incremental_data(
     }
   }
 
+  if (OB_SUCCESS == ret)
+  {
+    chunkserver::ObFusedRowCache &fused_row_cache = tablet_manager_->get_fused_row_cache();
+    if (fused_row_cache.is_inited()
+        && !sql_get_param_->get_is_read_consistency()
+        && OB_NEWEST_DATA_VERSION == end_data_version
+        && 0 == table_join_info.join_column_.count())
+    {
+      // rows read from ups are put into fused row cache, they must be
+      // newer than the commited trans id cache synced with master ups.
+      get_param_.set_is_read_consistency(true);
+      op_tablet_get_fuse->set_fused_row_cache(&fused_row_cache, &get_param_, table_id, start_data_version);
+    }
+    else
+    {
+      op_tablet_get_fuse->set_fused_row_cache(NULL, NULL, table_id, start_data_version);
+    }
+  }
+
   if(OB_SUCCESS == ret)
   {
     if(table_join_info.join_column_.count() > 0)
@@ -16,6 +16,7 @@
 
 #include "ob_tablet_get_fuse.h"
 #include "common/ob_row_fuse.h"
+#include "common/ob_new_scanner_helper.h"
 
 using namespace oceanbase;
 using namespace common;
@@ -25,8 +26,29 @@ ObTabletGetFuse::ObTabletGetFuse()
   :sstable_get_(NULL),
   incremental_get_(NULL),
   data_version_(0),
-  last_rowkey_(NULL)
+  last_rowkey_(NULL),
+  fused_row_cache_(NULL),
+  get_param_(NULL),
+  table_id_(OB_INVALID_ID),
+  column_signature_(0),
+  put_fused_row_(false),
+  all_rows_cached_(false),
+  sstable_get_opened_(false),
+  incremental_get_opened_(false),
+  cached_row_idx_(0)
 {
+  cache_snapshot_.generation_ = 0;
+  cache_snapshot_.trans_id_ = 0;
+}
+
+void ObTabletGetFuse::set_fused_row_cache(chunkserver::ObFusedRowCache *fused_row_cache,
+                                          const ObGetParam *get_param,
+                                          const uint64_t table_id, const int64_t data_version)
+{
+  fused_row_cache_ = fused_row_cache;
+  get_param_ = get_param;
+  table_id_ = table_id;
+  data_version_ = data_version;
 }
 
 int ObTabletGetFuse::set_sstable_get(ObRowkeyPhyOperator *sstable_get)
@@ -62,15 +84,101 @@ int ObTabletGetFuse::set_incremental_get(ObRowkeyPhyOperator *incremental_get)
 int ObTabletGetFuse::open()
 {
   int ret = OB_SUCCESS;
-  if (OB_SUCCESS != (ret = sstable_get_->open()))
+  put_fused_row_ = false;
+  all_rows_cached_ = false;
+  cached_row_idx_ = 0;
+  if (NULL != fused_row_cache_ && OB_SUCCESS != (ret = get_cached_rows()))
+  {
+    TBSYS_LOG(WARN, "fail to get cached rows:ret[%d]", ret);
+  }
+  else if (all_rows_cached_)
+  {
+    // no need to read sstable and updateserver
+  }
+  else
+  {
+    // mark before open, close also cleans up a partially opened child
+    sstable_get_opened_ = true;
+    if (OB_SUCCESS != (ret = sstable_get_->open()))
+    {
+      TBSYS_LOG(WARN, "fail to open sstable get:ret[%d]", ret);
+    }
+    else
+    {
+      incremental_get_opened_ = true;
+      if (OB_SUCCESS != (ret = incremental_get_->open()))
+      {
+        TBSYS_LOG(WARN, "fail to open incremental get:ret[%d]", ret);
+      }
+    }
+  }
+  FILL_TRACE_LOG("open get fuse op done ret =%d, all_rows_cached=%d", ret, all_rows_cached_);
+  return ret;
+}
+
+int ObTabletGetFuse::get_cached_rows()
+{
+  int ret = OB_SUCCESS;
+  const ObGetParam::ObRowIndex *row_index = NULL;
+  cached_rows_.reuse();
+  cached_row_desc_.reset();
+  if (NULL == get_param_)
+  {
+    ret = OB_INVALID_ARGUMENT;
+    TBSYS_LOG(WARN, "get param is null");
+  }
+  else if (!fused_row_cache_->get_snapshot(cache_snapshot_))
+  {
+    // cache out of sync with updateserver, read as usual
+  }
+  else if (OB_SUCCESS != (ret = ObNewScannerHelper::get_row_desc(*get_param_, true, cached_row_desc_)))
+  {
+    // same row desc as sstable get, which isn't opened yet
+    TBSYS_LOG(WARN, "fail to get row desc:ret[%d]", ret);
+  }
+  else
+  {
+    // the snapshot is taken before reading updateserver, rows read
+    // later are safe to put with it.
+    put_fused_row_ = true;
+    all_rows_cached_ = true;
+    column_signature_ = chunkserver::ObFusedRowCache::get_column_signature(cached_row_desc_);
+    curr_row_.set_row_desc(cached_row_desc_);
+    row_index = get_param_->get_row_index();
+    for (int64_t i = 0; all_rows_cached_ && i < get_param_->get_row_size(); i ++)
+    {
+      chunkserver::ObFusedRowCacheKey key(table_id_, data_version_, column_signature_,
+                                          (*get_param_)[row_index[i].offset_]->row_key_);
+      if (OB_SUCCESS != fused_row_cache_->get_row(key, cache_snapshot_, curr_row_, cached_rows_))
+      {
+        all_rows_cached_ = false;
+      }
+    }
+    if (!all_rows_cached_)
+    {
+      cached_rows_.reuse();
+    }
+  }
+  return ret;
+}
+
+int ObTabletGetFuse::get_next_cached_row(const common::ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  if (cached_row_idx_ >= get_param_->get_row_size())
+  {
+    ret = OB_ITER_END;
+  }
+  else if (OB_SUCCESS != (ret = cached_rows_.get_next_row(curr_row_)))
   {
-    TBSYS_LOG(WARN, "fail to open sstable get:ret[%d]", ret);
+    TBSYS_LOG(WARN, "fail to get next cached row:ret[%d]", ret);
   }
-  else if (OB_SUCCESS != (ret = incremental_get_->open()))
+  else
   {
-    TBSYS_LOG(WARN, "fail to open incremental get:ret[%d]", ret);
+    row = &curr_row_;
+    last_rowkey_ = &(*get_param_)[get_param_->get_row_index()[cached_row_idx_].offset_]->row_key_;
+    cached_row_idx_ ++;
   }
-  FILL_TRACE_LOG("open get fuse op done ret =%d", ret);
   return ret;
 }
 
@@ -82,13 +190,20 @@ int ObTabletGetFuse::get_next_row(const common::ObRow *&row)
   const ObRow *tmp_row = NULL;
   const ObUpsRow *incremental_row = NULL;
   const ObRowkey *incremental_rowkey = NULL;
-  ret = sstable_get_->get_next_row(sstable_rowkey, sstable_row);
-  if (OB_SUCCESS != ret && OB_ITER_END != ret)
+  if (all_rows_cached_)
+  {
+    ret = get_next_cached_row(row);
+  }
+  else
   {
-    TBSYS_LOG(WARN, "fail to get sstable next row:ret[%d]", ret);
+    ret = sstable_get_->get_next_row(sstable_rowkey, sstable_row);
+    if (OB_SUCCESS != ret && OB_ITER_END != ret)
+    {
+      TBSYS_LOG(WARN, "fail to get sstable next row:ret[%d]", ret);
+    }
   }
   
-  if (OB_SUCCESS == ret)
+  if (OB_SUCCESS == ret && !all_rows_cached_)
   {
     if (OB_SUCCESS != (ret = incremental_get_->get_next_row(incremental_rowkey, tmp_row)))
     {
@@ -100,7 +215,7 @@ int ObTabletGetFuse::get_next_row(const common::ObRow *&row)
     }
   }
 
-  if (OB_SUCCESS == ret)
+  if (OB_SUCCESS == ret && !all_rows_cached_)
   {
     incremental_row = dynamic_cast<const ObUpsRow *>(tmp_row);
     if (NULL == incremental_row)
@@ -110,7 +225,7 @@ int ObTabletGetFuse::get_next_row(const common::ObRow *&row)
     }
   }
 
-  if (OB_SUCCESS == ret)
+  if (OB_SUCCESS == ret && !all_rows_cached_)
   {
     TBSYS_LOG(DEBUG, "tablet get fuse incr[%s] sstable row[%s]", to_cstring(*incremental_row), to_cstring(*sstable_row));
     if (OB_SUCCESS != (ret = ObRowFuse::fuse_row(incremental_row, sstable_row, &curr_row_)))
@@ -121,6 +236,11 @@ int ObTabletGetFuse::get_next_row(const common::ObRow *&row)
     {
       row = &curr_row_;
       last_rowkey_ = sstable_rowkey;
+      if (put_fused_row_)
+      {
+        chunkserver::ObFusedRowCacheKey key(table_id_, data_version_, column_signature_, *sstable_rowkey);
+        fused_row_cache_->put_row(key, cache_snapshot_, curr_row_);
+      }
     }
   }
   return ret;
@@ -130,16 +250,21 @@ int ObTabletGetFuse::close()
 {
   int ret = OB_SUCCESS;
   int err = OB_SUCCESS;
-  if (OB_SUCCESS != (err = sstable_get_->close()))
+  if (sstable_get_opened_ && OB_SUCCESS != (err = sstable_get_->close()))
   {
     ret = err;
     TBSYS_LOG(WARN, "fail to close sstable get:err[%d]", err);
   }
-  if (OB_SUCCESS != (err = incremental_get_->close()))
+  if (incremental_get_opened_ && OB_SUCCESS != (err = incremental_get_->close()))
   {
     ret = err;
     TBSYS_LOG(WARN, "fail to close incremental get:err[%d]", err);
   }
+  sstable_get_opened_ = false;
+  incremental_get_opened_ = false;
+  all_rows_cached_ = false;
+  put_fused_row_ = false;
+  cached_rows_.clear();
   return ret;
 }
 
@@ -160,7 +285,16 @@ int ObTabletGetFuse::set_child(int32_t child_idx, ObPhyOperator &child_operator)
 
 int ObTabletGetFuse::get_row_desc(const common::ObRowDesc *&row_desc) const
 {
-  return sstable_get_->get_row_desc(row_desc);
+  int ret = OB_SUCCESS;
+  if (all_rows_cached_)
+  {
+    row_desc = &cached_row_desc_;
+  }
+  else
+  {
+    ret = sstable_get_->get_row_desc(row_desc);
+  }
+  return ret;
 }
 
 int ObTabletGetFuse::get_last_rowkey(const common::ObRowkey *&rowkey)
@@ -20,6 +20,8 @@
 #include "ob_phy_operator.h"
 #include "ob_tablet_fuse.h"
 #include "ob_ups_multi_get.h"
+#include "common/ob_row_store.h"
+#include "chunkserver/ob_fused_row_cache.h"
 
 namespace oceanbase
 {
@@ -44,12 +46,42 @@ namespace oceanbase
 
         int get_last_rowkey(const common::ObRowkey *&rowkey);
 
+        /**
+         * read fused rows from cache before reading sstable and
+         * updateserver, both gets are skipped if all rows of get_param
+         * hit, otherwise the fused rows are put into cache. pass NULL
+         * fused_row_cache to disable it.
+         *
+         * @param get_param get param of sstable get and incremental get
+         * @param data_version data version of the sstable
+         */
+        void set_fused_row_cache(chunkserver::ObFusedRowCache *fused_row_cache,
+                                 const common::ObGetParam *get_param,
+                                 const uint64_t table_id, const int64_t data_version);
+
+      private:
+        int get_cached_rows();
+        int get_next_cached_row(const common::ObRow *&row);
+
       private:
         ObRowkeyPhyOperator *sstable_get_;
         ObRowkeyPhyOperator *incremental_get_;
         ObRow curr_row_;
         int64_t data_version_;
         const ObRowkey *last_rowkey_;
+        chunkserver::ObFusedRowCache *fused_row_cache_;
+        chunkserver::ObFusedRowCache::Snapshot cache_snapshot_;
+        const common::ObGetParam *get_param_;
+        uint64_t table_id_;
+        uint64_t column_signature_;
+        bool put_fused_row_;
+        bool all_rows_cached_;
+        // children are not opened when all rows hit the fused row cache
+        bool sstable_get_opened_;
+        bool incremental_get_opened_;
+        int64_t cached_row_idx_;
+        common::ObRowStore cached_rows_;
+        common::ObRowDesc cached_row_desc_;
     };
   }
 }
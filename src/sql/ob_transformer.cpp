@@ -27,7 +27,9 @@
 #include "ob_sort.h"
 #include "ob_merge_distinct.h"
 #include "ob_merge_groupby.h"
+#include "ob_hash_groupby.h"
 #include "ob_merge_join.h"
+#include "ob_hash_join.h"
 #include "ob_scalar_aggregate.h"
 #include "ob_limit.h"
 #include "ob_physical_plan.h"
@@ -127,6 +129,7 @@ ObTransformer::ObTransformer(ObSqlContext &context)
   OB_ASSERT(mem_pool_);
   sql_context_ = &context;
   group_agg_push_down_param_ = false;
+  hash_group_by_param_ = false;
 }
 
 ObTransformer::~ObTransformer()
@@ -172,6 +175,15 @@ int ObTransformer::generate_physical_plans(
       // default off
       group_agg_push_down_param_ = false;
     }
+    // get hash_group_by_param_
+    param_str = ObString::make_string(OB_HASH_GROUP_BY_PARAM);
+    if (sql_context_->session_info_->get_sys_variable_value(param_str, val) != OB_SUCCESS
+      || val.get_bool(hash_group_by_param_) != OB_SUCCESS)
+    {
+      TBSYS_LOG(DEBUG, "Can not get param %s", OB_HASH_GROUP_BY_PARAM);
+      // default off
+      hash_group_by_param_ = false;
+    }
   }
   ObLogicalPlan *logical_plan = NULL;
   ObPhysicalPlan *physical_plan = NULL;
@@ -1068,20 +1080,49 @@ int ObTransformer::gen_phy_group_by(
     ObPhyOperator *&out_op)
 {
   int& ret = err_stat.err_code_ = OB_SUCCESS;
-  ObMergeGroupBy *group_op = NULL;
+  ObGroupBy *group_op = NULL;
   ObSort *sort_op = NULL;
   ObProject *project_op = NULL;
-  if (ret == OB_SUCCESS)
-    CREATE_PHY_OPERRATOR(sort_op, ObSort, physical_plan, err_stat);
-  if (ret == OB_SUCCESS)
-    CREATE_PHY_OPERRATOR(group_op, ObMergeGroupBy, physical_plan, err_stat);
-  if (ret == OB_SUCCESS && (ret = group_op->set_child(0, *sort_op)) != OB_SUCCESS)
+  ObSqlRawExpr *agg_expr = NULL;
+  ObAggFunRawExpr *agg_fun_expr = NULL;
+  int32_t num = select_stmt->get_agg_fun_size();
+  // hash group by needs no sort on the group columns, but its output is
+  // not ordered, use it when the result is sorted again by ORDER BY or it
+  // is turned on. distinct aggregate functions need the sorted input.
+  bool use_hash_group_by = hash_group_by_param_ || select_stmt->get_order_item_size() > 0;
+  for (int32_t i = 0; use_hash_group_by && i < num; i++)
   {
-    TRANS_LOG("Add child of group by plan faild");
+    agg_expr = logical_plan->get_expr(select_stmt->get_agg_expr_id(i));
+    OB_ASSERT(NULL != agg_expr);
+    agg_fun_expr = dynamic_cast<ObAggFunRawExpr*>(agg_expr->get_expr());
+    if (NULL != agg_fun_expr && agg_fun_expr->is_param_distinct())
+    {
+      use_hash_group_by = false;
+    }
+  }
+  if (use_hash_group_by)
+  {
+    ObHashGroupBy *hash_group_op = NULL;
+    if (ret == OB_SUCCESS)
+      CREATE_PHY_OPERRATOR(hash_group_op, ObHashGroupBy, physical_plan, err_stat);
+    group_op = hash_group_op;
+  }
+  else
+  {
+    ObMergeGroupBy *merge_group_op = NULL;
+    if (ret == OB_SUCCESS)
+      CREATE_PHY_OPERRATOR(sort_op, ObSort, physical_plan, err_stat);
+    if (ret == OB_SUCCESS)
+      CREATE_PHY_OPERRATOR(merge_group_op, ObMergeGroupBy, physical_plan, err_stat);
+    if (ret == OB_SUCCESS && (ret = merge_group_op->set_child(0, *sort_op)) != OB_SUCCESS)
+    {
+      TRANS_LOG("Add child of group by plan faild");
+    }
+    group_op = merge_group_op;
   }
 
   ObSqlRawExpr *group_expr;
-  int32_t num = select_stmt->get_group_expr_size();
+  num = select_stmt->get_group_expr_size();
   for (int32_t i = 0; ret == OB_SUCCESS && i < num; i++)
   {
     group_expr = logical_plan->get_expr(select_stmt->get_group_expr_id(i));
@@ -1090,12 +1131,15 @@ int ObTransformer::gen_phy_group_by(
     {
       ObBinaryRefRawExpr *col_expr = dynamic_cast<ObBinaryRefRawExpr*>(group_expr->get_expr());
       OB_ASSERT(NULL != col_expr);
-      ret = sort_op->add_sort_column(col_expr->get_first_ref_id(), col_expr->get_second_ref_id(), true);
-      if (ret != OB_SUCCESS)
+      if (sort_op)
       {
-        TRANS_LOG("Add sort column faild, table_id=%lu, column_id=%lu",
-            col_expr->get_first_ref_id(), col_expr->get_second_ref_id());
-        break;
+        ret = sort_op->add_sort_column(col_expr->get_first_ref_id(), col_expr->get_second_ref_id(), true);
+        if (ret != OB_SUCCESS)
+        {
+          TRANS_LOG("Add sort column faild, table_id=%lu, column_id=%lu",
+              col_expr->get_first_ref_id(), col_expr->get_second_ref_id());
+          break;
+        }
       }
       ret = group_op->add_group_column(col_expr->get_first_ref_id(), col_expr->get_second_ref_id());
       if (ret != OB_SUCCESS)
@@ -1133,7 +1177,7 @@ int ObTransformer::gen_phy_group_by(
         TRANS_LOG("Add output column to project plan faild");
         break;
       }
-      if ((ret = sort_op->add_sort_column(
+      if (sort_op && (ret = sort_op->add_sort_column(
                               group_expr->get_table_id(),
                               group_expr->get_column_id(),
                               true)) != OB_SUCCESS)
@@ -1152,10 +1196,11 @@ int ObTransformer::gen_phy_group_by(
   }
   if (ret == OB_SUCCESS)
   {
+    ObPhyOperator *child_op = sort_op ? static_cast<ObPhyOperator*>(sort_op) : group_op;
     if (project_op)
-      ret = sort_op->set_child(0, *project_op);
+      ret = child_op->set_child(0, *project_op);
     else
-      ret = sort_op->set_child(0, *in_op);
+      ret = child_op->set_child(0, *in_op);
     if (ret != OB_SUCCESS)
     {
       TRANS_LOG("Add child to sort plan faild");
@@ -1163,7 +1208,6 @@ int ObTransformer::gen_phy_group_by(
   }
 
   num = select_stmt->get_agg_fun_size();
-  ObSqlRawExpr *agg_expr = NULL;
   for (int32_t i = 0; ret == OB_SUCCESS && i < num; i++)
   {
     agg_expr = logical_plan->get_expr(select_stmt->get_agg_expr_id(i));
@@ -1258,17 +1302,13 @@ int ObTransformer::gen_phy_joins(
   while (ret == OB_SUCCESS && phy_table_list.size() > 1)
   {
     ObAddProject *project_op = NULL;
-    ObMergeJoin *join_op = NULL;
-    CREATE_PHY_OPERRATOR(join_op, ObMergeJoin, physical_plan, err_stat);
-    if (ret != OB_SUCCESS)
-      break;
-    join_op->set_join_type(ObJoin::INNER_JOIN);
-
+    ObJoin *join_op = NULL;
     ObBitSet<> join_table_bitset;
     ObBitSet<> left_table_bitset;
     ObBitSet<> right_table_bitset;
-    ObSort *left_sort = NULL;
-    ObSort *right_sort = NULL;
+    ObPhyOperator *left_table_op = NULL;
+    ObPhyOperator *right_table_op = NULL;
+    bool is_ordered_join = false;
     oceanbase::common::ObList<ObSqlRawExpr*>::iterator cnd_it;
     oceanbase::common::ObList<ObSqlRawExpr*>::iterator del_it;
     for (cnd_it = remainder_cnd_list.begin(); ret == OB_SUCCESS && cnd_it != remainder_cnd_list.end(); )
@@ -1280,33 +1320,10 @@ int ObTransformer::gen_phy_joins(
         ObBinaryRefRawExpr *rexpr = dynamic_cast<ObBinaryRefRawExpr*>(join_cnd->get_second_op_expr());
         int32_t left_bit_idx = select_stmt->get_table_bit_index(lexpr->get_first_ref_id());
         int32_t right_bit_idx = select_stmt->get_table_bit_index(rexpr->get_first_ref_id());
-        CREATE_PHY_OPERRATOR(left_sort, ObSort, physical_plan, err_stat);
-        if (ret != OB_SUCCESS)
-          break;
-        ret = left_sort->add_sort_column(lexpr->get_first_ref_id(), lexpr->get_second_ref_id(), true);
-        if (ret != OB_SUCCESS)
-        {
-          TRANS_LOG("Add sort column faild table_id=%lu, column_id =%lu",
-              lexpr->get_first_ref_id(), lexpr->get_second_ref_id());
-          break;
-        }
-        CREATE_PHY_OPERRATOR(right_sort, ObSort, physical_plan, err_stat);
-        if (ret != OB_SUCCESS)
-          break;
-        ret = right_sort->add_sort_column(rexpr->get_first_ref_id(), rexpr->get_second_ref_id(), true);
-        if (ret != OB_SUCCESS)
-        {
-          TRANS_LOG("Add sort column faild table_id=%lu, column_id =%lu",
-              lexpr->get_first_ref_id(), lexpr->get_second_ref_id());
-          break;
-        }
-
         oceanbase::common::ObList<ObPhyOperator*>::iterator table_it = phy_table_list.begin();
         oceanbase::common::ObList<ObPhyOperator*>::iterator del_table_it;
         oceanbase::common::ObList<ObBitSet<> >::iterator bitset_it = bitset_list.begin();
         oceanbase::common::ObList<ObBitSet<> >::iterator del_bitset_it;
-        ObPhyOperator *left_table_op = NULL;
-        ObPhyOperator *right_table_op = NULL;
         while (ret == OB_SUCCESS
             && (!left_table_op || !right_table_op)
             && table_it != phy_table_list.end()
@@ -1355,16 +1372,67 @@ int ObTransformer::gen_phy_joins(
 
         // Two columns must from different table, that expression from one table has been erased in gen_phy_table()
         OB_ASSERT(left_table_op && right_table_op);
-        if ((ret = left_sort->set_child(0, *left_table_op)) != OB_SUCCESS )
+        if (is_ordered_by_column(select_stmt, left_table_op, lexpr->get_first_ref_id(), lexpr->get_second_ref_id())
+          && is_ordered_by_column(select_stmt, right_table_op, rexpr->get_first_ref_id(), rexpr->get_second_ref_id()))
         {
-          TRANS_LOG("Add child of join plan faild");
-          break;
+          // both inputs are scanned in the order of the join columns,
+          // a merge join will be used directly on them without sorting
+          CREATE_PHY_OPERRATOR(join_op, ObMergeJoin, physical_plan, err_stat);
+          if (ret != OB_SUCCESS)
+            break;
+          is_ordered_join = true;
         }
-        if ((ret = right_sort->set_child(0, *right_table_op)) != OB_SUCCESS )
+        else if (!is_join_key_type_equal(remainder_cnd_list, left_table_bitset, right_table_bitset))
         {
-          TRANS_LOG("Add child of join plan faild");
-          break;
+          // the hash join hashes and compares the keys without type promotion,
+          // keys of different types are joined by sort and merge join instead
+          ObSort *left_sort = NULL;
+          ObSort *right_sort = NULL;
+          CREATE_PHY_OPERRATOR(join_op, ObMergeJoin, physical_plan, err_stat);
+          if (ret != OB_SUCCESS)
+            break;
+          CREATE_PHY_OPERRATOR(left_sort, ObSort, physical_plan, err_stat);
+          if (ret != OB_SUCCESS)
+            break;
+          ret = left_sort->add_sort_column(lexpr->get_first_ref_id(), lexpr->get_second_ref_id(), true);
+          if (ret != OB_SUCCESS)
+          {
+            TRANS_LOG("Add sort column faild table_id=%lu, column_id =%lu",
+                lexpr->get_first_ref_id(), lexpr->get_second_ref_id());
+            break;
+          }
+          CREATE_PHY_OPERRATOR(right_sort, ObSort, physical_plan, err_stat);
+          if (ret != OB_SUCCESS)
+            break;
+          ret = right_sort->add_sort_column(rexpr->get_first_ref_id(), rexpr->get_second_ref_id(), true);
+          if (ret != OB_SUCCESS)
+          {
+            TRANS_LOG("Add sort column faild table_id=%lu, column_id =%lu",
+                rexpr->get_first_ref_id(), rexpr->get_second_ref_id());
+            break;
+          }
+          if ((ret = left_sort->set_child(0, *left_table_op)) != OB_SUCCESS)
+          {
+            TRANS_LOG("Add child of join plan faild");
+            break;
+          }
+          if ((ret = right_sort->set_child(0, *right_table_op)) != OB_SUCCESS)
+          {
+            TRANS_LOG("Add child of join plan faild");
+            break;
+          }
+          left_table_op = left_sort;
+          right_table_op = right_sort;
+          is_ordered_join = true;
+        }
+        else
+        {
+          // no sort needed by the hash join, the right table is the build side
+          CREATE_PHY_OPERRATOR(join_op, ObHashJoin, physical_plan, err_stat);
+          if (ret != OB_SUCCESS)
+            break;
         }
+        join_op->set_join_type(ObJoin::INNER_JOIN);
         ObSqlExpression join_op_cnd;
         if ((ret = (*cnd_it)->fill_sql_expression(
                                   join_op_cnd,
@@ -1391,38 +1459,21 @@ int ObTransformer::gen_phy_joins(
       else if ((*cnd_it)->get_expr()->is_join_cond()
         && (*cnd_it)->get_tables_set().is_subset(join_table_bitset))
       {
-        ObBinaryOpRawExpr *join_cnd = dynamic_cast<ObBinaryOpRawExpr*>((*cnd_it)->get_expr());
-        ObBinaryRefRawExpr *expr1 = dynamic_cast<ObBinaryRefRawExpr*>(join_cnd->get_first_op_expr());
-        ObBinaryRefRawExpr *expr2 = dynamic_cast<ObBinaryRefRawExpr*>(join_cnd->get_second_op_expr());
-        int32_t bit_idx1 = select_stmt->get_table_bit_index(expr1->get_first_ref_id());
-        int32_t bit_idx2 = select_stmt->get_table_bit_index(expr2->get_first_ref_id());
-        if (left_table_bitset.has_member(bit_idx1))
-          ret = left_sort->add_sort_column(expr1->get_first_ref_id(), expr1->get_second_ref_id(), true);
-        else
-          ret = right_sort->add_sort_column(expr1->get_first_ref_id(), expr1->get_second_ref_id(), true);
-        if (ret != OB_SUCCESS)
-        {
-          TRANS_LOG("Add sort column faild table_id=%lu, column_id =%lu",
-              expr1->get_first_ref_id(), expr1->get_second_ref_id());
-          break;
-        }
-        if (right_table_bitset.has_member(bit_idx2))
-          ret = right_sort->add_sort_column(expr2->get_first_ref_id(), expr2->get_second_ref_id(), true);
-        else
-          ret = left_sort->add_sort_column(expr2->get_first_ref_id(), expr2->get_second_ref_id(), true);
-        if (ret != OB_SUCCESS)
-        {
-          TRANS_LOG("Add sort column faild table_id=%lu, column_id =%lu",
-              expr2->get_first_ref_id(), expr2->get_second_ref_id());
-          break;
-        }
         ObSqlExpression join_op_cnd;
         if ((ret = ((*cnd_it)->fill_sql_expression(
                                   join_op_cnd,
                                   this,
                                   logical_plan,
-                                  physical_plan))) != OB_SUCCESS
-          || (ret = join_op->add_equijoin_condition(join_op_cnd)) != OB_SUCCESS)
+                                  physical_plan))) != OB_SUCCESS)
+        {
+          TRANS_LOG("Add condition of join plan faild");
+          break;
+        }
+        // the unsorted inputs of a merge join are only ordered by the first join column,
+        // so the other equal conditions are checked after the rows are joined
+        else if ((ret = (is_ordered_join
+                         ? join_op->add_other_join_condition(join_op_cnd)
+                         : join_op->add_equijoin_condition(join_op_cnd))) != OB_SUCCESS)
         {
           TRANS_LOG("Add condition of join plan faild");
           break;
@@ -1469,15 +1520,14 @@ int ObTransformer::gen_phy_joins(
     {
       if (join_table_bitset.is_empty() == false)
       {
-        // find a join condition, a merge join will be used here
-        OB_ASSERT(left_sort != NULL);
-        OB_ASSERT(right_sort != NULL);
-        if ((ret = join_op->set_child(0, *left_sort)) != OB_SUCCESS)
+        // find a join condition, a merge join or a hash join will be used here
+        OB_ASSERT(join_op != NULL);
+        if ((ret = join_op->set_child(0, *left_table_op)) != OB_SUCCESS)
         {
           TRANS_LOG("Add child of join plan faild");
           break;
         }
-        if ((ret = join_op->set_child(1, *right_sort)) != OB_SUCCESS)
+        if ((ret = join_op->set_child(1, *right_table_op)) != OB_SUCCESS)
         {
           TRANS_LOG("Add child of join plan faild");
           break;
@@ -1488,6 +1538,10 @@ int ObTransformer::gen_phy_joins(
         // Can not find a join condition, a product join will be used here
         // FIX me, should be ObJoin, it will be fixed when Join is supported
         ObPhyOperator *op = NULL;
+        CREATE_PHY_OPERRATOR(join_op, ObMergeJoin, physical_plan, err_stat);
+        if (ret != OB_SUCCESS)
+          break;
+        join_op->set_join_type(ObJoin::INNER_JOIN);
         if ((ret = phy_table_list.pop_front(op)) != OB_SUCCESS)
         {
           TRANS_LOG("Generate join plan faild");
@@ -1625,6 +1679,65 @@ int ObTransformer::gen_phy_joins(
   return ret;
 }
 
+// A base table scanned by ObTableRpcScan is returned in the order of its rowkey,
+// so it is ordered by the join column if the column is the first rowkey column
+bool ObTransformer::is_ordered_by_column(
+    ObSelectStmt *select_stmt,
+    ObPhyOperator *table_op,
+    uint64_t table_id,
+    uint64_t column_id)
+{
+  bool ret = false;
+  TableItem *table_item = NULL;
+  const ObTableSchema *table_schema = NULL;
+  uint64_t rowkey_column_id = OB_INVALID_ID;
+  if (dynamic_cast<ObTableRpcScan*>(table_op) == NULL)
+  {
+    // filtered, projected or generated table
+  }
+  else if ((table_item = select_stmt->get_table_item_by_id(table_id)) == NULL
+    || (table_item->type_ != TableItem::BASE_TABLE && table_item->type_ != TableItem::ALIAS_TABLE))
+  {
+  }
+  else if ((table_schema = sql_context_->schema_manager_->get_table_schema(table_item->ref_id_)) == NULL)
+  {
+    TBSYS_LOG(WARN, "fail to get table schema for table[%lu]", table_item->ref_id_);
+  }
+  else if (table_schema->get_rowkey_info().get_column_id(0, rowkey_column_id) == OB_SUCCESS
+    && rowkey_column_id == column_id)
+  {
+    ret = true;
+  }
+  return ret;
+}
+
+bool ObTransformer::is_join_key_type_equal(
+    oceanbase::common::ObList<ObSqlRawExpr*>& cnd_list,
+    const ObBitSet<>& left_table_bitset,
+    const ObBitSet<>& right_table_bitset)
+{
+  bool ret = true;
+  ObBitSet<> table_bitset;
+  table_bitset.add_members(left_table_bitset);
+  table_bitset.add_members(right_table_bitset);
+  oceanbase::common::ObList<ObSqlRawExpr*>::iterator cnd_it;
+  for (cnd_it = cnd_list.begin(); ret && cnd_it != cnd_list.end(); cnd_it++)
+  {
+    // all the equal conditions between the two inputs become keys of the same join
+    if ((*cnd_it)->get_expr()->is_join_cond()
+      && (*cnd_it)->get_tables_set().is_subset(table_bitset))
+    {
+      ObBinaryOpRawExpr *join_cnd = dynamic_cast<ObBinaryOpRawExpr*>((*cnd_it)->get_expr());
+      if (join_cnd->get_first_op_expr()->get_result_type()
+        != join_cnd->get_second_op_expr()->get_result_type())
+      {
+        ret = false;
+      }
+    }
+  }
+  return ret;
+}
+
 int ObTransformer::gen_phy_tables(
     ObLogicalPlan *logical_plan,
     ObPhysicalPlan *physical_plan,
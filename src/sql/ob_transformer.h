@@ -147,6 +147,15 @@ namespace oceanbase
             oceanbase::common::ObList<ObBitSet<> >& bitset_list,
             oceanbase::common::ObList<ObSqlRawExpr*>& remainder_cnd_list,
             oceanbase::common::ObList<ObSqlRawExpr*>& none_columnlize_alias);
+        bool is_ordered_by_column(
+            ObSelectStmt *select_stmt,
+            ObPhyOperator *table_op,
+            uint64_t table_id,
+            uint64_t column_id);
+        bool is_join_key_type_equal(
+            oceanbase::common::ObList<ObSqlRawExpr*>& cnd_list,
+            const ObBitSet<>& left_table_bitset,
+            const ObBitSet<>& right_table_bitset);
         int gen_phy_group_by(
             ObLogicalPlan *logical_plan,
             ObPhysicalPlan *physical_plan,
@@ -371,6 +380,7 @@ namespace oceanbase
         common::ObIAllocator *mem_pool_;
         ObSqlContext *sql_context_;
         bool group_agg_push_down_param_;
+        bool hash_group_by_param_;
     };
 
     inline ObSqlContext* ObTransformer::get_sql_context()
@@ -67,10 +67,20 @@ int ObUpsScan::add_column(const uint64_t &column_id)
   return ret;
 }
 
+void ObUpsScan::end_scan_session()
+{
+  if(scan_session_.is_valid() && NULL != rpc_proxy_)
+  {
+    rpc_proxy_->sql_ups_stream_end(scan_session_);
+  }
+  scan_session_.reset();
+}
+
 int ObUpsScan::close()
 {
   int ret = OB_SUCCESS;
   TBSYS_LOG(DEBUG, "ups scan row count=%ld", row_counter_);
+  end_scan_session();
   return ret;
 }
 
@@ -134,29 +144,64 @@ int ObUpsScan::fetch_next(bool first_scan)
 {
   int ret = OB_SUCCESS;
   ObRowkey last_rowkey;
+  bool stream_fetched = false;
   INIT_PROFILE_LOG_TIMER();
 
-  if(!first_scan)
+  if(first_scan)
+  {
+    end_scan_session();
+  }
+  else
   {
     if(OB_SUCCESS != (ret = cur_new_scanner_.get_last_row_key(last_rowkey)))
     {
       TBSYS_LOG(WARN, "new scanner get rowkey fail:ret[%d]", ret);
     }
-    else if(OB_SUCCESS != (ret = get_next_scan_param(last_rowkey, cur_scan_param_)))
+    else if(scan_session_.is_valid())
+    {
+      // last_rowkey指向cur_new_scanner_的内存, 续读会覆盖它, 先保存下来以便续读失败时重新定位;
+      // 上一次保存的rowkey已经不再被引用, 每次复用range_str_buf_
+      range_str_buf_.reuse();
+      if(OB_SUCCESS != (ret = range_str_buf_.write_string(last_rowkey, &last_rowkey)))
+      {
+        TBSYS_LOG(WARN, "save last rowkey fail:ret[%d]", ret);
+      }
+      else if(OB_SUCCESS == rpc_proxy_->sql_ups_stream_next(scan_session_, cur_new_scanner_, network_timeout_))
+      {
+        bool is_fullfilled = false;
+        int64_t fullfilled_row_num = 0;
+        stream_fetched = true;
+        // 最后一页发出后UPS已经关闭了流, close时不需要再通知
+        if(OB_SUCCESS == cur_new_scanner_.get_is_req_fullfilled(is_fullfilled, fullfilled_row_num)
+            && is_fullfilled)
+        {
+          scan_session_.reset();
+        }
+      }
+      else
+      {
+        // 续读失败时UPS上的流可能仍然存在, 通知它关闭后再重新定位
+        TBSYS_LOG(INFO, "scan stream next fail, rescan from last rowkey[%s]", to_cstring(last_rowkey));
+        end_scan_session();
+      }
+    }
+    if(OB_SUCCESS == ret
+        && !stream_fetched
+        && OB_SUCCESS != (ret = get_next_scan_param(last_rowkey, cur_scan_param_)))
     {
       TBSYS_LOG(WARN, "get scan param fail:ret[%d]", ret);
     }
   }
 
-  if(OB_SUCCESS == ret)
+  if(OB_SUCCESS == ret && !stream_fetched)
   {
-    if(OB_SUCCESS != (ret = rpc_proxy_->sql_ups_scan(cur_scan_param_, cur_new_scanner_, network_timeout_)))
+    if(OB_SUCCESS != (ret = rpc_proxy_->sql_ups_stream_scan(cur_scan_param_, cur_new_scanner_, scan_session_, network_timeout_)))
     {
       TBSYS_LOG(WARN, "scan ups fail:ret[%d]", ret);
     }
   }
-  PROFILE_LOG_TIME(DEBUG, "ObUpsScan::fetch_next first_scan[%d] , range=%s",
-      first_scan, to_cstring(*cur_scan_param_.get_range()));
+  PROFILE_LOG_TIME(DEBUG, "ObUpsScan::fetch_next first_scan[%d] stream[%d], range=%s",
+      first_scan, stream_fetched, to_cstring(*cur_scan_param_.get_range()));
 
   return ret;
 }
@@ -228,6 +273,7 @@ int ObUpsScan::set_ups_rpc_proxy(ObSqlUpsRpcProxy *rpc_proxy)
 
 void ObUpsScan::reset()
 {
+  end_scan_session();
   cur_scan_param_.reset();
   row_desc_.reset();
 }
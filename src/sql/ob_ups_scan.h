@@ -78,6 +78,8 @@ namespace oceanbase
 
         int get_next_scan_param(const ObRowkey &last_rowkey, ObScanParam &scan_param);
         int fetch_next(bool first_scan);
+        // 通知UPS关闭未结束的scan stream并清除session
+        void end_scan_session();
         bool check_inner_stat();
 
       protected:
@@ -89,6 +91,8 @@ namespace oceanbase
         ObRowDesc row_desc_;
         ObStringBuf range_str_buf_;
         ObSqlUpsRpcProxy *rpc_proxy_;
+        // UPS保留的扫描流, 有效时后续页不需要重新定位
+        ObUpsScanSession scan_session_;
         int64_t network_timeout_;
         int64_t row_counter_;
         bool is_read_consistency_;
@@ -15,6 +15,7 @@
 #include "common/ob_record_header.h"
 #include "common/ob_common_stat.h"
 #include "ob_blockcache.h"
+#include "ob_disk_path.h"
 #include "ob_sstable_block_index_v2.h"
 #include "ob_sstable_writer.h"
 
@@ -24,14 +25,62 @@ namespace oceanbase
   {
     using namespace common;
 
+    /**
+     * io completion callback of prefetch_block, put the block into 
+     * block cache and free itself. 
+     */
+    class ObBlockPrefetchCallback : public ObDiskIOCallback
+    {
+    public:
+      ObBlockPrefetchCallback(ObBlockCache::KVCache& kv_cache, IFileInfoMgr& fileinfo_cache,
+                              const IFileInfo* file_info, const ObDataIndexKey& data_index)
+      : kv_cache_(kv_cache), fileinfo_cache_(fileinfo_cache),
+        file_info_(file_info), data_index_(data_index)
+      {
+      }
+
+      virtual void on_io_complete(const int err, const char* buf, const int64_t size)
+      {
+        int status = err;
+        BlockCacheValue value;
+        if (OB_SUCCESS == status)
+        {
+          value.nbyte = size;
+          value.buffer = const_cast<char*>(buf);
+          status = ObRecordHeader::check_record(value.buffer, value.nbyte, 
+                                                ObSSTableWriter::DATA_BLOCK_MAGIC);
+        }
+        if (OB_SUCCESS == status)
+        {
+          status = kv_cache_.put(data_index_, value, false);
+        }
+        if (OB_SUCCESS != status && OB_ENTRY_EXIST != status)
+        {
+          TBSYS_LOG(WARN, "prefetch block fail, sstable_id=%lu offset=%ld nbyte=%ld, status=%d",
+                    data_index_.sstable_id, data_index_.offset, data_index_.size, status);
+        }
+        fileinfo_cache_.revert_fileinfo(file_info_);
+        this->~ObBlockPrefetchCallback();
+        ob_free(this);
+      }
+
+      ObDiskIORequest request_;
+
+    private:
+      ObBlockCache::KVCache& kv_cache_;
+      IFileInfoMgr& fileinfo_cache_;
+      const IFileInfo* file_info_;
+      ObDataIndexKey data_index_;
+    };
+
     ObBlockCache::ObBlockCache()
-    : inited_(false), fileinfo_cache_(NULL)
+    : inited_(false), fileinfo_cache_(NULL), io_engine_(NULL)
     {
 
     }
 
     ObBlockCache::ObBlockCache(IFileInfoMgr& fileinfo_cache) 
-    : inited_(false), fileinfo_cache_(&fileinfo_cache)
+    : inited_(false), fileinfo_cache_(&fileinfo_cache), io_engine_(NULL)
     {
     }
 
@@ -129,10 +178,12 @@ namespace oceanbase
                                   const uint64_t sstable_id, 
                                   const int64_t offset, 
                                   const int64_t size, 
-                                  const char*& out_buffer)
+                                  const char*& out_buffer,
+                                  const int priority)
     {
       int ret                 = OB_SUCCESS;
       ObFileBuffer* file_buf  = GET_TSI_MULT(ObFileBuffer, TSI_SSTABLE_FILE_BUFFER_1);
+      int32_t disk_no         = static_cast<int32_t>(sstable_id & DISK_NO_MASK);
       out_buffer = NULL;
 
       if (NULL == file_buf)
@@ -140,6 +191,35 @@ namespace oceanbase
         TBSYS_LOG(WARN, "get thread file read buffer failed, file_buf=NULL");
         ret = OB_ERROR;
       }
+      else if (NULL != io_engine_ && io_engine_->has_disk(disk_no))
+      {
+        const IFileInfo* file_info = fileinfo_cache.get_fileinfo(sstable_id);
+        if (NULL == file_info)
+        {
+          TBSYS_LOG(WARN, "get file info fail sstable_id=%lu offset=%ld size=%ld", 
+                    sstable_id, offset, size);
+          ret = OB_ERROR;
+        }
+        else
+        {
+          if (OB_SUCCESS != (ret = file_buf->assign(size)))
+          {
+            TBSYS_LOG(WARN, "assign file buffer fail size=%ld", size);
+          }
+          else if (OB_SUCCESS != (ret = io_engine_->read(disk_no, file_info->get_fd(), offset, 
+                                                         size, file_buf->get_buffer(), priority)))
+          {
+            TBSYS_LOG(WARN, "read record by io engine fail sstable_id=%lu offset=%ld size=%ld ret=%d", 
+                      sstable_id, offset, size, ret);
+          }
+          else
+          {
+            file_buf->set_base_pos(0);
+            out_buffer = file_buf->get_buffer();
+          }
+          fileinfo_cache.revert_fileinfo(file_info);
+        }
+      }
       else
       {
         ret = ObFileReader::read_record(fileinfo_cache, sstable_id, offset, 
@@ -250,6 +330,88 @@ namespace oceanbase
       return ret;
     }
 
+    int ObBlockCache::prefetch_block(const uint64_t sstable_id,
+                                     const int64_t offset,
+                                     const int64_t nbyte,
+                                     const uint64_t table_id,
+                                     const int priority)
+    {
+      int ret                         = OB_SUCCESS;
+      int32_t disk_no                 = static_cast<int32_t>(sstable_id & DISK_NO_MASK);
+      const IFileInfo* file_info      = NULL;
+      void* cb_buf                    = NULL;
+      ObBlockPrefetchCallback* callback = NULL;
+      ObDataIndexKey data_index;
+      BlockCacheValue value;
+
+      if (!inited_ || NULL == fileinfo_cache_)
+      {
+        TBSYS_LOG(WARN, "have not inited, fileinfo_cache_=%p", fileinfo_cache_);
+        ret = OB_NOT_INIT;
+      }
+      else if (OB_INVALID_ID == sstable_id || offset < 0 || nbyte <= 0
+               || OB_INVALID_ID == table_id || 0 == table_id)
+      {
+        TBSYS_LOG(WARN, "invalid param sstable_id=%lu, offset=%ld, nbyte=%ld, "
+                        "table_id=%lu", 
+                  sstable_id, offset, nbyte, table_id);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (NULL == io_engine_ || !io_engine_->has_disk(disk_no))
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else
+      {
+        data_index.sstable_id = sstable_id;
+        data_index.offset = offset;
+        data_index.size = nbyte;
+
+        if (OB_SUCCESS == kv_cache_.get(data_index, value, false))
+        {
+          // already in block cache
+        }
+        else if (NULL == (file_info = fileinfo_cache_->get_fileinfo(sstable_id)))
+        {
+          TBSYS_LOG(WARN, "get file info fail sstable_id=%lu", sstable_id);
+          ret = OB_ERROR;
+        }
+        else if (NULL == (cb_buf = ob_malloc(sizeof(ObBlockPrefetchCallback), ObModIds::OB_SSTABLE_AIO)))
+        {
+          TBSYS_LOG(WARN, "failed to allocate memory for prefetch callback");
+          fileinfo_cache_->revert_fileinfo(file_info);
+          ret = OB_ALLOCATE_MEMORY_FAILED;
+        }
+        else
+        {
+          callback = new (cb_buf) ObBlockPrefetchCallback(kv_cache_, *fileinfo_cache_, 
+                                                          file_info, data_index);
+          callback->request_.fd = file_info->get_fd();
+          callback->request_.offset = offset;
+          callback->request_.size = nbyte;
+          callback->request_.priority = priority;
+          callback->request_.callback = callback;
+          if (OB_SUCCESS != (ret = io_engine_->submit(disk_no, callback->request_)))
+          {
+            TBSYS_LOG(WARN, "submit prefetch request fail sstable_id=%lu offset=%ld "
+                            "nbyte=%ld ret=%d", sstable_id, offset, nbyte, ret);
+            callback->~ObBlockPrefetchCallback();
+            ob_free(cb_buf);
+            fileinfo_cache_->revert_fileinfo(file_info);
+          }
+#ifndef _SSTABLE_NO_STAT_
+          else
+          {
+            OB_STAT_TABLE_INC(SSTABLE, table_id, INDEX_DISK_IO_NUM, 1); 
+            OB_STAT_TABLE_INC(SSTABLE, table_id, INDEX_DISK_IO_BYTES, nbyte); 
+          }
+#endif
+        }
+      }
+
+      return ret;
+    }
+
     int32_t ObBlockCache::get_block_readahead(
         const uint64_t sstable_id,
         const uint64_t table_id,
@@ -280,7 +442,7 @@ namespace oceanbase
         data_index.offset = current_block.offset_;
         data_index.size = current_block.size_;
 
-        if (OB_SUCCESS == kv_cache_.get(data_index, output_value, buffer_handle.handle_, true))
+        if (OB_SUCCESS == kv_cache_.get(data_index, output_value, buffer_handle.handle_, true, true))
         {
           // found in cache, continue search next block;
           buffer_handle.block_cache_ = this;
@@ -346,7 +508,7 @@ namespace oceanbase
           {
             readahead_offset = block_infos.position_info_[start_cursor].offset_;
             status = read_record(*fileinfo_cache_, sstable_id, 
-                readahead_offset, readahead_size, buffer);
+                readahead_offset, readahead_size, buffer, DISK_IO_PRIORITY_SCAN);
 
 #ifndef _SSTABLE_NO_STAT_
             OB_STAT_TABLE_INC(SSTABLE, table_id, INDEX_BLOCK_CACHE_MISS, 1);
@@ -388,7 +550,7 @@ namespace oceanbase
               if (cursor == i)
               {
                 status = kv_cache_.put_and_fetch(data_index, input_value, 
-                    output_value, buffer_handle.handle_, false, false);
+                    output_value, buffer_handle.handle_, false, false, true);
                 if (OB_SUCCESS == status)
                 {
                   buffer_handle.block_cache_ = this;
@@ -405,7 +567,7 @@ namespace oceanbase
               }
               else
               {
-                kv_cache_.put(data_index, input_value, false);
+                kv_cache_.put(data_index, input_value, false, true);
               }
               inner_offset += block_infos.position_info_[i].size_; 
             }
@@ -440,7 +602,7 @@ namespace oceanbase
         data_index.offset = offset;
         data_index.size = nbyte;
 
-        if (OB_SUCCESS == kv_cache_.get(data_index, value, buffer_handle.handle_, true))
+        if (OB_SUCCESS == kv_cache_.get(data_index, value, buffer_handle.handle_, true, true))
         {
           buffer_handle.block_cache_ = this;
           buffer_handle.buffer_ = value.buffer;
@@ -613,5 +775,10 @@ namespace oceanbase
 
       return ret;
     }
+
+    int64_t ObBlockCache::get_iter_access_time(const ObBufferHandle &buffer_handle) const
+    {
+      return kv_cache_.get_iter_access_time(buffer_handle.handle_);
+    }
   }
 }
@@ -18,6 +18,7 @@
 #include "common/murmur_hash.h"
 #include "common/ob_kv_storecache.h"
 #include "common/ob_fileinfo_manager.h"
+#include "common/ob_disk_io_engine.h"
 #include "ob_aio_buffer_mgr.h"
 
 namespace oceanbase
@@ -242,6 +243,29 @@ namespace oceanbase
                             const uint64_t column_group_id,
                             const bool check_crc = true);
 
+      /**
+       * if the block isn't in block cache, submit an async read of 
+       * the block to disk io engine and return immediately, the io 
+       * completion callback puts the block into block cache. it's 
+       * used to issue reads of many blocks at once, for example 
+       * before a batch of gets. 
+       * 
+       * @param sstable_id sstable id of sstable file to read
+       * @param offset offset in sstable file to read
+       * @param nbyte how much data to read from sstable file
+       * @param table_id table id 
+       * @param priority io priority, see common::ObDiskIOPriority
+       * 
+       * @return int if read submitted or block is in cache, return 
+       *         OB_SUCCESS, if disk io engine isn't set, return
+       *         OB_NOT_SUPPORTED, else return error code
+       */
+      int prefetch_block(const uint64_t sstable_id,
+                         const int64_t offset,
+                         const int64_t nbyte,
+                         const uint64_t table_id,
+                         const int priority = common::DISK_IO_PRIORITY_GET);
+
       /**
        * get next block in block cache, it's used to traverse the 
        * block cache. 
@@ -256,6 +280,17 @@ namespace oceanbase
       int get_next_block(ObDataIndexKey &data_index, 
                          ObBufferHandle &buffer_handle);
 
+      /**
+       * get the last access time of the block returned by 
+       * get_next_block(), blocks in one memblock share the same 
+       * access time, used to pick the hot blocks. 
+       * 
+       * @param buffer_handle buffer handle used by get_next_block
+       * 
+       * @return int64_t last access time in us, 0 if unknown
+       */
+      int64_t get_iter_access_time(const ObBufferHandle &buffer_handle) const;
+
       /**
        * if using the default constructor, must call this function to 
        * set the file info cache 
@@ -272,6 +307,16 @@ namespace oceanbase
         return *fileinfo_cache_;
       }
 
+      /**
+       * if disk io engine is set, the block reads missed in cache 
+       * are queued to the io engine of the disk where sstable file 
+       * is, instead of pread by current thread. 
+       */
+      inline void set_io_engine(common::ObDiskIOEngine* io_engine)
+      {
+        io_engine_ = io_engine;
+      }
+
       inline KVCache &get_kv_cache()
       {
         return kv_cache_;
@@ -282,7 +327,8 @@ namespace oceanbase
                       const uint64_t sstable_id, 
                       const int64_t offset, 
                       const int64_t size, 
-                      const char*& out_buffer);
+                      const char*& out_buffer,
+                      const int priority = common::DISK_IO_PRIORITY_GET);
 
       ObAIOBufferMgr* get_aio_buf_mgr(const uint64_t sstable_id, 
                                       const uint64_t table_id, 
@@ -292,6 +338,7 @@ namespace oceanbase
     private:
       bool inited_;
       common::IFileInfoMgr* fileinfo_cache_;
+      common::ObDiskIOEngine* io_engine_;
       KVCache kv_cache_;
     };
 
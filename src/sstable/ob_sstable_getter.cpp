@@ -12,6 +12,7 @@
  *   huating <huating.zmq@taobao.com>
  *
  */
+#include <algorithm>
 #include "common/utility.h"
 #include "common/ob_define.h"
 #include "common/ob_record_header.h"
@@ -34,7 +35,8 @@ namespace oceanbase
       handled_cells_(0), column_group_num_(0), cur_column_group_idx_(0), 
       get_param_(NULL), cur_column_mask_(MAX_GET_COLUMN_COUNT_PRE_ROW),
       getter_(cur_column_mask_), block_cache_(NULL), 
-      block_index_cache_(NULL), sstable_row_cache_(NULL), 
+      block_index_cache_(NULL), sstable_row_cache_(NULL), batch_blocks_(NULL),
+      last_sstable_id_(OB_INVALID_ID), last_block_offset_(-1), last_block_data_size_(0),
       uncomp_buf_(DEFAULT_UNCOMP_BUF_SIZE), row_buf_(DEFAULT_ROW_BUF_SIZE)
     {
       memset(column_group_, 0, OB_MAX_COLUMN_GROUP_NUMBER * sizeof(uint64_t));
@@ -394,6 +396,11 @@ namespace oceanbase
       block_cache_ = NULL;
       block_index_cache_ = NULL;
       sstable_row_cache_ = NULL;
+
+      batch_blocks_ = NULL;
+      last_sstable_id_ = OB_INVALID_ID;
+      last_block_offset_ = -1;
+      last_block_data_size_ = 0;
     }
 
     int ObSSTableGetter::init(ObBlockCache& block_cache, 
@@ -430,6 +437,12 @@ namespace oceanbase
         sstable_row_cache_ = row_cache;
 
         inited_ = true;
+        if (readers_size_ >= MIN_BATCH_GET_ROW_COUNT)
+        {
+          //it's only an optimization, ignore the error
+          prefetch_blocks();
+          FILL_TRACE_LOG("init sstable_getter_ prefetch_blocks done.");
+        }
         ret = filter_column_group();
         FILL_TRACE_LOG("init sstable_getter_ filter_column_group done.");
         if (OB_SUCCESS == ret)
@@ -550,7 +563,17 @@ namespace oceanbase
           FILL_TRACE_LOG("check row cache hit=%d.", is_row_cache_hit);
         }
 
-        if (NULL == sstable_row_cache_ || !is_row_cache_hit)
+        if (NULL != sstable_row_cache_ && is_row_cache_hit)
+        {
+          //row in row cache, needn't load block
+        }
+        else if (is_batch_block_ready(column_group_[cur_column_group_idx_]))
+        {
+          //block position is looked up by prefetch_blocks()
+          ret = batch_blocks_[cur_reader_idx_].ret_;
+          block_pos_ = batch_blocks_[cur_reader_idx_].pos_;
+        }
+        else
         {
           info.sstable_file_id_ = readers_[cur_reader_idx_]->get_sstable_id().sstable_file_id_;
           info.offset_ = trailer.get_block_index_record_offset();
@@ -803,6 +826,7 @@ namespace oceanbase
       
       block_data = NULL;
       block_data_size = 0;
+      last_block_offset_ = -1;
 
       if (OB_SUCCESS == ret)
       {
@@ -879,6 +903,13 @@ namespace oceanbase
         }
       }
 
+      if (OB_SUCCESS == ret)
+      {
+        last_sstable_id_ = sstable_id;
+        last_block_offset_ = block_pos_.offset_;
+        last_block_data_size_ = block_data_size;
+      }
+
       return ret;
     }
 
@@ -910,8 +941,18 @@ namespace oceanbase
 
       if (OB_SUCCESS == ret)
       {
-        ret = get_block_data(reader->get_sstable_id().sstable_file_id_, 
-                             cell->table_id_, data_buf, data_size);
+        if (reader->get_sstable_id().sstable_file_id_ == last_sstable_id_
+            && block_pos_.offset_ == last_block_offset_)
+        {
+          //the block is just decoded for previous row, reuse it
+          data_buf = uncomp_buf_.get_buffer();
+          data_size = last_block_data_size_;
+        }
+        else
+        {
+          ret = get_block_data(reader->get_sstable_id().sstable_file_id_, 
+                               cell->table_id_, data_buf, data_size);
+        }
       }
 
       if (OB_SUCCESS == ret)
@@ -1140,5 +1181,134 @@ namespace oceanbase
 
       return ret;
     }
+
+    bool ObSSTableGetter::is_batch_block_ready(const uint64_t column_group_id) const
+    {
+      return (NULL != batch_blocks_ && OB_INVALID_ID != column_group_id
+              && batch_blocks_[cur_reader_idx_].column_group_id_ == column_group_id);
+    }
+
+    int ObSSTableGetter::prefetch_blocks()
+    {
+      int ret                 = OB_SUCCESS;
+      int status              = OB_SUCCESS;
+      int64_t* sorted_rows    = NULL;
+      int64_t sorted_count    = 0;
+      int64_t prefetch_count  = 0;
+      const ObCellInfo* cell  = NULL;
+      const ObSSTableReader* reader = NULL;
+      const ObGetParam::ObRowIndex* row_index = get_param_->get_row_index();
+      ObBlockIndexPositionInfo info;
+      ObSSTableRowCacheValue row_cache_val;
+      ObRowkey look_key;
+
+      batch_blocks_ = NULL;
+      ret = batch_buf_.ensure_space(readers_size_ * (sizeof(BatchRowBlock) + sizeof(int64_t)), 
+                                    ObModIds::OB_SSTABLE_GET_SCAN);
+      if (OB_SUCCESS != ret)
+      {
+        TBSYS_LOG(WARN, "failed to ensure space for batch get, row_count=%ld", readers_size_);
+      }
+      else
+      {
+        batch_blocks_ = reinterpret_cast<BatchRowBlock*>(batch_buf_.get_buffer());
+        sorted_rows = reinterpret_cast<int64_t*>(batch_buf_.get_buffer() 
+                                                 + readers_size_ * sizeof(BatchRowBlock));
+        for (int64_t i = 0; i < readers_size_; ++i)
+        {
+          BatchRowBlock& block = batch_blocks_[i];
+          block.column_group_id_ = OB_INVALID_ID;
+          reader = readers_[i];
+          cell = (*get_param_)[row_index[i].offset_];
+          cur_reader_idx_ = i;
+          if (NULL == reader || NULL == cell)
+          {
+            //row doesn't exist in this tablet
+          }
+          else if (OB_SUCCESS != (status = filter_column_group()))
+          {
+            //let load_cur_block() handle it
+          }
+          else
+          {
+            look_key = cell->row_key_;
+            block.sstable_id_ = reader->get_sstable_id().sstable_file_id_;
+            block.table_id_ = cell->table_id_;
+            block.column_group_id_ = column_group_[0];
+
+            if (NULL != sstable_row_cache_)
+            {
+              ObSSTableRowCacheKey row_cache_key(block.sstable_id_, block.column_group_id_, look_key);
+              if (OB_SSTABLE_STORE_SPARSE == reader->get_trailer().get_row_value_store_style())
+              {
+                row_cache_key.table_id_ = static_cast<uint32_t>(block.table_id_);
+              }
+              if (OB_SUCCESS == sstable_row_cache_->get_row(row_cache_key, row_cache_val, row_buf_))
+              {
+                //row in row cache, needn't read block
+                block.column_group_id_ = OB_INVALID_ID;
+              }
+            }
+          }
+
+          if (OB_INVALID_ID != block.column_group_id_)
+          {
+            info.sstable_file_id_ = block.sstable_id_;
+            info.offset_ = reader->get_trailer().get_block_index_record_offset();
+            info.size_   = reader->get_trailer().get_block_index_record_size();
+            block.ret_ = block_index_cache_->get_single_block_pos_info(
+              info, block.table_id_, block.column_group_id_, look_key, 
+              OB_SEARCH_MODE_GREATER_EQUAL, block.pos_);
+            if (OB_SUCCESS == block.ret_)
+            {
+              sorted_rows[sorted_count++] = i;
+            }
+            else if (OB_BEYOND_THE_RANGE != block.ret_)
+            {
+              //look up again when load block
+              block.column_group_id_ = OB_INVALID_ID;
+            }
+          }
+        }
+
+        //restore the state of the first row, init() filters column group of it
+        cur_reader_idx_ = 0;
+        column_group_num_ = 0;
+        cur_column_group_idx_ = 0;
+
+        //read blocks in file order, each distinct block once
+        std::sort(sorted_rows, sorted_rows + sorted_count, BatchRowBlockCompare(batch_blocks_));
+        status = OB_SUCCESS;
+        for (int64_t i = 0; i < sorted_count && OB_NOT_SUPPORTED != status; ++i)
+        {
+          const BatchRowBlock& block = batch_blocks_[sorted_rows[i]];
+          if (i > 0 && block.sstable_id_ == batch_blocks_[sorted_rows[i - 1]].sstable_id_
+              && block.pos_.offset_ == batch_blocks_[sorted_rows[i - 1]].pos_.offset_)
+          {
+            //same block as previous row
+          }
+          else
+          {
+            status = block_cache_->prefetch_block(block.sstable_id_, block.pos_.offset_, 
+                                                  block.pos_.size_, block.table_id_);
+            if (OB_SUCCESS == status)
+            {
+              ++prefetch_count;
+            }
+            else if (OB_NOT_SUPPORTED != status)
+            {
+              TBSYS_LOG(WARN, "failed to prefetch block, sstable_id=%lu, offset=%ld, "
+                              "size=%ld, status=%d", 
+                        block.sstable_id_, block.pos_.offset_, block.pos_.size_, status);
+            }
+          }
+        }
+        TBSYS_LOG(DEBUG, "batch get prefetch blocks, row_count=%ld, "
+                         "located_row_count=%ld, prefetch_count=%ld",
+                  readers_size_, sorted_count, prefetch_count);
+      }
+
+      return ret;
+    }
   }//end namespace sstable
 }//end namespace oceanbase
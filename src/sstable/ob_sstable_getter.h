@@ -182,6 +182,22 @@ namespace oceanbase
                               const uint64_t column_group_id);
       int filter_column_group();
 
+      /**
+       * batch get, if there are many rows to get, look up the block 
+       * of each row by block index cache in advance, sort the blocks 
+       * by sstable and offset, then submit one async read for each 
+       * distinct block which isn't in block cache. the rows are 
+       * still returned in the order of get param, but the block 
+       * reads are issued together and adjacent blocks are merged by 
+       * disk io engine, and the block position of each row needn't 
+       * be looked up again when load block. 
+       * 
+       * @return int if success, return OB_SUCCESS, else return 
+       *         OB_ERROR
+       */
+      int prefetch_blocks();
+      bool is_batch_block_ready(const uint64_t column_group_id) const;
+
     private:
       enum ObGetterIterState
       {
@@ -191,8 +207,30 @@ namespace oceanbase
         ITERATE_END
       };
 
+      struct BatchRowBlock
+      {
+        uint64_t sstable_id_;
+        uint64_t table_id_;
+        uint64_t column_group_id_;  //OB_INVALID_ID if block isn't looked up
+        int ret_;                   //result of looking up block index
+        ObBlockPositionInfo pos_;
+      };
+
+      struct BatchRowBlockCompare
+      {
+        explicit BatchRowBlockCompare(const BatchRowBlock* blocks) : blocks_(blocks) {}
+        bool operator()(const int64_t lhs, const int64_t rhs) const
+        {
+          return (blocks_[lhs].sstable_id_ < blocks_[rhs].sstable_id_
+                  || (blocks_[lhs].sstable_id_ == blocks_[rhs].sstable_id_
+                      && blocks_[lhs].pos_.offset_ < blocks_[rhs].pos_.offset_));
+        }
+        const BatchRowBlock* blocks_;
+      };
+
     private:
       static const int64_t DEFAULT_UNCOMP_BUF_SIZE  = 128 * 1024; //128k
+      static const int64_t MIN_BATCH_GET_ROW_COUNT  = 8;
       static const int64_t DEFAULT_ROW_BUF_SIZE     = 64 * 1024; //64k
       static const int64_t MAX_GET_COLUMN_COUNT_PRE_ROW = common::ObGetParam::MAX_CELLS_PER_ROW;
 
@@ -224,6 +262,13 @@ namespace oceanbase
       ObBlockIndexCache* block_index_cache_; //block index cache
       ObSSTableRowCache* sstable_row_cache_; //sstable row cache
 
+      BatchRowBlock* batch_blocks_;     //block of each row for batch get
+      common::ObMemBuf batch_buf_;      //buffer for batch_blocks_
+
+      uint64_t last_sstable_id_;        //sstable id of block in uncomp_buf_
+      int64_t last_block_offset_;       //offset of block in uncomp_buf_, -1 if none
+      int64_t last_block_data_size_;    //uncompressed size of block in uncomp_buf_
+
       common::ObMemBuf uncomp_buf_;     //uncompressed buffer
       common::ObMemBuf row_buf_;     //sstable row data buffer
       common::ObObj rowkey_obj_array_[common::OB_MAX_ROWKEY_COLUMN_NUMBER];
@@ -17,6 +17,7 @@
 #include "ob_trans_executor.h"
 #include "ob_session_guard.h"
 #include "ob_ups_utils.h"
+#include "common/ob_log_compressor.h"
 
 namespace oceanbase
 {
@@ -31,7 +32,7 @@ namespace oceanbase
                       end_flush_time_us_ - start_flush_time_us_);
     }
 
-    ObLogTask::ObLogTask(): log_id_(0), barrier_log_id_(0),
+    ObLogTask::ObLogTask(): log_id_(0), barrier_log_id_(0), row_barrier_log_id_(0),
                             log_entry_(), log_data_(NULL), batch_buf_(NULL), batch_buf_len_(0),
                             trans_id_(), mutation_ts_(0),
                             checksum_before_mutate_(0), checksum_after_mutate_(0),
@@ -46,6 +47,7 @@ namespace oceanbase
     {
       log_id_ = 0;
       barrier_log_id_ = 0;
+      row_barrier_log_id_ = 0;
       new(&log_entry_)ObLogEntry;
       log_data_ = NULL;
       batch_buf_ = NULL;
@@ -117,11 +119,9 @@ namespace oceanbase
       return err;
     }
 
-    int ObAsyncLogApplier::handle_normal_mutator(ObLogTask& task)
+    int ObAsyncLogApplier::handle_normal_mutator(ObLogTask& task, const char* log_data, const int64_t data_len)
     {
       int err = OB_SUCCESS;
-      const char* log_data = task.log_data_;
-      const int64_t data_len = task.log_entry_.get_log_data_len();
       int64_t pos = 0;
       RPSessionCtx *session_ctx = NULL;
       SessionGuard session_guard(*session_mgr_, *lock_mgr_, err);
@@ -197,8 +197,8 @@ namespace oceanbase
       int err = OB_SUCCESS;
       ObUpsMutator *mutator = GET_TSI_MULT(ObUpsMutator, 1);
       CommonSchemaManagerWrapper *schema = GET_TSI_MULT(CommonSchemaManagerWrapper, 1);
-      const char* log_data = task.log_data_;
-      const int64_t data_len = task.log_entry_.get_log_data_len();
+      const char* log_data = NULL;
+      int64_t data_len = 0;
       LogCommand cmd = (LogCommand)task.log_entry_.cmd_;
       int64_t pos = 0;
       int64_t file_id = 0;
@@ -222,6 +222,10 @@ namespace oceanbase
         err = OB_EAGAIN;
         usleep(1000000);
       }
+      else if (OB_SUCCESS != (err = get_log_data(task.log_entry_, task.log_data_, log_data, data_len)))
+      {
+        TBSYS_LOG(ERROR, "get_log_data(log_id=%ld)=>%d", task.log_id_, err);
+      }
       else
       {
         switch(cmd)
@@ -233,7 +237,7 @@ namespace oceanbase
             }
             else if (mutator->is_normal_mutator())
             {
-              if (OB_SUCCESS != (err = handle_normal_mutator(task)))
+              if (OB_SUCCESS != (err = handle_normal_mutator(task, log_data, data_len)))
               {
                 TBSYS_LOG(WARN, "fail to handle normal mutator. err=%d", err);
               }
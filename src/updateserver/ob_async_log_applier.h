@@ -76,7 +76,8 @@ namespace oceanbase
       int64_t to_string(char* buf, const int64_t buf_len) const
       {
         int64_t pos = 0;
-        databuff_printf(buf, buf_len, pos, "[LogTask] log_id=%ld barrier_log_id=%ld trans_id=%s", log_id_, barrier_log_id_, to_cstring(trans_id_));
+        databuff_printf(buf, buf_len, pos, "[LogTask] log_id=%ld barrier_log_id=%ld row_barrier_log_id=%ld trans_id=%s",
+                        log_id_, barrier_log_id_, row_barrier_log_id_, to_cstring(trans_id_));
         pos += log_entry_.to_string(buf + pos, buf_len - pos);
 
         databuff_printf(buf, buf_len, pos, " log_data=%p batch_buf=%p batch_buf_len_=%ld ", log_data_, batch_buf_, batch_buf_len_);
@@ -90,6 +91,8 @@ namespace oceanbase
 
       volatile int64_t log_id_;
       volatile int64_t barrier_log_id_;
+      // 按行回放时最近一条修改过相同行的日志, 要等它apply完成
+      volatile int64_t row_barrier_log_id_;
       ObLogEntry log_entry_;
       const char* log_data_;
       const char* batch_buf_;
@@ -140,7 +143,7 @@ namespace oceanbase
       private:
         bool is_memory_warning();
         int add_memtable_uncommited_checksum_(const uint32_t session_descriptor, uint64_t *ret_checksum);
-        int handle_normal_mutator(ObLogTask& task);
+        int handle_normal_mutator(ObLogTask& task, const char* log_data, const int64_t data_len);
         bool is_inited() const;
       private:
         bool inited_;
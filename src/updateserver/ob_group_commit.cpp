@@ -0,0 +1,91 @@
+////===================================================================
+ //
+ // ob_group_commit.cpp updateserver / Oceanbase
+ //
+ // Copyright (C) 2010, 2013 Taobao.com, Inc.
+ //
+ // -------------------------------------------------------------------
+ //
+ // Description
+ //
+ //
+ // -------------------------------------------------------------------
+ //
+ // Change Log
+ //
+////====================================================================
+
+#include <algorithm>
+#include "ob_group_commit.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    GroupCommitWindow::GroupCommitWindow() : last_arrive_time_(0),
+                                             avg_arrive_interval_(0),
+                                             avg_flush_time_(0),
+                                             avg_batch_size_(0)
+    {
+    }
+
+    GroupCommitWindow::~GroupCommitWindow()
+    {
+    }
+
+    void GroupCommitWindow::reset()
+    {
+      last_arrive_time_ = 0;
+      avg_arrive_interval_ = 0;
+      avg_flush_time_ = 0;
+      avg_batch_size_ = 0;
+    }
+
+    void GroupCommitWindow::on_arrive(const int64_t cur_time)
+    {
+      if (0 < last_arrive_time_
+          && cur_time >= last_arrive_time_)
+      {
+        int64_t interval = cur_time - last_arrive_time_;
+        interval = (MAX_ARRIVE_INTERVAL < interval) ? MAX_ARRIVE_INTERVAL : interval;
+        avg_arrive_interval_ = ewma_(avg_arrive_interval_, std::max(interval, 1L));
+      }
+      last_arrive_time_ = cur_time;
+    }
+
+    void GroupCommitWindow::on_flush(const int64_t batch_size, const int64_t flush_time)
+    {
+      if (0 < batch_size)
+      {
+        avg_flush_time_ = ewma_(avg_flush_time_, std::max(flush_time, 1L));
+        avg_batch_size_ = ewma_(avg_batch_size_, batch_size);
+      }
+    }
+
+    int64_t GroupCommitWindow::calc_wait_time(const int64_t batch_size,
+                                              const int64_t max_batch_size,
+                                              const int64_t max_wait_time) const
+    {
+      int64_t wait_time = 0;
+      if (0 >= max_wait_time
+          || 0 >= avg_arrive_interval_
+          || 0 >= avg_flush_time_
+          || batch_size >= max_batch_size)
+      {
+        wait_time = 0;
+      }
+      else if (avg_arrive_interval_ >= avg_flush_time_)
+      {
+        // 一次fsync期间预期到达的事务不足一个, 等待只会增加延迟
+        wait_time = 0;
+      }
+      else
+      {
+        // 等待时间不超过一次fsync的耗时, 也不超过把batch填满所需的时间
+        wait_time = std::min(max_wait_time, avg_flush_time_);
+        wait_time = std::min(wait_time, (max_batch_size - batch_size) * avg_arrive_interval_);
+      }
+      return wait_time;
+    }
+  }
+}
@@ -0,0 +1,64 @@
+////===================================================================
+ //
+ // ob_group_commit.h updateserver / Oceanbase
+ //
+ // Copyright (C) 2010, 2013 Taobao.com, Inc.
+ //
+ // -------------------------------------------------------------------
+ //
+ // Description
+ //
+ // 根据事务到达间隔和刷commit log(fsync)的耗时, 估算commit线程在
+ // 队列为空时还值得为当前batch等待多久, 以便更多的事务合并到同一次
+ // write_log + fsync中; 低负载时窗口为0, 不增加延迟
+ //
+ // -------------------------------------------------------------------
+ //
+ // Change Log
+ //
+////====================================================================
+
+#ifndef  OCEANBASE_UPDATESERVER_GROUP_COMMIT_H_
+#define  OCEANBASE_UPDATESERVER_GROUP_COMMIT_H_
+#include "common/ob_define.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    // 只在commit线程中使用, 不需要加锁
+    class GroupCommitWindow
+    {
+      static const int64_t EWMA_SHIFT = 3;
+      static const int64_t MAX_ARRIVE_INTERVAL = 1000000;
+      public:
+        GroupCommitWindow();
+        ~GroupCommitWindow();
+      public:
+        void reset();
+        // 每个写事务进入commit线程时调用
+        void on_arrive(const int64_t cur_time);
+        // 每次flush commit log之后调用
+        void on_flush(const int64_t batch_size, const int64_t flush_time);
+        // 返回当前batch从第一个事务开始计算最多还应等待的时间, 0表示立即提交
+        int64_t calc_wait_time(const int64_t batch_size,
+                               const int64_t max_batch_size,
+                               const int64_t max_wait_time) const;
+        int64_t get_avg_arrive_interval() const {return avg_arrive_interval_;};
+        int64_t get_avg_flush_time() const {return avg_flush_time_;};
+        int64_t get_avg_batch_size() const {return avg_batch_size_;};
+      private:
+        static inline int64_t ewma_(const int64_t avg, const int64_t value)
+        {
+          return (0 == avg) ? value : (avg + ((value - avg) >> EWMA_SHIFT));
+        };
+      private:
+        int64_t last_arrive_time_;
+        int64_t avg_arrive_interval_;
+        int64_t avg_flush_time_;
+        int64_t avg_batch_size_;
+    };
+  }
+}
+
+#endif //OCEANBASE_UPDATESERVER_GROUP_COMMIT_H_
@@ -13,6 +13,7 @@
  */
 #include "ob_log_replay_worker.h"
 #include "ob_ups_log_utils.h"
+#include "common/ob_log_compressor.h"
 
 namespace oceanbase
 {
@@ -21,16 +22,31 @@ namespace oceanbase
     ObLogReplayWorker::ObLogReplayWorker(): n_worker_(0), queue_len_(0),
                                             flying_trans_no_limit_(0),
                                             log_applier_(NULL), apply_worker_(*this),
+                                            replay_by_row_(false), row_slot_log_id_(NULL),
+                                            applied_log_id_(NULL),
                                             replay_cursor_(), err_(OB_SUCCESS),
                                             next_submit_log_id_(0), next_commit_log_id_(0),
-                                            next_flush_log_id_(0), last_barrier_log_id_(0)
+                                            next_flush_log_id_(0), last_barrier_log_id_(0),
+                                            next_row_log_id_(0)
     {}
 
     ObLogReplayWorker::~ObLogReplayWorker()
-    {}
+    {
+      if (NULL != row_slot_log_id_)
+      {
+        ob_free(row_slot_log_id_);
+        row_slot_log_id_ = NULL;
+      }
+      if (NULL != applied_log_id_)
+      {
+        ob_free((void*)applied_log_id_);
+        applied_log_id_ = NULL;
+      }
+    }
 
     int ObLogReplayWorker::init(IAsyncLogApplier* log_applier, const int32_t n_worker,
-                                const int64_t log_buf_limit, const int64_t queue_len)
+                                const int64_t log_buf_limit, const int64_t queue_len,
+                                const bool replay_by_row)
     {
       int err = OB_SUCCESS;
       if (NULL == log_applier || n_worker <= 0 || n_worker > MAX_N_WORKER || log_buf_limit < 0 || queue_len <= 0)
@@ -53,8 +69,29 @@ namespace oceanbase
       {
         TBSYS_LOG(ERROR, "commit_queue_.init(%ld)=>%d", queue_len, err);
       }
+      else if (replay_by_row
+               && NULL == (row_slot_log_id_ = (int64_t*)ob_malloc(sizeof(int64_t) * ROW_SLOT_NUM, ObModIds::OB_UPS_LOG_REPLAY_WORKER)))
+      {
+        err = OB_ALLOCATE_MEMORY_FAILED;
+        TBSYS_LOG(ERROR, "ob_malloc(row_slot_num=%ld) failed", ROW_SLOT_NUM);
+      }
+      else if (replay_by_row
+               && NULL == (applied_log_id_ = (int64_t*)ob_malloc(sizeof(int64_t) * queue_len, ObModIds::OB_UPS_LOG_REPLAY_WORKER)))
+      {
+        err = OB_ALLOCATE_MEMORY_FAILED;
+        TBSYS_LOG(ERROR, "ob_malloc(queue_len=%ld) failed", queue_len);
+      }
       else
       {
+        if (NULL != row_slot_log_id_)
+        {
+          memset(row_slot_log_id_, 0, sizeof(int64_t) * ROW_SLOT_NUM);
+        }
+        if (NULL != applied_log_id_)
+        {
+          memset((void*)applied_log_id_, 0, sizeof(int64_t) * queue_len);
+        }
+        replay_by_row_ = replay_by_row;
         n_worker_ = n_worker;
         queue_len_ = queue_len;
         flying_trans_no_limit_ = queue_len;
@@ -67,7 +104,8 @@ namespace oceanbase
       }
       else
       {
-        TBSYS_LOG(INFO, "log_replay_worker.init(log_applier=%p, n_worker=%d): success", log_applier, n_worker);
+        TBSYS_LOG(INFO, "log_replay_worker.init(log_applier=%p, n_worker=%d, replay_by_row=%s): success",
+                  log_applier, n_worker, STR_BOOL(replay_by_row));
       }
       return err;
     }
@@ -113,6 +151,7 @@ namespace oceanbase
       else
       {
         last_barrier_log_id_ = cursor.log_id_ - 1;
+        next_row_log_id_ = cursor.log_id_;
         next_submit_log_id_ = cursor.log_id_;
         set_next_commit_log_id(cursor.log_id_);
         set_next_flush_log_id(cursor.log_id_);
@@ -307,19 +346,39 @@ namespace oceanbase
       }
       else
       {
-        while(!_stop && OB_SUCCESS == err_ && OB_EAGAIN == (err = replay(*task)))
-          ;
-        if (OB_SUCCESS != err && OB_EAGAIN != err)
+        if (replay_by_row_ && OB_SUCCESS != (err = set_row_barrier(*task)))
         {
-          err_ = err;
-          TBSYS_LOG(ERROR, "replay()=>%d", err);
+          if (OB_CANCELED != err)
+          {
+            err_ = err;
+            TBSYS_LOG(ERROR, "set_row_barrier(log_id=%ld)=>%d", task->log_id_, err);
+          }
+        }
+        else
+        {
+          while(!_stop && OB_SUCCESS == err_ && OB_EAGAIN == (err = replay(*task)))
+            ;
+          if (OB_SUCCESS != err && OB_EAGAIN != err)
+          {
+            err_ = err;
+            TBSYS_LOG(ERROR, "replay()=>%d", err);
+          }
         }
-        while(!_stop && OB_SUCCESS == err_ && OB_EAGAIN == (err = commit_queue_.add(task->log_id_, (void*)task)))
-          ;
-        if (OB_SUCCESS != err && OB_EAGAIN != err)
+        if (OB_SUCCESS == err)
         {
-          err_ = err;
-          TBSYS_LOG(ERROR, "commit_queue.add(%ld, %p)=>%d", task->log_id_, task, err);
+          if (NULL != applied_log_id_)
+          {
+            // 加入提交队列之后task可能被释放, 要在这之前标记apply完成
+            __sync_synchronize();
+            applied_log_id_[task->log_id_ % queue_len_] = task->log_id_;
+          }
+          while(!_stop && OB_SUCCESS == err_ && OB_EAGAIN == (err = commit_queue_.add(task->log_id_, (void*)task)))
+            ;
+          if (OB_SUCCESS != err && OB_EAGAIN != err)
+          {
+            err_ = err;
+            TBSYS_LOG(ERROR, "commit_queue.add(%ld, %p)=>%d", task->log_id_, task, err);
+          }
         }
       }
       return err;
@@ -330,6 +389,13 @@ namespace oceanbase
       return log_id < next_commit_log_id_;
     }
 
+    bool ObLogReplayWorker::is_task_applied(const int64_t log_id) const
+    {
+      // 槽位被后面的日志覆盖时log_id一定已经提交了
+      return is_task_commited(log_id)
+        || (NULL != applied_log_id_ && log_id == applied_log_id_[log_id % queue_len_]);
+    }
+
     bool ObLogReplayWorker::is_task_flushed(const int64_t log_id) const
     {
       return log_id < next_flush_log_id_;
@@ -374,6 +440,11 @@ namespace oceanbase
       {
         err = OB_EAGAIN;
       }
+      else if (!is_task_applied(task.row_barrier_log_id_))
+      {
+        // 回放不加行锁, 修改相同行的前一条日志apply完成就可以apply, 不用等它提交
+        err = OB_EAGAIN;
+      }
       else if (OB_SUCCESS != (err = log_applier_->start_transaction(task)))
       {
         TBSYS_LOG(ERROR, "log_applier->start_transaction()=>%d", err);
@@ -416,6 +487,118 @@ namespace oceanbase
       return err;
     }
 
+    int ObLogReplayWorker::get_row_slots(ObSEArray<int64_t, 64>& row_slots, const char* buf, const int64_t len)
+    {
+      int err = OB_SUCCESS;
+      ObUpsMutator* mutator = GET_TSI_MULT(ObUpsMutator, TSI_UPS_UPS_MUTATOR_2);
+      ObMutatorCellInfo* cell = NULL;
+      bool is_row_changed = false;
+      bool is_row_finished = false;
+      int64_t pos = 0;
+      row_slots.clear();
+      if (NULL == mutator)
+      {
+        err = OB_ALLOCATE_MEMORY_FAILED;
+      }
+      else if (OB_SUCCESS != (err = mutator->deserialize(buf, len, pos)))
+      {
+        TBSYS_LOG(ERROR, "mutator.deserialize(buf=%p[%ld])=>%d", buf, len, err);
+      }
+      else
+      {
+        ObMutator& cell_mutator = mutator->get_mutator();
+        cell_mutator.reset_iter();
+        while (OB_SUCCESS == err
+               && OB_SUCCESS == (err = cell_mutator.next_cell()))
+        {
+          if (OB_SUCCESS != (err = cell_mutator.get_cell(&cell, &is_row_changed, &is_row_finished)))
+          {
+            TBSYS_LOG(ERROR, "mutator.get_cell()=>%d", err);
+          }
+          else if (NULL == cell)
+          {
+            err = OB_ERR_UNEXPECTED;
+          }
+          else if (is_row_changed)
+          {
+            uint64_t sign = cell->cell_info.row_key_.murmurhash2((uint32_t)cell->cell_info.table_id_);
+            if (OB_SUCCESS != (err = row_slots.push_back((int64_t)(sign % ROW_SLOT_NUM))))
+            {
+              TBSYS_LOG(ERROR, "row_slots.push_back()=>%d", err);
+            }
+          }
+        }
+        if (OB_ITER_END == err)
+        {
+          err = OB_SUCCESS;
+        }
+      }
+      return err;
+    }
+
+    int ObLogReplayWorker::set_row_barrier(ObLogTask& task)
+    {
+      int err = OB_SUCCESS;
+      ObSEArray<int64_t, 64> row_slots;
+      bool is_barrier = true;
+      int64_t row_barrier_log_id = 0;
+      const char* log_data = NULL;
+      int64_t data_len = 0;
+      // 解压和反序列化不依赖其它日志, 各个apply线程并行做
+      if (NULL == row_slot_log_id_)
+      {
+        err = OB_NOT_INIT;
+      }
+      else if (OB_SUCCESS != (err = get_log_data(task.log_entry_, task.log_data_, log_data, data_len)))
+      {
+        TBSYS_LOG(ERROR, "get_log_data(log_id=%ld)=>%d", task.log_id_, err);
+      }
+      else if (OB_SUCCESS != (err = is_barrier_log(is_barrier, (LogCommand)task.log_entry_.cmd_, log_data, data_len)))
+      {
+        TBSYS_LOG(ERROR, "is_barrier_log(log_id=%ld)=>%d", task.log_id_, err);
+      }
+      else if (!is_barrier && OB_LOG_UPS_MUTATOR == task.log_entry_.cmd_
+               && OB_SUCCESS != (err = get_row_slots(row_slots, log_data, data_len)))
+      {
+        TBSYS_LOG(ERROR, "get_row_slots(log_id=%ld)=>%d", task.log_id_, err);
+      }
+      // 槽位要按日志顺序读写, 每个apply线程按提交顺序取task, 前面的日志不会等后面的日志
+      while (OB_SUCCESS == err && next_row_log_id_ != task.log_id_)
+      {
+        if (_stop || OB_SUCCESS != err_)
+        {
+          err = OB_CANCELED;
+        }
+      }
+      if (OB_SUCCESS == err)
+      {
+        for (int64_t i = 0; i < row_slots.count(); i++)
+        {
+          if (row_slot_log_id_[row_slots.at(i)] > row_barrier_log_id)
+          {
+            row_barrier_log_id = row_slot_log_id_[row_slots.at(i)];
+          }
+        }
+        for (int64_t i = 0; i < row_slots.count(); i++)
+        {
+          row_slot_log_id_[row_slots.at(i)] = task.log_id_;
+        }
+        if (is_barrier)
+        {
+          task.barrier_log_id_ = task.log_id_ - 1;
+          last_barrier_log_id_ = task.log_id_;
+        }
+        else
+        {
+          task.barrier_log_id_ = last_barrier_log_id_;
+        }
+        task.row_barrier_log_id_ = row_barrier_log_id;
+        __sync_synchronize();
+        next_row_log_id_ = task.log_id_ + 1;
+      }
+      return err;
+    }
+
     int64_t ObLogReplayWorker::get_replayed_log_id() const
     {
       return next_commit_log_id_;
@@ -427,6 +610,8 @@ namespace oceanbase
       int64_t new_pos = pos;
       bool check_integrity = true;
       bool is_barrier = true;
+      const char* log_data = NULL;
+      int64_t data_len = 0;
       //TBSYS_LOG(INFO, "submit(task.log_id[%ld], next_submit_log_id[%ld], next_commit_log_id[%ld])", task.log_id_, next_submit_log_id_, next_commit_log_id_);
       if (_stop)
       {
@@ -465,15 +650,25 @@ namespace oceanbase
                   next_commit_log_id_, flying_trans_no_limit_, task.log_entry_.seq_);
 
       }
-      else if (OB_SUCCESS != (err = is_barrier_log(is_barrier, (LogCommand)task.log_entry_.cmd_,
-                                                   buf + new_pos, task.log_entry_.get_log_data_len())))
+      else if (!replay_by_row_ && OB_SUCCESS != (err = get_log_data(task.log_entry_, buf + new_pos, log_data, data_len)))
+      {
+        TBSYS_LOG(ERROR, "get_log_data(log_id=%ld)=>%d", task.log_entry_.seq_, err);
+      }
+      else if (!replay_by_row_ && OB_SUCCESS != (err = is_barrier_log(is_barrier, (LogCommand)task.log_entry_.cmd_,
+                                                                     log_data, data_len)))
       {
         TBSYS_LOG(ERROR, "is_barrier_log()=>%d", err);
       }
       else
       {
         ObLogEntry entry = task.log_entry_;
-        if (is_barrier)
+        if (replay_by_row_)
+        {
+          // 按行模式下barrier由apply线程调用set_row_barrier()设置
+          is_barrier = false;
+          task.barrier_log_id_ = 0;
+        }
+        else if (is_barrier)
         {
           task.barrier_log_id_ = task.log_entry_.seq_ - 1;
         }
@@ -481,6 +676,7 @@ namespace oceanbase
         {
           task.barrier_log_id_ = last_barrier_log_id_;
         }
+        task.row_barrier_log_id_ = 0;
         task.trans_id_.reset();
         task.log_data_ = buf + new_pos;
         task.replay_type_ = replay_type;
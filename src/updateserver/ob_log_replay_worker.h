@@ -15,6 +15,7 @@
 #define __OB_UPDATESERVER_OB_LOG_REPLAY_WORKER_H__
 #include "common/ob_log_entry.h"
 #include "common/ob_seq_queue.h"
+#include "common/ob_se_array.h"
 #include "ob_queue_thread.h"
 #include "ob_fifo_allocator.h"
 #include "ob_ups_table_mgr.h"
@@ -51,11 +52,13 @@ namespace oceanbase
         const static int64_t MAX_N_WORKER = 256;
         const static int64_t CHECK_SUM_BUF_SIZE = 1<<16;
         const static int64_t MAX_LOG_BUF_SIZE = 1<<22;
+        const static int64_t ROW_SLOT_NUM = 1<<16;
       public:
         ObLogReplayWorker();
         virtual ~ObLogReplayWorker();
         int init(IAsyncLogApplier* log_applier, const int32_t n_thread,
-                 const int64_t log_buf_limit, const int64_t queue_len);
+                 const int64_t log_buf_limit, const int64_t queue_len,
+                 const bool replay_by_row = false);
         virtual void run(tbsys::CThread* thread, void* arg);
         int64_t to_string(char* buf, const int64_t len) const;
       protected:
@@ -90,6 +93,10 @@ namespace oceanbase
         int do_commit(int64_t thread_id);
         int do_replay(int64_t thread_id);
         int replay(ObLogTask& task);
+        // 按行模式下在apply线程里解析日志, 再按日志顺序计算task的barrier和依赖的最近一条修改过相同行的日志
+        int set_row_barrier(ObLogTask& task);
+        int get_row_slots(common::ObSEArray<int64_t, 64>& row_slots, const char* buf, const int64_t len);
+        bool is_task_applied(const int64_t log_id) const;
       private:
         DISALLOW_COPY_AND_ASSIGN(ObLogReplayWorker);
       private:
@@ -100,6 +107,10 @@ namespace oceanbase
         common::ObResourcePool<ObLogTask, 0, 1<<16> task_pool_;
         IAsyncLogApplier* log_applier_;
         ApplyWorker apply_worker_;
+        bool replay_by_row_;
+        int64_t* row_slot_log_id_;
+        // 按log_id % queue_len_记录apply完成的日志
+        volatile int64_t* applied_log_id_;
         ObSeqQueue commit_queue_;
         ObLogCursor replay_cursor_;
         tbsys::CThreadCond commit_log_id_cond_;
@@ -110,6 +121,7 @@ namespace oceanbase
         volatile int64_t next_commit_log_id_;
         volatile int64_t next_flush_log_id_;
         volatile int64_t last_barrier_log_id_;
+        volatile int64_t next_row_log_id_;
     };
   }; // end namespace updateserver
 }; // end namespace oceanbase
@@ -30,6 +30,7 @@ namespace oceanbase
     using namespace hash;
 
     MemTable::MemTable() : inited_(false), mem_tank_(), table_engine_(mem_tank_), table_bf_(),
+                           frozen_bf_(), frozen_bf_built_(false),
                            version_(0), ref_cnt_(0),
                            checksum_before_mutate_(0), checksum_after_mutate_(0),
                            checksum_(0),
@@ -38,7 +39,8 @@ namespace oceanbase
                            trans_mgr_(),
                            row_counter_(0),
                            tevalue_cb_(),
-                           trans_cb_()
+                           trans_cb_(),
+                           row_modify_tracker_(NULL)
     {
       MIN_OBJ.set_min_value();
       MAX_OBJ.set_max_value();
@@ -98,6 +100,8 @@ namespace oceanbase
         checksum_ = 0;
         uncommited_checksum_ = 0;
         table_bf_.destroy();
+        frozen_bf_built_ = false;
+        frozen_bf_.destroy();
         table_engine_.destroy();
         mem_tank_.clear();
         inited_ = false;
@@ -179,6 +183,7 @@ namespace oceanbase
           uci.uc_list_tail->next = node;
         }
         uci.uc_list_tail = node;
+        uci.uc_list_node_cnt = add_list_node_cnt(uci.uc_list_node_cnt, 1);
       }
       return ret;
     }
@@ -207,6 +212,7 @@ namespace oceanbase
           value.list_tail->next = node;
         }
         value.list_tail = node;
+        value.list_node_cnt = add_list_node_cnt(value.list_node_cnt, 1);
       }
       return ret;
     }
@@ -396,6 +402,11 @@ namespace oceanbase
           {
             cur_uci->value = cur_value;
             cur_uci->session_descriptor = session.get_session_descriptor();
+            if (NULL != row_modify_tracker_)
+            {
+              cur_uci->modify_tracker = row_modify_tracker_;
+              cur_uci->modify_slot = get_row_modify_slot(cur_key.table_id, cur_key.row_key);
+            }
             cur_value->cur_uc_info = cur_uci;
             TBSYS_LOG(DEBUG, "alloc uc_info value=%p uc_info=%p", cur_uci->value, cur_value->cur_uc_info);
           }
@@ -520,13 +531,14 @@ namespace oceanbase
               session.flush_min_flying_trans_id();
             }
             if ((is_row_changed || is_row_finished)
-                && (get_max_row_cell_num() < cur_value->cell_info_cnt
-                    || MAX_ROW_SIZE < cur_value->cell_info_size))
+                && need_merge_(*cur_value)
+                && can_merge_(session.get_min_flying_trans_id(), *cur_value))
             {
               merge_(session, cur_key, *cur_value);
             }
             if (is_row_finished)
             {
+              stat_chain_len_(*cur_value);
               ccw.row_finish();
               ret = copy_cells_(*cur_uci, ccw);
               ccw.reset();
@@ -582,11 +594,11 @@ namespace oceanbase
             ccw.row_finish();
             ret = copy_cells_(tn, *cur_value, ccw);
             ccw.reset();
-            if (get_max_row_cell_num() < cur_value->cell_info_cnt
-                || MAX_ROW_SIZE < cur_value->cell_info_size)
+            if (need_merge_(*cur_value))
             {
               merge_(tn, cur_key, *cur_value);
             }
+            stat_chain_len_(*cur_value);
           }
           if (MAX_ROW_SIZE < cur_value->cell_info_size)
           {
@@ -652,6 +664,46 @@ namespace oceanbase
       return bret;
     }
 
+    bool MemTable::need_merge_(const TEValue &te_value)
+    {
+      int64_t max_row_node_num = get_max_row_node_num();
+      return (get_max_row_cell_num() < te_value.cell_info_cnt
+              || MAX_ROW_SIZE < te_value.cell_info_size
+              || (0 < max_row_node_num && max_row_node_num < te_value.list_node_cnt));
+    }
+
+    bool MemTable::can_merge_(const int64_t min_trans_id, const TEValue &te_value)
+    {
+      return (NULL != te_value.list_head
+              && NULL != te_value.list_head->next
+              && te_value.list_head->next->modify_time <= min_trans_id);
+    }
+
+    void MemTable::stat_chain_len_(const TEValue &te_value)
+    {
+      int64_t len = te_value.list_node_cnt;
+      if (1 >= len)
+      {
+        OB_STAT_INC(UPDATESERVER, UPS_STAT_ROW_CHAIN_LEN_1, 1);
+      }
+      else if (4 >= len)
+      {
+        OB_STAT_INC(UPDATESERVER, UPS_STAT_ROW_CHAIN_LEN_4, 1);
+      }
+      else if (16 >= len)
+      {
+        OB_STAT_INC(UPDATESERVER, UPS_STAT_ROW_CHAIN_LEN_16, 1);
+      }
+      else if (64 >= len)
+      {
+        OB_STAT_INC(UPDATESERVER, UPS_STAT_ROW_CHAIN_LEN_64, 1);
+      }
+      else
+      {
+        OB_STAT_INC(UPDATESERVER, UPS_STAT_ROW_CHAIN_LEN_INF, 1);
+      }
+    }
+
     int MemTable::merge_(RWSessionCtx &session,
                         const TEKey &te_key,
                         TEValue &te_value)
@@ -751,6 +803,7 @@ namespace oceanbase
             node->modify_time = mtime;
             new_value.list_head = node;
             new_value.list_tail = node;
+            new_value.list_node_cnt = 1;
           }
         }
       }
@@ -773,14 +826,25 @@ namespace oceanbase
           {
             new_value.list_tail = te_value.list_tail;
           }
+          bool is_committed = (new_value.list_tail != new_value.list_head);
           while (NULL != node
                 && node != new_value.list_tail)
           {
             std::pair<int64_t, int64_t> sc = node->get_size_and_cnt();
             new_value.cell_info_cnt = static_cast<int16_t>(new_value.cell_info_cnt + sc.first);
             new_value.cell_info_size = static_cast<int16_t>(new_value.cell_info_size + sc.second);
+            if (is_committed)
+            {
+              new_value.list_node_cnt = add_list_node_cnt(new_value.list_node_cnt, 1);
+            }
             node = node->next;
           }
+          if (is_committed
+              && NULL != node)
+          {
+            // list_tail本身
+            new_value.list_node_cnt = add_list_node_cnt(new_value.list_node_cnt, 1);
+          }
         }
         timeu = tbsys::CTimeUtil::getTime() - timeu;
         TBSYS_LOG(DEBUG, "merge te_value succ, key-value: [%s] [%s] ==> [%s] value=%p timeu=%ld",
@@ -893,6 +957,7 @@ namespace oceanbase
             node->modify_time = mtime;
             new_value.list_head = node;
             new_value.list_tail = node;
+            new_value.list_node_cnt = 1;
           }
         }
       }
@@ -916,6 +981,7 @@ namespace oceanbase
             std::pair<int64_t, int64_t> sc = node->get_size_and_cnt();
             new_value.cell_info_cnt = static_cast<int16_t>(new_value.cell_info_cnt + sc.first);
             new_value.cell_info_size = static_cast<int16_t>(new_value.cell_info_size + sc.second);
+            new_value.list_node_cnt = add_list_node_cnt(new_value.list_node_cnt, 1);
             node = node->next;
           }
         }
@@ -1444,10 +1510,8 @@ namespace oceanbase
       }
       if (OB_SUCCESS == ret && NULL == value)
       {
-        if (using_memtable_bloomfilter()
-            && !table_bf_.contain(table_id, row_key))
-        {} // 保持value=NULL, iterator迭代时可以处理
-        else
+        // bloomfilter判定不存在时保持value=NULL, iterator迭代时可以处理
+        if (row_may_exist_(table_id, row_key))
         {
           value = table_engine_.get(key);
         }
@@ -1485,8 +1549,7 @@ namespace oceanbase
         TBSYS_LOG(WARN, "get trans node fail td=%lu", td);
         ret = OB_ERROR;
       }
-      else if (using_memtable_bloomfilter()
-              && !table_bf_.contain(table_id, row_key))
+      else if (!row_may_exist_(table_id, row_key))
       {
         iterator.get_get_iter_().set_(key, NULL, column_filter, tn);
       }
@@ -1708,6 +1771,82 @@ namespace oceanbase
       return table_bf.deep_copy(table_bf_);
     }
 
+    int MemTable::build_frozen_bloomfilter()
+    {
+      int ret = OB_SUCCESS;
+      int64_t row_num = table_engine_.btree_size();
+      int64_t nbyte = row_num * FROZEN_BLOOM_FILTER_BITS_PER_ROW / CHAR_BIT + 1;
+      nbyte = (FROZEN_BLOOM_FILTER_MAX_NBYTE < nbyte) ? FROZEN_BLOOM_FILTER_MAX_NBYTE : nbyte;
+      int64_t timeu = tbsys::CTimeUtil::getTime();
+      TableEngineIterator iter;
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_ERROR;
+      }
+      else if (frozen_bf_built_)
+      {
+        TBSYS_LOG(INFO, "frozen bloomfilter already built");
+      }
+      else if (0 >= row_num)
+      {
+        TBSYS_LOG(INFO, "empty memtable, no need to build frozen bloomfilter");
+      }
+      else if (OB_SUCCESS != (ret = frozen_bf_.init(FROZEN_BLOOM_FILTER_NHASH, nbyte)))
+      {
+        TBSYS_LOG(WARN, "init frozen bloomfilter fail ret=%d nbyte=%ld", ret, nbyte);
+      }
+      else if (OB_SUCCESS != (ret = scan_all(iter)))
+      {
+        TBSYS_LOG(WARN, "scan all fail ret=%d", ret);
+      }
+      else
+      {
+        while (OB_SUCCESS == ret
+              && OB_SUCCESS == iter.next())
+        {
+          const TEKey &key = iter.get_key();
+          if (OB_SUCCESS != (ret = frozen_bf_.insert(key.table_id, key.row_key)))
+          {
+            TBSYS_LOG(WARN, "insert frozen bloomfilter fail ret=%d %s", ret, key.log_str());
+          }
+        }
+        if (OB_SUCCESS == ret)
+        {
+          // bloomfilter写完之后才对读可见
+          __sync_synchronize();
+          frozen_bf_built_ = true;
+          TBSYS_LOG(INFO, "build frozen bloomfilter succ row_num=%ld nbyte=%ld timeu=%ld",
+                    row_num, nbyte, tbsys::CTimeUtil::getTime() - timeu);
+        }
+        else
+        {
+          frozen_bf_.destroy();
+        }
+      }
+      return ret;
+    }
+
+    bool MemTable::row_may_exist_(const uint64_t table_id, const ObRowkey &row_key) const
+    {
+      bool bret = true;
+      if (frozen_bf_built_
+          && using_frozen_bloomfilter())
+      {
+        OB_STAT_INC(UPDATESERVER, UPS_STAT_BF_CHECK_COUNT, 1);
+        if (!frozen_bf_.contain(table_id, row_key))
+        {
+          OB_STAT_INC(UPDATESERVER, UPS_STAT_BF_SKIP_COUNT, 1);
+          bret = false;
+        }
+      }
+      else if (using_memtable_bloomfilter())
+      {
+        bret = table_bf_.contain(table_id, row_key);
+      }
+      return bret;
+    }
+
     int MemTable::scan_all(TableEngineIterator &iter)
     {
       int ret = OB_SUCCESS;
@@ -200,16 +200,20 @@ namespace oceanbase
         common::ObIterator *iter_;
     };
 
+    class ObRowModifyTracker;
     struct MemTableAttr
     {
       int64_t total_memlimit;
       //int64_t drop_page_num_once;
       //int64_t drop_sleep_interval_us;
       IExternMemTotal *extern_mem_total;
+      // 提交时记录行所在slot的事务号, 为NULL时不记录
+      ObRowModifyTracker *row_modify_tracker;
       MemTableAttr() : total_memlimit(0),
                        //drop_page_num_once(0),
                        //drop_sleep_interval_us(0),
-                       extern_mem_total(NULL)
+                       extern_mem_total(NULL),
+                       row_modify_tracker(NULL)
       {
       };
     };
@@ -233,6 +237,10 @@ namespace oceanbase
       static const int64_t MAX_ROW_SIZE = common::OB_MAX_ROW_LENGTH / CELL_INFO_SIZE_UNIT;
       static const int64_t BLOOM_FILTER_NHASH = 1;
       static const int64_t BLOOM_FILTER_NBYTE = common::OB_MAX_PACKET_LENGTH - 1 * 1024;
+      // 冻结后按实际行数构建的bloomfilter, 每行10bit, 4个hash函数时误判率约1%
+      static const int64_t FROZEN_BLOOM_FILTER_NHASH = 4;
+      static const int64_t FROZEN_BLOOM_FILTER_BITS_PER_ROW = 10;
+      static const int64_t FROZEN_BLOOM_FILTER_MAX_NBYTE = 256L * 1024L * 1024L;
       static const int64_t MAX_TRANS_NUM = 64;
       public:
         MemTable();
@@ -332,12 +340,14 @@ namespace oceanbase
         {
           mem_tank_.set_total_limit(attr.total_memlimit);
           mem_tank_.set_extern_mem_total(attr.extern_mem_total);
+          row_modify_tracker_ = attr.row_modify_tracker;
         };
 
         inline void get_attr(MemTableAttr &attr)
         {
           attr.total_memlimit = mem_tank_.get_total_limit();
           attr.extern_mem_total = mem_tank_.get_extern_mem_total();
+          attr.row_modify_tracker = row_modify_tracker_;
         };
 
         inline void log_memory_info() const
@@ -454,9 +464,18 @@ namespace oceanbase
 
         int get_bloomfilter(common::TableBloomFilter &table_bf) const;
 
+        // 冻结后由转储线程调用, 遍历全表构建rowkey bloomfilter
+        // 构建完成之后点查询用它跳过不包含该行的memtable
+        int build_frozen_bloomfilter();
+        inline bool has_frozen_bloomfilter() const
+        {
+          return frozen_bf_built_;
+        };
+
         int scan_all(TableEngineIterator &iter);
 
       private:
+        inline bool row_may_exist_(const uint64_t table_id, const common::ObRowkey &row_key) const;
         inline int copy_cells_(TransNode &tn,
                               TEValue &value,
                               ObUpsCompactCellWriter &ccw);
@@ -526,6 +545,11 @@ namespace oceanbase
                           TEValue &te_value);
 
         inline static bool is_row_too_long_(const RWSessionCtx &session, const TEKey &te_key, const TEValue &te_value);
+        // 行上的cell个数或已提交的节点链长度超过门限时需要合并
+        inline static bool need_merge_(const TEValue &te_value);
+        // 链表前两个节点都对最老的读快照可见时合并才能减少节点个数
+        inline static bool can_merge_(const int64_t min_trans_id, const TEValue &te_value);
+        inline static void stat_chain_len_(const TEValue &te_value);
         inline static int16_t get_varchar_length_kb_(const common::ObObj &value)
         {
           int16_t ret = 0;
@@ -596,6 +620,8 @@ namespace oceanbase
         MemTank mem_tank_;
         TableEngine table_engine_;
         common::TableBloomFilter table_bf_;
+        common::TableBloomFilter frozen_bf_;
+        volatile bool frozen_bf_built_;
 
         int64_t version_;
         int64_t ref_cnt_;
@@ -613,6 +639,7 @@ namespace oceanbase
 
         TEValueSessionCallback tevalue_cb_;
         TransSessionCallback trans_cb_;
+        ObRowModifyTracker *row_modify_tracker_;
     };
   }
 }
@@ -261,6 +261,17 @@ namespace oceanbase
       }
       return bret;
     }
+
+    bool MemTableRowIterator::get_row_num(int64_t &row_num)
+    {
+      bool bret = false;
+      if (NULL != memtable_)
+      {
+        row_num = memtable_->btree_size();
+        bret = true;
+      }
+      return bret;
+    }
   }
 }
 
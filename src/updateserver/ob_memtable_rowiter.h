@@ -111,6 +111,7 @@ namespace oceanbase
         virtual const common::ObRowkeyInfo *get_rowkey_info(const uint64_t table_id) const;
         virtual bool get_store_type(int &store_type);
         virtual bool get_block_size(int64_t &block_size);
+        virtual bool get_row_num(int64_t &row_num);
       private:
         void reset_();
         void revert_schema_handle_();
@@ -57,24 +57,38 @@ namespace oceanbase
           return 0;
         }
     };
+    // 每个分配器都是TSIStackAllocator, 写线程从自己的block中分配, 互不竞争;
+    // block由分配它的线程首先访问, 因此落在该线程所在的NUMA节点上
+    // rowkey/cell节点/TEValue/索引各自使用独立的block allocator和ObModIds, 可以分别统计内存
     class MemTank
     {
       typedef common::ObHandyAllocatorWrapper<common::TSIStackAllocator> Allocator;
       static const int64_t PAGE_SIZE = 2 * 1024L * 1024L;
       static const int64_t AVAILABLE_WARN_SIZE = 2L * 1024L * 1024L * 1024L; //2G
       static const int64_t BLOCK_ALLOCATOR_LIMIT_DELTA = 2L * 1024L * 1024L * 1024L;
+      enum
+      {
+        STRING_BLOCK = 0,
+        NODE_BLOCK,
+        TEVALUE_BLOCK,
+        INDEX_BLOCK,
+        BLOCK_ALLOCATOR_NUM,
+      };
       public:
-        MemTank(const int32_t mod_id = common::ObModIds::OB_UPS_MEMTABLE)
+        MemTank()
           : total_limit_(INT64_MAX),
             extern_mem_total_ptr_(&default_extern_mem_total_)
         {
           int64_t block_size = PAGE_SIZE;
-          block_allocator_.set_mod_id(mod_id);
-          string_buf_.init(&block_allocator_, block_size);
-          allocer_.init(&block_allocator_, block_size);
-          tevalue_allocer_.init(&block_allocator_, block_size);
-          btree_engine_allocer_.init(&block_allocator_, block_size);
-          hash_engine_allocer_.init(&block_allocator_, block_size);
+          block_allocator_[STRING_BLOCK].set_mod_id(common::ObModIds::OB_UPS_MEMTABLE_STRING);
+          block_allocator_[NODE_BLOCK].set_mod_id(common::ObModIds::OB_UPS_MEMTABLE_NODE);
+          block_allocator_[TEVALUE_BLOCK].set_mod_id(common::ObModIds::OB_UPS_MEMTABLE_TEVALUE);
+          block_allocator_[INDEX_BLOCK].set_mod_id(common::ObModIds::OB_UPS_MEMTABLE_INDEX);
+          string_buf_.init(&block_allocator_[STRING_BLOCK], block_size);
+          allocer_.init(&block_allocator_[NODE_BLOCK], block_size);
+          tevalue_allocer_.init(&block_allocator_[TEVALUE_BLOCK], block_size);
+          btree_engine_allocer_.init(&block_allocator_[INDEX_BLOCK], block_size);
+          hash_engine_allocer_.init(&block_allocator_[INDEX_BLOCK], block_size);
         };
         ~MemTank()
         {
@@ -202,11 +216,16 @@ namespace oceanbase
         };
         int64_t used() const
         {
-          return block_allocator_.get_allocated();
+          return total();
         };
         int64_t total() const
         {
-          return block_allocator_.get_allocated();
+          int64_t ret = 0;
+          for (int64_t i = 0; i < BLOCK_ALLOCATOR_NUM; i++)
+          {
+            ret += block_allocator_[i].get_allocated();
+          }
+          return ret;
         };
         void set_extern_mem_total(IExternMemTotal *extern_mem_total_ptr)
         {
@@ -224,7 +243,11 @@ namespace oceanbase
           if (0 < limit)
           {
             total_limit_ = limit;
-            block_allocator_.set_limit(limit + BLOCK_ALLOCATOR_LIMIT_DELTA);
+            // 总量由mem_over_limit控制, 这里只是每个block allocator的兜底限制
+            for (int64_t i = 0; i < BLOCK_ALLOCATOR_NUM; i++)
+            {
+              block_allocator_[i].set_limit(limit + BLOCK_ALLOCATOR_LIMIT_DELTA);
+            }
           }
           return total_limit_;
         };
@@ -239,13 +262,21 @@ namespace oceanbase
                     "allocer_used=%ld "
                     "tevalue_allocer_used=%ld "
                     "btree_engine_allocer_used=%ld "
-                    "hash_engine_allocer_used=%ld ",
+                    "hash_engine_allocer_used=%ld "
+                    "string_block_total=%ld "
+                    "node_block_total=%ld "
+                    "tevalue_block_total=%ld "
+                    "index_block_total=%ld",
                     used(), total(), extern_mem_total_ptr_->get_extern_mem_total(), get_total_limit(),
                     string_buf_.get_alloc_size(),
                     allocer_.get_alloc_size(),
                     tevalue_allocer_.get_alloc_size(),
                     btree_engine_allocer_.get_alloc_size(),
-                    hash_engine_allocer_.get_alloc_size());
+                    hash_engine_allocer_.get_alloc_size(),
+                    block_allocator_[STRING_BLOCK].get_allocated(),
+                    block_allocator_[NODE_BLOCK].get_allocated(),
+                    block_allocator_[TEVALUE_BLOCK].get_allocated(),
+                    block_allocator_[INDEX_BLOCK].get_allocated());
         };
       private:
         void log_error_(const char *caller) const
@@ -265,7 +296,7 @@ namespace oceanbase
         };
       private:
         int64_t total_limit_;
-        common::DefaultBlockAllocator block_allocator_;
+        common::DefaultBlockAllocator block_allocator_[BLOCK_ALLOCATOR_NUM];
         Allocator string_buf_;
         Allocator allocer_;
         Allocator tevalue_allocer_;
@@ -0,0 +1,326 @@
+/**
+ * (C) 2007-2010 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * Authors:
+ *   yuanqi <yuanqi.xhf@taobao.com>
+ *     - some work details if you want
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ob_mmap_log_reader.h"
+#include "ob_ups_log_utils.h"
+
+using namespace oceanbase::common;
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    int read_log_file_by_location(const char* log_dir, const int64_t file_id, const int64_t offset,
+                                  char* buf, const int64_t len, int64_t& read_count, const bool dio);
+
+    ObMmapLogReader::ObMmapLogReader(): log_dir_(NULL), dio_(true), map_size_(DEFAULT_MAP_SIZE),
+                                        read_ahead_size_(DEFAULT_READ_AHEAD_SIZE)
+    {}
+
+    ObMmapLogReader::~ObMmapLogReader()
+    {
+      destroy();
+    }
+
+    bool ObMmapLogReader::is_inited() const
+    {
+      return NULL != log_dir_;
+    }
+
+    int ObMmapLogReader::init(const char* log_dir, const bool dio /*=true*/,
+                              const int64_t map_size /*=DEFAULT_MAP_SIZE*/,
+                              const int64_t read_ahead_size /*=DEFAULT_READ_AHEAD_SIZE*/)
+    {
+      int err = OB_SUCCESS;
+      if (is_inited())
+      {
+        err = OB_INIT_TWICE;
+      }
+      else if (NULL == log_dir || 0 >= map_size || 0 > read_ahead_size)
+      {
+        err = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        dio_ = dio;
+        map_size_ = map_size;
+        read_ahead_size_ = read_ahead_size;
+        log_dir_ = log_dir;
+      }
+      return err;
+    }
+
+    void ObMmapLogReader::destroy()
+    {
+      tbsys::CThreadGuard guard(&mutex_);
+      for (int64_t i = 0; i < MAX_MAPPED_FILE_NUM; i++)
+      {
+        if (0 != files_[i].ref_cnt_)
+        {
+          TBSYS_LOG(ERROR, "mapped file[%ld] still referenced: ref_cnt=%ld", files_[i].file_id_, files_[i].ref_cnt_);
+        }
+        unmap_file_(files_[i]);
+      }
+    }
+
+    int ObMmapLogReader::map_file_(MappedFile& file, const int64_t file_id, const char* path, const ino_t ino)
+    {
+      int err = OB_SUCCESS;
+      int fd = -1;
+      void* addr = MAP_FAILED;
+      if (NULL == path)
+      {
+        err = OB_INVALID_ARGUMENT;
+      }
+      else if (0 > (fd = open(path, O_RDONLY)))
+      {
+        err = (ENOENT == errno)? OB_FILE_NOT_EXIST: OB_IO_ERROR;
+        TBSYS_LOG(WARN, "open(%s):%s", path, strerror(errno));
+      }
+      else if (MAP_FAILED == (addr = mmap(NULL, map_size_, PROT_READ, MAP_SHARED, fd, 0)))
+      {
+        err = OB_IO_ERROR;
+        TBSYS_LOG(WARN, "mmap(%s, size=%ld):%s", path, map_size_, strerror(errno));
+      }
+      else
+      {
+        if (0 != madvise(addr, map_size_, MADV_SEQUENTIAL))
+        {
+          TBSYS_LOG(WARN, "madvise(%s, MADV_SEQUENTIAL):%s", path, strerror(errno));
+        }
+        file.file_id_ = file_id;
+        file.ino_ = ino;
+        file.addr_ = (char*)addr;
+        file.ref_cnt_ = 0;
+        file.is_stale_ = false;
+        TBSYS_LOG(INFO, "map log file: %s, addr=%p, map_size=%ld", path, addr, map_size_);
+      }
+      // 映射建立之后不再需要fd
+      if (fd >= 0)
+      {
+        close(fd);
+      }
+      return err;
+    }
+
+    void ObMmapLogReader::unmap_file_(MappedFile& file)
+    {
+      if (NULL != file.addr_)
+      {
+        if (0 != munmap(file.addr_, map_size_))
+        {
+          TBSYS_LOG(ERROR, "munmap(file_id=%ld, addr=%p):%s", file.file_id_, file.addr_, strerror(errno));
+        }
+      }
+      file.file_id_ = 0;
+      file.ino_ = 0;
+      file.addr_ = NULL;
+      file.ref_cnt_ = 0;
+      file.last_access_time_ = 0;
+      file.is_stale_ = false;
+    }
+
+    int ObMmapLogReader::acquire_file_(const int64_t file_id, MappedFile*& file, int64_t& file_size)
+    {
+      int err = OB_SUCCESS;
+      char path[OB_MAX_FILE_NAME_LENGTH];
+      int64_t path_len = 0;
+      struct stat st;
+      MappedFile* victim = NULL;
+      file = NULL;
+      if (0 >= (path_len = snprintf(path, sizeof(path), "%s/%ld", log_dir_, file_id))
+          || path_len >= (int64_t)sizeof(path))
+      {
+        err = OB_ERROR;
+      }
+      else
+      {
+        tbsys::CThreadGuard guard(&mutex_);
+        if (0 != stat(path, &st))
+        {
+          err = (ENOENT == errno)? OB_FILE_NOT_EXIST: OB_IO_ERROR;
+        }
+        else
+        {
+          file_size = st.st_size;
+        }
+        for (int64_t i = 0; i < MAX_MAPPED_FILE_NUM; i++)
+        {
+          MappedFile& cur = files_[i];
+          if (NULL == cur.addr_ || cur.is_stale_ || cur.file_id_ != file_id)
+          {}
+          else if (OB_SUCCESS == err && cur.ino_ == st.st_ino)
+          {
+            file = &cur;
+          }
+          else
+          {
+            TBSYS_LOG(INFO, "log file[%ld] was removed or reused, unmap it", file_id);
+            cur.is_stale_ = true;
+            if (0 == cur.ref_cnt_)
+            {
+              unmap_file_(cur);
+            }
+          }
+        }
+        if (OB_SUCCESS != err || NULL != file)
+        {}
+        else
+        {
+          for (int64_t i = 0; i < MAX_MAPPED_FILE_NUM; i++)
+          {
+            MappedFile& cur = files_[i];
+            if (NULL == cur.addr_)
+            {
+              victim = &cur;
+              break;
+            }
+            else if (0 == cur.ref_cnt_
+                     && (NULL == victim || cur.last_access_time_ < victim->last_access_time_))
+            {
+              victim = &cur;
+            }
+          }
+          // 所有映射都在使用中, 或者映射失败, 都退回到pread
+          if (NULL != victim)
+          {
+            unmap_file_(*victim);
+            if (OB_SUCCESS == map_file_(*victim, file_id, path, st.st_ino))
+            {
+              file = victim;
+            }
+          }
+        }
+        if (NULL != file)
+        {
+          file->ref_cnt_++;
+          file->last_access_time_ = tbsys::CTimeUtil::getTime();
+        }
+      }
+      return err;
+    }
+
+    void ObMmapLogReader::revert_file_(MappedFile* file)
+    {
+      if (NULL != file)
+      {
+        tbsys::CThreadGuard guard(&mutex_);
+        if (0 == --file->ref_cnt_ && file->is_stale_)
+        {
+          unmap_file_(*file);
+        }
+      }
+    }
+
+    int ObMmapLogReader::copy_log_(MappedFile& file, const int64_t file_size, const int64_t offset,
+                                   char* buf, const int64_t len, int64_t& read_count)
+    {
+      int err = OB_SUCCESS;
+      int64_t limit = (file_size < map_size_)? file_size: map_size_;
+      int64_t read_ahead_start = 0;
+      int64_t read_ahead_len = 0;
+      read_count = (offset >= limit)? 0: ((len < limit - offset)? len: limit - offset);
+      if (read_count > 0)
+      {
+        memcpy(buf, file.addr_ + offset, read_count);
+      }
+      // 预读紧接着的一段, 下一次请求基本就从这里开始
+      read_ahead_start = (offset + read_count) & ~(MADVISE_ALIGN_SIZE - 1);
+      read_ahead_len = limit - read_ahead_start;
+      if (read_ahead_len > read_ahead_size_)
+      {
+        read_ahead_len = read_ahead_size_;
+      }
+      if (read_ahead_len > 0 && 0 != madvise(file.addr_ + read_ahead_start, read_ahead_len, MADV_WILLNEED))
+      {
+        TBSYS_LOG(WARN, "madvise(file_id=%ld, offset=%ld, len=%ld, MADV_WILLNEED):%s",
+                  file.file_id_, read_ahead_start, read_ahead_len, strerror(errno));
+      }
+      return err;
+    }
+
+    int ObMmapLogReader::read_file(const int64_t file_id, const int64_t offset,
+                                   char* buf, const int64_t len, int64_t& read_count)
+    {
+      int err = OB_SUCCESS;
+      MappedFile* file = NULL;
+      int64_t file_size = 0;
+      bool use_pread = false;
+      read_count = 0;
+      if (!is_inited())
+      {
+        err = OB_NOT_INIT;
+      }
+      else if (0 >= file_id || 0 > offset || NULL == buf || 0 >= len)
+      {
+        err = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (err = acquire_file_(file_id, file, file_size))
+               && OB_FILE_NOT_EXIST != err)
+      {
+        TBSYS_LOG(ERROR, "acquire_file(%s/%ld)=>%d", log_dir_, file_id, err);
+      }
+      else if (OB_FILE_NOT_EXIST == err)
+      {
+        err = OB_SUCCESS;
+      }
+      else if (NULL == file || offset >= map_size_)
+      {
+        use_pread = true;
+      }
+      else if (OB_SUCCESS != (err = copy_log_(*file, file_size, offset, buf, len, read_count)))
+      {
+        TBSYS_LOG(ERROR, "copy_log(%s/%ld, offset=%ld)=>%d", log_dir_, file_id, offset, err);
+      }
+
+      if (NULL != file)
+      {
+        revert_file_(file);
+      }
+
+      if (OB_SUCCESS == err && use_pread
+          && OB_SUCCESS != (err = read_log_file_by_location(log_dir_, file_id, offset, buf, len, read_count, dio_)))
+      {
+        TBSYS_LOG(ERROR, "read_log_file_by_location(%s/%ld, offset=%ld)=>%d", log_dir_, file_id, offset, err);
+      }
+      return err;
+    }
+
+    int ObMmapLogReader::read_log(const int64_t file_id, const int64_t offset,
+                                  int64_t& start_id, int64_t& end_id,
+                                  char* buf, const int64_t len, int64_t& read_count, bool& is_file_end)
+    {
+      int err = OB_SUCCESS;
+      if (!is_inited())
+      {
+        err = OB_NOT_INIT;
+      }
+      else if (OB_SUCCESS != (err = read_file(file_id, offset, buf, len, read_count)))
+      {
+        TBSYS_LOG(ERROR, "read_file(%s/%ld, offset=%ld)=>%d", log_dir_, file_id, offset, err);
+      }
+      else if (OB_SUCCESS != (err = trim_log_buffer(offset, OB_DIRECT_IO_ALIGN_BITS,
+                                                    buf, read_count, read_count, start_id, end_id, is_file_end)))
+      {
+        TBSYS_LOG(ERROR, "trim_log_buffer()=>%d", err);
+      }
+      return err;
+    }
+  }; // end namespace updateserver
+}; // end namespace oceanbase
@@ -0,0 +1,79 @@
+/**
+ * (C) 2007-2010 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * Authors:
+ *   yuanqi <yuanqi.xhf@taobao.com>
+ *     - some work details if you want
+ */
+#ifndef OCEANBASE_UPDATESERVER_OB_MMAP_LOG_READER_H_
+#define OCEANBASE_UPDATESERVER_OB_MMAP_LOG_READER_H_
+#include <sys/types.h>
+#include "tbsys.h"
+#include "common/ob_define.h"
+#include "ob_located_log_reader.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+// 语义与ObLocatedLogReader相同, 区别在于不再每次打开文件pread:
+//  最近读过的几个日志文件保持打开并mmap到内存, 读日志时直接从映射区拷贝到调用者的发送缓冲区,
+//  拷贝之后对后续的一段区域做MADV_WILLNEED, 让内核提前把下一次要读的数据读进page cache,
+//  这样落后较多的备机追日志时对主机磁盘的访问是大块顺序读, 而不是每次2M的随机pread。
+//  映射的长度固定为map_size, 超出映射范围或者mmap失败时退回到pread。
+//  日志文件可能被复用(rename成新的文件名), 每次读之前用stat检查inode, 变化了就重新映射。
+    class ObMmapLogReader : public IObLocatedLogReader
+    {
+      public:
+        static const int64_t MAX_MAPPED_FILE_NUM = 8;
+        static const int64_t DEFAULT_MAP_SIZE = 1L<<30;
+        static const int64_t DEFAULT_READ_AHEAD_SIZE = 1L<<23;
+        static const int64_t MADVISE_ALIGN_SIZE = 1L<<12;
+      private:
+        struct MappedFile
+        {
+          MappedFile(): file_id_(0), ino_(0), addr_(NULL), ref_cnt_(0), last_access_time_(0), is_stale_(false) {}
+          int64_t file_id_;
+          ino_t ino_;
+          char* addr_;
+          int64_t ref_cnt_;
+          int64_t last_access_time_;
+          bool is_stale_; // 文件已被复用或删除, 引用计数归零后释放
+        };
+      public:
+        ObMmapLogReader();
+        virtual ~ObMmapLogReader();
+        int init(const char* log_dir, const bool dio = true,
+                 const int64_t map_size = DEFAULT_MAP_SIZE, const int64_t read_ahead_size = DEFAULT_READ_AHEAD_SIZE);
+        void destroy();
+        virtual int read_log(const int64_t file_id, const int64_t offset,
+                             int64_t& start_id, int64_t& end_id,
+                             char* buf, const int64_t len, int64_t& read_count, bool& is_file_end);
+        // 只拷贝文件内容, 不解析日志, 文件不存在时read_count=0
+        int read_file(const int64_t file_id, const int64_t offset, char* buf, const int64_t len, int64_t& read_count);
+      protected:
+        bool is_inited() const;
+        // 返回的file_size是stat得到的当前文件长度, 文件不存在时返回OB_FILE_NOT_EXIST
+        int acquire_file_(const int64_t file_id, MappedFile*& file, int64_t& file_size);
+        void revert_file_(MappedFile* file);
+        int map_file_(MappedFile& file, const int64_t file_id, const char* path, const ino_t ino);
+        void unmap_file_(MappedFile& file);
+        int copy_log_(MappedFile& file, const int64_t file_size, const int64_t offset,
+                      char* buf, const int64_t len, int64_t& read_count);
+      private:
+        const char* log_dir_;
+        bool dio_; // 退回到pread时是否使用DirectIO
+        int64_t map_size_;
+        int64_t read_ahead_size_;
+        tbsys::CThreadMutex mutex_;
+        MappedFile files_[MAX_MAPPED_FILE_NUM];
+    };
+  }; // end namespace updateserver
+}; // end namespace oceanbase
+#endif // OCEANBASE_UPDATESERVER_OB_MMAP_LOG_READER_H_
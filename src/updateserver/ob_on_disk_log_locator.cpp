@@ -12,9 +12,19 @@
  *     - some work details if you want
  */
 
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "common/ob_define.h"
+#include "common/ob_malloc.h"
+#include "common/ob_crc64.h"
+#include "common/serialization.h"
+#include "common/ob_file.h"
+#include "common/ob_log_entry.h"
 #include "common/ob_repeated_log_reader.h"
 #include "common/ob_log_dir_scanner.h"
+#include "common/ob_log_data_writer.h"
 #include "ob_on_disk_log_locator.h"
 
 using namespace oceanbase::common;
@@ -324,7 +334,533 @@ namespace oceanbase
       return err;
     }
 
-    ObOnDiskLogLocator::ObOnDiskLogLocator(): enable_log_id_cache_(true), log_dir_(NULL)
+    int get_log_file_size_func(const char* log_dir, const int64_t file_id, int64_t& file_size)
+    {
+      int err = OB_SUCCESS;
+      char path[OB_MAX_FILE_NAME_LENGTH];
+      int64_t path_len = 0;
+      struct stat st;
+      if (NULL == log_dir || 0 >= file_id)
+      {
+        err = OB_INVALID_ARGUMENT;
+      }
+      else if (0 >= (path_len = snprintf(path, sizeof(path), "%s/%ld", log_dir, file_id))
+               || path_len >= (int64_t)sizeof(path))
+      {
+        err = OB_ERROR;
+      }
+      else if (0 != stat(path, &st))
+      {
+        err = (ENOENT == errno)? OB_ENTRY_NOT_EXIST: OB_IO_ERROR;
+      }
+      else
+      {
+        file_size = st.st_size;
+      }
+      return err;
+    }
+
+    // 从[start_offset, end_offset)中找到log_id开始的位置
+    int get_log_offset_in_range_func(const char* log_dir, const int64_t file_id,
+                                     const int64_t start_offset, const int64_t end_offset,
+                                     const int64_t log_id, int64_t& offset)
+    {
+      int err = OB_SUCCESS;
+      char path[OB_MAX_FILE_NAME_LENGTH];
+      int64_t path_len = 0;
+      int fd = -1;
+      char* buf = NULL;
+      int64_t len = end_offset - start_offset;
+      int64_t read_count = 0;
+      int64_t pos = 0;
+      int64_t old_pos = 0;
+      ObLogEntry log_entry;
+      if (NULL == log_dir || 0 >= file_id || 0 > start_offset || 0 >= len)
+      {
+        err = OB_INVALID_ARGUMENT;
+      }
+      else if (0 >= (path_len = snprintf(path, sizeof(path), "%s/%ld", log_dir, file_id))
+               || path_len >= (int64_t)sizeof(path))
+      {
+        err = OB_ERROR;
+      }
+      else if (NULL == (buf = (char*)ob_malloc(len, ObModIds::OB_UPS_LOG)))
+      {
+        err = OB_ALLOCATE_MEMORY_FAILED;
+        TBSYS_LOG(ERROR, "ob_malloc(%ld) failed", len);
+      }
+      else if (0 > (fd = open(path, O_RDONLY)))
+      {
+        err = (ENOENT == errno)? OB_ENTRY_NOT_EXIST: OB_IO_ERROR;
+        TBSYS_LOG(WARN, "open(%s):%s", path, strerror(errno));
+      }
+      else if (len != (read_count = unintr_pread(fd, buf, len, start_offset)))
+      {
+        err = OB_IO_ERROR;
+        TBSYS_LOG(ERROR, "pread(%s, offset=%ld, len=%ld)=>%ld", path, start_offset, len, read_count);
+      }
+      while (OB_SUCCESS == err)
+      {
+        old_pos = pos;
+        if (pos + log_entry.get_serialize_size() > len)
+        {
+          err = OB_ENTRY_NOT_EXIST;
+        }
+        else if (OB_SUCCESS != (err = log_entry.deserialize(buf, len, pos)))
+        {
+          TBSYS_LOG(ERROR, "log_entry.deserialize(buf=%p, len=%ld, pos=%ld)=>%d", buf, len, pos, err);
+        }
+        else if ((int64_t)log_entry.seq_ == log_id)
+        {
+          offset = start_offset + old_pos;
+          break;
+        }
+        else if ((int64_t)log_entry.seq_ > log_id)
+        {
+          err = OB_ENTRY_NOT_EXIST;
+        }
+        else
+        {
+          pos = old_pos + log_entry.get_serialize_size() + log_entry.get_log_data_len();
+        }
+      }
+      if (fd >= 0)
+      {
+        close(fd);
+      }
+      if (NULL != buf)
+      {
+        ob_free(buf);
+      }
+      return err;
+    }
+
+    ObLogFileIndex::ObLogFileIndex()
+    {
+      reset();
+    }
+
+    ObLogFileIndex::~ObLogFileIndex()
+    {}
+
+    void ObLogFileIndex::reset()
+    {
+      file_id_ = 0;
+      file_size_ = 0;
+      end_log_id_ = 0;
+      end_offset_ = 0;
+      interval_ = DEFAULT_INTERVAL;
+      entry_num_ = 0;
+    }
+
+    void ObLogFileIndex::add_entry_(const int64_t log_id, const int64_t offset)
+    {
+      if (entry_num_ >= MAX_ENTRY_NUM)
+      {
+        for (int64_t i = 0; 2 * i < entry_num_; i++)
+        {
+          entries_[i] = entries_[2 * i];
+        }
+        entry_num_ = (entry_num_ + 1) / 2;
+        interval_ *= 2;
+      }
+      if (0 == entry_num_ || offset >= entries_[entry_num_ - 1].offset_ + interval_)
+      {
+        entries_[entry_num_].log_id_ = log_id;
+        entries_[entry_num_].offset_ = offset;
+        entry_num_++;
+      }
+    }
+
+    int ObLogFileIndex::build(const char* log_dir, const int64_t file_id, const int64_t interval)
+    {
+      int err = OB_SUCCESS;
+      ObRepeatedLogReader log_reader;
+      LogCommand cmd = OB_LOG_NOP;
+      uint64_t log_seq = 0;
+      char* log_data = NULL;
+      int64_t data_len = 0;
+      int64_t offset = 0;
+      bool is_file_end = false;
+      reset();
+      if (NULL == log_dir || 0 >= file_id || 0 >= interval)
+      {
+        err = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (err = log_reader.init(log_dir)))
+      {
+        TBSYS_LOG(ERROR, "log_reader.init(log_dir=%s)=>%d", log_dir, err);
+      }
+      else if (OB_SUCCESS != (err = log_reader.open(file_id)))
+      {
+        if (OB_FILE_NOT_EXIST != err)
+        {
+          TBSYS_LOG(ERROR, "log_reader.open(file_id=%ld)=>%d", file_id, err);
+        }
+        else
+        {
+          err = OB_ENTRY_NOT_EXIST;
+        }
+      }
+      else
+      {
+        file_id_ = file_id;
+        interval_ = interval;
+      }
+      while (OB_SUCCESS == err && !is_file_end)
+      {
+        offset = (int64_t)log_reader.get_last_log_offset();
+        if (OB_SUCCESS != (err = log_reader.read_log(cmd, log_seq, log_data, data_len)))
+        {
+          if (OB_READ_NOTHING != err)
+          {
+            TBSYS_LOG(ERROR, "log_reader.read_log()=>%d", err);
+          }
+          else
+          {
+            err = OB_ENTRY_NOT_EXIST;
+            TBSYS_LOG(INFO, "log file[%ld] is not ended with SWITCH_LOG, can not build index", file_id);
+          }
+        }
+        else
+        {
+          add_entry_((int64_t)log_seq, offset);
+          if (OB_LOG_SWITCH_LOG == cmd)
+          {
+            is_file_end = true;
+            end_log_id_ = (int64_t)log_seq + 1;
+            end_offset_ = (int64_t)log_reader.get_last_log_offset();
+          }
+        }
+      }
+      if (log_reader.is_opened())
+      {
+        log_reader.close();
+      }
+
+      if (OB_SUCCESS != err)
+      {}
+      else if (OB_SUCCESS != (err = get_log_file_size_func(log_dir, file_id, file_size_)))
+      {
+        TBSYS_LOG(ERROR, "get_log_file_size(file_id=%ld)=>%d", file_id, err);
+      }
+      else
+      {
+        TBSYS_LOG(INFO, "build log index: file_id=%ld, log_id=[%ld,%ld), entry_num=%ld, interval=%ld",
+                  file_id_, entries_[0].log_id_, end_log_id_, entry_num_, interval_);
+      }
+      if (OB_SUCCESS != err)
+      {
+        reset();
+      }
+      return err;
+    }
+
+    int64_t ObLogFileIndex::get_serialize_size_() const
+    {
+      return sizeof(int64_t) * (9 + 2 * entry_num_);
+    }
+
+    int ObLogFileIndex::serialize_(char* buf, const int64_t len, int64_t& pos) const
+    {
+      int err = OB_SUCCESS;
+      int64_t start_pos = pos;
+      if (OB_SUCCESS != (err = serialization::encode_i64(buf, len, pos, MAGIC))
+          || OB_SUCCESS != (err = serialization::encode_i64(buf, len, pos, VERSION))
+          || OB_SUCCESS != (err = serialization::encode_i64(buf, len, pos, file_id_))
+          || OB_SUCCESS != (err = serialization::encode_i64(buf, len, pos, file_size_))
+          || OB_SUCCESS != (err = serialization::encode_i64(buf, len, pos, end_log_id_))
+          || OB_SUCCESS != (err = serialization::encode_i64(buf, len, pos, end_offset_))
+          || OB_SUCCESS != (err = serialization::encode_i64(buf, len, pos, interval_))
+          || OB_SUCCESS != (err = serialization::encode_i64(buf, len, pos, entry_num_)))
+      {
+        TBSYS_LOG(ERROR, "serialize log index header error, buf=%p[%ld], pos=%ld", buf, len, pos);
+      }
+      for (int64_t i = 0; OB_SUCCESS == err && i < entry_num_; i++)
+      {
+        if (OB_SUCCESS != (err = serialization::encode_i64(buf, len, pos, entries_[i].log_id_))
+            || OB_SUCCESS != (err = serialization::encode_i64(buf, len, pos, entries_[i].offset_)))
+        {
+          TBSYS_LOG(ERROR, "serialize log index entry error, buf=%p[%ld], pos=%ld", buf, len, pos);
+        }
+      }
+      if (OB_SUCCESS == err
+          && OB_SUCCESS != (err = serialization::encode_i64(buf, len, pos,
+                                                            (int64_t)ob_crc64(buf + start_pos, pos - start_pos))))
+      {
+        TBSYS_LOG(ERROR, "serialize log index checksum error, buf=%p[%ld], pos=%ld", buf, len, pos);
+      }
+      return err;
+    }
+
+    int ObLogFileIndex::deserialize_(const char* buf, const int64_t len, int64_t& pos)
+    {
+      int err = OB_SUCCESS;
+      int64_t start_pos = pos;
+      int64_t magic = 0;
+      int64_t version = 0;
+      int64_t checksum = 0;
+      if (OB_SUCCESS != (err = serialization::decode_i64(buf, len, pos, &magic))
+          || OB_SUCCESS != (err = serialization::decode_i64(buf, len, pos, &version))
+          || OB_SUCCESS != (err = serialization::decode_i64(buf, len, pos, &file_id_))
+          || OB_SUCCESS != (err = serialization::decode_i64(buf, len, pos, &file_size_))
+          || OB_SUCCESS != (err = serialization::decode_i64(buf, len, pos, &end_log_id_))
+          || OB_SUCCESS != (err = serialization::decode_i64(buf, len, pos, &end_offset_))
+          || OB_SUCCESS != (err = serialization::decode_i64(buf, len, pos, &interval_))
+          || OB_SUCCESS != (err = serialization::decode_i64(buf, len, pos, &entry_num_)))
+      {
+        TBSYS_LOG(WARN, "deserialize log index header error, buf=%p[%ld], pos=%ld", buf, len, pos);
+      }
+      else if (MAGIC != magic || VERSION != version || 0 >= entry_num_ || MAX_ENTRY_NUM < entry_num_)
+      {
+        err = OB_DESERIALIZE_ERROR;
+        TBSYS_LOG(WARN, "invalid log index header: magic=%lx, version=%ld, entry_num=%ld", magic, version, entry_num_);
+      }
+      for (int64_t i = 0; OB_SUCCESS == err && i < entry_num_; i++)
+      {
+        if (OB_SUCCESS != (err = serialization::decode_i64(buf, len, pos, &entries_[i].log_id_))
+            || OB_SUCCESS != (err = serialization::decode_i64(buf, len, pos, &entries_[i].offset_)))
+        {
+          TBSYS_LOG(WARN, "deserialize log index entry error, buf=%p[%ld], pos=%ld", buf, len, pos);
+        }
+      }
+      if (OB_SUCCESS != err)
+      {}
+      else if (OB_SUCCESS != (err = serialization::decode_i64(buf, len, pos, &checksum)))
+      {
+        TBSYS_LOG(WARN, "deserialize log index checksum error, buf=%p[%ld], pos=%ld", buf, len, pos);
+      }
+      else if (checksum != (int64_t)ob_crc64(buf + start_pos, pos - start_pos - sizeof(checksum)))
+      {
+        err = OB_CHECKSUM_ERROR;
+        TBSYS_LOG(WARN, "log index checksum error, file_id=%ld", file_id_);
+      }
+      if (OB_SUCCESS != err)
+      {
+        reset();
+      }
+      return err;
+    }
+
+    int ObLogFileIndex::load(const char* log_dir, const int64_t file_id)
+    {
+      int err = OB_SUCCESS;
+      char path[OB_MAX_FILE_NAME_LENGTH];
+      int64_t path_len = 0;
+      int fd = -1;
+      char* buf = NULL;
+      int64_t len = sizeof(int64_t) * (9 + 2 * MAX_ENTRY_NUM);
+      int64_t read_count = 0;
+      int64_t pos = 0;
+      int64_t file_size = 0;
+      reset();
+      if (NULL == log_dir || 0 >= file_id)
+      {
+        err = OB_INVALID_ARGUMENT;
+      }
+      else if (0 >= (path_len = snprintf(path, sizeof(path), "%s/%ld.%s", log_dir, file_id, LOG_INDEX_EXTENSION))
+               || path_len >= (int64_t)sizeof(path))
+      {
+        err = OB_ERROR;
+      }
+      else if (0 > (fd = open(path, O_RDONLY)))
+      {
+        err = (ENOENT == errno)? OB_ENTRY_NOT_EXIST: OB_IO_ERROR;
+      }
+      else if (NULL == (buf = (char*)ob_malloc(len, ObModIds::OB_UPS_LOG)))
+      {
+        err = OB_ALLOCATE_MEMORY_FAILED;
+        TBSYS_LOG(ERROR, "ob_malloc(%ld) failed", len);
+      }
+      else if (0 > (read_count = unintr_pread(fd, buf, len, 0)))
+      {
+        err = OB_IO_ERROR;
+        TBSYS_LOG(ERROR, "pread(%s):%s", path, strerror(errno));
+      }
+      else if (OB_SUCCESS != deserialize_(buf, read_count, pos))
+      {
+        err = OB_ENTRY_NOT_EXIST;
+        TBSYS_LOG(WARN, "log index[%s] is corrupted, ignore it", path);
+      }
+      else if (OB_SUCCESS != (err = get_log_file_size_func(log_dir, file_id, file_size)))
+      {
+        if (OB_ENTRY_NOT_EXIST != err)
+        {
+          TBSYS_LOG(ERROR, "get_log_file_size(file_id=%ld)=>%d", file_id, err);
+        }
+      }
+      else if (file_id != file_id_ || file_size != file_size_)
+      {
+        err = OB_ENTRY_NOT_EXIST;
+        TBSYS_LOG(WARN, "log index[%s] mismatch: file_id=%ld, file_size=%ld, index.file_id=%ld, index.file_size=%ld",
+                  path, file_id, file_size, file_id_, file_size_);
+      }
+      if (fd >= 0)
+      {
+        close(fd);
+      }
+      if (NULL != buf)
+      {
+        ob_free(buf);
+      }
+      if (OB_SUCCESS != err)
+      {
+        reset();
+      }
+      return err;
+    }
+
+    int ObLogFileIndex::store(const char* log_dir) const
+    {
+      int err = OB_SUCCESS;
+      char path[OB_MAX_FILE_NAME_LENGTH];
+      char tmp_path[OB_MAX_FILE_NAME_LENGTH];
+      int64_t path_len = 0;
+      int fd = -1;
+      char* buf = NULL;
+      int64_t len = get_serialize_size_();
+      int64_t pos = 0;
+      if (NULL == log_dir || 0 >= entry_num_)
+      {
+        err = OB_INVALID_ARGUMENT;
+      }
+      else if (0 >= (path_len = snprintf(path, sizeof(path), "%s/%ld.%s", log_dir, file_id_, LOG_INDEX_EXTENSION))
+               || path_len >= (int64_t)sizeof(path)
+               || 0 >= (path_len = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path))
+               || path_len >= (int64_t)sizeof(tmp_path))
+      {
+        err = OB_ERROR;
+      }
+      else if (NULL == (buf = (char*)ob_malloc(len, ObModIds::OB_UPS_LOG)))
+      {
+        err = OB_ALLOCATE_MEMORY_FAILED;
+        TBSYS_LOG(ERROR, "ob_malloc(%ld) failed", len);
+      }
+      else if (OB_SUCCESS != (err = serialize_(buf, len, pos)))
+      {
+        TBSYS_LOG(ERROR, "serialize(buf=%p[%ld])=>%d", buf, len, err);
+      }
+      else if (0 > (fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)))
+      {
+        err = OB_IO_ERROR;
+        TBSYS_LOG(WARN, "open(%s):%s", tmp_path, strerror(errno));
+      }
+      else if (pos != unintr_pwrite(fd, buf, pos, 0))
+      {
+        err = OB_IO_ERROR;
+        TBSYS_LOG(WARN, "pwrite(%s, len=%ld):%s", tmp_path, pos, strerror(errno));
+      }
+      if (fd >= 0)
+      {
+        close(fd);
+      }
+      // 先写临时文件再rename, 保证不会留下写了一半的索引
+      if (OB_SUCCESS == err && 0 != rename(tmp_path, path))
+      {
+        err = OB_IO_ERROR;
+        TBSYS_LOG(WARN, "rename(%s, %s):%s", tmp_path, path, strerror(errno));
+      }
+      if (NULL != buf)
+      {
+        ob_free(buf);
+      }
+      return err;
+    }
+
+    int ObLogFileIndex::get_offset(const char* log_dir, const int64_t log_id, int64_t& offset) const
+    {
+      int err = OB_SUCCESS;
+      int64_t start = 0;
+      int64_t end = entry_num_ - 1;
+      int64_t mid = 0;
+      if (NULL == log_dir || 0 >= entry_num_)
+      {
+        err = OB_INVALID_ARGUMENT;
+      }
+      else if (log_id < entries_[0].log_id_ || log_id >= end_log_id_)
+      {
+        err = OB_ENTRY_NOT_EXIST;
+      }
+      else
+      {
+        while (start < end)
+        {
+          mid = (start + end + 1) / 2;
+          if (entries_[mid].log_id_ <= log_id)
+          {
+            start = mid;
+          }
+          else
+          {
+            end = mid - 1;
+          }
+        }
+        if (entries_[start].log_id_ == log_id)
+        {
+          offset = entries_[start].offset_;
+        }
+        else if (OB_SUCCESS != (err = get_log_offset_in_range_func(log_dir, file_id_, entries_[start].offset_,
+                                                                    start + 1 < entry_num_? entries_[start + 1].offset_: end_offset_,
+                                                                    log_id, offset)))
+        {
+          TBSYS_LOG(ERROR, "get_log_offset_in_range(file_id=%ld, offset=%ld, log_id=%ld)=>%d",
+                    file_id_, entries_[start].offset_, log_id, err);
+        }
+      }
+      return err;
+    }
+
+    // 只用于已经写完的日志文件, has_index为false时调用者需要退回到顺序扫描
+    int get_log_file_offset_by_index_func(const char* log_dir, const int64_t file_id, const int64_t log_id,
+                                          int64_t& offset, bool& has_index)
+    {
+      int err = OB_SUCCESS;
+      int tmp_err = OB_SUCCESS;
+      ObLogFileIndex log_index;
+      has_index = false;
+      if (NULL == log_dir || 0 >= file_id)
+      {
+        err = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (err = log_index.load(log_dir, file_id))
+               && OB_ENTRY_NOT_EXIST != err)
+      {
+        TBSYS_LOG(ERROR, "log_index.load(file_id=%ld)=>%d", file_id, err);
+      }
+      else if (OB_SUCCESS == err)
+      {
+        has_index = true;
+      }
+      else if (OB_SUCCESS != (err = log_index.build(log_dir, file_id)))
+      {
+        if (OB_ENTRY_NOT_EXIST != err)
+        {
+          TBSYS_LOG(ERROR, "log_index.build(file_id=%ld)=>%d", file_id, err);
+        }
+        else
+        {
+          err = OB_SUCCESS;
+        }
+      }
+      else
+      {
+        has_index = true;
+        if (OB_SUCCESS != (tmp_err = log_index.store(log_dir)))
+        {
+          TBSYS_LOG(WARN, "log_index.store(file_id=%ld)=>%d", file_id, tmp_err);
+        }
+      }
+
+      if (OB_SUCCESS == err && has_index
+          && OB_SUCCESS != (err = log_index.get_offset(log_dir, log_id, offset))
+          && OB_ENTRY_NOT_EXIST != err)
+      {
+        TBSYS_LOG(ERROR, "log_index.get_offset(file_id=%ld, log_id=%ld)=>%d", file_id, log_id, err);
+      }
+      return err;
+    }
+
+    ObOnDiskLogLocator::ObOnDiskLogLocator(): enable_log_id_cache_(true), enable_log_index_(true), log_dir_(NULL)
     {}
 
     ObOnDiskLogLocator::~ObOnDiskLogLocator()
@@ -364,6 +900,7 @@ namespace oceanbase
       int64_t max_log_file_id = 0;
       int64_t file_id = 0;
       int64_t offset = 0;
+      bool has_index = false;
       if (!is_inited())
       {
         err = OB_NOT_INIT;
@@ -383,7 +920,15 @@ namespace oceanbase
                     log_dir_, max_log_file_id, log_id, err);
         }
       }
-      else if (OB_SUCCESS != (err = get_log_file_offset_func(log_dir_, file_id, log_id, offset)))
+      else if (enable_log_index_ && file_id < max_log_file_id
+               && OB_SUCCESS != (err = get_log_file_offset_by_index_func(log_dir_, file_id, log_id, offset, has_index)))
+      {
+        if (OB_ENTRY_NOT_EXIST != err)
+        {
+          TBSYS_LOG(ERROR, "get_log_file_offset_by_index(log_dir=%s, file_id=%ld, log_id=%ld)=>%d", log_dir_, file_id, log_id, err);
+        }
+      }
+      else if (!has_index && OB_SUCCESS != (err = get_log_file_offset_func(log_dir_, file_id, log_id, offset)))
       {
         if (OB_ENTRY_NOT_EXIST != err)
         {
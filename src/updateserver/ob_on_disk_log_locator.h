@@ -23,6 +23,51 @@ namespace oceanbase
   {
     typedef ObRecentCache<int64_t, int64_t> ObFirstLogIdCache;
     int get_first_log_id_func(const char* log_dir, const int64_t file_id, int64_t& log_id, ObFirstLogIdCache* log_id_cache = NULL);
+
+    // 已经写完(以SWITCH_LOG结尾)的日志文件的稀疏索引, 保存在log_dir/file_id.index,
+    // 每隔interval_字节记录一条日志的(log_id, offset)。
+    // 第一次定位到某个文件时顺序扫描一遍建立索引, 之后的定位只需要二分查找索引,
+    // 再从最近的索引点向后读不超过一个间隔的数据。
+    // 索引项超过MAX_ENTRY_NUM时丢掉一半, 间隔加倍, 所以索引文件的大小是有上限的。
+    class ObLogFileIndex
+    {
+      public:
+        static const int64_t MAGIC = 0x4c4f47494458; // "LOGIDX"
+        static const int64_t VERSION = 1;
+        static const int64_t MAX_ENTRY_NUM = 1<<10;
+        static const int64_t DEFAULT_INTERVAL = 1<<18;
+        struct Entry
+        {
+          int64_t log_id_;
+          int64_t offset_;
+        };
+      public:
+        ObLogFileIndex();
+        ~ObLogFileIndex();
+        void reset();
+        // 文件不是以SWITCH_LOG结尾时返回OB_ENTRY_NOT_EXIST, 这种文件可能还在写, 不能建立索引
+        int build(const char* log_dir, const int64_t file_id, const int64_t interval = DEFAULT_INTERVAL);
+        // 索引文件不存在, 或者与日志文件对不上时返回OB_ENTRY_NOT_EXIST
+        int load(const char* log_dir, const int64_t file_id);
+        int store(const char* log_dir) const;
+        // 返回log_id所在的位置, log_id不在这个文件中时返回OB_ENTRY_NOT_EXIST
+        int get_offset(const char* log_dir, const int64_t log_id, int64_t& offset) const;
+        int64_t get_entry_num() const { return entry_num_; }
+      protected:
+        void add_entry_(const int64_t log_id, const int64_t offset);
+        int64_t get_serialize_size_() const;
+        int serialize_(char* buf, const int64_t len, int64_t& pos) const;
+        int deserialize_(const char* buf, const int64_t len, int64_t& pos);
+      private:
+        int64_t file_id_;
+        int64_t file_size_;
+        int64_t end_log_id_; // SWITCH_LOG的下一条日志ID
+        int64_t end_offset_; // SWITCH_LOG结束的位置
+        int64_t interval_;
+        int64_t entry_num_;
+        Entry entries_[MAX_ENTRY_NUM];
+    };
+
     // 通过扫描磁盘文件定位日志
     class ObOnDiskLogLocator : public IObLogLocator
     {
@@ -31,11 +76,13 @@ namespace oceanbase
         ObOnDiskLogLocator();
         virtual ~ObOnDiskLogLocator();
         int init(const char* log_dir);
+        void set_enable_log_index(const bool enable) { enable_log_index_ = enable; }
         virtual int get_location(const int64_t log_id, ObLogLocation& location);
       protected:
         bool is_inited() const;
       private:
         bool enable_log_id_cache_;
+        bool enable_log_index_;
         ObFirstLogIdCache first_log_id_cache_;
         const char* log_dir_;
     };
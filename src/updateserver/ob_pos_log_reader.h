@@ -16,7 +16,7 @@
 #define OCEANBASE_UPDATESERVER_OB_POS_LOG_READER_H_
 #include "ob_log_locator.h"
 #include "ob_on_disk_log_locator.h"
-#include "ob_located_log_reader.h"
+#include "ob_mmap_log_reader.h"
 
 namespace oceanbase
 {
@@ -36,7 +36,7 @@ namespace oceanbase
       private:
         char log_dir_[OB_MAX_FILE_NAME_LENGTH];
         ObOnDiskLogLocator on_disk_log_locator_;
-        ObLocatedLogReader located_log_reader_;
+        ObMmapLogReader located_log_reader_; // 追日志时大块顺序读, 减少对磁盘的小块随机读
     };
   }; // end namespace updateserver
 }; // end namespace oceanbase
@@ -29,10 +29,12 @@ namespace oceanbase
 
     int64_t QueryEngine::HASH_SIZE = 50000000;
     QueryEngine::QueryEngine(MemTank &allocer) : inited_(false),
+                                                 using_skiplist_(false),
                                                  btree_alloc_(allocer),
                                                  hash_alloc_(allocer),
                                                  keybtree_(btree_alloc_),
-                                                 keyhash_(hash_alloc_, hash_alloc_)
+                                                 keyhash_(hash_alloc_, hash_alloc_),
+                                                 keyskiplist_(allocer)
     {
     }
 
@@ -54,16 +56,24 @@ namespace oceanbase
       }
       else
       {
+        using_skiplist_ = g_conf.using_skiplist_index;
         if (OB_SUCCESS != (ret = keyhash_.create(hash::cal_next_prime(hash_size?: HASH_SIZE))))
         {
           TBSYS_LOG(WARN, "keyhash create fail");
         }
-        else if (ERROR_CODE_OK != (ret = keybtree_.init()))
+        else if (using_skiplist_
+                && OB_SUCCESS != (ret = keyskiplist_.init()))
+        {
+          TBSYS_LOG(WARN, "keyskiplist init fail");
+        }
+        else if (!using_skiplist_
+                && ERROR_CODE_OK != (ret = keybtree_.init()))
         {
           TBSYS_LOG(WARN, "keybtree init fail");
         }
         else
         {
+          TBSYS_LOG(INFO, "query engine init succ using_skiplist=%s", STR_BOOL(using_skiplist_));
           inited_ = true;
         }
       }
@@ -79,7 +89,14 @@ namespace oceanbase
       }
       else
       {
-        keybtree_.destroy();
+        if (using_skiplist_)
+        {
+          keyskiplist_.destroy();
+        }
+        else
+        {
+          keybtree_.destroy();
+        }
         keyhash_.destroy();
         inited_ = false;
       }
@@ -95,7 +112,14 @@ namespace oceanbase
       }
       else
       {
-        keybtree_.clear();
+        if (using_skiplist_)
+        {
+          keyskiplist_.clear();
+        }
+        else
+        {
+          keybtree_.clear();
+        }
         keyhash_.clear();
       }
       return ret;
@@ -132,7 +156,18 @@ namespace oceanbase
       else
       {
         value->index_stat |= IST_HASH_INDEX;
-        if (ERROR_CODE_OK != (btree_ret = keybtree_.put(key, value, true)))
+        if (using_skiplist_)
+        {
+          // hash索引已经保证了key的唯一, 跳表插入不会返回OB_ENTRY_EXIST
+          int skiplist_ret = keyskiplist_.set(key, value);
+          btree_ret = (OB_SUCCESS == skiplist_ret) ? ERROR_CODE_OK
+                      : ((OB_MEM_OVERFLOW == skiplist_ret) ? ERROR_CODE_ALLOC_FAIL : skiplist_ret);
+        }
+        else
+        {
+          btree_ret = keybtree_.put(key, value, true);
+        }
+        if (ERROR_CODE_OK != btree_ret)
         {
           TBSYS_LOG(WARN, "put to keybtree fail btree_ret=%d [%s] [%s]",
                     btree_ret, key.log_str(), value->log_str());
@@ -143,7 +178,8 @@ namespace oceanbase
         else
         {
           value->index_stat |= IST_BTREE_INDEX;
-          TBSYS_LOG(DEBUG, "insert to hash and btree succ %s %s", key.log_str(), value->log_str());
+          TBSYS_LOG(DEBUG, "insert to hash and %s succ %s %s",
+                    using_skiplist_ ? "skiplist" : "btree", key.log_str(), value->log_str());
         }
       }
       return ret;
@@ -187,6 +223,18 @@ namespace oceanbase
           }
         }
       }
+      else if (using_skiplist_)
+      {
+        int skiplist_ret = OB_SUCCESS;
+        if (OB_SUCCESS != (skiplist_ret = keyskiplist_.get(key, ret)))
+        {
+          if (OB_ENTRY_NOT_EXIST != skiplist_ret)
+          {
+            TBSYS_LOG(WARN, "get from keyskiplist fail skiplist_ret=%d %s", skiplist_ret, key.log_str());
+          }
+          ret = NULL;
+        }
+      }
       else
       {
         int btree_ret = ERROR_CODE_OK;
@@ -218,6 +266,19 @@ namespace oceanbase
         TBSYS_LOG(WARN, "have not inited");
         ret = OB_ERROR;
       }
+      else if (using_skiplist_)
+      {
+        if (OB_SUCCESS != (ret = keyskiplist_.scan(start_key, min_key, start_exclude,
+                                                   end_key, max_key, end_exclude,
+                                                   reverse, iter.get_skiplist_iter_())))
+        {
+          TBSYS_LOG(WARN, "keyskiplist scan fail ret=%d", ret);
+        }
+        else
+        {
+          iter.set_(&keyskiplist_);
+        }
+      }
       else if (ERROR_CODE_OK != (btree_ret = keybtree_.get_scan_handle(iter.get_read_handle_())))
       {
         TBSYS_LOG(WARN, "btree get scan handle fail btree_ret=%d", btree_ret);
@@ -294,6 +355,22 @@ namespace oceanbase
       return ret;
     }
 
+    void QueryEngine::dump_row_(FILE *fd, const int64_t num, const TEKey &key, TEValue *value)
+    {
+      MemTableGetIter get_iter;
+      fprintf(fd, "[ROW_INFO][%ld] btree_key=[%s] btree_value=[%s] ptr=%p\n",
+              num, key.log_str(), value->log_str(), value);
+      int64_t pos = 0;
+      ObCellInfo *ci = NULL;
+      get_iter.set_(key, value, NULL, true, NULL);
+      while (OB_SUCCESS == get_iter.next_cell()
+            && OB_SUCCESS == get_iter.get_cell(&ci))
+      {
+        fprintf(fd, "          [CELL_INFO][%ld][%ld] column_id=%lu value=[%s]\n",
+                num, pos++, ci->column_id_, print_obj(ci->value_));
+      }
+    }
+
     void QueryEngine::dump2text(const char *fname)
     {
       const int64_t BUFFER_SIZE = 1024;
@@ -302,33 +379,36 @@ namespace oceanbase
       FILE *fd = fopen(buffer, "w");
       if (NULL != fd)
       {
-        keybtree_t::TScanHandle handle;
-        TEKey btree_min_key;
-        TEKey btree_max_key;
-        if (ERROR_CODE_OK == keybtree_.get_scan_handle(handle)
-            && ERROR_CODE_OK == keybtree_.get_min_key(btree_min_key)
-            && ERROR_CODE_OK == keybtree_.get_max_key(btree_max_key))
+        TEKey key;
+        TEValue *value = NULL;
+        int64_t num = 0;
+        if (using_skiplist_)
+        {
+          SkiplistEngineIterator iter;
+          if (OB_SUCCESS == keyskiplist_.scan(key, 1, 0, key, 1, 0, false, iter))
+          {
+            while (OB_SUCCESS == iter.next(key, value)
+                  && NULL != value)
+            {
+              dump_row_(fd, num++, key, value);
+            }
+          }
+        }
+        else
         {
-          keybtree_.set_key_range(handle, btree_min_key, 0, btree_max_key, 0);
-          TEKey key;
-          TEValue *value = NULL;
-          MemTableGetIter get_iter;
-          int64_t num = 0;
-          while (ERROR_CODE_OK == keybtree_.get_next(handle, key, value)
-                && NULL != value)
+          keybtree_t::TScanHandle handle;
+          TEKey btree_min_key;
+          TEKey btree_max_key;
+          if (ERROR_CODE_OK == keybtree_.get_scan_handle(handle)
+              && ERROR_CODE_OK == keybtree_.get_min_key(btree_min_key)
+              && ERROR_CODE_OK == keybtree_.get_max_key(btree_max_key))
           {
-            fprintf(fd, "[ROW_INFO][%ld] btree_key=[%s] btree_value=[%s] ptr=%p\n",
-                    num, key.log_str(), value->log_str(), value);
-            int64_t pos = 0;
-            ObCellInfo *ci = NULL;
-            get_iter.set_(key, value, NULL, true, NULL);
-            while (OB_SUCCESS == get_iter.next_cell()
-                  && OB_SUCCESS == get_iter.get_cell(&ci))
+            keybtree_.set_key_range(handle, btree_min_key, 0, btree_max_key, 0);
+            while (ERROR_CODE_OK == keybtree_.get_next(handle, key, value)
+                  && NULL != value)
             {
-              fprintf(fd, "          [CELL_INFO][%ld][%ld] column_id=%lu value=[%s]\n",
-                      num, pos++, ci->column_id_, print_obj(ci->value_));
+              dump_row_(fd, num++, key, value);
             }
-            ++num;
           }
         }
         fclose(fd);
@@ -337,22 +417,29 @@ namespace oceanbase
 
     int64_t QueryEngine::btree_size()
     {
-      return keybtree_.get_object_count();
+      return using_skiplist_ ? keyskiplist_.size() : keybtree_.get_object_count();
     }
 
     int64_t QueryEngine::btree_alloc_memory()
     {
-      return keybtree_.get_alloc_memory();
+      return using_skiplist_ ? keyskiplist_.alloc_memory() : keybtree_.get_alloc_memory();
     }
 
     int64_t QueryEngine::btree_reserved_memory()
     {
-      return keybtree_.get_reserved_memory();
+      return using_skiplist_ ? keyskiplist_.alloc_memory() : keybtree_.get_reserved_memory();
     }
 
     void QueryEngine::btree_dump_mem_info()
     {
-      keybtree_.dump_mem_info();
+      if (using_skiplist_)
+      {
+        TBSYS_LOG(INFO, "keyskiplist size=%ld alloc_memory=%ld", keyskiplist_.size(), keyskiplist_.alloc_memory());
+      }
+      else
+      {
+        keybtree_.dump_mem_info();
+      }
     }
 
     int64_t QueryEngine::hash_size() const
@@ -372,7 +459,9 @@ namespace oceanbase
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    QueryEngineIterator::QueryEngineIterator() : keybtree_(NULL), read_handle_(), key_(), pvalue_(NULL)
+    QueryEngineIterator::QueryEngineIterator() : keybtree_(NULL), read_handle_(),
+                                                 keyskiplist_(NULL), skiplist_iter_(),
+                                                 key_(), pvalue_(NULL)
     {
     }
 
@@ -384,7 +473,18 @@ namespace oceanbase
     {
       int ret = OB_SUCCESS;
       int btree_ret = ERROR_CODE_OK;
-      if (NULL == keybtree_)
+      if (NULL != keyskiplist_)
+      {
+        while (OB_SUCCESS == (ret = skiplist_iter_.next(key_, pvalue_)))
+        {
+          if (NULL != pvalue_
+              && !pvalue_->is_empty())
+          {
+            break;
+          }
+        }
+      }
+      else if (NULL == keybtree_)
       {
         ret = OB_ITER_END;
       }
@@ -430,12 +530,22 @@ namespace oceanbase
     {
       keybtree_ = NULL;
       read_handle_.reset();
+      keyskiplist_ = NULL;
+      skiplist_iter_.reset();
       pvalue_ = NULL;
     }
 
     void QueryEngineIterator::set_(QueryEngine::keybtree_t *keybtree)
     {
       keybtree_ = keybtree;
+      keyskiplist_ = NULL;
+      pvalue_ = NULL;
+    }
+
+    void QueryEngineIterator::set_(SkiplistEngine *keyskiplist)
+    {
+      keybtree_ = NULL;
+      keyskiplist_ = keyskiplist;
       pvalue_ = NULL;
     }
 
@@ -444,6 +554,11 @@ namespace oceanbase
       return read_handle_;
     }
 
+    SkiplistEngineIterator &QueryEngineIterator::get_skiplist_iter_()
+    {
+      return skiplist_iter_;
+    }
+
   }
 }
 
@@ -34,6 +34,7 @@
 #include "ob_memtank.h"
 #include "ob_btree_engine_alloc.h"
 #include "ob_lighty_hash.h"
+#include "ob_skiplist_engine.h"
 
 namespace oceanbase
 {
@@ -129,12 +130,18 @@ namespace oceanbase
         int64_t hash_size() const;
         int64_t hash_bucket_using() const;
         int64_t hash_uninit_unit_num() const;
+        bool using_skiplist() const {return using_skiplist_;};
+      private:
+        static void dump_row_(FILE *fd, const int64_t num, const TEKey &key, TEValue *value);
       private:
         bool inited_;
+        // init时根据g_conf.using_skiplist_index选择有序索引, 之后不再改变
+        bool using_skiplist_;
         BtreeEngineAllocator btree_alloc_;
         HashEngineAllocator hash_alloc_;
         keybtree_t keybtree_;
         keyhash_t keyhash_;
+        SkiplistEngine keyskiplist_;
     };
 
     class QueryEngineIterator
@@ -154,10 +161,14 @@ namespace oceanbase
         void reset();
       private:
         void set_(QueryEngine::keybtree_t *keybtree);
+        void set_(SkiplistEngine *keyskiplist);
         QueryEngine::keybtree_t::TScanHandle &get_read_handle_();
+        SkiplistEngineIterator &get_skiplist_iter_();
       private:
         QueryEngine::keybtree_t *keybtree_;
         QueryEngine::keybtree_t::TScanHandle read_handle_;
+        SkiplistEngine *keyskiplist_;
+        SkiplistEngineIterator skiplist_iter_;
         TEKey key_;
         TEValue *pvalue_;
     };
@@ -613,7 +613,7 @@ namespace oceanbase
         while (host->run_flag_)
         {
           void *task = NULL;
-          if (OB_SUCCESS != (err = host->task_queue_.get(seq, task, QUEUE_WAIT_TIME))
+          if (OB_SUCCESS != (err = host->task_queue_.get(seq, task, host->get_wait_time()))
             && OB_EAGAIN != err)
           {
             TBSYS_LOG(ERROR, "get(seq=%ld)=>%d", seq, err);
@@ -623,10 +623,14 @@ namespace oceanbase
           {
             host->handle(task, pdata);
           }
-          else if ((host->last_idle_time_ + host->idle_interval_) <= tbsys::CTimeUtil::getTime())
+          else
           {
-            host->on_idle();
-            host->last_idle_time_ = tbsys::CTimeUtil::getTime();
+            host->on_wait_timeout();
+            if ((host->last_idle_time_ + host->idle_interval_) <= tbsys::CTimeUtil::getTime())
+            {
+              host->on_idle();
+              host->last_idle_time_ = tbsys::CTimeUtil::getTime();
+            }
           }
         }
         host->on_end(pdata);
@@ -147,6 +147,8 @@ namespace oceanbase
         virtual void *on_begin() {return NULL;};
         virtual void on_end(void *ptr) {UNUSED(ptr);};
         virtual void on_idle() {};
+        virtual void on_wait_timeout() {};
+        virtual int64_t get_wait_time() {return QUEUE_WAIT_TIME;};
         virtual int64_t get_seq(void* task) = 0;
       private:
         static void *thread_func_(void *data);
@@ -0,0 +1,75 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_row_modify_tracker.cpp for tracking the last commited trans id
+ * of each row modify slot.
+ *
+ */
+#include <string.h>
+#include <tbsys.h>
+#include "ob_row_modify_tracker.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    using namespace common;
+
+    ObRowModifyTracker::ObRowModifyTracker()
+      : epoch_(tbsys::CTimeUtil::getTime())
+    {
+      memset((void*)slot_trans_ids_, 0, sizeof(slot_trans_ids_));
+    }
+
+    ObRowModifyTracker::~ObRowModifyTracker()
+    {
+    }
+
+    void ObRowModifyTracker::on_row_commit(const int64_t slot, const int64_t trans_id)
+    {
+      int64_t old_trans_id = 0;
+      if (slot >= 0 && slot < ROW_MODIFY_SLOT_NUM)
+      {
+        while ((old_trans_id = slot_trans_ids_[slot]) < trans_id
+               && !__sync_bool_compare_and_swap(&slot_trans_ids_[slot], old_trans_id, trans_id))
+        {
+          PAUSE();
+        }
+      }
+    }
+
+    int ObRowModifyTracker::get_modified_slots(const int64_t last_trans_id,
+                                               const int64_t commited_trans_id,
+                                               ObRowModifySlots& slots) const
+    {
+      int ret = OB_SUCCESS;
+      int64_t trans_id = 0;
+
+      slots.reset();
+      slots.set_ups_epoch(epoch_);
+      slots.set_commited_trans_id(commited_trans_id);
+      // commit callbacks of all trans not after commited_trans_id have
+      // finished, make their slots visible before scanning.
+      __sync_synchronize();
+      if (0 >= last_trans_id)
+      {
+        // chunkserver has no base to compare with, it starts over.
+        slots.set_overflow();
+      }
+      for (int64_t i = 0; !slots.is_overflow() && i < ROW_MODIFY_SLOT_NUM; ++i)
+      {
+        if ((trans_id = slot_trans_ids_[i]) > last_trans_id)
+        {
+          slots.add_slot(i, trans_id);
+        }
+      }
+      return ret;
+    }
+  } // end namespace updateserver
+} // end namespace oceanbase
@@ -0,0 +1,67 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_row_modify_tracker.h for tracking the last commited trans id
+ * of each row modify slot.
+ *
+ */
+#ifndef OCEANBASE_UPDATESERVER_OB_ROW_MODIFY_TRACKER_H_
+#define OCEANBASE_UPDATESERVER_OB_ROW_MODIFY_TRACKER_H_
+
+#include "common/ob_define.h"
+#include "common/ob_row_modify_slots.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    /**
+     * every commited row mutation raises the trans id of the row's
+     * slot, chunkserver polls the slots modified since its last poll
+     * to find out which cached fused rows are stale.
+     *
+     * the slots are kept in memory only, epoch is the time when the
+     * tracker was created, chunkserver drops all cached rows when it
+     * sees a different epoch (updateserver restart or master switch).
+     */
+    class ObRowModifyTracker
+    {
+      public:
+        ObRowModifyTracker();
+        ~ObRowModifyTracker();
+
+        // called by the row commit callback of memtable.
+        void on_row_commit(const int64_t slot, const int64_t trans_id);
+
+        /**
+         * collect the slots whose trans id is greater than
+         * last_trans_id.
+         *
+         * @param commited_trans_id commited trans id of session mgr,
+         *                          it must be read before this call.
+         */
+        int get_modified_slots(const int64_t last_trans_id,
+                               const int64_t commited_trans_id,
+                               common::ObRowModifySlots& slots) const;
+
+        inline int64_t get_epoch() const
+        {
+          return epoch_;
+        }
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObRowModifyTracker);
+
+        int64_t epoch_;
+        volatile int64_t slot_trans_ids_[common::ROW_MODIFY_SLOT_NUM];
+    };
+  } // end namespace updateserver
+} // end namespace oceanbase
+
+#endif //OCEANBASE_UPDATESERVER_OB_ROW_MODIFY_TRACKER_H_
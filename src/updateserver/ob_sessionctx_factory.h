@@ -34,14 +34,18 @@ namespace oceanbase
     typedef BaseSessionCtx ROSessionCtx;
 
 
+    class ObRowModifyTracker;
     struct TEValueUCInfo
     {
       TEValue *value;
       uint32_t session_descriptor;
       int16_t uc_cell_info_cnt;
       int16_t uc_cell_info_size;
+      int16_t uc_list_node_cnt;
       ObCellInfoNode *uc_list_head;
       ObCellInfoNode *uc_list_tail;
+      ObRowModifyTracker *modify_tracker;
+      int64_t modify_slot;
       TEValueUCInfo()
       {
         reset();
@@ -52,8 +56,11 @@ namespace oceanbase
         session_descriptor = INVALID_SESSION_DESCRIPTOR;
         uc_cell_info_cnt = 0;
         uc_cell_info_size = 0;
+        uc_list_node_cnt = 0;
         uc_list_head = NULL;
         uc_list_tail = NULL;
+        modify_tracker = NULL;
+        modify_slot = -1;
       };
     };
 
@@ -0,0 +1,436 @@
+////===================================================================
+ //
+ // ob_skiplist_engine.cpp updateserver / Oceanbase
+ //
+ // Copyright (C) 2010, 2013 Taobao.com, Inc.
+ //
+ // -------------------------------------------------------------------
+ //
+ // Description
+ //
+ //
+ // -------------------------------------------------------------------
+ //
+ // Change Log
+ //
+////====================================================================
+
+#include "common/ob_malloc.h"
+#include "ob_skiplist_engine.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    using namespace common;
+
+    SkiplistEngine::SkiplistEngine(MemTank &allocer) : inited_(false),
+                                                       allocer_(allocer),
+                                                       head_(NULL),
+                                                       size_(0),
+                                                       alloc_memory_(0)
+    {
+    }
+
+    SkiplistEngine::~SkiplistEngine()
+    {
+      if (inited_)
+      {
+        destroy();
+      }
+    }
+
+    int SkiplistEngine::init()
+    {
+      int ret = OB_SUCCESS;
+      int64_t head_size = sizeof(Node) + MAX_LEVEL * sizeof(Node*);
+      if (inited_)
+      {
+        TBSYS_LOG(WARN, "have already inited");
+        ret = OB_ERROR;
+      }
+      else if (NULL == (head_ = (Node*)ob_malloc(head_size, ObModIds::OB_UPS_MEMTABLE_INDEX)))
+      {
+        TBSYS_LOG(WARN, "alloc skiplist head fail size=%ld", head_size);
+        ret = OB_MEM_OVERFLOW;
+      }
+      else
+      {
+        memset(head_, 0, head_size);
+        head_->level = MAX_LEVEL;
+        size_ = 0;
+        alloc_memory_ = 0;
+        inited_ = true;
+      }
+      return ret;
+    }
+
+    int SkiplistEngine::destroy()
+    {
+      int ret = OB_SUCCESS;
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+      }
+      else
+      {
+        ob_free(head_);
+        head_ = NULL;
+        size_ = 0;
+        alloc_memory_ = 0;
+        inited_ = false;
+      }
+      return ret;
+    }
+
+    int SkiplistEngine::clear()
+    {
+      int ret = OB_SUCCESS;
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+      }
+      else
+      {
+        for (int64_t i = 0; i < MAX_LEVEL; i++)
+        {
+          head_->next[i] = NULL;
+        }
+        size_ = 0;
+      }
+      return ret;
+    }
+
+    int64_t SkiplistEngine::random_level_()
+    {
+      static __thread uint64_t seed = 0;
+      if (0 == seed)
+      {
+        seed = (uint64_t)tbsys::CTimeUtil::getTime() ^ (uint64_t)pthread_self();
+        seed = (0 == seed) ? 1 : seed;
+      }
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      uint64_t rand = seed;
+      int64_t level = 1;
+      // 每层的概率为1/4
+      while (level < MAX_LEVEL
+            && 0 == (rand & 0x3))
+      {
+        level++;
+        rand >>= 2;
+      }
+      return level;
+    }
+
+    SkiplistEngine::Node *SkiplistEngine::alloc_node_(const TEKey &key, TEValue *value, const int64_t level)
+    {
+      Node *ret = NULL;
+      int64_t size = sizeof(Node) + level * sizeof(Node*);
+      void *buffer = allocer_.btree_engine_alloc(upper_align(size, sizeof(void*)) + sizeof(void*));
+      if (NULL != buffer)
+      {
+        ret = (Node*)upper_align((int64_t)buffer, sizeof(void*));
+        ret->key = key;
+        ret->value = value;
+        ret->level = level;
+        for (int64_t i = 0; i < level; i++)
+        {
+          ret->next[i] = NULL;
+        }
+        ATOMIC_ADD(&alloc_memory_, size);
+      }
+      return ret;
+    }
+
+    SkiplistEngine::Node *SkiplistEngine::find_(const TEKey &key, Node **preds, Node **succs) const
+    {
+      Node *pred = head_;
+      Node *cur = NULL;
+      for (int64_t i = MAX_LEVEL - 1; i >= 0; i--)
+      {
+        cur = pred->next[i];
+        while (NULL != cur
+              && 0 > (cur->key - key))
+        {
+          pred = cur;
+          cur = pred->next[i];
+        }
+        if (NULL != preds)
+        {
+          preds[i] = pred;
+        }
+        if (NULL != succs)
+        {
+          succs[i] = cur;
+        }
+      }
+      return cur;
+    }
+
+    SkiplistEngine::Node *SkiplistEngine::lower_bound_(const TEKey &key, const int exclude) const
+    {
+      Node *ret = find_(key, NULL, NULL);
+      if (0 != exclude
+          && NULL != ret
+          && 0 == (ret->key - key))
+      {
+        ret = ret->next[0];
+      }
+      return ret;
+    }
+
+    SkiplistEngine::Node *SkiplistEngine::upper_bound_(const TEKey &key, const int exclude) const
+    {
+      Node *pred = head_;
+      Node *cur = NULL;
+      for (int64_t i = MAX_LEVEL - 1; i >= 0; i--)
+      {
+        cur = pred->next[i];
+        while (NULL != cur)
+        {
+          int cmp = cur->key - key;
+          if (0 > cmp
+              || (0 == cmp && 0 == exclude))
+          {
+            pred = cur;
+            cur = pred->next[i];
+          }
+          else
+          {
+            break;
+          }
+        }
+      }
+      return (head_ == pred) ? NULL : pred;
+    }
+
+    SkiplistEngine::Node *SkiplistEngine::last_() const
+    {
+      Node *pred = head_;
+      Node *cur = NULL;
+      for (int64_t i = MAX_LEVEL - 1; i >= 0; i--)
+      {
+        while (NULL != (cur = pred->next[i]))
+        {
+          pred = cur;
+        }
+      }
+      return (head_ == pred) ? NULL : pred;
+    }
+
+    SkiplistEngine::Node *SkiplistEngine::prev_(const Node *cur, Node **preds) const
+    {
+      // 扫描期间可能有节点插入到preds[0]和cur之间, 先在最底层向后找到cur真正的前驱
+      Node *ret = preds[0];
+      Node *next = NULL;
+      while (NULL != (next = ret->next[0])
+            && cur != next
+            && 0 > (next->key - cur->key))
+      {
+        ret = next;
+      }
+      if (head_ == ret)
+      {
+        ret = NULL;
+      }
+      else
+      {
+        // 所有节点都先链入最底层, 所以旧的preds[i]都小于cur且不大于ret,
+        // 高于ret->level的层不会等于ret, 仍可作为起点, 只需更新ret所在的层;
+        // preds[i]等于ret时从上一层的前驱出发, 它已经验证小于ret
+        for (int64_t i = ret->level - 1; i >= 0; i--)
+        {
+          Node *pred = (ret != preds[i]) ? preds[i] : ((MAX_LEVEL - 1 == i) ? head_ : preds[i + 1]);
+          while (NULL != (next = pred->next[i])
+                && ret != next
+                && 0 > (next->key - ret->key))
+          {
+            pred = next;
+          }
+          preds[i] = pred;
+        }
+      }
+      return ret;
+    }
+
+    int SkiplistEngine::set(const TEKey &key, TEValue *value)
+    {
+      int ret = OB_SUCCESS;
+      Node *preds[MAX_LEVEL];
+      Node *succs[MAX_LEVEL];
+      Node *node = NULL;
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_ERROR;
+      }
+      else
+      {
+        // 先在最底层链接, 成功之后节点即对读可见
+        while (true)
+        {
+          Node *found = find_(key, preds, succs);
+          if (NULL != found
+              && 0 == (found->key - key))
+          {
+            ret = OB_ENTRY_EXIST;
+            break;
+          }
+          if (NULL == node
+              && NULL == (node = alloc_node_(key, value, random_level_())))
+          {
+            ret = OB_MEM_OVERFLOW;
+            break;
+          }
+          for (int64_t i = 0; i < node->level; i++)
+          {
+            node->next[i] = succs[i];
+          }
+          if (__sync_bool_compare_and_swap(&(preds[0]->next[0]), succs[0], node))
+          {
+            break;
+          }
+        }
+        // 再逐层链接上层索引, 上层只影响查找速度不影响正确性
+        for (int64_t i = 1; OB_SUCCESS == ret && i < node->level; i++)
+        {
+          while (true)
+          {
+            node->next[i] = succs[i];
+            if (__sync_bool_compare_and_swap(&(preds[i]->next[i]), succs[i], node))
+            {
+              break;
+            }
+            find_(key, preds, succs);
+          }
+        }
+        if (OB_SUCCESS == ret)
+        {
+          ATOMIC_ADD(&size_, 1);
+        }
+      }
+      return ret;
+    }
+
+    int SkiplistEngine::get(const TEKey &key, TEValue *&value) const
+    {
+      int ret = OB_SUCCESS;
+      Node *node = NULL;
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_ERROR;
+      }
+      else if (NULL == (node = find_(key, NULL, NULL))
+              || 0 != (node->key - key))
+      {
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else
+      {
+        value = node->value;
+      }
+      return ret;
+    }
+
+    int SkiplistEngine::scan(const TEKey &start_key,
+                            const int min_key,
+                            const int start_exclude,
+                            const TEKey &end_key,
+                            const int max_key,
+                            const int end_exclude,
+                            const bool reverse,
+                            SkiplistEngineIterator &iter) const
+    {
+      int ret = OB_SUCCESS;
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_ERROR;
+      }
+      else
+      {
+        iter.reset();
+        iter.host_ = this;
+        iter.reverse_ = reverse;
+        if (!reverse)
+        {
+          iter.cur_ = (0 != min_key) ? head_->next[0] : lower_bound_(start_key, start_exclude);
+          iter.unbounded_ = (0 != max_key);
+          iter.end_key_ = end_key;
+          iter.end_exclude_ = end_exclude;
+        }
+        else
+        {
+          iter.cur_ = (0 != max_key) ? last_() : upper_bound_(end_key, end_exclude);
+          if (NULL != iter.cur_)
+          {
+            find_(iter.cur_->key, iter.preds_, NULL);
+          }
+          iter.unbounded_ = (0 != min_key);
+          iter.end_key_ = start_key;
+          iter.end_exclude_ = start_exclude;
+        }
+      }
+      return ret;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    SkiplistEngineIterator::SkiplistEngineIterator() : host_(NULL),
+                                                       cur_(NULL),
+                                                       reverse_(false),
+                                                       unbounded_(false),
+                                                       end_exclude_(0),
+                                                       end_key_()
+    {
+    }
+
+    SkiplistEngineIterator::~SkiplistEngineIterator()
+    {
+    }
+
+    int SkiplistEngineIterator::next(TEKey &key, TEValue *&value)
+    {
+      int ret = OB_SUCCESS;
+      if (NULL == host_
+          || NULL == cur_)
+      {
+        ret = OB_ITER_END;
+      }
+      else if (!unbounded_)
+      {
+        int cmp = cur_->key - end_key_;
+        if ((!reverse_ && (0 < cmp || (0 == cmp && 0 != end_exclude_)))
+            || (reverse_ && (0 > cmp || (0 == cmp && 0 != end_exclude_))))
+        {
+          ret = OB_ITER_END;
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        key = cur_->key;
+        value = cur_->value;
+        // 跳表只有后继指针, 反向扫描从保存的每层前驱出发找前一个节点,
+        // 平均每一步只比较常数次
+        cur_ = reverse_ ? host_->prev_(cur_, preds_) : cur_->next[0];
+      }
+      else
+      {
+        cur_ = NULL;
+      }
+      return ret;
+    }
+
+    void SkiplistEngineIterator::reset()
+    {
+      host_ = NULL;
+      cur_ = NULL;
+      reverse_ = false;
+      unbounded_ = false;
+      end_exclude_ = 0;
+    }
+  }
+}
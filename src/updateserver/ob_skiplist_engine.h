@@ -0,0 +1,111 @@
+////===================================================================
+ //
+ // ob_skiplist_engine.h updateserver / Oceanbase
+ //
+ // Copyright (C) 2010, 2013 Taobao.com, Inc.
+ //
+ // -------------------------------------------------------------------
+ //
+ // Description
+ //
+ // memtable的有序索引, 可以替代QueryEngine中的btree
+ // 只插入不删除的无锁跳表: 插入通过CAS逐层链接, 读和扫描不加锁也不重试
+ // 节点内存从MemTank分配, 随memtable一起释放
+ //
+ // -------------------------------------------------------------------
+ //
+ // Change Log
+ //
+////====================================================================
+
+#ifndef  OCEANBASE_UPDATESERVER_SKIPLIST_ENGINE_H_
+#define  OCEANBASE_UPDATESERVER_SKIPLIST_ENGINE_H_
+#include "common/ob_define.h"
+#include "ob_table_engine.h"
+#include "ob_memtank.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    class SkiplistEngineIterator;
+    class SkiplistEngine
+    {
+      friend class SkiplistEngineIterator;
+      public:
+        static const int64_t MAX_LEVEL = 20;
+        struct Node
+        {
+          TEKey key;
+          TEValue *value;
+          int64_t level;
+          Node * volatile next[0];
+        };
+      public:
+        SkiplistEngine(MemTank &allocer);
+        ~SkiplistEngine();
+      public:
+        int init();
+        int destroy();
+        // 只重置索引, 节点内存随MemTank释放
+        int clear();
+      public:
+        // key已存在时返回OB_ENTRY_EXIST
+        int set(const TEKey &key, TEValue *value);
+        // key不存在时返回OB_ENTRY_NOT_EXIST
+        int get(const TEKey &key, TEValue *&value) const;
+        // 参数含义与QueryEngine::scan相同
+        int scan(const TEKey &start_key,
+                const int min_key,
+                const int start_exclude,
+                const TEKey &end_key,
+                const int max_key,
+                const int end_exclude,
+                const bool reverse,
+                SkiplistEngineIterator &iter) const;
+        int64_t size() const {return size_;};
+        int64_t alloc_memory() const {return alloc_memory_;};
+      private:
+        Node *alloc_node_(const TEKey &key, TEValue *value, const int64_t level);
+        static int64_t random_level_();
+        // 返回第一个不小于key的节点, 同时填充每一层的前驱和后继
+        Node *find_(const TEKey &key, Node **preds, Node **succs) const;
+        // exclude为0时返回第一个>=key的节点, 否则返回第一个>key的节点
+        Node *lower_bound_(const TEKey &key, const int exclude) const;
+        // exclude为0时返回最后一个<=key的节点, 否则返回最后一个<key的节点
+        Node *upper_bound_(const TEKey &key, const int exclude) const;
+        Node *last_() const;
+        // preds为cur在每一层的前驱, 返回cur的前一个节点并把preds更新为它的前驱
+        Node *prev_(const Node *cur, Node **preds) const;
+      private:
+        bool inited_;
+        MemTank &allocer_;
+        Node *head_;
+        volatile int64_t size_;
+        volatile int64_t alloc_memory_;
+    };
+
+    class SkiplistEngineIterator
+    {
+      friend class SkiplistEngine;
+      public:
+        SkiplistEngineIterator();
+        ~SkiplistEngineIterator();
+      public:
+        // 返回OB_ITER_END表示迭代结束
+        int next(TEKey &key, TEValue *&value);
+        void reset();
+      private:
+        const SkiplistEngine *host_;
+        const SkiplistEngine::Node *cur_;
+        // 反向扫描时cur_在每一层的前驱, 避免每一步都从头查找
+        SkiplistEngine::Node *preds_[SkiplistEngine::MAX_LEVEL];
+        bool reverse_;
+        bool unbounded_;
+        int end_exclude_;
+        TEKey end_key_;
+    };
+  }
+}
+
+#endif //OCEANBASE_UPDATESERVER_SKIPLIST_ENGINE_H_
@@ -735,6 +735,7 @@ namespace oceanbase
       ObString compressor_str;
       int store_type = 0;
       int64_t block_size = 0;
+      int64_t row_num = 0;
       ObUpdateServerMain *ups_main = ObUpdateServerMain::get_instance();
       if (!iter.get_sstable_schema(sstable_schema))
       {
@@ -752,6 +753,10 @@ namespace oceanbase
       {
         TBSYS_LOG(WARN, "get block size fail sstable_id=%lu", sstable_id);
       }
+      else if (!iter.get_row_num(row_num))
+      {
+        TBSYS_LOG(WARN, "get row num fail sstable_id=%lu", sstable_id);
+      }
       if (NULL == ups_main)
       {
         TBSYS_LOG(WARN, "get ups main fail");
@@ -768,7 +773,8 @@ namespace oceanbase
         sstable_trailer_param.store_type_ = store_type;
         sstable_trailer_param.block_size_ = block_size;
         sstable_trailer_param.frozen_time_ = time_stamp;
-        int tmp_ret = sstable_writer.create_sstable(sstable_schema, fpaths, sstable_trailer_param);
+        // 按行数生成rowkey bloomfilter写入trailer, 点查询据此跳过不包含该行的sstable
+        int tmp_ret = sstable_writer.create_sstable(sstable_schema, fpaths, sstable_trailer_param, row_num);
         if (OB_SUCCESS != tmp_ret)
         {
           TBSYS_LOG(WARN, "sstable create fail ret=%d sstable_id=%lu", tmp_ret, sstable_id);
@@ -777,6 +783,14 @@ namespace oceanbase
         {
           sstable::ObSSTableRow sstable_row;
           int64_t approx_space_usage = 0;
+          // 按写入sstable的字节数限速, 避免转储的突发写盘影响commit log的写入延迟
+          IOSpeedLimiter io_limiter;
+          int64_t io_limit = get_dump_sstable_io_limit();
+          int64_t charged_size = 0;
+          int64_t dumped_row_num = 0;
+          int64_t start_time = tbsys::CTimeUtil::getTime();
+          int64_t last_log_time = start_time;
+          io_limiter.reset(io_limit, io_limit / DUMP_IO_BURST_DIVISOR);
           while (OB_SUCCESS == (tmp_ret = iter.next_row()))
           {
             if (OB_SUCCESS != (tmp_ret = iter.get_row(sstable_row)))
@@ -808,6 +822,30 @@ namespace oceanbase
             {
               TBSYS_LOG(DEBUG, "append row succ ret=%d table_id=%lu approx_space_usage=%ld",
                         tmp_ret, sstable_row.get_table_id(), approx_space_usage);
+              dumped_row_num++;
+              // block压缩刷盘后approx_space_usage可能回退, 只对新增的部分计费
+              if (charged_size < approx_space_usage)
+              {
+                int64_t sleep_time = io_limiter.acquire(approx_space_usage - charged_size);
+                OB_STAT_INC(UPDATESERVER, UPS_STAT_DUMP_BYTES, approx_space_usage - charged_size);
+                OB_STAT_INC(UPDATESERVER, UPS_STAT_DUMP_THROTTLE_TIMEU, sleep_time);
+                charged_size = approx_space_usage;
+              }
+              if (io_limit != get_dump_sstable_io_limit())
+              {
+                io_limit = get_dump_sstable_io_limit();
+                io_limiter.reset(io_limit, io_limit / DUMP_IO_BURST_DIVISOR);
+                TBSYS_LOG(INFO, "dump sstable io limit changed to %ld sstable_id=%lu", io_limit, sstable_id);
+              }
+              int64_t cur_time = tbsys::CTimeUtil::getTime();
+              if (DUMP_PROGRESS_LOG_INTERVAL_US <= (cur_time - last_log_time))
+              {
+                int64_t timeu = cur_time - start_time;
+                TBSYS_LOG(INFO, "dumping sstable_id=%lu progress=%ld/%ld bytes=%ld timeu=%ld throttle_timeu=%ld speed=%ldKB/s",
+                          sstable_id, dumped_row_num, row_num, charged_size, timeu, io_limiter.get_total_sleep_time(),
+                          (0 < timeu) ? charged_size * 1000000L / 1024L / timeu : 0);
+                last_log_time = cur_time;
+              }
             }
             if (ObUpsRoleMgr::STOP == ups_main->get_update_server().get_role_mgr().get_state())
             {
@@ -819,6 +857,9 @@ namespace oceanbase
           iter.reset_iter();
           int64_t trailer_offset = 0;
           int64_t sstable_size = 0;
+          int64_t dump_timeu = tbsys::CTimeUtil::getTime() - start_time;
+          OB_STAT_INC(UPDATESERVER, UPS_STAT_DUMP_ROW_COUNT, dumped_row_num);
+          OB_STAT_INC(UPDATESERVER, UPS_STAT_DUMP_TIMEU, dump_timeu);
           if (OB_ITER_END != tmp_ret)
           {
             TBSYS_LOG(WARN, "iterate row fail ret=%d", tmp_ret);
@@ -829,7 +870,8 @@ namespace oceanbase
           }
           else
           {
-            TBSYS_LOG(INFO, "build sstable succ trailer_offset=%ld sstable_size=%ld", trailer_offset, sstable_size);
+            TBSYS_LOG(INFO, "build sstable succ sstable_id=%lu trailer_offset=%ld sstable_size=%ld row_num=%ld timeu=%ld throttle_timeu=%ld",
+                      sstable_id, trailer_offset, sstable_size, dumped_row_num, dump_timeu, io_limiter.get_total_sleep_time());
             bret = true;
           }
         }
@@ -104,6 +104,8 @@ namespace oceanbase
         virtual const common::ObRowkeyInfo *get_rowkey_info(const uint64_t table_id) const = 0;
         virtual bool get_store_type(int &store_type) = 0;
         virtual bool get_block_size(int64_t &block_size) = 0;
+        // 行数用于确定sstable的bloomfilter大小
+        virtual bool get_row_num(int64_t &row_num) = 0;
     };
 
     typedef common::ObVector<SSTFileInfo> SSTList;
@@ -368,6 +370,9 @@ namespace oceanbase
     {
       static const int64_t STORE_NUM = 10;
       static const int64_t SSTABLE_NUM = 1024;
+      // 转储限速允许积攒1/10秒的写入量
+      static const int64_t DUMP_IO_BURST_DIVISOR = 10;
+      static const int64_t DUMP_PROGRESS_LOG_INTERVAL_US = 10000000;
       typedef common::hash::ObHashMap<StoreMgr::Handle, int64_t> StoreRefMap;
       typedef common::hash::ObHashMap<uint64_t, SSTableInfo*> SSTableInfoMap;
       typedef common::ObList<ISSTableObserver*> ObserverList;
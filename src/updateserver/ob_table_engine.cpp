@@ -21,6 +21,7 @@
 #include "ob_table_engine.h"
 #include "ob_memtable.h"
 #include "ob_sessionctx_factory.h"
+#include "ob_row_modify_tracker.h"
 
 namespace oceanbase
 {
@@ -347,7 +348,12 @@ namespace oceanbase
                   session.get_trans_id(), &session, session.get_session_descriptor());
         uci->value->cell_info_cnt = (int16_t)(uci->value->cell_info_cnt + uci->uc_cell_info_cnt);
         uci->value->cell_info_size = (int16_t)(uci->value->cell_info_size + uci->uc_cell_info_size);
+        uci->value->list_node_cnt = add_list_node_cnt(uci->value->list_node_cnt, uci->uc_list_node_cnt);
         uci->value->cur_uc_info = NULL;
+        if (NULL != uci->modify_tracker)
+        {
+          uci->modify_tracker->on_row_commit(uci->modify_slot, session.get_trans_id());
+        }
       }
       else
       {
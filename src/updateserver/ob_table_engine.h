@@ -219,12 +219,22 @@ namespace oceanbase
     static const uint8_t IST_HASH_INDEX = 0x1;
     static const uint8_t IST_BTREE_INDEX = 0x2;
 
+    // 节点链长度只用来判断是否需要合并, 有长读事务时可能一直合并不了,
+    // 超过int16_t的范围后停在最大值, 不回绕成负数
+    static const int16_t MAX_LIST_NODE_CNT = INT16_MAX;
+    inline int16_t add_list_node_cnt(const int16_t list_node_cnt, const int64_t delta)
+    {
+      int64_t ret = list_node_cnt + delta;
+      return static_cast<int16_t>((MAX_LIST_NODE_CNT < ret) ? MAX_LIST_NODE_CNT : ret);
+    }
+
     struct TEValueUCInfo;
     struct TEValue
     {
       uint8_t index_stat;
       int16_t cell_info_cnt;
       int16_t cell_info_size; // 单位为1K
+      int16_t list_node_cnt; // 已提交的ObCellInfoNode个数
       ObCellInfoNode *list_head;
       ObCellInfoNode *list_tail;
       TEValueUCInfo *cur_uc_info;
@@ -239,6 +249,7 @@ namespace oceanbase
         index_stat = IST_NO_INDEX;
         cell_info_cnt = 0;
         cell_info_size = 0;
+        list_node_cnt = 0;
         list_head = NULL;
         list_tail = NULL;
         cur_uc_info = NULL;
@@ -249,9 +260,9 @@ namespace oceanbase
         static const int32_t BUFFER_SIZE = 2048;
         static __thread char BUFFER[2][BUFFER_SIZE];
         static __thread uint64_t i = 0;
-        snprintf(BUFFER[i % 2], BUFFER_SIZE, "index_stat=%hhu cell_info_cnt=%hd cell_info_size=%hdKB "
+        snprintf(BUFFER[i % 2], BUFFER_SIZE, "index_stat=%hhu cell_info_cnt=%hd cell_info_size=%hdKB list_node_cnt=%hd "
                 "list_head=%p list_tail=%p cur_uc_info=%p lock_uid=%x lock_nref=%u",
-                 index_stat, cell_info_cnt, cell_info_size,
+                 index_stat, cell_info_cnt, cell_info_size, list_node_cnt,
                  list_head, list_tail, cur_uc_info,
                  row_lock.uid_, row_lock.n_ref_);
         return BUFFER[i++ % 2];
@@ -291,7 +291,9 @@ namespace oceanbase
                                                      nop_cell_(),
                                                      is_row_changed_(false),
                                                      row_has_changed_(false),
-                                                     iter_counter_(0)
+                                                     iter_counter_(0),
+                                                     bf_key_buf_(),
+                                                     row_not_exist_(false)
     {
       nop_cell_.value_.set_ext(ObActionFlag::OP_NOP);
     }
@@ -332,7 +334,11 @@ namespace oceanbase
     int SSTableEntityIterator::next_cell()
     {
       int ret = OB_SUCCESS;
-      if (NULL == sstable_iter_
+      if (row_not_exist_)
+      {
+        ret = OB_ITER_END;
+      }
+      else if (NULL == sstable_iter_
           || NULL == column_filter_)
       {
         TBSYS_LOG(WARN, "invalid sstable_iter=%p column_filter=%p", sstable_iter_, column_filter_);
@@ -526,6 +532,7 @@ namespace oceanbase
       //is_sstable_iter_end_ = false;
       sst_scanner_.cleanup();
       iter_counter_ = 0;
+      row_not_exist_ = false;
     }
 
     ObGetParam &SSTableEntityIterator::get_get_param()
@@ -553,6 +560,16 @@ namespace oceanbase
       return sst_scanner_;
     }
 
+    ObMemBuf &SSTableEntityIterator::get_bf_key_buf()
+    {
+      return bf_key_buf_;
+    }
+
+    void SSTableEntityIterator::set_row_not_exist()
+    {
+      row_not_exist_ = true;
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////
 
     SSTableUtils::SSTableUtils() : trans_descriptor_(0)
@@ -636,6 +653,11 @@ namespace oceanbase
         TBSYS_LOG(WARN, "invalid param column_filter=%p sub_iter=%p", column_filter, sub_iter);
         ret = OB_INVALID_ARGUMENT;
       }
+      else if (!row_may_exist_(table_id, row_key, sub_iter->get_bf_key_buf()))
+      {
+        sub_iter->set_column_filter(column_filter);
+        sub_iter->set_row_not_exist();
+      }
       else
       {
         ObTransferSSTableQuery &sstable_query = ups_main->get_update_server().get_sstable_query();
@@ -703,6 +725,11 @@ namespace oceanbase
         TBSYS_LOG(WARN, "invalid param column_filter=%p sub_iter=%p", column_filter, sub_iter);
         ret = OB_INVALID_ARGUMENT;
       }
+      else if (!row_may_exist_(table_id, row_key, sub_iter->get_bf_key_buf()))
+      {
+        sub_iter->set_column_filter(column_filter);
+        sub_iter->set_row_not_exist();
+      }
       else
       {
         ObTransferSSTableQuery &sstable_query = ups_main->get_update_server().get_sstable_query();
@@ -985,6 +1012,34 @@ namespace oceanbase
       }
     }
 
+    bool SSTableEntity::row_may_exist_(const uint64_t table_id, const ObRowkey &row_key, ObMemBuf &bf_key_buf) const
+    {
+      bool bret = true;
+      int64_t pos = 0;
+      int64_t bf_key_size = sizeof(int64_t) + row_key.get_serialize_size();
+      char *bf_key = NULL;
+      if (using_frozen_bloomfilter()
+          && OB_SUCCESS == bf_key_buf.ensure_space(bf_key_size, ObModIds::OB_SSTABLE_GET_SCAN))
+      {
+        // 与ObSSTableWriter::update_bloom_filter生成key的方式保持一致
+        // 转储sstable只有一个column group, column_group_id为0
+        bf_key = bf_key_buf.get_buffer();
+        if (OB_SUCCESS == serialization::encode_i16(bf_key, bf_key_size, pos, 0)
+            && OB_SUCCESS == serialization::encode_i16(bf_key, bf_key_size, pos, 0)
+            && OB_SUCCESS == serialization::encode_i32(bf_key, bf_key_size, pos, static_cast<int32_t>(table_id))
+            && OB_SUCCESS == row_key.serialize(bf_key, bf_key_size, pos))
+        {
+          OB_STAT_INC(UPDATESERVER, UPS_STAT_BF_CHECK_COUNT, 1);
+          if (!sstable_reader_->may_contain(ObString(0, static_cast<int32_t>(bf_key_size), bf_key)))
+          {
+            OB_STAT_INC(UPDATESERVER, UPS_STAT_BF_SKIP_COUNT, 1);
+            bret = false;
+          }
+        }
+      }
+      return bret;
+    }
+
     int SSTableEntity::get_endkey(const uint64_t table_id, ObTabletInfo &ti)
     {
       int ret = OB_SUCCESS;
@@ -1246,6 +1301,12 @@ namespace oceanbase
         }
         else
         {
+          // 冻结表的bloomfilter在转储线程中构建, 避免阻塞冻结时的提交线程
+          int tmp_ret = OB_SUCCESS;
+          if (OB_SUCCESS != (tmp_ret = memtable_entity_.get_memtable().build_frozen_bloomfilter()))
+          {
+            TBSYS_LOG(WARN, "build frozen bloomfilter fail ret=%d, point get will not skip this memtable", tmp_ret);
+          }
           SSTableMgr &sstable_mgr = ups_main->get_update_server().get_sstable_mgr();
           if (OB_SUCCESS != (ret = sstable_mgr.add_sstable(sstable_entity_.get_sstable_id(), clog_id_, time_stamp_, row_iter_, schema_)))
           {
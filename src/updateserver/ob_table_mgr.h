@@ -105,6 +105,9 @@ namespace oceanbase
         void set_column_filter(common::ColumnFilter *column_filter);
         sstable::ObSSTableGetter &get_sstable_getter();
         sstable::ObSSTableScanner &get_sstable_scanner();
+        common::ObMemBuf &get_bf_key_buf();
+        // bloomfilter判定行不存在时调用, 之后next_cell直接返回OB_ITER_END
+        void set_row_not_exist();
       private:
         common::ObGetParam get_param_;
         common::ObIterator *sstable_iter_;
@@ -123,6 +126,8 @@ namespace oceanbase
         //bool need_not_next_;
         //bool is_sstable_iter_end_;
         int64_t iter_counter_;
+        common::ObMemBuf bf_key_buf_;
+        bool row_not_exist_;
     };
 
     class ITableUtils
@@ -353,6 +358,8 @@ namespace oceanbase
         void destroy_sstable_meta();
         void pre_load_sstable_block_index();
         int get_endkey(const uint64_t table_id, common::ObTabletInfo &ci);
+      private:
+        bool row_may_exist_(const uint64_t table_id, const common::ObRowkey &row_key, common::ObMemBuf &bf_key_buf) const;
       private:
         uint64_t sstable_id_;
         common::ModulePageAllocator mod_;
@@ -44,7 +44,10 @@ namespace oceanbase
                                                         allocator_(),
                                                         session_ctx_factory_(),
                                                         session_mgr_(),
+                                                        scan_stream_mgr_(session_mgr_),
                                                         lock_mgr_(),
+                                                        group_commit_window_(),
+                                                        batch_deadline_(0),
                                                         uncommited_session_list_(),
                                                         ups_result_buffer_(ups_result_memory_, OB_MAX_PACKET_LENGTH)
     {
@@ -82,6 +85,8 @@ namespace oceanbase
       trans_handler_[OB_UPS_SHOW_SESSIONS] = thandle_show_sessions;
       trans_handler_[OB_UPS_KILL_SESSION] = thandle_kill_session;
       trans_handler_[OB_END_TRANSACTION] = thandle_end_session;
+      trans_handler_[OB_SESSION_NEXT_REQUEST] = thandle_scan_stream_next;
+      trans_handler_[OB_SESSION_END] = thandle_scan_stream_end;
 
       commit_handler_[OB_MS_MUTATE] = chandle_write_commit;
       commit_handler_[OB_WRITE] = chandle_write_commit;
@@ -130,6 +135,7 @@ namespace oceanbase
     {
       TransHandlePool::destroy();
       TransCommitThread::destroy();
+      scan_stream_mgr_.destroy();
       session_mgr_.destroy();
       allocator_.destroy();
     }
@@ -247,6 +253,8 @@ namespace oceanbase
         case OB_UPS_SHOW_SESSIONS:
         case OB_UPS_KILL_SESSION:
         case OB_END_TRANSACTION:
+        case OB_SESSION_NEXT_REQUEST:
+        case OB_SESSION_END:
           ret = TransHandlePool::push(&task);
           break;
         case OB_SEND_LOG:
@@ -938,6 +946,13 @@ namespace oceanbase
                   UPS.get_obi_role().get_role_str(), UPS.get_role_mgr().get_role_str(), scan_param.get_version_range().get_query_version());
         ret = OB_NOT_MASTER;
       }
+      else if (OB_NEW_SCAN_REQUEST == pkt.get_packet_code()
+              && OB_UPS_STREAM_SCAN_VERSION <= pkt.get_api_version()
+              && 0 < UPS.get_param().max_scan_stream_num
+              && OB_SUCCESS == handle_scan_stream_open_(pkt, scan_param, new_scanner, buffer))
+      {
+        // 已经通过流式扫描应答, 失败时退回到下面的普通扫描
+      }
       else if (OB_SUCCESS != (ret = session_mgr_.begin_session(ST_READ_ONLY, pkt.get_receive_ts(), process_timeout, process_timeout, session_descriptor)))
       {
         TBSYS_LOG(WARN, "begin session fail ret=%d", ret);
@@ -1015,10 +1030,174 @@ namespace oceanbase
       }
     }
 
+    int TransExecutor::handle_scan_stream_open_(ObPacket &pkt,
+                                                ObScanParam &scan_param,
+                                                ObCellNewScanner &new_scanner,
+                                                ObDataBuffer &buffer)
+    {
+      int ret = OB_SUCCESS;
+      uint32_t session_descriptor = INVALID_SESSION_DESCRIPTOR;
+      ROSessionCtx *session_ctx = NULL;
+      ObUpsScanStream *stream = NULL;
+      int64_t stream_id = 0;
+      int64_t packet_timewait = (0 == pkt.get_source_timeout()) ?
+                                UPS.get_param().packet_max_wait_time :
+                                pkt.get_source_timeout();
+      int64_t process_timeout = packet_timewait - QUERY_TIMEOUT_RESERVE;
+      TableMgr *table_mgr = UPS.get_table_mgr().get_table_mgr();
+      if (NULL == table_mgr)
+      {
+        ret = OB_NOT_INIT;
+      }
+      else if (NULL == (stream = scan_stream_mgr_.alloc(UPS.get_param().max_scan_stream_num, stream_id)))
+      {
+        TBSYS_LOG(DEBUG, "too many scan streams, stream_num=%ld", scan_stream_mgr_.get_stream_num());
+        ret = OB_NOT_SUPPORTED;
+      }
+      // session在stream关闭时结束, 超时由stream的空闲回收控制
+      else if (OB_SUCCESS != (ret = session_mgr_.begin_session(ST_READ_ONLY, pkt.get_receive_ts(), INT64_MAX,
+                                                               UPS.get_param().scan_stream_idle_time, session_descriptor)))
+      {
+        TBSYS_LOG(WARN, "begin session fail ret=%d", ret);
+      }
+      else if (NULL == (session_ctx = session_mgr_.fetch_ctx<ROSessionCtx>(session_descriptor)))
+      {
+        TBSYS_LOG(WARN, "fetch ctx fail session_descriptor=%u", session_descriptor);
+        ret = OB_ERR_UNEXPECTED;
+      }
+      else
+      {
+        session_ctx->set_stmt_start_time(pkt.get_receive_ts());
+        session_ctx->set_stmt_timeout(process_timeout);
+        if (OB_SUCCESS != (ret = stream->open(*table_mgr, session_descriptor, *session_ctx, scan_param)))
+        {
+          if (OB_NOT_SUPPORTED != ret)
+          {
+            TBSYS_LOG(WARN, "open scan stream fail ret=%d", ret);
+          }
+        }
+        else if (OB_SUCCESS != (ret = stream->fill(new_scanner, pkt.get_receive_ts(), process_timeout)))
+        {
+          TBSYS_LOG(WARN, "fill first page of scan stream fail ret=%d", ret);
+        }
+        else
+        {
+          bool is_finished = stream->is_finished();
+          UPS.response_scanner(OB_SUCCESS, pkt, new_scanner, buffer, is_finished ? 0 : stream_id);
+          OB_STAT_INC(UPDATESERVER, UPS_STAT_SCAN_COUNT, 1);
+          OB_STAT_INC(UPDATESERVER, UPS_STAT_SCAN_STREAM_OPEN_COUNT, 1);
+          OB_STAT_INC(UPDATESERVER, UPS_STAT_SCAN_TIMEU, session_ctx->get_session_timeu());
+          stream->prefetch(tbsys::CTimeUtil::getTime(), process_timeout);
+        }
+        session_ctx->set_last_active_time(tbsys::CTimeUtil::getTime());
+        session_mgr_.revert_ctx(session_descriptor);
+      }
+      if (NULL != stream)
+      {
+        if (OB_SUCCESS != ret
+            || stream->is_finished())
+        {
+          if (INVALID_SESSION_DESCRIPTOR == stream->get_session_descriptor()
+              && INVALID_SESSION_DESCRIPTOR != session_descriptor)
+          {
+            session_mgr_.end_session(session_descriptor);
+          }
+          scan_stream_mgr_.close(stream_id);
+        }
+        else
+        {
+          scan_stream_mgr_.revert(stream_id);
+        }
+      }
+      return ret;
+    }
+
+    void TransExecutor::handle_scan_stream_next_(ObPacket &pkt,
+                                                 ObCellNewScanner &new_scanner,
+                                                 ObDataBuffer &buffer)
+    {
+      int &ret = thread_errno();
+      ret = OB_SUCCESS;
+      int64_t stream_id = pkt.get_session_id();
+      uint32_t session_descriptor = INVALID_SESSION_DESCRIPTOR;
+      ROSessionCtx *session_ctx = NULL;
+      ObUpsScanStream *stream = NULL;
+      ObCellNewScanner *scanner = NULL;
+      int64_t packet_timewait = (0 == pkt.get_source_timeout()) ?
+                                UPS.get_param().packet_max_wait_time :
+                                pkt.get_source_timeout();
+      int64_t process_timeout = packet_timewait - QUERY_TIMEOUT_RESERVE;
+      // 上一页应答发出后stream仍被预取占用, 此时到达的请求等待预取结束
+      if (NULL == (stream = scan_stream_mgr_.fetch(stream_id, process_timeout)))
+      {
+        // 已经被空闲回收、UPS重启过或等待超时, 客户端会从last rowkey重新扫描
+        TBSYS_LOG(INFO, "scan stream not exist, stream_id=%ld src=%s",
+                  stream_id, NULL == pkt.get_request() ? NULL : get_peer_ip(pkt.get_request()));
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else if (NULL == (session_ctx = session_mgr_.fetch_ctx<ROSessionCtx>(session_descriptor = stream->get_session_descriptor())))
+      {
+        TBSYS_LOG(WARN, "fetch ctx fail session_descriptor=%u stream_id=%ld", session_descriptor, stream_id);
+        ret = OB_TRANS_ROLLBACKED;
+        scan_stream_mgr_.close(stream_id);
+      }
+      else
+      {
+        session_ctx->set_stmt_start_time(pkt.get_receive_ts());
+        session_ctx->set_stmt_timeout(process_timeout);
+        if (NULL != (scanner = stream->pop_prefetched()))
+        {
+          OB_STAT_INC(UPDATESERVER, UPS_STAT_SCAN_STREAM_PREFETCH_HIT, 1);
+        }
+        else if (OB_SUCCESS == (ret = stream->fill(new_scanner, pkt.get_receive_ts(), process_timeout)))
+        {
+          scanner = &new_scanner;
+        }
+        if (OB_SUCCESS == ret)
+        {
+          bool is_finished = stream->is_finished();
+          UPS.response_scanner(OB_SUCCESS, pkt, *scanner, buffer, is_finished ? 0 : stream_id);
+          OB_STAT_INC(UPDATESERVER, UPS_STAT_SCAN_STREAM_NEXT_COUNT, 1);
+          stream->prefetch(tbsys::CTimeUtil::getTime(), process_timeout);
+        }
+        session_ctx->set_last_active_time(tbsys::CTimeUtil::getTime());
+        session_mgr_.revert_ctx(session_descriptor);
+        if (OB_SUCCESS != ret
+            || stream->is_finished())
+        {
+          scan_stream_mgr_.close(stream_id);
+        }
+        else
+        {
+          scan_stream_mgr_.revert(stream_id);
+        }
+      }
+      if (OB_SUCCESS != ret)
+      {
+        UPS.response_result(ret, pkt);
+      }
+    }
+
+    void TransExecutor::handle_scan_stream_end_(ObPacket &pkt)
+    {
+      int64_t stream_id = pkt.get_session_id();
+      int64_t packet_timewait = (0 == pkt.get_source_timeout()) ?
+                                UPS.get_param().packet_max_wait_time :
+                                pkt.get_source_timeout();
+      // 等待正在进行的预取结束, 否则这次关闭会被丢掉, stream只能等空闲回收
+      if (NULL != scan_stream_mgr_.fetch(stream_id, packet_timewait - QUERY_TIMEOUT_RESERVE))
+      {
+        scan_stream_mgr_.close(stream_id);
+      }
+      // 客户端不等待OB_SESSION_END的应答
+      easy_request_wakeup(pkt.get_request());
+    }
+
     void TransExecutor::handle_kill_zombie_()
     {
       const bool force = false;
       session_mgr_.kill_zombie_session(force);
+      scan_stream_mgr_.recycle_idle(UPS.get_param().scan_stream_idle_time);
     }
 
     void TransExecutor::handle_show_sessions_(ObPacket &pkt,
@@ -1205,7 +1384,9 @@ namespace oceanbase
         }
         else
         {
-          batch_start_time() = (0 == batch_start_time()) ? tbsys::CTimeUtil::getTime() : batch_start_time();
+          int64_t cur_time = tbsys::CTimeUtil::getTime();
+          batch_start_time() = (0 == batch_start_time()) ? cur_time : batch_start_time();
+          group_commit_window_.on_arrive(cur_time);
           int64_t cur_timestamp = session_ctx->get_trans_id();
           session_ctx->get_uc_info().uc_checksum = ob_crc64(session_ctx->get_uc_info().uc_checksum, &cur_timestamp, sizeof(cur_timestamp));
           if (cur_timestamp <= 0)
@@ -1241,8 +1422,7 @@ namespace oceanbase
         }
       }
       if (OB_SUCCESS == ret
-          && (0 == TransCommitThread::get_queued_num()
-              || MAX_BATCH_NUM <= uncommited_session_list_.size()))
+          && need_commit_log_())
       {
         ret = commit_log_();
       }
@@ -1253,12 +1433,68 @@ namespace oceanbase
       return ret;
     }
 
+    bool TransExecutor::need_commit_log_()
+    {
+      bool bret = false;
+      int64_t batch_size = uncommited_session_list_.size();
+      if (MAX_BATCH_NUM <= batch_size)
+      {
+        bret = true;
+      }
+      else if (0 != TransCommitThread::get_queued_num())
+      {
+        bret = false;
+      }
+      else if (0 == batch_deadline_)
+      {
+        // 队列已空, 根据到达速率和fsync耗时决定是否值得再等一会儿凑batch
+        int64_t wait_time = group_commit_window_.calc_wait_time(batch_size,
+                                                                MAX_BATCH_NUM,
+                                                                UPS.get_param().group_commit_max_wait_time);
+        if (0 >= wait_time)
+        {
+          bret = true;
+        }
+        else
+        {
+          batch_deadline_ = batch_start_time() + wait_time;
+          bret = (batch_deadline_ <= tbsys::CTimeUtil::getTime());
+        }
+      }
+      else
+      {
+        bret = (batch_deadline_ <= tbsys::CTimeUtil::getTime());
+      }
+      return bret;
+    }
+
     void TransExecutor::on_commit_idle()
     {
       commit_log_();
       try_submit_auto_freeze_();
     }
 
+    void TransExecutor::on_commit_timeout()
+    {
+      if (0 < batch_deadline_
+          && batch_deadline_ <= tbsys::CTimeUtil::getTime())
+      {
+        ObSpinLockGuard guard(write_clog_mutex_);
+        commit_log_();
+      }
+    }
+
+    int64_t TransExecutor::get_commit_wait_time()
+    {
+      // ObSeqQueue按毫秒等待, 不足1ms的窗口会退化为短时间的轮询, 只发生在高负载的等待窗口内
+      int64_t wait_time = COMMIT_QUEUE_WAIT_TIME;
+      if (0 < batch_deadline_)
+      {
+        wait_time = std::max(batch_deadline_ - tbsys::CTimeUtil::getTime(), 0L);
+      }
+      return wait_time;
+    }
+
     int TransExecutor::fill_log_(Task &task, RWSessionCtx &session_ctx)
     {
       int ret = OB_SUCCESS;
@@ -1317,7 +1553,17 @@ namespace oceanbase
       if (0 < uncommited_session_list_.size())
       {
         CLEAR_TRACE_BUF(TraceLog::get_logbuffer());
+        int64_t flush_start_time = tbsys::CTimeUtil::getTime();
+        int64_t batch_size = uncommited_session_list_.size();
         ret = UPS.get_table_mgr().flush_commit_log(TraceLog::get_logbuffer());
+        int64_t flush_time = tbsys::CTimeUtil::getTime() - flush_start_time;
+        group_commit_window_.on_flush(batch_size, flush_time);
+        OB_STAT_INC(UPDATESERVER, UPS_STAT_BATCH_TRANS_COUNT, batch_size);
+        OB_STAT_INC(UPDATESERVER, UPS_STAT_BATCH_FLUSH_TIMEU, flush_time);
+        if (0 < batch_deadline_)
+        {
+          OB_STAT_INC(UPDATESERVER, UPS_STAT_BATCH_WAIT_TIMEU, std::max(flush_start_time - batch_start_time(), 0L));
+        }
         if (OB_SUCCESS != ret)
         {
           TBSYS_LOG(ERROR, "flush commit log fail ret=%d uncommited_number=%ld, will kill self", ret, uncommited_session_list_.size());
@@ -1378,6 +1624,7 @@ namespace oceanbase
         OB_STAT_INC(UPDATESERVER, UPS_STAT_BATCH_TIMEU, tbsys::CTimeUtil::getTime() - batch_start_time());
         batch_start_time() = 0;
       }
+      batch_deadline_ = 0;
       try_submit_auto_freeze_();
       return ret;
     }
@@ -1434,6 +1681,10 @@ namespace oceanbase
       TBSYS_LOG(INFO, "queued_num trans_thread=%ld commit_thread=%ld",
                 TransHandlePool::get_queued_num(),
                 TransCommitThread::get_queued_num());
+      TBSYS_LOG(INFO, "group commit avg_arrive_interval=%ld avg_flush_time=%ld avg_batch_size=%ld",
+                group_commit_window_.get_avg_arrive_interval(),
+                group_commit_window_.get_avg_flush_time(),
+                group_commit_window_.get_avg_batch_size());
       TBSYS_LOG(INFO, "==========log trans executor end==========");
     }
 
@@ -1556,6 +1807,20 @@ namespace oceanbase
       pdata.buffer.get_position() = 0;
       return host.handle_end_session_(task, pdata.buffer);
     }
+
+    bool TransExecutor::thandle_scan_stream_next(TransExecutor &host, Task &task, TransParamData &pdata)
+    {
+      pdata.buffer.get_position() = 0;
+      host.handle_scan_stream_next_(task.pkt, pdata.new_scanner, pdata.buffer);
+      return true;
+    }
+
+    bool TransExecutor::thandle_scan_stream_end(TransExecutor &host, Task &task, TransParamData &pdata)
+    {
+      UNUSED(pdata);
+      host.handle_scan_stream_end_(task.pkt);
+      return true;
+    }
     ////////////////////////////////////////////////////////////////////////////////////////////////////
 
     bool TransExecutor::chandle_non_impl(TransExecutor &host, Task &task, CommitParamData &pdata)
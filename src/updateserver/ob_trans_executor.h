@@ -32,6 +32,8 @@
 #include "ob_sessionctx_factory.h"
 #include "ob_lock_mgr.h"
 #include "ob_util_interface.h"
+#include "ob_group_commit.h"
+#include "ob_ups_scan_stream.h"
 
 namespace oceanbase
 {
@@ -87,6 +89,14 @@ namespace oceanbase
         {
           on_commit_push_fail(task);
         }
+        void on_wait_timeout()
+        {
+          on_commit_timeout();
+        };
+        int64_t get_wait_time()
+        {
+          return get_commit_wait_time();
+        };
           
       public:
         virtual void handle_commit(void *ptask, void *pdata) = 0;
@@ -94,6 +104,8 @@ namespace oceanbase
         virtual void on_commit_end(void *ptr) = 0;
         virtual void on_commit_push_fail(void* ptr) = 0;
         virtual void on_commit_idle() = 0;
+        virtual void on_commit_timeout() = 0;
+        virtual int64_t get_commit_wait_time() = 0;
         virtual int64_t get_seq(void* task) = 0;
     };
 
@@ -143,6 +155,7 @@ namespace oceanbase
       static const int64_t QUERY_TIMEOUT_RESERVE = 50000;
       static const int64_t TRY_FREEZE_INTERVAL = 1000000;
       static const int64_t MAX_BATCH_NUM = 500;
+      static const int64_t COMMIT_QUEUE_WAIT_TIME = 100 * 1000;
       typedef void (*packet_handler_pt)(common::ObPacket &pkt, common::ObDataBuffer &buffer);
       typedef bool (*trans_handler_pt)(TransExecutor &host, Task &task, TransParamData &pdata);
       typedef bool (*commit_handler_pt)(TransExecutor &host, Task &task, CommitParamData &pdata);
@@ -164,6 +177,8 @@ namespace oceanbase
         void on_commit_push_fail(void* ptr);
         void on_commit_end(void *ptr);
         void on_commit_idle();
+        void on_commit_timeout();
+        int64_t get_commit_wait_time();
         int64_t get_seq(void* ptr);
 
         SessionMgr &get_session_mgr() {return session_mgr_;};
@@ -195,6 +210,14 @@ namespace oceanbase
                                 common::ObScanner &scanner,
                                 common::ObCellNewScanner &new_scanner,
                                 common::ObDataBuffer &buffer);
+        int handle_scan_stream_open_(common::ObPacket &pkt,
+                                    common::ObScanParam &scan_param,
+                                    common::ObCellNewScanner &new_scanner,
+                                    common::ObDataBuffer &buffer);
+        void handle_scan_stream_next_(common::ObPacket &pkt,
+                                      common::ObCellNewScanner &new_scanner,
+                                      common::ObDataBuffer &buffer);
+        void handle_scan_stream_end_(common::ObPacket &pkt);
         void handle_kill_zombie_();
         void handle_show_sessions_(common::ObPacket &pkt,
                                   common::ObNewScanner &scanner,
@@ -207,6 +230,7 @@ namespace oceanbase
         int handle_write_commit_(Task &task);
         int fill_log_(Task &task, RWSessionCtx &session_ctx);
         int commit_log_();
+        bool need_commit_log_();
         void try_submit_auto_freeze_();
       private:
         static void phandle_non_impl(common::ObPacket &pkt, ObDataBuffer &buffer);
@@ -223,6 +247,8 @@ namespace oceanbase
         static bool thandle_show_sessions(TransExecutor &host, Task &task, TransParamData &pdata);
         static bool thandle_kill_session(TransExecutor &host, Task &task, TransParamData &pdata);
         static bool thandle_end_session(TransExecutor &host, Task &task, TransParamData &pdata);
+        static bool thandle_scan_stream_next(TransExecutor &host, Task &task, TransParamData &pdata);
+        static bool thandle_scan_stream_end(TransExecutor &host, Task &task, TransParamData &pdata);
       private:
         static bool chandle_non_impl(TransExecutor &host, Task &task, CommitParamData &pdata);
         static bool chandle_write_commit(TransExecutor &host, Task &task, CommitParamData &data);
@@ -242,8 +268,11 @@ namespace oceanbase
         FIFOAllocator allocator_;
         SessionCtxFactory session_ctx_factory_;
         SessionMgr session_mgr_;
+        ObUpsScanStreamMgr scan_stream_mgr_;
         LockMgr lock_mgr_;
         ObSpinLock write_clog_mutex_;
+        GroupCommitWindow group_commit_window_;
+        int64_t batch_deadline_;
 
         common::ObList<Task*> uncommited_session_list_;
         char ups_result_memory_[OB_MAX_PACKET_LENGTH];
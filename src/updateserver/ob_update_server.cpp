@@ -23,6 +23,7 @@
 #include "common/ob_token.h"
 #include "common/ob_version.h"
 #include "common/ob_log_cursor.h"
+#include "common/ob_log_compressor.h"
 #include "sstable/ob_aio_buffer_mgr.h"
 #include "ob_update_server.h"
 #include "ob_ups_utils.h"
@@ -222,6 +223,7 @@ namespace oceanbase
           if (OB_SUCCESS == table_mgr_.get_memtable_attr(memtable_attr))
           {
             memtable_attr.total_memlimit = config_.table_memory_limit;
+            memtable_attr.row_modify_tracker = &row_modify_tracker_;
             table_mgr_.set_memtable_attr(memtable_attr);
           }
           else
@@ -314,7 +316,8 @@ namespace oceanbase
           TBSYS_LOG(ERROR, "log_applier.init(n_replay_worker=%ld)=>%d", n_replay_worker, err);
         }
         else if (OB_SUCCESS != (err = replay_worker_.init(&log_applier_, (int32_t)n_replay_worker,
-                                                          replay_log_buf_len, replay_queue_len)))
+                                                          replay_log_buf_len, replay_queue_len,
+                                                          config_.replay_by_row)))
         {
           TBSYS_LOG(ERROR, "replay_worker.init(n_replay_worker=%ld)=>%d", n_replay_worker, err);
         }
@@ -342,6 +345,7 @@ namespace oceanbase
       if (OB_SUCCESS == err)
       {
         set_log_sync_delay_stat_param();
+        set_log_compress_param();
       }
 
       if (OB_SUCCESS == err)
@@ -1502,6 +1506,8 @@ namespace oceanbase
       case OB_NEW_SCAN_REQUEST:
       case OB_UPS_SHOW_SESSIONS:
       case OB_UPS_KILL_SESSION:
+      case OB_SESSION_NEXT_REQUEST:
+      case OB_SESSION_END:
         trans_executor_.handle_packet(*req);
         break;
         //if (!get_service_state())
@@ -1525,6 +1531,7 @@ namespace oceanbase
       case OB_UPS_RELOAD_CONF:
       case OB_UPS_GET_LAST_FROZEN_VERSION:
       case OB_UPS_GET_TABLE_TIME_STAMP:
+      case OB_UPS_GET_ROW_MODIFY_SLOTS:
       case OB_UPS_ENABLE_MEMTABLE_CHECKSUM:
       case OB_UPS_DISABLE_MEMTABLE_CHECKSUM:
       case OB_FETCH_STATS:
@@ -1819,6 +1826,9 @@ namespace oceanbase
               case OB_UPS_GET_TABLE_TIME_STAMP:
                 return_code = ups_get_table_time_stamp(version, *in_buf, req, channel_id, thread_buff);
                 break;
+              case OB_UPS_GET_ROW_MODIFY_SLOTS:
+                return_code = ups_get_row_modify_slots(version, *in_buf, req, channel_id, thread_buff);
+                break;
               case OB_UPS_GET_SLAVE_INFO:
                 return_code = ups_get_slave_info(version, req, channel_id, thread_buff);
                 break;
@@ -3285,7 +3295,8 @@ namespace oceanbase
     int ObUpdateServer::response_data_(int32_t ret_code, const T &data,
                                           int32_t cmd_type, int32_t func_version,
                                           easy_request_t* req, const uint32_t channel_id,
-                                          common::ObDataBuffer& out_buff, const int32_t* priority)
+                                          common::ObDataBuffer& out_buff, const int32_t* priority,
+                                          const int64_t session_id)
     {
       int ret = OB_SUCCESS;
       common::ObResultCode result_msg;
@@ -3307,7 +3318,7 @@ namespace oceanbase
         }
         else
         {
-          ret = send_response(cmd_type, func_version, out_buff, req, channel_id);
+          ret = send_response(cmd_type, func_version, out_buff, req, channel_id, session_id);
           if (OB_SUCCESS != ret)
           {
             TBSYS_LOG(WARN, "failed to send scan response, ret=%d", ret);
@@ -4782,11 +4793,12 @@ namespace oceanbase
       return ret;
     }
 
-    int ObUpdateServer::response_scanner(int32_t ret_code, ObPacket &pkt, common::ObCellNewScanner &new_scanner, ObDataBuffer &out_buffer)
+    int ObUpdateServer::response_scanner(int32_t ret_code, ObPacket &pkt, common::ObCellNewScanner &new_scanner, ObDataBuffer &out_buffer,
+                                        const int64_t session_id)
     {
       int ret = OB_SUCCESS;
       ret =  response_data_(ret_code, new_scanner, pkt.get_packet_code(), pkt.get_api_version(),
-                            pkt.get_request(), pkt.get_channel_id(), out_buffer);
+                            pkt.get_request(), pkt.get_channel_id(), out_buffer, NULL, session_id);
       // 忽略前两个字段 trace_id和chid
       PROFILE_LOG(DEBUG, TRACE_ID SOURCE_CHANNEL_ID UPS_REQ_END_TIME SCANNER_SIZE_BYTES, pkt.get_trace_id(), pkt.get_channel_id(), tbsys::CTimeUtil::getTime(), new_scanner.get_size());
       return ret;
@@ -4957,6 +4969,36 @@ namespace oceanbase
       log_mgr_.set_net_warn_threshold_us(config_.net_warn_threshold);
     }
 
+    void ObUpdateServer::set_log_compress_param()
+    {
+      // 备机和回放需要解压主机用过的任何压缩算法, 因此能加载的压缩库都注册上
+      ObLogCompressor &log_compressor = ObLogCompressor::get_instance();
+      for (int64_t type = ObLogCompressor::NONE + 1; type < ObLogCompressor::MAX_TYPE; type++)
+      {
+        ObCompressor *compressor = NULL;
+        if (log_compressor.is_registered(type))
+        {}
+        else if (NULL == (compressor = create_compressor(ObLogCompressor::get_lib_name(type))))
+        {
+          TBSYS_LOG(WARN, "cannot load log compressor library name=[%s]", ObLogCompressor::get_lib_name(type));
+        }
+        else if (OB_SUCCESS != log_compressor.register_compressor(type, compressor))
+        {
+          destroy_compressor(compressor);
+        }
+      }
+      int64_t compress_type = ObLogCompressor::get_type(config_.commit_log_compressor_name);
+      if (!log_compressor.is_registered(compress_type))
+      {
+        TBSYS_LOG(ERROR, "commit_log_compressor_name=%s not available, commit log will not be compressed",
+                  config_.commit_log_compressor_name.str());
+        compress_type = ObLogCompressor::NONE;
+      }
+      TBSYS_LOG(INFO, "set_log_compress_param commit_log_compressor_name=%s compress_type=%ld",
+                config_.commit_log_compressor_name.str(), compress_type);
+      log_mgr_.set_log_compress_type(compress_type);
+    }
+
     void ObUpdateServer::set_log_replay_thread_param()
     {
       TBSYS_LOG(INFO, "set_log_replay_thread_param replay_wait_time=%s fetch_log_wait_time=%s",
@@ -4971,6 +5013,7 @@ namespace oceanbase
 
       set_log_replay_thread_param();
       set_log_sync_delay_stat_param();
+      set_log_compress_param();
 
       table_mgr_.set_replay_checksum_flag(0 != config_.replay_checksum_flag);
       TBSYS_LOG(INFO, "set_replay_checksum_flag replay_checksum_flag=%s",
@@ -4994,6 +5037,9 @@ namespace oceanbase
       g_conf.using_hash_index = (0 != config_.using_hash_index);
       TBSYS_LOG(INFO, "set using_hash_index=%s", STR_BOOL(g_conf.using_hash_index));
 
+      g_conf.using_skiplist_index = (0 != config_.using_skiplist_index);
+      TBSYS_LOG(INFO, "set using_skiplist_index=%s", STR_BOOL(g_conf.using_skiplist_index));
+
       MemTableAttr memtable_attr;
       if (OB_SUCCESS == table_mgr_.get_memtable_attr(memtable_attr))
       {
@@ -5715,6 +5761,50 @@ namespace oceanbase
       return ret;
     }
 
+    int ObUpdateServer::ups_get_row_modify_slots(const int32_t version, common::ObDataBuffer& in_buff,
+        easy_request_t* req, const uint32_t channel_id, common::ObDataBuffer& out_buff)
+    {
+      int ret = OB_SUCCESS;
+      if (version != MY_VERSION)
+      {
+        ret = OB_ERROR_FUNC_VERSION;
+      }
+      int proc_ret = OB_SUCCESS;
+      int64_t last_trans_id = 0;
+      int64_t commited_trans_id = 0;
+      ObRowModifySlots *slots = GET_TSI_MULT(ObRowModifySlots, TSI_UPS_ROW_MODIFY_SLOTS_1);
+      if (NULL == slots)
+      {
+        TBSYS_LOG(WARN, "get tsi row modify slots fail");
+        proc_ret = OB_ALLOCATE_MEMORY_FAILED;
+      }
+      else if (OB_SUCCESS != (proc_ret = serialization::decode_vi64(in_buff.get_data(), in_buff.get_capacity(), in_buff.get_position(), &last_trans_id)))
+      {
+        TBSYS_LOG(WARN, "decode last_trans_id fail ret=%d", proc_ret);
+        slots->reset();
+      }
+      else
+      {
+        // read commited trans id before collecting the slots, all
+        // trans not after it have marked their slots.
+        commited_trans_id = trans_executor_.get_session_mgr().get_commited_trans_id();
+        proc_ret = row_modify_tracker_.get_modified_slots(last_trans_id, commited_trans_id, *slots);
+      }
+      TBSYS_LOG(DEBUG, "get_row_modify_slots ret=%d last_trans_id=%ld commited_trans_id=%ld slot_count=%ld src=%s",
+                proc_ret, last_trans_id, commited_trans_id, NULL == slots ? 0 : slots->get_slot_count(),
+                NULL == req ? NULL : get_peer_ip(req));
+      if (NULL == slots)
+      {
+        ret = response_result_(proc_ret, OB_UPS_GET_ROW_MODIFY_SLOTS_RESPONSE, MY_VERSION, req, channel_id);
+      }
+      else
+      {
+        ret = response_data_(proc_ret, *slots, OB_UPS_GET_ROW_MODIFY_SLOTS_RESPONSE, MY_VERSION,
+            req, channel_id, out_buff);
+      }
+      return ret;
+    }
+
     int ObUpdateServer::ups_enable_memtable_checksum(const int32_t version, easy_request_t* req, const uint32_t channel_id)
     {
       int ret = OB_SUCCESS;
@@ -57,6 +57,7 @@
 #include "ob_slave_sync_type.h"
 #include "ob_trans_executor.h"
 #include "ob_trigger_handler.h"
+#include "ob_row_modify_tracker.h"
 #include "ob_util_interface.h"
 #include "common/ob_trace_id.h"
 namespace oceanbase
@@ -172,6 +173,11 @@ namespace oceanbase
         {
           return table_mgr_;
         }
+
+        ObRowModifyTracker& get_row_modify_tracker()
+        {
+          return row_modify_tracker_;
+        }
         common::BatchPacketQueueThread& get_write_thread_queue()
         {
           return write_thread_queue_;
@@ -273,6 +279,7 @@ namespace oceanbase
         }
 
         void set_log_sync_delay_stat_param();
+        void set_log_compress_param();
         void set_log_replay_thread_param();
 
         int sync_update_schema(const bool always_try, const bool write_log, bool only_core_tables);
@@ -354,7 +361,9 @@ namespace oceanbase
         int response_trans_id(int32_t ret_code, ObPacket &pkt, common::ObTransID &id, ObDataBuffer &out_buffer);
         int response_scanner(int32_t ret_code, ObPacket &pkt, common::ObScanner &scanner, ObDataBuffer &out_buffer);
         int response_scanner(int32_t ret_code, ObPacket &pkt, common::ObNewScanner &new_scanner, ObDataBuffer &out_buffer);
-        int response_scanner(int32_t ret_code, ObPacket &pkt, common::ObCellNewScanner &new_scanner, ObDataBuffer &out_buffer);
+        // session_id非0时客户端可以用OB_SESSION_NEXT_REQUEST续读
+        int response_scanner(int32_t ret_code, ObPacket &pkt, common::ObCellNewScanner &new_scanner, ObDataBuffer &out_buffer,
+                            const int64_t session_id = 0);
         int response_buffer(int32_t ret_code, ObPacket &pkt, common::ObDataBuffer &buffer);
       private:
         //add:
@@ -456,6 +465,8 @@ namespace oceanbase
             easy_request_t* req, const uint32_t channel_id, common::ObDataBuffer& out_buff);
         int ups_get_table_time_stamp(const int32_t version, common::ObDataBuffer& in_buff,
             easy_request_t* req, const uint32_t channel_id, common::ObDataBuffer& out_buff);
+        int ups_get_row_modify_slots(const int32_t version, common::ObDataBuffer& in_buff,
+            easy_request_t* req, const uint32_t channel_id, common::ObDataBuffer& out_buff);
         int ups_enable_memtable_checksum(const int32_t version, easy_request_t* req, const uint32_t channel_id);
         int ups_disable_memtable_checksum(const int32_t version, easy_request_t* req, const uint32_t channel_id);
         int ups_fetch_stat_info(const int32_t version,
@@ -524,7 +535,8 @@ namespace oceanbase
         int response_data_(int32_t ret_code, const T &data,
                           int32_t cmd_type, int32_t func_version,
                           easy_request_t* req, const uint32_t channel_id,
-                          common::ObDataBuffer& out_buff, const int32_t* priority = NULL);
+                          common::ObDataBuffer& out_buff, const int32_t* priority = NULL,
+                          const int64_t session_id = 0);
         int low_priv_speed_control_(const int64_t scanner_size);
 
         template <class Queue>
@@ -665,6 +677,7 @@ namespace oceanbase
         TransExecutor trans_executor_;
         ObLogReplayWorker replay_worker_;
         ObAsyncLogApplier log_applier_;
+        ObRowModifyTracker row_modify_tracker_;
     };
   }
 }
@@ -17,6 +17,7 @@
 #include <math.h>
 #include "ob_update_server_config.h"
 #include "common/compress/ob_compressor.h"
+#include "common/ob_log_compressor.h"
 
 using namespace oceanbase::updateserver;
 
@@ -87,6 +88,12 @@ int ObUpdateServerConfig::check_all()
       }
     }
 
+    if (0 > ObLogCompressor::get_type(commit_log_compressor_name))
+    {
+      TBSYS_LOG(ERROR, "unknown commit_log_compressor_name=[%s]", commit_log_compressor_name.str());
+      ret = OB_INVALID_ARGUMENT;
+    }
+
     ObCompressor *compressor = create_compressor(sstable_compressor_name);
     if (NULL == compressor)
     {
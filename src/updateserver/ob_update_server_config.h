@@ -83,8 +83,10 @@ namespace oceanbase
         DEF_INT(lease_queue_size, "100", "lease queue size");
         DEF_INT(store_queue_size, "100", "store queue site");
         DEF_CAP(commit_log_size, "64MB", "commit log size");
+        DEF_STR(commit_log_compressor_name, "none", "compressor of commit log content: none, lzo_1.0 or snappy_1.0. all ups and lsync readers must support it before enabling");
 
         DEF_INT(write_thread_batch_num, "1024", "[1,]", "max wirte task count for batch");
+        DEF_TIME(group_commit_max_wait_time, "1ms", "[0s,10ms]", "max time commit thread waits to group more transactions into one commit log flush, 0 to disable");
         DEF_INT(fetch_schema_times, "10", "active fetch schema try times if fail");
         DEF_TIME(fetch_schema_timeout, "3s", "active fetch shema timeout");
         DEF_INT(resp_root_times, "20", "report frozen version to root server try times if fail");
@@ -107,6 +109,8 @@ namespace oceanbase
         DEF_TIME(log_sync_timeout, "500ms", "slave sync log timeout");
         DEF_TIME(packet_max_wait_time, "10s", "default rpc timeout if not timeout specified");
         DEF_TIME(trans_proc_time_warn, "1s", "if master process batch or slave write local log beyond this value, give an alarm");
+        DEF_INT(max_scan_stream_num, "64", "[0,1024]", "max number of memtable scan streams kept open for chunkserver, 0 means disable stream scan");
+        DEF_TIME(scan_stream_idle_time, "10s", "[1s,]", "close scan stream and its read only session if no next request arrives within this time");
 
         DEF_INT(inner_port, "2701", "(1024,65536)", "inner port for daily merge");
         DEF_CAP(low_priv_network_lower_limit, "30MB", "increase 1% probability to process low priority if low priority request network band less than this value and \\'low_priv_adjust_flag\\' is True");
@@ -135,12 +139,15 @@ namespace oceanbase
         DEF_TIME(lsync_fetch_timeout, "5s", "fetch commit log timeout from lsync or master ups");
         DEF_TIME(refresh_lsync_addr_interval, "60s", "interval of slave to refresh lsyncserver-address");
         DEF_INT(max_row_cell_num, "256", "compact cell when cell of row beyond this valud");
+        DEF_INT(max_row_node_num, "32", "[0,]", "compact committed cell nodes of row when chain length beyond this value, 0 means disable");
         DEF_CAP(table_available_warn_size, "0", "try drop frozen table if available table memory less than this value"); /* calc later */
         DEF_CAP(table_available_error_size, "0", "force drop frozen table and give an alarm if available table memory less than this value"); /* calc later */
 
         DEF_TIME(warm_up_time, "10m", "[10s,30m]", "sstable warm up time");
         DEF_BOOL(using_memtable_bloomfilter, "False", "using memtable bloomfilter");
+        DEF_BOOL(using_frozen_bloomfilter, "True", "using rowkey bloomfilter of frozen memtable and ups sstable to skip point get");
         DEF_BOOL(write_sstable_use_dio, "True", "write sstable use dio");
+        DEF_CAP(dump_sstable_io_limit, "0", "max bytes per second written when dumping frozen memtable to sstable, 0 means unlimited");
 
         DEF_TIME(keep_alive_timeout, "5s", "keep alive timeout");
         DEF_TIME(lease_timeout_in_advance, "500ms", "lease timeout in advance");
@@ -149,11 +156,13 @@ namespace oceanbase
 
         DEF_BOOL(using_static_cm_column_id, "False", "should treat 2 and 3 as create_time and modify_time column id");
         DEF_BOOL(using_hash_index, "True", "using hash index");
+        DEF_BOOL(using_skiplist_index, "False", "using lock-free skiplist instead of btree as ordered index of new memtables");
 
         DEF_INT(log_cache_n_block, "4", "number of blocks of log cache");
         DEF_CAP(log_cache_block_size, "32MB", "size of per-block of log cache");
         DEF_CAP(replay_log_buf_size, "10GB", "replay log buffer size");
         DEF_INT(replay_queue_len, "500", "replay queue size");
+        DEF_BOOL(replay_by_row, "False", "order replay of logs by the rows they modify instead of only by barrier logs");
         DEF_TIME(wait_slave_sync_time, "100ms", "wait slave sync time");
         DEF_INT(wait_slave_sync_type, "0", "[0,2]", "0: response master ups before replay; 1: response master ups after replay before sync to disk; 2: response master ups after sync to disk");
         DEF_TIME(disk_warn_threshold, "5ms", "disk warn threshold");
@@ -20,6 +20,7 @@
 #include "common/file_utils.h"
 #include "common/file_directory_utils.h"
 #include "ob_ups_log_mgr.h"
+#include "common/ob_log_compressor.h"
 
 using namespace oceanbase::common;
 namespace oceanbase
@@ -615,6 +616,8 @@ namespace oceanbase
       ObLogEntry log_entry;
       int64_t pos = 0;
       int64_t retry_wait_time_us = 100 * 1000;
+      const char* entry_data = NULL;
+      int64_t entry_data_len = 0;
       while (OB_SUCCESS == err && pos < data_len)
       {
         if (OB_SUCCESS != (err = log_entry.deserialize(log_data, data_len, pos)))
@@ -625,16 +628,20 @@ namespace oceanbase
         {
           TBSYS_LOG(ERROR, "log_entry.check_data_integrity()=>%d", err);
         }
+        else if (OB_SUCCESS != (err = get_log_data(log_entry, log_data + pos, entry_data, entry_data_len)))
+        {
+          TBSYS_LOG(ERROR, "get_log_data(log_id=%ld)=>%d", log_entry.seq_, err);
+        }
         else
         {
           err = OB_NEED_RETRY;
           while(OB_NEED_RETRY == err)
           {
             if (OB_SUCCESS != (err = log_applier->apply_log((LogCommand)log_entry.cmd_,
-                                                            log_entry.seq_, log_data + pos, log_entry.get_log_data_len(), RT_APPLY))
+                                                            log_entry.seq_, entry_data, entry_data_len, RT_APPLY))
                 && OB_NEED_RETRY != err && OB_CANCELED != err)
             {
-              TBSYS_LOG(ERROR, "replay_log(cmd=%d, log_data=%p, data_len=%d)=>%d", log_entry.cmd_, log_data + pos, log_entry.get_log_data_len(), err);
+              TBSYS_LOG(ERROR, "replay_log(cmd=%d, log_data=%p, data_len=%ld)=>%d", log_entry.cmd_, entry_data, entry_data_len, err);
             }
             else if (OB_NEED_RETRY == err)
             {
@@ -0,0 +1,515 @@
+////===================================================================
+ //
+ // ob_ups_scan_stream.cpp updateserver / Oceanbase
+ //
+ // Copyright (C) 2010, 2013 Taobao.com, Inc.
+ //
+ // -------------------------------------------------------------------
+ //
+ // Description
+ //
+ //
+ // -------------------------------------------------------------------
+ //
+ // Change Log
+ //
+////====================================================================
+
+#include "common/ob_malloc.h"
+#include "common/ob_cur_time.h"
+#include "common/ob_new_scanner_helper.h"
+#include "ob_ups_scan_stream.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    using namespace common;
+
+    ObUpsScanStream::ObUpsScanStream() : table_mgr_(NULL),
+                                         session_descriptor_(INVALID_SESSION_DESCRIPTOR),
+                                         table_list_(),
+                                         iter_num_(0),
+                                         merger_(),
+                                         column_filter_(),
+                                         allocator_(),
+                                         range_(),
+                                         row_desc_(),
+                                         table_id_(OB_INVALID_ID),
+                                         scan_size_(0),
+                                         data_version_(0),
+                                         has_pending_cell_(false),
+                                         is_end_(false),
+                                         is_broken_(false),
+                                         has_prefetched_(false),
+                                         prefetch_ret_(OB_SUCCESS),
+                                         prefetch_scanner_()
+    {
+      memset(iters_, 0, sizeof(iters_));
+    }
+
+    ObUpsScanStream::~ObUpsScanStream()
+    {
+      close();
+    }
+
+    int ObUpsScanStream::open(TableMgr &table_mgr,
+                              const uint32_t session_descriptor,
+                              const BaseSessionCtx &session_ctx,
+                              const ObScanParam &scan_param)
+    {
+      int ret = OB_SUCCESS;
+      uint64_t max_valid_version = 0;
+      bool is_final_minor = false;
+      const ObNewRange *scan_range = scan_param.get_range();
+      if (NULL != table_mgr_)
+      {
+        TBSYS_LOG(WARN, "stream has already opened sd=%u", session_descriptor_);
+        ret = OB_INIT_TWICE;
+      }
+      else if (NULL == scan_range)
+      {
+        TBSYS_LOG(WARN, "invalid scan range");
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (ret = table_mgr.acquire_table(scan_param.get_version_range(), max_valid_version, table_list_, is_final_minor))
+              || 0 == table_list_.size())
+      {
+        TBSYS_LOG(WARN, "acquire table fail version_range=%s", range2str(scan_param.get_version_range()));
+        ret = (OB_SUCCESS == ret) ? OB_INVALID_START_VERSION : ret;
+      }
+      else
+      {
+        table_mgr_ = &table_mgr;
+        session_descriptor_ = session_descriptor;
+        table_id_ = scan_param.get_table_id();
+        scan_size_ = scan_param.get_scan_size();
+        data_version_ = ObVersion::get_version(SSTableID::get_major_version(max_valid_version),
+                                              SSTableID::get_minor_version_end(max_valid_version),
+                                              is_final_minor);
+        merger_.set_asc(scan_param.get_scan_direction() == ScanFlag::FORWARD);
+        // range和column filter会被memtable迭代器引用, 必须拷贝到stream自己的内存中
+        ColumnFilter *pcf = ColumnFilter::build_columnfilter(scan_param, &column_filter_);
+        bool reverse = (scan_param.get_scan_direction() == ScanFlag::BACKWARD);
+        if (OB_SUCCESS != (ret = deep_copy_range(allocator_, *scan_range, range_)))
+        {
+          TBSYS_LOG(WARN, "deep copy range fail ret=%d %s", ret, scan_range2str(*scan_range));
+        }
+        else if (OB_SUCCESS != (ret = ObNewScannerHelper::get_row_desc(scan_param, row_desc_)))
+        {
+          TBSYS_LOG(WARN, "get row desc fail ret=%d", ret);
+        }
+        for (TableList::iterator iter = table_list_.begin();
+            OB_SUCCESS == ret && iter != table_list_.end();
+            iter++)
+        {
+          ITableEntity *table_entity = *iter;
+          MemTableEntity *memtable_entity = NULL;
+          MemTableEntityIterator *table_iter = NULL;
+          if (NULL == table_entity)
+          {
+            TBSYS_LOG(WARN, "invalid table_entity version_range=%s", range2str(scan_param.get_version_range()));
+            ret = OB_ERROR;
+          }
+          else if (ITableEntity::MEMTABLE != table_entity->get_table_type()
+                  || MAX_TABLE_NUM <= iter_num_)
+          {
+            // sstable迭代器依赖线程局部的AIO buffer, 不能跨请求保留
+            ret = OB_NOT_SUPPORTED;
+          }
+          else if (NULL == (memtable_entity = dynamic_cast<MemTableEntity*>(table_entity)))
+          {
+            TBSYS_LOG(WARN, "table entity is not memtable %p", table_entity);
+            ret = OB_ERR_UNEXPECTED;
+          }
+          else if (NULL == (table_iter = table_mgr.get_resource_pool().get_memtable_rp().alloc()))
+          {
+            TBSYS_LOG(WARN, "alloc memtable iterator fail");
+            ret = OB_MEM_OVERFLOW;
+          }
+          else
+          {
+            iters_[iter_num_++] = table_iter;
+            if (OB_SUCCESS != (ret = memtable_entity->get_memtable().scan(session_ctx, range_, reverse,
+                                                                          table_iter->get_memtable_iter(), pcf)))
+            {
+              TBSYS_LOG(WARN, "memtable scan fail ret=%d %s", ret, scan_range2str(range_));
+            }
+            else if (OB_SUCCESS != (ret = merger_.add_iterator(table_iter)))
+            {
+              TBSYS_LOG(WARN, "add iterator to merger fail ret=%d", ret);
+            }
+          }
+        }
+        if (OB_SUCCESS != ret)
+        {
+          close();
+        }
+      }
+      return ret;
+    }
+
+    int ObUpsScanStream::fill(ObCellNewScanner &scanner, const int64_t start_time, const int64_t timeout)
+    {
+      int ret = OB_SUCCESS;
+      ObCellInfo *cell = NULL;
+      bool is_row_changed = false;
+      bool page_full = false;
+      int64_t row_count = 0;
+      scanner.reuse();
+      scanner.set_row_desc(row_desc_);
+      if (NULL == table_mgr_
+          || is_end_
+          || is_broken_)
+      {
+        TBSYS_LOG(WARN, "stream can not fill more, table_mgr=%p is_end=%s is_broken=%s",
+                  table_mgr_, STR_BOOL(is_end_), STR_BOOL(is_broken_));
+        ret = OB_ERR_UNEXPECTED;
+      }
+      while (OB_SUCCESS == ret)
+      {
+        if (!has_pending_cell_
+            && OB_SUCCESS != (ret = merger_.next_cell()))
+        {
+          break;
+        }
+        has_pending_cell_ = false;
+        if (OB_SUCCESS != (ret = merger_.get_cell(&cell, &is_row_changed))
+            || NULL == cell)
+        {
+          TBSYS_LOG(WARN, "failed to get cell, ret=%d", ret);
+          ret = OB_ERROR;
+          break;
+        }
+        // 与add_to_scanner_不同, 这里不能回滚半行,
+        // 只在新行的第一个cell处检查页大小和超时, 该cell留给下一页
+        if (is_row_changed
+            && 0 < row_count
+            && ((0 < scan_size_ && scan_size_ <= scanner.get_size())
+                || (start_time + timeout) < g_cur_time))
+        {
+          has_pending_cell_ = true;
+          page_full = true;
+          break;
+        }
+        if (is_row_changed)
+        {
+          ++row_count;
+        }
+        if (OB_SUCCESS != (ret = scanner.add_cell(*cell, false, is_row_changed)))
+        {
+          break;
+        }
+      }
+      if (OB_ITER_END == ret)
+      {
+        is_end_ = true;
+        ret = OB_SUCCESS;
+      }
+      else if (OB_SIZE_OVERFLOW == ret)
+      {
+        // 超过scanner的硬上限, 上一行已被丢弃, stream无法续读
+        is_broken_ = true;
+        ret = OB_SUCCESS;
+      }
+      if (OB_SUCCESS == ret
+          && OB_SUCCESS != (ret = scanner.finish()))
+      {
+        TBSYS_LOG(WARN, "finish new scanner fail ret=%d", ret);
+      }
+      if (OB_SUCCESS == ret)
+      {
+        bool is_fullfilled = false;
+        int64_t fullfilled_row_num = 0;
+        scanner.get_is_req_fullfilled(is_fullfilled, fullfilled_row_num);
+        if (!is_fullfilled)
+        {
+          is_broken_ = true;
+        }
+        else if (page_full)
+        {
+          scanner.set_is_req_fullfilled(false, fullfilled_row_num);
+        }
+        if (is_broken_
+            && 0 >= fullfilled_row_num)
+        {
+          TBSYS_LOG(WARN, "memory is not enough to add even one row");
+          ret = OB_ERROR;
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        ObNewRange range;
+        range.table_id_ = table_id_;
+        range.set_whole_range();
+        scanner.set_data_version(data_version_);
+        ret = scanner.set_range(range);
+      }
+      if (OB_SUCCESS != ret)
+      {
+        is_broken_ = true;
+      }
+      return ret;
+    }
+
+    void ObUpsScanStream::prefetch(const int64_t start_time, const int64_t timeout)
+    {
+      if (!is_end_
+          && !is_broken_
+          && !has_prefetched_)
+      {
+        prefetch_ret_ = fill(prefetch_scanner_, start_time, timeout);
+        has_prefetched_ = true;
+      }
+    }
+
+    ObCellNewScanner *ObUpsScanStream::pop_prefetched()
+    {
+      ObCellNewScanner *ret = NULL;
+      if (has_prefetched_
+          && OB_SUCCESS == prefetch_ret_)
+      {
+        ret = &prefetch_scanner_;
+      }
+      has_prefetched_ = false;
+      prefetch_ret_ = OB_SUCCESS;
+      return ret;
+    }
+
+    void ObUpsScanStream::release_iters_()
+    {
+      merger_.reset();
+      for (int64_t i = 0; i < iter_num_; i++)
+      {
+        if (NULL != iters_[i]
+            && NULL != table_mgr_)
+        {
+          table_mgr_->get_resource_pool().get_memtable_rp().free(iters_[i]);
+        }
+        iters_[i] = NULL;
+      }
+      iter_num_ = 0;
+    }
+
+    void ObUpsScanStream::close()
+    {
+      release_iters_();
+      if (NULL != table_mgr_)
+      {
+        table_mgr_->revert_table(table_list_);
+      }
+      table_list_.clear();
+      table_mgr_ = NULL;
+      session_descriptor_ = INVALID_SESSION_DESCRIPTOR;
+      column_filter_.clear();
+      allocator_.reuse();
+      row_desc_.reset();
+      table_id_ = OB_INVALID_ID;
+      scan_size_ = 0;
+      data_version_ = 0;
+      has_pending_cell_ = false;
+      is_end_ = false;
+      is_broken_ = false;
+      has_prefetched_ = false;
+      prefetch_ret_ = OB_SUCCESS;
+      prefetch_scanner_.clear();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ObUpsScanStreamMgr::ObUpsScanStreamMgr(SessionMgr &session_mgr) : session_mgr_(session_mgr),
+                                                                       lock_(),
+                                                                       stream_seq_(0),
+                                                                       stream_num_(0)
+    {
+      memset(slots_, 0, sizeof(slots_));
+    }
+
+    ObUpsScanStreamMgr::~ObUpsScanStreamMgr()
+    {
+      destroy();
+    }
+
+    void ObUpsScanStreamMgr::destroy()
+    {
+      for (int64_t i = 0; i < MAX_STREAM_NUM; i++)
+      {
+        Slot &slot = slots_[i];
+        if (NULL != slot.stream)
+        {
+          if (0 != slot.stream_id)
+          {
+            uint32_t sd = slot.stream->get_session_descriptor();
+            slot.stream->close();
+            session_mgr_.end_session(sd);
+          }
+          slot.stream->~ObUpsScanStream();
+          ob_free(slot.stream);
+        }
+      }
+      memset(slots_, 0, sizeof(slots_));
+      stream_num_ = 0;
+    }
+
+    ObUpsScanStream *ObUpsScanStreamMgr::alloc(const int64_t max_stream_num, int64_t &stream_id)
+    {
+      ObUpsScanStream *ret = NULL;
+      int64_t limit = (MAX_STREAM_NUM < max_stream_num) ? MAX_STREAM_NUM : max_stream_num;
+      ObSpinLockGuard guard(lock_);
+      if (stream_num_ < limit)
+      {
+        for (int64_t i = 0; i < MAX_STREAM_NUM; i++)
+        {
+          Slot &slot = slots_[i];
+          if (0 != slot.stream_id)
+          {
+            continue;
+          }
+          if (NULL == slot.stream)
+          {
+            void *buffer = ob_malloc(sizeof(ObUpsScanStream), ObModIds::OB_UPS_SCAN_STREAM);
+            if (NULL == buffer)
+            {
+              TBSYS_LOG(WARN, "alloc scan stream fail");
+              break;
+            }
+            slot.stream = new(buffer) ObUpsScanStream();
+          }
+          slot.stream_id = ((++stream_seq_) * MAX_STREAM_NUM) + i;
+          slot.using_flag = true;
+          slot.last_active_time = tbsys::CTimeUtil::getTime();
+          stream_id = slot.stream_id;
+          stream_num_ += 1;
+          ret = slot.stream;
+          break;
+        }
+      }
+      return ret;
+    }
+
+    ObUpsScanStreamMgr::Slot *ObUpsScanStreamMgr::get_slot_(const int64_t stream_id)
+    {
+      Slot *ret = NULL;
+      if (0 < stream_id)
+      {
+        Slot &slot = slots_[stream_id % MAX_STREAM_NUM];
+        if (stream_id == slot.stream_id)
+        {
+          ret = &slot;
+        }
+      }
+      return ret;
+    }
+
+    ObUpsScanStream *ObUpsScanStreamMgr::fetch(const int64_t stream_id, const int64_t timeout)
+    {
+      ObUpsScanStream *ret = NULL;
+      bool need_wait = true;
+      int64_t end_time = tbsys::CTimeUtil::getTime() + timeout;
+      while (NULL == ret
+            && need_wait)
+      {
+        {
+          ObSpinLockGuard guard(lock_);
+          Slot *slot = get_slot_(stream_id);
+          if (NULL == slot)
+          {
+            need_wait = false;
+          }
+          else if (!slot->using_flag)
+          {
+            slot->using_flag = true;
+            ret = slot->stream;
+          }
+        }
+        if (NULL != ret
+            || !need_wait)
+        {
+          // do nothing
+        }
+        else if (end_time <= tbsys::CTimeUtil::getTime())
+        {
+          TBSYS_LOG(WARN, "wait busy scan stream timeout, stream_id=%ld timeout=%ld", stream_id, timeout);
+          need_wait = false;
+        }
+        else
+        {
+          usleep(FETCH_WAIT_INTERVAL_US);
+        }
+      }
+      return ret;
+    }
+
+    void ObUpsScanStreamMgr::revert(const int64_t stream_id)
+    {
+      ObSpinLockGuard guard(lock_);
+      Slot *slot = get_slot_(stream_id);
+      if (NULL != slot)
+      {
+        slot->last_active_time = tbsys::CTimeUtil::getTime();
+        slot->using_flag = false;
+      }
+    }
+
+    void ObUpsScanStreamMgr::close(const int64_t stream_id)
+    {
+      ObUpsScanStream *stream = NULL;
+      {
+        ObSpinLockGuard guard(lock_);
+        Slot *slot = get_slot_(stream_id);
+        if (NULL == slot
+            || !slot->using_flag)
+        {
+          TBSYS_LOG(WARN, "stream not held by caller, stream_id=%ld slot=%p", stream_id, slot);
+        }
+        else
+        {
+          stream = slot->stream;
+        }
+      }
+      if (NULL != stream)
+      {
+        uint32_t sd = stream->get_session_descriptor();
+        stream->close();
+        if (INVALID_SESSION_DESCRIPTOR != sd)
+        {
+          session_mgr_.end_session(sd);
+        }
+        ObSpinLockGuard guard(lock_);
+        Slot *slot = get_slot_(stream_id);
+        if (NULL != slot)
+        {
+          slot->stream_id = 0;
+          slot->using_flag = false;
+          stream_num_ -= 1;
+        }
+      }
+    }
+
+    void ObUpsScanStreamMgr::recycle_idle(const int64_t idle_time)
+    {
+      int64_t idle_ids[MAX_STREAM_NUM];
+      int64_t idle_num = 0;
+      int64_t cur_time = tbsys::CTimeUtil::getTime();
+      {
+        ObSpinLockGuard guard(lock_);
+        for (int64_t i = 0; i < MAX_STREAM_NUM; i++)
+        {
+          Slot &slot = slots_[i];
+          if (0 != slot.stream_id
+              && !slot.using_flag
+              && (slot.last_active_time + idle_time) < cur_time)
+          {
+            slot.using_flag = true;
+            idle_ids[idle_num++] = slot.stream_id;
+          }
+        }
+      }
+      for (int64_t i = 0; i < idle_num; i++)
+      {
+        TBSYS_LOG(INFO, "close idle scan stream, stream_id=%ld idle_time=%ld", idle_ids[i], idle_time);
+        close(idle_ids[i]);
+      }
+    }
+  }
+}
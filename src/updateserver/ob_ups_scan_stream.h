@@ -0,0 +1,134 @@
+////===================================================================
+ //
+ // ob_ups_scan_stream.h updateserver / Oceanbase
+ //
+ // Copyright (C) 2010, 2013 Taobao.com, Inc.
+ //
+ // -------------------------------------------------------------------
+ //
+ // Description
+ //
+ // chunkserver增量扫描的流式实现
+ // 首个OB_NEW_SCAN_REQUEST打开memtable迭代器后不释放, 后续页通过
+ // OB_SESSION_NEXT_REQUEST从上次停下的行继续读, 不再重新定位和建session;
+ // 每页发送之后立即在服务端预取下一页, 相当于窗口为一页的流水线
+ // 迭代器、column filter、range都由stream自己持有, 不依赖线程局部变量,
+ // 因此后续请求可以由任意读线程处理
+ //
+ // -------------------------------------------------------------------
+ //
+ // Change Log
+ //
+////====================================================================
+
+#ifndef  OCEANBASE_UPDATESERVER_UPS_SCAN_STREAM_H_
+#define  OCEANBASE_UPDATESERVER_UPS_SCAN_STREAM_H_
+#include "common/ob_define.h"
+#include "common/ob_spin_lock.h"
+#include "common/ob_merger.h"
+#include "common/ob_column_filter.h"
+#include "common/ob_range2.h"
+#include "common/ob_row_desc.h"
+#include "common/ob_new_scanner.h"
+#include "common/page_arena.h"
+#include "ob_table_mgr.h"
+#include "ob_session_mgr.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    class ObUpsScanStream
+    {
+      public:
+        static const int64_t MAX_TABLE_NUM = 16;
+      public:
+        ObUpsScanStream();
+        ~ObUpsScanStream();
+      public:
+        // 只支持全部由memtable组成的table list, 含有sstable时返回OB_NOT_SUPPORTED,
+        // 调用者退回到普通的分页扫描
+        int open(TableMgr &table_mgr,
+                const uint32_t session_descriptor,
+                const BaseSessionCtx &session_ctx,
+                const common::ObScanParam &scan_param);
+        // 从上次停下的位置继续填充一页, 只在行边界切分, 切分处的cell留给下一页
+        int fill(common::ObCellNewScanner &scanner, const int64_t start_time, const int64_t timeout);
+        // 在内部scanner中预取下一页
+        void prefetch(const int64_t start_time, const int64_t timeout);
+        // 返回预取好的一页并清除预取标记, 没有预取时返回NULL
+        common::ObCellNewScanner *pop_prefetched();
+        void close();
+      public:
+        uint32_t get_session_descriptor() const {return session_descriptor_;};
+        // 已经读到结尾, 或者scanner硬上限溢出丢掉了已读出的行,
+        // 后者需要客户端从last rowkey重新定位, 两种情况stream都不能再继续;
+        // 预取的最后一页还没有发出之前不算结束
+        bool is_finished() const {return (is_end_ || is_broken_) && !has_prefetched_;};
+      private:
+        void release_iters_();
+      private:
+        TableMgr *table_mgr_;
+        uint32_t session_descriptor_;
+        TableList table_list_;
+        MemTableEntityIterator *iters_[MAX_TABLE_NUM];
+        int64_t iter_num_;
+        common::ObMerger merger_;
+        common::ColumnFilter column_filter_;
+        common::CharArena allocator_;
+        common::ObNewRange range_;
+        common::ObRowDesc row_desc_;
+        uint64_t table_id_;
+        int64_t scan_size_;
+        int64_t data_version_;
+        bool has_pending_cell_;
+        bool is_end_;
+        bool is_broken_;
+        bool has_prefetched_;
+        int prefetch_ret_;
+        common::ObCellNewScanner prefetch_scanner_;
+    };
+
+    class ObUpsScanStreamMgr
+    {
+      struct Slot
+      {
+        int64_t stream_id;
+        bool using_flag;
+        int64_t last_active_time;
+        ObUpsScanStream *stream;
+      };
+      public:
+        // stream_id的低位是slot下标, 高位是递增序号, 防止误用已关闭的stream
+        static const int64_t MAX_STREAM_NUM = 1024;
+        static const int64_t FETCH_WAIT_INTERVAL_US = 100;
+      public:
+        ObUpsScanStreamMgr(SessionMgr &session_mgr);
+        ~ObUpsScanStreamMgr();
+      public:
+        void destroy();
+        // 占用一个空闲slot, 打开的stream超过max_stream_num时返回NULL
+        ObUpsScanStream *alloc(const int64_t max_stream_num, int64_t &stream_id);
+        // 占用stream_id对应的stream, 不存在时返回NULL;
+        // 正被其他线程使用(例如发送应答后的预取)时最多等待timeout
+        ObUpsScanStream *fetch(const int64_t stream_id, const int64_t timeout);
+        // 归还alloc或fetch占用的stream并刷新活跃时间
+        void revert(const int64_t stream_id);
+        // 关闭已占用的stream, 结束它的只读session并释放slot
+        void close(const int64_t stream_id);
+        // 关闭超过idle_time没有被访问的stream
+        void recycle_idle(const int64_t idle_time);
+        int64_t get_stream_num() const {return stream_num_;};
+      private:
+        Slot *get_slot_(const int64_t stream_id);
+      private:
+        SessionMgr &session_mgr_;
+        common::ObSpinLock lock_;
+        Slot slots_[MAX_STREAM_NUM];
+        int64_t stream_seq_;
+        volatile int64_t stream_num_;
+    };
+  }
+}
+
+#endif //OCEANBASE_UPDATESERVER_UPS_SCAN_STREAM_H_
@@ -40,7 +40,7 @@ namespace oceanbase
   {
     using namespace oceanbase::common;
     Dummy __dummy__;
-    GConf g_conf = {true, 0, true};
+    GConf g_conf = {true, 0, true, false};
 
     template <>
     int ups_serialize<uint64_t>(const uint64_t &data, char *buf, const int64_t data_len, int64_t& pos)
@@ -253,6 +253,21 @@ namespace oceanbase
       return ret;
     }
 
+    int64_t get_max_row_node_num()
+    {
+      int64_t ret = 0;
+      ObUpdateServerMain *ups_main = ObUpdateServerMain::get_instance();
+      if (NULL == ups_main)
+      {
+        TBSYS_LOG(WARN, "get updateserver main fail");
+      }
+      else
+      {
+        ret = ups_main->get_update_server().get_param().max_row_node_num;
+      }
+      return ret;
+    }
+
     int64_t get_table_available_warn_size()
     {
       int64_t ret = 0;
@@ -414,6 +429,24 @@ namespace oceanbase
       return bret;
     }
 
+    bool using_frozen_bloomfilter()
+    {
+      bool bret = false;
+      ObUpdateServerMain *ups_main = ObUpdateServerMain::get_instance();
+      if (NULL == ups_main)
+      {
+        TBSYS_LOG(WARN, "get updateserver main fail");
+      }
+      else
+      {
+        if (ups_main->get_update_server().get_param().using_frozen_bloomfilter)
+        {
+          bret = true;
+        }
+      }
+      return bret;
+    }
+
     bool sstable_dio_writing()
     {
       bool bret = true;
@@ -432,6 +465,79 @@ namespace oceanbase
       return bret;
     }
 
+    int64_t get_dump_sstable_io_limit()
+    {
+      int64_t ret = 0;
+      ObUpdateServerMain *ups_main = ObUpdateServerMain::get_instance();
+      if (NULL == ups_main)
+      {
+        TBSYS_LOG(WARN, "get updateserver main fail");
+      }
+      else
+      {
+        ret = ups_main->get_update_server().get_param().dump_sstable_io_limit;
+      }
+      return ret;
+    }
+
+    IOSpeedLimiter::IOSpeedLimiter() : rate_(0),
+                                       burst_(0),
+                                       tokens_(0),
+                                       last_refill_time_(0),
+                                       total_sleep_time_(0)
+    {
+    }
+
+    IOSpeedLimiter::~IOSpeedLimiter()
+    {
+    }
+
+    void IOSpeedLimiter::reset(const int64_t rate, const int64_t burst)
+    {
+      rate_ = (0 < rate) ? rate : 0;
+      burst_ = (0 < burst) ? burst : rate_;
+      tokens_ = burst_;
+      last_refill_time_ = tbsys::CTimeUtil::getTime();
+    }
+
+    void IOSpeedLimiter::refill_(const int64_t cur_time)
+    {
+      int64_t elapsed = cur_time - last_refill_time_;
+      if (0 < elapsed)
+      {
+        // 按秒和余数分开计算, 避免rate * elapsed溢出
+        int64_t tokens = (elapsed / 1000000L) * rate_ + (elapsed % 1000000L) * rate_ / 1000000L;
+        if (0 < tokens)
+        {
+          tokens_ = (burst_ - tokens_ < tokens) ? burst_ : tokens_ + tokens;
+          last_refill_time_ = cur_time;
+        }
+      }
+    }
+
+    int64_t IOSpeedLimiter::acquire(const int64_t size)
+    {
+      int64_t sleep_time = 0;
+      if (0 < rate_
+          && 0 < size)
+      {
+        tokens_ -= size;
+        refill_(tbsys::CTimeUtil::getTime());
+        // 令牌可以透支, 透支的部分通过睡眠补足, 单次写入大于burst时也不会卡住
+        while (0 > tokens_)
+        {
+          int64_t wait_time = (-tokens_) * 1000000L / rate_;
+          wait_time = (MIN_SLEEP_TIME_US > wait_time) ? MIN_SLEEP_TIME_US : wait_time;
+          wait_time = (MAX_SLEEP_TIME_US < wait_time) ? MAX_SLEEP_TIME_US : wait_time;
+          usleep(static_cast<useconds_t>(wait_time));
+          sleep_time += wait_time;
+          refill_(tbsys::CTimeUtil::getTime());
+        }
+        total_sleep_time_ += sleep_time;
+      }
+      return sleep_time;
+    }
+
     void log_scanner(common::ObScanner *scanner)
     {
       if (TBSYS_LOG_LEVEL_DEBUG == TBSYS_LOGGER._level
@@ -59,6 +59,7 @@ namespace oceanbase
     extern int precise_sleep(const int64_t microsecond);
     extern const char *inet_ntoa_r(easy_addr_t addr);
     extern int64_t get_max_row_cell_num();
+    extern int64_t get_max_row_node_num();
     extern int64_t get_table_available_warn_size();
     extern int64_t get_table_available_error_size();
     extern int64_t get_table_memory_limit();
@@ -68,7 +69,9 @@ namespace oceanbase
     extern void submit_force_drop();
     extern void schedule_warm_up_duty();
     extern bool using_memtable_bloomfilter();
+    extern bool using_frozen_bloomfilter();
     extern bool sstable_dio_writing();
+    extern int64_t get_dump_sstable_io_limit();
     extern void log_scanner(common::ObScanner *scanner);
     extern const char *print_scanner_info(common::ObScanner *scanner);
     extern int64_t get_active_mem_limit();
@@ -86,6 +89,7 @@ namespace oceanbase
       bool using_static_cm_column_id;
       volatile int64_t global_schema_version;
       bool using_hash_index;
+      bool using_skiplist_index;
     };
     extern GConf g_conf;
 
@@ -188,6 +192,32 @@ namespace oceanbase
       };
     };
 
+    // 令牌桶限速, 每秒补充rate个令牌, 最多积攒burst个, 令牌不足时睡眠等待
+    // 只在单个线程中使用, 不加锁
+    class IOSpeedLimiter
+    {
+      public:
+        static const int64_t MIN_SLEEP_TIME_US = 1000;
+        static const int64_t MAX_SLEEP_TIME_US = 100000;
+      public:
+        IOSpeedLimiter();
+        ~IOSpeedLimiter();
+      public:
+        // rate为0表示不限速, 配置变化时也调用, 只重置限速状态, 累计的睡眠时间不清零
+        void reset(const int64_t rate, const int64_t burst);
+        // 消耗size个令牌, 返回本次睡眠的时间
+        int64_t acquire(const int64_t size);
+        int64_t get_total_sleep_time() const {return total_sleep_time_;};
+      private:
+        void refill_(const int64_t cur_time);
+      private:
+        int64_t rate_;
+        int64_t burst_;
+        int64_t tokens_;
+        int64_t last_refill_time_;
+        int64_t total_sleep_time_;
+    };
+
     struct UpsPrivQueueConf
     {
       int64_t low_priv_network_lower_limit;
@@ -489,6 +489,38 @@ namespace oceanbase
         }
       }
 
+      TEST_F(TestObBlockCacheReaderLoader, test_load_blocks_by_position)
+      {
+        int ret;
+        uint64_t table_id = 100;
+        uint64_t column_group_id = 0;
+        int64_t loaded_size = 0;
+        int64_t block_num = 0;
+        ObRowkey start_key = cell_infos[0][0].row_key_;
+        ObDataIndexKey data_index;
+        ObBufferHandle handle;
+
+        // no tablet image to find sstable reader by sstable id
+        ret = cache_loader_.load_blocks_into_cache(new_index_cache_, new_block_cache_,
+                                                   &data_index, 1, loaded_size);
+        ASSERT_EQ(OB_INVALID_ARGUMENT, ret);
+        ASSERT_EQ(0, loaded_size);
+
+        ret = cache_loader_.load_block_into_cache(old_index_cache_, old_block_cache_,
+                                                  table_id, column_group_id,
+                                                  start_key, &reader_);
+        ASSERT_EQ(OB_SUCCESS, ret);
+        while (OB_SUCCESS == (ret = old_block_cache_.get_next_block(data_index, handle)))
+        {
+          ASSERT_EQ(reader_.get_sstable_id().sstable_file_id_, data_index.sstable_id);
+          ASSERT_TRUE(data_index.size > 0);
+          ASSERT_TRUE(old_block_cache_.get_iter_access_time(handle) >= 0);
+          ++block_num;
+        }
+        ASSERT_EQ(OB_ITER_END, ret);
+        ASSERT_EQ(1, block_num);
+      }
+
     }//end namespace common
   }//end namespace tests
 }//end namespace oceanbase
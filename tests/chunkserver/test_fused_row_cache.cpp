@@ -0,0 +1,166 @@
+#include <tblog.h>
+#include <gtest/gtest.h>
+
+#include "common/ob_malloc.h"
+#include "common/ob_row_modify_slots.h"
+#include "ob_fused_row_cache.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::chunkserver;
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
+
+static const uint64_t TABLE_ID = 1001;
+static const int64_t DATA_VERSION = 3;
+
+class TestFusedRowCache: public ::testing::Test
+{
+  public:
+    virtual void SetUp()
+    {
+      row_desc_.add_column_desc(TABLE_ID, 16);
+      row_desc_.add_column_desc(TABLE_ID, 17);
+      row_.set_row_desc(row_desc_);
+      rowkey_obj_.set_int(1);
+      rowkey_.assign(&rowkey_obj_, 1);
+      signature_ = ObFusedRowCache::get_column_signature(row_desc_);
+      ASSERT_EQ(OB_SUCCESS, cache_.init(8 * 1024 * 1024, 10 * 1000 * 1000));
+    }
+
+    virtual void TearDown()
+    {
+      cache_.destroy();
+    }
+
+    void set_row(const int64_t value)
+    {
+      ObObj cell;
+      cell.set_int(value);
+      ASSERT_EQ(OB_SUCCESS, row_.raw_set_cell(0, cell));
+      cell.set_int(value + 1);
+      ASSERT_EQ(OB_SUCCESS, row_.raw_set_cell(1, cell));
+    }
+
+    int get_row(int64_t& value)
+    {
+      int ret = OB_SUCCESS;
+      ObRow row;
+      ObRowStore row_store;
+      const ObObj* cell = NULL;
+      uint64_t table_id = OB_INVALID_ID;
+      uint64_t column_id = OB_INVALID_ID;
+      ObFusedRowCache::Snapshot snapshot;
+      ObFusedRowCacheKey key(TABLE_ID, DATA_VERSION, signature_, rowkey_);
+      row.set_row_desc(row_desc_);
+      if (!cache_.get_snapshot(snapshot))
+      {
+        ret = OB_NOT_INIT;
+      }
+      else if (OB_SUCCESS == (ret = cache_.get_row(key, snapshot, row, row_store))
+               && OB_SUCCESS == (ret = row_store.get_next_row(row)))
+      {
+        row.raw_get_cell(0, cell, table_id, column_id);
+        cell->get_int(value);
+      }
+      return ret;
+    }
+
+    void put_row(const int64_t value)
+    {
+      ObFusedRowCache::Snapshot snapshot;
+      ObFusedRowCacheKey key(TABLE_ID, DATA_VERSION, signature_, rowkey_);
+      set_row(value);
+      ASSERT_TRUE(cache_.get_snapshot(snapshot));
+      ASSERT_EQ(OB_SUCCESS, cache_.put_row(key, snapshot, row_));
+    }
+
+  protected:
+    ObFusedRowCache cache_;
+    ObRowDesc row_desc_;
+    ObRow row_;
+    ObObj rowkey_obj_;
+    ObRowkey rowkey_;
+    uint64_t signature_;
+    ObRowModifySlots slots_;
+};
+
+TEST_F(TestFusedRowCache, serialize_slots)
+{
+  char buf[1024];
+  int64_t pos = 0;
+  ObRowModifySlots slots;
+  slots_.set_ups_epoch(7);
+  slots_.set_commited_trans_id(100);
+  EXPECT_EQ(OB_SUCCESS, slots_.add_slot(3, 90));
+  EXPECT_EQ(OB_SUCCESS, slots_.add_slot(5, 99));
+  EXPECT_EQ(OB_INVALID_ARGUMENT, slots_.add_slot(ROW_MODIFY_SLOT_NUM, 99));
+  EXPECT_EQ(OB_SUCCESS, slots_.serialize(buf, sizeof(buf), pos));
+  EXPECT_EQ(pos, slots_.get_serialize_size());
+  pos = 0;
+  EXPECT_EQ(OB_SUCCESS, slots.deserialize(buf, sizeof(buf), pos));
+  EXPECT_EQ(7, slots.get_ups_epoch());
+  EXPECT_EQ(100, slots.get_commited_trans_id());
+  EXPECT_FALSE(slots.is_overflow());
+  ASSERT_EQ(2, slots.get_slot_count());
+  EXPECT_EQ(5, slots.get_slot(1).slot_);
+  EXPECT_EQ(99, slots.get_slot(1).trans_id_);
+}
+
+TEST_F(TestFusedRowCache, validate)
+{
+  int64_t value = 0;
+  ObFusedRowCache::Snapshot snapshot;
+
+  // not synced with ups yet
+  EXPECT_FALSE(cache_.get_snapshot(snapshot));
+
+  slots_.set_ups_epoch(7);
+  slots_.set_commited_trans_id(100);
+  EXPECT_EQ(OB_SUCCESS, cache_.apply_modify_slots(slots_));
+  EXPECT_EQ(OB_ENTRY_NOT_EXIST, get_row(value));
+  put_row(10);
+  EXPECT_EQ(OB_SUCCESS, get_row(value));
+  EXPECT_EQ(10, value);
+
+  // other slot modified, still valid
+  slots_.reset();
+  slots_.set_ups_epoch(7);
+  slots_.set_commited_trans_id(200);
+  slots_.add_slot((get_row_modify_slot(TABLE_ID, rowkey_) + 1) % ROW_MODIFY_SLOT_NUM, 150);
+  EXPECT_EQ(OB_SUCCESS, cache_.apply_modify_slots(slots_));
+  EXPECT_EQ(OB_SUCCESS, get_row(value));
+
+  // slot of the row modified after the row is read
+  slots_.reset();
+  slots_.set_ups_epoch(7);
+  slots_.set_commited_trans_id(300);
+  slots_.add_slot(get_row_modify_slot(TABLE_ID, rowkey_), 250);
+  EXPECT_EQ(OB_SUCCESS, cache_.apply_modify_slots(slots_));
+  EXPECT_EQ(OB_ENTRY_NOT_EXIST, get_row(value));
+  put_row(20);
+  EXPECT_EQ(OB_SUCCESS, get_row(value));
+  EXPECT_EQ(20, value);
+
+  // ups restarted
+  slots_.reset();
+  slots_.set_ups_epoch(8);
+  slots_.set_commited_trans_id(400);
+  EXPECT_EQ(OB_SUCCESS, cache_.apply_modify_slots(slots_));
+  EXPECT_EQ(OB_ENTRY_NOT_EXIST, get_row(value));
+  put_row(30);
+  EXPECT_EQ(OB_SUCCESS, get_row(value));
+  EXPECT_EQ(30, value);
+
+  // too many slots modified
+  slots_.reset();
+  slots_.set_ups_epoch(8);
+  slots_.set_commited_trans_id(500);
+  slots_.set_overflow();
+  EXPECT_EQ(OB_SUCCESS, cache_.apply_modify_slots(slots_));
+  EXPECT_EQ(OB_ENTRY_NOT_EXIST, get_row(value));
+}
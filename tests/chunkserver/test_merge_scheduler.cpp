@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <sys/sysmacros.h>
+#include "common/ob_malloc.h"
+#include "chunkserver/ob_merge_scheduler.h"
+
+using namespace oceanbase;
+using namespace oceanbase::common;
+using namespace oceanbase::chunkserver;
+
+static const int64_t READ_LATENCY_HIGH = 10000;
+static const int64_t DISK_UTIL_HIGH = 80;
+static const int64_t DISK_UTIL_LOW = 50;
+static const int64_t MAX_MERGE_PER_DISK = 3;
+static const int64_t MIN_THREAD_NUM = 1;
+static const int64_t MAX_THREAD_NUM = 8;
+
+// 用给定的读延迟和磁盘利用率代替chunkserver统计和/proc/diskstats
+class MockMergeScheduler : public ObMergeScheduler
+{
+  public:
+    MockMergeScheduler() : read_latency_(-1)
+    {
+      memset(util_, 0, sizeof(util_));
+    }
+    int init(const int32_t disk_num)
+    {
+      int ret = OB_SUCCESS;
+      set_param(0, READ_LATENCY_HIGH, DISK_UTIL_HIGH, DISK_UTIL_LOW, MAX_MERGE_PER_DISK);
+      for (int32_t i = 0; OB_SUCCESS == ret && i < disk_num; ++i)
+      {
+        ret = add_disk(i + 1, makedev(8, 16 * i));
+      }
+      reset(MIN_THREAD_NUM, MAX_THREAD_NUM);
+      // 第一次只采样作为基准
+      adjust();
+      return ret;
+    }
+    void set_load(const int64_t read_latency, const int64_t util1, const int64_t util2)
+    {
+      read_latency_ = read_latency;
+      util_[0] = util1;
+      util_[1] = util2;
+    }
+    // 按当前负载调整一次, 返回调整后的目标线程数
+    int64_t adjust_by_load(const int64_t read_latency, const int64_t util1, const int64_t util2)
+    {
+      set_load(read_latency, util1, util2);
+      adjust();
+      return get_target_thread_num();
+    }
+  protected:
+    virtual int64_t sample_read_latency()
+    {
+      return read_latency_;
+    }
+    virtual int sample_disk_util(const int64_t elapsed_time)
+    {
+      UNUSED(elapsed_time);
+      for (int32_t i = 0; i < disk_num_; ++i)
+      {
+        disk_util_[i] = util_[i];
+      }
+      return OB_SUCCESS;
+    }
+  private:
+    int64_t read_latency_;
+    int64_t util_[MAX_DISK_SLOT];
+};
+
+TEST(ObMergeScheduler, init)
+{
+  MockMergeScheduler scheduler;
+  ASSERT_EQ(OB_SUCCESS, scheduler.init(2));
+  EXPECT_EQ(MAX_THREAD_NUM, scheduler.get_target_thread_num());
+  EXPECT_EQ(MAX_MERGE_PER_DISK, scheduler.get_disk_merge_limit(1));
+  EXPECT_EQ(MAX_MERGE_PER_DISK, scheduler.get_disk_merge_limit(2));
+  // 没有监控的磁盘按最大值
+  EXPECT_EQ(MAX_MERGE_PER_DISK, scheduler.get_disk_merge_limit(-1));
+}
+
+TEST(ObMergeScheduler, high_latency_halve)
+{
+  MockMergeScheduler scheduler;
+  ASSERT_EQ(OB_SUCCESS, scheduler.init(2));
+  EXPECT_EQ(4, scheduler.adjust_by_load(READ_LATENCY_HIGH + 1, 10, 10));
+  EXPECT_EQ(MAX_MERGE_PER_DISK - 1, scheduler.get_disk_merge_limit(1));
+  EXPECT_EQ(MAX_MERGE_PER_DISK - 1, scheduler.get_disk_merge_limit(2));
+  EXPECT_EQ(2, scheduler.adjust_by_load(READ_LATENCY_HIGH + 1, 10, 10));
+  EXPECT_EQ(1, scheduler.adjust_by_load(READ_LATENCY_HIGH + 1, 10, 10));
+  // 不低于最小线程数, 每块盘至少一个合并
+  EXPECT_EQ(MIN_THREAD_NUM, scheduler.adjust_by_load(READ_LATENCY_HIGH * 10, 10, 10));
+  EXPECT_EQ(1, scheduler.get_disk_merge_limit(1));
+  EXPECT_EQ(1, scheduler.get_disk_merge_limit(2));
+}
+
+TEST(ObMergeScheduler, low_load_increase)
+{
+  MockMergeScheduler scheduler;
+  ASSERT_EQ(OB_SUCCESS, scheduler.init(2));
+  for (int64_t i = 0; i < 4; ++i)
+  {
+    scheduler.adjust_by_load(READ_LATENCY_HIGH + 1, 90, 90);
+  }
+  EXPECT_EQ(MIN_THREAD_NUM, scheduler.get_target_thread_num());
+  EXPECT_EQ(1, scheduler.get_disk_merge_limit(1));
+  // 负载低时每次加一个线程, 直到最大线程数
+  for (int64_t i = MIN_THREAD_NUM + 1; i <= MAX_THREAD_NUM; ++i)
+  {
+    EXPECT_EQ(i, scheduler.adjust_by_load(READ_LATENCY_HIGH / 2 - 1, DISK_UTIL_LOW - 1, 0));
+  }
+  EXPECT_EQ(MAX_THREAD_NUM, scheduler.adjust_by_load(READ_LATENCY_HIGH / 2 - 1, DISK_UTIL_LOW - 1, 0));
+  EXPECT_EQ(MAX_MERGE_PER_DISK, scheduler.get_disk_merge_limit(1));
+  EXPECT_EQ(MAX_MERGE_PER_DISK, scheduler.get_disk_merge_limit(2));
+  // 没有读请求也按负载低处理
+  EXPECT_EQ(4, scheduler.adjust_by_load(READ_LATENCY_HIGH + 1, 0, 0));
+  EXPECT_EQ(5, scheduler.adjust_by_load(-1, 0, 0));
+}
+
+TEST(ObMergeScheduler, keep_in_middle)
+{
+  MockMergeScheduler scheduler;
+  ASSERT_EQ(OB_SUCCESS, scheduler.init(2));
+  EXPECT_EQ(4, scheduler.adjust_by_load(READ_LATENCY_HIGH + 1, 10, 10));
+  // 读延迟或磁盘利用率在高低门限之间时保持不变
+  EXPECT_EQ(4, scheduler.adjust_by_load(READ_LATENCY_HIGH, 10, 10));
+  EXPECT_EQ(4, scheduler.adjust_by_load(READ_LATENCY_HIGH / 2, 10, 10));
+  EXPECT_EQ(4, scheduler.adjust_by_load(READ_LATENCY_HIGH / 2 - 1, DISK_UTIL_LOW, 10));
+  EXPECT_EQ(4, scheduler.adjust_by_load(READ_LATENCY_HIGH / 2 - 1, DISK_UTIL_HIGH, 10));
+  EXPECT_EQ(MAX_MERGE_PER_DISK - 1, scheduler.get_disk_merge_limit(1));
+  EXPECT_EQ(MAX_MERGE_PER_DISK, scheduler.get_disk_merge_limit(2));
+}
+
+TEST(ObMergeScheduler, busy_disk)
+{
+  MockMergeScheduler scheduler;
+  ASSERT_EQ(OB_SUCCESS, scheduler.init(2));
+  // 任何一块盘忙都减半总线程数, 但只减少忙的那块盘上的合并数
+  EXPECT_EQ(4, scheduler.adjust_by_load(0, DISK_UTIL_HIGH + 1, 0));
+  EXPECT_EQ(MAX_MERGE_PER_DISK - 1, scheduler.get_disk_merge_limit(1));
+  EXPECT_EQ(MAX_MERGE_PER_DISK, scheduler.get_disk_merge_limit(2));
+  EXPECT_EQ(2, scheduler.adjust_by_load(0, 100, 0));
+  EXPECT_EQ(1, scheduler.get_disk_merge_limit(1));
+  EXPECT_EQ(MAX_MERGE_PER_DISK, scheduler.get_disk_merge_limit(2));
+  EXPECT_EQ(1, scheduler.adjust_by_load(0, 0, DISK_UTIL_HIGH + 1));
+  EXPECT_EQ(2, scheduler.get_disk_merge_limit(1));
+  EXPECT_EQ(MAX_MERGE_PER_DISK - 1, scheduler.get_disk_merge_limit(2));
+}
+
+TEST(ObMergeScheduler, lower_max_merge_per_disk)
+{
+  MockMergeScheduler scheduler;
+  ASSERT_EQ(OB_SUCCESS, scheduler.init(2));
+  scheduler.set_param(0, READ_LATENCY_HIGH, DISK_UTIL_HIGH, DISK_UTIL_LOW, 1);
+  EXPECT_EQ(1, scheduler.get_disk_merge_limit(1));
+  EXPECT_EQ(1, scheduler.get_disk_merge_limit(2));
+  EXPECT_EQ(MAX_THREAD_NUM, scheduler.adjust_by_load(0, 0, 0));
+  EXPECT_EQ(1, scheduler.get_disk_merge_limit(1));
+}
+
+int main(int argc, char **argv)
+{
+  common::ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
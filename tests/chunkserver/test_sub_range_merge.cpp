@@ -0,0 +1,377 @@
+/**
+ * (C) 2010-2012 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * test_sub_range_merge.cpp for test splitting big tablet into sub
+ * ranges and merging them in the sub merge pool.
+ *
+ */
+
+#include <tblog.h>
+#include <gtest/gtest.h>
+#include "common/ob_malloc.h"
+#include "chunkserver/ob_sub_merge_pool.h"
+#include "chunkserver/ob_tablet_merger_v2.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::chunkserver;
+
+namespace oceanbase
+{
+  namespace tests
+  {
+    namespace chunkserver
+    {
+      static const int64_t MAX_KEY_NUM = 16;
+
+      class TestSubRangeMerge : public ::testing::Test
+      {
+        public:
+          virtual void SetUp()
+          {
+            range_.table_id_ = 1001;
+            range_.start_key_ = make_key(start_obj_, 10);
+            range_.end_key_ = make_key(end_obj_, 100);
+            range_.border_flag_.unset_inclusive_start();
+            range_.border_flag_.set_inclusive_end();
+          }
+
+          ObRowkey make_key(ObObj& obj, const int64_t value)
+          {
+            obj.set_int(value);
+            return ObRowkey(&obj, 1);
+          }
+
+          void set_endkeys(const int64_t* values, const int64_t count)
+          {
+            for (int64_t i = 0; i < count; ++i)
+            {
+              endkeys_[i] = make_key(endkey_objs_[i], values[i]);
+            }
+          }
+
+          void check_key(const ObRowkey& key, const int64_t value)
+          {
+            int64_t v = 0;
+            ASSERT_EQ(1, key.get_obj_cnt());
+            ASSERT_EQ(OB_SUCCESS, key.get_obj_ptr()[0].get_int(v));
+            ASSERT_EQ(value, v);
+          }
+
+        protected:
+          ObNewRange range_;
+          ObObj start_obj_;
+          ObObj end_obj_;
+          ObObj endkey_objs_[MAX_KEY_NUM];
+          ObRowkey endkeys_[MAX_KEY_NUM];
+          ObNewRange sub_ranges_[MAX_KEY_NUM];
+      };
+
+      TEST_F(TestSubRangeMerge, build_sub_ranges)
+      {
+        const int64_t values[] = {20, 50, 80};
+        int64_t sub_range_count = 0;
+        set_endkeys(values, 3);
+        ASSERT_EQ(OB_SUCCESS, ObTabletMergerV2::build_sub_ranges(range_, endkeys_, 3,
+              sub_ranges_, MAX_KEY_NUM, sub_range_count));
+        ASSERT_EQ(4, sub_range_count);
+
+        // (10, 20], (20, 50], (50, 80], (80, 100]
+        const int64_t bounds[] = {10, 20, 50, 80, 100};
+        for (int64_t i = 0; i < sub_range_count; ++i)
+        {
+          ASSERT_EQ(range_.table_id_, sub_ranges_[i].table_id_);
+          check_key(sub_ranges_[i].start_key_, bounds[i]);
+          check_key(sub_ranges_[i].end_key_, bounds[i + 1]);
+          ASSERT_FALSE(sub_ranges_[i].border_flag_.inclusive_start());
+          ASSERT_TRUE(sub_ranges_[i].border_flag_.inclusive_end());
+          if (i > 0)
+          {
+            // adjacent and in key order
+            ASSERT_EQ(0, sub_ranges_[i - 1].end_key_.compare(sub_ranges_[i].start_key_));
+          }
+        }
+      }
+
+      TEST_F(TestSubRangeMerge, build_sub_ranges_boundary)
+      {
+        // on or out of the tablet bounds, duplicate and decreasing endkeys are skipped
+        const int64_t values[] = {5, 10, 30, 30, 20, 60, 100, 200};
+        int64_t sub_range_count = 0;
+        set_endkeys(values, 8);
+        range_.border_flag_.set_inclusive_start();
+        range_.border_flag_.unset_inclusive_end();
+        ASSERT_EQ(OB_SUCCESS, ObTabletMergerV2::build_sub_ranges(range_, endkeys_, 8,
+              sub_ranges_, MAX_KEY_NUM, sub_range_count));
+        ASSERT_EQ(3, sub_range_count);
+
+        // [10, 30], (30, 60], (60, 100)
+        check_key(sub_ranges_[0].start_key_, 10);
+        check_key(sub_ranges_[0].end_key_, 30);
+        ASSERT_TRUE(sub_ranges_[0].border_flag_.inclusive_start());
+        ASSERT_TRUE(sub_ranges_[0].border_flag_.inclusive_end());
+        check_key(sub_ranges_[1].start_key_, 30);
+        check_key(sub_ranges_[1].end_key_, 60);
+        ASSERT_FALSE(sub_ranges_[1].border_flag_.inclusive_start());
+        ASSERT_TRUE(sub_ranges_[1].border_flag_.inclusive_end());
+        check_key(sub_ranges_[2].start_key_, 60);
+        check_key(sub_ranges_[2].end_key_, 100);
+        ASSERT_FALSE(sub_ranges_[2].border_flag_.inclusive_start());
+        ASSERT_FALSE(sub_ranges_[2].border_flag_.inclusive_end());
+      }
+
+      TEST_F(TestSubRangeMerge, build_sub_ranges_whole_range)
+      {
+        const int64_t values[] = {20, 50};
+        int64_t sub_range_count = 0;
+        set_endkeys(values, 2);
+        range_.set_whole_range();
+        range_.border_flag_.set_min_value();
+        range_.border_flag_.set_max_value();
+        ASSERT_EQ(OB_SUCCESS, ObTabletMergerV2::build_sub_ranges(range_, endkeys_, 2,
+              sub_ranges_, MAX_KEY_NUM, sub_range_count));
+        ASSERT_EQ(3, sub_range_count);
+
+        // the first keeps MIN and the last keeps MAX
+        ASSERT_TRUE(sub_ranges_[0].start_key_.is_min_row());
+        ASSERT_TRUE(sub_ranges_[0].border_flag_.is_min_value());
+        ASSERT_FALSE(sub_ranges_[0].border_flag_.is_max_value());
+        check_key(sub_ranges_[0].end_key_, 20);
+        check_key(sub_ranges_[1].start_key_, 20);
+        check_key(sub_ranges_[1].end_key_, 50);
+        ASSERT_FALSE(sub_ranges_[1].border_flag_.is_min_value());
+        ASSERT_FALSE(sub_ranges_[1].border_flag_.is_max_value());
+        check_key(sub_ranges_[2].start_key_, 50);
+        ASSERT_TRUE(sub_ranges_[2].end_key_.is_max_row());
+        ASSERT_FALSE(sub_ranges_[2].border_flag_.is_min_value());
+        ASSERT_TRUE(sub_ranges_[2].border_flag_.is_max_value());
+      }
+
+      TEST_F(TestSubRangeMerge, build_sub_ranges_not_split)
+      {
+        const int64_t values[] = {10, 100, 200};
+        int64_t sub_range_count = 0;
+        set_endkeys(values, 3);
+        ASSERT_EQ(OB_SUCCESS, ObTabletMergerV2::build_sub_ranges(range_, endkeys_, 3,
+              sub_ranges_, MAX_KEY_NUM, sub_range_count));
+        ASSERT_EQ(0, sub_range_count);
+        ASSERT_EQ(OB_SUCCESS, ObTabletMergerV2::build_sub_ranges(range_, NULL, 0,
+              sub_ranges_, MAX_KEY_NUM, sub_range_count));
+        ASSERT_EQ(0, sub_range_count);
+        // no room for the last sub range
+        ASSERT_EQ(OB_INVALID_ARGUMENT, ObTabletMergerV2::build_sub_ranges(range_, endkeys_, 3,
+              sub_ranges_, 3, sub_range_count));
+      }
+
+      class FakeSubMergeTask : public ObSubMergePool::Task
+      {
+        public:
+          FakeSubMergeTask() : index_(0), sleep_us_(0), result_(OB_SUCCESS),
+            mutex_(NULL), running_(NULL), max_running_(NULL), finish_seq_(NULL),
+            finish_order_(-1), thread_id_(0)
+          {
+          }
+
+          virtual int process()
+          {
+            pthread_mutex_lock(mutex_);
+            if (++(*running_) > *max_running_)
+            {
+              *max_running_ = *running_;
+            }
+            pthread_mutex_unlock(mutex_);
+            usleep(static_cast<useconds_t>(sleep_us_));
+            pthread_mutex_lock(mutex_);
+            thread_id_ = pthread_self();
+            finish_order_ = (*finish_seq_)++;
+            --(*running_);
+            pthread_mutex_unlock(mutex_);
+            return result_;
+          }
+
+        public:
+          int64_t index_;
+          int64_t sleep_us_;
+          int result_;
+          pthread_mutex_t* mutex_;
+          int64_t* running_;
+          int64_t* max_running_;
+          int64_t* finish_seq_;
+          int64_t finish_order_;
+          pthread_t thread_id_;
+      };
+
+      class TestSubMergePool : public ::testing::Test
+      {
+        public:
+          TestSubMergePool() : running_(0), max_running_(0), finish_seq_(0)
+          {
+            pthread_mutex_init(&mutex_, NULL);
+          }
+
+          ~TestSubMergePool()
+          {
+            pthread_mutex_destroy(&mutex_);
+          }
+
+          void init_tasks(FakeSubMergeTask* tasks, ObSubMergePool::Task** task_list, const int64_t count)
+          {
+            for (int64_t i = 0; i < count; ++i)
+            {
+              tasks[i].index_ = i;
+              // the first task finishes the last
+              tasks[i].sleep_us_ = (count - i) * 10000;
+              tasks[i].mutex_ = &mutex_;
+              tasks[i].running_ = &running_;
+              tasks[i].max_running_ = &max_running_;
+              tasks[i].finish_seq_ = &finish_seq_;
+              task_list[i] = &tasks[i];
+            }
+          }
+
+        protected:
+          pthread_mutex_t mutex_;
+          int64_t running_;
+          int64_t max_running_;
+          int64_t finish_seq_;
+      };
+
+      TEST_F(TestSubMergePool, bounded_and_ordered)
+      {
+        static const int64_t TASK_NUM = 12;
+        static const int64_t THREAD_NUM = 3;
+        ObSubMergePool pool;
+        FakeSubMergeTask tasks[TASK_NUM];
+        ObSubMergePool::Task* task_list[TASK_NUM];
+        init_tasks(tasks, task_list, TASK_NUM);
+
+        ASSERT_EQ(OB_SUCCESS, pool.init(THREAD_NUM));
+        ASSERT_EQ(THREAD_NUM, pool.get_thread_num());
+        ASSERT_EQ(OB_INIT_TWICE, pool.init(THREAD_NUM));
+        ASSERT_EQ(OB_SUCCESS, pool.process(task_list, TASK_NUM));
+
+        // all tasks are done when process() returns, by at most THREAD_NUM threads
+        ASSERT_EQ(TASK_NUM, finish_seq_);
+        ASSERT_EQ(0, running_);
+        ASSERT_GE(THREAD_NUM, max_running_);
+        bool out_of_order = false;
+        for (int64_t i = 0; i < TASK_NUM; ++i)
+        {
+          // results are still read in task order
+          ASSERT_EQ(i, tasks[i].index_);
+          ASSERT_EQ(OB_SUCCESS, tasks[i].get_ret());
+          ASSERT_TRUE(0 == pthread_equal(pthread_self(), tasks[i].thread_id_));
+          if (tasks[i].finish_order_ != i)
+          {
+            out_of_order = true;
+          }
+        }
+        ASSERT_TRUE(out_of_order);
+        pool.destroy();
+        ASSERT_EQ(0, pool.get_thread_num());
+      }
+
+      TEST_F(TestSubMergePool, first_error)
+      {
+        static const int64_t TASK_NUM = 4;
+        ObSubMergePool pool;
+        FakeSubMergeTask tasks[TASK_NUM];
+        ObSubMergePool::Task* task_list[TASK_NUM];
+        init_tasks(tasks, task_list, TASK_NUM);
+        // the last task fails first
+        tasks[1].result_ = OB_ERROR;
+        tasks[3].result_ = OB_SIZE_OVERFLOW;
+
+        ASSERT_EQ(OB_SUCCESS, pool.init(2));
+        ASSERT_EQ(OB_ERROR, pool.process(task_list, TASK_NUM));
+        // the others are still merged so their sstables can be cleaned up
+        ASSERT_EQ(TASK_NUM, finish_seq_);
+        ASSERT_EQ(OB_SUCCESS, tasks[0].get_ret());
+        ASSERT_EQ(OB_ERROR, tasks[1].get_ret());
+        ASSERT_EQ(OB_SUCCESS, tasks[2].get_ret());
+        ASSERT_EQ(OB_SIZE_OVERFLOW, tasks[3].get_ret());
+        ASSERT_EQ(OB_INVALID_ARGUMENT, pool.process(task_list, 0));
+      }
+
+      TEST_F(TestSubMergePool, not_started)
+      {
+        static const int64_t TASK_NUM = 3;
+        ObSubMergePool pool;
+        FakeSubMergeTask tasks[TASK_NUM];
+        ObSubMergePool::Task* task_list[TASK_NUM];
+        init_tasks(tasks, task_list, TASK_NUM);
+
+        ASSERT_EQ(OB_INVALID_ARGUMENT, pool.init(0));
+        ASSERT_EQ(OB_SUCCESS, pool.process(task_list, TASK_NUM));
+        for (int64_t i = 0; i < TASK_NUM; ++i)
+        {
+          // in the caller thread one by one
+          ASSERT_TRUE(0 != pthread_equal(pthread_self(), tasks[i].thread_id_));
+          ASSERT_EQ(i, tasks[i].finish_order_);
+        }
+        ASSERT_EQ(1, max_running_);
+      }
+
+      struct ProcessArg
+      {
+        ObSubMergePool* pool_;
+        ObSubMergePool::Task** task_list_;
+        int64_t count_;
+        int ret_;
+      };
+
+      void* process_routine(void* arg)
+      {
+        ProcessArg* process_arg = reinterpret_cast<ProcessArg*>(arg);
+        process_arg->ret_ = process_arg->pool_->process(process_arg->task_list_, process_arg->count_);
+        return NULL;
+      }
+
+      TEST_F(TestSubMergePool, shared_by_merge_threads)
+      {
+        static const int64_t MERGE_THREAD_NUM = 4;
+        static const int64_t TASK_NUM = 4;
+        static const int64_t THREAD_NUM = 2;
+        ObSubMergePool pool;
+        FakeSubMergeTask tasks[MERGE_THREAD_NUM][TASK_NUM];
+        ObSubMergePool::Task* task_list[MERGE_THREAD_NUM][TASK_NUM];
+        ProcessArg args[MERGE_THREAD_NUM];
+        pthread_t threads[MERGE_THREAD_NUM];
+
+        ASSERT_EQ(OB_SUCCESS, pool.init(THREAD_NUM));
+        for (int64_t i = 0; i < MERGE_THREAD_NUM; ++i)
+        {
+          init_tasks(tasks[i], task_list[i], TASK_NUM);
+          tasks[i][i].result_ = OB_ERROR;
+          args[i].pool_ = &pool;
+          args[i].task_list_ = task_list[i];
+          args[i].count_ = TASK_NUM;
+          args[i].ret_ = OB_SUCCESS;
+          ASSERT_EQ(0, pthread_create(&threads[i], NULL, process_routine, &args[i]));
+        }
+        for (int64_t i = 0; i < MERGE_THREAD_NUM; ++i)
+        {
+          pthread_join(threads[i], NULL);
+          // each merge thread only sees its own tasks
+          ASSERT_EQ(OB_ERROR, args[i].ret_);
+          for (int64_t j = 0; j < TASK_NUM; ++j)
+          {
+            ASSERT_EQ(i == j ? OB_ERROR : OB_SUCCESS, tasks[i][j].get_ret());
+          }
+        }
+        ASSERT_EQ(MERGE_THREAD_NUM * TASK_NUM, finish_seq_);
+        ASSERT_GE(THREAD_NUM, max_running_);
+      }
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,4 +1,5 @@
 #include "ob_compressor.h"
+#include "ob_adaptive_compressor.h"
 #include <iostream>
 #include <stdio.h>
 #include <stdlib.h>
@@ -126,6 +127,223 @@ TEST(TestLibcomp, compress_snappy)
   }
 }
 
+static char *read_comp_data(int64_t &size)
+{
+  char *fname = (char*)"./data/comp.data";
+  struct stat st;
+  FILE *fd = fopen(fname, "r");
+  stat(fname, &st);
+  char *src_buffer = new char[st.st_size];
+  fread(src_buffer, sizeof(char), st.st_size, fd);
+  fclose(fd);
+  size = st.st_size;
+  return src_buffer;
+}
+
+static void check_compress(ObCompressor *comp, const char *src_buffer, const int64_t size)
+{
+  char *comp_buffer = new char[size + comp->get_max_overflow_size(size)];
+  char *decomp_buffer = new char[size];
+  int64_t ret_size = size + comp->get_max_overflow_size(size);
+
+  EXPECT_EQ(ObCompressor::COM_E_OVERFLOW, comp->compress(src_buffer, size, comp_buffer, size, ret_size));
+  EXPECT_EQ(ObCompressor::COM_E_NOERROR, comp->compress(src_buffer, size, comp_buffer, ret_size, ret_size));
+  EXPECT_EQ(ObCompressor::COM_E_NOERROR, comp->decompress(comp_buffer, ret_size, decomp_buffer, size, ret_size));
+  EXPECT_EQ(size, ret_size);
+  EXPECT_EQ(0, memcmp(decomp_buffer, src_buffer, size));
+
+  EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->compress(NULL, 1, NULL, 1, ret_size));
+  EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->compress(src_buffer, 0, comp_buffer, 0, ret_size));
+  EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->decompress(NULL, 1, NULL, 1, ret_size));
+  EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->decompress(src_buffer, -1, comp_buffer, -1, ret_size));
+
+  delete[] decomp_buffer;
+  delete[] comp_buffer;
+}
+
+TEST(TestLibcomp, compress_lz4)
+{
+  int64_t size = 0;
+  char *src_buffer = read_comp_data(size);
+  ObCompressor *comp = create_compressor("lz4_1.0");
+  EXPECT_TRUE(NULL != comp);
+  if (NULL != comp)
+  {
+    check_compress(comp, src_buffer, size);
+    EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->set_compress_level(0));
+    EXPECT_EQ(ObCompressor::COM_E_NOERROR, comp->set_compress_level(8));
+    check_compress(comp, src_buffer, size);
+    EXPECT_EQ(ObCompressor::COM_E_NOIMPL, comp->set_compress_dict(src_buffer, size));
+    EXPECT_EQ(0, strcmp("lz4_1.0", comp->get_compressor_name()));
+    destroy_compressor(comp);
+  }
+  delete[] src_buffer;
+}
+
+TEST(TestLibcomp, compress_zstd)
+{
+  int64_t size = 0;
+  char *src_buffer = read_comp_data(size);
+  ObCompressor *comp = create_compressor("zstd_1.0");
+  ObCompressor *decomp = create_compressor("zstd_1.0");
+  EXPECT_TRUE(NULL != comp);
+  EXPECT_TRUE(NULL != decomp);
+  if (NULL != comp && NULL != decomp)
+  {
+    check_compress(comp, src_buffer, size);
+    EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->set_compress_level(0));
+    EXPECT_EQ(ObCompressor::COM_E_NOERROR, comp->set_compress_level(19));
+    check_compress(comp, src_buffer, size);
+    EXPECT_EQ(0, strcmp("zstd_1.0", comp->get_compressor_name()));
+
+    // data compressed with dictionary can't be decompressed without it
+    char *comp_buffer = new char[size + comp->get_max_overflow_size(size)];
+    char *decomp_buffer = new char[size];
+    int64_t dict_size = size / 4;
+    int64_t ret_size = 0;
+    EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->set_compress_dict(NULL, 0));
+    EXPECT_EQ(ObCompressor::COM_E_NOERROR, comp->set_compress_dict(src_buffer, dict_size));
+    check_compress(comp, src_buffer, size);
+    EXPECT_EQ(ObCompressor::COM_E_NOERROR, comp->compress(src_buffer, size, comp_buffer,
+                                                          size + comp->get_max_overflow_size(size), ret_size));
+    EXPECT_NE(ObCompressor::COM_E_NOERROR, decomp->decompress(comp_buffer, ret_size, decomp_buffer, size, ret_size));
+    delete[] decomp_buffer;
+    delete[] comp_buffer;
+  }
+  destroy_compressor(comp);
+  destroy_compressor(decomp);
+  delete[] src_buffer;
+}
+
+TEST(TestLibcomp, compress_adaptive)
+{
+  int64_t size = 0;
+  int64_t block_count = 0;
+  char *src_buffer = read_comp_data(size);
+  ObAdaptiveCompressor *comp = dynamic_cast<ObAdaptiveCompressor*>(create_compressor("adaptive_1.0"));
+  ObCompressor *decomp = create_compressor("adaptive_1.0");
+  EXPECT_TRUE(NULL != comp);
+  EXPECT_TRUE(NULL != decomp);
+  if (NULL != comp && NULL != decomp)
+  {
+    char *comp_buffer = new char[size + comp->get_max_overflow_size(size)];
+    char *decomp_buffer = new char[size];
+    int64_t ret_size = 0;
+    for (int64_t i = 0; i < ObAdaptiveCompressor::SAMPLE_INTERVAL + 1; ++i)
+    {
+      EXPECT_EQ(ObCompressor::COM_E_NOERROR, comp->compress(src_buffer, size, comp_buffer,
+                                                            size + comp->get_max_overflow_size(size), ret_size));
+      // the codec id in the first byte tells how to decompress
+      if (ret_size < size)
+      {
+        EXPECT_EQ(ObCompressor::COM_E_NOERROR, decomp->decompress(comp_buffer, ret_size, decomp_buffer, size, ret_size));
+        EXPECT_EQ(size, ret_size);
+        EXPECT_EQ(0, memcmp(decomp_buffer, src_buffer, size));
+      }
+    }
+    for (int64_t i = 0; i < ObAdaptiveCompressor::CODEC_COUNT; ++i)
+    {
+      block_count += comp->get_block_count(i);
+    }
+    EXPECT_EQ(ObAdaptiveCompressor::SAMPLE_INTERVAL + 1, block_count);
+
+    // well compressed data is never stored as is, the first block is sampled
+    int64_t repeat_size = 64 * 1024;
+    char *repeat_buffer = new char[repeat_size];
+    char *repeat_comp_buffer = new char[repeat_size + decomp->get_max_overflow_size(repeat_size)];
+    for (int64_t i = 0; i < repeat_size; ++i)
+    {
+      repeat_buffer[i] = static_cast<char>('a' + i % 7);
+    }
+    EXPECT_EQ(ObCompressor::COM_E_NOERROR, decomp->compress(repeat_buffer, repeat_size, repeat_comp_buffer,
+                                                            repeat_size + decomp->get_max_overflow_size(repeat_size), ret_size));
+    EXPECT_GT(repeat_size, ret_size);
+    EXPECT_NE(ObAdaptiveCompressor::CODEC_NONE, repeat_comp_buffer[0]);
+    delete[] repeat_comp_buffer;
+    delete[] repeat_buffer;
+
+    comp_buffer[0] = ObAdaptiveCompressor::CODEC_COUNT;
+    EXPECT_EQ(ObCompressor::COM_E_DATAERROR, decomp->decompress(comp_buffer, ret_size, decomp_buffer, size, ret_size));
+    EXPECT_EQ(0, strcmp("adaptive_1.0", comp->get_compressor_name()));
+    delete[] decomp_buffer;
+    delete[] comp_buffer;
+  }
+  destroy_compressor(comp);
+  destroy_compressor(decomp);
+  delete[] src_buffer;
+}
+
+TEST(TestLibcomp, compress_adaptive_param)
+{
+  int64_t repeat_size = 64 * 1024;
+  int64_t ret_size = 0;
+  char *repeat_buffer = new char[repeat_size];
+  for (int64_t i = 0; i < repeat_size; ++i)
+  {
+    repeat_buffer[i] = static_cast<char>('a' + i % 7);
+  }
+
+  EXPECT_TRUE(NULL == create_compressor("adaptive_1.0,"));
+  EXPECT_TRUE(NULL == create_compressor("adaptive_1.0,10"));
+  EXPECT_TRUE(NULL == create_compressor("adaptive_1.0,10,200,"));
+  EXPECT_TRUE(NULL == create_compressor("adaptive_1.0,-1,200"));
+  EXPECT_TRUE(NULL == create_compressor("adaptive_1.0,10,x"));
+  EXPECT_FALSE(ObAdaptiveCompressor::is_adaptive("adaptive_1.00"));
+
+  int64_t default_slack_percent = ObAdaptiveCompressor::DEFAULT_MAX_SIZE_SLACK_PERCENT;
+  int64_t default_decompress_speed = ObAdaptiveCompressor::DEFAULT_MIN_DECOMPRESS_SPEED;
+  ObAdaptiveCompressor *comp = dynamic_cast<ObAdaptiveCompressor*>(create_compressor("adaptive_1.0"));
+  ASSERT_TRUE(NULL != comp);
+  EXPECT_EQ(default_slack_percent, comp->get_max_size_slack_percent());
+  EXPECT_EQ(default_decompress_speed, comp->get_min_decompress_speed());
+  destroy_compressor(comp);
+
+  // any size is acceptable, not compressing is the fastest
+  comp = dynamic_cast<ObAdaptiveCompressor*>(create_compressor("adaptive_1.0,1000000,0"));
+  ASSERT_TRUE(NULL != comp);
+  EXPECT_EQ(1000000, comp->get_max_size_slack_percent());
+  EXPECT_EQ(0, comp->get_min_decompress_speed());
+  EXPECT_EQ(0, strcmp("adaptive_1.0,1000000,0", comp->get_compressor_name()));
+  char *comp_buffer = new char[repeat_size + comp->get_max_overflow_size(repeat_size)];
+  EXPECT_EQ(ObCompressor::COM_E_NOERROR, comp->compress(repeat_buffer, repeat_size, comp_buffer,
+                                                        repeat_size + comp->get_max_overflow_size(repeat_size), ret_size));
+  EXPECT_EQ(repeat_size, ret_size);
+  EXPECT_EQ(1, comp->get_block_count(ObAdaptiveCompressor::CODEC_NONE));
+  delete[] comp_buffer;
+  destroy_compressor(comp);
+
+  // no codec decompresses fast enough
+  comp = dynamic_cast<ObAdaptiveCompressor*>(create_compressor("adaptive_1.0,10,1000000000"));
+  ASSERT_TRUE(NULL != comp);
+  comp_buffer = new char[repeat_size + comp->get_max_overflow_size(repeat_size)];
+  EXPECT_EQ(ObCompressor::COM_E_NOERROR, comp->compress(repeat_buffer, repeat_size, comp_buffer,
+                                                        repeat_size + comp->get_max_overflow_size(repeat_size), ret_size));
+  EXPECT_EQ(repeat_size, ret_size);
+  delete[] comp_buffer;
+  destroy_compressor(comp);
+
+  // only the compress ratio counts, blocks written with any thresholds
+  // are readable by the default one
+  comp = dynamic_cast<ObAdaptiveCompressor*>(create_compressor("adaptive_1.0,0,0"));
+  ObCompressor *decomp = create_compressor("adaptive_1.0");
+  ASSERT_TRUE(NULL != comp);
+  ASSERT_TRUE(NULL != decomp);
+  comp_buffer = new char[repeat_size + comp->get_max_overflow_size(repeat_size)];
+  char *decomp_buffer = new char[repeat_size];
+  EXPECT_EQ(ObCompressor::COM_E_NOERROR, comp->compress(repeat_buffer, repeat_size, comp_buffer,
+                                                        repeat_size + comp->get_max_overflow_size(repeat_size), ret_size));
+  EXPECT_GT(repeat_size, ret_size);
+  EXPECT_NE(ObAdaptiveCompressor::CODEC_NONE, comp_buffer[0]);
+  EXPECT_EQ(ObCompressor::COM_E_NOERROR, decomp->decompress(comp_buffer, ret_size, decomp_buffer, repeat_size, ret_size));
+  EXPECT_EQ(repeat_size, ret_size);
+  EXPECT_EQ(0, memcmp(decomp_buffer, repeat_buffer, repeat_size));
+  delete[] decomp_buffer;
+  delete[] comp_buffer;
+  destroy_compressor(comp);
+  destroy_compressor(decomp);
+  delete[] repeat_buffer;
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc,argv);
@@ -0,0 +1,144 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "ob_malloc.h"
+#include "ob_disk_io_engine.h"
+
+using namespace oceanbase::common;
+
+namespace oceanbase
+{
+  namespace tests
+  {
+    namespace common
+    {
+      static const char* TEST_FILE = "test_disk_io_engine.data";
+      static const int64_t TEST_FILE_SIZE = 64 * 1024;
+
+      class CountCallback : public ObDiskIOCallback
+      {
+        public:
+          CountCallback() : count_(0), err_(OB_SUCCESS), offset_(0), size_(0) {}
+          virtual void on_io_complete(const int err, const char *buf, const int64_t size)
+          {
+            if (OB_SUCCESS != err)
+            {
+              err_ = err;
+            }
+            else
+            {
+              for (int64_t i = 0; i < size; i++)
+              {
+                if (buf[i] != (char)((offset_ + i) % 251))
+                {
+                  err_ = OB_CHECKSUM_ERROR;
+                  break;
+                }
+              }
+            }
+            __sync_add_and_fetch(&count_, 1);
+          }
+          volatile int64_t count_;
+          int err_;
+          int64_t offset_;
+          int64_t size_;
+      };
+
+      class TestDiskIOEngine : public ::testing::Test
+      {
+        public:
+          virtual void SetUp()
+          {
+            char buf[TEST_FILE_SIZE];
+            for (int64_t i = 0; i < TEST_FILE_SIZE; i++)
+            {
+              buf[i] = (char)(i % 251);
+            }
+            fd_ = open(TEST_FILE, O_RDWR | O_CREAT | O_TRUNC, 0644);
+            ASSERT_TRUE(fd_ >= 0);
+            ASSERT_EQ(TEST_FILE_SIZE, write(fd_, buf, TEST_FILE_SIZE));
+          }
+          virtual void TearDown()
+          {
+            close(fd_);
+            unlink(TEST_FILE);
+          }
+          int fd_;
+      };
+
+      TEST_F(TestDiskIOEngine, init)
+      {
+        ObDiskIOEngine engine;
+        int32_t disk_no_array[] = {1, 3};
+        EXPECT_EQ(OB_INVALID_ARGUMENT, engine.init(NULL, 2, 8));
+        EXPECT_EQ(OB_INVALID_ARGUMENT, engine.init(disk_no_array, 2, 0));
+        EXPECT_EQ(OB_SUCCESS, engine.init(disk_no_array, 2, 8));
+        EXPECT_EQ(OB_INIT_TWICE, engine.init(disk_no_array, 2, 8));
+        EXPECT_TRUE(engine.has_disk(1));
+        EXPECT_FALSE(engine.has_disk(2));
+        EXPECT_TRUE(engine.has_disk(3));
+        engine.destroy();
+        EXPECT_FALSE(engine.has_disk(1));
+      }
+
+      TEST_F(TestDiskIOEngine, read)
+      {
+        ObDiskIOEngine engine;
+        int32_t disk_no_array[] = {1};
+        char buf[TEST_FILE_SIZE];
+        ASSERT_EQ(OB_SUCCESS, engine.init(disk_no_array, 1, 4));
+        // not aligned
+        ASSERT_EQ(OB_SUCCESS, engine.read(1, fd_, 100, 5000, buf, DISK_IO_PRIORITY_GET));
+        for (int64_t i = 0; i < 5000; i++)
+        {
+          ASSERT_EQ((char)((100 + i) % 251), buf[i]);
+        }
+        // tail of file
+        ASSERT_EQ(OB_SUCCESS, engine.read(1, fd_, TEST_FILE_SIZE - 10, 10, buf, DISK_IO_PRIORITY_SCAN));
+        ASSERT_EQ((char)((TEST_FILE_SIZE - 1) % 251), buf[9]);
+        // beyond end of file
+        EXPECT_EQ(OB_IO_ERROR, engine.read(1, fd_, TEST_FILE_SIZE - 10, 20, buf, DISK_IO_PRIORITY_GET));
+        EXPECT_EQ(OB_ENTRY_NOT_EXIST, engine.read(2, fd_, 0, 10, buf, DISK_IO_PRIORITY_GET));
+        engine.destroy();
+      }
+
+      TEST_F(TestDiskIOEngine, submit)
+      {
+        static const int64_t REQUEST_NUM = 64;
+        ObDiskIOEngine engine;
+        int32_t disk_no_array[] = {1};
+        ObDiskIORequest requests[REQUEST_NUM];
+        CountCallback callbacks[REQUEST_NUM];
+        ASSERT_EQ(OB_SUCCESS, engine.init(disk_no_array, 1, 2));
+        for (int64_t i = 0; i < REQUEST_NUM; i++)
+        {
+          // adjacent and overlapped requests, some of them are merged
+          callbacks[i].offset_ = i * 512;
+          requests[i].fd = fd_;
+          requests[i].offset = i * 512;
+          requests[i].size = 1024;
+          requests[i].priority = static_cast<int>(i % DISK_IO_PRIORITY_NUM);
+          requests[i].callback = &callbacks[i];
+          ASSERT_EQ(OB_SUCCESS, engine.submit(1, requests[i]));
+        }
+        for (int64_t i = 0; i < REQUEST_NUM; i++)
+        {
+          while (0 == callbacks[i].count_)
+          {
+            usleep(1000);
+          }
+          EXPECT_EQ(1, callbacks[i].count_);
+          EXPECT_EQ(OB_SUCCESS, callbacks[i].err_);
+        }
+        engine.destroy();
+      }
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
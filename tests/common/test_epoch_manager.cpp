@@ -0,0 +1,112 @@
+#include <pthread.h>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "ob_malloc.h"
+#include "ob_epoch_manager.h"
+
+using namespace oceanbase::common;
+
+namespace oceanbase
+{
+  namespace tests
+  {
+    namespace common
+    {
+      struct ReaderArg
+      {
+        ObEpochManager* manager_;
+        volatile int64_t* shared_;
+        volatile bool entered_;
+        volatile bool left_;
+        int64_t value_;
+      };
+
+      void* reader_routine(void* arg)
+      {
+        ReaderArg* reader = reinterpret_cast<ReaderArg*>(arg);
+        reader->manager_->enter();
+        reader->value_ = *reader->shared_;
+        reader->entered_ = true;
+        usleep(100000);
+        // value must not be reclaimed before leave
+        reader->value_ = *reader->shared_;
+        reader->left_ = true;
+        reader->manager_->leave();
+        return NULL;
+      }
+
+      void* slot_routine(void* arg)
+      {
+        ObEpochManager* manager = reinterpret_cast<ObEpochManager*>(arg);
+        ObEpochManager::Guard guard(*manager);
+        return reinterpret_cast<void*>(ObEpochManager::get_thread_idx());
+      }
+
+      TEST(TestEpochManager, nested)
+      {
+        ObEpochManager manager;
+        int64_t epoch = manager.get_epoch();
+        manager.enter();
+        manager.enter();
+        manager.leave();
+        manager.leave();
+        // no reader, return immediately
+        manager.synchronize();
+        EXPECT_EQ(epoch + 1, manager.get_epoch());
+        {
+          ObEpochManager::Guard guard(manager);
+        }
+        manager.synchronize();
+        EXPECT_EQ(epoch + 2, manager.get_epoch());
+      }
+
+      TEST(TestEpochManager, synchronize)
+      {
+        ObEpochManager manager;
+        volatile int64_t value = 1;
+        pthread_t thread;
+        ReaderArg arg;
+        arg.manager_ = &manager;
+        arg.shared_ = &value;
+        arg.entered_ = false;
+        arg.left_ = false;
+        arg.value_ = 0;
+
+        ASSERT_EQ(0, pthread_create(&thread, NULL, reader_routine, &arg));
+        while (!arg.entered_)
+        {
+          usleep(1000);
+        }
+        manager.synchronize();
+        // reader entered before synchronize, so it must have left.
+        EXPECT_TRUE(arg.left_);
+        EXPECT_EQ(1, arg.value_);
+        value = 0;
+        pthread_join(thread, NULL);
+      }
+
+      TEST(TestEpochManager, reuse_slot)
+      {
+        ObEpochManager manager;
+        pthread_t thread;
+        void* idx = NULL;
+        int64_t max_thread_num = ObEpochManager::MAX_THREAD_NUM;
+        // slots of exited threads are reused, never run out of them.
+        for (int64_t i = 0; i < 2 * max_thread_num; ++i)
+        {
+          ASSERT_EQ(0, pthread_create(&thread, NULL, slot_routine, &manager));
+          ASSERT_EQ(0, pthread_join(thread, &idx));
+          ASSERT_GT(max_thread_num, reinterpret_cast<int64_t>(idx));
+        }
+        manager.synchronize();
+      }
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
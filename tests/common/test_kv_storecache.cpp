@@ -0,0 +1,185 @@
+#include "ob_kv_storecache.h"
+#include "ob_malloc.h"
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace common;
+
+struct TestValue
+{
+  int64_t key;
+  char buf[1000];
+};
+
+static const int64_t ITEM_SIZE = 1024;
+static const int64_t BLOCK_SIZE = 64 * 1024;
+typedef KeyValueCache<int64_t, TestValue, ITEM_SIZE, BLOCK_SIZE> TestCache;
+// MemBlock::MEM_BLOCK_SIZE比BLOCK_SIZE稍大, 按BLOCK_SIZE算每个memblock能放下的个数偏多,
+// 所以用ITEM_PER_BLOCK个kv一定能写满至少一个memblock
+static const int64_t ITEM_PER_BLOCK = BLOCK_SIZE / ITEM_SIZE;
+static const int64_t CACHE_BLOCK_NUM = 40;
+static const int64_t CACHE_SIZE = CACHE_BLOCK_NUM * BLOCK_SIZE;
+
+static int put(TestCache &cache, const int64_t key, const bool probation)
+{
+  TestValue value;
+  value.key = key;
+  memset(value.buf, 0, sizeof(value.buf));
+  return cache.put(key, value, true, probation);
+}
+
+static int get(TestCache &cache, const int64_t key, const bool probation)
+{
+  TestValue value;
+  CacheHandle handle;
+  int ret = cache.get(key, value, handle, true, probation);
+  if (OB_SUCCESS == ret)
+  {
+    ret = (key == value.key) ? OB_SUCCESS : OB_ERROR;
+    cache.revert(handle);
+  }
+  return ret;
+}
+
+TEST(TestKVStoreCache, set_replace_policy)
+{
+  TestCache cache;
+  EXPECT_EQ(OB_SUCCESS, cache.init(CACHE_SIZE));
+  EXPECT_EQ(OB_INVALID_ARGUMENT, cache.set_replace_policy(KVStoreCacheComponent::TWO_Q_POLICY, 0));
+  EXPECT_EQ(OB_INVALID_ARGUMENT, cache.set_replace_policy(KVStoreCacheComponent::TWO_Q_POLICY, 100));
+  EXPECT_EQ(OB_SUCCESS, cache.set_replace_policy(KVStoreCacheComponent::TWO_Q_POLICY, 25));
+  EXPECT_EQ(OB_SUCCESS, cache.set_replace_policy(KVStoreCacheComponent::LRU_POLICY, 25));
+  EXPECT_EQ(OB_SUCCESS, cache.destroy());
+}
+
+TEST(TestKVStoreCache, promote)
+{
+  TestCache cache;
+  ASSERT_EQ(OB_SUCCESS, cache.init(CACHE_SIZE));
+  ASSERT_EQ(OB_SUCCESS, cache.set_replace_policy(KVStoreCacheComponent::TWO_Q_POLICY, 25));
+
+  // 写满两个probation memblock, 前两个memblock提交后进入A1in
+  for (int64_t i = 0; i < 3 * ITEM_PER_BLOCK; i++)
+  {
+    ASSERT_EQ(OB_SUCCESS, put(cache, i, true));
+  }
+  int64_t probation_size = cache.get_probation_size();
+  int64_t probation_hit_cnt = cache.get_probation_hit_cnt();
+  int64_t protected_hit_cnt = cache.get_protected_hit_cnt();
+  EXPECT_LE(2 * BLOCK_SIZE, probation_size);
+  EXPECT_EQ(0, cache.get_promote_cnt());
+
+  // scan的访问不会提升
+  ASSERT_EQ(OB_SUCCESS, get(cache, 0, true));
+  EXPECT_EQ(0, cache.get_promote_cnt());
+  EXPECT_EQ(probation_size, cache.get_probation_size());
+  EXPECT_EQ(probation_hit_cnt + 1, cache.get_probation_hit_cnt());
+
+  // 点查命中后整个memblock提升到Am
+  ASSERT_EQ(OB_SUCCESS, get(cache, 0, false));
+  EXPECT_EQ(1, cache.get_promote_cnt());
+  EXPECT_GT(probation_size, cache.get_probation_size());
+  probation_size = cache.get_probation_size();
+
+  // 同一个memblock中的其他kv已经是protected, 不会重复提升
+  ASSERT_EQ(OB_SUCCESS, get(cache, 1, false));
+  EXPECT_EQ(1, cache.get_promote_cnt());
+  EXPECT_EQ(probation_size, cache.get_probation_size());
+  EXPECT_EQ(protected_hit_cnt + 1, cache.get_protected_hit_cnt());
+
+  // 没有probation标记写入的kv不进入A1in
+  for (int64_t i = 0; i < 2 * ITEM_PER_BLOCK; i++)
+  {
+    ASSERT_EQ(OB_SUCCESS, put(cache, 10000 + i, false));
+  }
+  EXPECT_EQ(probation_size, cache.get_probation_size());
+  EXPECT_EQ(OB_SUCCESS, cache.destroy());
+}
+
+TEST(TestKVStoreCache, lru_ignore_probation)
+{
+  TestCache cache;
+  ASSERT_EQ(OB_SUCCESS, cache.init(CACHE_SIZE));
+  for (int64_t i = 0; i < 3 * ITEM_PER_BLOCK; i++)
+  {
+    ASSERT_EQ(OB_SUCCESS, put(cache, i, true));
+  }
+  EXPECT_EQ(0, cache.get_probation_size());
+  ASSERT_EQ(OB_SUCCESS, get(cache, 0, false));
+  EXPECT_EQ(0, cache.get_promote_cnt());
+  EXPECT_EQ(OB_SUCCESS, cache.destroy());
+}
+
+// 先写入热点数据并点查, 然后scan写入cache总量3倍的数据, 返回scan后还在cache中的热点数据个数
+static int64_t scan_pollution(const KVStoreCacheComponent::ReplacePolicy policy,
+                              const int64_t hot_num, const int64_t scan_num,
+                              int64_t &promoted_key, bool &promoted_hit,
+                              bool &first_scan_key_hit, bool &last_scan_key_hit)
+{
+  TestCache cache;
+  int64_t hot_hit = 0;
+  EXPECT_EQ(OB_SUCCESS, cache.init(CACHE_SIZE));
+  EXPECT_EQ(OB_SUCCESS, cache.set_replace_policy(policy, 25));
+  for (int64_t i = 0; i < hot_num; i++)
+  {
+    EXPECT_EQ(OB_SUCCESS, put(cache, i, false));
+  }
+  for (int64_t i = 0; i < hot_num; i++)
+  {
+    EXPECT_EQ(OB_SUCCESS, get(cache, i, false));
+  }
+  const int64_t scan_start = hot_num;
+  promoted_key = scan_start + scan_num / 2;
+  for (int64_t i = scan_start; i < scan_start + scan_num; i++)
+  {
+    EXPECT_EQ(OB_SUCCESS, put(cache, i, true));
+    // scan中途被点查到的数据所在的memblock提升为protected
+    if (promoted_key + 2 * ITEM_PER_BLOCK == i)
+    {
+      EXPECT_EQ(OB_SUCCESS, get(cache, promoted_key, false));
+    }
+  }
+  promoted_hit = (OB_SUCCESS == get(cache, promoted_key, true));
+  first_scan_key_hit = (OB_SUCCESS == get(cache, scan_start, true));
+  last_scan_key_hit = (OB_SUCCESS == get(cache, scan_start + scan_num - 1, true));
+  for (int64_t i = 0; i < hot_num; i++)
+  {
+    if (OB_SUCCESS == get(cache, i, true))
+    {
+      hot_hit++;
+    }
+  }
+  EXPECT_EQ(OB_SUCCESS, cache.destroy());
+  return hot_hit;
+}
+
+TEST(TestKVStoreCache, scan_pollution)
+{
+  // 热点数据约占cache的20%, 小于probation memblock的淘汰门限
+  const int64_t hot_num = CACHE_BLOCK_NUM / 5 * ITEM_PER_BLOCK;
+  const int64_t scan_num = 3 * CACHE_BLOCK_NUM * ITEM_PER_BLOCK;
+  int64_t promoted_key = 0;
+  bool promoted_hit = false;
+  bool first_scan_key_hit = false;
+  bool last_scan_key_hit = false;
+
+  // 2Q下A1in超过门限后先淘汰, 而且按访问时间从旧到新淘汰, 热点数据和被点查过的数据都保留
+  EXPECT_EQ(hot_num, scan_pollution(KVStoreCacheComponent::TWO_Q_POLICY, hot_num, scan_num,
+                                    promoted_key, promoted_hit, first_scan_key_hit, last_scan_key_hit));
+  EXPECT_TRUE(promoted_hit);
+  EXPECT_FALSE(first_scan_key_hit);
+  EXPECT_TRUE(last_scan_key_hit);
+
+  // LRU下热点数据被scan冲掉
+  EXPECT_EQ(0, scan_pollution(KVStoreCacheComponent::LRU_POLICY, hot_num, scan_num,
+                              promoted_key, promoted_hit, first_scan_key_hit, last_scan_key_hit));
+  EXPECT_FALSE(first_scan_key_hit);
+  EXPECT_TRUE(last_scan_key_hit);
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,6 +1,7 @@
 #include "gtest/gtest.h"
 #include "common/ob_malloc.h"
 #include "common/ob_log_generator.h"
+#include "common/ob_log_compressor.h"
 #include "common/utility.h"
 #include "../updateserver/rwt.h"
 
@@ -171,6 +172,99 @@ namespace oceanbase
       BaseWorker worker;
       ASSERT_EQ(0, PARDO(get_thread_num(), this, duration));
     }
+
+    // 按(字节, 重复次数)编码的简单压缩, 只用于测试
+    class RLECompressor : public ObCompressor
+    {
+      public:
+        int compress(const char *src_buffer, const int64_t src_data_size,
+                     char *dst_buffer, const int64_t dst_buffer_size, int64_t &dst_data_size)
+        {
+          dst_data_size = 0;
+          for (int64_t i = 0; i < src_data_size; )
+          {
+            int64_t n = 1;
+            while (i + n < src_data_size && n < 255 && src_buffer[i + n] == src_buffer[i])
+            {
+              n++;
+            }
+            if (dst_data_size + 2 > dst_buffer_size)
+            {
+              return COM_E_OVERFLOW;
+            }
+            dst_buffer[dst_data_size++] = src_buffer[i];
+            dst_buffer[dst_data_size++] = (char)n;
+            i += n;
+          }
+          return COM_E_NOERROR;
+        }
+        int decompress(const char *src_buffer, const int64_t src_data_size,
+                       char *dst_buffer, const int64_t dst_buffer_size, int64_t &dst_data_size)
+        {
+          dst_data_size = 0;
+          for (int64_t i = 0; i + 1 < src_data_size; i += 2)
+          {
+            int64_t n = (uint8_t)src_buffer[i + 1];
+            if (dst_data_size + n > dst_buffer_size)
+            {
+              return COM_E_OVERFLOW;
+            }
+            memset(dst_buffer + dst_data_size, src_buffer[i], n);
+            dst_data_size += n;
+          }
+          return COM_E_NOERROR;
+        }
+        const char *get_compressor_name() const
+        {
+          return "rle";
+        }
+    };
+
+    TEST_F(ObLogGeneratorTest, CompressLog){
+      static RLECompressor rle_compressor;
+      ObLogCompressor &log_compressor = ObLogCompressor::get_instance();
+      if (!log_compressor.is_registered(ObLogCompressor::LZO))
+      {
+        ASSERT_EQ(OB_SUCCESS, log_compressor.register_compressor(ObLogCompressor::LZO, &rle_compressor));
+      }
+      char big_log[4096];
+      char small_log[64];
+      memset(big_log, 'a', sizeof(big_log));
+      memset(small_log, 'b', sizeof(small_log));
+      log_generator.set_compress_type(ObLogCompressor::LZO);
+      ASSERT_EQ(OB_SUCCESS, log_generator.write_log(OB_LOG_UPS_MUTATOR, big_log, sizeof(big_log)));
+      ASSERT_EQ(OB_SUCCESS, log_generator.write_log(OB_LOG_UPS_MUTATOR, small_log, sizeof(small_log)));
+
+      ObLogCursor start_cursor;
+      ObLogCursor end_cursor;
+      char* buf = NULL;
+      int64_t len = 0;
+      ASSERT_EQ(OB_SUCCESS, log_generator.get_log(start_cursor, end_cursor, buf, len));
+      ASSERT_EQ(OB_SUCCESS, consume_log(buf, len));
+      ASSERT_EQ(end_cursor.log_id_, consumed_cursor.log_id_);
+      ASSERT_EQ(end_cursor.offset_, consumed_cursor.offset_);
+
+      ObLogEntry entry;
+      int64_t pos = 0;
+      const char* log_data = NULL;
+      int64_t data_len = 0;
+      ASSERT_EQ(OB_SUCCESS, entry.deserialize(buf, len, pos));
+      ASSERT_TRUE(entry.is_compressed());
+      ASSERT_GT((int64_t)sizeof(big_log), (int64_t)entry.get_log_data_len());
+      ASSERT_EQ(OB_SUCCESS, get_log_data(entry, buf + pos, log_data, data_len));
+      ASSERT_EQ((int64_t)sizeof(big_log), data_len);
+      ASSERT_EQ(0, memcmp(big_log, log_data, data_len));
+      pos += entry.get_log_data_len();
+
+      // 太小的日志不压缩
+      ASSERT_EQ(OB_SUCCESS, entry.deserialize(buf, len, pos));
+      ASSERT_FALSE(entry.is_compressed());
+      ASSERT_EQ(OB_SUCCESS, get_log_data(entry, buf + pos, log_data, data_len));
+      ASSERT_EQ(buf + pos, log_data);
+      ASSERT_EQ((int64_t)sizeof(small_log), data_len);
+      ASSERT_EQ(OB_SUCCESS, log_generator.commit(end_cursor));
+      log_generator.set_compress_type(ObLogCompressor::NONE);
+    }
   }
 }
 using namespace oceanbase::test;
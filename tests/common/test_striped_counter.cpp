@@ -0,0 +1,99 @@
+#include <pthread.h>
+#include "common/ob_malloc.h"
+#include "common/ob_simple_tpl.h"
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace common;
+
+static const int64_t ADD_COUNT = 100000;
+// 线程数多于STRIPE_NUM, 有些stripe被多个线程共享
+static const int64_t THREAD_NUM = ObStripedCounter::STRIPE_NUM + 8;
+
+struct AddArg
+{
+  ObStripedCounter* counter_;
+  int64_t delta_;
+  volatile int64_t* started_;
+};
+
+static void* add_thread(void* arg)
+{
+  AddArg* add_arg = (AddArg*)arg;
+  __sync_fetch_and_add(add_arg->started_, 1);
+  for (int64_t i = 0; i < ADD_COUNT; i++)
+  {
+    add_arg->counter_->add(add_arg->delta_);
+  }
+  return NULL;
+}
+
+TEST(TestStripedCounter, single_thread)
+{
+  ObStripedCounter counter;
+  EXPECT_EQ(0, counter.value());
+  counter.add(10);
+  counter.add(-3);
+  EXPECT_EQ(7, counter.value());
+  counter.reset();
+  EXPECT_EQ(0, counter.value());
+}
+
+TEST(TestStripedCounter, multi_thread_add)
+{
+  ObStripedCounter counter;
+  pthread_t threads[THREAD_NUM];
+  AddArg args[THREAD_NUM];
+  volatile int64_t started = 0;
+  int64_t expected = 0;
+  for (int64_t i = 0; i < THREAD_NUM; i++)
+  {
+    args[i].counter_ = &counter;
+    args[i].delta_ = i + 1;
+    args[i].started_ = &started;
+    expected += (i + 1) * ADD_COUNT;
+    ASSERT_EQ(0, pthread_create(threads + i, NULL, add_thread, args + i));
+  }
+  // 只加正数, 并发读到的和不会变小也不会超过最终结果
+  int64_t last_value = 0;
+  while (started < THREAD_NUM || last_value < expected)
+  {
+    int64_t value = counter.value();
+    ASSERT_LE(last_value, value);
+    ASSERT_GE(expected, value);
+    last_value = value;
+  }
+  for (int64_t i = 0; i < THREAD_NUM; i++)
+  {
+    pthread_join(threads[i], NULL);
+  }
+  EXPECT_EQ(expected, counter.value());
+}
+
+TEST(TestStripedCounter, multi_thread_inc_dec)
+{
+  // 分配和释放在不同线程中, 只有求和是准确的
+  ObStripedCounter counter;
+  pthread_t threads[THREAD_NUM];
+  AddArg args[THREAD_NUM];
+  volatile int64_t started = 0;
+  for (int64_t i = 0; i < THREAD_NUM; i++)
+  {
+    args[i].counter_ = &counter;
+    args[i].delta_ = (0 == i % 2) ? 1024 : -1024;
+    args[i].started_ = &started;
+    ASSERT_EQ(0, pthread_create(threads + i, NULL, add_thread, args + i));
+  }
+  for (int64_t i = 0; i < THREAD_NUM; i++)
+  {
+    pthread_join(threads[i], NULL);
+  }
+  EXPECT_EQ(0, counter.value());
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
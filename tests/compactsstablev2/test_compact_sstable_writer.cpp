@@ -751,7 +751,9 @@ public:
     //ASSERT_EQ(total_len * row_count + sizeof(ObSSTableBlockHeader),
     //    block_header_ptr->row_index_offset_);
     ASSERT_EQ(row_count, block_header_ptr->row_count_);
-    ASSERT_EQ(0, block_header_ptr->reserved64_);
+    ASSERT_EQ(OB_SSTABLE_BLOCK_FORMAT_ROW, block_header_ptr->block_format_);
+    ASSERT_EQ(0, block_header_ptr->reserved16_);
+    ASSERT_EQ(0, block_header_ptr->reserved32_);
     pos += sizeof(ObSSTableBlockHeader);
 
     int row_flag = 0;
@@ -1200,7 +1202,9 @@ public:
 
         int64_t pos = 0;
         block_header_ptr = (ObSSTableBlockHeader*)uncomp_buf;
-        ASSERT_EQ(0, block_header_ptr->reserved64_);
+        ASSERT_EQ(OB_SSTABLE_BLOCK_FORMAT_ROW, block_header_ptr->block_format_);
+        ASSERT_EQ(0, block_header_ptr->reserved16_);
+        ASSERT_EQ(0, block_header_ptr->reserved32_);
         pos = sizeof(ObSSTableBlockHeader);
         for (int64_t k = 0; k < block_header_ptr->row_count_; k ++)
         {
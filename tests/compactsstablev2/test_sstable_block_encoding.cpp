@@ -0,0 +1,292 @@
+#include "gtest/gtest.h"
+#include "common/ob_define.h"
+#include "common/ob_row.h"
+#include "common/ob_row_desc.h"
+#include "compactsstablev2/ob_sstable_block_builder.h"
+#include "compactsstablev2/ob_sstable_block_reader.h"
+#include "compactsstablev2/ob_sstable_block_encoding.h"
+
+using namespace oceanbase;
+using namespace common;
+using namespace compactsstablev2;
+
+static const uint64_t TABLE_ID = 1001;
+static const int64_t ROW_COUNT = 100;
+static const int64_t COLUMN_COUNT = 5;
+
+class TestSSTableBlockEncoding : public ::testing::Test
+{
+public:
+  virtual void SetUp()
+  {
+    for (int64_t i = 0; i < COLUMN_COUNT; i ++)
+    {
+      ASSERT_EQ(OB_SUCCESS, row_desc_.add_column_desc(TABLE_ID, i + 16));
+    }
+    row_.set_row_desc(row_desc_);
+  }
+
+  virtual void TearDown()
+  {
+  }
+
+  /**
+   * rowkey: (varchar user_i, int i/10)
+   * rowvalue: int 1000+i(INT_FOR), varchar city_(i%5)(DICT),
+   *           int i/30(RLE or INT_FOR), varchar payload(PLAIN), null
+   */
+  void add_rows(ObSSTableBlockBuilder& builder)
+  {
+    char key_str[32];
+    char city_str[32];
+    char payload_str[64];
+    ObObj rowkey_objs[2];
+    ObRowkey rowkey;
+    ObObj obj;
+    ObString str;
+
+    for (int64_t i = 0; i < ROW_COUNT; i ++)
+    {
+      make_rowkey(i, key_str, sizeof(key_str), rowkey_objs, rowkey);
+
+      obj.set_int(1000 + i);
+      ASSERT_EQ(OB_SUCCESS, row_.raw_set_cell(0, obj));
+      snprintf(city_str, sizeof(city_str), "city_%ld", i % 5);
+      str.assign_ptr(city_str, static_cast<int32_t>(strlen(city_str)));
+      obj.set_varchar(str);
+      ASSERT_EQ(OB_SUCCESS, row_.raw_set_cell(1, obj));
+      obj.set_int(i / 30);
+      ASSERT_EQ(OB_SUCCESS, row_.raw_set_cell(2, obj));
+      snprintf(payload_str, sizeof(payload_str), "payload %ld %ld", i * 7919, i * 31);
+      str.assign_ptr(payload_str, static_cast<int32_t>(strlen(payload_str)));
+      obj.set_varchar(str);
+      ASSERT_EQ(OB_SUCCESS, row_.raw_set_cell(3, obj));
+      obj.set_null();
+      ASSERT_EQ(OB_SUCCESS, row_.raw_set_cell(4, obj));
+
+      ASSERT_EQ(OB_SUCCESS, builder.add_row(rowkey, row_));
+    }
+  }
+
+  void make_rowkey(const int64_t i, char* buf, const int64_t buf_len,
+      ObObj* objs, ObRowkey& rowkey)
+  {
+    ObString str;
+    snprintf(buf, buf_len, "user_%08ld", i);
+    str.assign_ptr(buf, static_cast<int32_t>(strlen(buf)));
+    objs[0].set_varchar(str);
+    objs[1].set_int(i / 10);
+    rowkey.assign(objs, 2);
+  }
+
+  void build_block(ObSSTableBlockBuilder& builder, const bool block_encoding,
+      char*& buf, int64_t& size)
+  {
+    builder.set_row_store_type(DENSE_DENSE);
+    builder.set_block_encoding(block_encoding);
+    add_rows(builder);
+    ASSERT_EQ(OB_SUCCESS, builder.build_block(buf, size));
+  }
+
+protected:
+  ObRowDesc row_desc_;
+  ObRow row_;
+  char index_buf_[(ROW_COUNT + 1) * sizeof(ObSSTableBlockReader::RowIndexItemType)];
+  char encoded_index_buf_[(ROW_COUNT + 1) * sizeof(ObSSTableBlockReader::RowIndexItemType)];
+};
+
+TEST_F(TestSSTableBlockEncoding, round_trip)
+{
+  ObSSTableBlockBuilder builder;
+  ObSSTableBlockBuilder encoded_builder;
+  ObSSTableBlockReader reader;
+  ObSSTableBlockReader encoded_reader;
+  char* buf = NULL;
+  int64_t size = 0;
+  char* encoded_buf = NULL;
+  int64_t encoded_size = 0;
+  sstable::ObSSTableRowCacheValue row;
+  sstable::ObSSTableRowCacheValue encoded_row;
+
+  build_block(builder, false, buf, size);
+  build_block(encoded_builder, true, encoded_buf, encoded_size);
+  EXPECT_LT(encoded_size, size);
+  EXPECT_EQ(OB_SSTABLE_BLOCK_FORMAT_ROW,
+      reinterpret_cast<ObSSTableBlockHeader*>(buf)->block_format_);
+  EXPECT_EQ(OB_SSTABLE_BLOCK_FORMAT_ENCODED,
+      reinterpret_cast<ObSSTableBlockHeader*>(encoded_buf)->block_format_);
+
+  ObSSTableBlockReader::BlockData data(index_buf_, sizeof(index_buf_), buf, size);
+  ObSSTableBlockReader::BlockData encoded_data(encoded_index_buf_,
+      sizeof(encoded_index_buf_), encoded_buf, encoded_size);
+  ASSERT_EQ(OB_SUCCESS, reader.init(data, DENSE_DENSE));
+  ASSERT_EQ(OB_SUCCESS, encoded_reader.init(encoded_data, DENSE_DENSE));
+  ASSERT_EQ(ROW_COUNT, encoded_reader.end_index() - encoded_reader.begin_index());
+
+  //sequential and random access rebuild the same rows
+  int64_t rows[] = {0, 1, 15, 16, 17, 99, 50, 3, 98};
+  for (int64_t i = 0; i < ROW_COUNT + 9; i ++)
+  {
+    int64_t row_num = i < ROW_COUNT ? i : rows[i - ROW_COUNT];
+    ASSERT_EQ(OB_SUCCESS, reader.get_cache_row_value(
+          reader.begin_index() + row_num, row));
+    ASSERT_EQ(OB_SUCCESS, encoded_reader.get_cache_row_value(
+          encoded_reader.begin_index() + row_num, encoded_row));
+    ASSERT_EQ(row.size_, encoded_row.size_);
+    EXPECT_EQ(0, memcmp(row.buf_, encoded_row.buf_, row.size_));
+  }
+}
+
+TEST_F(TestSSTableBlockEncoding, lower_bound)
+{
+  ObSSTableBlockBuilder builder;
+  ObSSTableBlockBuilder encoded_builder;
+  ObSSTableBlockReader reader;
+  ObSSTableBlockReader encoded_reader;
+  char* buf = NULL;
+  int64_t size = 0;
+  char* encoded_buf = NULL;
+  int64_t encoded_size = 0;
+  char key_str[32];
+  ObObj key_objs[2];
+  ObRowkey key;
+  ObRowkey find_key;
+
+  build_block(builder, false, buf, size);
+  build_block(encoded_builder, true, encoded_buf, encoded_size);
+  ObSSTableBlockReader::BlockData data(index_buf_, sizeof(index_buf_), buf, size);
+  ObSSTableBlockReader::BlockData encoded_data(encoded_index_buf_,
+      sizeof(encoded_index_buf_), encoded_buf, encoded_size);
+  ASSERT_EQ(OB_SUCCESS, reader.init(data, DENSE_DENSE));
+  ASSERT_EQ(OB_SUCCESS, encoded_reader.init(encoded_data, DENSE_DENSE));
+
+  for (int64_t i = 0; i < ROW_COUNT; i ++)
+  {
+    //the existing rowkey
+    make_rowkey(i, key_str, sizeof(key_str), key_objs, key);
+    ASSERT_EQ(i, encoded_reader.lower_bound(key) - encoded_reader.begin_index());
+    ASSERT_EQ(OB_SUCCESS, encoded_reader.get_row_key(encoded_reader.lower_bound(key),
+          find_key));
+    EXPECT_EQ(0, find_key.compare(key));
+
+    //between two rowkeys
+    key_objs[1].set_int(i / 10 + 1);
+    EXPECT_EQ(reader.lower_bound(key) - reader.begin_index(),
+        encoded_reader.lower_bound(key) - encoded_reader.begin_index());
+  }
+
+  //before the first and after the last rowkey
+  key.set_min_row();
+  EXPECT_EQ(encoded_reader.begin_index(), encoded_reader.lower_bound(key));
+  key.set_max_row();
+  EXPECT_EQ(encoded_reader.end_index(), encoded_reader.lower_bound(key));
+}
+
+TEST_F(TestSSTableBlockEncoding, project_columns)
+{
+  ObSSTableBlockBuilder builder;
+  ObSSTableBlockReader reader;
+  ObSSTableScanColumnIndexes scan_columns;
+  ObCompactCellIterator row;
+  char* buf = NULL;
+  int64_t size = 0;
+  ObObj obj;
+  bool is_row_finished = false;
+  int64_t value = 0;
+
+  build_block(builder, true, buf, size);
+  ASSERT_EQ(OB_SUCCESS, scan_columns.add_column_id(
+        ObSSTableScanColumnIndexes::Rowkey, 0, 1));
+  ASSERT_EQ(OB_SUCCESS, scan_columns.add_column_id(
+        ObSSTableScanColumnIndexes::Normal, 2, 18));
+  ObSSTableBlockReader::BlockData data(index_buf_, sizeof(index_buf_), buf, size);
+  ASSERT_EQ(OB_SUCCESS, reader.init(data, DENSE_DENSE, &scan_columns));
+  ASSERT_EQ(OB_SUCCESS, reader.get_row(reader.begin_index() + 42, row));
+
+  //rowkey
+  ASSERT_EQ(OB_SUCCESS, row.get_next_cell(obj, is_row_finished));
+  EXPECT_EQ(ObVarcharType, obj.get_type());
+  ASSERT_EQ(OB_SUCCESS, row.get_next_cell(obj, is_row_finished));
+  EXPECT_EQ(OB_SUCCESS, obj.get_int(value));
+  EXPECT_EQ(4, value);
+  ASSERT_EQ(OB_SUCCESS, row.get_next_cell(obj, is_row_finished));
+  EXPECT_TRUE(is_row_finished);
+
+  //the columns not scanned are null
+  ASSERT_EQ(OB_SUCCESS, row.get_next_cell(obj, is_row_finished));
+  EXPECT_EQ(ObNullType, obj.get_type());
+  ASSERT_EQ(OB_SUCCESS, row.get_next_cell(obj, is_row_finished));
+  EXPECT_EQ(ObNullType, obj.get_type());
+  ASSERT_EQ(OB_SUCCESS, row.get_next_cell(obj, is_row_finished));
+  EXPECT_EQ(OB_SUCCESS, obj.get_int(value));
+  EXPECT_EQ(1, value);
+  ASSERT_EQ(OB_SUCCESS, row.get_next_cell(obj, is_row_finished));
+  EXPECT_EQ(ObNullType, obj.get_type());
+  ASSERT_EQ(OB_SUCCESS, row.get_next_cell(obj, is_row_finished));
+  EXPECT_EQ(ObNullType, obj.get_type());
+  ASSERT_EQ(OB_SUCCESS, row.get_next_cell(obj, is_row_finished));
+  EXPECT_TRUE(is_row_finished);
+}
+
+TEST_F(TestSSTableBlockEncoding, choose_encoding)
+{
+  static char row_buf[64 * 1024];
+  ObSSTableBlockRowIndex row_index[ROW_COUNT + 1];
+  ObSSTableBlockEncoder encoder;
+  ObSSTableEncodedColumnMeta meta;
+  ObCompactCellWriter writer;
+  int64_t pos = sizeof(ObSSTableBlockHeader);
+  char* buf = NULL;
+  int64_t size = 0;
+  ObObj obj;
+
+  for (int64_t i = 0; i < ROW_COUNT; i ++)
+  {
+    ASSERT_EQ(OB_SUCCESS, writer.init(row_buf + pos, sizeof(row_buf) - pos, DENSE_DENSE));
+    obj.set_int(i);
+    ASSERT_EQ(OB_SUCCESS, writer.append(obj));
+    ASSERT_EQ(OB_SUCCESS, writer.rowkey_finish());
+    obj.set_int(i % 3 * 1000000);       //DICT
+    ASSERT_EQ(OB_SUCCESS, writer.append(obj));
+    obj.set_int(i < 90 ? 1 : 2);        //RLE
+    ASSERT_EQ(OB_SUCCESS, writer.append(obj));
+    obj.set_int(1000000 + i * 3);       //INT_FOR
+    ASSERT_EQ(OB_SUCCESS, writer.append(obj));
+    ASSERT_EQ(OB_SUCCESS, writer.row_finish());
+    row_index[i].row_offset_ = static_cast<int32_t>(pos);
+    pos += writer.size();
+  }
+  row_index[ROW_COUNT].row_offset_ = static_cast<int32_t>(pos);
+
+  ASSERT_EQ(OB_SUCCESS, encoder.encode(row_buf, row_index, ROW_COUNT, buf, size));
+  EXPECT_LT(size, pos);
+  ASSERT_EQ(3, encoder.column_count_);
+  ASSERT_EQ(OB_SUCCESS, encoder.choose_encoding(0, meta));
+  EXPECT_EQ(OB_COLUMN_ENCODING_DICT, meta.encoding_);
+  EXPECT_EQ(3, meta.param_);
+  ASSERT_EQ(OB_SUCCESS, encoder.choose_encoding(1, meta));
+  EXPECT_EQ(OB_COLUMN_ENCODING_RLE, meta.encoding_);
+  EXPECT_EQ(2, meta.param_);
+  ASSERT_EQ(OB_SUCCESS, encoder.choose_encoding(2, meta));
+  EXPECT_EQ(OB_COLUMN_ENCODING_INT_FOR, meta.encoding_);
+  EXPECT_EQ(9, meta.param_);
+
+  //rows with different column count are not encoded
+  pos = row_index[1].row_offset_;
+  ASSERT_EQ(OB_SUCCESS, writer.init(row_buf + pos, sizeof(row_buf) - pos, DENSE_DENSE));
+  obj.set_int(1);
+  ASSERT_EQ(OB_SUCCESS, writer.append(obj));
+  ASSERT_EQ(OB_SUCCESS, writer.rowkey_finish());
+  ASSERT_EQ(OB_SUCCESS, writer.append(obj));
+  ASSERT_EQ(OB_SUCCESS, writer.row_finish());
+  row_index[2].row_offset_ = static_cast<int32_t>(pos + writer.size());
+  EXPECT_EQ(OB_NOT_SUPPORTED, encoder.encode(row_buf, row_index, 2, buf, size));
+}
+
+int main(int argc, char** argv)
+{
+  ob_init_memory_pool();
+  TBSYS_LOGGER.setLogLevel("INFO");
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
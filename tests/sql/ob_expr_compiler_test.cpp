@@ -0,0 +1,513 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_expr_compiler_test.cpp
+ *
+ * Authors:
+ *   Zhifeng YANG <zhuweng.yzf@taobao.com>
+ *
+ */
+#include "sql/ob_postfix_expression.h"
+#include "common/ob_malloc.h"
+#include <gtest/gtest.h>
+using namespace oceanbase::common;
+using namespace oceanbase::sql;
+
+static const uint64_t TID = 1001;
+static const uint64_t C1 = 16;
+static const uint64_t C2 = 17;
+
+class ObExprCompilerTest: public ::testing::Test
+{
+  public:
+    ObExprCompilerTest();
+    virtual ~ObExprCompilerTest();
+    virtual void SetUp();
+    virtual void TearDown();
+  protected:
+    void add_column(ObPostfixExpression &p, const uint64_t cid);
+    void add_int(ObPostfixExpression &p, const int64_t v);
+    void add_str(ObPostfixExpression &p, const char *str);
+    void add_param(ObPostfixExpression &p, const ObObj &param);
+    void add_op(ObPostfixExpression &p, const ObItemType op, const int64_t count);
+    void set_row(const ObObj &c1, const ObObj &c2);
+    // calc the expression and check the result equals to expected
+    void check(ObPostfixExpression &p, const ObExprObj &expected);
+  protected:
+    ObRowDesc row_desc_;
+    ObRow row_;
+  private:
+    // disallow copy
+    ObExprCompilerTest(const ObExprCompilerTest &other);
+    ObExprCompilerTest& operator=(const ObExprCompilerTest &other);
+};
+
+ObExprCompilerTest::ObExprCompilerTest()
+{
+}
+
+ObExprCompilerTest::~ObExprCompilerTest()
+{
+}
+
+void ObExprCompilerTest::SetUp()
+{
+  row_desc_.reset();
+  ASSERT_EQ(OB_SUCCESS, row_desc_.add_column_desc(TID, C1));
+  ASSERT_EQ(OB_SUCCESS, row_desc_.add_column_desc(TID, C2));
+  row_.set_row_desc(row_desc_);
+}
+
+void ObExprCompilerTest::TearDown()
+{
+}
+
+void ObExprCompilerTest::add_column(ObPostfixExpression &p, const uint64_t cid)
+{
+  ExprItem item;
+  item.type_ = T_REF_COLUMN;
+  item.value_.cell_.tid = TID;
+  item.value_.cell_.cid = cid;
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(item));
+}
+
+void ObExprCompilerTest::add_int(ObPostfixExpression &p, const int64_t v)
+{
+  ExprItem item;
+  item.type_ = T_INT;
+  item.value_.int_ = v;
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(item));
+}
+
+void ObExprCompilerTest::add_str(ObPostfixExpression &p, const char *str)
+{
+  ExprItem item;
+  item.type_ = T_STRING;
+  item.string_ = ObString::make_string(str);
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(item));
+}
+
+void ObExprCompilerTest::add_param(ObPostfixExpression &p, const ObObj &param)
+{
+  ExprItem item;
+  item.type_ = T_QUESTIONMARK;
+  item.value_.int_ = reinterpret_cast<int64_t>(&param);
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(item));
+}
+
+void ObExprCompilerTest::add_op(ObPostfixExpression &p, const ObItemType op, const int64_t count)
+{
+  ExprItem item;
+  item.type_ = op;
+  item.value_.int_ = count;
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(item));
+}
+
+void ObExprCompilerTest::set_row(const ObObj &c1, const ObObj &c2)
+{
+  ASSERT_EQ(OB_SUCCESS, row_.set_cell(TID, C1, c1));
+  ASSERT_EQ(OB_SUCCESS, row_.set_cell(TID, C2, c2));
+}
+
+void ObExprCompilerTest::check(ObPostfixExpression &p, const ObExprObj &expected)
+{
+  const ObObj *result = NULL;
+  ObObj expected_obj;
+  ASSERT_EQ(OB_SUCCESS, expected.to(expected_obj));
+  ASSERT_EQ(OB_SUCCESS, p.calc(row_, result));
+  ASSERT_TRUE(NULL != result);
+  ASSERT_EQ(expected_obj.get_type(), result->get_type()) << to_cstring(p) << " row=" << to_cstring(row_);
+  ASSERT_TRUE(expected_obj == *result) << to_cstring(p) << " row=" << to_cstring(row_);
+}
+
+TEST_F(ObExprCompilerTest, compare)
+{
+  const ObItemType ops[] = {T_OP_LT, T_OP_LE, T_OP_GT, T_OP_GE, T_OP_EQ, T_OP_NE};
+  ObObj cells[6];
+  cells[0].set_int(5);
+  cells[1].set_int(10);
+  cells[2].set_null();
+  cells[3].set_double(10.0);
+  cells[4].set_varchar(ObString::make_string("10"));
+  cells[5].set_varchar(ObString::make_string("abc"));
+  ObObj param;
+  for (int64_t i = 0; i < static_cast<int64_t>(sizeof(ops) / sizeof(ops[0])); ++i)
+  {
+    // c1 OP 10, 10 OP c1, c1 OP 'abc', c1 OP c2, c1 OP ?
+    ObPostfixExpression col_const;
+    add_column(col_const, C1);
+    add_int(col_const, 10);
+    add_op(col_const, ops[i], 2);
+    col_const.add_expr_item_end();
+    ObPostfixExpression const_col;
+    add_int(const_col, 10);
+    add_column(const_col, C1);
+    add_op(const_col, ops[i], 2);
+    const_col.add_expr_item_end();
+    ObPostfixExpression col_str;
+    add_column(col_str, C1);
+    add_str(col_str, "abc");
+    add_op(col_str, ops[i], 2);
+    col_str.add_expr_item_end();
+    ObPostfixExpression col_col;
+    add_column(col_col, C1);
+    add_column(col_col, C2);
+    add_op(col_col, ops[i], 2);
+    col_col.add_expr_item_end();
+    ObPostfixExpression col_param;
+    add_column(col_param, C1);
+    add_param(col_param, param);
+    add_op(col_param, ops[i], 2);
+    col_param.add_expr_item_end();
+    for (int64_t j = 0; j < 6; ++j)
+    {
+      for (int64_t k = 0; k < 6; ++k)
+      {
+        set_row(cells[j], cells[k]);
+        param = cells[k];
+        ObExprObj v1;
+        ObExprObj v2;
+        ObExprObj ten;
+        ObExprObj abc;
+        ObExprObj res;
+        v1.assign(cells[j]);
+        v2.assign(cells[k]);
+        ten.set_int(10);
+        abc.set_varchar(ObString::make_string("abc"));
+        ObExprObj *args[4][2] = {{&v1, &ten}, {&ten, &v1}, {&v1, &abc}, {&v1, &v2}};
+        ObPostfixExpression *exprs[4] = {&col_const, &const_col, &col_str, &col_col};
+        for (int64_t n = 0; n < 4; ++n)
+        {
+          switch(ops[i])
+          {
+            case T_OP_LT:
+              args[n][0]->lt(*args[n][1], res);
+              break;
+            case T_OP_LE:
+              args[n][0]->le(*args[n][1], res);
+              break;
+            case T_OP_GT:
+              args[n][0]->gt(*args[n][1], res);
+              break;
+            case T_OP_GE:
+              args[n][0]->ge(*args[n][1], res);
+              break;
+            case T_OP_EQ:
+              args[n][0]->eq(*args[n][1], res);
+              break;
+            default:
+              args[n][0]->ne(*args[n][1], res);
+              break;
+          }
+          check(*exprs[n], res);
+          if (3 == n)
+          {
+            // the param has the same value as c2
+            check(col_param, res);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_F(ObExprCompilerTest, between)
+{
+  ObObj cells[5];
+  cells[0].set_int(0);
+  cells[1].set_int(3);
+  cells[2].set_int(20);
+  cells[3].set_null();
+  cells[4].set_double(3.5);
+  for (int64_t is_not = 0; is_not < 2; ++is_not)
+  {
+    // c1 [NOT] BETWEEN 1 AND 10
+    ObPostfixExpression p;
+    add_column(p, C1);
+    add_int(p, 1);
+    add_int(p, 10);
+    add_op(p, is_not ? T_OP_NOT_BTW : T_OP_BTW, 3);
+    p.add_expr_item_end();
+    for (int64_t i = 0; i < 5; ++i)
+    {
+      set_row(cells[i], cells[i]);
+      ObExprObj value;
+      ObExprObj low;
+      ObExprObj high;
+      ObExprObj res;
+      value.assign(cells[i]);
+      low.set_int(1);
+      high.set_int(10);
+      if (is_not)
+      {
+        value.not_btw(low, high, res);
+      }
+      else
+      {
+        value.btw(low, high, res);
+      }
+      check(p, res);
+    }
+  }
+}
+
+TEST_F(ObExprCompilerTest, like)
+{
+  const char *patterns[] = {"abc", "", "abc%", "abc%%", "%abc", "%abc%", "%%abc%%", "%", "%%",
+                            "a_c", "%%abc", "a\\%", "%b%c%"};
+  const char *texts[] = {"abc", "", "ab", "abcd", "xabc", "xabcx", "bc", "a%", "xbxcx"};
+  // the texts are put after zeros, so that what the matcher reads out of
+  // the short texts never matches
+  char buf[64];
+  for (int64_t is_not = 0; is_not < 2; ++is_not)
+  {
+    for (int64_t i = 0; i < static_cast<int64_t>(sizeof(patterns) / sizeof(patterns[0])); ++i)
+    {
+      ObPostfixExpression p;
+      add_column(p, C1);
+      add_str(p, patterns[i]);
+      add_op(p, is_not ? T_OP_NOT_LIKE : T_OP_LIKE, 2);
+      p.add_expr_item_end();
+      for (int64_t j = 0; j < static_cast<int64_t>(sizeof(texts) / sizeof(texts[0])); ++j)
+      {
+        memset(buf, 0, sizeof(buf));
+        strcpy(buf + 32, texts[j]);
+        ObObj text;
+        text.set_varchar(ObString(0, static_cast<int32_t>(strlen(texts[j])), buf + 32));
+        set_row(text, text);
+        ObExprObj value;
+        ObExprObj pattern;
+        ObExprObj res;
+        value.assign(text);
+        pattern.set_varchar(ObString::make_string(patterns[i]));
+        if (is_not)
+        {
+          value.not_like(pattern, res);
+        }
+        else
+        {
+          value.like(pattern, res);
+        }
+        check(p, res);
+      }
+      // null
+      ObObj null_obj;
+      ObExprObj res;
+      res.set_null();
+      set_row(null_obj, null_obj);
+      check(p, res);
+    }
+  }
+  // like on an int column is an error
+  ObPostfixExpression p;
+  add_column(p, C1);
+  add_str(p, "abc%");
+  add_op(p, T_OP_LIKE, 2);
+  p.add_expr_item_end();
+  ObObj int_obj;
+  int_obj.set_int(1);
+  set_row(int_obj, int_obj);
+  const ObObj *result = NULL;
+  ASSERT_EQ(OB_INVALID_ARGUMENT, p.calc(row_, result));
+}
+
+TEST_F(ObExprCompilerTest, logic)
+{
+  ObObj cells[4];
+  cells[0].set_int(1);
+  cells[1].set_int(2);
+  cells[2].set_null();
+  cells[3].set_varchar(ObString::make_string("x"));
+  const ObItemType ops[] = {T_OP_AND, T_OP_OR};
+  for (int64_t n = 0; n < 2; ++n)
+  {
+    // c1 = 1 AND/OR NOT (c2 = 1)
+    ObPostfixExpression p;
+    add_column(p, C1);
+    add_int(p, 1);
+    add_op(p, T_OP_EQ, 2);
+    add_column(p, C2);
+    add_int(p, 1);
+    add_op(p, T_OP_EQ, 2);
+    add_op(p, T_OP_NOT, 1);
+    add_op(p, ops[n], 2);
+    p.add_expr_item_end();
+    for (int64_t i = 0; i < 4; ++i)
+    {
+      for (int64_t j = 0; j < 4; ++j)
+      {
+        set_row(cells[i], cells[j]);
+        ObExprObj c1;
+        ObExprObj c2;
+        ObExprObj one;
+        ObExprObj left;
+        ObExprObj eq;
+        ObExprObj right;
+        ObExprObj res;
+        c1.assign(cells[i]);
+        c2.assign(cells[j]);
+        one.set_int(1);
+        c1.eq(one, left);
+        c2.eq(one, eq);
+        eq.lnot(right);
+        if (T_OP_AND == ops[n])
+        {
+          left.land(right, res);
+        }
+        else
+        {
+          left.lor(right, res);
+        }
+        check(p, res);
+      }
+    }
+  }
+  // the error of the right side is not skipped by the short circuit
+  ObPostfixExpression p;
+  add_column(p, C1);
+  add_int(p, 1);
+  add_op(p, T_OP_EQ, 2);
+  add_column(p, C2);
+  add_str(p, "a%");
+  add_op(p, T_OP_LIKE, 2);
+  add_op(p, T_OP_AND, 2);
+  p.add_expr_item_end();
+  set_row(cells[1], cells[1]);
+  const ObObj *result = NULL;
+  ASSERT_EQ(OB_INVALID_ARGUMENT, p.calc(row_, result));
+}
+
+TEST_F(ObExprCompilerTest, const_folding)
+{
+  // c1 + (2 + 3) * 4, 'a' || 'b'
+  ObPostfixExpression p;
+  add_column(p, C1);
+  add_int(p, 2);
+  add_int(p, 3);
+  add_op(p, T_OP_ADD, 2);
+  add_int(p, 4);
+  add_op(p, T_OP_MUL, 2);
+  add_op(p, T_OP_ADD, 2);
+  p.add_expr_item_end();
+  ObObj c1;
+  c1.set_int(1);
+  set_row(c1, c1);
+  ObExprObj res;
+  res.set_int(21);
+  check(p, res);
+  c1.set_int(2);
+  set_row(c1, c1);
+  res.set_int(22);
+  check(p, res);
+
+  ObPostfixExpression p2;
+  add_str(p2, "a");
+  add_str(p2, "b");
+  add_op(p2, T_OP_CNN, 2);
+  p2.add_expr_item_end();
+  res.set_varchar(ObString::make_string("ab"));
+  check(p2, res);
+
+  // params are not folded
+  ObObj param;
+  param.set_int(1);
+  ObPostfixExpression p3;
+  add_param(p3, param);
+  add_int(p3, 1);
+  add_op(p3, T_OP_ADD, 2);
+  p3.add_expr_item_end();
+  res.set_int(2);
+  check(p3, res);
+  param.set_int(2);
+  res.set_int(3);
+  check(p3, res);
+}
+
+TEST_F(ObExprCompilerTest, fallback)
+{
+  // c1 IN (1, 2) is interpreted
+  ObPostfixExpression p;
+  add_column(p, C1);
+  add_op(p, T_OP_LEFT_PARAM_END, 1);
+  add_int(p, 1);
+  add_int(p, 2);
+  add_op(p, T_OP_ROW, 2);
+  add_op(p, T_OP_IN, 2);
+  p.add_expr_item_end();
+  ASSERT_FALSE(p.is_compiled());
+  ObObj c1;
+  c1.set_int(2);
+  set_row(c1, c1);
+  ObExprObj res;
+  res.set_bool(true);
+  check(p, res);
+
+  // the expression is compiled again after changed
+  ObPostfixExpression p2;
+  add_column(p2, C1);
+  ASSERT_FALSE(p2.is_compiled());
+  p2.add_expr_item_end();
+  ASSERT_TRUE(p2.is_compiled());
+  res.set_int(2);
+  check(p2, res);
+  ObPostfixExpression p3;
+  p3 = p2;
+  ASSERT_TRUE(p3.is_compiled());
+  p2.reset();
+  ASSERT_FALSE(p2.is_compiled());
+  add_int(p2, 3);
+  p2.add_expr_item_end();
+  ASSERT_TRUE(p2.is_compiled());
+  res.set_int(3);
+  check(p2, res);
+  res.set_int(2);
+  check(p3, res);
+}
+
+TEST_F(ObExprCompilerTest, deserialize)
+{
+  // c1 > 1 AND c2 LIKE 'a%'
+  ObPostfixExpression p;
+  add_column(p, C1);
+  add_int(p, 1);
+  add_op(p, T_OP_GT, 2);
+  add_column(p, C2);
+  add_str(p, "a%");
+  add_op(p, T_OP_LIKE, 2);
+  add_op(p, T_OP_AND, 2);
+  p.add_expr_item_end();
+  char buf[1024];
+  int64_t pos = 0;
+  ASSERT_EQ(OB_SUCCESS, p.serialize(buf, sizeof(buf), pos));
+  ObPostfixExpression p2;
+  int64_t data_len = pos;
+  pos = 0;
+  ASSERT_EQ(OB_SUCCESS, p2.deserialize(buf, data_len, pos));
+  // compiled before the first row comes
+  ASSERT_TRUE(p2.is_compiled());
+  ObObj c1;
+  ObObj c2;
+  c1.set_int(2);
+  c2.set_varchar(ObString::make_string("abc"));
+  set_row(c1, c2);
+  ObExprObj res;
+  res.set_bool(true);
+  check(p2, res);
+  c2.set_varchar(ObString::make_string("bc"));
+  set_row(c1, c2);
+  res.set_bool(false);
+  check(p2, res);
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
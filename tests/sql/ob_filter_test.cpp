@@ -44,6 +44,8 @@ class ObPhyOperatorStub : public ObPhyOperator
       data[7][0] = 8, data[7][1] = 2;
       data[8][0] = 9, data[8][1] = 1;
       data[9][0] = 0, data[9][1] = 0;
+      row_desc_.add_column_desc(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+2);
+      row_desc_.add_column_desc(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+3);
     }
 
     ~ObPhyOperatorStub(){}
@@ -83,7 +85,6 @@ class ObPhyOperatorStub : public ObPhyOperator
     virtual int get_row_desc(const ObRowDesc *&row_desc) const {row_desc=NULL;return OB_NOT_IMPLEMENT;}
     int get_next_row(const ObRow *&row)
     {
-      ObRowDesc row_desc;
       ObObj obj_a, obj_b;
 
       if (pos_ == 10)
@@ -91,11 +92,9 @@ class ObPhyOperatorStub : public ObPhyOperator
         return OB_ITER_END;
       }
 
-      row_desc.add_column_desc(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+2);
-      row_desc.add_column_desc(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+3);
       obj_a.set_int(data[pos_][0]);
       obj_b.set_int(data[pos_][1]);
-      row_.set_row_desc(row_desc);
+      row_.set_row_desc(row_desc_);
       row_.set_cell(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+2, obj_a);
       row_.set_cell(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+3, obj_b);
       row = &row_;
@@ -114,6 +113,7 @@ class ObPhyOperatorStub : public ObPhyOperator
 
     ObRow row_;
 private:
+    ObRowDesc row_desc_; // the row refers to it
     int data[10][2];
     int pos_;
 };
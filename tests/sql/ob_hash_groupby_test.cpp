@@ -0,0 +1,145 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_hash_groupby_test.cpp
+ *
+ * Authors:
+ *   Zhifeng YANG <zhuweng.yzf@taobao.com>
+ *
+ */
+#include "sql/ob_hash_groupby.h"
+#include "ob_fake_table.h"
+#include <gtest/gtest.h>
+using namespace oceanbase::common;
+using namespace oceanbase::sql;
+
+class ObHashGroupByTest: public ::testing::Test
+{
+  public:
+    ObHashGroupByTest();
+    virtual ~ObHashGroupByTest();
+    virtual void SetUp();
+    virtual void TearDown();
+  protected:
+    static const int64_t AGGR_CID = 9999;
+    // sum(c1+c2) group by group_cid, the result of every group is verified
+    void test_groupby(ObHashGroupBy &groupby, const int64_t row_count,
+                      const uint64_t group_cid, const int64_t group_count);
+    int64_t get_group(const int64_t row_idx, const uint64_t group_cid) const;
+  private:
+    // disallow copy
+    ObHashGroupByTest(const ObHashGroupByTest &other);
+    ObHashGroupByTest& operator=(const ObHashGroupByTest &other);
+};
+
+ObHashGroupByTest::ObHashGroupByTest()
+{
+}
+
+ObHashGroupByTest::~ObHashGroupByTest()
+{
+}
+
+void ObHashGroupByTest::SetUp()
+{
+}
+
+void ObHashGroupByTest::TearDown()
+{
+}
+
+int64_t ObHashGroupByTest::get_group(const int64_t row_idx, const uint64_t group_cid) const
+{
+  return (OB_APP_MIN_COLUMN_ID+3 == group_cid) ? row_idx % 3 : row_idx / 3;
+}
+
+void ObHashGroupByTest::test_groupby(ObHashGroupBy &groupby, const int64_t row_count,
+                                     const uint64_t group_cid, const int64_t group_count)
+{
+  test::ObFakeTable input;
+  input.set_row_count(row_count);
+  ASSERT_EQ(OB_SUCCESS, groupby.add_group_column(test::ObFakeTable::TABLE_ID, group_cid));
+  // sum(c1+c2)
+  ObSqlExpression sexpr2;
+  sexpr2.set_aggr_func(T_FUN_SUM, false);
+  sexpr2.set_tid_cid(OB_INVALID_ID, AGGR_CID);
+  ExprItem expr_item;
+  expr_item.type_ = T_REF_COLUMN;
+  expr_item.value_.cell_.tid = test::ObFakeTable::TABLE_ID;
+  expr_item.value_.cell_.cid = OB_APP_MIN_COLUMN_ID+1;
+  sexpr2.add_expr_item(expr_item); // c1
+  expr_item.value_.cell_.cid = OB_APP_MIN_COLUMN_ID+2;
+  sexpr2.add_expr_item(expr_item); // c2
+  expr_item.type_ = T_OP_ADD;
+  sexpr2.add_expr_item(expr_item); // + op
+  sexpr2.add_expr_item_end();
+  ASSERT_EQ(OB_SUCCESS, groupby.add_aggr_column(sexpr2));
+  groupby.set_child(0, input);
+  char strbuff[1024];
+  groupby.to_string(strbuff, 1024);
+  TBSYS_LOG(INFO, "groupby=%s", strbuff);
+  // expected results
+  int64_t *expected = new int64_t[group_count];
+  bool *seen = new bool[group_count];
+  for (int64_t i = 0; i < group_count; ++i)
+  {
+    expected[i] = 0;
+    seen[i] = false;
+  }
+  for (int64_t i = 0; i < row_count; ++i)
+  {
+    expected[get_group(i, group_cid)] += i + i % 2;
+  }
+  // the output is not ordered
+  ASSERT_EQ(OB_SUCCESS, groupby.open());
+  const ObRow *row = NULL;
+  const ObObj *cell = NULL;
+  int64_t group = 0;
+  int64_t i64 = 0;
+  for (int64_t i = 0; i < group_count; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, groupby.get_next_row(row));
+    ASSERT_EQ(OB_SUCCESS, row->get_cell(test::ObFakeTable::TABLE_ID, group_cid, cell));
+    ASSERT_EQ(OB_SUCCESS, cell->get_int(group));
+    ASSERT_TRUE(0 <= group && group < group_count);
+    ASSERT_FALSE(seen[group]);
+    seen[group] = true;
+    ASSERT_EQ(OB_SUCCESS, row->get_cell(OB_INVALID_ID, AGGR_CID, cell));
+    ASSERT_EQ(OB_SUCCESS, cell->get_int(i64));
+    ASSERT_EQ(expected[group], i64);
+  }
+  ASSERT_EQ(OB_ITER_END, groupby.get_next_row(row));
+  ASSERT_EQ(OB_ITER_END, groupby.get_next_row(row));
+  ASSERT_EQ(OB_SUCCESS, groupby.close());
+  delete [] expected;
+  delete [] seen;
+}
+
+TEST_F(ObHashGroupByTest, basic_test)
+{
+  ObHashGroupBy groupby;
+  // the input is not sorted by c3
+  test_groupby(groupby, 100, OB_APP_MIN_COLUMN_ID+3, 3);
+}
+
+TEST_F(ObHashGroupByTest, spill_test)
+{
+  ObHashGroupBy groupby;
+  // keep one group in memory at a time, the others are spilled
+  groupby.set_mem_size_limit(1);
+  ASSERT_EQ(OB_SUCCESS, groupby.set_run_filename(ObString::make_string("ob_hash_groupby_test.run")));
+  test_groupby(groupby, 300, OB_APP_MIN_COLUMN_ID+5, 100);
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
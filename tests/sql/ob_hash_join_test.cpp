@@ -0,0 +1,359 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_hash_join_test.cpp
+ *
+ * Authors:
+ *   Zhifeng YANG <zhuweng.yzf@taobao.com>
+ *
+ */
+#include "sql/ob_hash_join.h"
+#include "ob_fake_table.h"
+#include <gtest/gtest.h>
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+class ObHashJoinTest: public ::testing::Test
+{
+  public:
+    ObHashJoinTest();
+    virtual ~ObHashJoinTest();
+    virtual void SetUp();
+    virtual void TearDown();
+  protected:
+    static const uint64_t LEFT_TID = 1001;
+    static const uint64_t RIGHT_TID = 2001;
+    static const int64_t SPILL_MEM_SIZE_LIMIT = 8*1024*1024LL;
+    // the output is verified against a nested loop join of the same inputs,
+    // rows are identified by c1 of both sides
+    void test_join(ObHashJoin &hash_join, const ObJoin::JoinType join_type,
+                   const int64_t left_row_count, const int64_t right_row_count,
+                   const int64_t left_cid, const int64_t right_cid,
+                   const bool has_other_cond);
+    // value of the fake table column, see ObFakeTable::cons_curr_row()
+    static bool get_value(const int64_t row_idx, const int64_t cid, int64_t &val);
+  private:
+    // disallow copy
+    ObHashJoinTest(const ObHashJoinTest &other);
+    ObHashJoinTest& operator=(const ObHashJoinTest &other);
+};
+
+ObHashJoinTest::ObHashJoinTest()
+{
+}
+
+ObHashJoinTest::~ObHashJoinTest()
+{
+}
+
+void ObHashJoinTest::SetUp()
+{
+}
+
+void ObHashJoinTest::TearDown()
+{
+}
+
+bool ObHashJoinTest::get_value(const int64_t row_idx, const int64_t cid, int64_t &val)
+{
+  bool is_null = false;
+  switch(cid)
+  {
+    case 1:
+      val = row_idx;
+      break;
+    case 2:
+      val = row_idx % 2;
+      break;
+    case 3:
+      val = row_idx % 3;
+      break;
+    case 4:
+      val = row_idx / 2;
+      break;
+    case 5:
+      val = row_idx / 3;
+      break;
+    case 8:
+      is_null = (0 == row_idx % 2);
+      val = row_idx;
+      break;
+    default:
+      abort();
+  }
+  return !is_null;
+}
+
+void ObHashJoinTest::test_join(ObHashJoin &hash_join, const ObJoin::JoinType join_type,
+                               const int64_t left_row_count, const int64_t right_row_count,
+                               const int64_t left_cid, const int64_t right_cid,
+                               const bool has_other_cond)
+{
+  test::ObFakeTable left_input;
+  left_input.set_row_count(left_row_count);
+  left_input.set_table_id(LEFT_TID);
+  test::ObFakeTable right_input;
+  right_input.set_row_count(right_row_count);
+  right_input.set_table_id(RIGHT_TID);
+  ASSERT_EQ(OB_SUCCESS, hash_join.set_child(0, left_input));
+  ASSERT_EQ(OB_SUCCESS, hash_join.set_child(1, right_input));
+  ASSERT_EQ(OB_SUCCESS, hash_join.set_join_type(join_type));
+  // equijoin: right.right_col = left.left_col, columns of the condition are
+  // reversed on purpose
+  {
+    ObSqlExpression expr;
+    ExprItem item;
+    item.type_ = T_REF_COLUMN;
+    item.value_.cell_.tid = RIGHT_TID;
+    item.value_.cell_.cid = OB_APP_MIN_COLUMN_ID + right_cid;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    item.type_ = T_REF_COLUMN;
+    item.value_.cell_.tid = LEFT_TID;
+    item.value_.cell_.cid = OB_APP_MIN_COLUMN_ID + left_cid;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    item.type_ = T_OP_EQ;
+    item.value_.int_ = 2;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item_end());
+    ASSERT_EQ(OB_SUCCESS, hash_join.add_equijoin_condition(expr));
+  }
+  // other cond: left.c1 % 2 = 0
+  if (has_other_cond)
+  {
+    ObSqlExpression expr;
+    ExprItem item;
+    item.type_ = T_REF_COLUMN;
+    item.value_.cell_.tid = LEFT_TID;
+    item.value_.cell_.cid = OB_APP_MIN_COLUMN_ID + 1;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    item.type_ = T_INT;
+    item.value_.int_ = 2;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    item.type_ = T_OP_MOD;
+    item.value_.int_ = 2;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    item.type_ = T_INT;
+    item.value_.int_ = 0;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    item.type_ = T_OP_EQ;
+    item.value_.int_ = 2;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item_end());
+    ASSERT_EQ(OB_SUCCESS, hash_join.add_other_join_condition(expr));
+  }
+  char buff[1024];
+  hash_join.to_string(buff, 1024);
+  TBSYS_LOG(INFO, "hash_join=%s", buff);
+  // expected results, the output row (l, r) is counted at (l+1)*(right_row_count+1)+(r+1),
+  // the missing side is counted as -1
+  const int64_t slot_num = (left_row_count + 1) * (right_row_count + 1);
+  int64_t *expected = new int64_t[slot_num];
+  int64_t *actual = new int64_t[slot_num];
+  bool *right_matched = new bool[right_row_count];
+  memset(expected, 0, slot_num * sizeof(int64_t));
+  memset(actual, 0, slot_num * sizeof(int64_t));
+  memset(right_matched, 0, right_row_count * sizeof(bool));
+  for (int64_t l = 0; l < left_row_count; ++l)
+  {
+    bool left_matched = false;
+    for (int64_t r = 0; r < right_row_count; ++r)
+    {
+      int64_t lval = 0;
+      int64_t rval = 0;
+      if (get_value(l, left_cid, lval) && get_value(r, right_cid, rval)
+          && lval == rval && (!has_other_cond || 0 == l % 2))
+      {
+        left_matched = true;
+        right_matched[r] = true;
+        if (ObJoin::LEFT_SEMI_JOIN != join_type && ObJoin::LEFT_ANTI_SEMI_JOIN != join_type
+            && ObJoin::RIGHT_SEMI_JOIN != join_type && ObJoin::RIGHT_ANTI_SEMI_JOIN != join_type)
+        {
+          ++expected[(l + 1) * (right_row_count + 1) + r + 1];
+        }
+      }
+    }
+    if ((left_matched && ObJoin::LEFT_SEMI_JOIN == join_type)
+        || (!left_matched && (ObJoin::LEFT_ANTI_SEMI_JOIN == join_type
+                              || ObJoin::LEFT_OUTER_JOIN == join_type
+                              || ObJoin::FULL_OUTER_JOIN == join_type)))
+    {
+      ++expected[(l + 1) * (right_row_count + 1)];
+    }
+  }
+  for (int64_t r = 0; r < right_row_count; ++r)
+  {
+    if ((right_matched[r] && ObJoin::RIGHT_SEMI_JOIN == join_type)
+        || (!right_matched[r] && (ObJoin::RIGHT_ANTI_SEMI_JOIN == join_type
+                                  || ObJoin::RIGHT_OUTER_JOIN == join_type
+                                  || ObJoin::FULL_OUTER_JOIN == join_type)))
+    {
+      ++expected[r + 1];
+    }
+  }
+  // the output is not ordered
+  const bool has_left = (ObJoin::RIGHT_SEMI_JOIN != join_type && ObJoin::RIGHT_ANTI_SEMI_JOIN != join_type);
+  const bool has_right = (ObJoin::LEFT_SEMI_JOIN != join_type && ObJoin::LEFT_ANTI_SEMI_JOIN != join_type);
+  ASSERT_EQ(OB_SUCCESS, hash_join.open());
+  const ObRow *row = NULL;
+  const ObObj *cell = NULL;
+  int ret = OB_SUCCESS;
+  while (OB_SUCCESS == (ret = hash_join.get_next_row(row)))
+  {
+    int64_t l = -1;
+    int64_t r = -1;
+    if (has_left)
+    {
+      ASSERT_EQ(OB_SUCCESS, row->get_cell(LEFT_TID, OB_APP_MIN_COLUMN_ID + 1, cell));
+      if (!cell->is_null())
+      {
+        ASSERT_EQ(OB_SUCCESS, cell->get_int(l));
+      }
+    }
+    if (has_right)
+    {
+      ASSERT_EQ(OB_SUCCESS, row->get_cell(RIGHT_TID, OB_APP_MIN_COLUMN_ID + 1, cell));
+      if (!cell->is_null())
+      {
+        ASSERT_EQ(OB_SUCCESS, cell->get_int(r));
+      }
+    }
+    ASSERT_TRUE(-1 <= l && l < left_row_count);
+    ASSERT_TRUE(-1 <= r && r < right_row_count);
+    ++actual[(l + 1) * (right_row_count + 1) + r + 1];
+  }
+  ASSERT_EQ(OB_ITER_END, ret);
+  ASSERT_EQ(OB_ITER_END, hash_join.get_next_row(row));
+  for (int64_t i = 0; i < slot_num; ++i)
+  {
+    ASSERT_EQ(expected[i], actual[i]) << "l=" << i / (right_row_count + 1) - 1
+                                      << " r=" << i % (right_row_count + 1) - 1;
+  }
+  ASSERT_EQ(OB_SUCCESS, hash_join.close());
+  delete [] expected;
+  delete [] actual;
+  delete [] right_matched;
+}
+
+TEST_F(ObHashJoinTest, inner_join_test)
+{
+  {
+    ObHashJoin hash_join;
+    test_join(hash_join, ObJoin::INNER_JOIN, 100, 80, 1, 1, false);
+  }
+  {
+    // many to many
+    ObHashJoin hash_join;
+    test_join(hash_join, ObJoin::INNER_JOIN, 90, 60, 3, 5, false);
+  }
+  {
+    ObHashJoin hash_join;
+    test_join(hash_join, ObJoin::INNER_JOIN, 90, 60, 4, 5, true);
+  }
+  {
+    // null never equals null
+    ObHashJoin hash_join;
+    test_join(hash_join, ObJoin::INNER_JOIN, 50, 50, 8, 8, false);
+  }
+}
+
+TEST_F(ObHashJoinTest, outer_join_test)
+{
+  const ObJoin::JoinType join_types[] = {
+    ObJoin::LEFT_OUTER_JOIN, ObJoin::RIGHT_OUTER_JOIN, ObJoin::FULL_OUTER_JOIN
+  };
+  for (int64_t i = 0; i < static_cast<int64_t>(ARRAYSIZEOF(join_types)); ++i)
+  {
+    {
+      ObHashJoin hash_join;
+      test_join(hash_join, join_types[i], 100, 60, 1, 4, false);
+    }
+    {
+      ObHashJoin hash_join;
+      test_join(hash_join, join_types[i], 60, 100, 8, 1, true);
+    }
+  }
+}
+
+TEST_F(ObHashJoinTest, semi_join_test)
+{
+  const ObJoin::JoinType join_types[] = {
+    ObJoin::LEFT_SEMI_JOIN, ObJoin::RIGHT_SEMI_JOIN,
+    ObJoin::LEFT_ANTI_SEMI_JOIN, ObJoin::RIGHT_ANTI_SEMI_JOIN
+  };
+  for (int64_t i = 0; i < static_cast<int64_t>(ARRAYSIZEOF(join_types)); ++i)
+  {
+    {
+      ObHashJoin hash_join;
+      test_join(hash_join, join_types[i], 100, 60, 5, 1, false);
+    }
+    {
+      ObHashJoin hash_join;
+      test_join(hash_join, join_types[i], 60, 100, 1, 8, true);
+    }
+  }
+}
+
+TEST_F(ObHashJoinTest, spill_test)
+{
+  const ObJoin::JoinType join_types[] = {
+    ObJoin::INNER_JOIN, ObJoin::LEFT_OUTER_JOIN, ObJoin::RIGHT_OUTER_JOIN, ObJoin::FULL_OUTER_JOIN,
+    ObJoin::LEFT_SEMI_JOIN, ObJoin::RIGHT_SEMI_JOIN,
+    ObJoin::LEFT_ANTI_SEMI_JOIN, ObJoin::RIGHT_ANTI_SEMI_JOIN
+  };
+  for (int64_t i = 0; i < static_cast<int64_t>(ARRAYSIZEOF(join_types)); ++i)
+  {
+    {
+      // every partition with rows takes a 2M block of the row store, so
+      // partitions are spilled until at most 3 of them are left in memory
+      ObHashJoin hash_join;
+      hash_join.set_mem_size_limit(SPILL_MEM_SIZE_LIMIT);
+      ASSERT_EQ(OB_SUCCESS, hash_join.set_run_filename(ObString::make_string("ob_hash_join_test.run")));
+      test_join(hash_join, join_types[i], 200, 150, 1, 4, false);
+    }
+    {
+      ObHashJoin hash_join;
+      hash_join.set_mem_size_limit(SPILL_MEM_SIZE_LIMIT);
+      ASSERT_EQ(OB_SUCCESS, hash_join.set_run_filename(ObString::make_string("ob_hash_join_test.run")));
+      test_join(hash_join, join_types[i], 300, 400, 2, 5, true);
+    }
+  }
+}
+
+TEST_F(ObHashJoinTest, max_spill_level_test)
+{
+  // rows of the same key can not be split by spilling, the partitions left
+  // at the max spill level are joined chunk by chunk
+  const ObJoin::JoinType join_types[] = {
+    ObJoin::INNER_JOIN, ObJoin::LEFT_OUTER_JOIN, ObJoin::RIGHT_OUTER_JOIN, ObJoin::FULL_OUTER_JOIN,
+    ObJoin::LEFT_SEMI_JOIN, ObJoin::RIGHT_SEMI_JOIN,
+    ObJoin::LEFT_ANTI_SEMI_JOIN, ObJoin::RIGHT_ANTI_SEMI_JOIN
+  };
+  for (int64_t i = 0; i < static_cast<int64_t>(ARRAYSIZEOF(join_types)); ++i)
+  {
+    {
+      ObHashJoin hash_join;
+      hash_join.set_mem_size_limit(1);
+      ASSERT_EQ(OB_SUCCESS, hash_join.set_run_filename(ObString::make_string("ob_hash_join_test.run")));
+      test_join(hash_join, join_types[i], 30, 40, 2, 3, false);
+    }
+    {
+      ObHashJoin hash_join;
+      hash_join.set_mem_size_limit(1);
+      ASSERT_EQ(OB_SUCCESS, hash_join.set_run_filename(ObString::make_string("ob_hash_join_test.run")));
+      test_join(hash_join, join_types[i], 30, 40, 2, 3, true);
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,171 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_plan_cache_test.cpp
+ *
+ * Authors:
+ *   Zhifeng YANG <zhuweng.yzf@taobao.com>
+ *
+ */
+#include "sql/ob_plan_cache.h"
+#include "common/ob_malloc.h"
+#include <gtest/gtest.h>
+using namespace oceanbase::common;
+using namespace oceanbase::sql;
+
+class ObPlanCacheTest: public ::testing::Test
+{
+  public:
+    ObPlanCacheTest();
+    virtual ~ObPlanCacheTest();
+    virtual void SetUp();
+    virtual void TearDown();
+  protected:
+    // parameterize sql and check the result is expected_key, NULL if not cachable
+    void test_parameterize(const char *sql, const char *expected_key, const int64_t param_count);
+  protected:
+    char buf_[ObSqlParameterizer::MAX_STMT_LENGTH];
+    ObArray<ObObj> params_;
+  private:
+    // disallow copy
+    ObPlanCacheTest(const ObPlanCacheTest &other);
+    ObPlanCacheTest& operator=(const ObPlanCacheTest &other);
+};
+
+ObPlanCacheTest::ObPlanCacheTest()
+{
+}
+
+ObPlanCacheTest::~ObPlanCacheTest()
+{
+}
+
+void ObPlanCacheTest::SetUp()
+{
+}
+
+void ObPlanCacheTest::TearDown()
+{
+}
+
+void ObPlanCacheTest::test_parameterize(const char *sql, const char *expected_key, const int64_t param_count)
+{
+  ObString key;
+  bool cachable = false;
+  ASSERT_EQ(OB_SUCCESS, ObSqlParameterizer::parameterize(ObString::make_string(sql), buf_, sizeof(buf_),
+                                                         key, params_, cachable));
+  if (NULL == expected_key)
+  {
+    ASSERT_FALSE(cachable);
+  }
+  else
+  {
+    ASSERT_TRUE(cachable);
+    ASSERT_EQ(std::string(expected_key), std::string(key.ptr(), key.length()));
+    ASSERT_EQ(param_count, params_.count());
+  }
+}
+
+TEST_F(ObPlanCacheTest, parameterize_select)
+{
+  test_parameterize("SELECT c1, 'a' FROM t1 WHERE c1 = 10 AND c2 = 'abc' ORDER BY 1 LIMIT 5",
+                    "SELECT c1, 'a' FROM t1 WHERE c1 = ? AND c2 = ? ORDER BY 1 LIMIT 5", 2);
+  int64_t i64 = 0;
+  ObString str;
+  ASSERT_EQ(OB_SUCCESS, params_.at(0).get_int(i64));
+  ASSERT_EQ(10, i64);
+  ASSERT_EQ(OB_SUCCESS, params_.at(1).get_varchar(str));
+  ASSERT_EQ(std::string("abc"), std::string(str.ptr(), str.length()));
+  // the same statement with other constants
+  test_parameterize("SELECT c1, 'a' FROM t1 WHERE c1 = 20 AND c2 = 'xyz' ORDER BY 1 LIMIT 5",
+                    "SELECT c1, 'a' FROM t1 WHERE c1 = ? AND c2 = ? ORDER BY 1 LIMIT 5", 2);
+  // subquery and in list
+  test_parameterize("select * from t1 where c1 in (1, 2) and c2 in (select c2 from t2 where c3 > 3) and c4 < 4",
+                    "select * from t1 where c1 in (?, ?) and c2 in (select c2 from t2 where c3 > ?) and c4 < ?", 4);
+  // identifiers, decimals and typed literals are kept
+  test_parameterize("select t1.c1 from t1 where c2 = 1.5 and c3 = date '2012-01-01' and c4 = X'0A' and c5 = 0x0A and c6 = 1e3",
+                    "select t1.c1 from t1 where c2 = 1.5 and c3 = date '2012-01-01' and c4 = X'0A' and c5 = 0x0A and c6 = 1e3", 0);
+  // escaped strings are kept
+  test_parameterize("select c1 from t1 where c2 = 'it''s' and c3 = 'a\\'b' and c4 = 'c'",
+                    "select c1 from t1 where c2 = 'it''s' and c3 = 'a\\'b' and c4 = ?", 1);
+  // comments and quoted identifiers
+  test_parameterize("/*+ index(t1 i1) */ select `c1` from t1 -- 1\n where \"c2\" = 2",
+                    "/*+ index(t1 i1) */ select `c1` from t1 -- 1\n where \"c2\" = ?", 1);
+  // VALUE and VALUES are column names here
+  test_parameterize("SELECT value, 1 FROM t1 WHERE values = 2",
+                    "SELECT value, 1 FROM t1 WHERE values = ?", 1);
+}
+
+TEST_F(ObPlanCacheTest, parameterize_dml)
+{
+  test_parameterize("insert into t1 (c1, c2) values (1, 'a'), (2, 'b')",
+                    "insert into t1 (c1, c2) values (?, ?), (?, ?)", 4);
+  test_parameterize("replace into t1 values (1, -2)",
+                    "replace into t1 values (?, -?)", 2);
+  test_parameterize("update t1 set c2 = c2 + 1, c3 = 'x' where c1 = 100",
+                    "update t1 set c2 = c2 + ?, c3 = ? where c1 = ?", 3);
+  test_parameterize("delete from t1 where c1 = 100",
+                    "delete from t1 where c1 = ?", 1);
+  test_parameterize("insert into t1 (c1, value) value (1, 2)",
+                    "insert into t1 (c1, value) value (?, ?)", 2);
+  test_parameterize("insert into t1 select value, 1 from t2 where c1 = 3",
+                    "insert into t1 select value, 1 from t2 where c1 = ?", 1);
+}
+
+TEST_F(ObPlanCacheTest, not_cachable)
+{
+  test_parameterize("show tables", NULL, 0);
+  test_parameterize("set @a = 1", NULL, 0);
+  test_parameterize("select * from t1 where c1 = ?", NULL, 0);
+  test_parameterize("select * from t1 where c1 = @a", NULL, 0);
+  test_parameterize("select * from t1 where c1 = 'abc", NULL, 0);
+  test_parameterize("(select * from t1)", NULL, 0);
+  test_parameterize("", NULL, 0);
+}
+
+TEST_F(ObPlanCacheTest, lru)
+{
+  ObPlanCache cache;
+  ObPlanCache::CachedPlan plan;
+  ObPlanCache::CachedPlan evicted;
+  const int64_t max_count = ObPlanCache::MAX_CACHED_PLAN_COUNT;
+  char sql[64];
+  for (int64_t i = 0; i < max_count; ++i)
+  {
+    snprintf(sql, sizeof(sql), "select * from t%ld", i);
+    plan.stmt_id_ = i;
+    ASSERT_EQ(OB_SUCCESS, cache.put(ObString::make_string(sql), plan, evicted));
+    ASSERT_EQ(OB_INVALID_ID, evicted.stmt_id_);
+  }
+  ASSERT_EQ(max_count, cache.size());
+  ASSERT_EQ(OB_ENTRY_EXIST, cache.put(ObString::make_string("select * from t0"), plan, evicted));
+  // t0 is used recently, t1 is evicted
+  ASSERT_EQ(OB_SUCCESS, cache.get(ObString::make_string("select * from t0"), plan));
+  ASSERT_EQ(0U, plan.stmt_id_);
+  plan.stmt_id_ = 1000;
+  ASSERT_EQ(OB_SUCCESS, cache.put(ObString::make_string("select * from new_table"), plan, evicted));
+  ASSERT_EQ(1U, evicted.stmt_id_);
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, cache.get(ObString::make_string("select * from t1"), plan));
+  ASSERT_EQ(OB_SUCCESS, cache.remove(ObString::make_string("select * from new_table"), plan));
+  ASSERT_EQ(1000U, plan.stmt_id_);
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, cache.remove(ObString::make_string("select * from new_table"), plan));
+  ASSERT_EQ(OB_SUCCESS, cache.pop(plan));
+  ASSERT_EQ(2U, plan.stmt_id_);
+  while (OB_SUCCESS == cache.pop(plan))
+  {
+  }
+  ASSERT_EQ(0, cache.size());
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,371 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_row_batch_test.cpp
+ *
+ * Authors:
+ *   Zhifeng YANG <zhuweng.yzf@taobao.com>
+ *
+ */
+#include "sql/ob_row_batch.h"
+#include "sql/ob_filter.h"
+#include "sql/ob_project.h"
+#include "sql/ob_limit.h"
+#include "sql/ob_scalar_aggregate.h"
+#include "common/ob_row_store.h"
+#include "common/ob_row_util.h"
+#include "ob_fake_table.h"
+#include <gtest/gtest.h>
+using namespace oceanbase::common;
+using namespace oceanbase::sql;
+
+// fake table which asks its parents to read it by batches
+class BatchFakeTable: public test::ObFakeTable
+{
+  public:
+    virtual bool is_batch_native() const
+    {
+      return true;
+    }
+};
+
+class ObRowBatchTest: public ::testing::Test
+{
+  public:
+    ObRowBatchTest();
+    virtual ~ObRowBatchTest();
+    virtual void SetUp();
+    virtual void TearDown();
+  protected:
+    static const uint64_t NEW_CID = OB_APP_MIN_COLUMN_ID+100;
+    // c2 = 1
+    void gen_filter(ObFilter &filter);
+    // c0, c1, c1+c2
+    void gen_project(ObProject &project);
+    void gen_limit(ObLimit &limit, const int64_t limit_val, const int64_t offset_val);
+  private:
+    // disallow copy
+    ObRowBatchTest(const ObRowBatchTest &other);
+    ObRowBatchTest& operator=(const ObRowBatchTest &other);
+};
+
+ObRowBatchTest::ObRowBatchTest()
+{
+}
+
+ObRowBatchTest::~ObRowBatchTest()
+{
+}
+
+void ObRowBatchTest::SetUp()
+{
+}
+
+void ObRowBatchTest::TearDown()
+{
+}
+
+void ObRowBatchTest::gen_filter(ObFilter &filter)
+{
+  ObSqlExpression *expr = ObSqlExpression::alloc();
+  ASSERT_TRUE(NULL != expr);
+  ExprItem item;
+  item.type_ = T_REF_COLUMN;
+  item.value_.cell_.tid = test::ObFakeTable::TABLE_ID;
+  item.value_.cell_.cid = OB_APP_MIN_COLUMN_ID+2;
+  ASSERT_EQ(OB_SUCCESS, expr->add_expr_item(item));
+  item.type_ = T_INT;
+  item.data_type_ = ObIntType;
+  item.value_.int_ = 1;
+  ASSERT_EQ(OB_SUCCESS, expr->add_expr_item(item));
+  item.type_ = T_OP_EQ;
+  item.value_.int_ = 2;
+  ASSERT_EQ(OB_SUCCESS, expr->add_expr_item(item));
+  ASSERT_EQ(OB_SUCCESS, expr->add_expr_item_end());
+  ASSERT_EQ(OB_SUCCESS, filter.add_filter(expr));
+}
+
+void ObRowBatchTest::gen_project(ObProject &project)
+{
+  ExprItem item;
+  item.type_ = T_REF_COLUMN;
+  item.value_.cell_.tid = test::ObFakeTable::TABLE_ID;
+  for (uint64_t cid = OB_APP_MIN_COLUMN_ID; cid <= OB_APP_MIN_COLUMN_ID+1; ++cid)
+  {
+    ObSqlExpression expr;
+    item.value_.cell_.cid = cid;
+    expr.set_tid_cid(test::ObFakeTable::TABLE_ID, cid);
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item_end());
+    ASSERT_EQ(OB_SUCCESS, project.add_output_column(expr));
+  }
+  ObSqlExpression expr;
+  expr.set_tid_cid(test::ObFakeTable::TABLE_ID, NEW_CID);
+  item.value_.cell_.cid = OB_APP_MIN_COLUMN_ID+1;
+  ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+  item.value_.cell_.cid = OB_APP_MIN_COLUMN_ID+2;
+  ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+  item.type_ = T_OP_ADD;
+  item.value_.int_ = 2;
+  ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+  ASSERT_EQ(OB_SUCCESS, expr.add_expr_item_end());
+  ASSERT_EQ(OB_SUCCESS, project.add_output_column(expr));
+}
+
+void ObRowBatchTest::gen_limit(ObLimit &limit, const int64_t limit_val, const int64_t offset_val)
+{
+  ObSqlExpression limit_expr;
+  ObSqlExpression offset_expr;
+  ExprItem item;
+  item.type_ = T_INT;
+  item.data_type_ = ObIntType;
+  item.value_.int_ = limit_val;
+  ASSERT_EQ(OB_SUCCESS, limit_expr.add_expr_item(item));
+  ASSERT_EQ(OB_SUCCESS, limit_expr.add_expr_item_end());
+  item.value_.int_ = offset_val;
+  ASSERT_EQ(OB_SUCCESS, offset_expr.add_expr_item(item));
+  ASSERT_EQ(OB_SUCCESS, offset_expr.add_expr_item_end());
+  ASSERT_EQ(OB_SUCCESS, limit.set_limit(limit_expr, offset_expr));
+}
+
+TEST_F(ObRowBatchTest, row_to_batch_adapter)
+{
+  test::ObFakeTable input;
+  input.set_row_count(1000);
+  ASSERT_EQ(OB_SUCCESS, input.open());
+  ASSERT_FALSE(input.is_batch_native());
+  const ObRowDesc *row_desc = NULL;
+  ASSERT_EQ(OB_SUCCESS, input.get_row_desc(row_desc));
+  ObRowBatch batch;
+  ASSERT_EQ(OB_SUCCESS, batch.init(*row_desc));
+  ObRow row;
+  const ObObj *cell = NULL;
+  int64_t i64 = 0;
+  int64_t row_count = 0;
+  ObString str;
+  const char *last_ptr = NULL;
+  while (OB_SUCCESS == input.get_next_batch(batch))
+  {
+    ASSERT_TRUE(0 < batch.get_row_count());
+    ASSERT_TRUE(batch.get_row_count() <= batch.get_capacity());
+    const ObObj *c1 = batch.get_column(1);
+    for (int64_t i = 0; i < batch.get_row_count(); ++i)
+    {
+      ASSERT_EQ(OB_SUCCESS, c1[batch.get_selection()[i]].get_int(i64));
+      ASSERT_EQ(row_count, i64);
+      ASSERT_EQ(OB_SUCCESS, batch.get_row(i, row));
+      ASSERT_EQ(OB_SUCCESS, row.get_cell(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+2, cell));
+      ASSERT_EQ(OB_SUCCESS, cell->get_int(i64));
+      ASSERT_EQ(row_count % 2, i64);
+      // varchars are deep copied, the fake table reuses one buffer for all rows
+      ASSERT_EQ(OB_SUCCESS, row.get_cell(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID, cell));
+      ASSERT_EQ(OB_SUCCESS, cell->get_varchar(str));
+      if (0 < str.length())
+      {
+        ASSERT_TRUE(last_ptr != str.ptr());
+        last_ptr = str.ptr();
+      }
+      ++row_count;
+    }
+  }
+  ASSERT_EQ(1000, row_count);
+  ASSERT_TRUE(batch.is_end());
+  ASSERT_EQ(OB_ITER_END, input.get_next_batch(batch));
+  ASSERT_EQ(OB_SUCCESS, input.close());
+}
+
+TEST_F(ObRowBatchTest, compact_rows)
+{
+  test::ObFakeTable input;
+  input.set_row_count(1000);
+  ASSERT_EQ(OB_SUCCESS, input.open());
+  const ObRowDesc *row_desc = NULL;
+  ASSERT_EQ(OB_SUCCESS, input.get_row_desc(row_desc));
+  ObRowStore store;
+  const ObRow *row = NULL;
+  int64_t cur_size = 0;
+  while (OB_SUCCESS == input.get_next_row(row))
+  {
+    ASSERT_EQ(OB_SUCCESS, store.add_row(*row, cur_size));
+  }
+  ObRowBatch batch;
+  ASSERT_EQ(OB_SUCCESS, batch.init(*row_desc));
+  ObString compact_rows[ObRowBatch::DEFAULT_BATCH_SIZE];
+  ObRow store_row;
+  store_row.set_row_desc(*row_desc);
+  ObString str;
+  ObString store_str;
+  const ObObj *cell = NULL;
+  int64_t i64 = 0;
+  int64_t row_count = 0;
+  int ret = OB_SUCCESS;
+  while (OB_SUCCESS == ret)
+  {
+    batch.reuse();
+    while (!batch.is_full()
+           && OB_SUCCESS == (ret = store.get_next_compact_row(compact_rows[batch.get_row_count()])))
+    {
+      ASSERT_EQ(OB_SUCCESS, batch.add_compact_row(compact_rows[batch.get_row_count()]));
+    }
+    const ObObj *c0 = batch.get_column(0);
+    const ObObj *c1 = batch.get_column(1);
+    for (int64_t i = 0; i < batch.get_row_count(); ++i)
+    {
+      ASSERT_EQ(OB_SUCCESS, c1[batch.get_selection()[i]].get_int(i64));
+      ASSERT_EQ(row_count, i64);
+      // the same cells as the row path, varchars point into the row store
+      ASSERT_EQ(OB_SUCCESS, ObRowUtil::convert(compact_rows[i], store_row));
+      ASSERT_EQ(OB_SUCCESS, store_row.get_cell(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID, cell));
+      ASSERT_EQ(OB_SUCCESS, cell->get_varchar(store_str));
+      ASSERT_EQ(OB_SUCCESS, c0[batch.get_selection()[i]].get_varchar(str));
+      ASSERT_TRUE(str == store_str);
+      ASSERT_EQ(store_str.ptr(), str.ptr());
+      ++row_count;
+    }
+  }
+  ASSERT_EQ(OB_ITER_END, ret);
+  ASSERT_EQ(1000, row_count);
+  ASSERT_EQ(OB_SUCCESS, input.close());
+}
+
+TEST_F(ObRowBatchTest, row_children)
+{
+  test::ObFakeTable input;
+  input.set_row_count(1000);
+  ObFilter filter;
+  ObProject project;
+  ObLimit limit;
+  gen_filter(filter);
+  gen_project(project);
+  gen_limit(limit, 300, 5);
+  ASSERT_EQ(OB_SUCCESS, filter.set_child(0, input));
+  ASSERT_EQ(OB_SUCCESS, project.set_child(0, filter));
+  ASSERT_EQ(OB_SUCCESS, limit.set_child(0, project));
+  // rows of a row child are not copied into batches
+  ASSERT_FALSE(filter.is_batch_native());
+  ASSERT_FALSE(project.is_batch_native());
+  ASSERT_FALSE(limit.is_batch_native());
+  ASSERT_EQ(OB_SUCCESS, limit.open());
+  const ObRow *row = NULL;
+  const ObObj *cell = NULL;
+  int64_t i64 = 0;
+  for (int64_t i = 0; i < 300; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, limit.get_next_row(row));
+    ASSERT_EQ(OB_SUCCESS, row->get_cell(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+1, cell));
+    ASSERT_EQ(OB_SUCCESS, cell->get_int(i64));
+    ASSERT_EQ(2 * (i + 5) + 1, i64);
+  }
+  ASSERT_EQ(OB_ITER_END, limit.get_next_row(row));
+  ASSERT_EQ(OB_SUCCESS, limit.close());
+}
+
+TEST_F(ObRowBatchTest, filter_project_limit)
+{
+  BatchFakeTable input;
+  input.set_row_count(1000);
+  ObFilter filter;
+  ObProject project;
+  ObLimit limit;
+  gen_filter(filter);
+  gen_project(project);
+  gen_limit(limit, 300, 5);
+  ASSERT_EQ(OB_SUCCESS, filter.set_child(0, input));
+  ASSERT_EQ(OB_SUCCESS, project.set_child(0, filter));
+  ASSERT_EQ(OB_SUCCESS, limit.set_child(0, project));
+  ASSERT_TRUE(limit.is_batch_native());
+  // the rows are read by batches from filter up to limit
+  ASSERT_EQ(OB_SUCCESS, limit.open());
+  const ObRow *row = NULL;
+  const ObObj *cell = NULL;
+  int64_t i64 = 0;
+  int64_t row_idx = 0;
+  for (int64_t i = 0; i < 300; ++i)
+  {
+    row_idx = 2 * (i + 5) + 1;
+    ASSERT_EQ(OB_SUCCESS, limit.get_next_row(row));
+    ASSERT_EQ(3, row->get_column_num());
+    ASSERT_EQ(OB_SUCCESS, row->get_cell(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+1, cell));
+    ASSERT_EQ(OB_SUCCESS, cell->get_int(i64));
+    ASSERT_EQ(row_idx, i64);
+    ASSERT_EQ(OB_SUCCESS, row->get_cell(test::ObFakeTable::TABLE_ID, NEW_CID, cell));
+    ASSERT_EQ(OB_SUCCESS, cell->get_int(i64));
+    ASSERT_EQ(row_idx + 1, i64);
+  }
+  ASSERT_EQ(OB_ITER_END, limit.get_next_row(row));
+  ASSERT_EQ(OB_ITER_END, limit.get_next_row(row));
+  ASSERT_EQ(OB_SUCCESS, limit.close());
+
+  // get_next_batch of limit, the odd rows after offset 5 are all returned
+  gen_limit(limit, -1, 5);
+  ASSERT_EQ(OB_SUCCESS, limit.open());
+  const ObRowDesc *row_desc = NULL;
+  ASSERT_EQ(OB_SUCCESS, limit.get_row_desc(row_desc));
+  ObRowBatch batch;
+  ASSERT_EQ(OB_SUCCESS, batch.init(*row_desc, 100));
+  int64_t row_count = 0;
+  while (OB_SUCCESS == limit.get_next_batch(batch))
+  {
+    ASSERT_TRUE(0 < batch.get_row_count());
+    for (int64_t i = 0; i < batch.get_row_count(); ++i)
+    {
+      ASSERT_EQ(OB_SUCCESS, batch.get_column(1)[batch.get_selection()[i]].get_int(i64));
+      ASSERT_EQ(2 * (row_count + 5) + 1, i64);
+      ++row_count;
+    }
+  }
+  ASSERT_EQ(495, row_count);
+  ASSERT_EQ(OB_SUCCESS, limit.close());
+}
+
+TEST_F(ObRowBatchTest, scalar_aggregate)
+{
+  BatchFakeTable input;
+  input.set_row_count(1000);
+  ObFilter filter;
+  ObScalarAggregate aggr;
+  gen_filter(filter);
+  // sum(c1)
+  ObSqlExpression expr;
+  expr.set_aggr_func(T_FUN_SUM, false);
+  expr.set_tid_cid(OB_INVALID_ID, NEW_CID);
+  ExprItem item;
+  item.type_ = T_REF_COLUMN;
+  item.value_.cell_.tid = test::ObFakeTable::TABLE_ID;
+  item.value_.cell_.cid = OB_APP_MIN_COLUMN_ID+1;
+  ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+  ASSERT_EQ(OB_SUCCESS, expr.add_expr_item_end());
+  ASSERT_EQ(OB_SUCCESS, aggr.add_aggr_column(expr));
+  ASSERT_EQ(OB_SUCCESS, filter.set_child(0, input));
+  ASSERT_EQ(OB_SUCCESS, aggr.set_child(0, filter));
+  // the input of the aggregation is read by batches
+  ASSERT_EQ(OB_SUCCESS, aggr.open());
+  const ObRowDesc *row_desc = NULL;
+  ASSERT_EQ(OB_SUCCESS, aggr.get_row_desc(row_desc));
+  ObRowBatch batch;
+  ASSERT_EQ(OB_SUCCESS, batch.init(*row_desc));
+  ASSERT_EQ(OB_SUCCESS, aggr.get_next_batch(batch));
+  ASSERT_EQ(1, batch.get_row_count());
+  ObRow row;
+  const ObObj *cell = NULL;
+  int64_t i64 = 0;
+  ASSERT_EQ(OB_SUCCESS, batch.get_row(0, row));
+  ASSERT_EQ(OB_SUCCESS, row.get_cell(OB_INVALID_ID, NEW_CID, cell));
+  ASSERT_EQ(OB_SUCCESS, cell->get_int(i64));
+  ASSERT_EQ(250000, i64);
+  ASSERT_EQ(OB_ITER_END, aggr.get_next_batch(batch));
+  ASSERT_EQ(OB_SUCCESS, aggr.close());
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
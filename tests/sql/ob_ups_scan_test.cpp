@@ -113,6 +113,158 @@ TEST_F(ObUpsScanTest, basic_test)
   OK(ups_scan.close());
 }
 
+// 用普通扫描模拟UPS保留的扫描流, 每fail_interval次续读失败一次
+class ObFakeStreamUpsRpcProxy : public ObFakeSqlUpsRpcProxy2
+{
+  public:
+    ObFakeStreamUpsRpcProxy(const int64_t fail_interval)
+      : scan_param_(NULL), fail_interval_(fail_interval),
+        open_count_(0), next_count_(0), end_count_(0)
+    {
+    }
+    int sql_ups_stream_scan(const ObScanParam & scan_param, ObNewScanner & new_scanner,
+        ObUpsScanSession & session, const int64_t timeout)
+    {
+      int ret = OB_SUCCESS;
+      bool is_fullfilled = false;
+      int64_t fullfilled_row_num = 0;
+      scan_param_ = &scan_param;
+      open_count_++;
+      session.reset();
+      if (OB_SUCCESS == (ret = sql_ups_scan(scan_param, new_scanner, timeout))
+          && OB_SUCCESS == (ret = new_scanner.get_is_req_fullfilled(is_fullfilled, fullfilled_row_num))
+          && !is_fullfilled)
+      {
+        session.session_id_ = open_count_;
+      }
+      return ret;
+    }
+    int sql_ups_stream_next(const ObUpsScanSession & session, ObNewScanner & new_scanner, const int64_t timeout)
+    {
+      int ret = OB_SUCCESS;
+      ObRowkey last_rowkey;
+      ObNewRange range = *scan_param_->get_range();
+      ObScanParam scan_param;
+      ObString table_name;
+      next_count_++;
+      if (open_count_ != session.session_id_)
+      {
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else if (0 == next_count_ % fail_interval_)
+      {
+        // 续读失败前scanner已经被清空
+        new_scanner.clear();
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else if (OB_SUCCESS != (ret = new_scanner.get_last_row_key(last_rowkey))
+              || OB_SUCCESS != (ret = rowkey_buf_.write_string(last_rowkey, &range.start_key_)))
+      {
+        TBSYS_LOG(WARN, "get last rowkey fail:ret[%d]", ret);
+      }
+      else
+      {
+        range.border_flag_.unset_inclusive_start();
+        scan_param.set(TABLE_ID, table_name, range);
+        ret = sql_ups_scan(scan_param, new_scanner, timeout);
+      }
+      return ret;
+    }
+    void sql_ups_stream_end(const ObUpsScanSession & session)
+    {
+      UNUSED(session);
+      end_count_++;
+    }
+  public:
+    const ObScanParam *scan_param_;
+    ObStringBuf rowkey_buf_;
+    int64_t fail_interval_;
+    int64_t open_count_;
+    int64_t next_count_;
+    int64_t end_count_;
+};
+
+TEST_F(ObUpsScanTest, stream_test)
+{
+  ObUpsScan ups_scan;
+  ObFakeStreamUpsRpcProxy rpc_proxy(3);
+  CharArena arena;
+
+  OK(ups_scan.set_ups_rpc_proxy(&rpc_proxy));
+
+  const ObRow *ups_row = NULL;
+  const ObObj *cell = NULL;
+  uint64_t table_id = OB_INVALID_ID;
+  uint64_t column_id = OB_INVALID_ID;
+  int64_t int_value = 0;
+  const ObRowkey *rowkey = NULL;
+
+  int start = 12;
+  int end = 1000;
+
+  ObNewRange range;
+  range.table_id_ = TABLE_ID;
+  gen_new_range(start, end, arena, range);
+  range.border_flag_.unset_inclusive_start();
+  range.border_flag_.unset_inclusive_end();
+
+  ups_scan.set_network_timeout(1000 * 1000);
+  ups_scan.set_range(range);
+  for(uint64_t i = 0;i<COLUMN_NUMS;i++)
+  {
+    OK(ups_scan.add_column(i + OB_APP_MIN_COLUMN_ID));
+  }
+
+  OK(ups_scan.open());
+  for(int i=start + 1;i<=end - 1;i++)
+  {
+    OK(ups_scan.get_next_row(rowkey, ups_row));
+    OK(ups_row->raw_get_cell(0, cell, table_id, column_id));
+    cell->get_int(int_value);
+    ASSERT_EQ(i * 1000, int_value);
+  }
+  ASSERT_EQ(OB_ITER_END, ups_scan.get_next_row(rowkey, ups_row));
+  OK(ups_scan.close());
+
+  // 每页100行, 每3次续读失败一次并从last rowkey重新扫描
+  ASSERT_LT(1, rpc_proxy.open_count_);
+  ASSERT_LT(rpc_proxy.open_count_, rpc_proxy.next_count_);
+  ASSERT_EQ(0, rpc_proxy.end_count_);
+}
+
+TEST_F(ObUpsScanTest, stream_close_early_test)
+{
+  ObUpsScan ups_scan;
+  ObFakeStreamUpsRpcProxy rpc_proxy(100);
+  CharArena arena;
+
+  OK(ups_scan.set_ups_rpc_proxy(&rpc_proxy));
+
+  const ObRow *ups_row = NULL;
+  const ObRowkey *rowkey = NULL;
+
+  ObNewRange range;
+  range.table_id_ = TABLE_ID;
+  gen_new_range(12, 1000, arena, range);
+
+  ups_scan.set_network_timeout(1000 * 1000);
+  ups_scan.set_range(range);
+  for(uint64_t i = 0;i<COLUMN_NUMS;i++)
+  {
+    OK(ups_scan.add_column(i + OB_APP_MIN_COLUMN_ID));
+  }
+
+  OK(ups_scan.open());
+  for(int i=0;i<150;i++)
+  {
+    OK(ups_scan.get_next_row(rowkey, ups_row));
+  }
+  OK(ups_scan.close());
+  ASSERT_EQ(1, rpc_proxy.open_count_);
+  ASSERT_EQ(1, rpc_proxy.next_count_);
+  ASSERT_EQ(1, rpc_proxy.end_count_);
+}
+
 int main(int argc, char **argv)
 {
   ob_init_memory_pool();
@@ -0,0 +1,58 @@
+#include "common/ob_malloc.h"
+#include "updateserver/ob_group_commit.h"
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace updateserver;
+using namespace common;
+
+static const int64_t MAX_BATCH = 500;
+static const int64_t MAX_WAIT = 1000;
+
+TEST(TestGroupCommitWindow, no_stat)
+{
+  GroupCommitWindow window;
+  EXPECT_EQ(0, window.calc_wait_time(1, MAX_BATCH, MAX_WAIT));
+  window.on_arrive(100);
+  EXPECT_EQ(0, window.calc_wait_time(1, MAX_BATCH, MAX_WAIT));
+}
+
+TEST(TestGroupCommitWindow, low_load)
+{
+  GroupCommitWindow window;
+  // 每10ms到达一个事务, fsync耗时1ms, 不应该等待
+  for (int64_t i = 1; i <= 100; i++)
+  {
+    window.on_arrive(i * 10000);
+    window.on_flush(1, 1000);
+  }
+  EXPECT_EQ(0, window.calc_wait_time(1, MAX_BATCH, MAX_WAIT));
+}
+
+TEST(TestGroupCommitWindow, high_load)
+{
+  GroupCommitWindow window;
+  // 每10us到达一个事务, fsync耗时500us
+  for (int64_t i = 1; i <= 100; i++)
+  {
+    window.on_arrive(i * 10);
+    window.on_flush(50, 500);
+  }
+  EXPECT_EQ(10, window.get_avg_arrive_interval());
+  EXPECT_EQ(500, window.get_avg_flush_time());
+  EXPECT_EQ(50, window.get_avg_batch_size());
+  EXPECT_EQ(500, window.calc_wait_time(1, MAX_BATCH, MAX_WAIT));
+  EXPECT_EQ(200, window.calc_wait_time(1, MAX_BATCH, 200));
+  EXPECT_EQ(100, window.calc_wait_time(MAX_BATCH - 10, MAX_BATCH, MAX_WAIT));
+  EXPECT_EQ(0, window.calc_wait_time(MAX_BATCH, MAX_BATCH, MAX_WAIT));
+  EXPECT_EQ(0, window.calc_wait_time(1, MAX_BATCH, 0));
+  window.reset();
+  EXPECT_EQ(0, window.calc_wait_time(1, MAX_BATCH, MAX_WAIT));
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "common/ob_malloc.h"
+#include "updateserver/ob_ups_utils.h"
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace common;
+using namespace updateserver;
+
+TEST(TestIOSpeedLimiter, unlimited)
+{
+  IOSpeedLimiter limiter;
+  limiter.reset(0, 0);
+  int64_t timeu = tbsys::CTimeUtil::getTime();
+  for (int64_t i = 0; i < 1000; i++)
+  {
+    EXPECT_EQ(0, limiter.acquire(1L<<20));
+  }
+  EXPECT_GT(100000, tbsys::CTimeUtil::getTime() - timeu);
+  EXPECT_EQ(0, limiter.get_total_sleep_time());
+}
+
+TEST(TestIOSpeedLimiter, limited)
+{
+  // 1MB/s, 突发100KB, 写入600KB至少需要0.5秒
+  const int64_t rate = 1L<<20;
+  IOSpeedLimiter limiter;
+  limiter.reset(rate, rate / 10);
+  int64_t timeu = tbsys::CTimeUtil::getTime();
+  for (int64_t i = 0; i < 600; i++)
+  {
+    limiter.acquire(1024);
+  }
+  timeu = tbsys::CTimeUtil::getTime() - timeu;
+  TBSYS_LOG(INFO, "timeu=%ld total_sleep_time=%ld", timeu, limiter.get_total_sleep_time());
+  EXPECT_LE(400000, timeu);
+  EXPECT_GT(2000000, timeu);
+  EXPECT_LT(0, limiter.get_total_sleep_time());
+}
+
+TEST(TestIOSpeedLimiter, large_acquire)
+{
+  // 单次申请超过burst时透支, 按透支量睡眠而不是一直等待
+  const int64_t rate = 1L<<20;
+  IOSpeedLimiter limiter;
+  limiter.reset(rate, rate / 10);
+  int64_t timeu = tbsys::CTimeUtil::getTime();
+  limiter.acquire(rate / 2);
+  timeu = tbsys::CTimeUtil::getTime() - timeu;
+  EXPECT_LE(300000, timeu);
+  EXPECT_GT(2000000, timeu);
+}
+
+TEST(TestIOSpeedLimiter, reset_keep_sleep_time)
+{
+  // 配置变化时重新设置限速, 之前累计的睡眠时间要保留
+  const int64_t rate = 1L<<20;
+  IOSpeedLimiter limiter;
+  limiter.reset(rate, rate / 10);
+  limiter.acquire(rate / 4);
+  int64_t total_sleep_time = limiter.get_total_sleep_time();
+  EXPECT_LT(0, total_sleep_time);
+  limiter.reset(rate * 2, rate / 5);
+  EXPECT_EQ(total_sleep_time, limiter.get_total_sleep_time());
+  total_sleep_time += limiter.acquire(rate / 2);
+  EXPECT_EQ(total_sleep_time, limiter.get_total_sleep_time());
+  limiter.reset(0, 0);
+  EXPECT_EQ(0, limiter.acquire(rate));
+  EXPECT_EQ(total_sleep_time, limiter.get_total_sleep_time());
+}
+
+int main(int argc, char **argv)
+{
+  TBSYS_LOGGER.setLogLevel("info");
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
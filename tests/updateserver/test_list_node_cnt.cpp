@@ -0,0 +1,69 @@
+#include "common/ob_malloc.h"
+#include "updateserver/ob_table_engine.h"
+#include "updateserver/ob_sessionctx_factory.h"
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace common;
+using namespace updateserver;
+
+// 模拟有长读事务时热点行一直合并不了, 每个事务提交时把未提交的节点数加到行上
+static void commit(TEValue &value, TEValueUCInfo &uci)
+{
+  value.list_node_cnt = add_list_node_cnt(value.list_node_cnt, uci.uc_list_node_cnt);
+  uci.reset();
+}
+
+TEST(TestListNodeCnt, saturate_on_commit)
+{
+  TEValue value;
+  TEValueUCInfo uci;
+  int64_t node_num = 0;
+  for (int64_t i = 0; i < 3 * MAX_LIST_NODE_CNT; i++)
+  {
+    for (int64_t j = 0; j <= i % 3; j++)
+    {
+      uci.uc_list_node_cnt = add_list_node_cnt(uci.uc_list_node_cnt, 1);
+      node_num++;
+    }
+    commit(value, uci);
+    if (node_num < MAX_LIST_NODE_CNT)
+    {
+      ASSERT_EQ(node_num, value.list_node_cnt);
+    }
+    else
+    {
+      // 超过上限后不能回绕成负数, 否则行上的节点链再也不会触发合并
+      ASSERT_EQ(MAX_LIST_NODE_CNT, value.list_node_cnt);
+    }
+  }
+  EXPECT_LT(INT16_MAX, node_num);
+  EXPECT_LT(32, value.list_node_cnt);
+}
+
+TEST(TestListNodeCnt, saturate_in_one_trans)
+{
+  TEValue value;
+  TEValueUCInfo uci;
+  value.list_node_cnt = 100;
+  for (int64_t i = 0; i < MAX_LIST_NODE_CNT + 100; i++)
+  {
+    uci.uc_list_node_cnt = add_list_node_cnt(uci.uc_list_node_cnt, 1);
+    ASSERT_LT(0, uci.uc_list_node_cnt);
+  }
+  EXPECT_EQ(MAX_LIST_NODE_CNT, uci.uc_list_node_cnt);
+  commit(value, uci);
+  EXPECT_EQ(MAX_LIST_NODE_CNT, value.list_node_cnt);
+
+  // 合并后重新计数
+  value.list_node_cnt = 1;
+  value.list_node_cnt = add_list_node_cnt(value.list_node_cnt, 1);
+  EXPECT_EQ(2, value.list_node_cnt);
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -33,6 +33,31 @@ namespace oceanbase
       
     };
 
+    class IndexedLogDataWriter: public ObLogDataWriter
+    {
+      public:
+        using ObLogDataWriter::prepare_fd;
+        using ObLogDataWriter::reuse;
+    };
+
+    static bool file_exist(const char* dir, const char* name)
+    {
+      char path[OB_MAX_FILE_NAME_LENGTH];
+      snprintf(path, sizeof(path), "%s/%s", dir, name);
+      return 0 == access(path, F_OK);
+    }
+
+    static void touch_file(const char* dir, const char* name)
+    {
+      char path[OB_MAX_FILE_NAME_LENGTH];
+      int fd = -1;
+      snprintf(path, sizeof(path), "%s/%s", dir, name);
+      fd = open(path, O_WRONLY | O_CREAT, 0644);
+      ASSERT_TRUE(fd >= 0);
+      ASSERT_EQ(1, write(fd, "x", 1));
+      close(fd);
+    }
+
     class ObLogDataWriterTest: public ::testing::Test, public Config {
       public:
         ObLogDataWriterTest(){}
@@ -55,6 +80,44 @@ namespace oceanbase
       ASSERT_EQ(OB_SUCCESS, writer.init(log_dir, file_size, du_percent, 0, NULL));
       ASSERT_EQ(OB_INIT_TWICE, writer.init(log_dir, file_size, du_percent, 0, NULL));
     }
+    TEST_F(ObLogDataWriterTest, remove_index)
+    {
+      const char* dir = "log_dir_index";
+      char pool_file[OB_MAX_FILE_NAME_LENGTH];
+      char fname[OB_MAX_FILE_NAME_LENGTH];
+      int fd = -1;
+      IndexedLogDataWriter writer;
+      ASSERT_EQ(0, system("rm -rf log_dir_index && mkdir -p log_dir_index"));
+      ASSERT_EQ(OB_SUCCESS, writer.init(dir, file_size, du_percent, 0, NULL));
+      snprintf(pool_file, sizeof(pool_file), "%s/3", dir);
+      snprintf(fname, sizeof(fname), "%s/5", dir);
+
+      // recycled log file takes a new file id, both stale indexes are removed
+      touch_file(dir, "3");
+      touch_file(dir, "3.index");
+      touch_file(dir, "3.index.tmp");
+      touch_file(dir, "5.index");
+      fd = writer.reuse(pool_file, fname);
+      ASSERT_TRUE(fd >= 0);
+      close(fd);
+      ASSERT_FALSE(file_exist(dir, "3"));
+      ASSERT_FALSE(file_exist(dir, "3.index"));
+      ASSERT_FALSE(file_exist(dir, "3.index.tmp"));
+      ASSERT_TRUE(file_exist(dir, "5"));
+      ASSERT_FALSE(file_exist(dir, "5.index"));
+
+      // log file created again after it was removed
+      touch_file(dir, "7.index");
+      ASSERT_EQ(OB_SUCCESS, writer.prepare_fd(7));
+      ASSERT_TRUE(file_exist(dir, "7"));
+      ASSERT_FALSE(file_exist(dir, "7.index"));
+
+      // index of an existing log file is kept
+      touch_file(dir, "5.index");
+      ASSERT_EQ(OB_SUCCESS, writer.prepare_fd(5));
+      ASSERT_TRUE(file_exist(dir, "5.index"));
+    }
+
     TEST_F(ObLogDataWriterTest, select)
     {
       // ObLogDataWriter writer;
@@ -0,0 +1,355 @@
+#include "common/ob_malloc.h"
+#include "common/ob_mutator.h"
+#include "updateserver/ob_ups_mutator.h"
+#include "updateserver/ob_ups_log_utils.h"
+#include "updateserver/ob_log_replay_worker.h"
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace updateserver;
+using namespace common;
+
+static const uint64_t TABLE_ID = 1001;
+static const uint64_t COLUMN_ID = 16;
+static const int64_t HOT_ROW = 0;
+static const int64_t ROW_NUM = 9;
+static const int64_t LOG_NUM = 256;
+
+// 记录每一行最后apply的日志和值, 检查同一行上的日志是否按顺序apply
+class RowOrderApplier : public IAsyncLogApplier
+{
+  public:
+    RowOrderApplier() : out_of_order_(0)
+    {
+      memset(last_log_id_, 0, sizeof(last_log_id_));
+      memset(value_, 0, sizeof(value_));
+      pthread_mutex_init(&mutex_, NULL);
+    }
+    virtual ~RowOrderApplier()
+    {
+      pthread_mutex_destroy(&mutex_);
+    }
+  public:
+    virtual int on_submit(ObLogTask& log_task) { UNUSED(log_task); return OB_SUCCESS; }
+    virtual int start_transaction(ObLogTask& log_task) { UNUSED(log_task); return OB_SUCCESS; }
+    virtual int end_transaction(ObLogTask& log_task) { UNUSED(log_task); return OB_SUCCESS; }
+    virtual int flush(ObLogTask& log_task) { UNUSED(log_task); return OB_SUCCESS; }
+    virtual int on_destroy(ObLogTask& log_task) { UNUSED(log_task); return OB_SUCCESS; }
+    virtual int apply(ObLogTask& task)
+    {
+      int err = OB_SUCCESS;
+      ObUpsMutator mutator;
+      ObMutatorCellInfo* cell = NULL;
+      bool is_row_changed = false;
+      bool is_row_finished = false;
+      int64_t pos = 0;
+      int64_t row = 0;
+      int64_t value = 0;
+      if (OB_SUCCESS != (err = mutator.deserialize(task.log_data_, task.log_entry_.get_log_data_len(), pos)))
+      {
+        TBSYS_LOG(ERROR, "mutator.deserialize(log_id=%ld)=>%d", task.log_id_, err);
+      }
+      else
+      {
+        mutator.get_mutator().reset_iter();
+      }
+      while (OB_SUCCESS == err
+             && OB_SUCCESS == (err = mutator.get_mutator().next_cell()))
+      {
+        if (OB_SUCCESS != (err = mutator.get_mutator().get_cell(&cell, &is_row_changed, &is_row_finished)))
+        {
+          TBSYS_LOG(ERROR, "get_cell()=>%d", err);
+        }
+        else if (OB_SUCCESS != (err = cell->cell_info.row_key_.get_obj_ptr()[0].get_int(row))
+                 || OB_SUCCESS != (err = cell->cell_info.value_.get_int(value)))
+        {
+          TBSYS_LOG(ERROR, "get_int()=>%d", err);
+        }
+        else
+        {
+          // 不同日志apply的快慢不同, 没有按行排序时后面的日志可能先写
+          usleep(static_cast<useconds_t>((task.log_id_ * 7919) % 500));
+          pthread_mutex_lock(&mutex_);
+          if (last_log_id_[row] > task.log_id_)
+          {
+            out_of_order_++;
+          }
+          last_log_id_[row] = task.log_id_;
+          value_[row] = value;
+          pthread_mutex_unlock(&mutex_);
+        }
+      }
+      if (OB_ITER_END == err)
+      {
+        err = OB_SUCCESS;
+      }
+      return err;
+    }
+  public:
+    pthread_mutex_t mutex_;
+    int64_t out_of_order_;
+    int64_t last_log_id_[ROW_NUM];
+    int64_t value_[ROW_NUM];
+};
+
+static int update_row(ObMutator& mutator, const int64_t row, const int64_t value)
+{
+  ObObj key_obj;
+  ObObj value_obj;
+  key_obj.set_int(row);
+  value_obj.set_int(value);
+  return mutator.update(TABLE_ID, ObRowkey(&key_obj, 1), COLUMN_ID, value_obj);
+}
+
+// 第i条日志修改热点行和第i % 8 + 1行, 单数日志的第一行是热点行, 双数日志的第一行是另一行,
+// 修改热点行的日志会分发到不同的apply线程
+static int gen_logs(char* buf, const int64_t len, int64_t& pos)
+{
+  int err = OB_SUCCESS;
+  char data[1024];
+  for (int64_t log_id = 1; OB_SUCCESS == err && log_id <= LOG_NUM; log_id++)
+  {
+    ObUpsMutator mutator;
+    int64_t data_len = 0;
+    int64_t other_row = log_id % (ROW_NUM - 1) + 1;
+    if (1 == log_id % 2)
+    {
+      err = update_row(mutator.get_mutator(), HOT_ROW, log_id);
+      err = (OB_SUCCESS == err) ? update_row(mutator.get_mutator(), other_row, log_id) : err;
+    }
+    else
+    {
+      err = update_row(mutator.get_mutator(), other_row, log_id);
+      err = (OB_SUCCESS == err) ? update_row(mutator.get_mutator(), HOT_ROW, log_id) : err;
+    }
+    mutator.set_mutate_timestamp(log_id);
+    if (OB_SUCCESS != err)
+    {
+      TBSYS_LOG(ERROR, "update_row(log_id=%ld)=>%d", log_id, err);
+    }
+    else if (OB_SUCCESS != (err = mutator.serialize(data, sizeof(data), data_len)))
+    {
+      TBSYS_LOG(ERROR, "mutator.serialize(log_id=%ld)=>%d", log_id, err);
+    }
+    else if (OB_SUCCESS != (err = serialize_log_entry(buf, len, pos, OB_LOG_UPS_MUTATOR, log_id, data, data_len)))
+    {
+      TBSYS_LOG(ERROR, "serialize_log_entry(log_id=%ld)=>%d", log_id, err);
+    }
+  }
+  return err;
+}
+
+TEST(TestLogReplayByRow, interleaved_rows)
+{
+  static char buf[1<<20];
+  int64_t len = 0;
+  int64_t task_id = 0;
+  ObLogCursor cursor;
+  RowOrderApplier applier;
+  ObLogReplayWorker worker;
+  cursor.file_id_ = 1;
+  cursor.log_id_ = 1;
+  cursor.offset_ = 0;
+  ASSERT_EQ(OB_SUCCESS, gen_logs(buf, sizeof(buf), len));
+  ASSERT_EQ(OB_SUCCESS, worker.init(&applier, 4, 1<<22, 64, true));
+  ASSERT_EQ(OB_SUCCESS, worker.start_log(cursor));
+  worker.start();
+  ASSERT_EQ(OB_SUCCESS, worker.submit_batch(task_id, buf, len, RT_APPLY));
+  ASSERT_EQ(LOG_NUM, task_id);
+  ASSERT_EQ(OB_SUCCESS, worker.wait_task(LOG_NUM));
+  worker.stop();
+  worker.wait();
+
+  // 每一行的终态都是最后一条修改它的日志写的值
+  EXPECT_EQ(0, applier.out_of_order_);
+  EXPECT_EQ(LOG_NUM, applier.value_[HOT_ROW]);
+  for (int64_t row = 1; row < ROW_NUM; row++)
+  {
+    int64_t last_log_id = LOG_NUM;
+    while (last_log_id % (ROW_NUM - 1) + 1 != row)
+    {
+      last_log_id--;
+    }
+    EXPECT_EQ(last_log_id, applier.value_[row]);
+    EXPECT_EQ(last_log_id, applier.last_log_id_[row]);
+  }
+  EXPECT_EQ(LOG_NUM + 1, worker.get_replayed_log_id());
+}
+
+// 第1条日志提交时等待第2条日志apply, 两条日志修改同一行,
+// 第2条日志只需要等第1条日志apply完成, 不需要等它提交
+class CommitWaitApplier : public IAsyncLogApplier
+{
+  public:
+    static const int64_t COMMIT_WAIT_US = 5000000;
+  public:
+    CommitWaitApplier() : applied_num_(0), applied_before_commit_(false) {}
+    virtual ~CommitWaitApplier() {}
+  public:
+    virtual int on_submit(ObLogTask& log_task) { UNUSED(log_task); return OB_SUCCESS; }
+    virtual int start_transaction(ObLogTask& log_task) { UNUSED(log_task); return OB_SUCCESS; }
+    virtual int flush(ObLogTask& log_task) { UNUSED(log_task); return OB_SUCCESS; }
+    virtual int on_destroy(ObLogTask& log_task) { UNUSED(log_task); return OB_SUCCESS; }
+    virtual int apply(ObLogTask& log_task)
+    {
+      UNUSED(log_task);
+      __sync_fetch_and_add(&applied_num_, 1);
+      return OB_SUCCESS;
+    }
+    virtual int end_transaction(ObLogTask& log_task)
+    {
+      if (1 == log_task.log_id_)
+      {
+        int64_t end_time = tbsys::CTimeUtil::getTime() + COMMIT_WAIT_US;
+        while (applied_num_ < 2 && tbsys::CTimeUtil::getTime() < end_time)
+        {
+          usleep(100);
+        }
+        applied_before_commit_ = (applied_num_ >= 2);
+      }
+      return OB_SUCCESS;
+    }
+  public:
+    volatile int64_t applied_num_;
+    bool applied_before_commit_;
+};
+
+// apply和提交都有固定的耗时, 用来比较按行模式下的回放速度
+class CostApplier : public IAsyncLogApplier
+{
+  public:
+    CostApplier(const int64_t apply_us, const int64_t commit_us) : apply_us_(apply_us), commit_us_(commit_us) {}
+    virtual ~CostApplier() {}
+  public:
+    virtual int on_submit(ObLogTask& log_task) { UNUSED(log_task); return OB_SUCCESS; }
+    virtual int start_transaction(ObLogTask& log_task) { UNUSED(log_task); return OB_SUCCESS; }
+    virtual int flush(ObLogTask& log_task) { UNUSED(log_task); return OB_SUCCESS; }
+    virtual int on_destroy(ObLogTask& log_task) { UNUSED(log_task); return OB_SUCCESS; }
+    virtual int apply(ObLogTask& log_task)
+    {
+      UNUSED(log_task);
+      spin(apply_us_);
+      return OB_SUCCESS;
+    }
+    virtual int end_transaction(ObLogTask& log_task)
+    {
+      UNUSED(log_task);
+      spin(commit_us_);
+      return OB_SUCCESS;
+    }
+  private:
+    static void spin(const int64_t us)
+    {
+      int64_t end_time = tbsys::CTimeUtil::getTime() + us;
+      while (tbsys::CTimeUtil::getTime() < end_time)
+        ;
+    }
+  private:
+    int64_t apply_us_;
+    int64_t commit_us_;
+};
+
+// 每条日志都先修改热点行, 再修改row_per_log - 1个只属于它自己的行
+static int gen_hot_row_log(char* buf, const int64_t len, int64_t& pos, const int64_t log_id, const int64_t row_per_log)
+{
+  int err = OB_SUCCESS;
+  char data[1<<16];
+  int64_t data_len = 0;
+  ObUpsMutator mutator;
+  err = update_row(mutator.get_mutator(), HOT_ROW, log_id);
+  for (int64_t i = 1; OB_SUCCESS == err && i < row_per_log; i++)
+  {
+    err = update_row(mutator.get_mutator(), log_id * row_per_log + i, log_id);
+  }
+  mutator.set_mutate_timestamp(log_id);
+  if (OB_SUCCESS != err)
+  {
+    TBSYS_LOG(ERROR, "update_row(log_id=%ld)=>%d", log_id, err);
+  }
+  else if (OB_SUCCESS != (err = mutator.serialize(data, sizeof(data), data_len)))
+  {
+    TBSYS_LOG(ERROR, "mutator.serialize(log_id=%ld)=>%d", log_id, err);
+  }
+  else if (OB_SUCCESS != (err = serialize_log_entry(buf, len, pos, OB_LOG_UPS_MUTATOR, log_id, data, data_len)))
+  {
+    TBSYS_LOG(ERROR, "serialize_log_entry(log_id=%ld)=>%d", log_id, err);
+  }
+  return err;
+}
+
+TEST(TestLogReplayByRow, apply_before_commit)
+{
+  static char buf[1<<16];
+  int64_t len = 0;
+  int64_t task_id = 0;
+  ObLogCursor cursor;
+  CommitWaitApplier applier;
+  ObLogReplayWorker worker;
+  cursor.file_id_ = 1;
+  cursor.log_id_ = 1;
+  cursor.offset_ = 0;
+  ASSERT_EQ(OB_SUCCESS, gen_hot_row_log(buf, sizeof(buf), len, 1, 1));
+  ASSERT_EQ(OB_SUCCESS, gen_hot_row_log(buf, sizeof(buf), len, 2, 1));
+  ASSERT_EQ(OB_SUCCESS, worker.init(&applier, 4, 1<<22, 64, true));
+  ASSERT_EQ(OB_SUCCESS, worker.start_log(cursor));
+  worker.start();
+  ASSERT_EQ(OB_SUCCESS, worker.submit_batch(task_id, buf, len, RT_APPLY));
+  ASSERT_EQ(OB_SUCCESS, worker.wait_task(2));
+  worker.stop();
+  worker.wait();
+  EXPECT_TRUE(applier.applied_before_commit_);
+}
+
+// 所有日志都修改热点行, 按行模式下回放是一条依赖链, 链上每一步的耗时决定回放速度
+TEST(TestLogReplayByRow, hot_row_perf)
+{
+  const int64_t log_num = 2000;
+  const int64_t row_per_log = 32;
+  const int64_t batch_log_num = 64;
+  const int64_t buf_len = 1<<26;
+  int64_t batch_pos[log_num / batch_log_num + 2];
+  int64_t batch_num = 0;
+  int64_t len = 0;
+  int64_t task_id = 0;
+  char* buf = (char*)ob_malloc(buf_len, ObModIds::TEST);
+  ObLogCursor cursor;
+  CostApplier applier(20, 10);
+  ObLogReplayWorker worker;
+  cursor.file_id_ = 1;
+  cursor.log_id_ = 1;
+  cursor.offset_ = 0;
+  ASSERT_TRUE(NULL != buf);
+  batch_pos[batch_num++] = 0;
+  for (int64_t log_id = 1; log_id <= log_num; log_id++)
+  {
+    ASSERT_EQ(OB_SUCCESS, gen_hot_row_log(buf, buf_len, len, log_id, row_per_log));
+    if (0 == log_id % batch_log_num || log_num == log_id)
+    {
+      batch_pos[batch_num++] = len;
+    }
+  }
+  ASSERT_EQ(OB_SUCCESS, worker.init(&applier, 4, 1<<26, 1024, true));
+  ASSERT_EQ(OB_SUCCESS, worker.start_log(cursor));
+  worker.start();
+  int64_t start_time = tbsys::CTimeUtil::getTime();
+  for (int64_t i = 0; i + 1 < batch_num; i++)
+  {
+    ASSERT_EQ(OB_SUCCESS, worker.submit_batch(task_id, buf + batch_pos[i], batch_pos[i + 1] - batch_pos[i], RT_APPLY));
+  }
+  int64_t submit_timeu = tbsys::CTimeUtil::getTime() - start_time;
+  ASSERT_EQ(OB_SUCCESS, worker.wait_task(log_num));
+  int64_t replay_timeu = tbsys::CTimeUtil::getTime() - start_time;
+  worker.stop();
+  worker.wait();
+  EXPECT_EQ(log_num + 1, worker.get_replayed_log_id());
+  TBSYS_LOG(INFO, "[hot_row] log_num=%ld row_per_log=%ld submit_timeu=%ld replay_timeu=%ld log_per_sec=%ld",
+            log_num, row_per_log, submit_timeu, replay_timeu, log_num * 1000000 / replay_timeu);
+  ob_free(buf);
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
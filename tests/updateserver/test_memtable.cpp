@@ -565,6 +565,37 @@ TEST(TestMemTable, min_max_key_2row)
   mt.destroy();
 }
 
+TEST(TestMemTable, frozen_bloomfilter)
+{
+  MemTable mt;
+  PageArena<char> allocer;
+  ObUpsMutator ups_mutator;
+  ObMutator &mutator = ups_mutator.get_mutator();
+  ObMutator result;
+  MemTableTransDescriptor td;
+
+  EXPECT_EQ(OB_ERROR, mt.build_frozen_bloomfilter());
+  mt.init();
+  // 空表不构建
+  EXPECT_EQ(OB_SUCCESS, mt.build_frozen_bloomfilter());
+  EXPECT_FALSE(mt.has_frozen_bloomfilter());
+
+  read_cell_infos("test_cases/test_mt_set.ci.ini", "MT_SET_CI", allocer, mutator, result);
+  mt.start_transaction(WRITE_TRANSACTION, td);
+  mt.start_mutation(td);
+  EXPECT_EQ(OB_SUCCESS, mt.set(td, ups_mutator, false));
+  mt.end_mutation(td, false);
+  mt.end_transaction(td, false);
+
+  EXPECT_EQ(OB_SUCCESS, mt.build_frozen_bloomfilter());
+  EXPECT_TRUE(mt.has_frozen_bloomfilter());
+  EXPECT_EQ(OB_SUCCESS, mt.build_frozen_bloomfilter());
+  EXPECT_TRUE(mt.has_frozen_bloomfilter());
+
+  mt.destroy();
+  EXPECT_FALSE(mt.has_frozen_bloomfilter());
+}
+
 TEST(TestMemTable, total_empty)
 {
   MemTable mt;
@@ -181,6 +181,38 @@ namespace oceanbase
       }
       ASSERT_EQ(0, n_err);
     }
+
+    TEST_F(ObPosLogReaderTest, LocateByLogIndex){
+      ObOnDiskLogLocator scan_locator;
+      ObOnDiskLogLocator index_locator;
+      ObLogLocation scan_location;
+      ObLogLocation index_location;
+      ObLogFileIndex log_index;
+      int64_t n_err = 0;
+      ASSERT_EQ(OB_SUCCESS, write_log_to_end(log_writer, log_generator, max_num_items));
+      ASSERT_EQ(OB_SUCCESS, scan_locator.init(log_dir));
+      ASSERT_EQ(OB_SUCCESS, index_locator.init(log_dir));
+      scan_locator.set_enable_log_index(false);
+      // 第一轮建立索引, 第二轮从索引文件加载
+      for (int64_t round = 0; round < 2; round++)
+      {
+        for (int64_t i = 1; i < max_num_items; i += 1 + random() % 997)
+        {
+          err = scan_locator.get_location(i, scan_location);
+          if (err != index_locator.get_location(i, index_location)
+              || (OB_SUCCESS == err && (scan_location.file_id_ != index_location.file_id_
+                                        || scan_location.offset_ != index_location.offset_)))
+          {
+            TBSYS_LOG(ERROR, "location mismatch: log_id=%ld, scan=%ld:+%ld, index=%ld:+%ld",
+                      i, scan_location.file_id_, scan_location.offset_, index_location.file_id_, index_location.offset_);
+            n_err++;
+          }
+        }
+      }
+      ASSERT_EQ(0, n_err);
+      ASSERT_EQ(OB_SUCCESS, log_index.load(log_dir, 1));
+      ASSERT_LT(0, log_index.get_entry_num());
+    }
   } // end namespace updateserver
 } // end namespace oceanbase
 
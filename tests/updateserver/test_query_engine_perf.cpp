@@ -0,0 +1,327 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "common/ob_malloc.h"
+#include "updateserver/ob_query_engine.h"
+#include "updateserver/ob_ups_utils.h"
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace common;
+using namespace updateserver;
+
+static const int64_t HASH_SIZE = 1L<<20;
+static const int64_t THREAD_NUM = 8;
+
+struct KeySet
+{
+  int64_t num;
+  ObObj *objs;
+  TEKey *keys;
+  TEValue *values;
+  ObCellInfoNode dummy_node;
+  KeySet(const int64_t n) : num(n)
+  {
+    objs = new ObObj[n];
+    keys = new TEKey[n];
+    values = new TEValue[n];
+    // 打散插入顺序, 避免退化为顺序追加
+    for (int64_t i = 0; i < n; i++)
+    {
+      objs[i].set_int((i * 7919) % n);
+      keys[i].table_id = 1001;
+      keys[i].row_key.assign(&objs[i], 1);
+      values[i].list_head = &dummy_node;
+    }
+  };
+  ~KeySet()
+  {
+    delete[] objs;
+    delete[] keys;
+    delete[] values;
+  };
+};
+
+struct InsertParam
+{
+  QueryEngine *qe;
+  KeySet *ks;
+  int64_t thread_idx;
+};
+
+void *insert_thread(void *data)
+{
+  InsertParam *param = (InsertParam*)data;
+  for (int64_t i = param->thread_idx; i < param->ks->num; i += THREAD_NUM)
+  {
+    EXPECT_EQ(OB_SUCCESS, param->qe->set(param->ks->keys[i], &param->ks->values[i]));
+  }
+  return NULL;
+}
+
+void run_test(const bool using_skiplist, const int64_t num)
+{
+  g_conf.using_skiplist_index = using_skiplist;
+  MemTank mt;
+  QueryEngine qe(mt);
+  KeySet ks(num);
+  ASSERT_EQ(OB_SUCCESS, qe.init(HASH_SIZE));
+  ASSERT_EQ(using_skiplist, qe.using_skiplist());
+
+  pthread_t pd[THREAD_NUM];
+  InsertParam params[THREAD_NUM];
+  int64_t timeu = tbsys::CTimeUtil::getTime();
+  for (int64_t i = 0; i < THREAD_NUM; i++)
+  {
+    params[i].qe = &qe;
+    params[i].ks = &ks;
+    params[i].thread_idx = i;
+    pthread_create(&pd[i], NULL, insert_thread, &params[i]);
+  }
+  for (int64_t i = 0; i < THREAD_NUM; i++)
+  {
+    pthread_join(pd[i], NULL);
+  }
+  int64_t insert_timeu = tbsys::CTimeUtil::getTime() - timeu;
+  EXPECT_EQ(num, qe.btree_size());
+  EXPECT_EQ(OB_ENTRY_EXIST, qe.set(ks.keys[0], &ks.values[0]));
+
+  bool using_hash_index = g_conf.using_hash_index;
+  g_conf.using_hash_index = false;
+  timeu = tbsys::CTimeUtil::getTime();
+  for (int64_t i = 0; i < num; i++)
+  {
+    EXPECT_EQ(&ks.values[i], qe.get(ks.keys[i]));
+  }
+  int64_t get_timeu = tbsys::CTimeUtil::getTime() - timeu;
+  g_conf.using_hash_index = using_hash_index;
+
+  TEKey start_key;
+  TEKey end_key;
+  QueryEngineIterator iter;
+  int64_t count = 0;
+  int64_t prev = -1;
+  timeu = tbsys::CTimeUtil::getTime();
+  ASSERT_EQ(OB_SUCCESS, qe.scan(start_key, 1, 0, end_key, 1, 0, false, iter));
+  while (OB_SUCCESS == iter.next())
+  {
+    int64_t cur = 0;
+    iter.get_key().row_key.ptr()[0].get_int(cur);
+    EXPECT_LT(prev, cur);
+    prev = cur;
+    count++;
+  }
+  int64_t scan_timeu = tbsys::CTimeUtil::getTime() - timeu;
+  EXPECT_EQ(num, count);
+
+  // 全表反向扫描, 耗时应与正向扫描在同一量级
+  iter.reset();
+  count = 0;
+  prev = num;
+  timeu = tbsys::CTimeUtil::getTime();
+  ASSERT_EQ(OB_SUCCESS, qe.scan(start_key, 1, 0, end_key, 1, 0, true, iter));
+  while (OB_SUCCESS == iter.next())
+  {
+    int64_t cur = 0;
+    iter.get_key().row_key.ptr()[0].get_int(cur);
+    EXPECT_GT(prev, cur);
+    prev = cur;
+    count++;
+  }
+  int64_t reverse_scan_timeu = tbsys::CTimeUtil::getTime() - timeu;
+  EXPECT_EQ(num, count);
+
+  // [num/4, num/2) 反向扫描
+  ObObj start_obj;
+  ObObj end_obj;
+  start_obj.set_int(num / 4);
+  end_obj.set_int(num / 2);
+  start_key.table_id = 1001;
+  start_key.row_key.assign(&start_obj, 1);
+  end_key.table_id = 1001;
+  end_key.row_key.assign(&end_obj, 1);
+  iter.reset();
+  count = 0;
+  prev = num;
+  ASSERT_EQ(OB_SUCCESS, qe.scan(start_key, 0, 0, end_key, 0, 1, true, iter));
+  while (OB_SUCCESS == iter.next())
+  {
+    int64_t cur = 0;
+    iter.get_key().row_key.ptr()[0].get_int(cur);
+    EXPECT_GT(prev, cur);
+    prev = cur;
+    count++;
+  }
+  EXPECT_EQ(num / 2 - num / 4, count);
+
+  TBSYS_LOG(INFO, "[%s] num=%ld insert_timeu=%ld get_timeu=%ld scan_timeu=%ld reverse_scan_timeu=%ld alloc_memory=%ld",
+            using_skiplist ? "SKIPLIST" : "BTREE", num, insert_timeu, get_timeu, scan_timeu, reverse_scan_timeu,
+            qe.btree_alloc_memory());
+  qe.destroy();
+}
+
+TEST(TestQueryEnginePerf, btree)
+{
+  run_test(false, 1000);
+  run_test(false, 100000);
+}
+
+TEST(TestQueryEnginePerf, skiplist)
+{
+  run_test(true, 1000);
+  run_test(true, 100000);
+}
+
+struct ConcurrentInsertParam
+{
+  QueryEngine *qe;
+  KeySet *ks;
+  int64_t thread_idx;
+  volatile int64_t *finished;
+};
+
+void *concurrent_insert_thread(void *data)
+{
+  ConcurrentInsertParam *param = (ConcurrentInsertParam*)data;
+  for (int64_t i = param->thread_idx; i < param->ks->num; i += THREAD_NUM)
+  {
+    EXPECT_EQ(OB_SUCCESS, param->qe->set(param->ks->keys[i], &param->ks->values[i]));
+  }
+  __sync_fetch_and_add(param->finished, 1);
+  return NULL;
+}
+
+TEST(TestQueryEnginePerf, skiplist_reverse_scan_with_insert)
+{
+  g_conf.using_skiplist_index = true;
+  const int64_t num = 100000;
+  MemTank mt;
+  QueryEngine qe(mt);
+  KeySet even(num);
+  KeySet odd(num);
+  for (int64_t i = 0; i < num; i++)
+  {
+    even.objs[i].set_int(2 * ((i * 7919) % num));
+    odd.objs[i].set_int(2 * ((i * 7919) % num) + 1);
+  }
+  ASSERT_EQ(OB_SUCCESS, qe.init(HASH_SIZE));
+  for (int64_t i = 0; i < num; i++)
+  {
+    ASSERT_EQ(OB_SUCCESS, qe.set(even.keys[i], &even.values[i]));
+  }
+
+  pthread_t pd[THREAD_NUM];
+  ConcurrentInsertParam params[THREAD_NUM];
+  volatile int64_t finished = 0;
+  for (int64_t i = 0; i < THREAD_NUM; i++)
+  {
+    params[i].qe = &qe;
+    params[i].ks = &odd;
+    params[i].thread_idx = i;
+    params[i].finished = &finished;
+    pthread_create(&pd[i], NULL, concurrent_insert_thread, &params[i]);
+  }
+  // 反向扫描期间不断插入奇数key, 已有的偶数key都要扫到, 且不能重复或乱序
+  TEKey start_key;
+  TEKey end_key;
+  QueryEngineIterator iter;
+  int64_t round = 0;
+  while (0 == round || THREAD_NUM > finished)
+  {
+    int64_t even_count = 0;
+    int64_t prev = 2 * num;
+    iter.reset();
+    ASSERT_EQ(OB_SUCCESS, qe.scan(start_key, 1, 0, end_key, 1, 0, true, iter));
+    while (OB_SUCCESS == iter.next())
+    {
+      int64_t cur = 0;
+      iter.get_key().row_key.ptr()[0].get_int(cur);
+      ASSERT_GT(prev, cur);
+      prev = cur;
+      even_count += (0 == cur % 2) ? 1 : 0;
+    }
+    EXPECT_EQ(num, even_count);
+    round++;
+  }
+  for (int64_t i = 0; i < THREAD_NUM; i++)
+  {
+    pthread_join(pd[i], NULL);
+  }
+
+  int64_t count = 0;
+  int64_t prev = 2 * num;
+  iter.reset();
+  ASSERT_EQ(OB_SUCCESS, qe.scan(start_key, 1, 0, end_key, 1, 0, true, iter));
+  while (OB_SUCCESS == iter.next())
+  {
+    int64_t cur = 0;
+    iter.get_key().row_key.ptr()[0].get_int(cur);
+    EXPECT_EQ(prev - 1, cur);
+    prev = cur;
+    count++;
+  }
+  EXPECT_EQ(2 * num, count);
+  TBSYS_LOG(INFO, "reverse scan with concurrent insert, rounds=%ld", round);
+  qe.destroy();
+}
+
+TEST(TestQueryEnginePerf, skiplist_reverse_scan_insert_below_cursor)
+{
+  g_conf.using_skiplist_index = true;
+  const int64_t num = 10000;
+  MemTank mt;
+  QueryEngine qe(mt);
+  KeySet even(num);
+  KeySet odd(num);
+  for (int64_t i = 0; i < num; i++)
+  {
+    even.objs[i].set_int(2 * ((i * 7919) % num));
+  }
+  ASSERT_EQ(OB_SUCCESS, qe.init(HASH_SIZE));
+  for (int64_t i = 0; i < num; i++)
+  {
+    ASSERT_EQ(OB_SUCCESS, qe.set(even.keys[i], &even.values[i]));
+  }
+  // 每返回一个偶数key k, 就在游标下方插入k-3, 之后的反向扫描必须能看到它
+  TEKey start_key;
+  TEKey end_key;
+  QueryEngineIterator iter;
+  int64_t even_count = 0;
+  int64_t odd_count = 0;
+  int64_t inserted = 0;
+  int64_t prev = 2 * num;
+  ASSERT_EQ(OB_SUCCESS, qe.scan(start_key, 1, 0, end_key, 1, 0, true, iter));
+  while (OB_SUCCESS == iter.next())
+  {
+    int64_t cur = 0;
+    iter.get_key().row_key.ptr()[0].get_int(cur);
+    ASSERT_GT(prev, cur);
+    prev = cur;
+    if (0 != cur % 2)
+    {
+      odd_count++;
+    }
+    else
+    {
+      even_count++;
+      if (3 <= cur)
+      {
+        odd.objs[inserted].set_int(cur - 3);
+        ASSERT_EQ(OB_SUCCESS, qe.set(odd.keys[inserted], &odd.values[inserted]));
+        inserted++;
+      }
+    }
+  }
+  EXPECT_EQ(num, even_count);
+  EXPECT_EQ(inserted, odd_count);
+  qe.destroy();
+}
+
+int main(int argc, char **argv)
+{
+  TBSYS_LOGGER.setLogLevel("info");
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
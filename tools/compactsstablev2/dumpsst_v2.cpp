@@ -827,7 +827,7 @@ int DumpSSTableV2::load_display_block(
         printf("row_index_offset_=%d\n",
             block_header->row_index_offset_);
         printf("row_count_=%d\n", block_header->row_count_);
-        printf("reserved64_=%ld\n", block_header->reserved64_);
+        printf("block_format_=%d\n", block_header->block_format_);
         for (int i = 0; tmp_index  < end_index; tmp_index ++, i ++)
         {
           printf("--row num=%d--:", i);